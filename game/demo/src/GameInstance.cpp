@@ -3,6 +3,8 @@
 #include "triglav/io/CommandLine.h"
 #include "triglav/resource/PathManager.h"
 
+#include <spdlog/spdlog.h>
+
 namespace demo {
 
 using triglav::desktop::DefaultSurfaceEventListener;
@@ -113,8 +115,20 @@ GameInstance::GameInstance(triglav::desktop::IDisplay& display, triglav::graphic
     m_graphicsSplashScreenSurface(GAPI_CHECK(m_instance.create_surface(*m_splashScreenSurface))),
     m_device(GAPI_CHECK(m_instance.create_device(*m_graphicsSplashScreenSurface, device_pick_strategy()))),
     m_resourceManager(*m_device, m_fontManager),
-    m_onLoadedAssetsSink(m_resourceManager.OnLoadedAssets.connect<&GameInstance::on_loaded_assets>(this))
+    m_onLoadedAssetsSink(m_resourceManager.OnLoadedAssets.connect<&GameInstance::on_loaded_assets>(this)),
+    m_onLoadedRequiredAssetsSink(m_resourceManager.OnLoadedRequiredAssets.connect<&GameInstance::on_loaded_required_assets>(this))
 {
+   if (triglav::io::CommandLine::the().is_enabled("textureStreaming"_name)) {
+      triglav::resource::TextureResidencySettings settings{};
+      if (const auto budget = triglav::io::CommandLine::the().arg_int("textureBudget"_name); budget.has_value()) {
+         settings.budget = static_cast<triglav::MemorySize>(*budget) * 1024 * 1024;
+      }
+      m_resourceManager.enable_texture_streaming(settings);
+   }
+   if (triglav::io::CommandLine::the().is_enabled("hotReload"_name)) {
+      m_resourceManager.enable_hot_reload();
+   }
+
    m_state = State::LoadingBaseResources;
    m_resourceManager.load_asset_list(PathManager::the().content_path().sub("index_base.yaml"));
 }
@@ -135,6 +149,14 @@ void GameInstance::on_loaded_assets()
    }
 }
 
+void GameInstance::on_loaded_required_assets()
+{
+   // The base resources are needed by the splash screen as a whole.
+   if (m_state.load() == State::LoadingResources) {
+      m_state.store(State::Ready);
+   }
+}
+
 void GameInstance::loop(triglav::desktop::IDisplay& display)
 {
    display.dispatch_messages();
@@ -170,6 +192,10 @@ void GameInstance::loop(triglav::desktop::IDisplay& display)
 
    auto& eventListener = dynamic_cast<EventListener&>(*m_eventListener);
 
+   m_renderer->on_render();
+   const std::chrono::duration<double, std::milli> timeToFirstFrame = std::chrono::steady_clock::now() - m_startTime;
+   spdlog::info("Time to first frame: {:.1f} ms", timeToFirstFrame.count());
+
    while (eventListener.is_running()) {
       m_renderer->on_render();
       display.dispatch_messages();
@@ -11,6 +11,7 @@
 #include "triglav/resource/ResourceManager.h"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -31,6 +32,8 @@ class GameInstance
    GameInstance(triglav::desktop::IDisplay& display, triglav::graphics_api::Resolution&& resolution);
 
    void on_loaded_assets();
+   // The renderer starts once the assets of the starting level are loaded, the rest keeps loading in the background.
+   void on_loaded_required_assets();
    void loop(triglav::desktop::IDisplay& display);
 
  private:
@@ -49,8 +52,10 @@ class GameInstance
    std::mutex m_stateMtx;
    std::atomic<State> m_state{State::Uninitialized};
    std::condition_variable m_baseResourcesReadyCV;
+   std::chrono::steady_clock::time_point m_startTime{std::chrono::steady_clock::now()};
 
    triglav::resource::ResourceManager::OnLoadedAssetsDel::Sink<GameInstance> m_onLoadedAssetsSink;
+   triglav::resource::ResourceManager::OnLoadedRequiredAssetsDel::Sink<GameInstance> m_onLoadedRequiredAssetsSink;
 };
 
 }// namespace demo
\ No newline at end of file
@@ -71,9 +71,9 @@ class ResourceName
       return m_type;
    }
 
-   [[nodiscard]] constexpr int loading_stage() const
+   [[nodiscard]] constexpr Name name() const
    {
-      return g_resourceStage[static_cast<int>(m_type)];
+      return m_name;
    }
 
    constexpr auto operator<=>(const ResourceName& other) const
@@ -134,7 +134,7 @@ constexpr auto make_rc_name(const std::string_view value)
    return ResourceName(type_by_extension(extension), hash);
 }
 
-#define TG_RESOURCE_TYPE(name, ext, cppType, stage) using name##Name = TypedName<ResourceType::name>;
+#define TG_RESOURCE_TYPE(name, ext, cppType) using name##Name = TypedName<ResourceType::name>;
 
 TG_RESOURCE_TYPE_LIST
 
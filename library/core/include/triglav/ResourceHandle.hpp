@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Int.hpp"
+#include "ResourceType.hpp"
+
+#include <compare>
+
+namespace triglav {
+
+// Slot of a loaded resource in the dense storage of its type, resolved without a lookup. The generation
+// tells apart resources that occupied the same slot, so a handle to an unloaded resource never resolves
+// to the one that took its place.
+template<ResourceType CResourceType>
+class ResourceHandle
+{
+ public:
+   static constexpr auto resource_type = CResourceType;
+
+   constexpr ResourceHandle() = default;
+
+   constexpr ResourceHandle(const u32 index, const u32 generation) :
+       m_index(index),
+       m_generation(generation)
+   {
+   }
+
+   [[nodiscard]] constexpr u32 index() const
+   {
+      return m_index;
+   }
+
+   [[nodiscard]] constexpr u32 generation() const
+   {
+      return m_generation;
+   }
+
+   [[nodiscard]] constexpr bool is_valid() const
+   {
+      return m_generation != 0;
+   }
+
+   constexpr auto operator<=>(const ResourceHandle& other) const = default;
+   constexpr bool operator==(const ResourceHandle& other) const = default;
+
+ private:
+   u32 m_index{};
+   u32 m_generation{};
+};
+
+#define TG_RESOURCE_TYPE(name, ext, cppType) using name##Handle = ResourceHandle<ResourceType::name>;
+
+TG_RESOURCE_TYPE_LIST
+
+#undef TG_RESOURCE_TYPE
+
+}// namespace triglav
@@ -2,14 +2,13 @@
 
 #include "TypeMacroList.hpp"
 
-#include <array>
 #include <string_view>
 
 namespace triglav {
 
 enum class ResourceType
 {
-#define TG_RESOURCE_TYPE(name, ext, cppType, stage) name,
+#define TG_RESOURCE_TYPE(name, ext, cppType) name,
    TG_RESOURCE_TYPE_LIST
 #undef TG_RESOURCE_TYPE
       Unknown,
@@ -23,8 +22,8 @@ struct EnumToCppResourceType
 
 constexpr ResourceType type_by_extension(const std::string_view extension)
 {
-#define TG_RESOURCE_TYPE(name, ext, cppType, stage) \
-   if (extension == ext)                            \
+#define TG_RESOURCE_TYPE(name, ext, cppType) \
+   if (extension == ext)                     \
       return ResourceType::name;
 
    TG_RESOURCE_TYPE_LIST
@@ -34,7 +33,21 @@ constexpr ResourceType type_by_extension(const std::string_view extension)
    return ResourceType::Unknown;
 }
 
-#define TG_RESOURCE_TYPE(name, ext, cppType, stage)            \
+constexpr std::string_view resource_type_name(const ResourceType type)
+{
+   switch (type) {
+#define TG_RESOURCE_TYPE(name, ext, cppType) \
+   case ResourceType::name:                  \
+      return #name;
+      TG_RESOURCE_TYPE_LIST
+#undef TG_RESOURCE_TYPE
+   case ResourceType::Unknown:
+      break;
+   }
+   return "Unknown";
+}
+
+#define TG_RESOURCE_TYPE(name, ext, cppType)                   \
    template<>                                                  \
    struct EnumToCppResourceType<::triglav::ResourceType::name> \
    {                                                           \
@@ -45,24 +58,4 @@ TG_RESOURCE_TYPE_LIST
 
 #undef TG_RESOURCE_TYPE
 
-constexpr std::array g_resourceStage{
-#define TG_RESOURCE_TYPE(name, ext, cppType, stage) stage,
-   TG_RESOURCE_TYPE_LIST
-#undef TG_RESOURCE_TYPE
-};
-
-constexpr int loading_stage_count()
-{
-   int topStage{};
-#define TG_RESOURCE_TYPE(name, ext, cppType, stage) \
-   if (topStage < stage)                            \
-      topStage = stage;
-
-   TG_RESOURCE_TYPE_LIST
-
-#undef TG_RESOURCE_TYPE
-
-   return topStage + 1;
-}
-
 }// namespace triglav
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Int.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace triglav {
+
+struct SlotKey
+{
+   u32 index;
+   u32 generation;
+};
+
+// Values addressed by a slot index that readers resolve without locking. Slots live in fixed size chunks
+// that never move, so references stay valid while other values are inserted. Removed slots are reused,
+// each insertion and removal advances the generation of the slot, an occupied slot has an odd one.
+// Insertions and removals need to be serialized by the owner.
+template<typename TValue, u32 CChunkSize = 256, u32 CMaxChunkCount = 1024>
+class SlotArray
+{
+   struct Slot
+   {
+      std::optional<TValue> value;
+      std::atomic<u32> generation{};
+   };
+
+ public:
+   static constexpr u32 max_slot_count = CChunkSize * CMaxChunkCount;
+
+   SlotArray() = default;
+
+   SlotArray(const SlotArray& other) = delete;
+   SlotArray& operator=(const SlotArray& other) = delete;
+   SlotArray(SlotArray&& other) noexcept = delete;
+   SlotArray& operator=(SlotArray&& other) noexcept = delete;
+
+   ~SlotArray()
+   {
+      for (auto& chunk : m_chunks) {
+         delete[] chunk.load(std::memory_order_relaxed);
+      }
+   }
+
+   template<typename... TArgs>
+   SlotKey emplace(TArgs&&... args)
+   {
+      u32 index;
+      if (not m_freeSlots.empty()) {
+         index = m_freeSlots.back();
+         m_freeSlots.pop_back();
+      } else {
+         assert(m_slotCount < max_slot_count);
+         index = m_slotCount++;
+         if (index % CChunkSize == 0) {
+            m_chunks[index / CChunkSize].store(new Slot[CChunkSize], std::memory_order_release);
+         }
+      }
+
+      auto& slot = this->slot(index);
+      slot.value.emplace(std::forward<TArgs>(args)...);
+      const auto generation = slot.generation.load(std::memory_order_relaxed) + 1;
+      slot.generation.store(generation, std::memory_order_release);
+
+      return SlotKey{index, generation};
+   }
+
+   void erase(const u32 index)
+   {
+      auto& slot = this->slot(index);
+      assert(slot.value.has_value());
+
+      slot.generation.store(slot.generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      slot.value.reset();
+      m_freeSlots.emplace_back(index);
+   }
+
+   [[nodiscard]] TValue& operator[](const u32 index)
+   {
+      return *this->slot(index).value;
+   }
+
+   [[nodiscard]] const TValue& operator[](const u32 index) const
+   {
+      return *this->slot(index).value;
+   }
+
+   [[nodiscard]] u32 generation(const u32 index) const
+   {
+      return this->slot(index).generation.load(std::memory_order_acquire);
+   }
+
+   [[nodiscard]] bool contains(const SlotKey key) const
+   {
+      return key.index < m_slotCount && key.generation % 2 == 1 && this->generation(key.index) == key.generation;
+   }
+
+   // Number of slots ever used, valid indices are below it.
+   [[nodiscard]] u32 slot_count() const
+   {
+      return m_slotCount;
+   }
+
+ private:
+   [[nodiscard]] Slot& slot(const u32 index) const
+   {
+      assert(index < max_slot_count);
+      auto* chunk = m_chunks[index / CChunkSize].load(std::memory_order_acquire);
+      assert(chunk != nullptr);
+      return chunk[index % CChunkSize];
+   }
+
+   std::array<std::atomic<Slot*>, CMaxChunkCount> m_chunks{};
+   std::atomic<u32> m_slotCount{};
+   std::vector<u32> m_freeSlots;
+};
+
+}// namespace triglav
@@ -4,6 +4,7 @@ class GlyphAtlas;
 struct Model;
 struct Material;
 struct MaterialTemplate;
+struct ParticleEmitter;
 }// namespace render_core
 
 namespace graphics_api {
@@ -22,16 +23,17 @@ struct Level;
 }// namespace triglav
 
 /*
-TG_RESOURCE_TYPE(name, extension, cppType, loadingStage)
+TG_RESOURCE_TYPE(name, extension, cppType)
 */
 
-#define TG_RESOURCE_TYPE_LIST                                                            \
-   TG_RESOURCE_TYPE(Texture, "tex", ::triglav::graphics_api::Texture, 0)                 \
-   TG_RESOURCE_TYPE(FragmentShader, "fshader", ::triglav::graphics_api::Shader, 0)       \
-   TG_RESOURCE_TYPE(VertexShader, "vshader", ::triglav::graphics_api::Shader, 0)         \
-   TG_RESOURCE_TYPE(ComputeShader, "cshader", ::triglav::graphics_api::Shader, 0)        \
-   TG_RESOURCE_TYPE(Material, "mat", ::triglav::render_core::Material, 1)                \
-   TG_RESOURCE_TYPE(MaterialTemplate, "mt", ::triglav::render_core::MaterialTemplate, 0) \
-   TG_RESOURCE_TYPE(Model, "model", ::triglav::render_core::Model, 0)                    \
-   TG_RESOURCE_TYPE(Typeface, "typeface", ::triglav::font::Typeface, 0)                  \
-   TG_RESOURCE_TYPE(Level, "level", ::triglav::world::Level, 0)
+#define TG_RESOURCE_TYPE_LIST                                                          \
+   TG_RESOURCE_TYPE(Texture, "tex", ::triglav::graphics_api::Texture)                  \
+   TG_RESOURCE_TYPE(FragmentShader, "fshader", ::triglav::graphics_api::Shader)        \
+   TG_RESOURCE_TYPE(VertexShader, "vshader", ::triglav::graphics_api::Shader)          \
+   TG_RESOURCE_TYPE(ComputeShader, "cshader", ::triglav::graphics_api::Shader)         \
+   TG_RESOURCE_TYPE(Material, "mat", ::triglav::render_core::Material)                 \
+   TG_RESOURCE_TYPE(MaterialTemplate, "mt", ::triglav::render_core::MaterialTemplate)  \
+   TG_RESOURCE_TYPE(Model, "model", ::triglav::render_core::Model)                     \
+   TG_RESOURCE_TYPE(Typeface, "typeface", ::triglav::font::Typeface)                   \
+   TG_RESOURCE_TYPE(Level, "level", ::triglav::world::Level)                           \
+   TG_RESOURCE_TYPE(ParticleEmitter, "pemit", ::triglav::render_core::ParticleEmitter)
@@ -0,0 +1,69 @@
+#include "triglav/SlotArray.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using triglav::SlotArray;
+using triglav::SlotKey;
+using triglav::u32;
+
+TEST(SlotArrayTest, ValuesAreAddressedBySlot)
+{
+   SlotArray<std::string, 4> slots;
+
+   const auto first = slots.emplace("first");
+   const auto second = slots.emplace(3, 'x');
+
+   EXPECT_EQ(first.index, 0);
+   EXPECT_EQ(second.index, 1);
+   EXPECT_EQ(slots[first.index], "first");
+   EXPECT_EQ(slots[second.index], "xxx");
+   EXPECT_TRUE(slots.contains(first));
+   EXPECT_TRUE(slots.contains(second));
+   EXPECT_EQ(slots.slot_count(), 2);
+}
+
+TEST(SlotArrayTest, ReferencesStayValidAcrossChunks)
+{
+   SlotArray<u32, 4> slots;
+
+   const auto first = slots.emplace(100u);
+   const auto* firstValue = &slots[first.index];
+
+   for (u32 value = 0; value < 64; ++value) {
+      const auto key = slots.emplace(value);
+      EXPECT_EQ(slots[key.index], value);
+   }
+
+   EXPECT_EQ(&slots[first.index], firstValue);
+   EXPECT_EQ(*firstValue, 100);
+   EXPECT_EQ(slots.slot_count(), 65);
+}
+
+TEST(SlotArrayTest, ErasedSlotIsReusedWithNewGeneration)
+{
+   SlotArray<std::string, 4> slots;
+
+   const auto first = slots.emplace("first");
+   slots.emplace("second");
+
+   slots.erase(first.index);
+   EXPECT_FALSE(slots.contains(first));
+
+   const auto third = slots.emplace("third");
+   EXPECT_EQ(third.index, first.index);
+   EXPECT_NE(third.generation, first.generation);
+   EXPECT_FALSE(slots.contains(first));
+   EXPECT_TRUE(slots.contains(third));
+   EXPECT_EQ(slots[third.index], "third");
+}
+
+TEST(SlotArrayTest, UnusedSlotsAreNotContained)
+{
+   SlotArray<u32, 4> slots;
+   EXPECT_FALSE(slots.contains(SlotKey{0, 1}));
+
+   const auto key = slots.emplace(1u);
+   EXPECT_FALSE(slots.contains(SlotKey{key.index, 0}));
+   EXPECT_FALSE(slots.contains(SlotKey{key.index + 1, 1}));
+}
@@ -64,6 +64,18 @@ struct DeviceMesh
    std::vector<MaterialRange> ranges;
 };
 
+struct VertexData
+{
+   std::vector<Vertex> vertices;
+   std::vector<uint32_t> indices;
+   std::vector<MaterialRange> ranges;
+
+   [[nodiscard]] DeviceMesh upload_to_device(graphics_api::Device& device) const
+   {
+      return {{graphics_api::VertexArray<Vertex>{device, vertices}, graphics_api::IndexArray{device, indices}}, ranges};
+   }
+};
+
 struct BoundingBox
 {
    glm::vec3 min;
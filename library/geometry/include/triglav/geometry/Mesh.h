@@ -5,6 +5,7 @@
 
 #include "triglav/graphics_api/Array.hpp"
 #include "triglav/io/Path.h"
+#include "triglav/io/Stream.h"
 
 #include "Geometry.h"
 
@@ -45,9 +46,12 @@ class Mesh
    [[nodiscard]] BoundingBox calculate_bouding_box() const;
    [[nodiscard]] bool is_triangulated() const;
    [[nodiscard]] size_t vertex_count() const;
+   // Deduplicated vertices and indices of a triangulated mesh, the data upload_to_device writes to the GPU.
+   [[nodiscard]] VertexData to_vertex_data() const;
    [[nodiscard]] DeviceMesh upload_to_device(graphics_api::Device& device) const;
 
    static Mesh from_file(const io::Path& path);
+   static Mesh from_stream(io::IReader& stream);
 
  private:
    explicit Mesh(std::unique_ptr<InternalMesh> mesh);
@@ -346,7 +346,7 @@ InternalMesh InternalMesh::from_obj_file(const io::Path& path)
    return InternalMesh::from_obj_file(**file);
 }
 
-DeviceMesh InternalMesh::upload_to_device(graphics_api::Device& device)
+VertexData InternalMesh::to_vertex_data()
 {
    if (not this->is_triangulated())
       throw std::runtime_error("mesh must be triangulated before upload to GPU");
@@ -401,13 +401,12 @@ DeviceMesh InternalMesh::upload_to_device(graphics_api::Device& device)
       materialRanges.push_back(MaterialRange{lastOffset, outIndices.size() - lastOffset, currentMaterial});
    }
 
-   graphics_api::VertexArray<Vertex> gpuVertices{device, outVertices.size()};
-   gpuVertices.write(outVertices.data(), outVertices.size());
-
-   graphics_api::IndexArray gpuIndices{device, outIndices.size()};
-   gpuIndices.write(outIndices.data(), outIndices.size());
+   return {std::move(outVertices), std::move(outIndices), std::move(materialRanges)};
+}
 
-   return {{std::move(gpuVertices), std::move(gpuIndices)}, std::move(materialRanges)};
+DeviceMesh InternalMesh::upload_to_device(graphics_api::Device& device)
+{
+   return this->to_vertex_data().upload_to_device(device);
 }
 
 void InternalMesh::reverse_orientation()
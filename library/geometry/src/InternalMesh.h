@@ -63,6 +63,7 @@ class InternalMesh
    [[nodiscard]] bool is_triangulated();
    [[nodiscard]] BoundingBox calculate_bouding_box() const;
 
+   [[nodiscard]] VertexData to_vertex_data();
    [[nodiscard]] DeviceMesh upload_to_device(graphics_api::Device& device);
    void reverse_orientation();
 
@@ -104,6 +104,12 @@ void Mesh::reverse_orientation()
    m_mesh->reverse_orientation();
 }
 
+VertexData Mesh::to_vertex_data() const
+{
+   assert(m_mesh != nullptr);
+   return m_mesh->to_vertex_data();
+}
+
 DeviceMesh Mesh::upload_to_device(graphics_api::Device& device) const
 {
    assert(m_mesh != nullptr);
@@ -116,6 +122,12 @@ Mesh Mesh::from_file(const io::Path& path)
    return Mesh(std::make_unique<InternalMesh>(std::move(internalMesh)));
 }
 
+Mesh Mesh::from_stream(io::IReader& stream)
+{
+   auto internalMesh = InternalMesh::from_obj_file(stream);
+   return Mesh(std::make_unique<InternalMesh>(std::move(internalMesh)));
+}
+
 Mesh::Mesh(std::unique_ptr<InternalMesh> mesh) :
     m_mesh(std::move(mesh))
 {
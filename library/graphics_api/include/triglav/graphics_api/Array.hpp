@@ -49,6 +49,13 @@ class Array
       m_buffer.write_indirect(source, count * sizeof(TValue));
    }
 
+   // Writes serialized elements, the bytes don't need to be aligned to the element type.
+   void write_bytes(const std::span<const u8> bytes)
+   {
+      assert(bytes.size() <= m_elementCount * sizeof(TValue));
+      m_buffer.write_indirect(bytes.data(), bytes.size());
+   }
+
    [[nodiscard]] const Buffer& buffer() const
    {
       return m_buffer;
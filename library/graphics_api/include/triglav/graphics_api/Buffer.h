@@ -3,10 +3,16 @@
 #include "GraphicsApi.hpp"
 #include "vulkan/ObjectWrapper.hpp"
 
+#include <functional>
+#include <span>
+
 namespace triglav::graphics_api {
 
 class Device;
 
+// Fills the staging memory of an upload, returns false if the data couldn't be written.
+using StagingWriter = std::function<bool(std::span<u8> memory)>;
+
 DECLARE_VLK_WRAPPED_CHILD_OBJECT(Buffer, Device);
 
 namespace vulkan {
@@ -48,6 +54,8 @@ class Buffer
 
 
    [[nodiscard]] Status write_indirect(const void* data, size_t size);
+   // Uploads data the writer puts straight into the staging memory, like file contents read into it.
+   [[nodiscard]] Status write_indirect(size_t size, const StagingWriter& writer);
    [[nodiscard]] VkBuffer vulkan_buffer() const;
    Result<MappedMemory> map_memory();
    [[nodiscard]] size_t size() const;
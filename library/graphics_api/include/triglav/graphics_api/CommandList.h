@@ -47,18 +47,34 @@ class CommandList
    void draw_primitives(int vertexCount, int vertexOffset);
    void draw_primitives(int vertexCount, int vertexOffset, int instanceCount, int firstInstance);
    void draw_indexed_primitives(int indexCount, int indexOffset, int vertexOffset);
+   // Reads the draw arguments from a buffer, the layout matches DrawIndirectCommand.
+   void draw_indirect(const Buffer& drawCallBuffer, u32 drawCount = 1);
    void dispatch(u32 x, u32 y, u32 z);
+   // Reads the group counts from a buffer, the layout matches DispatchIndirectCommand.
+   void dispatch_indirect(const Buffer& dispatchBuffer);
    void bind_vertex_buffer(const Buffer& buffer, uint32_t layoutIndex) const;
    void bind_index_buffer(const Buffer& buffer) const;
    void copy_buffer(const Buffer& source, const Buffer& dest) const;
    void copy_buffer(const Buffer& source, const Buffer& dest, u32 srcOffset, u32 dstOffset, u32 size) const;
-   void copy_buffer_to_texture(const Buffer& source, const Texture& destination, int mipLevel = 0) const;
+   void copy_buffer_to_texture(const Buffer& source, const Texture& destination, int mipLevel = 0, MemorySize bufferOffset = 0) const;
    void copy_texture(const Texture& source, TextureState srcState, const Texture& destination, TextureState dstState);
+   // The source level needs to be in the TransferSrc state.
+   void copy_texture_to_buffer(const Texture& source, const Buffer& destination, int mipLevel = 0, MemorySize bufferOffset = 0) const;
    void push_constant_ptr(PipelineStage stage, const void* ptr, size_t size, size_t offset = 0) const;
 
    void texture_barrier(PipelineStageFlags sourceStage, PipelineStageFlags targetStage, std::span<const TextureBarrierInfo> infos) const;
    void texture_barrier(PipelineStageFlags sourceStage, PipelineStageFlags targetStage, const TextureBarrierInfo& info) const;
    void execution_barrier(PipelineStageFlags sourceStage, PipelineStageFlags targetStage) const;
+   // Execution barrier that also makes all memory writes of the source stage visible to the target stage.
+   void memory_barrier(PipelineStageFlags sourceStage, PipelineStageFlags targetStage) const;
+
+   // Queue family ownership transfer of a resource written by this command list to work of the target types. The
+   // consuming command list records the matching acquire after waiting for this one with a semaphore, for textures
+   // both need the same state transition. Nothing is recorded when both work types share a queue family.
+   void release_buffer(const Buffer& buffer, PipelineStageFlags sourceStage, WorkTypeFlags targetWorkTypes) const;
+   void acquire_buffer(const Buffer& buffer, WorkTypeFlags sourceWorkTypes, PipelineStageFlags targetStage) const;
+   void release_texture(PipelineStageFlags sourceStage, const TextureBarrierInfo& info, WorkTypeFlags targetWorkTypes) const;
+   void acquire_texture(WorkTypeFlags sourceWorkTypes, PipelineStageFlags targetStage, const TextureBarrierInfo& info) const;
 
    void blit_texture(const Texture& sourceTex, const TextureRegion& sourceRegion, const Texture& targetTex,
                      const TextureRegion& targetRegion) const;
@@ -77,6 +93,8 @@ class CommandList
    }
 
    void bind_texture(u32 binding, const Texture& texture);
+   void bind_texture_mip(u32 binding, const Texture& texture, int mipLevel);
+   void bind_storage_images(u32 binding, const Texture& texture, int baseMipLevel, int mipLevelCount);
 
    template<typename TIndexArray>
    void bind_index_array(const TIndexArray& array) const
@@ -43,6 +43,10 @@ class DescriptorWriter
    }
 
    void set_sampled_texture(uint32_t binding, const Texture& texture, const Sampler& sampler);
+   // Samples a single mip level through its linear format view, the texture must have storage usage.
+   void set_sampled_texture_mip(uint32_t binding, const Texture& texture, int mipLevel, const Sampler& sampler);
+   // Writes an array of storage images, one element for each mip level in the range.
+   void set_storage_images(uint32_t binding, const Texture& texture, int baseMipLevel, int mipLevelCount);
    void reset_count();
 
    [[nodiscard]] VkDescriptorSet vulkan_descriptor_set() const;
@@ -59,6 +63,7 @@ class DescriptorWriter
    ObjectPool<VkDescriptorBufferInfo> m_descriptorBufferInfoPool{};
    ObjectPool<VkDescriptorImageInfo> m_descriptorImageInfoPool{};
    std::array<VkWriteDescriptorSet, g_maxBinding> m_descriptorWrites{};
+   std::array<std::vector<VkDescriptorImageInfo>, g_maxBinding> m_imageArrayInfos{};
 };
 
 }// namespace triglav::graphics_api
@@ -6,6 +6,7 @@
 #include "Sampler.h"
 #include "SamplerCache.h"
 #include "Shader.h"
+#include "StagingBufferPool.h"
 #include "Surface.h"
 #include "Swapchain.h"
 #include "Synchronization.h"
@@ -13,6 +14,7 @@
 #include "TimestampArray.h"
 #include "vulkan/ObjectWrapper.hpp"
 
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -45,10 +47,36 @@ using PhysicalDevice = VkPhysicalDevice;
 
 constexpr auto g_maxMipMaps = 0;
 
+// Objects created by a null device and the memory they would take on a GPU.
+struct NullDeviceStats
+{
+   std::atomic<u32> bufferCount{};
+   std::atomic<MemorySize> bufferMemory{};
+   std::atomic<u32> textureCount{};
+   std::atomic<MemorySize> textureMemory{};
+   std::atomic<u32> shaderCount{};
+   std::atomic<MemorySize> shaderCodeSize{};
+   std::atomic<u32> pipelineCount{};
+   std::atomic<u32> uploadCount{};
+   std::atomic<MemorySize> uploadSize{};
+};
+
+// Optional features, enabled when the physical device supports them.
+struct DeviceFeatures
+{
+   // Storage images declared without a format, required by the compute mip generator.
+   bool storageImageWithoutFormat{false};
+};
+
 class Device
 {
  public:
-   Device(vulkan::Device device, vulkan::PhysicalDevice physicalDevice, std::vector<QueueFamilyInfo>&& queueFamilyInfos);
+   Device(vulkan::Device device, vulkan::PhysicalDevice physicalDevice, std::vector<QueueFamilyInfo>&& queueFamilyInfos,
+          const DeviceFeatures& features);
+
+   // Device without a GPU, for running the resource loaders headless. Objects are created without Vulkan handles,
+   // the data written to them is discarded and only their sizes are recorded. It has no queues to submit work to.
+   [[nodiscard]] static std::unique_ptr<Device> create_null();
 
    [[nodiscard]] Result<Swapchain> create_swapchain(const Surface& surface, ColorFormat colorFormat, ColorSpace colorSpace,
                                                     const Resolution& resolution, PresentMode presentMode,
@@ -75,10 +103,21 @@ class Device
    [[nodiscard]] VkDevice vulkan_device() const;
    [[nodiscard]] QueueManager& queue_manager();
    [[nodiscard]] SamplerCache& sampler_cache();
+   [[nodiscard]] StagingBufferPool& staging_buffer_pool();
 
    void await_all() const;
 
    [[nodiscard]] u32 min_storage_buffer_alignment() const;
+   [[nodiscard]] const DeviceFeatures& features() const;
+   // Checks if optimal tiling 2D textures of the format can be created with the given usage.
+   // With the storage usage the format, or its linear counterpart for sRGB, also needs to support storage images.
+   [[nodiscard]] bool is_texture_format_supported(const ColorFormat& format, TextureUsageFlags usageFlags) const;
+
+   [[nodiscard]] bool is_null() const;
+   // Null devices only, returns nullptr for a GPU device.
+   [[nodiscard]] NullDeviceStats* null_stats() const;
+   // Takes the place of uploading data through a staging buffer on a null device.
+   void record_null_upload(MemorySize size) const;
 
  private:
    [[nodiscard]] uint32_t find_memory_type(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
@@ -86,8 +125,11 @@ class Device
    vulkan::Device m_device;
    vulkan::PhysicalDevice m_physicalDevice;
    std::vector<QueueFamilyInfo> m_queueFamilyInfos;
+   DeviceFeatures m_features;
    QueueManager m_queueManager;
    SamplerCache m_samplerCache;
+   StagingBufferPool m_stagingBufferPool;
+   std::unique_ptr<NullDeviceStats> m_nullStats;
 };
 
 using DeviceUPtr = std::unique_ptr<Device>;
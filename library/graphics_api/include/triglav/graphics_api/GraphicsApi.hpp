@@ -22,6 +22,7 @@ enum class Status
    OutOfDateSwapchain,
    PSOCreationFailed,
    InvalidTransferDestination,
+   InvalidTransferSource,
    InvalidShaderStage,
 };
 
@@ -33,7 +34,12 @@ enum class ColorFormatOrder
    RGBA,
    BGRA,
    DS,
-   D
+   D,
+   // Block compressed formats, the first part is either sRGB or UNorm8.
+   BC1,
+   BC4,
+   BC5,
+   BC7,
 };
 
 constexpr size_t color_format_order_count(const ColorFormatOrder order)
@@ -53,6 +59,14 @@ constexpr size_t color_format_order_count(const ColorFormatOrder order)
       return 2;
    case ColorFormatOrder::D:
       return 1;
+   case ColorFormatOrder::BC1:
+      return 3;
+   case ColorFormatOrder::BC4:
+      return 1;
+   case ColorFormatOrder::BC5:
+      return 2;
+   case ColorFormatOrder::BC7:
+      return 4;
    }
    return 0;
 }
@@ -113,6 +127,29 @@ struct ColorFormat
    ColorFormatOrder order;
    std::array<ColorFormatPart, 4> parts;
 
+   [[nodiscard]] bool is_srgb() const
+   {
+      return parts[0] == ColorFormatPart::sRGB;
+   }
+
+   [[nodiscard]] bool is_block_compressed() const
+   {
+      return order == ColorFormatOrder::BC1 || order == ColorFormatOrder::BC4 || order == ColorFormatOrder::BC5 ||
+             order == ColorFormatOrder::BC7;
+   }
+
+   // Same format with the sRGB encoding replaced by UNorm8, used for views that can't be sRGB such as storage images.
+   [[nodiscard]] ColorFormat linear_format() const
+   {
+      ColorFormat result{*this};
+      for (auto& part : result.parts) {
+         if (part == ColorFormatPart::sRGB) {
+            part = ColorFormatPart::UNorm8;
+         }
+      }
+      return result;
+   }
+
    [[nodiscard]] size_t pixel_size() const
    {
       size_t result{};
@@ -134,6 +171,8 @@ struct Resolution
 {
    uint32_t width{};
    uint32_t height{};
+
+   bool operator==(const Resolution& other) const = default;
 };
 
 struct Color
@@ -163,6 +202,7 @@ enum class DescriptorType
    StorageBuffer,
    Sampler,
    ImageSampler,
+   StorageImage,
 };
 
 struct DescriptorBinding
@@ -182,6 +222,7 @@ enum class TextureUsage
    ColorAttachment = (1 << 3),
    DepthStencilAttachment = (1 << 4),
    Transient = (1 << 5),
+   Storage = (1 << 6),
 };
 
 TRIGLAV_DECL_FLAGS(TextureUsage)
@@ -193,6 +234,8 @@ enum class TextureState
    TransferDst,
    ShaderRead,
    DepthStencilRead,
+   // Read and written by compute shaders as a storage image.
+   General,
 };
 
 class Texture;
@@ -309,15 +352,35 @@ enum class BufferUsage : u32
    VertexBuffer = (1 << 4),
    IndexBuffer = (1 << 5),
    StorageBuffer = (1 << 6),
+   Indirect = (1 << 7),
 };
 
 TRIGLAV_DECL_FLAGS(BufferUsage)
 
+// Layout of a single indirect draw call in a buffer with the Indirect usage.
+struct DrawIndirectCommand
+{
+   u32 vertexCount;
+   u32 instanceCount;
+   u32 firstVertex;
+   u32 firstInstance;
+};
+
+// Layout of the group counts of an indirect dispatch.
+struct DispatchIndirectCommand
+{
+   u32 groupCountX;
+   u32 groupCountY;
+   u32 groupCountZ;
+};
+
 enum class DepthTestMode
 {
    Disabled,
    Enabled,
-   ReadOnly
+   ReadOnly,
+   // Read only, passes only fragments matching the stored depth.
+   Equal
 };
 
 enum class PipelineType
@@ -15,10 +15,14 @@ class Instance
 
    [[nodiscard]] Result<Surface> create_surface(const desktop::ISurface& surface) const;
    [[nodiscard]] Result<DeviceUPtr> create_device(const Surface& surface, DevicePickStrategy strategy) const;
+   // Creates a device without presentation support, for offscreen work.
+   [[nodiscard]] Result<DeviceUPtr> create_headless_device(DevicePickStrategy strategy) const;
 
    [[nodiscard]] static Result<Instance> create_instance();
 
  private:
+   [[nodiscard]] Result<DeviceUPtr> create_device_internal(const Surface* surface, DevicePickStrategy strategy) const;
+
    vulkan::Instance m_instance;
 #if GAPI_ENABLE_VALIDATION
    vulkan::DebugUtilsMessengerEXT m_debugMessenger;
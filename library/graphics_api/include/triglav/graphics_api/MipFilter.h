@@ -0,0 +1,30 @@
+#pragma once
+
+#include "GraphicsApi.hpp"
+
+#include <glm/vec4.hpp>
+#include <span>
+#include <vector>
+
+namespace triglav::graphics_api {
+
+// Number of mip levels a single dispatch of the mip generator writes, limits the source to 4096x4096.
+constexpr int g_maxGeneratedMipCount = 12;
+
+enum class MipFilter : u32
+{
+   // Box filter, sRGB textures are averaged in linear space.
+   Average = 0,
+   // Averages the decoded normal vectors and renormalizes the result.
+   NormalMap = 1,
+   // Reductions for depth pyramids.
+   Min = 2,
+   Max = 3,
+};
+
+// CPU reference of the compute mip generator. Texels are given and returned in the stored representation,
+// the result holds the levels below the source, the first one is half the size of the source.
+std::vector<std::vector<glm::vec4>> generate_mip_chain_reference(std::span<const glm::vec4> texels, const Resolution& resolution,
+                                                                 int mipCount, MipFilter filter, bool isSrgb);
+
+}// namespace triglav::graphics_api
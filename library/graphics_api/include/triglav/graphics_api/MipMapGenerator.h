@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Buffer.h"
+#include "MipFilter.h"
+#include "Pipeline.h"
+
+#include <atomic>
+
+namespace triglav::graphics_api {
+
+class CommandList;
+class Device;
+class Shader;
+class Texture;
+
+// Writes a whole mip chain with a single compute dispatch, sources larger than 4096 pixels take a second one.
+// The filter is applied in linear space for sRGB textures, normal maps are renormalized on every level.
+class MipMapGenerator
+{
+ public:
+   MipMapGenerator(Device& device, const Shader& downsampleShader);
+
+   // Generates levels 1 and below from level 0, which needs to be in the ShaderRead state.
+   // The generated levels are left in the ShaderRead state.
+   void generate(CommandList& cmdList, const Texture& texture, MipFilter filter);
+
+   // Writes all levels of the destination from the source, level 0 of the destination is half the size of the source.
+   // The source needs to be in the ShaderRead state, the destination is left in the ShaderRead state.
+   void downsample(CommandList& cmdList, const Texture& source, const Texture& destination, MipFilter filter);
+
+   [[nodiscard]] static bool can_generate(const Texture& texture);
+
+ private:
+   void dispatch(CommandList& cmdList, const Texture& source, int sourceMipLevel, const Texture& destination, int baseMipLevel,
+                 int mipCount, MipFilter filter);
+
+   Pipeline m_pipeline;
+   Buffer m_counterBuffer;
+   std::atomic<u32> m_nextCounter{0};
+};
+
+}// namespace triglav::graphics_api
@@ -18,10 +18,12 @@ class PipelineBuilderBase
 
  protected:
    void add_shader(const Shader& shader);
-   void add_descriptor_binding(DescriptorType descriptorType, PipelineStage shaderStage);
+   void add_descriptor_binding(DescriptorType descriptorType, PipelineStage shaderStage, u32 count = 1);
    void add_push_constant(PipelineStage shaderStage, size_t size, size_t offset = 0);
 
    [[nodiscard]] Result<std::tuple<vulkan::DescriptorSetLayout, vulkan::PipelineLayout>> build_pipeline_layout() const;
+   // Null devices accept pipelines without compiling them.
+   [[nodiscard]] Pipeline build_null_pipeline(PipelineType pipelineType) const;
 
    Device& m_device;
    std::vector<VkDescriptorSetLayoutBinding> m_vulkanDescriptorBindings{};
@@ -37,6 +39,7 @@ class ComputePipelineBuilder : public PipelineBuilderBase
 
    ComputePipelineBuilder& compute_shader(const Shader& shader);
    ComputePipelineBuilder& descriptor_binding(DescriptorType descriptorType);
+   ComputePipelineBuilder& descriptor_binding_array(DescriptorType descriptorType, u32 count);
    ComputePipelineBuilder& push_constant(PipelineStage shaderStage, size_t size, size_t offset = 0);
    ComputePipelineBuilder& use_push_descriptors(bool enabled);
 
@@ -57,6 +60,7 @@ class GraphicsPipelineBuilder : public PipelineBuilderBase
    GraphicsPipelineBuilder& enable_depth_test(bool enabled);
    GraphicsPipelineBuilder& depth_test_mode(DepthTestMode mode);
    GraphicsPipelineBuilder& enable_blending(bool enabled);
+   GraphicsPipelineBuilder& enable_color_write(bool enabled);
    GraphicsPipelineBuilder& use_push_descriptors(bool enabled);
    GraphicsPipelineBuilder& vertex_topology(VertexTopology topology);
    GraphicsPipelineBuilder& rasterization_method(RasterizationMethod method);
@@ -85,6 +89,7 @@ class GraphicsPipelineBuilder : public PipelineBuilderBase
    VkFrontFace m_frontFace = VK_FRONT_FACE_CLOCKWISE;
    DepthTestMode m_depthTestMode{DepthTestMode::Disabled};
    bool m_blendingEnabled{true};
+   bool m_colorWriteEnabled{true};
 
    std::vector<VkVertexInputBindingDescription> m_bindings{};
    std::vector<VkVertexInputAttributeDescription> m_attributes{};
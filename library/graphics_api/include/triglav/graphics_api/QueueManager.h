@@ -7,6 +7,7 @@
 #include "triglav/ObjectPool.hpp"
 #include "triglav/threading/SafeAccess.hpp"
 
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <span>
@@ -23,6 +24,13 @@ struct QueueFamilyInfo
    WorkTypeFlags flags{WorkType::None};
 };
 
+using QueueFamilySelection = std::array<u32, 16>;
+
+// Picks the queue family for each combination of work types, indexed by the value of the flags. Families supporting
+// the fewest work types are preferred, so transfers go to a dedicated transfer family when the device has one.
+// Holds the position of the family in the infos, or u32 max when no family supports the combination.
+[[nodiscard]] QueueFamilySelection select_queue_families(std::span<const QueueFamilyInfo> infos);
+
 class QueueManager
 {
  public:
@@ -33,6 +41,8 @@ class QueueManager
    [[nodiscard]] SafeQueue& next_queue(WorkTypeFlags flags);
    [[nodiscard]] Result<CommandList> create_command_list(WorkTypeFlags flags) const;
    [[nodiscard]] u32 queue_index(WorkTypeFlags flags) const;
+   // Resources exclusive to a queue family need an ownership transfer to be used by work of another family.
+   [[nodiscard]] bool shares_queue_family(WorkTypeFlags first, WorkTypeFlags second) const;
    [[nodiscard]] Semaphore* aquire_semaphore();
    void release_semaphore(const Semaphore* semaphore);
    [[nodiscard]] Fence* aquire_fence();
@@ -89,7 +99,7 @@ class QueueManager
    FenceFactory m_fenceFactory;
    ObjectPool<Fence, FenceFactory, 4> m_fencePool;
    std::vector<std::unique_ptr<QueueGroup>> m_queueGroups;
-   std::array<u32, 16> m_queueIndices{};
+   QueueFamilySelection m_queueIndices{};
 };
 
 }// namespace triglav::graphics_api
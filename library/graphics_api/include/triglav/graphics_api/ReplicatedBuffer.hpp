@@ -49,9 +49,18 @@ class ReplicatedBuffer
       return BufferLock<TValue>{m_hostBuffer, m_mutex};
    }
 
-   void sync(CommandList& cmdList)
+   // Copies the values to the device buffer. When the work reading the buffer runs on another queue family, it
+   // needs to acquire the buffer with acquire().
+   void sync(CommandList& cmdList, const WorkTypeFlags consumerWorkTypes = WorkType::Graphics)
    {
       cmdList.copy_buffer(m_hostBuffer, m_deviceBuffer);
+      cmdList.release_buffer(m_deviceBuffer, PipelineStage::Transfer, consumerWorkTypes);
+   }
+
+   // Every sync overwrites the whole buffer, so the ownership doesn't need to be transferred back.
+   void acquire(CommandList& cmdList, const PipelineStageFlags stage, const WorkTypeFlags producerWorkTypes = WorkType::Transfer) const
+   {
+      cmdList.acquire_buffer(m_deviceBuffer, producerWorkTypes, stage);
    }
 
    [[nodiscard]] const Buffer& buffer() const
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Buffer.h"
+#include "GraphicsApi.hpp"
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace triglav::graphics_api {
+
+class Device;
+class StagingBufferPool;
+
+// Staging memory of the calling thread, a thread holds at most one at a time.
+class StagingMemory
+{
+ public:
+   ~StagingMemory();
+
+   StagingMemory(const StagingMemory& other) = delete;
+   StagingMemory& operator=(const StagingMemory& other) = delete;
+   StagingMemory(StagingMemory&& other) noexcept;
+   StagingMemory& operator=(StagingMemory&& other) = delete;
+
+   [[nodiscard]] std::span<u8> data() const;
+   // Null devices stage the data in host memory and have no buffer to copy from.
+   [[nodiscard]] const Buffer& buffer() const;
+
+ private:
+   friend class StagingBufferPool;
+
+   StagingMemory(StagingBufferPool& pool, u32 slot, std::span<u8> data);
+
+   StagingBufferPool* m_pool;
+   u32 m_slot;
+   std::span<u8> m_data;
+};
+
+// Persistently mapped staging buffers, one per thread like the command pools, so loaders write the data of their
+// uploads straight into memory the transfer queue copies from. A buffer grows to the largest upload of its thread,
+// buffers larger than g_maxRetainedStagingSize are released once their upload is finished.
+class StagingBufferPool
+{
+ public:
+   static constexpr MemorySize g_minStagingSize = 1024 * 1024;
+   static constexpr MemorySize g_maxRetainedStagingSize = 32 * 1024 * 1024;
+
+   explicit StagingBufferPool(Device& device);
+
+   [[nodiscard]] Result<StagingMemory> acquire(MemorySize size);
+
+ private:
+   friend class StagingMemory;
+
+   struct Slot
+   {
+      std::optional<Buffer> buffer;
+      std::optional<MappedMemory> mapping;
+      std::vector<u8> hostMemory;
+      std::span<u8> memory;
+      bool isAcquired{false};
+   };
+
+   void release(u32 slot);
+
+   Device& m_device;
+   std::vector<Slot> m_slots;
+};
+
+}// namespace triglav::graphics_api
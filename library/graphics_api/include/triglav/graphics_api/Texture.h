@@ -1,29 +1,46 @@
 #pragma once
 
 #include "Buffer.h"
+#include "MipFilter.h"
 #include "vulkan/ObjectWrapper.hpp"
 
+#include <span>
+#include <vector>
+
 namespace triglav::graphics_api {
 
 DECLARE_VLK_WRAPPED_CHILD_OBJECT(ImageView, Device)
 DECLARE_VLK_WRAPPED_CHILD_OBJECT(Image, Device)
 
 class CommandList;
+class MipMapGenerator;
 
 class Texture
 {
  public:
    Texture(vulkan::Image image, vulkan::DeviceMemory memory, vulkan::ImageView imageView, const ColorFormat& colorFormat,
-           TextureUsageFlags usageFlags, uint32_t width, uint32_t height, int mipCount);
+           TextureUsageFlags usageFlags, uint32_t width, uint32_t height, int mipCount, std::vector<vulkan::ImageView> mipViews = {});
 
    [[nodiscard]] VkImage vulkan_image() const;
    [[nodiscard]] VkImageView vulkan_image_view() const;
+   // View of a single mip level in the linear format, only available for storage textures.
+   [[nodiscard]] VkImageView vulkan_mip_view(int mipLevel) const;
    [[nodiscard]] TextureUsageFlags usage_flags() const;
    [[nodiscard]] uint32_t width() const;
    [[nodiscard]] uint32_t height() const;
    [[nodiscard]] Resolution resolution() const;
+   [[nodiscard]] Resolution mip_resolution(int mipLevel) const;
+   [[nodiscard]] int mip_count() const;
+   [[nodiscard]] const ColorFormat& format() const;
    [[nodiscard]] const SamplerProperties& sampler_properties() const;
    Status write(Device& device, const uint8_t* pixels) const;
+   // Writes level 0 and fills the remaining levels with the compute mip generator.
+   Status write(Device& device, const uint8_t* pixels, MipMapGenerator& mipMapGenerator, MipFilter filter) const;
+   // Writes precomputed data of every mip level, block compressed levels are uploaded as they are.
+   Status write_levels(Device& device, std::span<const std::span<const u8>> levels) const;
+   // Writes every mip level from data the writer puts straight into the staging memory. The offsets of the levels
+   // in that memory need to be aligned to the texel block size and to 4 bytes.
+   Status write_levels(Device& device, std::span<const MemorySize> levelOffsets, MemorySize size, const StagingWriter& writer) const;
    [[nodiscard]] Status generate_mip_maps(Device& device) const;
 
    void set_anisotropy_state(bool isEnabled);
@@ -31,6 +48,7 @@ class Texture
 
 
  private:
+   Status write_internal(Device& device, const uint8_t* pixels, MipMapGenerator* mipMapGenerator, MipFilter filter) const;
    void generate_mip_maps_internal(const CommandList& cmdList) const;
 
    uint32_t m_width{};
@@ -41,6 +59,7 @@ class Texture
    vulkan::DeviceMemory m_memory;
    vulkan::ImageView m_imageView;
    int m_mipCount;
+   std::vector<vulkan::ImageView> m_mipViews;
    SamplerProperties m_samplerProperties;
 };
 
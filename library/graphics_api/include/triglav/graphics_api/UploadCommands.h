@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CommandList.h"
+#include "GraphicsApi.hpp"
+
+#include <optional>
+
+namespace triglav::graphics_api {
+
+class Device;
+
+// Command lists of a one time upload. The copies are recorded on the transfer queue and the commands using the
+// uploaded resources, like generating mip maps, on the graphics queue, which waits for the copies with a semaphore.
+// Devices without a dedicated transfer queue family, like lavapipe, record both to a single graphics command list.
+class UploadCommands
+{
+ public:
+   [[nodiscard]] static Result<UploadCommands> create(Device& device);
+
+   [[nodiscard]] CommandList& transfer();
+   [[nodiscard]] CommandList& graphics();
+
+   // Hands a resource written by the transfer commands over to the graphics queue family, textures keep their state.
+   void transfer_ownership(const Buffer& buffer) const;
+   void transfer_ownership(const Texture& texture, TextureState state) const;
+
+   // Submits the commands and waits for them to finish.
+   [[nodiscard]] Status submit();
+
+ private:
+   UploadCommands(Device& device, CommandList transferCommands, std::optional<CommandList> graphicsCommands);
+
+   Device& m_device;
+   CommandList m_transferCommands;
+   std::optional<CommandList> m_graphicsCommands;
+};
+
+}// namespace triglav::graphics_api
@@ -3,6 +3,7 @@
 #include "CommandList.h"
 #include "Device.h"
 #include "ReplicatedBuffer.hpp"
+#include "UploadCommands.h"
 
 #include <cstring>
 
@@ -77,6 +78,10 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept
 
 Result<MappedMemory> Buffer::map_memory()
 {
+   // Buffers of a null device have no memory to map.
+   if (m_device.is_null())
+      return std::unexpected(Status::UnsupportedDevice);
+
    void* pointer;
    if (vkMapMemory(m_memory.parent(), *m_memory, 0, m_size, 0, &pointer) != VK_SUCCESS) {
       return std::unexpected(Status::UnsupportedDevice);
@@ -97,34 +102,34 @@ size_t Buffer::size() const
 
 Status Buffer::write_indirect(const void* data, size_t size)
 {
-   auto transferBuffer = m_device.create_buffer(BufferUsage::HostVisible | BufferUsage::TransferSrc, size);
-   if (not transferBuffer.has_value())
-      return transferBuffer.error();
-
-   {
-      const auto mappedMemory = transferBuffer->map_memory();
-      if (not mappedMemory.has_value())
-         return mappedMemory.error();
-
-      mappedMemory->write(data, size);
-   }
+   return this->write_indirect(size, [data](const std::span<u8> memory) {
+      std::memcpy(memory.data(), data, memory.size());
+      return true;
+   });
+}
 
-   auto oneTimeCommands = m_device.create_command_list();
-   if (not oneTimeCommands.has_value())
-      return oneTimeCommands.error();
+Status Buffer::write_indirect(const size_t size, const StagingWriter& writer)
+{
+   auto stagingMemory = m_device.staging_buffer_pool().acquire(size);
+   if (not stagingMemory.has_value())
+      return stagingMemory.error();
 
-   if (const auto res = oneTimeCommands->begin(SubmitType::OneTime); res != Status::Success)
-      return res;
+   if (not writer(stagingMemory->data()))
+      return Status::InvalidTransferSource;
 
-   oneTimeCommands->copy_buffer(*transferBuffer, *this);
+   if (m_device.is_null()) {
+      m_device.record_null_upload(size);
+      return Status::Success;
+   }
 
-   if (const auto res = oneTimeCommands->finish(); res != Status::Success)
-      return res;
+   auto uploadCommands = UploadCommands::create(m_device);
+   if (not uploadCommands.has_value())
+      return uploadCommands.error();
 
-   if (const auto res = m_device.submit_command_list_one_time(*oneTimeCommands); res != Status::Success)
-      return res;
+   uploadCommands->transfer().copy_buffer(stagingMemory->buffer(), *this, 0, 0, static_cast<u32>(size));
+   uploadCommands->transfer_ownership(*this);
 
-   return Status::Success;
+   return uploadCommands->submit();
 }
 
 }// namespace triglav::graphics_api
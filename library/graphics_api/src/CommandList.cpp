@@ -12,6 +12,27 @@
 
 namespace triglav::graphics_api {
 
+namespace {
+
+// Access masks are left to the release and acquire, each only covers the accesses of its own queue.
+VkImageMemoryBarrier ownership_barrier(const TextureBarrierInfo& info, const u32 sourceQueueFamily, const u32 targetQueueFamily)
+{
+   VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+   barrier.oldLayout = vulkan::to_vulkan_image_layout(info.sourceState);
+   barrier.newLayout = vulkan::to_vulkan_image_layout(info.targetState);
+   barrier.srcQueueFamilyIndex = sourceQueueFamily;
+   barrier.dstQueueFamilyIndex = targetQueueFamily;
+   barrier.image = info.texture->vulkan_image();
+   barrier.subresourceRange.aspectMask = vulkan::to_vulkan_aspect_flags(info.texture->usage_flags());
+   barrier.subresourceRange.baseMipLevel = info.baseMipLevel;
+   barrier.subresourceRange.levelCount = info.mipLevelCount;
+   barrier.subresourceRange.baseArrayLayer = 0;
+   barrier.subresourceRange.layerCount = 1;
+   return barrier;
+}
+
+}// namespace
+
 CommandList::CommandList(Device& device, const VkCommandBuffer commandBuffer, const VkCommandPool commandPool,
                          const WorkTypeFlags workTypes) :
     m_device(device),
@@ -163,6 +184,17 @@ void CommandList::draw_primitives(const int vertexCount, const int vertexOffset)
    this->draw_primitives(vertexCount, vertexOffset, 1, 0);
 }
 
+void CommandList::draw_indirect(const Buffer& drawCallBuffer, const u32 drawCount)
+{
+   if (m_hasPendingDescriptors) {
+      m_hasPendingDescriptors = false;
+      this->push_descriptors(0, m_descriptorWriter, PipelineType::Graphics);
+      m_descriptorWriter.reset_count();
+   }
+
+   vkCmdDrawIndirect(m_commandBuffer, drawCallBuffer.vulkan_buffer(), 0, drawCount, sizeof(DrawIndirectCommand));
+}
+
 void CommandList::draw_indexed_primitives(const int indexCount, const int indexOffset, const int vertexOffset)
 {
    if (m_hasPendingDescriptors) {
@@ -189,6 +221,17 @@ void CommandList::dispatch(u32 x, u32 y, u32 z)
    vkCmdDispatch(m_commandBuffer, x, y, z);
 }
 
+void CommandList::dispatch_indirect(const Buffer& dispatchBuffer)
+{
+   if (m_hasPendingDescriptors) {
+      m_hasPendingDescriptors = false;
+      this->push_descriptors(0, m_descriptorWriter, PipelineType::Compute);
+      m_descriptorWriter.reset_count();
+   }
+
+   vkCmdDispatchIndirect(m_commandBuffer, dispatchBuffer.vulkan_buffer(), 0);
+}
+
 void CommandList::bind_vertex_buffer(const Buffer& buffer, uint32_t layoutIndex) const
 {
    const std::array buffers{buffer.vulkan_buffer()};
@@ -219,10 +262,13 @@ void CommandList::copy_buffer(const Buffer& source, const Buffer& dest, u32 srcO
    vkCmdCopyBuffer(m_commandBuffer, source.vulkan_buffer(), dest.vulkan_buffer(), 1, &region);
 }
 
-void CommandList::copy_buffer_to_texture(const Buffer& source, const Texture& destination, const int mipLevel) const
+void CommandList::copy_buffer_to_texture(const Buffer& source, const Texture& destination, const int mipLevel,
+                                         const MemorySize bufferOffset) const
 {
+   const auto mipResolution = destination.mip_resolution(mipLevel);
+
    VkBufferImageCopy region{};
-   region.bufferOffset = 0;
+   region.bufferOffset = bufferOffset;
    region.bufferRowLength = 0;
    region.bufferImageHeight = 0;
    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -230,11 +276,30 @@ void CommandList::copy_buffer_to_texture(const Buffer& source, const Texture& de
    region.imageSubresource.baseArrayLayer = 0;
    region.imageSubresource.layerCount = 1;
    region.imageOffset = {0, 0, 0};
-   region.imageExtent = {destination.width(), destination.height(), 1};
+   region.imageExtent = {mipResolution.width, mipResolution.height, 1};
    vkCmdCopyBufferToImage(m_commandBuffer, source.vulkan_buffer(), destination.vulkan_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
                           &region);
 }
 
+void CommandList::copy_texture_to_buffer(const Texture& source, const Buffer& destination, const int mipLevel,
+                                         const MemorySize bufferOffset) const
+{
+   const auto mipResolution = source.mip_resolution(mipLevel);
+
+   VkBufferImageCopy region{};
+   region.bufferOffset = bufferOffset;
+   region.bufferRowLength = 0;
+   region.bufferImageHeight = 0;
+   region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+   region.imageSubresource.mipLevel = mipLevel;
+   region.imageSubresource.baseArrayLayer = 0;
+   region.imageSubresource.layerCount = 1;
+   region.imageOffset = {0, 0, 0};
+   region.imageExtent = {mipResolution.width, mipResolution.height, 1};
+   vkCmdCopyImageToBuffer(m_commandBuffer, source.vulkan_image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, destination.vulkan_buffer(), 1,
+                          &region);
+}
+
 void CommandList::copy_texture(const Texture& source, const TextureState srcState, const Texture& destination, const TextureState dstState)
 {
    VkImageCopy imageCopy{.srcSubresource{
@@ -306,6 +371,79 @@ void CommandList::execution_barrier(PipelineStageFlags sourceStage, PipelineStag
                         vulkan::to_vulkan_pipeline_stage_flags(targetStage), 0, 0, nullptr, 0, nullptr, 0, nullptr);
 }
 
+void CommandList::memory_barrier(PipelineStageFlags sourceStage, PipelineStageFlags targetStage) const
+{
+   VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+   barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+   barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+   vkCmdPipelineBarrier(m_commandBuffer, vulkan::to_vulkan_pipeline_stage_flags(sourceStage),
+                        vulkan::to_vulkan_pipeline_stage_flags(targetStage), 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void CommandList::release_buffer(const Buffer& buffer, const PipelineStageFlags sourceStage, const WorkTypeFlags targetWorkTypes) const
+{
+   auto& queueManager = m_device.queue_manager();
+   if (queueManager.shares_queue_family(m_workTypes, targetWorkTypes))
+      return;
+
+   VkBufferMemoryBarrier barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+   barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+   barrier.srcQueueFamilyIndex = queueManager.queue_index(m_workTypes);
+   barrier.dstQueueFamilyIndex = queueManager.queue_index(targetWorkTypes);
+   barrier.buffer = buffer.vulkan_buffer();
+   barrier.size = VK_WHOLE_SIZE;
+
+   vkCmdPipelineBarrier(m_commandBuffer, vulkan::to_vulkan_pipeline_stage_flags(sourceStage), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                        nullptr, 1, &barrier, 0, nullptr);
+}
+
+void CommandList::acquire_buffer(const Buffer& buffer, const WorkTypeFlags sourceWorkTypes, const PipelineStageFlags targetStage) const
+{
+   auto& queueManager = m_device.queue_manager();
+   if (queueManager.shares_queue_family(sourceWorkTypes, m_workTypes))
+      return;
+
+   VkBufferMemoryBarrier barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+   barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+   barrier.srcQueueFamilyIndex = queueManager.queue_index(sourceWorkTypes);
+   barrier.dstQueueFamilyIndex = queueManager.queue_index(m_workTypes);
+   barrier.buffer = buffer.vulkan_buffer();
+   barrier.size = VK_WHOLE_SIZE;
+
+   // The target stage is also the source one, so that the barrier chains with the semaphore wait of the same stage.
+   const auto stage = vulkan::to_vulkan_pipeline_stage_flags(targetStage);
+   vkCmdPipelineBarrier(m_commandBuffer, stage, stage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void CommandList::release_texture(const PipelineStageFlags sourceStage, const TextureBarrierInfo& info,
+                                  const WorkTypeFlags targetWorkTypes) const
+{
+   auto& queueManager = m_device.queue_manager();
+   if (queueManager.shares_queue_family(m_workTypes, targetWorkTypes))
+      return;
+
+   auto barrier = ownership_barrier(info, queueManager.queue_index(m_workTypes), queueManager.queue_index(targetWorkTypes));
+   barrier.srcAccessMask = vulkan::to_vulkan_access_flags(info.sourceState);
+
+   vkCmdPipelineBarrier(m_commandBuffer, vulkan::to_vulkan_pipeline_stage_flags(sourceStage), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                        nullptr, 0, nullptr, 1, &barrier);
+}
+
+void CommandList::acquire_texture(const WorkTypeFlags sourceWorkTypes, const PipelineStageFlags targetStage,
+                                  const TextureBarrierInfo& info) const
+{
+   auto& queueManager = m_device.queue_manager();
+   if (queueManager.shares_queue_family(sourceWorkTypes, m_workTypes))
+      return;
+
+   auto barrier = ownership_barrier(info, queueManager.queue_index(sourceWorkTypes), queueManager.queue_index(m_workTypes));
+   barrier.dstAccessMask = vulkan::to_vulkan_access_flags(info.targetState);
+
+   const auto stage = vulkan::to_vulkan_pipeline_stage_flags(targetStage);
+   vkCmdPipelineBarrier(m_commandBuffer, stage, stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
 void CommandList::blit_texture(const Texture& sourceTex, const TextureRegion& sourceRegion, const Texture& targetTex,
                                const TextureRegion& targetRegion) const
 {
@@ -389,4 +527,17 @@ void CommandList::bind_texture(u32 binding, const Texture& texture)
    m_hasPendingDescriptors = true;
 }
 
+void CommandList::bind_texture_mip(const u32 binding, const Texture& texture, const int mipLevel)
+{
+   auto& sampler = m_device.sampler_cache().find_sampler(texture.sampler_properties());
+   m_descriptorWriter.set_sampled_texture_mip(binding, texture, mipLevel, sampler);
+   m_hasPendingDescriptors = true;
+}
+
+void CommandList::bind_storage_images(const u32 binding, const Texture& texture, const int baseMipLevel, const int mipLevelCount)
+{
+   m_descriptorWriter.set_storage_images(binding, texture, baseMipLevel, mipLevelCount);
+   m_hasPendingDescriptors = true;
+}
+
 }// namespace triglav::graphics_api
@@ -7,6 +7,8 @@
 
 #include <Device.h>
 
+#include <algorithm>
+
 namespace triglav::graphics_api {
 
 DescriptorWriter::DescriptorWriter(const Device& device, const DescriptorView& descView) :
@@ -85,6 +87,35 @@ void DescriptorWriter::set_sampled_texture(const uint32_t binding, const Texture
    writeDescriptorSet.pImageInfo = imageInfo;
 }
 
+void DescriptorWriter::set_sampled_texture_mip(const uint32_t binding, const Texture& texture, const int mipLevel, const Sampler& sampler)
+{
+   auto& writeDescriptorSet = write_binding(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+   auto imageInfo = m_descriptorImageInfoPool.aquire_object();
+   imageInfo->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+   imageInfo->imageView = texture.vulkan_mip_view(mipLevel);
+   imageInfo->sampler = sampler.vulkan_sampler();
+
+   writeDescriptorSet.pImageInfo = imageInfo;
+}
+
+void DescriptorWriter::set_storage_images(const uint32_t binding, const Texture& texture, const int baseMipLevel, const int mipLevelCount)
+{
+   auto& writeDescriptorSet = write_binding(binding, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+
+   auto& imageInfos = m_imageArrayInfos[binding];
+   imageInfos.resize(mipLevelCount);
+   for (int i = 0; i < mipLevelCount; ++i) {
+      // Elements past the last level repeat it, so the whole array holds valid descriptors.
+      imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+      imageInfos[i].imageView = texture.vulkan_mip_view(std::min(baseMipLevel + i, texture.mip_count() - 1));
+      imageInfos[i].sampler = VK_NULL_HANDLE;
+   }
+
+   writeDescriptorSet.descriptorCount = static_cast<u32>(mipLevelCount);
+   writeDescriptorSet.pImageInfo = imageInfos.data();
+}
+
 VkWriteDescriptorSet& DescriptorWriter::write_binding(const u32 binding, VkDescriptorType descType)
 {
    assert(binding < 16);
@@ -99,7 +130,7 @@ VkWriteDescriptorSet& DescriptorWriter::write_binding(const u32 binding, VkDescr
       m_descriptorBufferInfoPool.release_object(writeDescriptorSet.pBufferInfo);
       writeDescriptorSet.pBufferInfo = nullptr;
    }
-   if (writeDescriptorSet.pImageInfo != nullptr) {
+   if (writeDescriptorSet.pImageInfo != nullptr && writeDescriptorSet.pImageInfo != m_imageArrayInfos[binding].data()) {
       m_descriptorImageInfoPool.release_object(writeDescriptorSet.pImageInfo);
       writeDescriptorSet.pImageInfo = nullptr;
    }
@@ -136,7 +167,8 @@ DescriptorWriter::DescriptorWriter(DescriptorWriter&& other) noexcept :
     m_topBinding(std::exchange(other.m_topBinding, 0)),
     m_descriptorBufferInfoPool(std::move(other.m_descriptorBufferInfoPool)),
     m_descriptorImageInfoPool(std::move(other.m_descriptorImageInfoPool)),
-    m_descriptorWrites(std::move(other.m_descriptorWrites))
+    m_descriptorWrites(std::move(other.m_descriptorWrites)),
+    m_imageArrayInfos(std::move(other.m_imageArrayInfos))
 {
 }
 
@@ -146,6 +178,7 @@ DescriptorWriter& DescriptorWriter::operator=(DescriptorWriter&& other) noexcept
    m_descriptorSet = std::exchange(other.m_descriptorSet, nullptr);
    m_topBinding = std::exchange(other.m_topBinding, 0);
    m_descriptorWrites = other.m_descriptorWrites;
+   m_imageArrayInfos = std::move(other.m_imageArrayInfos);
    return *this;
 }
 
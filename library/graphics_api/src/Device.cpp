@@ -57,15 +57,46 @@ uint32_t swapchain_image_count(const uint32_t min, const uint32_t max)
    return std::min(std::max(2u, min + 1), max);
 }
 
+// Size of the texture levels without any padding a GPU would add.
+MemorySize texture_memory_size(const ColorFormat& format, const Resolution& imageSize, const int mipCount)
+{
+   MemorySize result{};
+   u32 width = imageSize.width;
+   u32 height = imageSize.height;
+   for (int mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+      if (format.is_block_compressed()) {
+         const MemorySize blockSize = format.order == ColorFormatOrder::BC1 || format.order == ColorFormatOrder::BC4 ? 8 : 16;
+         result += blockSize * ((width + 3) / 4) * ((height + 3) / 4);
+      } else {
+         result += format.pixel_size() * width * height;
+      }
+      width = std::max(width / 2, 1u);
+      height = std::max(height / 2, 1u);
+   }
+   return result;
+}
+
 }// namespace
 
-Device::Device(vulkan::Device device, const VkPhysicalDevice physicalDevice, std::vector<QueueFamilyInfo>&& queueFamilyInfos) :
+Device::Device(vulkan::Device device, const VkPhysicalDevice physicalDevice, std::vector<QueueFamilyInfo>&& queueFamilyInfos,
+               const DeviceFeatures& features) :
     m_device(std::move(device)),
     m_physicalDevice(physicalDevice),
     m_queueFamilyInfos{std::move(queueFamilyInfos)},
+    m_features(features),
     m_queueManager(*this, m_queueFamilyInfos),
-    m_samplerCache(*this)
+    m_samplerCache(*this),
+    m_stagingBufferPool(*this)
+{
+}
+
+std::unique_ptr<Device> Device::create_null()
 {
+   // The null device takes the same paths as a device with every feature, so it measures the loaders like a GPU would.
+   auto device = std::make_unique<Device>(vulkan::Device{}, nullptr, std::vector<QueueFamilyInfo>{},
+                                          DeviceFeatures{.storageImageWithoutFormat = true});
+   device->m_nullStats = std::make_unique<NullDeviceStats>();
+   return device;
 }
 
 Result<Swapchain> Device::create_swapchain(const Surface& surface, ColorFormat colorFormat, ColorSpace colorSpace,
@@ -151,6 +182,12 @@ Result<Swapchain> Device::create_swapchain(const Surface& surface, ColorFormat c
 
 Result<Shader> Device::create_shader(const PipelineStage stage, const std::string_view entrypoint, const std::span<const char> code)
 {
+   if (this->is_null()) {
+      ++m_nullStats->shaderCount;
+      m_nullStats->shaderCodeSize += code.size();
+      return Shader(std::string{entrypoint}, stage, vulkan::ShaderModule(*m_device));
+   }
+
    VkShaderModuleCreateInfo shaderModuleInfo{};
    shaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
    shaderModuleInfo.codeSize = code.size();
@@ -173,6 +210,12 @@ Result<Buffer> Device::create_buffer(const BufferUsageFlags usage, const uint64_
 {
    assert(size != 0);
 
+   if (this->is_null()) {
+      ++m_nullStats->bufferCount;
+      m_nullStats->bufferMemory += size;
+      return Buffer{*this, size, vulkan::Buffer(*m_device), vulkan::DeviceMemory(*m_device)};
+   }
+
    VkBufferCreateInfo bufferInfo{};
    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
    bufferInfo.size = size;
@@ -206,6 +249,9 @@ Result<Buffer> Device::create_buffer(const BufferUsageFlags usage, const uint64_
 
 Result<Fence> Device::create_fence() const
 {
+   if (this->is_null())
+      return Fence(vulkan::Fence(*m_device));
+
    VkFenceCreateInfo fenceInfo{};
    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
@@ -220,6 +266,9 @@ Result<Fence> Device::create_fence() const
 
 Result<Semaphore> Device::create_semaphore() const
 {
+   if (this->is_null())
+      return Semaphore(vulkan::Semaphore(*m_device));
+
    VkSemaphoreCreateInfo semaphoreInfo{};
    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
@@ -240,10 +289,23 @@ Result<Texture> Device::create_texture(const ColorFormat& format, const Resoluti
       mipCount = static_cast<int>(std::floor(std::log2(std::max(imageSize.width, imageSize.height)))) + 1;
    }
 
+   if (this->is_null()) {
+      ++m_nullStats->textureCount;
+      m_nullStats->textureMemory += texture_memory_size(format, imageSize, mipCount);
+      return Texture(vulkan::Image(*m_device), vulkan::DeviceMemory(*m_device), vulkan::ImageView(*m_device), format, usageFlags,
+                     imageSize.width, imageSize.height, mipCount, {});
+   }
+
+   // sRGB formats don't support storage, the storage views of such textures use the linear format instead.
+   const auto isStorage = usageFlags & TextureUsage::Storage;
+   const auto hasLinearStorageViews = isStorage && format.is_srgb();
+   const VkImageCreateFlags imageFlags =
+      hasLinearStorageViews ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT : 0;
+
    VkImageFormatProperties formatProperties;
    if (const auto res =
           vkGetPhysicalDeviceImageFormatProperties(m_physicalDevice, vulkanColorFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                                   vulkan::to_vulkan_image_usage_flags(usageFlags), 0, &formatProperties);
+                                                   vulkan::to_vulkan_image_usage_flags(usageFlags), imageFlags, &formatProperties);
        res != VK_SUCCESS) {
       return std::unexpected(Status::UnsupportedDevice);
    }
@@ -254,6 +316,7 @@ Result<Texture> Device::create_texture(const ColorFormat& format, const Resoluti
 
    VkImageCreateInfo imageInfo{};
    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+   imageInfo.flags = imageFlags;
    imageInfo.format = vulkanColorFormat;
    imageInfo.extent = VkExtent3D{imageSize.width, imageSize.height, 1};
    imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -288,9 +351,11 @@ Result<Texture> Device::create_texture(const ColorFormat& format, const Resoluti
    imageViewInfo.image = *image;
    imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
    imageViewInfo.format = vulkanColorFormat;
+   // Single channel compressed textures hold grayscale data, the view replicates it so they sample like the source image.
+   const auto isGrayscale = format.order == ColorFormatOrder::BC4;
    imageViewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-   imageViewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-   imageViewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+   imageViewInfo.components.g = isGrayscale ? VK_COMPONENT_SWIZZLE_R : VK_COMPONENT_SWIZZLE_IDENTITY;
+   imageViewInfo.components.b = isGrayscale ? VK_COMPONENT_SWIZZLE_R : VK_COMPONENT_SWIZZLE_IDENTITY;
    imageViewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
    imageViewInfo.subresourceRange.aspectMask = vulkan::to_vulkan_image_aspect_flags(usageFlags);
    imageViewInfo.subresourceRange.baseMipLevel = 0;
@@ -298,16 +363,42 @@ Result<Texture> Device::create_texture(const ColorFormat& format, const Resoluti
    imageViewInfo.subresourceRange.baseArrayLayer = 0;
    imageViewInfo.subresourceRange.layerCount = 1;
 
+   VkImageViewUsageCreateInfo viewUsageInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO};
+   if (hasLinearStorageViews) {
+      viewUsageInfo.usage = imageInfo.usage & ~VK_IMAGE_USAGE_STORAGE_BIT;
+      imageViewInfo.pNext = &viewUsageInfo;
+   }
+
    vulkan::ImageView imageView(*m_device);
    if (imageView.construct(&imageViewInfo) != VK_SUCCESS)
       return std::unexpected(Status::UnsupportedDevice);
 
+   // Storage textures get an additional view for each mip level.
+   std::vector<vulkan::ImageView> mipViews;
+   if (isStorage) {
+      imageViewInfo.pNext = nullptr;
+      imageViewInfo.format = *vulkan::to_vulkan_color_format(format.linear_format());
+      imageViewInfo.subresourceRange.levelCount = 1;
+
+      mipViews.reserve(mipCount);
+      for (int mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+         imageViewInfo.subresourceRange.baseMipLevel = mipLevel;
+
+         auto& mipView = mipViews.emplace_back(*m_device);
+         if (mipView.construct(&imageViewInfo) != VK_SUCCESS)
+            return std::unexpected(Status::UnsupportedDevice);
+      }
+   }
+
    return Texture(std::move(image), std::move(imageMemory), std::move(imageView), format, usageFlags, imageSize.width, imageSize.height,
-                  mipCount);
+                  mipCount, std::move(mipViews));
 }
 
 Result<Sampler> Device::create_sampler(const SamplerProperties& info)
 {
+   if (this->is_null())
+      return Sampler(vulkan::Sampler(*m_device));
+
    VkPhysicalDeviceProperties properties{};
    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
 
@@ -339,6 +430,9 @@ Result<Sampler> Device::create_sampler(const SamplerProperties& info)
 
 Result<TimestampArray> Device::create_timestamp_array(const u32 timestampCount)
 {
+   if (this->is_null())
+      return TimestampArray(vulkan::QueryPool(*m_device), 1.0f);
+
    VkQueryPoolCreateInfo queryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
    queryPoolInfo.queryCount = timestampCount;
@@ -438,6 +532,9 @@ QueueManager& Device::queue_manager()
 
 void Device::await_all() const
 {
+   if (this->is_null())
+      return;
+
    vkDeviceWaitIdle(*m_device);
 }
 
@@ -460,11 +557,73 @@ SamplerCache& Device::sampler_cache()
    return m_samplerCache;
 }
 
+StagingBufferPool& Device::staging_buffer_pool()
+{
+   return m_stagingBufferPool;
+}
+
 u32 Device::min_storage_buffer_alignment() const
 {
+   // The largest alignment a Vulkan implementation may require.
+   if (this->is_null())
+      return 256;
+
    VkPhysicalDeviceProperties props;
    vkGetPhysicalDeviceProperties(m_physicalDevice, &props);
    return props.limits.minStorageBufferOffsetAlignment;
 }
 
+const DeviceFeatures& Device::features() const
+{
+   return m_features;
+}
+
+bool Device::is_texture_format_supported(const ColorFormat& format, const TextureUsageFlags usageFlags) const
+{
+   const auto vulkanColorFormat = vulkan::to_vulkan_color_format(format);
+   if (not vulkanColorFormat.has_value())
+      return false;
+   if (this->is_null())
+      return true;
+
+   // Same as in create_texture, storage views of sRGB textures use the linear format.
+   const auto isStorage = usageFlags & TextureUsage::Storage;
+   const auto hasLinearStorageViews = isStorage && format.is_srgb();
+   if (isStorage) {
+      const auto storageFormat = vulkan::to_vulkan_color_format(hasLinearStorageViews ? format.linear_format() : format);
+      if (not storageFormat.has_value())
+         return false;
+
+      VkFormatProperties storageFormatProperties;
+      vkGetPhysicalDeviceFormatProperties(m_physicalDevice, *storageFormat, &storageFormatProperties);
+      if (not(storageFormatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+         return false;
+   }
+
+   const VkImageCreateFlags imageFlags =
+      hasLinearStorageViews ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT : 0;
+
+   VkImageFormatProperties formatProperties;
+   return vkGetPhysicalDeviceImageFormatProperties(m_physicalDevice, *vulkanColorFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
+                                                   vulkan::to_vulkan_image_usage_flags(usageFlags), imageFlags,
+                                                   &formatProperties) == VK_SUCCESS;
+}
+
+bool Device::is_null() const
+{
+   return m_nullStats != nullptr;
+}
+
+NullDeviceStats* Device::null_stats() const
+{
+   return m_nullStats.get();
+}
+
+void Device::record_null_upload(const MemorySize size) const
+{
+   assert(this->is_null());
+   ++m_nullStats->uploadCount;
+   m_nullStats->uploadSize += size;
+}
+
 }// namespace triglav::graphics_api
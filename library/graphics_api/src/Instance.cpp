@@ -96,6 +96,16 @@ Result<Surface> Instance::create_surface(const desktop::ISurface& surface) const
 }
 
 Result<DeviceUPtr> Instance::create_device(const Surface& surface, const DevicePickStrategy strategy) const
+{
+   return this->create_device_internal(&surface, strategy);
+}
+
+Result<DeviceUPtr> Instance::create_headless_device(const DevicePickStrategy strategy) const
+{
+   return this->create_device_internal(nullptr, strategy);
+}
+
+Result<DeviceUPtr> Instance::create_device_internal(const Surface* surface, const DevicePickStrategy strategy) const
 {
    auto physicalDevices = vulkan::get_physical_devices(*m_instance);
    auto pickedDevice = std::find_if(physicalDevices.begin(), physicalDevices.end(), create_physical_device_pick_predicate(strategy));
@@ -111,7 +121,8 @@ Result<DeviceUPtr> Instance::create_device(const Surface& surface, const DeviceP
    u32 queueIndex{};
    for (const auto& family : queueFamilies) {
       VkBool32 canPresent{};
-      if (vkGetPhysicalDeviceSurfaceSupportKHR(*pickedDevice, queueIndex, surface.vulkan_surface(), &canPresent) != VK_SUCCESS)
+      if (surface != nullptr &&
+          vkGetPhysicalDeviceSurfaceSupportKHR(*pickedDevice, queueIndex, surface->vulkan_surface(), &canPresent) != VK_SUCCESS)
          return std::unexpected(Status::UnsupportedDevice);
 
       QueueFamilyInfo info{};
@@ -151,10 +162,12 @@ Result<DeviceUPtr> Instance::create_device(const Surface& surface, const DeviceP
    }
 
    std::vector<const char*> vulkanDeviceExtensions{
-      VK_KHR_SWAPCHAIN_EXTENSION_NAME,
       VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
       "VK_KHR_shader_non_semantic_info",
    };
+   if (surface != nullptr) {
+      vulkanDeviceExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+   }
 
    const auto extensionProperties = vulkan::get_device_extension_properties(*pickedDevice, nullptr);
    for (const auto& property : extensionProperties) {
@@ -168,6 +181,15 @@ Result<DeviceUPtr> Instance::create_device(const Surface& surface, const DeviceP
    VkPhysicalDeviceHostQueryResetFeatures hostQueryResetFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES};
    hostQueryResetFeatures.hostQueryReset = true;
 
+   VkPhysicalDeviceFeatures supportedFeatures{};
+   vkGetPhysicalDeviceFeatures(*pickedDevice, &supportedFeatures);
+
+   // Without these the compute mip generator can't be used, textures fall back to blitted mip maps.
+   const DeviceFeatures features{
+      .storageImageWithoutFormat =
+         supportedFeatures.shaderStorageImageReadWithoutFormat && supportedFeatures.shaderStorageImageWriteWithoutFormat,
+   };
+
    VkPhysicalDeviceFeatures2 deviceFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
    deviceFeatures.pNext = &hostQueryResetFeatures;
    deviceFeatures.features.sampleRateShading = true;
@@ -175,6 +197,8 @@ Result<DeviceUPtr> Instance::create_device(const Surface& surface, const DeviceP
    deviceFeatures.features.fillModeNonSolid = true;
    deviceFeatures.features.wideLines = true;
    deviceFeatures.features.samplerAnisotropy = true;
+   deviceFeatures.features.shaderStorageImageReadWithoutFormat = features.storageImageWithoutFormat;
+   deviceFeatures.features.shaderStorageImageWriteWithoutFormat = features.storageImageWithoutFormat;
 
    VkDeviceCreateInfo deviceInfo{};
    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -189,7 +213,7 @@ Result<DeviceUPtr> Instance::create_device(const Surface& surface, const DeviceP
       return std::unexpected(Status::UnsupportedDevice);
    }
 
-   return std::make_unique<Device>(std::move(device), *pickedDevice, std::move(queueFamilyInfos));
+   return std::make_unique<Device>(std::move(device), *pickedDevice, std::move(queueFamilyInfos), features);
 }
 
 #if GAPI_ENABLE_VALIDATION
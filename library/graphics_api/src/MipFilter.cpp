@@ -0,0 +1,62 @@
+#include "MipFilter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+namespace triglav::graphics_api {
+
+namespace mip {
+
+// The filter is defined once in GLSL and shared with the compute shader.
+using namespace glm;
+using uint = u32;
+
+#include "mip_generation/filter.glsl"
+
+}// namespace mip
+
+std::vector<std::vector<glm::vec4>> generate_mip_chain_reference(const std::span<const glm::vec4> texels, const Resolution& resolution,
+                                                                 const int mipCount, const MipFilter filter, const bool isSrgb)
+{
+   assert(texels.size() == resolution.width * resolution.height);
+
+   const auto filterType = static_cast<u32>(filter);
+
+   std::vector<glm::vec4> level(texels.size());
+   std::ranges::transform(texels, level.begin(), [&](const glm::vec4& texel) { return mip::mip_decode(texel, filterType, isSrgb); });
+
+   std::vector<std::vector<glm::vec4>> result;
+   auto width = resolution.width;
+   auto height = resolution.height;
+
+   for (int mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+      const auto dstWidth = std::max(width / 2, 1u);
+      const auto dstHeight = std::max(height / 2, 1u);
+
+      // Edge texels are repeated outside of the level, same as the clamped loads in the shader.
+      const auto load = [&](const u32 x, const u32 y) { return level[std::min(y, height - 1) * width + std::min(x, width - 1)]; };
+
+      std::vector<glm::vec4> reduced(dstWidth * dstHeight);
+      for (u32 y = 0; y < dstHeight; ++y) {
+         for (u32 x = 0; x < dstWidth; ++x) {
+            reduced[y * dstWidth + x] = mip::mip_reduce(load(2 * x, 2 * y), load(2 * x + 1, 2 * y), load(2 * x, 2 * y + 1),
+                                                        load(2 * x + 1, 2 * y + 1), filterType);
+         }
+      }
+
+      auto& encoded = result.emplace_back(reduced.size());
+      std::ranges::transform(reduced, encoded.begin(), [&](const glm::vec4& value) { return mip::mip_encode(value, filterType, isSrgb); });
+
+      level = std::move(reduced);
+      width = dstWidth;
+      height = dstHeight;
+   }
+
+   return result;
+}
+
+}// namespace triglav::graphics_api
@@ -0,0 +1,140 @@
+#include "MipMapGenerator.h"
+
+#include "CommandList.h"
+#include "Device.h"
+#include "PipelineBuilder.h"
+#include "Texture.h"
+
+#include <array>
+#include <cassert>
+
+namespace triglav::graphics_api {
+
+namespace {
+
+// Each workgroup reduces a 64x64 tile of the source.
+constexpr u32 g_workgroupTileSize = 64;
+// Levels written by each workgroup, the last workgroup to finish continues from a single tile of the last one.
+constexpr int g_levelsPerPass = 6;
+// Largest source whose sixth level fits in the single tile the continuation reduces.
+constexpr u32 g_maxContinuedSourceSize = g_workgroupTileSize * g_workgroupTileSize;
+
+// Dispatches recorded at the same time use separate counters, the shader resets its counter when done.
+constexpr u32 g_counterCount = 64;
+// Keeps each counter within its own minStorageBufferOffsetAlignment block.
+constexpr u32 g_counterStride = 256;
+
+struct DownsamplePushConstants
+{
+   int sourceSize[2];
+   u32 mipCount;
+   u32 workgroupCount;
+   u32 filterType;
+   u32 isSrgb;
+};
+
+Buffer create_counter_buffer(Device& device)
+{
+   auto buffer = GAPI_CHECK(device.create_buffer(BufferUsage::StorageBuffer | BufferUsage::TransferDst, g_counterCount * g_counterStride));
+   const std::array<u8, g_counterCount * g_counterStride> zeros{};
+   GAPI_CHECK_STATUS(buffer.write_indirect(zeros.data(), zeros.size()));
+   return buffer;
+}
+
+}// namespace
+
+MipMapGenerator::MipMapGenerator(Device& device, const Shader& downsampleShader) :
+    m_pipeline(GAPI_CHECK(ComputePipelineBuilder(device)
+                             .compute_shader(downsampleShader)
+                             .descriptor_binding(DescriptorType::ImageSampler)
+                             .descriptor_binding(DescriptorType::StorageBuffer)
+                             .descriptor_binding_array(DescriptorType::StorageImage, g_maxGeneratedMipCount)
+                             .push_constant(PipelineStage::ComputeShader, sizeof(DownsamplePushConstants))
+                             .use_push_descriptors(true)
+                             .build())),
+    m_counterBuffer(create_counter_buffer(device))
+{
+}
+
+void MipMapGenerator::generate(CommandList& cmdList, const Texture& texture, const MipFilter filter)
+{
+   assert(can_generate(texture));
+   if (texture.mip_count() <= 1)
+      return;
+
+   this->dispatch(cmdList, texture, 0, texture, 1, texture.mip_count() - 1, filter);
+}
+
+void MipMapGenerator::downsample(CommandList& cmdList, const Texture& source, const Texture& destination, const MipFilter filter)
+{
+   assert(destination.usage_flags() & TextureUsage::Storage);
+   assert(destination.mip_count() <= g_maxGeneratedMipCount);
+   // The source is sampled through its regular view, the shader only handles the sRGB encoding of the generated levels.
+   assert(!source.format().is_srgb() && !destination.format().is_srgb());
+
+   this->dispatch(cmdList, source, -1, destination, 0, destination.mip_count(), filter);
+}
+
+bool MipMapGenerator::can_generate(const Texture& texture)
+{
+   return (texture.usage_flags() & TextureUsage::Storage) && texture.mip_count() - 1 <= g_maxGeneratedMipCount;
+}
+
+void MipMapGenerator::dispatch(CommandList& cmdList, const Texture& source, const int sourceMipLevel, const Texture& destination,
+                               const int baseMipLevel, const int mipCount, const MipFilter filter)
+{
+   const auto sourceResolution = sourceMipLevel < 0 ? source.resolution() : source.mip_resolution(sourceMipLevel);
+
+   // Larger sources need a second dispatch that starts from the last level of the first one.
+   if (mipCount > g_levelsPerPass &&
+       (sourceResolution.width > g_maxContinuedSourceSize || sourceResolution.height > g_maxContinuedSourceSize)) {
+      this->dispatch(cmdList, source, sourceMipLevel, destination, baseMipLevel, g_levelsPerPass, filter);
+      this->dispatch(cmdList, destination, baseMipLevel + g_levelsPerPass - 1, destination, baseMipLevel + g_levelsPerPass,
+                     mipCount - g_levelsPerPass, filter);
+      return;
+   }
+
+   const auto workgroupCountX = (sourceResolution.width + g_workgroupTileSize - 1) / g_workgroupTileSize;
+   const auto workgroupCountY = (sourceResolution.height + g_workgroupTileSize - 1) / g_workgroupTileSize;
+
+   const TextureBarrierInfo storageBarrier{
+      .texture = &destination,
+      .sourceState = TextureState::Undefined,
+      .targetState = TextureState::General,
+      .baseMipLevel = baseMipLevel,
+      .mipLevelCount = mipCount,
+   };
+   cmdList.texture_barrier(PipelineStage::Entrypoint, PipelineStage::ComputeShader, storageBarrier);
+
+   DownsamplePushConstants pushConstants{
+      .sourceSize{static_cast<int>(sourceResolution.width), static_cast<int>(sourceResolution.height)},
+      .mipCount = static_cast<u32>(mipCount),
+      .workgroupCount = workgroupCountX * workgroupCountY,
+      .filterType = static_cast<u32>(filter),
+      .isSrgb = destination.format().is_srgb() ? 1u : 0u,
+   };
+
+   const auto counterIndex = m_nextCounter.fetch_add(1) % g_counterCount;
+
+   cmdList.bind_pipeline(m_pipeline);
+   if (sourceMipLevel < 0) {
+      cmdList.bind_texture(0, source);
+   } else {
+      cmdList.bind_texture_mip(0, source, sourceMipLevel);
+   }
+   cmdList.bind_storage_buffer(1, m_counterBuffer, counterIndex * g_counterStride, sizeof(u32));
+   cmdList.bind_storage_images(2, destination, baseMipLevel, g_maxGeneratedMipCount);
+   cmdList.push_constant(PipelineStage::ComputeShader, pushConstants);
+   cmdList.dispatch(workgroupCountX, workgroupCountY, 1);
+
+   const TextureBarrierInfo readBarrier{
+      .texture = &destination,
+      .sourceState = TextureState::General,
+      .targetState = TextureState::ShaderRead,
+      .baseMipLevel = baseMipLevel,
+      .mipLevelCount = mipCount,
+   };
+   cmdList.texture_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader | PipelineStage::FragmentShader, readBarrier);
+}
+
+}// namespace triglav::graphics_api
@@ -5,6 +5,8 @@
 #include "Shader.h"
 #include "vulkan/Util.h"
 
+#include <cassert>
+
 namespace triglav::graphics_api {
 
 // -------------------------
@@ -26,10 +28,10 @@ void PipelineBuilderBase::add_shader(const Shader& shader)
    m_shaderStageInfos.emplace_back(info);
 }
 
-void PipelineBuilderBase::add_descriptor_binding(DescriptorType descriptorType, PipelineStage shaderStage)
+void PipelineBuilderBase::add_descriptor_binding(DescriptorType descriptorType, PipelineStage shaderStage, const u32 count)
 {
    VkDescriptorSetLayoutBinding layoutBinding{};
-   layoutBinding.descriptorCount = 1;
+   layoutBinding.descriptorCount = count;
    layoutBinding.binding = m_vulkanDescriptorBindings.size();
    layoutBinding.descriptorType = vulkan::to_vulkan_descriptor_type(descriptorType);
    layoutBinding.stageFlags = vulkan::to_vulkan_shader_stage_flags(shaderStage);
@@ -74,6 +76,14 @@ Result<std::tuple<vulkan::DescriptorSetLayout, vulkan::PipelineLayout>> Pipeline
    return std::make_tuple(std::move(descriptorSetLayout), std::move(pipelineLayout));
 }
 
+Pipeline PipelineBuilderBase::build_null_pipeline(const PipelineType pipelineType) const
+{
+   assert(m_device.is_null());
+   ++m_device.null_stats()->pipelineCount;
+   return Pipeline{vulkan::PipelineLayout(m_device.vulkan_device()), vulkan::Pipeline(m_device.vulkan_device()),
+                   vulkan::DescriptorSetLayout(m_device.vulkan_device()), pipelineType};
+}
+
 // -------------------------
 // COMPUTE PIPELINE BUILDER
 // -------------------------
@@ -96,6 +106,12 @@ ComputePipelineBuilder& ComputePipelineBuilder::descriptor_binding(DescriptorTyp
    return *this;
 }
 
+ComputePipelineBuilder& ComputePipelineBuilder::descriptor_binding_array(DescriptorType descriptorType, const u32 count)
+{
+   this->add_descriptor_binding(descriptorType, PipelineStage::ComputeShader, count);
+   return *this;
+}
+
 ComputePipelineBuilder& ComputePipelineBuilder::push_constant(PipelineStage shaderStage, size_t size, size_t offset)
 {
    this->add_push_constant(shaderStage, size, offset);
@@ -108,6 +124,9 @@ Result<Pipeline> ComputePipelineBuilder::build() const
       return std::unexpected{Status::InvalidShaderStage};
    }
 
+   if (m_device.is_null())
+      return this->build_null_pipeline(PipelineType::Compute);
+
    auto layouts = this->build_pipeline_layout();
    if (not layouts.has_value()) {
       return std::unexpected(layouts.error());
@@ -212,6 +231,12 @@ GraphicsPipelineBuilder& GraphicsPipelineBuilder::enable_blending(const bool ena
    return *this;
 }
 
+GraphicsPipelineBuilder& GraphicsPipelineBuilder::enable_color_write(const bool enabled)
+{
+   m_colorWriteEnabled = enabled;
+   return *this;
+}
+
 GraphicsPipelineBuilder& GraphicsPipelineBuilder::use_push_descriptors(bool enabled)
 {
    m_usePushDescriptors = enabled;
@@ -276,6 +301,9 @@ constexpr std::array g_dynamicStates{
 
 Result<Pipeline> GraphicsPipelineBuilder::build() const
 {
+   if (m_device.is_null())
+      return this->build_null_pipeline(PipelineType::Graphics);
+
    VkPipelineDynamicStateCreateInfo dynamicStateInfo{};
    dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
    dynamicStateInfo.dynamicStateCount = g_dynamicStates.size();
@@ -338,8 +366,10 @@ Result<Pipeline> GraphicsPipelineBuilder::build() const
    std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments{};
    for (int i = 0; i < m_renderTarget.color_attachment_count(); ++i) {
       VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-      colorBlendAttachment.colorWriteMask =
-         VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+      if (m_colorWriteEnabled) {
+         colorBlendAttachment.colorWriteMask =
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+      }
       colorBlendAttachment.blendEnable = m_blendingEnabled;
       colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
       colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
@@ -365,7 +395,7 @@ Result<Pipeline> GraphicsPipelineBuilder::build() const
    depthStencilStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
    depthStencilStateInfo.depthTestEnable = m_depthTestMode != DepthTestMode::Disabled;
    depthStencilStateInfo.depthWriteEnable = m_depthTestMode == DepthTestMode::Enabled;
-   depthStencilStateInfo.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+   depthStencilStateInfo.depthCompareOp = m_depthTestMode == DepthTestMode::Equal ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS_OR_EQUAL;
    depthStencilStateInfo.depthBoundsTestEnable = false;
    depthStencilStateInfo.stencilTestEnable = false;
 
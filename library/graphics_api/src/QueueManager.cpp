@@ -29,31 +29,41 @@ u32 work_type_flag_count(const WorkTypeFlags flags)
 
 }// namespace
 
-QueueManager::QueueManager(Device& device, std::span<QueueFamilyInfo> infos) :
-    m_device(device),
-    m_semaphoreFactory(device),
-    m_semaphorePool(m_semaphoreFactory),
-    m_fenceFactory(device),
-    m_fencePool(m_fenceFactory)
+QueueFamilySelection select_queue_families(const std::span<const QueueFamilyInfo> infos)
 {
-   m_queueIndices.fill(std::numeric_limits<u32>::max());
+   QueueFamilySelection result{};
+   result.fill(std::numeric_limits<u32>::max());
 
-   std::array<u32, 16> queueCounts{};
-   queueCounts.fill(std::numeric_limits<u32>::max());
+   std::array<u32, 16> familyFlagCounts{};
+   familyFlagCounts.fill(std::numeric_limits<u32>::max());
 
    u32 index{};
    for (const auto& info : infos) {
-      m_queueGroups.emplace_back(std::make_unique<QueueGroup>(device, info));
+      const auto familyFlagCount = work_type_flag_count(info.flags);
       for (u32 flagsInt = 1; flagsInt < 16; ++flagsInt) {
          const WorkTypeFlags flags{flagsInt};
-         const auto flagCount = work_type_flag_count(flags);
-         if (info.flags & flags && queueCounts[flagsInt] >= flagCount) {
-            queueCounts[flagsInt] = flagCount;
-            m_queueIndices[flagsInt] = index;
+         if (info.flags & flags && familyFlagCounts[flagsInt] > familyFlagCount) {
+            familyFlagCounts[flagsInt] = familyFlagCount;
+            result[flagsInt] = index;
          }
       }
       ++index;
    }
+
+   return result;
+}
+
+QueueManager::QueueManager(Device& device, std::span<QueueFamilyInfo> infos) :
+    m_device(device),
+    m_semaphoreFactory(device),
+    m_semaphorePool(m_semaphoreFactory),
+    m_fenceFactory(device),
+    m_fencePool(m_fenceFactory),
+    m_queueIndices(select_queue_families(infos))
+{
+   for (const auto& info : infos) {
+      m_queueGroups.emplace_back(std::make_unique<QueueGroup>(device, info));
+   }
 }
 
 QueueManager::SafeQueue& QueueManager::next_queue(const WorkTypeFlags flags)
@@ -71,6 +81,11 @@ u32 QueueManager::queue_index(const WorkTypeFlags flags) const
    return this->queue_group(flags).index();
 }
 
+bool QueueManager::shares_queue_family(const WorkTypeFlags first, const WorkTypeFlags second) const
+{
+   return this->queue_index(first) == this->queue_index(second);
+}
+
 Semaphore* QueueManager::aquire_semaphore()
 {
    return m_semaphorePool.aquire_object();
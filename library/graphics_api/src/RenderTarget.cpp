@@ -341,6 +341,9 @@ Result<RenderTarget> RenderTargetBuilder::build()
    renderPassInfo.pDependencies = dependencies.data();
 
    vulkan::RenderPass renderPass(m_device.vulkan_device());
+   if (m_device.is_null())
+      return RenderTarget(m_device, std::move(renderPass), m_sampleCount, std::move(m_attachments));
+
    if (const auto res = renderPass.construct(&renderPassInfo); res != VK_SUCCESS) {
       return std::unexpected{Status::UnsupportedDevice};
    }
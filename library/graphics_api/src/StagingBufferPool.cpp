@@ -0,0 +1,102 @@
+#include "StagingBufferPool.h"
+
+#include "Device.h"
+
+#include "triglav/threading/Threading.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace triglav::graphics_api {
+
+StagingMemory::StagingMemory(StagingBufferPool& pool, const u32 slot, const std::span<u8> data) :
+    m_pool(&pool),
+    m_slot(slot),
+    m_data(data)
+{
+}
+
+StagingMemory::~StagingMemory()
+{
+   if (m_pool != nullptr) {
+      m_pool->release(m_slot);
+   }
+}
+
+StagingMemory::StagingMemory(StagingMemory&& other) noexcept :
+    m_pool(std::exchange(other.m_pool, nullptr)),
+    m_slot(other.m_slot),
+    m_data(other.m_data)
+{
+}
+
+std::span<u8> StagingMemory::data() const
+{
+   return m_data;
+}
+
+const Buffer& StagingMemory::buffer() const
+{
+   const auto& slot = m_pool->m_slots[m_slot];
+   assert(slot.buffer.has_value());
+   return *slot.buffer;
+}
+
+StagingBufferPool::StagingBufferPool(Device& device) :
+    m_device(device),
+    m_slots(threading::total_thread_count())
+{
+}
+
+Result<StagingMemory> StagingBufferPool::acquire(const MemorySize size)
+{
+   const auto slotIndex = threading::this_thread_id();
+   assert(slotIndex < m_slots.size());
+
+   auto& slot = m_slots[slotIndex];
+   assert(not slot.isAcquired);
+   if (slot.memory.size() < size) {
+      const auto capacity = std::max(size, g_minStagingSize);
+
+      // The memory needs to be unmapped before the buffer is destroyed.
+      slot.mapping.reset();
+      slot.buffer.reset();
+      slot.memory = {};
+
+      if (m_device.is_null()) {
+         slot.hostMemory.resize(capacity);
+         slot.memory = slot.hostMemory;
+      } else {
+         auto buffer = m_device.create_buffer(BufferUsage::HostVisible | BufferUsage::TransferSrc, capacity);
+         if (not buffer.has_value())
+            return std::unexpected(buffer.error());
+
+         auto mapping = buffer->map_memory();
+         if (not mapping.has_value())
+            return std::unexpected(mapping.error());
+
+         slot.buffer.emplace(std::move(*buffer));
+         slot.mapping.emplace(std::move(*mapping));
+         slot.memory = {static_cast<u8*>(**slot.mapping), capacity};
+      }
+   }
+
+   slot.isAcquired = true;
+   return StagingMemory(*this, slotIndex, slot.memory.first(size));
+}
+
+void StagingBufferPool::release(const u32 slot)
+{
+   auto& releasedSlot = m_slots[slot];
+   releasedSlot.isAcquired = false;
+   if (releasedSlot.memory.size() <= g_maxRetainedStagingSize)
+      return;
+
+   releasedSlot.mapping.reset();
+   releasedSlot.buffer.reset();
+   releasedSlot.hostMemory = {};
+   releasedSlot.memory = {};
+}
+
+}// namespace triglav::graphics_api
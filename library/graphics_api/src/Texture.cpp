@@ -2,11 +2,17 @@
 
 #include "CommandList.h"
 #include "Device.h"
+#include "MipMapGenerator.h"
+#include "UploadCommands.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace triglav::graphics_api {
 
 Texture::Texture(vulkan::Image image, vulkan::DeviceMemory memory, vulkan::ImageView imageView, const ColorFormat& colorFormat,
-                 const TextureUsageFlags usageFlags, const uint32_t width, const uint32_t height, const int mipCount) :
+                 const TextureUsageFlags usageFlags, const uint32_t width, const uint32_t height, const int mipCount,
+                 std::vector<vulkan::ImageView> mipViews) :
     m_width{width},
     m_height{height},
     m_colorFormat(colorFormat),
@@ -15,6 +21,7 @@ Texture::Texture(vulkan::Image image, vulkan::DeviceMemory memory, vulkan::Image
     m_memory(std::move(memory)),
     m_imageView(std::move(imageView)),
     m_mipCount{mipCount},
+    m_mipViews(std::move(mipViews)),
     m_samplerProperties{
        FilterType::Linear,
        FilterType::Linear,
@@ -54,36 +61,60 @@ Resolution Texture::resolution() const
    return {m_width, m_height};
 }
 
+Resolution Texture::mip_resolution(const int mipLevel) const
+{
+   return {std::max(m_width >> mipLevel, 1u), std::max(m_height >> mipLevel, 1u)};
+}
+
+int Texture::mip_count() const
+{
+   return m_mipCount;
+}
+
+const ColorFormat& Texture::format() const
+{
+   return m_colorFormat;
+}
+
 const SamplerProperties& Texture::sampler_properties() const
 {
    return m_samplerProperties;
 }
 
 Status Texture::write(Device& device, const uint8_t* pixels) const
+{
+   return this->write_internal(device, pixels, nullptr, MipFilter::Average);
+}
+
+Status Texture::write(Device& device, const uint8_t* pixels, MipMapGenerator& mipMapGenerator, const MipFilter filter) const
+{
+   if (not MipMapGenerator::can_generate(*this)) {
+      return this->write_internal(device, pixels, nullptr, filter);
+   }
+   return this->write_internal(device, pixels, &mipMapGenerator, filter);
+}
+
+Status Texture::write_internal(Device& device, const uint8_t* pixels, MipMapGenerator* mipMapGenerator, const MipFilter filter) const
 {
    if (!(this->usage_flags() & TextureUsage::TransferDst)) {
       return Status::InvalidTransferDestination;
    }
 
    const auto bufferSize = m_colorFormat.pixel_size() * m_width * m_height;
-   auto transferBuffer = device.create_buffer(BufferUsage::HostVisible | BufferUsage::TransferSrc, bufferSize);
-   if (not transferBuffer.has_value())
-      return transferBuffer.error();
-
-   {
-      const auto mappedMemory = transferBuffer->map_memory();
-      if (not mappedMemory.has_value())
-         return mappedMemory.error();
-
-      mappedMemory->write(pixels, bufferSize);
+   if (device.is_null()) {
+      device.record_null_upload(bufferSize);
+      return Status::Success;
    }
 
-   auto oneTimeCommands = device.create_command_list(WorkType::Graphics);
-   if (not oneTimeCommands.has_value())
-      return oneTimeCommands.error();
+   auto stagingMemory = device.staging_buffer_pool().acquire(bufferSize);
+   if (not stagingMemory.has_value())
+      return stagingMemory.error();
 
-   if (const auto res = oneTimeCommands->begin(SubmitType::OneTime); res != Status::Success)
-      return res;
+   std::memcpy(stagingMemory->data().data(), pixels, bufferSize);
+
+   auto uploadCommands = UploadCommands::create(device);
+   if (not uploadCommands.has_value())
+      return uploadCommands.error();
 
    const TextureBarrierInfo transferBarrier{
       .texture = this,
@@ -92,10 +123,14 @@ Status Texture::write(Device& device, const uint8_t* pixels) const
       .baseMipLevel = 0,
       .mipLevelCount = m_mipCount,
    };
-   oneTimeCommands->texture_barrier(PipelineStage::Entrypoint, PipelineStage::Transfer, transferBarrier);
+   uploadCommands->transfer().texture_barrier(PipelineStage::Entrypoint, PipelineStage::Transfer, transferBarrier);
+
+   uploadCommands->transfer().copy_buffer_to_texture(stagingMemory->buffer(), *this, 0);
 
-   oneTimeCommands->copy_buffer_to_texture(*transferBuffer, *this, 0);
+   // Mip maps are generated on the graphics queue.
+   uploadCommands->transfer_ownership(*this, TextureState::TransferDst);
 
+   auto& graphicsCommands = uploadCommands->graphics();
    if (m_mipCount == 1) {
       const TextureBarrierInfo fragmentShaderBarrier{
          .texture = this,
@@ -104,18 +139,91 @@ Status Texture::write(Device& device, const uint8_t* pixels) const
          .baseMipLevel = 0,
          .mipLevelCount = 1,
       };
-      oneTimeCommands->texture_barrier(PipelineStage::Transfer, PipelineStage::FragmentShader, fragmentShaderBarrier);
+      graphicsCommands.texture_barrier(PipelineStage::Transfer, PipelineStage::FragmentShader, fragmentShaderBarrier);
+   } else if (mipMapGenerator != nullptr) {
+      const TextureBarrierInfo computeShaderBarrier{
+         .texture = this,
+         .sourceState = TextureState::TransferDst,
+         .targetState = TextureState::ShaderRead,
+         .baseMipLevel = 0,
+         .mipLevelCount = 1,
+      };
+      graphicsCommands.texture_barrier(PipelineStage::Transfer, PipelineStage::ComputeShader | PipelineStage::FragmentShader,
+                                       computeShaderBarrier);
+      mipMapGenerator->generate(graphicsCommands, *this, filter);
    } else {
-      this->generate_mip_maps_internal(*oneTimeCommands);
+      this->generate_mip_maps_internal(graphicsCommands);
    }
 
-   if (const auto res = oneTimeCommands->finish(); res != Status::Success)
-      return res;
+   return uploadCommands->submit();
+}
 
-   if (const auto res = device.submit_command_list_one_time(*oneTimeCommands); res != Status::Success)
-      return res;
+Status Texture::write_levels(Device& device, const std::span<const std::span<const u8>> levels) const
+{
+   // Buffer offsets of the copies need to be a multiple of the block size, 16 bytes covers every format.
+   constexpr MemorySize levelAlignment = 16;
+
+   std::vector<MemorySize> levelOffsets;
+   levelOffsets.reserve(levels.size());
+   MemorySize bufferSize{};
+   for (const auto& level : levels) {
+      bufferSize = (bufferSize + levelAlignment - 1) / levelAlignment * levelAlignment;
+      levelOffsets.emplace_back(bufferSize);
+      bufferSize += level.size();
+   }
 
-   return Status::Success;
+   return this->write_levels(device, levelOffsets, bufferSize, [&](const std::span<u8> memory) {
+      for (MemorySize mipLevel = 0; mipLevel < levels.size(); ++mipLevel) {
+         std::memcpy(memory.data() + levelOffsets[mipLevel], levels[mipLevel].data(), levels[mipLevel].size());
+      }
+      return true;
+   });
+}
+
+Status Texture::write_levels(Device& device, const std::span<const MemorySize> levelOffsets, const MemorySize size,
+                             const StagingWriter& writer) const
+{
+   if (!(this->usage_flags() & TextureUsage::TransferDst)) {
+      return Status::InvalidTransferDestination;
+   }
+   assert(levelOffsets.size() == static_cast<MemorySize>(m_mipCount));
+
+   auto stagingMemory = device.staging_buffer_pool().acquire(size);
+   if (not stagingMemory.has_value())
+      return stagingMemory.error();
+
+   if (not writer(stagingMemory->data()))
+      return Status::InvalidTransferSource;
+
+   if (device.is_null()) {
+      device.record_null_upload(size);
+      return Status::Success;
+   }
+
+   auto uploadCommands = UploadCommands::create(device);
+   if (not uploadCommands.has_value())
+      return uploadCommands.error();
+
+   TextureBarrierInfo barrier{
+      .texture = this,
+      .sourceState = TextureState::Undefined,
+      .targetState = TextureState::TransferDst,
+      .baseMipLevel = 0,
+      .mipLevelCount = m_mipCount,
+   };
+   uploadCommands->transfer().texture_barrier(PipelineStage::Entrypoint, PipelineStage::Transfer, barrier);
+
+   for (int mipLevel = 0; mipLevel < m_mipCount; ++mipLevel) {
+      uploadCommands->transfer().copy_buffer_to_texture(stagingMemory->buffer(), *this, mipLevel, levelOffsets[mipLevel]);
+   }
+
+   uploadCommands->transfer_ownership(*this, TextureState::TransferDst);
+
+   barrier.sourceState = TextureState::TransferDst;
+   barrier.targetState = TextureState::ShaderRead;
+   uploadCommands->graphics().texture_barrier(PipelineStage::Transfer, PipelineStage::FragmentShader, barrier);
+
+   return uploadCommands->submit();
 }
 
 Status Texture::generate_mip_maps(Device& device) const
@@ -186,6 +294,12 @@ VkImageView Texture::vulkan_image_view() const
    return *m_imageView;
 }
 
+VkImageView Texture::vulkan_mip_view(const int mipLevel) const
+{
+   assert(mipLevel < static_cast<int>(m_mipViews.size()));
+   return *m_mipViews[mipLevel];
+}
+
 void Texture::set_anisotropy_state(const bool isEnabled)
 {
    m_samplerProperties.enableAnisotropy = isEnabled;
@@ -0,0 +1,128 @@
+#include "UploadCommands.h"
+
+#include "Device.h"
+#include "Synchronization.h"
+#include "Texture.h"
+
+namespace triglav::graphics_api {
+
+namespace {
+
+Result<CommandList> begin_command_list(Device& device, const WorkTypeFlags workTypes)
+{
+   auto commandList = device.create_command_list(workTypes);
+   if (not commandList.has_value())
+      return std::unexpected(commandList.error());
+
+   if (const auto res = commandList->begin(SubmitType::OneTime); res != Status::Success)
+      return std::unexpected(res);
+
+   return commandList;
+}
+
+}// namespace
+
+UploadCommands::UploadCommands(Device& device, CommandList transferCommands, std::optional<CommandList> graphicsCommands) :
+    m_device(device),
+    m_transferCommands(std::move(transferCommands)),
+    m_graphicsCommands(std::move(graphicsCommands))
+{
+}
+
+Result<UploadCommands> UploadCommands::create(Device& device)
+{
+   auto transferCommands = begin_command_list(device, WorkType::Transfer);
+   if (not transferCommands.has_value())
+      return std::unexpected(transferCommands.error());
+
+   if (device.queue_manager().shares_queue_family(WorkType::Transfer, WorkType::Graphics))
+      return UploadCommands(device, std::move(*transferCommands), std::nullopt);
+
+   auto graphicsCommands = begin_command_list(device, WorkType::Graphics);
+   if (not graphicsCommands.has_value())
+      return std::unexpected(graphicsCommands.error());
+
+   return UploadCommands(device, std::move(*transferCommands), std::move(*graphicsCommands));
+}
+
+CommandList& UploadCommands::transfer()
+{
+   return m_transferCommands;
+}
+
+CommandList& UploadCommands::graphics()
+{
+   if (m_graphicsCommands.has_value())
+      return *m_graphicsCommands;
+   return m_transferCommands;
+}
+
+void UploadCommands::transfer_ownership(const Buffer& buffer) const
+{
+   if (not m_graphicsCommands.has_value())
+      return;
+
+   m_transferCommands.release_buffer(buffer, PipelineStage::Transfer, m_graphicsCommands->work_types());
+   m_graphicsCommands->acquire_buffer(buffer, m_transferCommands.work_types(), PipelineStage::Transfer);
+}
+
+void UploadCommands::transfer_ownership(const Texture& texture, const TextureState state) const
+{
+   if (not m_graphicsCommands.has_value())
+      return;
+
+   const TextureBarrierInfo info{
+      .texture = &texture,
+      .sourceState = state,
+      .targetState = state,
+      .baseMipLevel = 0,
+      .mipLevelCount = texture.mip_count(),
+   };
+   m_transferCommands.release_texture(PipelineStage::Transfer, info, m_graphicsCommands->work_types());
+   m_graphicsCommands->acquire_texture(m_transferCommands.work_types(), PipelineStage::Transfer, info);
+}
+
+Status UploadCommands::submit()
+{
+   if (const auto res = m_transferCommands.finish(); res != Status::Success)
+      return res;
+
+   auto fence = m_device.create_fence();
+   if (not fence.has_value())
+      return fence.error();
+
+   // Fences are created signaled, awaiting resets it.
+   fence->await();
+
+   if (not m_graphicsCommands.has_value()) {
+      if (const auto res = m_device.submit_command_list(m_transferCommands, {}, {}, &*fence, WorkType::Transfer); res != Status::Success)
+         return res;
+
+      fence->await();
+      return Status::Success;
+   }
+
+   if (const auto res = m_graphicsCommands->finish(); res != Status::Success)
+      return res;
+
+   auto semaphore = m_device.create_semaphore();
+   if (not semaphore.has_value())
+      return semaphore.error();
+
+   SemaphoreArray semaphores;
+   semaphores.add_semaphore(*semaphore);
+
+   if (const auto res = m_device.submit_command_list(m_transferCommands, {}, semaphores, nullptr, WorkType::Transfer);
+       res != Status::Success)
+      return res;
+
+   // The graphics commands acquire the ownership of the uploaded resources at the transfer stage.
+   if (const auto res = m_device.submit_command_list(*m_graphicsCommands, semaphores, {}, &*fence, WorkType::Transfer);
+       res != Status::Success)
+      return res;
+
+   fence->await();
+   return Status::Success;
+}
+
+}// namespace triglav::graphics_api
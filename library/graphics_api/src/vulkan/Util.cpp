@@ -105,6 +105,36 @@ Result<VkFormat> to_vulkan_color_format(const ColorFormat& format)
          break;
       }
       return std::unexpected{Status::UnsupportedFormat};
+   case ColorFormatOrder::BC1:
+      switch (format.parts[0]) {
+      case ColorFormatPart::sRGB:
+         return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+      case ColorFormatPart::UNorm8:
+         return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+      default:
+         break;
+      }
+      return std::unexpected{Status::UnsupportedFormat};
+   case ColorFormatOrder::BC4:
+      if (format.parts[0] == ColorFormatPart::UNorm8) {
+         return VK_FORMAT_BC4_UNORM_BLOCK;
+      }
+      return std::unexpected{Status::UnsupportedFormat};
+   case ColorFormatOrder::BC5:
+      if (format.parts[0] == ColorFormatPart::UNorm8) {
+         return VK_FORMAT_BC5_UNORM_BLOCK;
+      }
+      return std::unexpected{Status::UnsupportedFormat};
+   case ColorFormatOrder::BC7:
+      switch (format.parts[0]) {
+      case ColorFormatPart::sRGB:
+         return VK_FORMAT_BC7_SRGB_BLOCK;
+      case ColorFormatPart::UNorm8:
+         return VK_FORMAT_BC7_UNORM_BLOCK;
+      default:
+         break;
+      }
+      return std::unexpected{Status::UnsupportedFormat};
    }
    return std::unexpected{Status::UnsupportedFormat};
 }
@@ -309,6 +339,8 @@ VkDescriptorType to_vulkan_descriptor_type(DescriptorType descriptorType)
       return VK_DESCRIPTOR_TYPE_SAMPLER;
    case DescriptorType::ImageSampler:
       return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+   case DescriptorType::StorageImage:
+      return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
    }
    return VK_DESCRIPTOR_TYPE_MAX_ENUM;
 }
@@ -326,6 +358,8 @@ VkImageLayout to_vulkan_image_layout(const TextureState resourceState)
       return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
    case TextureState::DepthStencilRead:
       return VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+   case TextureState::General:
+      return VK_IMAGE_LAYOUT_GENERAL;
    }
 
    return VK_IMAGE_LAYOUT_UNDEFINED;
@@ -344,6 +378,8 @@ VkAccessFlags to_vulkan_access_flags(const TextureState resourceState)
       [[fallthrough]];
    case TextureState::DepthStencilRead:
       return VK_ACCESS_SHADER_READ_BIT;
+   case TextureState::General:
+      return VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
    }
 
    return 0;
@@ -399,6 +435,9 @@ VkImageUsageFlags to_vulkan_image_usage_flags(const TextureUsageFlags usage)
    if (usage & TextureUsage::Transient) {
       result |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
    }
+   if (usage & TextureUsage::Storage) {
+      result |= VK_IMAGE_USAGE_STORAGE_BIT;
+   }
 
    return result;
 }
@@ -435,6 +474,9 @@ VkBufferUsageFlags to_vulkan_buffer_usage_flags(const BufferUsageFlags usage)
    if (usage & StorageBuffer) {
       result |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
    }
+   if (usage & Indirect) {
+      result |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+   }
 
    return result;
 }
@@ -458,10 +500,12 @@ VkPipelineStageFlags to_vulkan_wait_pipeline_stage(const WorkTypeFlags workTypes
    using enum WorkType;
 
    if (workTypes & Graphics) {
-      return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+      // Indirect draw arguments and vertex shader storage reads can be produced by other nodes.
+      return VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
    }
    if (workTypes & Compute) {
-      return VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+      // Indirect dispatch arguments are read in the draw indirect stage.
+      return VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
    }
    if (workTypes & Transfer) {
       return VK_PIPELINE_STAGE_TRANSFER_BIT;
@@ -487,7 +531,7 @@ VkImageAspectFlags to_vulkan_aspect_flags(TextureUsageFlags usageFlags)
 
    if (usageFlags & TextureUsage::DepthStencilAttachment) {
       outFlags |= VK_IMAGE_ASPECT_DEPTH_BIT;
-   } else if (usageFlags & TextureUsage::Sampled) {
+   } else if ((usageFlags & TextureUsage::Sampled) || (usageFlags & TextureUsage::Storage)) {
       outFlags |= VK_IMAGE_ASPECT_COLOR_BIT;
    }
 
@@ -0,0 +1,194 @@
+#include "triglav/graphics_api/CommandList.h"
+#include "triglav/graphics_api/Device.h"
+#include "triglav/graphics_api/Instance.h"
+#include "triglav/graphics_api/MipFilter.h"
+#include "triglav/graphics_api/MipMapGenerator.h"
+#include "triglav/graphics_api/Shader.h"
+#include "triglav/graphics_api/Texture.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <optional>
+#include <random>
+
+using triglav::MemorySize;
+using triglav::u8;
+using triglav::graphics_api::BufferUsage;
+using triglav::graphics_api::DevicePickStrategy;
+using triglav::graphics_api::DeviceUPtr;
+using triglav::graphics_api::generate_mip_chain_reference;
+using triglav::graphics_api::Instance;
+using triglav::graphics_api::MipFilter;
+using triglav::graphics_api::MipMapGenerator;
+using triglav::graphics_api::PipelineStage;
+using triglav::graphics_api::Resolution;
+using triglav::graphics_api::SampleCount;
+using triglav::graphics_api::Shader;
+using triglav::graphics_api::SubmitType;
+using triglav::graphics_api::Texture;
+using triglav::graphics_api::TextureBarrierInfo;
+using triglav::graphics_api::TextureState;
+using triglav::graphics_api::TextureUsage;
+
+namespace {
+
+using Levels = std::vector<std::vector<u8>>;
+
+std::vector<u8> generate_pixels(const Resolution& resolution)
+{
+   std::mt19937 generator(100);
+   std::uniform_int_distribution<int> distribution(0, 255);
+
+   std::vector<u8> pixels(4 * resolution.width * resolution.height);
+   for (auto& pixel : pixels) {
+      pixel = static_cast<u8>(distribution(generator));
+   }
+   return pixels;
+}
+
+// Levels below the source computed on the CPU, the tolerance is given in 8 bit steps.
+void expect_matches_reference(const Levels& levels, const std::vector<u8>& pixels, const Resolution& resolution, const float tolerance)
+{
+   std::vector<glm::vec4> texels(resolution.width * resolution.height);
+   for (std::size_t i = 0; i < texels.size(); ++i) {
+      texels[i] = glm::vec4{pixels[4 * i], pixels[4 * i + 1], pixels[4 * i + 2], pixels[4 * i + 3]} / 255.0f;
+   }
+
+   const auto reference = generate_mip_chain_reference(texels, resolution, static_cast<int>(levels.size()) - 1, MipFilter::Average, false);
+
+   for (std::size_t level = 1; level < levels.size(); ++level) {
+      ASSERT_EQ(levels[level].size(), 4 * reference[level - 1].size());
+      for (std::size_t i = 0; i < reference[level - 1].size(); ++i) {
+         const auto& expected = reference[level - 1][i];
+         for (int component = 0; component < 4; ++component) {
+            EXPECT_NEAR(levels[level][4 * i + component], 255.0f * expected[component], tolerance) << "level " << level << ", texel " << i;
+         }
+      }
+   }
+}
+
+}// namespace
+
+// Needs a Vulkan device, lavapipe is enough. The tests are skipped when none is available.
+class MipMapGeneratorGpuTest : public testing::Test
+{
+ protected:
+   void SetUp() override
+   {
+      auto instance = Instance::create_instance();
+      if (not instance.has_value())
+         GTEST_SKIP() << "Vulkan is not available";
+      m_instance.emplace(std::move(*instance));
+
+      auto device = m_instance->create_headless_device(DevicePickStrategy::PreferDedicated);
+      if (not device.has_value())
+         GTEST_SKIP() << "no Vulkan device is available";
+      m_device = std::move(*device);
+
+      if (not m_device->features().storageImageWithoutFormat)
+         GTEST_SKIP() << "the device doesn't support formatless storage images";
+
+      std::ifstream file(TRIGLAV_MIP_DOWNSAMPLE_SHADER_PATH, std::ios::binary);
+      ASSERT_TRUE(file.is_open());
+      const std::vector<char> code{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+      m_shader.emplace(GAPI_CHECK(m_device->create_shader(PipelineStage::ComputeShader, "main", code)));
+      m_generator.emplace(*m_device, *m_shader);
+   }
+
+   [[nodiscard]] Texture upload(const std::vector<u8>& pixels, const Resolution& resolution, const bool useCompute)
+   {
+      auto texture = GAPI_CHECK(m_device->create_texture(
+         GAPI_FORMAT(RGBA, UNorm8), resolution,
+         TextureUsage::Sampled | TextureUsage::TransferSrc | TextureUsage::TransferDst | TextureUsage::Storage, SampleCount::Single, 0));
+
+      if (useCompute) {
+         GAPI_CHECK_STATUS(texture.write(*m_device, pixels.data(), *m_generator, MipFilter::Average));
+      } else {
+         GAPI_CHECK_STATUS(texture.write(*m_device, pixels.data()));
+      }
+      return texture;
+   }
+
+   // Copies every level of a texture in the ShaderRead state back to the host.
+   [[nodiscard]] Levels read_levels(const Texture& texture)
+   {
+      std::vector<MemorySize> offsets;
+      MemorySize size{};
+      for (int level = 0; level < texture.mip_count(); ++level) {
+         const auto resolution = texture.mip_resolution(level);
+         offsets.emplace_back(size);
+         size += 4 * resolution.width * resolution.height;
+      }
+
+      auto buffer = GAPI_CHECK(m_device->create_buffer(BufferUsage::HostVisible | BufferUsage::TransferDst, size));
+      auto cmdList = GAPI_CHECK(m_device->create_command_list());
+
+      GAPI_CHECK_STATUS(cmdList.begin(SubmitType::OneTime));
+      const TextureBarrierInfo barrier{
+         .texture = &texture,
+         .sourceState = TextureState::ShaderRead,
+         .targetState = TextureState::TransferSrc,
+         .baseMipLevel = 0,
+         .mipLevelCount = texture.mip_count(),
+      };
+      cmdList.texture_barrier(PipelineStage::ComputeShader | PipelineStage::FragmentShader, PipelineStage::Transfer, barrier);
+      for (int level = 0; level < texture.mip_count(); ++level) {
+         cmdList.copy_texture_to_buffer(texture, buffer, level, offsets[level]);
+      }
+      GAPI_CHECK_STATUS(cmdList.finish());
+      GAPI_CHECK_STATUS(m_device->submit_command_list_one_time(cmdList));
+
+      const auto mapping = GAPI_CHECK(buffer.map_memory());
+      const auto* data = static_cast<const u8*>(*mapping);
+
+      Levels levels;
+      for (int level = 0; level < texture.mip_count(); ++level) {
+         const auto resolution = texture.mip_resolution(level);
+         levels.emplace_back(data + offsets[level], data + offsets[level] + 4 * resolution.width * resolution.height);
+      }
+      return levels;
+   }
+
+   std::optional<Instance> m_instance;
+   DeviceUPtr m_device;
+   std::optional<Shader> m_shader;
+   std::optional<MipMapGenerator> m_generator;
+};
+
+TEST_F(MipMapGeneratorGpuTest, ComputeMatchesBlit)
+{
+   const Resolution resolution{256, 128};
+   const auto pixels = generate_pixels(resolution);
+
+   const auto blitTexture = this->upload(pixels, resolution, false);
+   const auto computeTexture = this->upload(pixels, resolution, true);
+   const auto blitLevels = this->read_levels(blitTexture);
+   const auto computeLevels = this->read_levels(computeTexture);
+
+   ASSERT_EQ(computeLevels.size(), 9);
+   ASSERT_EQ(blitLevels.size(), computeLevels.size());
+
+   // Blits round every level before reducing it further, so only the first generated level is compared with them.
+   ASSERT_EQ(blitLevels[1].size(), computeLevels[1].size());
+   for (std::size_t i = 0; i < computeLevels[1].size(); ++i) {
+      EXPECT_LE(std::abs(blitLevels[1][i] - computeLevels[1][i]), 1) << "byte " << i;
+   }
+
+   // The shader rounds only when storing a level, levels continued from the sixth one are rounded twice.
+   expect_matches_reference(computeLevels, pixels, resolution, 1.0f + 1e-3f);
+}
+
+TEST_F(MipMapGeneratorGpuTest, SourcesLargerThan4096AreFullyGenerated)
+{
+   // Past 4096 pixels the chain is generated in two dispatches, the second one starts from the sixth level.
+   const Resolution resolution{8192, 4};
+   const auto pixels = generate_pixels(resolution);
+
+   const auto texture = this->upload(pixels, resolution, true);
+   const auto levels = this->read_levels(texture);
+
+   ASSERT_EQ(levels.size(), 14);
+   expect_matches_reference(levels, pixels, resolution, 1.5f + 1e-3f);
+}
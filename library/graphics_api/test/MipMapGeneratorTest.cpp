@@ -0,0 +1,167 @@
+#include "triglav/graphics_api/MipFilter.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using triglav::u32;
+using triglav::graphics_api::generate_mip_chain_reference;
+using triglav::graphics_api::MipFilter;
+using triglav::graphics_api::Resolution;
+
+namespace {
+
+std::vector<glm::vec4> generate_texels(const Resolution& resolution)
+{
+   std::mt19937 generator(100);
+   std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+   std::vector<glm::vec4> texels(resolution.width * resolution.height);
+   for (auto& texel : texels) {
+      texel = glm::vec4{distribution(generator), distribution(generator), distribution(generator), distribution(generator)};
+   }
+   return texels;
+}
+
+// Reference of the blit based generation, a plain box filter of the previous level.
+std::vector<glm::vec4> blit_half(const std::vector<glm::vec4>& texels, const Resolution& resolution)
+{
+   std::vector<glm::vec4> result(resolution.width * resolution.height / 4);
+   const auto width = resolution.width / 2;
+   for (u32 y = 0; y < resolution.height / 2; ++y) {
+      for (u32 x = 0; x < width; ++x) {
+         const auto src = 2 * y * resolution.width + 2 * x;
+         result[y * width + x] = 0.25f * (texels[src] + texels[src + 1] + texels[src + resolution.width] + texels[src + resolution.width + 1]);
+      }
+   }
+   return result;
+}
+
+void expect_near(const glm::vec4& actual, const glm::vec4& expected, const float tolerance)
+{
+   EXPECT_NEAR(actual.x, expected.x, tolerance);
+   EXPECT_NEAR(actual.y, expected.y, tolerance);
+   EXPECT_NEAR(actual.z, expected.z, tolerance);
+   EXPECT_NEAR(actual.w, expected.w, tolerance);
+}
+
+}// namespace
+
+TEST(MipMapGeneratorTest, LevelSizes)
+{
+   const Resolution resolution{37, 12};
+   const std::vector texels(resolution.width * resolution.height, glm::vec4{0.5f});
+
+   const auto levels = generate_mip_chain_reference(texels, resolution, 6, MipFilter::Average, false);
+
+   ASSERT_EQ(levels.size(), 6);
+   EXPECT_EQ(levels[0].size(), 18 * 6);
+   EXPECT_EQ(levels[1].size(), 9 * 3);
+   EXPECT_EQ(levels[2].size(), 4 * 1);
+   EXPECT_EQ(levels[3].size(), 2 * 1);
+   EXPECT_EQ(levels[4].size(), 1);
+   EXPECT_EQ(levels[5].size(), 1);
+}
+
+TEST(MipMapGeneratorTest, ConstantImageIsPreserved)
+{
+   const Resolution resolution{64, 64};
+   const glm::vec4 color{0.2f, 0.4f, 0.6f, 1.0f};
+   const std::vector texels(resolution.width * resolution.height, color);
+
+   for (const bool isSrgb : {false, true}) {
+      for (const auto& level : generate_mip_chain_reference(texels, resolution, 6, MipFilter::Average, isSrgb)) {
+         for (const auto& texel : level) {
+            expect_near(texel, color, 1e-5f);
+         }
+      }
+   }
+}
+
+TEST(MipMapGeneratorTest, MatchesBlitForLinearTextures)
+{
+   Resolution resolution{128, 64};
+   auto expected = generate_texels(resolution);
+
+   const auto levels = generate_mip_chain_reference(expected, resolution, 6, MipFilter::Average, false);
+
+   for (const auto& level : levels) {
+      expected = blit_half(expected, resolution);
+      resolution = {resolution.width / 2, resolution.height / 2};
+
+      ASSERT_EQ(level.size(), expected.size());
+      for (std::size_t i = 0; i < level.size(); ++i) {
+         expect_near(level[i], expected[i], 1e-5f);
+      }
+   }
+}
+
+TEST(MipMapGeneratorTest, SrgbIsAveragedInLinearSpace)
+{
+   const Resolution resolution{2, 2};
+   const std::vector<glm::vec4> texels{glm::vec4{0.0f}, glm::vec4{1.0f}, glm::vec4{1.0f}, glm::vec4{0.0f}};
+
+   const auto levels = generate_mip_chain_reference(texels, resolution, 1, MipFilter::Average, true);
+
+   ASSERT_EQ(levels[0].size(), 1);
+   // A black and white checkerboard averages to 0.5 in linear space, which encodes to ~0.735.
+   // Alpha is not sRGB encoded and is averaged as is.
+   expect_near(levels[0][0], glm::vec4{0.7354f, 0.7354f, 0.7354f, 0.5f}, 1e-3f);
+}
+
+TEST(MipMapGeneratorTest, NormalsStayUnitLength)
+{
+   const Resolution resolution{16, 16};
+   auto texels = generate_texels(resolution);
+
+   for (const auto& level : generate_mip_chain_reference(texels, resolution, 4, MipFilter::NormalMap, false)) {
+      for (const auto& texel : level) {
+         const glm::vec3 normal{2.0f * texel.x - 1.0f, 2.0f * texel.y - 1.0f, 2.0f * texel.z - 1.0f};
+         EXPECT_NEAR(std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z), 1.0f, 1e-4f);
+      }
+   }
+}
+
+TEST(MipMapGeneratorTest, OppositeNormalsFallBackToUp)
+{
+   const Resolution resolution{2, 1};
+   const std::vector<glm::vec4> texels{glm::vec4{1.0f, 0.5f, 0.5f, 1.0f}, glm::vec4{0.0f, 0.5f, 0.5f, 1.0f}};
+
+   const auto levels = generate_mip_chain_reference(texels, resolution, 1, MipFilter::NormalMap, false);
+
+   expect_near(levels[0][0], glm::vec4{0.5f, 0.5f, 1.0f, 1.0f}, 1e-5f);
+}
+
+TEST(MipMapGeneratorTest, MinAndMaxReductions)
+{
+   Resolution resolution{32, 32};
+   const auto texels = generate_texels(resolution);
+
+   const auto minLevels = generate_mip_chain_reference(texels, resolution, 5, MipFilter::Min, false);
+   const auto maxLevels = generate_mip_chain_reference(texels, resolution, 5, MipFilter::Max, false);
+
+   glm::vec4 expectedMin{1.0f};
+   glm::vec4 expectedMax{0.0f};
+   for (const auto& texel : texels) {
+      expectedMin = glm::vec4{std::min(expectedMin.x, texel.x), std::min(expectedMin.y, texel.y), std::min(expectedMin.z, texel.z),
+                              std::min(expectedMin.w, texel.w)};
+      expectedMax = glm::vec4{std::max(expectedMax.x, texel.x), std::max(expectedMax.y, texel.y), std::max(expectedMax.z, texel.z),
+                              std::max(expectedMax.w, texel.w)};
+   }
+
+   ASSERT_EQ(minLevels[4].size(), 1);
+   expect_near(minLevels[4][0], expectedMin, 0.0f);
+   expect_near(maxLevels[4][0], expectedMax, 0.0f);
+}
+
+TEST(MipMapGeneratorTest, OddEdgeIsClamped)
+{
+   // The last column of an odd width is dropped, same as a blit of the even part.
+   const Resolution resolution{3, 2};
+   const std::vector<glm::vec4> texels{glm::vec4{0.0f}, glm::vec4{1.0f}, glm::vec4{8.0f}, glm::vec4{0.0f}, glm::vec4{1.0f}, glm::vec4{8.0f}};
+
+   const auto levels = generate_mip_chain_reference(texels, resolution, 1, MipFilter::Average, false);
+
+   ASSERT_EQ(levels[0].size(), 1);
+   expect_near(levels[0][0], glm::vec4{0.5f}, 1e-6f);
+}
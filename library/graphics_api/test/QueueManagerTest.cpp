@@ -0,0 +1,54 @@
+#include "triglav/graphics_api/QueueManager.h"
+
+#include <gtest/gtest.h>
+
+using triglav::u32;
+using triglav::graphics_api::QueueFamilyInfo;
+using triglav::graphics_api::select_queue_families;
+using triglav::graphics_api::WorkType;
+using triglav::graphics_api::WorkTypeFlags;
+
+namespace {
+
+u32 selected_family(const std::span<const QueueFamilyInfo> infos, const WorkTypeFlags flags)
+{
+   return select_queue_families(infos)[flags.value];
+}
+
+}// namespace
+
+TEST(QueueManagerTest, SingleFamilyHandlesAllWork)
+{
+   // Single queue family devices, like lavapipe, upload on the graphics queue without ownership transfers.
+   const std::array infos{
+      QueueFamilyInfo{0, 1, WorkType::Graphics | WorkType::Compute | WorkType::Transfer | WorkType::Presentation},
+   };
+
+   EXPECT_EQ(selected_family(infos, WorkType::Graphics), 0);
+   EXPECT_EQ(selected_family(infos, WorkType::Transfer), 0);
+   EXPECT_EQ(selected_family(infos, WorkType::Graphics | WorkType::Presentation), 0);
+}
+
+TEST(QueueManagerTest, TransfersPreferDedicatedFamily)
+{
+   const std::array infos{
+      QueueFamilyInfo{0, 16, WorkType::Graphics | WorkType::Compute | WorkType::Transfer | WorkType::Presentation},
+      QueueFamilyInfo{1, 2, WorkType::Transfer},
+      QueueFamilyInfo{2, 8, WorkType::Compute | WorkType::Transfer | WorkType::Presentation},
+   };
+
+   EXPECT_EQ(selected_family(infos, WorkType::Transfer), 1);
+   EXPECT_EQ(selected_family(infos, WorkType::Compute), 2);
+   EXPECT_EQ(selected_family(infos, WorkType::Graphics), 0);
+   EXPECT_EQ(selected_family(infos, WorkType::Graphics | WorkType::Transfer), 0);
+}
+
+TEST(QueueManagerTest, UnsupportedWorkHasNoFamily)
+{
+   const std::array infos{
+      QueueFamilyInfo{0, 1, WorkType::Graphics | WorkType::Transfer},
+   };
+
+   EXPECT_EQ(selected_family(infos, WorkType::Presentation), std::numeric_limits<u32>::max());
+   EXPECT_EQ(selected_family({}, WorkType::Transfer), std::numeric_limits<u32>::max());
+}
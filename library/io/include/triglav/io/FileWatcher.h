@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Path.h"
+#include "Result.h"
+
+#include <memory>
+#include <vector>
+
+namespace triglav::io {
+
+// Reports the files written or replaced in the watched directories, subdirectories are not watched.
+class IFileWatcher
+{
+ public:
+   virtual ~IFileWatcher() = default;
+
+   // Watching a directory again has no effect.
+   [[nodiscard]] virtual Status watch_directory(const Path& path) = 0;
+   // Returns the files changed since the last call without blocking, each of them once.
+   [[nodiscard]] virtual std::vector<Path> changed_files() = 0;
+};
+
+using IFileWatcherUPtr = std::unique_ptr<IFileWatcher>;
+
+// Watches with inotify on Linux, other platforms return Status::Unsupported.
+Result<IFileWatcherUPtr> create_file_watcher();
+
+}// namespace triglav::io
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Path.h"
+#include "Result.h"
+
+#include "triglav/Int.hpp"
+
+#include <span>
+
+namespace triglav::io {
+
+// Read-only mapping of a whole file. Pages are read by the OS on first access, reading the contents takes no syscalls.
+class MappedFile
+{
+ public:
+   MappedFile(const u8* data, MemorySize size);
+   ~MappedFile();
+
+   MappedFile(const MappedFile& other) = delete;
+   MappedFile& operator=(const MappedFile& other) = delete;
+   MappedFile(MappedFile&& other) noexcept;
+   MappedFile& operator=(MappedFile&& other) noexcept;
+
+   [[nodiscard]] std::span<const u8> data() const;
+
+ private:
+   const u8* m_data;
+   MemorySize m_size;
+};
+
+Result<MappedFile> map_file(const Path& path);
+
+}// namespace triglav::io
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "File.h"
+
+#include <vector>
+
+namespace triglav::io {
+
+// Read-only file with its contents in memory, either a view of data owned elsewhere or its own buffer.
+class MemoryFile final : public IFile
+{
+ public:
+   explicit MemoryFile(std::span<const u8> data);
+   explicit MemoryFile(std::vector<u8>&& buffer);
+
+   [[nodiscard]] Result<MemorySize> read(std::span<u8> buffer) override;
+   [[nodiscard]] Result<MemorySize> write(std::span<u8> buffer) override;
+   [[nodiscard]] Status seek(SeekPosition position, MemoryOffset offset) override;
+   [[nodiscard]] Result<MemorySize> file_size() override;
+
+ private:
+   std::vector<u8> m_buffer;
+   std::span<const u8> m_data;
+   MemorySize m_position{};
+};
+
+}// namespace triglav::io
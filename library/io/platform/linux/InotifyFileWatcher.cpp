@@ -0,0 +1,100 @@
+#include "InotifyFileWatcher.h"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+
+namespace triglav::io {
+
+Result<IFileWatcherUPtr> create_file_watcher()
+{
+   const auto res = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+   if (res < 0) {
+      return std::unexpected{Status::BrokenPipe};
+   }
+
+   return std::make_unique<linux::InotifyFileWatcher>(res);
+}
+
+}// namespace triglav::io
+
+namespace triglav::io::linux {
+
+namespace {
+
+// Editors either write the file in place or write a temporary file and rename it over the original one.
+constexpr u32 g_watchedEvents = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+}// namespace
+
+InotifyFileWatcher::InotifyFileWatcher(const int inotifyDescriptor) :
+    m_inotifyDescriptor(inotifyDescriptor)
+{
+}
+
+InotifyFileWatcher::~InotifyFileWatcher()
+{
+   ::close(m_inotifyDescriptor);
+}
+
+Status InotifyFileWatcher::watch_directory(const Path& path)
+{
+   std::unique_lock lk{m_mutex};
+
+   // Adding a watch for the same directory returns its existing descriptor.
+   const auto watchDescriptor = ::inotify_add_watch(m_inotifyDescriptor, path.string().c_str(), g_watchedEvents | IN_ONLYDIR);
+   if (watchDescriptor < 0) {
+      return Status::InvalidDirectory;
+   }
+
+   m_directories[watchDescriptor] = path.string();
+   return Status::Success;
+}
+
+std::vector<Path> InotifyFileWatcher::changed_files()
+{
+   std::unique_lock lk{m_mutex};
+
+   std::vector<std::string> changedFiles;
+
+   alignas(inotify_event) std::array<char, 4096> buffer;
+   while (true) {
+      const auto readSize = ::read(m_inotifyDescriptor, buffer.data(), buffer.size());
+      if (readSize <= 0)
+         break;
+
+      for (MemorySize offset = 0; offset < static_cast<MemorySize>(readSize);) {
+         inotify_event event{};
+         std::memcpy(&event, buffer.data() + offset, sizeof(inotify_event));
+         const auto* name = buffer.data() + offset + sizeof(inotify_event);
+         offset += sizeof(inotify_event) + event.len;
+
+         if (event.len == 0 || (event.mask & IN_ISDIR) != 0)
+            continue;
+
+         const auto directory = m_directories.find(event.wd);
+         if (directory == m_directories.end())
+            continue;
+
+         changedFiles.emplace_back(std::format("{}/{}", directory->second, name));
+      }
+   }
+
+   // A file written in several steps is reported once.
+   std::ranges::sort(changedFiles);
+   const auto [first, last] = std::ranges::unique(changedFiles);
+   changedFiles.erase(first, last);
+
+   std::vector<Path> result;
+   result.reserve(changedFiles.size());
+   for (const auto& file : changedFiles) {
+      result.emplace_back(file);
+   }
+   return result;
+}
+
+}// namespace triglav::io::linux
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "FileWatcher.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace triglav::io::linux {
+
+class InotifyFileWatcher final : public IFileWatcher
+{
+ public:
+   explicit InotifyFileWatcher(int inotifyDescriptor);
+   ~InotifyFileWatcher() override;
+
+   InotifyFileWatcher(const InotifyFileWatcher& other) = delete;
+   InotifyFileWatcher& operator=(const InotifyFileWatcher& other) = delete;
+
+   [[nodiscard]] Status watch_directory(const Path& path) override;
+   [[nodiscard]] std::vector<Path> changed_files() override;
+
+ private:
+   int m_inotifyDescriptor;
+   // Watched directories by their watch descriptors.
+   std::map<int, std::string> m_directories;
+   std::mutex m_mutex;
+};
+
+}// namespace triglav::io::linux
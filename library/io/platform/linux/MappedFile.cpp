@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace triglav::io {
+
+Result<MappedFile> map_file(const Path& path)
+{
+   const auto fileDescriptor = ::open(path.string().c_str(), O_RDONLY);
+   if (fileDescriptor < 0)
+      return std::unexpected{Status::InvalidFile};
+
+   struct ::stat fileStat
+   {};
+   if (::fstat(fileDescriptor, &fileStat) < 0) {
+      ::close(fileDescriptor);
+      return std::unexpected{Status::InvalidFile};
+   }
+
+   const auto size = static_cast<MemorySize>(fileStat.st_size);
+   if (size == 0) {
+      ::close(fileDescriptor);
+      return MappedFile{nullptr, 0};
+   }
+
+   // The mapping stays valid after the descriptor is closed.
+   void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+   ::close(fileDescriptor);
+   if (data == MAP_FAILED)
+      return std::unexpected{Status::BrokenPipe};
+
+   return MappedFile{static_cast<const u8*>(data), size};
+}
+
+MappedFile::MappedFile(const u8* data, const MemorySize size) :
+    m_data(data),
+    m_size(size)
+{
+}
+
+MappedFile::~MappedFile()
+{
+   if (m_data != nullptr) {
+      ::munmap(const_cast<u8*>(m_data), m_size);
+   }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+   if (this == &other)
+      return *this;
+
+   if (m_data != nullptr) {
+      ::munmap(const_cast<u8*>(m_data), m_size);
+   }
+   m_data = std::exchange(other.m_data, nullptr);
+   m_size = std::exchange(other.m_size, 0);
+   return *this;
+}
+
+std::span<const u8> MappedFile::data() const
+{
+   return {m_data, m_size};
+}
+
+}// namespace triglav::io
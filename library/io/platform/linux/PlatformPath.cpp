@@ -24,7 +24,10 @@ bool is_existing_path(const Path& path)
 Result<std::string> full_path(const std::string_view path)
 {
    char result[PATH_MAX];
-   ::realpath(path.data(), result);
+   // Fails for paths that don't exist yet.
+   if (::realpath(path.data(), result) == nullptr) {
+      return std::unexpected{Status::InvalidFile};
+   }
    return std::string{result};
 }
 
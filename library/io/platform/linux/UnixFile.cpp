@@ -66,10 +66,13 @@ Status UnixFile::seek(SeekPosition position, MemoryOffset offset)
    switch (position) {
    case SeekPosition::Begin:
       whence = SEEK_SET;
+      break;
    case SeekPosition::Current:
       whence = SEEK_CUR;
+      break;
    case SeekPosition::End:
       whence = SEEK_END;
+      break;
    }
 
    const auto res = ::lseek(m_fileDescriptor, offset, whence);
@@ -0,0 +1,10 @@
+#include "FileWatcher.h"
+
+namespace triglav::io {
+
+Result<IFileWatcherUPtr> create_file_watcher()
+{
+   return std::unexpected{Status::Unsupported};
+}
+
+}// namespace triglav::io
@@ -0,0 +1,76 @@
+#include "MappedFile.h"
+
+#include <Windows.h>
+
+#include <utility>
+
+namespace triglav::io {
+
+Result<MappedFile> map_file(const Path& path)
+{
+   const auto file = CreateFileA(path.string().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file == INVALID_HANDLE_VALUE)
+      return std::unexpected{Status::InvalidFile};
+
+   LARGE_INTEGER fileSize{};
+   if (not GetFileSizeEx(file, &fileSize)) {
+      CloseHandle(file);
+      return std::unexpected{Status::InvalidFile};
+   }
+   if (fileSize.QuadPart == 0) {
+      CloseHandle(file);
+      return MappedFile{nullptr, 0};
+   }
+
+   const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   CloseHandle(file);
+   if (mapping == nullptr)
+      return std::unexpected{Status::BrokenPipe};
+
+   // The view keeps the mapping alive after its handle is closed.
+   const auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   CloseHandle(mapping);
+   if (data == nullptr)
+      return std::unexpected{Status::BrokenPipe};
+
+   return MappedFile{static_cast<const u8*>(data), static_cast<MemorySize>(fileSize.QuadPart)};
+}
+
+MappedFile::MappedFile(const u8* data, const MemorySize size) :
+    m_data(data),
+    m_size(size)
+{
+}
+
+MappedFile::~MappedFile()
+{
+   if (m_data != nullptr) {
+      UnmapViewOfFile(m_data);
+   }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+   if (this == &other)
+      return *this;
+
+   if (m_data != nullptr) {
+      UnmapViewOfFile(m_data);
+   }
+   m_data = std::exchange(other.m_data, nullptr);
+   m_size = std::exchange(other.m_size, 0);
+   return *this;
+}
+
+std::span<const u8> MappedFile::data() const
+{
+   return {m_data, m_size};
+}
+
+}// namespace triglav::io
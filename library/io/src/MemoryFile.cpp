@@ -0,0 +1,60 @@
+#include "MemoryFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace triglav::io {
+
+MemoryFile::MemoryFile(const std::span<const u8> data) :
+    m_data(data)
+{
+}
+
+MemoryFile::MemoryFile(std::vector<u8>&& buffer) :
+    m_buffer(std::move(buffer)),
+    m_data(m_buffer)
+{
+}
+
+Result<MemorySize> MemoryFile::read(const std::span<u8> buffer)
+{
+   const auto size = std::min(buffer.size(), m_data.size() - m_position);
+   std::memcpy(buffer.data(), m_data.data() + m_position, size);
+   m_position += size;
+   return size;
+}
+
+Result<MemorySize> MemoryFile::write([[maybe_unused]] const std::span<u8> buffer)
+{
+   return std::unexpected(Status::InvalidFile);
+}
+
+Status MemoryFile::seek(const SeekPosition position, const MemoryOffset offset)
+{
+   MemoryOffset base{};
+   switch (position) {
+   case SeekPosition::Begin:
+      base = 0;
+      break;
+   case SeekPosition::Current:
+      base = static_cast<MemoryOffset>(m_position);
+      break;
+   case SeekPosition::End:
+      base = static_cast<MemoryOffset>(m_data.size());
+      break;
+   }
+
+   const auto target = base + offset;
+   if (target < 0 || target > static_cast<MemoryOffset>(m_data.size()))
+      return Status::InvalidFile;
+
+   m_position = static_cast<MemorySize>(target);
+   return Status::Success;
+}
+
+Result<MemorySize> MemoryFile::file_size()
+{
+   return m_data.size();
+}
+
+}// namespace triglav::io
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Format.h"
+
+#include "triglav/Int.hpp"
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace triglav::ktx {
+
+// Texels of a single 4x4 block in row order, four bytes (RGBA) each.
+constexpr MemorySize g_blockTexelsSize = 4 * g_blockDimension * g_blockDimension;
+
+using BlockTexels = std::span<const u8, g_blockTexelsSize>;
+using OutputBlockTexels = std::span<u8, g_blockTexelsSize>;
+
+// Opaque BC1, endpoints come from a range fit along the principal axis refined with least squares.
+void encode_bc1_block(BlockTexels texels, std::span<u8, 8> output);
+// Single channel BC4 of the given texel component.
+void encode_bc4_block(BlockTexels texels, u32 channel, std::span<u8, 8> output);
+// Red and green channels encoded as two BC4 blocks.
+void encode_bc5_block(BlockTexels texels, std::span<u8, 16> output);
+// BC7 mode 6, a single RGBA subset with 7 bit endpoints, shared bits and 4 bit indices.
+void encode_bc7_block(BlockTexels texels, std::span<u8, 16> output);
+
+void decode_bc1_block(std::span<const u8, 8> block, OutputBlockTexels output);
+// Writes only the given component of the output texels.
+void decode_bc4_block(std::span<const u8, 8> block, u32 channel, OutputBlockTexels output);
+void decode_bc5_block(std::span<const u8, 16> block, OutputBlockTexels output);
+// Only decodes mode 6 blocks, the mode the encoder produces. Returns false for other modes.
+[[nodiscard]] bool decode_bc7_block(std::span<const u8, 16> block, OutputBlockTexels output);
+
+// Converts RGBA8 texels to the given format, partial blocks on the edges repeat the edge texels.
+[[nodiscard]] std::vector<u8> encode_image(Format format, std::span<const u8> texels, u32 width, u32 height);
+// Converts an image of the given format back to RGBA8. Single channel formats are replicated to RGB
+// and missing channels are zero, alpha is opaque when the format has none.
+[[nodiscard]] std::optional<std::vector<u8>> decode_image(Format format, std::span<const u8> data, u32 width, u32 height);
+
+}// namespace triglav::ktx
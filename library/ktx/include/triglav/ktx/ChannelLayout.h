@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Format.h"
+
+#include <optional>
+#include <string_view>
+
+namespace triglav::ktx {
+
+// Number of channels a texture holds, independent of how many the source image has.
+enum class ChannelLayout : u32
+{
+   R = 1,
+   RG = 2,
+   RGBA = 4,
+};
+
+enum class ColorSpace
+{
+   sRGB,
+   Linear,
+};
+
+struct TextureLayout
+{
+   ChannelLayout channels{ChannelLayout::RGBA};
+   ColorSpace colorSpace{ColorSpace::sRGB};
+};
+
+// Parses the channels property of a texture asset, one of r, rg or rgba.
+[[nodiscard]] std::optional<ChannelLayout> parse_channel_layout(std::string_view value);
+// Parses the color_space property of a texture asset, either srgb or linear.
+[[nodiscard]] std::optional<ColorSpace> parse_color_space(std::string_view value);
+
+// Layout implied by the file name of the source image, for example brick_height_map.png holds a single channel
+// and bark_normal.png two. Anything else is an RGBA color texture.
+[[nodiscard]] ChannelLayout channel_layout_from_name(std::string_view source);
+
+// Combines the declared channels and color space with the defaults. Empty or unknown values fall back to the mip
+// filter (normal maps have two channels) and then to the file name. Single and dual channel textures hold data and
+// are always linear.
+[[nodiscard]] TextureLayout resolve_texture_layout(std::string_view source, std::string_view channels, std::string_view colorSpace,
+                                                   bool isNormalMap);
+
+// Layout of the data a format stores, three channel formats count as RGBA.
+[[nodiscard]] TextureLayout texture_layout(Format format);
+
+// R8 or RG8 for data textures, RGBA8 in the declared color space otherwise.
+[[nodiscard]] Format uncompressed_format(const TextureLayout& layout);
+
+}// namespace triglav::ktx
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+
+namespace triglav::ktx {
+
+// Pixel formats of a KTX2 container, the values match VkFormat.
+enum class Format : u32
+{
+   Undefined = 0,
+   R8_UNorm = 9,
+   RG8_UNorm = 16,
+   RGBA8_UNorm = 37,
+   RGBA8_sRGB = 43,
+   BC1_RGB_UNorm = 131,
+   BC1_RGB_sRGB = 132,
+   BC4_UNorm = 139,
+   BC5_UNorm = 141,
+   BC7_UNorm = 145,
+   BC7_sRGB = 146,
+};
+
+// Width and height of a compressed block in texels.
+constexpr u32 g_blockDimension = 4;
+
+[[nodiscard]] bool is_supported_format(Format format);
+[[nodiscard]] bool is_block_compressed(Format format);
+[[nodiscard]] bool is_srgb(Format format);
+// Size of a block for compressed formats, size of a texel otherwise.
+[[nodiscard]] u32 block_size(Format format);
+// Number of channels the format stores, compressed formats decode to the same number of channels.
+[[nodiscard]] u32 channel_count(Format format);
+[[nodiscard]] MemorySize image_size(Format format, u32 width, u32 height);
+
+}// namespace triglav::ktx
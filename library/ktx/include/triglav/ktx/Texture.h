@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Format.h"
+
+#include "triglav/Int.hpp"
+
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace triglav::ktx {
+
+enum class Status
+{
+   Success,
+   InvalidIdentifier,
+   TruncatedData,
+   UnsupportedFormat,
+   UnsupportedLayout,
+   Supercompressed,
+};
+
+template<typename T>
+using Result = std::expected<T, Status>;
+
+// 2D texture stored in a KTX2 container, only single layer, single face textures without supercompression are supported.
+struct Texture
+{
+   Format format{};
+   u32 width{};
+   u32 height{};
+   // Data of each mip level, level 0 has the full resolution.
+   std::vector<std::vector<u8>> levels;
+
+   [[nodiscard]] u32 mip_width(u32 mipLevel) const;
+   [[nodiscard]] u32 mip_height(u32 mipLevel) const;
+   [[nodiscard]] MemorySize total_size() const;
+};
+
+struct LevelRange
+{
+   MemorySize offset{};
+   MemorySize size{};
+};
+
+// Header and level index of a KTX2 file, allows reading a subset of the levels without loading the whole file.
+struct Header
+{
+   Format format{};
+   u32 width{};
+   u32 height{};
+   std::vector<LevelRange> levels;
+};
+
+// Upper bound of the size of the header and the level index, reading this many bytes is enough to parse the header.
+constexpr MemorySize g_maxHeaderSize = 48 + 32 + 32 * 24;
+
+[[nodiscard]] std::vector<u8> write_ktx2(const Texture& texture);
+[[nodiscard]] Result<Texture> read_ktx2(std::span<const u8> data);
+// Validates the header and level index, fileSize is used to check the level ranges.
+[[nodiscard]] Result<Header> read_ktx2_header(std::span<const u8> data, MemorySize fileSize);
+
+// Path of the cooked KTX2 file of a source image, both relative to their root directories.
+[[nodiscard]] std::string cooked_texture_path(std::string_view source);
+
+}// namespace triglav::ktx
@@ -0,0 +1,717 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace triglav::ktx {
+
+namespace {
+
+constexpr u32 g_texelCount = g_blockDimension * g_blockDimension;
+constexpr std::array<u32, 16> g_bc7Weights{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+constexpr u32 g_bc7Mode = 6;
+
+template<u32 N>
+using Vector = std::array<float, N>;
+
+template<u32 N>
+using Color = std::array<i32, N>;
+
+template<u32 N>
+Vector<N> texel_vector(const BlockTexels texels, const u32 index)
+{
+   Vector<N> result{};
+   for (u32 c = 0; c < N; ++c) {
+      result[c] = static_cast<float>(texels[4 * index + c]);
+   }
+   return result;
+}
+
+template<u32 N>
+i32 distance_sq(const BlockTexels texels, const u32 index, const Color<N>& color)
+{
+   i32 result{};
+   for (u32 c = 0; c < N; ++c) {
+      const auto diff = static_cast<i32>(texels[4 * index + c]) - color[c];
+      result += diff * diff;
+   }
+   return result;
+}
+
+// Direction of the largest variance of the first N channels of the block.
+template<u32 N>
+Vector<N> principal_axis(const BlockTexels texels)
+{
+   Vector<N> mean{};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      const auto texel = texel_vector<N>(texels, i);
+      for (u32 c = 0; c < N; ++c) {
+         mean[c] += texel[c] / static_cast<float>(g_texelCount);
+      }
+   }
+
+   std::array<Vector<N>, N> covariance{};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      const auto texel = texel_vector<N>(texels, i);
+      for (u32 a = 0; a < N; ++a) {
+         for (u32 b = 0; b < N; ++b) {
+            covariance[a][b] += (texel[a] - mean[a]) * (texel[b] - mean[b]);
+         }
+      }
+   }
+
+   // Power iteration starting from the variances, which are only all zero for a solid block.
+   Vector<N> axis{};
+   for (u32 c = 0; c < N; ++c) {
+      axis[c] = covariance[c][c];
+   }
+
+   for (u32 iteration = 0; iteration < 8; ++iteration) {
+      Vector<N> next{};
+      float maxComponent{};
+      for (u32 a = 0; a < N; ++a) {
+         for (u32 b = 0; b < N; ++b) {
+            next[a] += covariance[a][b] * axis[b];
+         }
+         maxComponent = std::max(maxComponent, std::abs(next[a]));
+      }
+      if (maxComponent == 0.0f)
+         break;
+
+      for (u32 c = 0; c < N; ++c) {
+         axis[c] = next[c] / maxComponent;
+      }
+   }
+
+   return axis;
+}
+
+// Texels with the lowest and highest projection onto the principal axis.
+template<u32 N>
+std::pair<Vector<N>, Vector<N>> range_fit(const BlockTexels texels)
+{
+   const auto axis = principal_axis<N>(texels);
+
+   u32 minIndex{}, maxIndex{};
+   float minProjection{std::numeric_limits<float>::max()}, maxProjection{std::numeric_limits<float>::lowest()};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      const auto texel = texel_vector<N>(texels, i);
+      float projection{};
+      for (u32 c = 0; c < N; ++c) {
+         projection += texel[c] * axis[c];
+      }
+      if (projection < minProjection) {
+         minProjection = projection;
+         minIndex = i;
+      }
+      if (projection > maxProjection) {
+         maxProjection = projection;
+         maxIndex = i;
+      }
+   }
+
+   return {texel_vector<N>(texels, minIndex), texel_vector<N>(texels, maxIndex)};
+}
+
+// Endpoints minimizing the squared error for fixed interpolation weights, weights go from the first to the second endpoint.
+template<u32 N>
+bool least_squares_fit(const BlockTexels texels, const std::array<float, g_texelCount>& weights, Vector<N>& endpoint0, Vector<N>& endpoint1)
+{
+   float aa{}, ab{}, bb{};
+   Vector<N> ax{}, bx{};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      const auto a = 1.0f - weights[i];
+      const auto b = weights[i];
+      aa += a * a;
+      ab += a * b;
+      bb += b * b;
+
+      const auto texel = texel_vector<N>(texels, i);
+      for (u32 c = 0; c < N; ++c) {
+         ax[c] += a * texel[c];
+         bx[c] += b * texel[c];
+      }
+   }
+
+   const auto determinant = aa * bb - ab * ab;
+   if (std::abs(determinant) < 1e-6f)
+      return false;
+
+   for (u32 c = 0; c < N; ++c) {
+      endpoint0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+      endpoint1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+   }
+   return true;
+}
+
+class BitWriter
+{
+ public:
+   explicit BitWriter(const std::span<u8> data) :
+       m_data(data)
+   {
+      std::ranges::fill(m_data, 0);
+   }
+
+   void write(const u32 value, const u32 bitCount)
+   {
+      for (u32 bit = 0; bit < bitCount; ++bit, ++m_offset) {
+         if ((value >> bit) & 1u) {
+            m_data[m_offset / 8] |= static_cast<u8>(1u << (m_offset % 8));
+         }
+      }
+   }
+
+ private:
+   std::span<u8> m_data;
+   u32 m_offset{};
+};
+
+class BitReader
+{
+ public:
+   explicit BitReader(const std::span<const u8> data) :
+       m_data(data)
+   {
+   }
+
+   u32 read(const u32 bitCount)
+   {
+      u32 result{};
+      for (u32 bit = 0; bit < bitCount; ++bit, ++m_offset) {
+         result |= ((m_data[m_offset / 8] >> (m_offset % 8)) & 1u) << bit;
+      }
+      return result;
+   }
+
+ private:
+   std::span<const u8> m_data;
+   u32 m_offset{};
+};
+
+// BC1
+
+u16 pack_565(const Vector<3>& color)
+{
+   const auto r = static_cast<u16>(std::lround(color[0] * 31.0f / 255.0f));
+   const auto g = static_cast<u16>(std::lround(color[1] * 63.0f / 255.0f));
+   const auto b = static_cast<u16>(std::lround(color[2] * 31.0f / 255.0f));
+   return static_cast<u16>((r << 11) | (g << 5) | b);
+}
+
+Color<3> unpack_565(const u16 value)
+{
+   const auto r = (value >> 11) & 31;
+   const auto g = (value >> 5) & 63;
+   const auto b = value & 31;
+   return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+std::array<Color<3>, 4> bc1_palette(const u16 color0, const u16 color1)
+{
+   std::array<Color<3>, 4> palette{unpack_565(color0), unpack_565(color1)};
+   for (u32 c = 0; c < 3; ++c) {
+      if (color0 > color1) {
+         palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+         palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+      } else {
+         palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+         palette[3][c] = 0;
+      }
+   }
+   return palette;
+}
+
+struct Bc1Fit
+{
+   u16 color0{};
+   u16 color1{};
+   std::array<u32, g_texelCount> indices{};
+   i32 error{std::numeric_limits<i32>::max()};
+};
+
+Bc1Fit fit_bc1(const BlockTexels texels, const Vector<3>& endpoint0, const Vector<3>& endpoint1)
+{
+   Bc1Fit result{
+      .color0 = pack_565(endpoint0),
+      .color1 = pack_565(endpoint1),
+      .error = 0,
+   };
+   // The four color mode requires the first color to be greater.
+   if (result.color0 < result.color1) {
+      std::swap(result.color0, result.color1);
+   }
+
+   const auto palette = bc1_palette(result.color0, result.color1);
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      i32 bestError{std::numeric_limits<i32>::max()};
+      for (u32 index = 0; index < palette.size(); ++index) {
+         const auto error = distance_sq<3>(texels, i, palette[index]);
+         if (error < bestError) {
+            bestError = error;
+            result.indices[i] = index;
+         }
+      }
+      result.error += bestError;
+   }
+
+   return result;
+}
+
+// BC4
+
+std::array<i32, 8> bc4_palette(const u8 value0, const u8 value1)
+{
+   std::array<i32, 8> palette{value0, value1};
+   if (value0 > value1) {
+      for (i32 i = 2; i < 8; ++i) {
+         palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7;
+      }
+   } else {
+      for (i32 i = 2; i < 6; ++i) {
+         palette[i] = ((6 - i) * value0 + (i - 1) * value1) / 5;
+      }
+      palette[6] = 0;
+      palette[7] = 255;
+   }
+   return palette;
+}
+
+// BC7
+
+using Bc7Endpoint = std::pair<Color<4>, u32>;
+
+// Finds the 7 bit endpoint and the shared bit closest to the value.
+Bc7Endpoint quantize_bc7_endpoint(const Vector<4>& value)
+{
+   Bc7Endpoint result{};
+   float bestError{std::numeric_limits<float>::max()};
+   for (u32 pBit = 0; pBit < 2; ++pBit) {
+      Color<4> quantized{};
+      float error{};
+      for (u32 c = 0; c < 4; ++c) {
+         quantized[c] = std::clamp(static_cast<i32>(std::lround((value[c] - static_cast<float>(pBit)) / 2.0f)), 0, 127);
+         const auto diff = static_cast<float>((quantized[c] << 1) | static_cast<i32>(pBit)) - value[c];
+         error += diff * diff;
+      }
+      if (error < bestError) {
+         bestError = error;
+         result = {quantized, pBit};
+      }
+   }
+   return result;
+}
+
+Color<4> expand_bc7_endpoint(const Bc7Endpoint& endpoint)
+{
+   Color<4> result{};
+   for (u32 c = 0; c < 4; ++c) {
+      result[c] = (endpoint.first[c] << 1) | static_cast<i32>(endpoint.second);
+   }
+   return result;
+}
+
+std::array<Color<4>, 16> bc7_palette(const Bc7Endpoint& endpoint0, const Bc7Endpoint& endpoint1)
+{
+   const auto color0 = expand_bc7_endpoint(endpoint0);
+   const auto color1 = expand_bc7_endpoint(endpoint1);
+
+   std::array<Color<4>, 16> palette{};
+   for (u32 index = 0; index < palette.size(); ++index) {
+      const auto weight = static_cast<i32>(g_bc7Weights[index]);
+      for (u32 c = 0; c < 4; ++c) {
+         palette[index][c] = ((64 - weight) * color0[c] + weight * color1[c] + 32) >> 6;
+      }
+   }
+   return palette;
+}
+
+struct Bc7Fit
+{
+   Bc7Endpoint endpoint0{};
+   Bc7Endpoint endpoint1{};
+   std::array<u32, g_texelCount> indices{};
+   i32 error{std::numeric_limits<i32>::max()};
+};
+
+Bc7Fit fit_bc7(const BlockTexels texels, const Vector<4>& endpoint0, const Vector<4>& endpoint1)
+{
+   Bc7Fit result{
+      .endpoint0 = quantize_bc7_endpoint(endpoint0),
+      .endpoint1 = quantize_bc7_endpoint(endpoint1),
+      .error = 0,
+   };
+
+   const auto palette = bc7_palette(result.endpoint0, result.endpoint1);
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      i32 bestError{std::numeric_limits<i32>::max()};
+      for (u32 index = 0; index < palette.size(); ++index) {
+         const auto error = distance_sq<4>(texels, i, palette[index]);
+         if (error < bestError) {
+            bestError = error;
+            result.indices[i] = index;
+         }
+      }
+      result.error += bestError;
+   }
+
+   return result;
+}
+
+template<MemorySize TBlockSize>
+void encode_blocks(const std::span<const u8> texels, const u32 width, const u32 height, std::vector<u8>& output,
+                   void (*encodeBlock)(BlockTexels, std::span<u8, TBlockSize>))
+{
+   const auto blockCountX = (width + g_blockDimension - 1) / g_blockDimension;
+   const auto blockCountY = (height + g_blockDimension - 1) / g_blockDimension;
+   output.resize(static_cast<MemorySize>(blockCountX) * blockCountY * TBlockSize);
+
+   std::array<u8, g_blockTexelsSize> block{};
+   auto* dst = output.data();
+   for (u32 blockY = 0; blockY < blockCountY; ++blockY) {
+      for (u32 blockX = 0; blockX < blockCountX; ++blockX) {
+         for (u32 y = 0; y < g_blockDimension; ++y) {
+            for (u32 x = 0; x < g_blockDimension; ++x) {
+               const auto srcX = std::min(blockX * g_blockDimension + x, width - 1);
+               const auto srcY = std::min(blockY * g_blockDimension + y, height - 1);
+               std::copy_n(&texels[4 * (static_cast<MemorySize>(srcY) * width + srcX)], 4, &block[4 * (y * g_blockDimension + x)]);
+            }
+         }
+         encodeBlock(block, std::span<u8, TBlockSize>{dst, TBlockSize});
+         dst += TBlockSize;
+      }
+   }
+}
+
+template<MemorySize TBlockSize>
+bool decode_blocks(const std::span<const u8> data, const u32 width, const u32 height, std::vector<u8>& output,
+                   bool (*decodeBlock)(std::span<const u8, TBlockSize>, OutputBlockTexels))
+{
+   const auto blockCountX = (width + g_blockDimension - 1) / g_blockDimension;
+   const auto blockCountY = (height + g_blockDimension - 1) / g_blockDimension;
+   output.resize(4 * static_cast<MemorySize>(width) * height);
+
+   std::array<u8, g_blockTexelsSize> block{};
+   const auto* src = data.data();
+   for (u32 blockY = 0; blockY < blockCountY; ++blockY) {
+      for (u32 blockX = 0; blockX < blockCountX; ++blockX) {
+         if (not decodeBlock(std::span<const u8, TBlockSize>{src, TBlockSize}, block))
+            return false;
+         src += TBlockSize;
+
+         for (u32 y = 0; y < g_blockDimension; ++y) {
+            for (u32 x = 0; x < g_blockDimension; ++x) {
+               const auto dstX = blockX * g_blockDimension + x;
+               const auto dstY = blockY * g_blockDimension + y;
+               if (dstX >= width || dstY >= height)
+                  continue;
+               std::copy_n(&block[4 * (y * g_blockDimension + x)], 4, &output[4 * (static_cast<MemorySize>(dstY) * width + dstX)]);
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
+}// namespace
+
+void encode_bc1_block(const BlockTexels texels, const std::span<u8, 8> output)
+{
+   const auto [minEndpoint, maxEndpoint] = range_fit<3>(texels);
+   auto best = fit_bc1(texels, maxEndpoint, minEndpoint);
+
+   // Refine the endpoints for the selected indices, only in the four color mode.
+   if (best.color0 > best.color1) {
+      static constexpr std::array g_indexWeights{0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+      std::array<float, g_texelCount> weights{};
+      for (u32 i = 0; i < g_texelCount; ++i) {
+         weights[i] = g_indexWeights[best.indices[i]];
+      }
+
+      Vector<3> endpoint0{}, endpoint1{};
+      if (least_squares_fit<3>(texels, weights, endpoint0, endpoint1)) {
+         const auto refined = fit_bc1(texels, endpoint0, endpoint1);
+         if (refined.error < best.error) {
+            best = refined;
+         }
+      }
+   }
+
+   u32 indices{};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      indices |= best.indices[i] << (2 * i);
+   }
+
+   output[0] = static_cast<u8>(best.color0 & 0xff);
+   output[1] = static_cast<u8>(best.color0 >> 8);
+   output[2] = static_cast<u8>(best.color1 & 0xff);
+   output[3] = static_cast<u8>(best.color1 >> 8);
+   for (u32 i = 0; i < 4; ++i) {
+      output[4 + i] = static_cast<u8>(indices >> (8 * i));
+   }
+}
+
+void encode_bc4_block(const BlockTexels texels, const u32 channel, const std::span<u8, 8> output)
+{
+   assert(channel < 4);
+
+   u8 minValue{255}, maxValue{0};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      minValue = std::min(minValue, texels[4 * i + channel]);
+      maxValue = std::max(maxValue, texels[4 * i + channel]);
+   }
+
+   // The eight value mode, a solid block uses the first value for every texel.
+   const auto palette = bc4_palette(maxValue, minValue);
+
+   u64 indices{};
+   if (maxValue > minValue) {
+      for (u32 i = 0; i < g_texelCount; ++i) {
+         const auto value = static_cast<i32>(texels[4 * i + channel]);
+         u64 bestIndex{};
+         i32 bestError{std::numeric_limits<i32>::max()};
+         for (u32 index = 0; index < palette.size(); ++index) {
+            const auto error = std::abs(value - palette[index]);
+            if (error < bestError) {
+               bestError = error;
+               bestIndex = index;
+            }
+         }
+         indices |= bestIndex << (3 * i);
+      }
+   }
+
+   output[0] = maxValue;
+   output[1] = minValue;
+   for (u32 i = 0; i < 6; ++i) {
+      output[2 + i] = static_cast<u8>(indices >> (8 * i));
+   }
+}
+
+void encode_bc5_block(const BlockTexels texels, const std::span<u8, 16> output)
+{
+   encode_bc4_block(texels, 0, output.subspan<0, 8>());
+   encode_bc4_block(texels, 1, output.subspan<8, 8>());
+}
+
+void encode_bc7_block(const BlockTexels texels, const std::span<u8, 16> output)
+{
+   const auto [minEndpoint, maxEndpoint] = range_fit<4>(texels);
+   auto best = fit_bc7(texels, minEndpoint, maxEndpoint);
+
+   std::array<float, g_texelCount> weights{};
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      weights[i] = static_cast<float>(g_bc7Weights[best.indices[i]]) / 64.0f;
+   }
+
+   Vector<4> endpoint0{}, endpoint1{};
+   if (least_squares_fit<4>(texels, weights, endpoint0, endpoint1)) {
+      const auto refined = fit_bc7(texels, endpoint0, endpoint1);
+      if (refined.error < best.error) {
+         best = refined;
+      }
+   }
+
+   // The most significant bit of the first index is implicitly zero, swapping the endpoints inverts the indices.
+   if (best.indices[0] >= 8) {
+      std::swap(best.endpoint0, best.endpoint1);
+      for (auto& index : best.indices) {
+         index = 15 - index;
+      }
+   }
+
+   BitWriter writer{output};
+   writer.write(1u << g_bc7Mode, g_bc7Mode + 1);
+   for (u32 c = 0; c < 4; ++c) {
+      writer.write(static_cast<u32>(best.endpoint0.first[c]), 7);
+      writer.write(static_cast<u32>(best.endpoint1.first[c]), 7);
+   }
+   writer.write(best.endpoint0.second, 1);
+   writer.write(best.endpoint1.second, 1);
+   writer.write(best.indices[0], 3);
+   for (u32 i = 1; i < g_texelCount; ++i) {
+      writer.write(best.indices[i], 4);
+   }
+}
+
+void decode_bc1_block(const std::span<const u8, 8> block, const OutputBlockTexels output)
+{
+   const auto color0 = static_cast<u16>(block[0] | (block[1] << 8));
+   const auto color1 = static_cast<u16>(block[2] | (block[3] << 8));
+   const auto indices = static_cast<u32>(block[4] | (block[5] << 8) | (block[6] << 16) | (block[7] << 24));
+
+   const auto palette = bc1_palette(color0, color1);
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      const auto& color = palette[(indices >> (2 * i)) & 3u];
+      for (u32 c = 0; c < 3; ++c) {
+         output[4 * i + c] = static_cast<u8>(color[c]);
+      }
+      output[4 * i + 3] = 255;
+   }
+}
+
+void decode_bc4_block(const std::span<const u8, 8> block, const u32 channel, const OutputBlockTexels output)
+{
+   assert(channel < 4);
+
+   u64 indices{};
+   for (u32 i = 0; i < 6; ++i) {
+      indices |= static_cast<u64>(block[2 + i]) << (8 * i);
+   }
+
+   const auto palette = bc4_palette(block[0], block[1]);
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      output[4 * i + channel] = static_cast<u8>(palette[(indices >> (3 * i)) & 7u]);
+   }
+}
+
+void decode_bc5_block(const std::span<const u8, 16> block, const OutputBlockTexels output)
+{
+   decode_bc4_block(block.subspan<0, 8>(), 0, output);
+   decode_bc4_block(block.subspan<8, 8>(), 1, output);
+}
+
+bool decode_bc7_block(const std::span<const u8, 16> block, const OutputBlockTexels output)
+{
+   BitReader reader{block};
+
+   // The mode is the number of zero bits before the first set bit.
+   u32 mode{};
+   while (mode < 8 && reader.read(1) == 0) {
+      ++mode;
+   }
+   if (mode != g_bc7Mode)
+      return false;
+
+   Bc7Endpoint endpoint0{}, endpoint1{};
+   for (u32 c = 0; c < 4; ++c) {
+      endpoint0.first[c] = static_cast<i32>(reader.read(7));
+      endpoint1.first[c] = static_cast<i32>(reader.read(7));
+   }
+   endpoint0.second = reader.read(1);
+   endpoint1.second = reader.read(1);
+
+   const auto palette = bc7_palette(endpoint0, endpoint1);
+   for (u32 i = 0; i < g_texelCount; ++i) {
+      const auto& color = palette[reader.read(i == 0 ? 3 : 4)];
+      for (u32 c = 0; c < 4; ++c) {
+         output[4 * i + c] = static_cast<u8>(color[c]);
+      }
+   }
+
+   return true;
+}
+
+std::vector<u8> encode_image(const Format format, const std::span<const u8> texels, const u32 width, const u32 height)
+{
+   assert(texels.size() >= 4 * static_cast<MemorySize>(width) * height);
+
+   std::vector<u8> result;
+   switch (format) {
+   case Format::R8_UNorm:
+   case Format::RG8_UNorm:
+   case Format::RGBA8_UNorm:
+   case Format::RGBA8_sRGB: {
+      const auto channelCount = channel_count(format);
+      result.resize(static_cast<MemorySize>(width) * height * channelCount);
+      for (MemorySize i = 0; i < static_cast<MemorySize>(width) * height; ++i) {
+         std::copy_n(&texels[4 * i], channelCount, &result[channelCount * i]);
+      }
+      break;
+   }
+   case Format::BC1_RGB_UNorm:
+   case Format::BC1_RGB_sRGB:
+      encode_blocks<8>(texels, width, height, result, encode_bc1_block);
+      break;
+   case Format::BC4_UNorm:
+      encode_blocks<8>(texels, width, height, result, [](const BlockTexels block, const std::span<u8, 8> output) {
+         encode_bc4_block(block, 0, output);
+      });
+      break;
+   case Format::BC5_UNorm:
+      encode_blocks<16>(texels, width, height, result, encode_bc5_block);
+      break;
+   case Format::BC7_UNorm:
+   case Format::BC7_sRGB:
+      encode_blocks<16>(texels, width, height, result, encode_bc7_block);
+      break;
+   case Format::Undefined:
+      assert(false);
+      break;
+   }
+   return result;
+}
+
+std::optional<std::vector<u8>> decode_image(const Format format, const std::span<const u8> data, const u32 width, const u32 height)
+{
+   if (not is_supported_format(format) || data.size() < image_size(format, width, height))
+      return std::nullopt;
+
+   std::vector<u8> result;
+   bool isValid = true;
+   switch (format) {
+   case Format::R8_UNorm:
+   case Format::RG8_UNorm:
+   case Format::RGBA8_UNorm:
+   case Format::RGBA8_sRGB: {
+      const auto channelCount = channel_count(format);
+      result.resize(4 * static_cast<MemorySize>(width) * height);
+      for (MemorySize i = 0; i < static_cast<MemorySize>(width) * height; ++i) {
+         std::array<u8, 4> texel{0, 0, 0, 255};
+         std::copy_n(&data[channelCount * i], channelCount, texel.begin());
+         if (channelCount == 1) {
+            texel[1] = texel[0];
+            texel[2] = texel[0];
+         }
+         std::ranges::copy(texel, &result[4 * i]);
+      }
+      break;
+   }
+   case Format::BC1_RGB_UNorm:
+   case Format::BC1_RGB_sRGB:
+      isValid = decode_blocks<8>(data, width, height, result, [](const std::span<const u8, 8> block, const OutputBlockTexels output) {
+         decode_bc1_block(block, output);
+         return true;
+      });
+      break;
+   case Format::BC4_UNorm:
+      isValid = decode_blocks<8>(data, width, height, result, [](const std::span<const u8, 8> block, const OutputBlockTexels output) {
+         decode_bc4_block(block, 0, output);
+         for (u32 i = 0; i < g_texelCount; ++i) {
+            output[4 * i + 1] = output[4 * i];
+            output[4 * i + 2] = output[4 * i];
+            output[4 * i + 3] = 255;
+         }
+         return true;
+      });
+      break;
+   case Format::BC5_UNorm:
+      isValid = decode_blocks<16>(data, width, height, result, [](const std::span<const u8, 16> block, const OutputBlockTexels output) {
+         decode_bc5_block(block, output);
+         for (u32 i = 0; i < g_texelCount; ++i) {
+            output[4 * i + 2] = 0;
+            output[4 * i + 3] = 255;
+         }
+         return true;
+      });
+      break;
+   case Format::BC7_UNorm:
+   case Format::BC7_sRGB:
+      isValid = decode_blocks<16>(data, width, height, result, decode_bc7_block);
+      break;
+   case Format::Undefined:
+      return std::nullopt;
+   }
+
+   if (not isValid)
+      return std::nullopt;
+
+   return result;
+}
+
+}// namespace triglav::ktx
@@ -0,0 +1,117 @@
+#include "ChannelLayout.h"
+
+#include <array>
+
+namespace triglav::ktx {
+
+namespace {
+
+struct NameSuffix
+{
+   std::string_view suffix;
+   ChannelLayout channels;
+};
+
+constexpr std::array g_nameSuffixes{
+   NameSuffix{"_height_map", ChannelLayout::R}, NameSuffix{"_height", ChannelLayout::R},      NameSuffix{"_metallic", ChannelLayout::R},
+   NameSuffix{"_roughness", ChannelLayout::R},  NameSuffix{"_ao", ChannelLayout::R},          NameSuffix{"_occlusion", ChannelLayout::R},
+   NameSuffix{"_mask", ChannelLayout::R},       NameSuffix{"_normal_map", ChannelLayout::RG}, NameSuffix{"_normal", ChannelLayout::RG},
+};
+
+std::string_view file_stem(const std::string_view path)
+{
+   const auto nameStart = path.find_last_of('/');
+   auto result = nameStart == std::string_view::npos ? path : path.substr(nameStart + 1);
+   if (const auto extensionStart = result.find_last_of('.'); extensionStart != std::string_view::npos) {
+      result = result.substr(0, extensionStart);
+   }
+   return result;
+}
+
+}// namespace
+
+std::optional<ChannelLayout> parse_channel_layout(const std::string_view value)
+{
+   if (value == "r")
+      return ChannelLayout::R;
+   if (value == "rg")
+      return ChannelLayout::RG;
+   if (value == "rgba")
+      return ChannelLayout::RGBA;
+   return std::nullopt;
+}
+
+std::optional<ColorSpace> parse_color_space(const std::string_view value)
+{
+   if (value == "srgb")
+      return ColorSpace::sRGB;
+   if (value == "linear")
+      return ColorSpace::Linear;
+   return std::nullopt;
+}
+
+ChannelLayout channel_layout_from_name(const std::string_view source)
+{
+   const auto stem = file_stem(source);
+   for (const auto& [suffix, channels] : g_nameSuffixes) {
+      if (stem.ends_with(suffix))
+         return channels;
+   }
+   return ChannelLayout::RGBA;
+}
+
+TextureLayout resolve_texture_layout(const std::string_view source, const std::string_view channels, const std::string_view colorSpace,
+                                     const bool isNormalMap)
+{
+   TextureLayout result{};
+
+   if (const auto declaredChannels = parse_channel_layout(channels); declaredChannels.has_value()) {
+      result.channels = *declaredChannels;
+   } else if (isNormalMap) {
+      result.channels = ChannelLayout::RG;
+   } else {
+      result.channels = channel_layout_from_name(source);
+   }
+
+   if (result.channels != ChannelLayout::RGBA || isNormalMap) {
+      result.colorSpace = ColorSpace::Linear;
+   } else {
+      result.colorSpace = parse_color_space(colorSpace).value_or(ColorSpace::sRGB);
+   }
+
+   return result;
+}
+
+TextureLayout texture_layout(const Format format)
+{
+   TextureLayout result{
+      .colorSpace = is_srgb(format) ? ColorSpace::sRGB : ColorSpace::Linear,
+   };
+   switch (channel_count(format)) {
+   case 1:
+      result.channels = ChannelLayout::R;
+      break;
+   case 2:
+      result.channels = ChannelLayout::RG;
+      break;
+   default:
+      result.channels = ChannelLayout::RGBA;
+      break;
+   }
+   return result;
+}
+
+Format uncompressed_format(const TextureLayout& layout)
+{
+   switch (layout.channels) {
+   case ChannelLayout::R:
+      return Format::R8_UNorm;
+   case ChannelLayout::RG:
+      return Format::RG8_UNorm;
+   case ChannelLayout::RGBA:
+      break;
+   }
+   return layout.colorSpace == ColorSpace::sRGB ? Format::RGBA8_sRGB : Format::RGBA8_UNorm;
+}
+
+}// namespace triglav::ktx
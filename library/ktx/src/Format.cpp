@@ -0,0 +1,88 @@
+#include "Format.h"
+
+namespace triglav::ktx {
+
+bool is_supported_format(const Format format)
+{
+   return block_size(format) != 0;
+}
+
+bool is_block_compressed(const Format format)
+{
+   switch (format) {
+   case Format::BC1_RGB_UNorm:
+   case Format::BC1_RGB_sRGB:
+   case Format::BC4_UNorm:
+   case Format::BC5_UNorm:
+   case Format::BC7_UNorm:
+   case Format::BC7_sRGB:
+      return true;
+   default:
+      break;
+   }
+   return false;
+}
+
+bool is_srgb(const Format format)
+{
+   return format == Format::RGBA8_sRGB || format == Format::BC1_RGB_sRGB || format == Format::BC7_sRGB;
+}
+
+u32 block_size(const Format format)
+{
+   switch (format) {
+   case Format::R8_UNorm:
+      return 1;
+   case Format::RG8_UNorm:
+      return 2;
+   case Format::RGBA8_UNorm:
+   case Format::RGBA8_sRGB:
+      return 4;
+   case Format::BC1_RGB_UNorm:
+   case Format::BC1_RGB_sRGB:
+   case Format::BC4_UNorm:
+      return 8;
+   case Format::BC5_UNorm:
+   case Format::BC7_UNorm:
+   case Format::BC7_sRGB:
+      return 16;
+   case Format::Undefined:
+      break;
+   }
+   return 0;
+}
+
+u32 channel_count(const Format format)
+{
+   switch (format) {
+   case Format::R8_UNorm:
+   case Format::BC4_UNorm:
+      return 1;
+   case Format::RG8_UNorm:
+   case Format::BC5_UNorm:
+      return 2;
+   case Format::BC1_RGB_UNorm:
+   case Format::BC1_RGB_sRGB:
+      return 3;
+   case Format::RGBA8_UNorm:
+   case Format::RGBA8_sRGB:
+   case Format::BC7_UNorm:
+   case Format::BC7_sRGB:
+      return 4;
+   case Format::Undefined:
+      break;
+   }
+   return 0;
+}
+
+MemorySize image_size(const Format format, const u32 width, const u32 height)
+{
+   if (is_block_compressed(format)) {
+      const auto blockCountX = (width + g_blockDimension - 1) / g_blockDimension;
+      const auto blockCountY = (height + g_blockDimension - 1) / g_blockDimension;
+      return static_cast<MemorySize>(blockCountX) * blockCountY * block_size(format);
+   }
+   return static_cast<MemorySize>(width) * height * block_size(format);
+}
+
+}// namespace triglav::ktx
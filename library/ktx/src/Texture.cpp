@@ -0,0 +1,308 @@
+#include "Texture.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <string_view>
+
+namespace triglav::ktx {
+
+namespace {
+
+constexpr std::array<u8, 12> g_identifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr MemorySize g_headerSize = 48;
+constexpr MemorySize g_indexSize = 32;
+constexpr MemorySize g_levelIndexEntrySize = 24;
+constexpr std::string_view g_writerKey{"KTXwriter"};
+constexpr std::string_view g_writerName{"triglav ktx"};
+
+// Data format descriptor constants from the Khronos Data Format specification.
+constexpr u32 g_dfdVersion = 2;
+constexpr u32 g_dfdColorModelRGBSDA = 1;
+constexpr u32 g_dfdColorModelBC1A = 128;
+constexpr u32 g_dfdColorModelBC4 = 131;
+constexpr u32 g_dfdColorModelBC5 = 132;
+constexpr u32 g_dfdColorModelBC7 = 134;
+constexpr u32 g_dfdPrimariesBT709 = 1;
+constexpr u32 g_dfdTransferLinear = 1;
+constexpr u32 g_dfdTransferSRGB = 2;
+constexpr u32 g_dfdChannelAlpha = 15;
+constexpr u32 g_dfdSampleLinear = 0x10;
+
+struct DfdSample
+{
+   u32 bitOffset;
+   u32 bitLength;
+   u32 channelType;
+   u32 upper;
+};
+
+class ByteWriter
+{
+ public:
+   explicit ByteWriter(std::vector<u8>& data) :
+       m_data(data)
+   {
+   }
+
+   template<typename T>
+   void write(const T value)
+   {
+      const auto offset = m_data.size();
+      m_data.resize(offset + sizeof(T));
+      std::memcpy(m_data.data() + offset, &value, sizeof(T));
+   }
+
+   template<typename T>
+   void write_at(const MemorySize offset, const T value)
+   {
+      std::memcpy(m_data.data() + offset, &value, sizeof(T));
+   }
+
+   void write_bytes(const std::span<const u8> bytes)
+   {
+      m_data.insert(m_data.end(), bytes.begin(), bytes.end());
+   }
+
+   void align(const MemorySize alignment)
+   {
+      m_data.resize((m_data.size() + alignment - 1) / alignment * alignment);
+   }
+
+   [[nodiscard]] MemorySize offset() const
+   {
+      return m_data.size();
+   }
+
+ private:
+   std::vector<u8>& m_data;
+};
+
+template<typename T>
+T read_value(const std::span<const u8> data, const MemorySize offset)
+{
+   T result;
+   std::memcpy(&result, data.data() + offset, sizeof(T));
+   return result;
+}
+
+std::vector<DfdSample> dfd_samples(const Format format, u32& colorModel)
+{
+   switch (format) {
+   case Format::R8_UNorm:
+      colorModel = g_dfdColorModelRGBSDA;
+      return {{0, 7, 0, 255}};
+   case Format::RG8_UNorm:
+      colorModel = g_dfdColorModelRGBSDA;
+      return {{0, 7, 0, 255}, {8, 7, 1, 255}};
+   case Format::RGBA8_UNorm:
+      colorModel = g_dfdColorModelRGBSDA;
+      return {{0, 7, 0, 255}, {8, 7, 1, 255}, {16, 7, 2, 255}, {24, 7, g_dfdChannelAlpha, 255}};
+   case Format::RGBA8_sRGB:
+      colorModel = g_dfdColorModelRGBSDA;
+      return {{0, 7, 0, 255}, {8, 7, 1, 255}, {16, 7, 2, 255}, {24, 7, g_dfdChannelAlpha | g_dfdSampleLinear, 255}};
+   case Format::BC1_RGB_UNorm:
+   case Format::BC1_RGB_sRGB:
+      colorModel = g_dfdColorModelBC1A;
+      return {{0, 63, 0, 0xFFFFFFFF}};
+   case Format::BC4_UNorm:
+      colorModel = g_dfdColorModelBC4;
+      return {{0, 63, 0, 0xFFFFFFFF}};
+   case Format::BC5_UNorm:
+      colorModel = g_dfdColorModelBC5;
+      return {{0, 63, 0, 0xFFFFFFFF}, {64, 63, 1, 0xFFFFFFFF}};
+   case Format::BC7_UNorm:
+   case Format::BC7_sRGB:
+      colorModel = g_dfdColorModelBC7;
+      return {{0, 127, 0, 0xFFFFFFFF}};
+   case Format::Undefined:
+      break;
+   }
+   return {};
+}
+
+void write_dfd(ByteWriter& writer, const Format format)
+{
+   u32 colorModel{};
+   const auto samples = dfd_samples(format, colorModel);
+   const auto blockSize = static_cast<u32>(24 + 16 * samples.size());
+   const auto blockDimension = is_block_compressed(format) ? g_blockDimension - 1 : 0;
+   const auto transfer = is_srgb(format) ? g_dfdTransferSRGB : g_dfdTransferLinear;
+
+   writer.write<u32>(4 + blockSize);
+   writer.write<u32>(0);
+   writer.write<u32>(g_dfdVersion | (blockSize << 16));
+   writer.write<u32>(colorModel | (g_dfdPrimariesBT709 << 8) | (transfer << 16));
+   writer.write<u32>(blockDimension | (blockDimension << 8));
+   writer.write<u32>(block_size(format));
+   writer.write<u32>(0);
+
+   for (const auto& sample : samples) {
+      writer.write<u32>(sample.bitOffset | (sample.bitLength << 16) | (sample.channelType << 24));
+      writer.write<u32>(0);
+      writer.write<u32>(0);
+      writer.write<u32>(sample.upper);
+   }
+}
+
+}// namespace
+
+u32 Texture::mip_width(const u32 mipLevel) const
+{
+   return std::max(this->width >> mipLevel, 1u);
+}
+
+u32 Texture::mip_height(const u32 mipLevel) const
+{
+   return std::max(this->height >> mipLevel, 1u);
+}
+
+MemorySize Texture::total_size() const
+{
+   return std::accumulate(this->levels.begin(), this->levels.end(), MemorySize{0},
+                          [](const MemorySize sum, const std::vector<u8>& level) { return sum + level.size(); });
+}
+
+std::vector<u8> write_ktx2(const Texture& texture)
+{
+   std::vector<u8> result;
+   ByteWriter writer{result};
+
+   const auto levelCount = static_cast<u32>(texture.levels.size());
+
+   writer.write_bytes(g_identifier);
+   writer.write<u32>(static_cast<u32>(texture.format));
+   writer.write<u32>(1);// typeSize
+   writer.write<u32>(texture.width);
+   writer.write<u32>(texture.height);
+   writer.write<u32>(0);// pixelDepth
+   writer.write<u32>(0);// layerCount
+   writer.write<u32>(1);// faceCount
+   writer.write<u32>(levelCount);
+   writer.write<u32>(0);// supercompressionScheme
+
+   // The index and the level index are filled in once the offsets are known.
+   const auto indexOffset = writer.offset();
+   result.resize(indexOffset + g_indexSize + levelCount * g_levelIndexEntrySize);
+
+   const auto dfdOffset = writer.offset();
+   write_dfd(writer, texture.format);
+   const auto dfdSize = writer.offset() - dfdOffset;
+
+   const auto kvdOffset = writer.offset();
+   const auto entrySize = static_cast<u32>(g_writerKey.size() + g_writerName.size() + 2);
+   writer.write<u32>(entrySize);
+   writer.write_bytes({reinterpret_cast<const u8*>(g_writerKey.data()), g_writerKey.size()});
+   writer.write<u8>(0);
+   writer.write_bytes({reinterpret_cast<const u8*>(g_writerName.data()), g_writerName.size()});
+   writer.write<u8>(0);
+   writer.align(4);
+   const auto kvdSize = writer.offset() - kvdOffset;
+
+   writer.write_at<u32>(indexOffset, static_cast<u32>(dfdOffset));
+   writer.write_at<u32>(indexOffset + 4, static_cast<u32>(dfdSize));
+   writer.write_at<u32>(indexOffset + 8, static_cast<u32>(kvdOffset));
+   writer.write_at<u32>(indexOffset + 12, static_cast<u32>(kvdSize));
+   writer.write_at<u64>(indexOffset + 16, 0);
+   writer.write_at<u64>(indexOffset + 24, 0);
+
+   // Levels are stored from the smallest one so a partial read gets usable data first.
+   const auto alignment = std::lcm(static_cast<MemorySize>(block_size(texture.format)), MemorySize{4});
+   for (u32 mipLevel = levelCount; mipLevel-- > 0;) {
+      writer.align(alignment);
+
+      const auto& level = texture.levels[mipLevel];
+      const auto entryOffset = indexOffset + g_indexSize + mipLevel * g_levelIndexEntrySize;
+      writer.write_at<u64>(entryOffset, writer.offset());
+      writer.write_at<u64>(entryOffset + 8, level.size());
+      writer.write_at<u64>(entryOffset + 16, level.size());
+
+      writer.write_bytes(level);
+   }
+
+   return result;
+}
+
+Result<Header> read_ktx2_header(const std::span<const u8> data, const MemorySize fileSize)
+{
+   if (data.size() < g_headerSize + g_indexSize)
+      return std::unexpected(Status::TruncatedData);
+   if (not std::equal(g_identifier.begin(), g_identifier.end(), data.begin()))
+      return std::unexpected(Status::InvalidIdentifier);
+
+   Header result{
+      .format = static_cast<Format>(read_value<u32>(data, 12)),
+      .width = read_value<u32>(data, 20),
+      .height = read_value<u32>(data, 24),
+   };
+
+   const auto pixelDepth = read_value<u32>(data, 28);
+   const auto layerCount = read_value<u32>(data, 32);
+   const auto faceCount = read_value<u32>(data, 36);
+   // Zero levels means the mips are to be generated, the file then holds only the base level.
+   const auto levelCount = std::max(read_value<u32>(data, 40), 1u);
+   const auto supercompressionScheme = read_value<u32>(data, 44);
+
+   if (not is_supported_format(result.format))
+      return std::unexpected(Status::UnsupportedFormat);
+   if (supercompressionScheme != 0)
+      return std::unexpected(Status::Supercompressed);
+   if (result.width == 0 || result.height == 0 || pixelDepth > 1 || layerCount > 1 || faceCount != 1 || levelCount > 32)
+      return std::unexpected(Status::UnsupportedLayout);
+
+   const auto levelIndexOffset = g_headerSize + g_indexSize;
+   if (data.size() < levelIndexOffset + levelCount * g_levelIndexEntrySize)
+      return std::unexpected(Status::TruncatedData);
+
+   result.levels.resize(levelCount);
+   for (u32 mipLevel = 0; mipLevel < levelCount; ++mipLevel) {
+      const auto entryOffset = levelIndexOffset + mipLevel * g_levelIndexEntrySize;
+      const auto byteOffset = read_value<u64>(data, entryOffset);
+      const auto byteLength = read_value<u64>(data, entryOffset + 8);
+
+      const auto mipWidth = std::max(result.width >> mipLevel, 1u);
+      const auto mipHeight = std::max(result.height >> mipLevel, 1u);
+      if (byteLength != image_size(result.format, mipWidth, mipHeight))
+         return std::unexpected(Status::UnsupportedLayout);
+      if (byteOffset > fileSize || byteLength > fileSize - byteOffset)
+         return std::unexpected(Status::TruncatedData);
+
+      result.levels[mipLevel] = LevelRange{byteOffset, byteLength};
+   }
+
+   return result;
+}
+
+Result<Texture> read_ktx2(const std::span<const u8> data)
+{
+   auto header = read_ktx2_header(data, data.size());
+   if (not header.has_value())
+      return std::unexpected(header.error());
+
+   Texture result{
+      .format = header->format,
+      .width = header->width,
+      .height = header->height,
+   };
+
+   result.levels.reserve(header->levels.size());
+   for (const auto& range : header->levels) {
+      const auto level = data.subspan(range.offset, range.size);
+      result.levels.emplace_back(level.begin(), level.end());
+   }
+
+   return result;
+}
+
+std::string cooked_texture_path(const std::string_view source)
+{
+   const auto directoryEnd = source.find_last_of('/');
+   const auto extensionStart = source.find_last_of('.');
+   if (extensionStart == std::string_view::npos || (directoryEnd != std::string_view::npos && extensionStart < directoryEnd)) {
+      return std::string{source} + ".ktx2";
+   }
+   return std::string{source.substr(0, extensionStart)} + ".ktx2";
+}
+
+}// namespace triglav::ktx
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include "triglav/ktx/BlockCompression.h"
+
+#include <array>
+#include <cmath>
+
+using triglav::u32;
+using triglav::u8;
+using triglav::ktx::Format;
+
+namespace {
+
+using Block = std::array<u8, triglav::ktx::g_blockTexelsSize>;
+
+Block gradient_block()
+{
+   Block result{};
+   for (u32 i = 0; i < 16; ++i) {
+      result[4 * i] = static_cast<u8>(100 + 2 * i);
+      result[4 * i + 1] = static_cast<u8>(150 - 2 * i);
+      result[4 * i + 2] = static_cast<u8>(60 + i);
+      result[4 * i + 3] = 255;
+   }
+   return result;
+}
+
+double rmse(const std::span<const u8> expected, const std::span<const u8> actual, const u32 channelCount)
+{
+   double sum{};
+   u32 count{};
+   for (std::size_t i = 0; i < expected.size(); i += 4) {
+      for (u32 c = 0; c < channelCount; ++c) {
+         const auto diff = static_cast<double>(expected[i + c]) - static_cast<double>(actual[i + c]);
+         sum += diff * diff;
+         ++count;
+      }
+   }
+   return std::sqrt(sum / count);
+}
+
+}// namespace
+
+TEST(BlockCompressionTest, SolidBlocks)
+{
+   Block solid{};
+   for (u32 i = 0; i < 16; ++i) {
+      solid[4 * i] = 128;
+      solid[4 * i + 1] = 64;
+      solid[4 * i + 2] = 32;
+      solid[4 * i + 3] = 200;
+   }
+
+   std::array<u8, 8> bc4{};
+   triglav::ktx::encode_bc4_block(solid, 1, bc4);
+   Block bc4Decoded{};
+   triglav::ktx::decode_bc4_block(bc4, 1, bc4Decoded);
+   for (u32 i = 0; i < 16; ++i) {
+      EXPECT_EQ(bc4Decoded[4 * i + 1], 64);
+   }
+
+   std::array<u8, 16> bc7{};
+   triglav::ktx::encode_bc7_block(solid, bc7);
+   Block bc7Decoded{};
+   ASSERT_TRUE(triglav::ktx::decode_bc7_block(bc7, bc7Decoded));
+   EXPECT_EQ(bc7Decoded, solid);
+}
+
+TEST(BlockCompressionTest, Bc1Gradient)
+{
+   const auto block = gradient_block();
+
+   std::array<u8, 8> encoded{};
+   triglav::ktx::encode_bc1_block(block, encoded);
+   Block decoded{};
+   triglav::ktx::decode_bc1_block(encoded, decoded);
+
+   // Four color mode, the first endpoint is the greater one.
+   EXPECT_GT(encoded[0] | (encoded[1] << 8), encoded[2] | (encoded[3] << 8));
+   EXPECT_LT(rmse(block, decoded, 3), 4.0);
+   EXPECT_EQ(decoded[3], 255);
+}
+
+TEST(BlockCompressionTest, Bc4ExactForFewValues)
+{
+   Block block{};
+   for (u32 i = 0; i < 16; ++i) {
+      block[4 * i] = i % 2 == 0 ? 10 : 150;
+   }
+
+   std::array<u8, 8> encoded{};
+   triglav::ktx::encode_bc4_block(block, 0, encoded);
+   Block decoded{};
+   triglav::ktx::decode_bc4_block(encoded, 0, decoded);
+
+   for (u32 i = 0; i < 16; ++i) {
+      EXPECT_EQ(decoded[4 * i], block[4 * i]);
+   }
+}
+
+TEST(BlockCompressionTest, Bc5KeepsChannelsApart)
+{
+   Block block{};
+   for (u32 i = 0; i < 16; ++i) {
+      block[4 * i] = static_cast<u8>(4 * i);
+      block[4 * i + 1] = static_cast<u8>(255 - 4 * i);
+   }
+
+   std::array<u8, 16> encoded{};
+   triglav::ktx::encode_bc5_block(block, encoded);
+   Block decoded{};
+   triglav::ktx::decode_bc5_block(encoded, decoded);
+
+   EXPECT_LT(rmse(block, decoded, 2), 3.0);
+}
+
+TEST(BlockCompressionTest, Bc7Alpha)
+{
+   auto block = gradient_block();
+   for (u32 i = 0; i < 16; ++i) {
+      block[4 * i + 3] = static_cast<u8>(17 * i);
+   }
+
+   std::array<u8, 16> encoded{};
+   triglav::ktx::encode_bc7_block(block, encoded);
+
+   // Mode 6 is stored as six zero bits followed by a set bit.
+   EXPECT_EQ(encoded[0] & 0x7f, 0x40);
+
+   Block decoded{};
+   ASSERT_TRUE(triglav::ktx::decode_bc7_block(encoded, decoded));
+   EXPECT_LT(rmse(block, decoded, 4), 4.0);
+}
+
+TEST(BlockCompressionTest, Bc7RejectsOtherModes)
+{
+   std::array<u8, 16> encoded{};
+   encoded[0] = 0x01;
+
+   Block decoded{};
+   EXPECT_FALSE(triglav::ktx::decode_bc7_block(encoded, decoded));
+}
+
+TEST(BlockCompressionTest, PartialBlocks)
+{
+   constexpr u32 width = 6;
+   constexpr u32 height = 3;
+
+   std::vector<u8> texels(4 * width * height);
+   for (u32 i = 0; i < width * height; ++i) {
+      texels[4 * i] = static_cast<u8>(4 * i);
+      texels[4 * i + 1] = static_cast<u8>(4 * i);
+      texels[4 * i + 2] = static_cast<u8>(4 * i);
+      texels[4 * i + 3] = 255;
+   }
+
+   for (const auto format : {Format::BC1_RGB_sRGB, Format::BC4_UNorm, Format::BC7_sRGB}) {
+      const auto encoded = triglav::ktx::encode_image(format, texels, width, height);
+      ASSERT_EQ(encoded.size(), triglav::ktx::image_size(format, width, height));
+      EXPECT_EQ(encoded.size(), 2 * triglav::ktx::block_size(format));
+
+      const auto decoded = triglav::ktx::decode_image(format, encoded, width, height);
+      ASSERT_TRUE(decoded.has_value());
+      ASSERT_EQ(decoded->size(), texels.size());
+      EXPECT_LT(rmse(texels, *decoded, 3), 6.0);
+   }
+}
+
+TEST(BlockCompressionTest, UncompressedChannels)
+{
+   const std::vector<u8> texels{1, 2, 3, 4, 5, 6, 7, 8};
+
+   const auto encoded = triglav::ktx::encode_image(Format::RG8_UNorm, texels, 2, 1);
+   EXPECT_EQ(encoded, (std::vector<u8>{1, 2, 5, 6}));
+
+   const auto decoded = triglav::ktx::decode_image(Format::RG8_UNorm, encoded, 2, 1);
+   ASSERT_TRUE(decoded.has_value());
+   EXPECT_EQ(*decoded, (std::vector<u8>{1, 2, 0, 255, 5, 6, 0, 255}));
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "triglav/ktx/ChannelLayout.h"
+
+using triglav::ktx::ChannelLayout;
+using triglav::ktx::ColorSpace;
+using triglav::ktx::Format;
+using triglav::ktx::resolve_texture_layout;
+
+TEST(ChannelLayoutTest, LayoutFromName)
+{
+   EXPECT_EQ(triglav::ktx::channel_layout_from_name("texture/stone_height_map.png"), ChannelLayout::R);
+   EXPECT_EQ(triglav::ktx::channel_layout_from_name("texture/metal_roughness.jpg"), ChannelLayout::R);
+   EXPECT_EQ(triglav::ktx::channel_layout_from_name("texture/metal_metallic.jpg"), ChannelLayout::R);
+   EXPECT_EQ(triglav::ktx::channel_layout_from_name("texture/bark_normal.png"), ChannelLayout::RG);
+   EXPECT_EQ(triglav::ktx::channel_layout_from_name("texture/board.png"), ChannelLayout::RGBA);
+   // Only the file name is considered.
+   EXPECT_EQ(triglav::ktx::channel_layout_from_name("texture_ao/board.png"), ChannelLayout::RGBA);
+}
+
+TEST(ChannelLayoutTest, DeclaredLayoutTakesPrecedence)
+{
+   const auto layout = resolve_texture_layout("texture/stone_height_map.png", "rgba", "linear", false);
+   EXPECT_EQ(layout.channels, ChannelLayout::RGBA);
+   EXPECT_EQ(layout.colorSpace, ColorSpace::Linear);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(layout), Format::RGBA8_UNorm);
+}
+
+TEST(ChannelLayoutTest, DefaultLayouts)
+{
+   const auto color = resolve_texture_layout("texture/board.png", "", "", false);
+   EXPECT_EQ(color.channels, ChannelLayout::RGBA);
+   EXPECT_EQ(color.colorSpace, ColorSpace::sRGB);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(color), Format::RGBA8_sRGB);
+
+   const auto normalMap = resolve_texture_layout("texture/bark_nrm.png", "", "", true);
+   EXPECT_EQ(normalMap.channels, ChannelLayout::RG);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(normalMap), Format::RG8_UNorm);
+
+   const auto heightMap = resolve_texture_layout("texture/brick_height_map.png", "", "", false);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(heightMap), Format::R8_UNorm);
+}
+
+TEST(ChannelLayoutTest, DataTexturesAreLinear)
+{
+   const auto layout = resolve_texture_layout("texture/mask.png", "r", "srgb", false);
+   EXPECT_EQ(layout.channels, ChannelLayout::R);
+   EXPECT_EQ(layout.colorSpace, ColorSpace::Linear);
+}
+
+TEST(ChannelLayoutTest, UncompressedFormatOfCompressedData)
+{
+   EXPECT_EQ(triglav::ktx::uncompressed_format(triglav::ktx::texture_layout(Format::BC4_UNorm)), Format::R8_UNorm);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(triglav::ktx::texture_layout(Format::BC5_UNorm)), Format::RG8_UNorm);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(triglav::ktx::texture_layout(Format::BC1_RGB_sRGB)), Format::RGBA8_sRGB);
+   EXPECT_EQ(triglav::ktx::uncompressed_format(triglav::ktx::texture_layout(Format::BC7_UNorm)), Format::RGBA8_UNorm);
+}
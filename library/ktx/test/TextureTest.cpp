@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "triglav/ktx/BlockCompression.h"
+#include "triglav/ktx/Texture.h"
+
+#include <algorithm>
+#include <cstring>
+
+using triglav::u32;
+using triglav::u8;
+using triglav::ktx::Format;
+using triglav::ktx::Status;
+
+namespace {
+
+triglav::ktx::Texture make_texture(const Format format, const u32 width, const u32 height)
+{
+   triglav::ktx::Texture result{
+      .format = format,
+      .width = width,
+      .height = height,
+   };
+
+   for (u32 mipLevel = 0; (width >> mipLevel) > 0 || (height >> mipLevel) > 0; ++mipLevel) {
+      auto& level = result.levels.emplace_back(triglav::ktx::image_size(format, result.mip_width(mipLevel), result.mip_height(mipLevel)));
+      for (std::size_t i = 0; i < level.size(); ++i) {
+         level[i] = static_cast<u8>(i + mipLevel);
+      }
+   }
+
+   return result;
+}
+
+}// namespace
+
+TEST(TextureTest, RoundTrip)
+{
+   const auto texture = make_texture(Format::BC7_sRGB, 64, 16);
+   ASSERT_EQ(texture.levels.size(), 7);
+
+   const auto data = triglav::ktx::write_ktx2(texture);
+   const auto result = triglav::ktx::read_ktx2(data);
+   ASSERT_TRUE(result.has_value());
+
+   EXPECT_EQ(result->format, Format::BC7_sRGB);
+   EXPECT_EQ(result->width, 64);
+   EXPECT_EQ(result->height, 16);
+   EXPECT_EQ(result->levels, texture.levels);
+   EXPECT_EQ(result->total_size(), texture.total_size());
+}
+
+TEST(TextureTest, LevelsAreAligned)
+{
+   const auto texture = make_texture(Format::BC1_RGB_UNorm, 16, 16);
+   const auto data = triglav::ktx::write_ktx2(texture);
+
+   for (u32 mipLevel = 0; mipLevel < texture.levels.size(); ++mipLevel) {
+      triglav::u64 offset{};
+      std::memcpy(&offset, data.data() + 80 + 24 * mipLevel, sizeof(offset));
+      EXPECT_EQ(offset % 8, 0);
+   }
+}
+
+TEST(TextureTest, InvalidData)
+{
+   const auto data = triglav::ktx::write_ktx2(make_texture(Format::BC5_UNorm, 8, 8));
+
+   auto corrupted = data;
+   corrupted[1] = 'X';
+   EXPECT_EQ(triglav::ktx::read_ktx2(corrupted).error(), Status::InvalidIdentifier);
+
+   const std::span truncated{data.data(), data.size() - 1};
+   EXPECT_EQ(triglav::ktx::read_ktx2(truncated).error(), Status::TruncatedData);
+
+   auto unsupported = data;
+   unsupported[12] = 1;
+   EXPECT_EQ(triglav::ktx::read_ktx2(unsupported).error(), Status::UnsupportedFormat);
+}
+
+TEST(TextureTest, HeaderOnly)
+{
+   const auto texture = make_texture(Format::BC4_UNorm, 32, 32);
+   const auto data = triglav::ktx::write_ktx2(texture);
+
+   const std::span prefix{data.data(), std::min(data.size(), triglav::ktx::g_maxHeaderSize)};
+   const auto header = triglav::ktx::read_ktx2_header(prefix, data.size());
+   ASSERT_TRUE(header.has_value());
+   EXPECT_EQ(header->format, Format::BC4_UNorm);
+   ASSERT_EQ(header->levels.size(), texture.levels.size());
+
+   for (std::size_t mipLevel = 0; mipLevel < texture.levels.size(); ++mipLevel) {
+      const auto& range = header->levels[mipLevel];
+      ASSERT_EQ(range.size, texture.levels[mipLevel].size());
+      EXPECT_TRUE(std::equal(texture.levels[mipLevel].begin(), texture.levels[mipLevel].end(), data.begin() + range.offset));
+   }
+
+   // Smaller levels come first, so the levels from any mip to the last one form a single range.
+   EXPECT_LT(header->levels[1].offset, header->levels[0].offset);
+
+   EXPECT_EQ(triglav::ktx::read_ktx2_header(prefix, data.size() - 1).error(), Status::TruncatedData);
+}
+
+TEST(TextureTest, CookedPath)
+{
+   EXPECT_EQ(triglav::ktx::cooked_texture_path("texture/brick_albedo.png"), "texture/brick_albedo.ktx2");
+   EXPECT_EQ(triglav::ktx::cooked_texture_path("texture.dir/noise"), "texture.dir/noise.ktx2");
+}
@@ -92,6 +92,7 @@ class FrameResources
    void set_flag(Name flagName, bool isEnabled);
 
    void update_resolution(const graphics_api::Resolution& resolution);
+   void update_resolution(Name nodeName, const graphics_api::Resolution& resolution);
    void add_signal_semaphore(Name parent, Name child, graphics_api::Semaphore&& semaphore);
    void initialize_command_list(Name nodeName, graphics_api::SemaphoreArray&& waitSemaphores, graphics_api::CommandList&& commandList,
                                 size_t inFrameWaitSemaphoreCount);
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "triglav/Name.hpp"
+#include "triglav/ResourceHandle.hpp"
 #include "triglav/geometry/Mesh.h"
 #include "triglav/graphics_api/DescriptorArray.h"
 #include "triglav/graphics_api/HostVisibleBuffer.hpp"
@@ -29,15 +30,16 @@ struct Model
 
 struct ModelShaderMapProperties
 {
-   ResourceName modelName;
+   ModelHandle model;
    geometry::BoundingBox boundingBox;
    glm::mat4 modelMat;
-   graphics_api::UniformBuffer<ShadowMapUBO> ubo;
 };
 
 struct InstancedModel
 {
-   ResourceName modelName;
+   ModelHandle model;
+   // Material of each range of the model.
+   std::vector<MaterialHandle> materials;
    geometry::BoundingBox boundingBox;
    glm::vec3 position{};
    graphics_api::UniformBuffer<UniformBufferObject> ubo;
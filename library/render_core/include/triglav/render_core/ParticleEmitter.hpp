@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+namespace triglav::render_core {
+
+struct ParticleEmitter
+{
+   // Number of particles spawned per second.
+   float spawnRate{};
+   // Lifetime in seconds, varies by +/- lifetimeRandomness fraction of itself.
+   float lifetime{1.0f};
+   float lifetimeRandomness{};
+   // Particles spawn uniformly inside a box with the given half extent centered at the emitter.
+   glm::vec3 extent{};
+   glm::vec3 velocity{};
+   float velocityRandomness{};
+   float angularVelocity{};
+   float scale{1.0f};
+   float gravity{};
+};
+
+}// namespace triglav::render_core
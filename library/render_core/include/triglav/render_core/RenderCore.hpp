@@ -24,7 +24,7 @@ struct SpriteUBO
    glm::mat4 transform;
 };
 
-struct ShadowMapUBO
+struct ShadowMapPushConstants
 {
    alignas(16) glm::mat4 mvp;
 };
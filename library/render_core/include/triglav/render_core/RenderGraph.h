@@ -8,6 +8,7 @@
 
 #include <map>
 #include <memory>
+#include <span>
 #include <utility>
 
 namespace triglav::render_core {
@@ -39,6 +40,8 @@ class RenderGraph
    void record_command_lists();
    void set_flag(Name flag, bool isEnabled);
    void update_resolution(const graphics_api::Resolution& resolution);
+   // Updates the resolution of the given nodes only, the remaining nodes keep their current framebuffers.
+   void update_resolution(std::span<const Name> nodes, const graphics_api::Resolution& resolution);
    [[nodiscard]] graphics_api::Status execute();
    void await();
    [[nodiscard]] graphics_api::Semaphore& target_semaphore();
@@ -116,6 +116,14 @@ void FrameResources::update_resolution(const graphics_api::Resolution& resolutio
    }
 }
 
+void FrameResources::update_resolution(const Name nodeName, const graphics_api::Resolution& resolution)
+{
+   auto* frameNode = dynamic_cast<NodeFrameResources*>(m_nodes.at(nodeName).get());
+   if (frameNode != nullptr) {
+      frameNode->update_resolution(resolution);
+   }
+}
+
 void FrameResources::add_signal_semaphore(Name parent, Name child, graphics_api::Semaphore&& semaphore)
 {
    auto& node = m_nodes.at(parent);
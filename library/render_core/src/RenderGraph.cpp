@@ -158,6 +158,15 @@ void RenderGraph::update_resolution(const graphics_api::Resolution& resolution)
    }
 }
 
+void RenderGraph::update_resolution(const std::span<const Name> nodes, const graphics_api::Resolution& resolution)
+{
+   for (auto& frameRes : m_frameResources) {
+      for (const auto node : nodes) {
+         frameRes.update_resolution(node, resolution);
+      }
+   }
+}
+
 graphics_api::Status RenderGraph::execute()
 {
    for (const auto& name : m_nodeOrder) {
@@ -24,13 +24,15 @@ class AmbientOcclusionRenderer
    struct UniformData
    {
       glm::mat4 cameraProjection{};
+      glm::mat4 inverseCameraProjection{};
       AlignedVec3 samplesSSAO[g_SampleCountSSAO];
    };
 
    AmbientOcclusionRenderer(graphics_api::Device& device, graphics_api::RenderTarget& renderTarget,
                             resource::ResourceManager& resourceManager, const graphics_api::Texture& noiseTexture);
 
-   void draw(render_core::FrameResources& resources, graphics_api::CommandList& cmdList, const glm::mat4& cameraProjection) const;
+   void draw(graphics_api::CommandList& cmdList, const glm::mat4& cameraProjection, const graphics_api::Texture& depthTexture,
+             const graphics_api::Texture& normalTexture) const;
    static std::vector<AlignedVec3> generate_sample_points(size_t count);
 
  private:
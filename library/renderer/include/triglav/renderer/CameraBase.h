@@ -26,6 +26,8 @@ class CameraBase
    [[nodiscard]] const glm::mat4& view_projection_matrix() const;
    [[nodiscard]] bool is_point_visible(glm::vec3 point) const;
    [[nodiscard]] bool is_bounding_box_visible(const geometry::BoundingBox& boundingBox, const glm::mat4& modelMat) const;
+   // Fraction of the viewport covered by the projected bounding box, one if the box reaches behind the near plane.
+   [[nodiscard]] float screen_coverage(const geometry::BoundingBox& boundingBox, const glm::mat4& modelMat) const;
 
    [[nodiscard]] virtual const glm::mat4& projection_matrix() const = 0;
    [[nodiscard]] virtual float to_linear_depth(float depth) const = 0;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+#include "triglav/graphics_api/GraphicsApi.hpp"
+
+namespace triglav::renderer {
+
+struct DynamicResolutionSettings
+{
+   // GPU time budget of a frame in milliseconds.
+   float targetGpuTime{16.0f};
+   // Bounds of the render scale. The controller clamps them to a range from one step to the output resolution.
+   float minScale{0.5f};
+   float maxScale{1.0f};
+   // The applied scale is a multiple of the step, render targets are only recreated when it changes.
+   float scaleStep{0.05f};
+   float proportionalGain{0.15f};
+   float integralGain{0.02f};
+   float derivativeGain{0.05f};
+   // Relative GPU time error treated as zero. The band is wider below the budget, one scale step changes the GPU time
+   // by roughly 10% so a narrow band would make the applied scale alternate between the two steps around the budget.
+   float overBudgetTolerance{0.02f};
+   float underBudgetTolerance{0.12f};
+   // Fraction of a step the controller output needs to move away from the applied scale before it changes.
+   float hysteresis{0.75f};
+   // Weight of the newest sample in the smoothed GPU time.
+   float smoothing{0.2f};
+   // Minimum number of frames between two changes of the applied scale.
+   u32 cooldownFrames{30};
+};
+
+// Scales the render resolution to keep the measured GPU frame time within the budget.
+// A PID loop drives a continuous scale, the applied scale follows it in quantized steps with hysteresis.
+class DynamicResolutionController
+{
+ public:
+   explicit DynamicResolutionController(const DynamicResolutionSettings& settings);
+
+   // Feeds the GPU time of the last frame in milliseconds, returns true if the applied scale changed.
+   bool update(float gpuTime);
+   void reset();
+
+   [[nodiscard]] float render_scale() const;
+   [[nodiscard]] graphics_api::Resolution render_resolution(const graphics_api::Resolution& outputResolution) const;
+   [[nodiscard]] const DynamicResolutionSettings& settings() const;
+
+ private:
+   DynamicResolutionSettings m_settings;
+   float m_smoothedGpuTime{};
+   float m_integral{};
+   float m_previousError{};
+   float m_scale{};
+   float m_appliedScale{};
+   u32 m_framesSinceChange{};
+   bool m_hasSample{false};
+};
+
+}// namespace triglav::renderer
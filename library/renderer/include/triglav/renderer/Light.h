@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+namespace triglav::renderer {
+
+enum class LightType
+{
+   Point,
+   Spot,
+};
+
+struct Light
+{
+   LightType type{LightType::Point};
+   glm::vec3 position{};
+   // Only used by spot lights.
+   glm::vec3 direction{0.0f, 0.0f, 1.0f};
+   glm::vec3 color{1.0f};
+   float intensity{1.0f};
+   // Distance at which the light contribution fades out to zero.
+   float range{10.0f};
+   // Cone half-angles in radians, only used by spot lights.
+   float innerConeAngle{0.4f};
+   float outerConeAngle{0.5f};
+};
+
+}// namespace triglav::renderer
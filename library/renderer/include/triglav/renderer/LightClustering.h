@@ -0,0 +1,79 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace triglav::renderer {
+
+// Froxel grid dimensions, must match the shading shader.
+constexpr u32 g_lightClusterCountX = 16;
+constexpr u32 g_lightClusterCountY = 9;
+constexpr u32 g_lightClusterCountZ = 24;
+constexpr u32 g_lightClusterCount = g_lightClusterCountX * g_lightClusterCountY * g_lightClusterCountZ;
+
+struct LightCluster
+{
+   u32 offset;
+   u32 count;
+};
+
+struct LightClusterBounds
+{
+   glm::vec3 min;
+   glm::vec3 max;
+};
+
+// Assigns light bounding spheres to the view space clusters of a perspective frustum.
+// The frustum is split into a screen space grid of tiles and exponentially distributed depth slices.
+// Each cluster receives a list of indices of the lights that intersect its bounding box.
+class LightClustering
+{
+ public:
+   LightClustering();
+
+   // Recalculates the cluster bounds, does nothing if the parameters didn't change.
+   void update_projection(const glm::mat4& projection, float nearPlane, float farPlane);
+
+   // Each sphere is given in view space: xyz is the center, w is the radius.
+   void assign_lights(std::span<const glm::vec4> lightSpheres);
+
+   [[nodiscard]] std::span<const LightCluster> clusters() const;
+   [[nodiscard]] std::span<const u32> light_indices() const;
+   [[nodiscard]] LightClusterBounds cluster_bounds(u32 clusterIndex) const;
+
+   // Converts view depth to slice index: slice = log(depth) * scale + bias.
+   [[nodiscard]] float slice_scale() const;
+   [[nodiscard]] float slice_bias() const;
+
+   [[nodiscard]] static u32 cluster_index(u32 x, u32 y, u32 z);
+
+ private:
+   [[nodiscard]] u32 depth_to_slice(float depth) const;
+
+   glm::mat4 m_projection{};
+   float m_nearPlane{};
+   float m_farPlane{};
+   float m_sliceScale{};
+   float m_sliceBias{};
+
+   // Cluster bounds stored as structure of arrays, the intersection test loads four tiles at a time.
+   std::vector<float> m_minX;
+   std::vector<float> m_minY;
+   std::vector<float> m_minZ;
+   std::vector<float> m_maxX;
+   std::vector<float> m_maxY;
+   std::vector<float> m_maxZ;
+
+   std::vector<LightCluster> m_clusters;
+   std::vector<u32> m_lightIndices;
+   std::vector<std::pair<u32, u32>> m_clusterLightPairs;
+   std::vector<u8> m_sliceHits;
+};
+
+}// namespace triglav::renderer
@@ -2,8 +2,11 @@
 
 #include <map>
 #include <optional>
+#include <span>
+#include <vector>
 
 #include "triglav/Name.hpp"
+#include "triglav/ResourceHandle.hpp"
 #include "triglav/graphics_api/Buffer.h"
 #include "triglav/graphics_api/Pipeline.h"
 #include "triglav/graphics_api/RenderTarget.h"
@@ -13,25 +16,36 @@ namespace triglav::renderer {
 
 struct MaterialResources
 {
+   // Material the resources were built for, a material loaded into a reused slot has a different generation.
+   MaterialHandle material;
    MaterialTemplateName materialTemplate;
    std::optional<graphics_api::Buffer> uniformBuffer;
-   std::vector<TextureName> textures;
+   std::vector<TextureHandle> textures;
 };
 
 struct MaterialTemplateResources
 {
    graphics_api::Pipeline pipeline;
+   // Used when depth is already laid out by the depth pre-pass.
+   graphics_api::Pipeline depthEqualPipeline;
 };
 
+// Builds the pipelines of the material templates and the uniform buffers of the materials. Textures that are still loading
+// are replaced by placeholders, the materials using them are rebuilt once they are loaded.
 class MaterialManager
 {
  public:
    MaterialManager(graphics_api::Device& device, resource::ResourceManager& resourceManager, graphics_api::RenderTarget& renderTarget);
 
-   [[nodiscard]] const MaterialResources& material_resources(MaterialName name) const;
+   [[nodiscard]] const MaterialResources& material_resources(MaterialHandle handle) const;
    [[nodiscard]] const MaterialTemplateResources& material_template_resources(MaterialTemplateName name) const;
 
  private:
+   // Rebuilds the pipelines of the reloaded templates and the uniform buffers of the reloaded materials.
+   void on_reloaded_assets(std::span<const ResourceName> names);
+   // Builds the templates and materials loaded after the manager was created and swaps the placeholders of loaded textures.
+   void on_added_assets(std::span<const ResourceName> names);
+   void create_placeholder_textures();
    void process_material(MaterialName name, const render_core::Material& material);
    void process_material_template(MaterialTemplateName name, const render_core::MaterialTemplate& materialTemplate);
 
@@ -39,7 +53,12 @@ class MaterialManager
    resource::ResourceManager& m_resourceManager;
    graphics_api::RenderTarget& m_renderTarget;
    std::map<MaterialTemplateName, MaterialTemplateResources> m_templates;
-   std::map<MaterialName, MaterialResources> m_materials;
+   // Indexed by the slot of the material handle, the entry may still belong to an unloaded material.
+   std::vector<std::optional<MaterialResources>> m_materials;
+   // Materials drawn with a placeholder for the texture.
+   std::map<TextureName, std::vector<MaterialName>> m_placeholderMaterials;
+   resource::ResourceManager::OnReloadedAssetsDel::Sink<MaterialManager> m_onReloadedAssetsSink;
+   resource::ResourceManager::OnAddedAssetsDel::Sink<MaterialManager> m_onAddedAssetsSink;
 };
 
 }// namespace triglav::renderer
\ No newline at end of file
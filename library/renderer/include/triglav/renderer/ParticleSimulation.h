@@ -0,0 +1,59 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+
+#include <glm/vec4.hpp>
+#include <span>
+#include <vector>
+
+namespace triglav::renderer {
+
+namespace particles {
+
+// Particle types are defined once in GLSL and shared with the compute shaders.
+using namespace glm;
+using uint = u32;
+
+#include "particles/particle.glsl"
+
+}// namespace particles
+
+struct ParticleEmitterState
+{
+   particles::ParticleEmitter emitter;
+   // Number of particles spawned per second.
+   float spawnRate;
+   float spawnRemainder{};
+};
+
+// Advances the spawn rate accumulators and assigns each emitter a consecutive range of spawn indices.
+// Returns the total number of particles requested this frame.
+u32 schedule_particle_spawns(std::span<ParticleEmitterState> emitters, float deltaTime, u32 frameSeed);
+
+// CPU reference of the GPU particle simulation, runs the same update and spawn code as the compute shaders.
+// Particles live in a fixed pool, the alive and dead lists hold pool slots and together always cover the whole pool.
+// The dead list is a stack, expired slots are pushed on top and spawns take slots from the top.
+class ParticleSimulation
+{
+ public:
+   explicit ParticleSimulation(u32 capacity);
+
+   // Emitters need their spawn ranges assigned by schedule_particle_spawns.
+   void update(std::span<const ParticleEmitterState> emitters, float deltaTime);
+
+   [[nodiscard]] u32 capacity() const;
+   [[nodiscard]] const particles::Particle& particle(u32 slot) const;
+   [[nodiscard]] std::span<const u32> alive_slots() const;
+   [[nodiscard]] std::span<const u32> dead_slots() const;
+
+ private:
+   void simulate(float deltaTime);
+   void emit(std::span<const ParticleEmitterState> emitters);
+
+   std::vector<particles::Particle> m_particles;
+   std::vector<u32> m_alive;
+   std::vector<u32> m_dead;
+   std::vector<u32> m_nextAlive;
+};
+
+}// namespace triglav::renderer
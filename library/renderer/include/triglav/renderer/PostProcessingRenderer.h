@@ -17,6 +17,7 @@ class PostProcessingRenderer
       int enableFXAA{};
       int hideUI{};
       int bloomEnabled{};
+      int upscale{};
    };
 
    PostProcessingRenderer(graphics_api::Device& device, graphics_api::RenderTarget& renderTarget,
@@ -2,6 +2,7 @@
 
 #include "AmbientOcclusionRenderer.h"
 #include "DebugLinesRenderer.h"
+#include "DynamicResolution.h"
 #include "GlyphCache.h"
 #include "GroundRenderer.h"
 #include "InfoDialog.h"
@@ -61,6 +62,8 @@ class Renderer
  private:
    void recreate_swapchain(uint32_t width, uint32_t height);
    void update_uniform_data(float deltaTime);
+   void update_dynamic_resolution();
+   void apply_render_resolution();
    static float calculate_frame_duration();
    glm::vec3 moving_direction();
 
@@ -68,8 +71,13 @@ class Renderer
    bool m_ssaoEnabled{true};
    bool m_fxaaEnabled{true};
    bool m_bloomEnabled{true};
+   bool m_bloomHighQuality{true};
    bool m_hideUI{false};
    bool m_smoothCamera{true};
+   bool m_depthPrepassEnabled{false};
+   // Divides the SSAO resolution, either 1, 2 or 4.
+   u32 m_ssaoResolutionDivisor{1};
+   bool m_dynamicResolutionEnabled{false};
    glm::vec3 m_position{};
    glm::vec3 m_motion{};
    glm::vec2 m_mouseOffset{};
@@ -82,6 +90,9 @@ class Renderer
    resource::ResourceManager& m_resourceManager;
    Scene m_scene;
    graphics_api::Resolution m_resolution;
+   // Resolution of the geometry, ambient occlusion and shading passes, upscaled to the output resolution in post processing.
+   graphics_api::Resolution m_renderResolution;
+   DynamicResolutionController m_dynamicResolution;
    graphics_api::Swapchain m_swapchain;
    graphics_api::RenderTarget m_renderTarget;
    std::vector<graphics_api::Framebuffer> m_framebuffers;
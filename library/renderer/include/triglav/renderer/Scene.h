@@ -2,17 +2,24 @@
 
 #include "Camera.h"
 #include "DebugLinesRenderer.h"
+#include "Light.h"
 #include "OrthoCamera.h"
 
 #include "triglav/Delegate.hpp"
+#include "triglav/Int.hpp"
 #include "triglav/Name.hpp"
 #include "triglav/render_core/Model.hpp"
 
+#include <array>
 #include <glm/gtc/quaternion.hpp>
+#include <span>
 #include <vector>
 
 namespace triglav::renderer {
 
+// Number of shadow map cascades, must match the shading shader.
+constexpr u32 g_shadowCascadeCount = 3;
+
 class ModelRenderer;
 class Renderer;
 
@@ -26,6 +33,12 @@ struct SceneObject
    [[nodiscard]] glm::mat4 model_matrix() const;
 };
 
+struct SceneParticleEmitter
+{
+   ParticleEmitterName emitter;
+   glm::vec3 position;
+};
+
 class Scene
 {
  public:
@@ -39,12 +52,21 @@ class Scene
 
    void update(graphics_api::Resolution& resolution);
    void add_object(SceneObject object);
+   void add_light(const Light& light);
+   void add_particle_emitter(const SceneParticleEmitter& emitter);
    void load_level(LevelName name);
    void set_camera(glm::vec3 position, glm::quat orientation);
 
    [[nodiscard]] const Camera& camera() const;
    [[nodiscard]] Camera& camera();
    [[nodiscard]] const OrthoCamera& shadow_map_camera() const;
+   [[nodiscard]] const OrthoCamera& shadow_cascade_camera(u32 index) const;
+   [[nodiscard]] float shadow_cascade_split(u32 index) const;
+   [[nodiscard]] std::span<const Light> lights() const;
+   [[nodiscard]] std::span<const SceneParticleEmitter> particle_emitters() const;
+
+   void set_shadow_distance(float distance);
+   void set_shadow_cascade_split_lambda(float lambda);
 
    [[nodiscard]] float yaw() const;
    [[nodiscard]] float pitch() const;
@@ -52,14 +74,22 @@ class Scene
    void update_orientation(float delta_yaw, float delta_pitch);
 
  private:
+   void update_shadow_cascades();
+
    resource::ResourceManager& m_resourceManager;
    float m_yaw{};
    float m_pitch{};
 
    OrthoCamera m_shadowMapCamera{};
    Camera m_camera{};
+   float m_shadowDistance{100.0f};
+   float m_shadowCascadeSplitLambda{0.75f};
+   std::array<OrthoCamera, g_shadowCascadeCount> m_shadowCascadeCameras{};
+   std::array<float, g_shadowCascadeCount> m_shadowCascadeSplits{};
 
    std::vector<SceneObject> m_objects{};
+   std::vector<Light> m_lights{};
+   std::vector<SceneParticleEmitter> m_particleEmitters{};
 };
 
 }// namespace triglav::renderer
\ No newline at end of file
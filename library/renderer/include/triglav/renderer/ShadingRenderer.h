@@ -7,11 +7,36 @@
 #include "triglav/render_core/FrameResources.h"
 #include "triglav/resource/ResourceManager.h"
 
+#include "LightClustering.h"
+#include "Scene.h"
+
+#include <array>
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
 namespace triglav::renderer {
 
+// Maximum number of lights and cluster light references uploaded to the shading pass.
+constexpr u32 g_maxClusteredLights = 4096;
+constexpr u32 g_maxClusterLightIndices = 64 * g_lightClusterCount;
+
+// Light layout shared with the shading shader, positions and directions are in view space.
+struct ClusteredLight
+{
+   // xyz - position, w - range.
+   glm::vec4 positionRange;
+   // rgb - color multiplied by intensity, a - spot attenuation offset.
+   glm::vec4 colorSpotOffset;
+   // xyz - direction, w - spot attenuation scale.
+   glm::vec4 directionSpotScale;
+};
+
+using ClusteredLightBuffer =
+   graphics_api::HostVisibleBuffer<graphics_api::BufferUsage::StorageBuffer, std::array<ClusteredLight, g_maxClusteredLights>>;
+using LightClusterBuffer =
+   graphics_api::HostVisibleBuffer<graphics_api::BufferUsage::StorageBuffer, std::array<LightCluster, g_lightClusterCount>>;
+using LightIndexBuffer = graphics_api::HostVisibleBuffer<graphics_api::BufferUsage::StorageBuffer, std::array<u32, g_maxClusterLightIndices>>;
+
 class ShadingRenderer
 {
  public:
@@ -19,17 +44,31 @@ class ShadingRenderer
    {
       alignas(16) glm::vec3 lightPosition{};
       int enableSSAO{1};
+      // Reduced resolution occlusion is already blurred and upsampled.
+      int blurSSAO{1};
    };
 
    struct UniformData
    {
-      glm::mat4 shadowMapMat;
+      glm::mat4 inverseProjection;
+      std::array<glm::mat4, g_shadowCascadeCount> shadowMapMats;
+      // View space far distance of each cascade.
+      glm::vec4 cascadeSplits;
+      // x - slice scale, y - slice bias, converts log of view depth to the cluster slice.
+      glm::vec4 clusterDepthParams;
+   };
+
+   struct ClusteredLightBuffers
+   {
+      const graphics_api::Buffer& lights;
+      const graphics_api::Buffer& clusters;
+      const graphics_api::Buffer& lightIndices;
    };
 
    ShadingRenderer(graphics_api::Device& device, graphics_api::RenderTarget& renderTarget, resource::ResourceManager& resourceManager);
 
    void draw(render_core::FrameResources& resources, graphics_api::CommandList& cmdList, const glm::vec3& lightPosition,
-             const glm::mat4& shadowMapMat) const;
+             const UniformData& uniformData, const ClusteredLightBuffers& lightBuffers) const;
 
  private:
    graphics_api::Device& m_device;
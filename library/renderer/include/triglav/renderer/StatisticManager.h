@@ -29,6 +29,9 @@ enum class Stat : u32
    FramesPerSecond,
    GBufferGpuTime,
    ShadingGpuTime,
+   ShadowMapGpuTime,
+   AmbientOcclusionGpuTime,
+   BloomGpuTime,
    Count
 };
 
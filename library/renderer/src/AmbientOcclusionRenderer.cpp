@@ -1,6 +1,7 @@
 #include "AmbientOcclusionRenderer.h"
 
 #include <cstring>
+#include <glm/matrix.hpp>
 #include <random>
 
 #include "triglav/graphics_api/CommandList.h"
@@ -38,17 +39,16 @@ AmbientOcclusionRenderer::AmbientOcclusionRenderer(graphics_api::Device& device,
    std::memcpy(&m_uniformBuffer->samplesSSAO, m_samplesSSAO.data(), m_samplesSSAO.size() * sizeof(AlignedVec3));
 }
 
-void AmbientOcclusionRenderer::draw(render_core::FrameResources& resources, graphics_api::CommandList& cmdList,
-                                    const glm::mat4& cameraProjection) const
+void AmbientOcclusionRenderer::draw(graphics_api::CommandList& cmdList, const glm::mat4& cameraProjection,
+                                    const graphics_api::Texture& depthTexture, const graphics_api::Texture& normalTexture) const
 {
    m_uniformBuffer->cameraProjection = cameraProjection;
+   m_uniformBuffer->inverseCameraProjection = glm::inverse(cameraProjection);
 
    cmdList.bind_pipeline(m_pipeline);
 
-   auto& gbuffer = resources.node<render_core::NodeFrameResources>("geometry"_name).framebuffer("gbuffer"_name);
-
-   cmdList.bind_texture(0, gbuffer.texture("position"_name));
-   cmdList.bind_texture(1, gbuffer.texture("normal"_name));
+   cmdList.bind_texture(0, depthTexture);
+   cmdList.bind_texture(1, normalTexture);
    cmdList.bind_texture(2, m_noiseTexture);
    cmdList.bind_uniform_buffer(3, m_uniformBuffer);
 
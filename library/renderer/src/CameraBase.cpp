@@ -1,5 +1,7 @@
 #include "CameraBase.h"
 
+#include <glm/common.hpp>
+
 namespace triglav::renderer {
 
 void CameraBase::set_position(const glm::vec3 position)
@@ -128,6 +130,37 @@ bool CameraBase::is_bounding_box_visible(const geometry::BoundingBox& boundingBo
    return min.x <= 1.0f && max.x >= -1.0f && min.y <= 1.0f && max.y >= -1.0f && min.z <= 1.0f && max.z >= 0.0f;
 }
 
+float CameraBase::screen_coverage(const geometry::BoundingBox& boundingBox, const glm::mat4& modelMat) const
+{
+   const auto mat = this->view_projection_matrix() * modelMat;
+
+   glm::vec2 min{std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+   glm::vec2 max{-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+
+   for (u32 corner = 0; corner < 8; ++corner) {
+      const glm::vec3 point{
+         (corner & 1) ? boundingBox.max.x : boundingBox.min.x,
+         (corner & 2) ? boundingBox.max.y : boundingBox.min.y,
+         (corner & 4) ? boundingBox.max.z : boundingBox.min.z,
+      };
+      const auto projectedPoint = mat * glm::vec4(point, 1.0f);
+
+      // The projection of a box crossing the near plane is unbounded, the camera is close enough to need all the detail.
+      if (projectedPoint.w < m_nearPlane)
+         return 1.0f;
+
+      const glm::vec2 ndcPoint{projectedPoint.x / projectedPoint.w, projectedPoint.y / projectedPoint.w};
+      min = glm::min(min, ndcPoint);
+      max = glm::max(max, ndcPoint);
+   }
+
+   min = glm::clamp(min, glm::vec2{-1.0f}, glm::vec2{1.0f});
+   max = glm::clamp(max, glm::vec2{-1.0f}, glm::vec2{1.0f});
+
+   // The viewport spans two units in both directions.
+   return (max.x - min.x) * (max.y - min.y) / 4.0f;
+}
+
 const glm::mat4& CameraBase::view_matrix() const
 {
    if (not m_hasCachedViewMatrix) {
@@ -0,0 +1,106 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace triglav::renderer {
+
+namespace {
+
+DynamicResolutionSettings clamp_scale_bounds(DynamicResolutionSettings settings)
+{
+   settings.minScale = std::clamp(settings.minScale, settings.scaleStep, 1.0f);
+   settings.maxScale = std::clamp(settings.maxScale, settings.minScale, 1.0f);
+   return settings;
+}
+
+}// namespace
+
+DynamicResolutionController::DynamicResolutionController(const DynamicResolutionSettings& settings) :
+    m_settings(clamp_scale_bounds(settings)),
+    m_scale(m_settings.maxScale),
+    m_appliedScale(m_settings.maxScale),
+    m_framesSinceChange(m_settings.cooldownFrames)
+{
+}
+
+bool DynamicResolutionController::update(const float gpuTime)
+{
+   m_smoothedGpuTime = m_hasSample ? m_smoothedGpuTime + m_settings.smoothing * (gpuTime - m_smoothedGpuTime) : gpuTime;
+
+   // Positive error means there is headroom left in the budget.
+   auto error = (m_settings.targetGpuTime - m_smoothedGpuTime) / m_settings.targetGpuTime;
+   if (error > -m_settings.overBudgetTolerance && error < m_settings.underBudgetTolerance) {
+      error = 0.0f;
+   }
+
+   const auto derivative = m_hasSample ? error - m_previousError : 0.0f;
+   m_previousError = error;
+   m_hasSample = true;
+
+   // The controller is at rest at the maximum scale, the integral only pulls the scale down from there.
+   const auto pid_output = [&](const float integralValue) {
+      return m_settings.maxScale + m_settings.proportionalGain * error + m_settings.integralGain * integralValue +
+             m_settings.derivativeGain * derivative;
+   };
+
+   const auto integral = m_integral + error;
+   const auto output = pid_output(integral);
+
+   // Anti-windup, stop integrating while the output is saturated in the direction of the error.
+   const auto saturatedHigh = output >= m_settings.maxScale && error > 0.0f;
+   const auto saturatedLow = output <= m_settings.minScale && error < 0.0f;
+   if (not saturatedHigh && not saturatedLow) {
+      m_integral = integral;
+   }
+
+   m_scale = std::clamp(pid_output(m_integral), m_settings.minScale, m_settings.maxScale);
+
+   if (m_framesSinceChange < m_settings.cooldownFrames) {
+      ++m_framesSinceChange;
+      return false;
+   }
+
+   if (std::abs(m_scale - m_appliedScale) <= m_settings.hysteresis * m_settings.scaleStep)
+      return false;
+
+   const auto quantizedScale = std::round(m_scale / m_settings.scaleStep) * m_settings.scaleStep;
+   const auto newScale = std::clamp(quantizedScale, m_settings.minScale, m_settings.maxScale);
+   if (newScale == m_appliedScale)
+      return false;
+
+   m_appliedScale = newScale;
+   m_framesSinceChange = 0;
+   return true;
+}
+
+void DynamicResolutionController::reset()
+{
+   m_smoothedGpuTime = 0.0f;
+   m_integral = 0.0f;
+   m_previousError = 0.0f;
+   m_scale = m_settings.maxScale;
+   m_appliedScale = m_settings.maxScale;
+   m_framesSinceChange = m_settings.cooldownFrames;
+   m_hasSample = false;
+}
+
+float DynamicResolutionController::render_scale() const
+{
+   return m_appliedScale;
+}
+
+graphics_api::Resolution DynamicResolutionController::render_resolution(const graphics_api::Resolution& outputResolution) const
+{
+   const auto scale_dimension = [this](const u32 dimension) {
+      return std::max(static_cast<u32>(std::lround(static_cast<float>(dimension) * m_appliedScale)), 1u);
+   };
+   return {scale_dimension(outputResolution.width), scale_dimension(outputResolution.height)};
+}
+
+const DynamicResolutionSettings& DynamicResolutionController::settings() const
+{
+   return m_settings;
+}
+
+}// namespace triglav::renderer
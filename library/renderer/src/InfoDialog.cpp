@@ -22,6 +22,13 @@ constexpr std::array g_metricsLabels{
    std::tuple{"info_dialog/metrics/gbuffer_gpu_time"_name, "info_dialog/metrics/gbuffer_gpu_time/value"_name, "GBuffer Render Time"sv},
    std::tuple{"info_dialog/metrics/shading_triangles"_name, "info_dialog/metrics/shading_triangles/value"_name, "Shading Triangles"sv},
    std::tuple{"info_dialog/metrics/shading_gpu_time"_name, "info_dialog/metrics/shading_gpu_time/value"_name, "Shading Render Time"sv},
+   std::tuple{"info_dialog/metrics/shadow_map_gpu_time"_name, "info_dialog/metrics/shadow_map_gpu_time/value"_name,
+              "Shadow Map Render Time"sv},
+   std::tuple{"info_dialog/metrics/ao_gpu_time"_name, "info_dialog/metrics/ao_gpu_time/value"_name, "AO Render Time"sv},
+   std::tuple{"info_dialog/metrics/bloom_gpu_time"_name, "info_dialog/metrics/bloom_gpu_time/value"_name, "Bloom Render Time"sv},
+   std::tuple{"info_dialog/metrics/gbuffer_bandwidth"_name, "info_dialog/metrics/gbuffer_bandwidth/value"_name, "GBuffer Bandwidth"sv},
+   std::tuple{"info_dialog/metrics/render_resolution"_name, "info_dialog/metrics/render_resolution/value"_name, "Render Resolution"sv},
+   std::tuple{"info_dialog/metrics/texture_memory"_name, "info_dialog/metrics/texture_memory/value"_name, "Texture Memory"sv},
 };
 
 constexpr std::array g_locationLabels{
@@ -33,8 +40,13 @@ constexpr std::array g_featureLabels{
    std::tuple{"info_dialog/features/ao"_name, "info_dialog/features/ao/value"_name, "Ambient Occlusion"sv},
    std::tuple{"info_dialog/features/aa"_name, "info_dialog/features/aa/value"_name, "Anti-Aliasing"sv},
    std::tuple{"info_dialog/features/bloom"_name, "info_dialog/features/bloom/value"_name, "Bloom"sv},
+   std::tuple{"info_dialog/features/bloom_quality"_name, "info_dialog/features/bloom_quality/value"_name, "Bloom Quality"sv},
    std::tuple{"info_dialog/features/debug_lines"_name, "info_dialog/features/debug_lines/value"_name, "Debug Lines"sv},
    std::tuple{"info_dialog/features/smooth_camera"_name, "info_dialog/features/smooth_camera/value"_name, "Smooth Camera"sv},
+   std::tuple{"info_dialog/features/depth_prepass"_name, "info_dialog/features/depth_prepass/value"_name, "Depth Pre-pass"sv},
+   std::tuple{"info_dialog/features/ao_resolution"_name, "info_dialog/features/ao_resolution/value"_name, "AO Resolution"sv},
+   std::tuple{"info_dialog/features/dynamic_resolution"_name, "info_dialog/features/dynamic_resolution/value"_name,
+              "Dynamic Resolution"sv},
 };
 
 constexpr std::array g_labelGroups{
@@ -52,7 +64,7 @@ InfoDialog::InfoDialog(ui_core::Viewport& viewport, resource::ResourceManager& r
 
 void InfoDialog::initialize()
 {
-   m_viewport.add_rectangle("info_dialog/bg"_name, ui_core::Rectangle{.rect{5.0f, 5.0f, 380.0f, 600.0f}});
+   m_viewport.add_rectangle("info_dialog/bg"_name, ui_core::Rectangle{.rect{5.0f, 5.0f, 380.0f, 885.0f}});
 
    m_position = {g_leftOffset, g_topOffset};
 
@@ -0,0 +1,221 @@
+#include "LightClustering.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TG_LIGHT_CLUSTERING_SSE2
+#endif
+
+namespace triglav::renderer {
+
+constexpr u32 g_lightClusterTileCount = g_lightClusterCountX * g_lightClusterCountY;
+
+namespace {
+
+struct SliceBounds
+{
+   const float* minX;
+   const float* minY;
+   const float* minZ;
+   const float* maxX;
+   const float* maxY;
+   const float* maxZ;
+};
+
+#ifdef TG_LIGHT_CLUSTERING_SSE2
+
+static_assert(g_lightClusterTileCount % 4 == 0);
+
+// Sphere against box test of four tiles at a time, debug builds don't vectorize the scalar loop.
+void test_slice_tiles(const SliceBounds& bounds, const glm::vec4& sphere, u8* hits)
+{
+   const auto zero = _mm_setzero_ps();
+   const auto centerX = _mm_set1_ps(sphere.x);
+   const auto centerY = _mm_set1_ps(sphere.y);
+   const auto centerZ = _mm_set1_ps(sphere.z);
+   const auto radiusSq = _mm_set1_ps(sphere.w * sphere.w);
+
+   for (u32 tile = 0; tile < g_lightClusterTileCount; tile += 4) {
+      const auto dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(bounds.minX + tile), centerX), zero),
+                                 _mm_max_ps(_mm_sub_ps(centerX, _mm_loadu_ps(bounds.maxX + tile)), zero));
+      const auto dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(bounds.minY + tile), centerY), zero),
+                                 _mm_max_ps(_mm_sub_ps(centerY, _mm_loadu_ps(bounds.maxY + tile)), zero));
+      const auto dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(bounds.minZ + tile), centerZ), zero),
+                                 _mm_max_ps(_mm_sub_ps(centerZ, _mm_loadu_ps(bounds.maxZ + tile)), zero));
+      const auto distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+      const auto mask = _mm_movemask_ps(_mm_cmple_ps(distanceSq, radiusSq));
+
+      hits[tile] = static_cast<u8>(mask & 1);
+      hits[tile + 1] = static_cast<u8>((mask >> 1) & 1);
+      hits[tile + 2] = static_cast<u8>((mask >> 2) & 1);
+      hits[tile + 3] = static_cast<u8>((mask >> 3) & 1);
+   }
+}
+
+#else
+
+void test_slice_tiles(const SliceBounds& bounds, const glm::vec4& sphere, u8* hits)
+{
+   const auto radiusSq = sphere.w * sphere.w;
+   for (u32 tile = 0; tile < g_lightClusterTileCount; ++tile) {
+      const auto dx = std::max(bounds.minX[tile] - sphere.x, 0.0f) + std::max(sphere.x - bounds.maxX[tile], 0.0f);
+      const auto dy = std::max(bounds.minY[tile] - sphere.y, 0.0f) + std::max(sphere.y - bounds.maxY[tile], 0.0f);
+      const auto dz = std::max(bounds.minZ[tile] - sphere.z, 0.0f) + std::max(sphere.z - bounds.maxZ[tile], 0.0f);
+      hits[tile] = (dx * dx + dy * dy + dz * dz) <= radiusSq;
+   }
+}
+
+#endif
+
+}// namespace
+
+LightClustering::LightClustering() :
+    m_minX(g_lightClusterCount),
+    m_minY(g_lightClusterCount),
+    m_minZ(g_lightClusterCount),
+    m_maxX(g_lightClusterCount),
+    m_maxY(g_lightClusterCount),
+    m_maxZ(g_lightClusterCount),
+    m_clusters(g_lightClusterCount),
+    m_sliceHits(g_lightClusterTileCount)
+{
+}
+
+void LightClustering::update_projection(const glm::mat4& projection, const float nearPlane, const float farPlane)
+{
+   if (m_projection == projection && m_nearPlane == nearPlane && m_farPlane == farPlane)
+      return;
+
+   m_projection = projection;
+   m_nearPlane = nearPlane;
+   m_farPlane = farPlane;
+
+   const auto depthRatioLog = std::log(farPlane / nearPlane);
+   m_sliceScale = static_cast<float>(g_lightClusterCountZ) / depthRatioLog;
+   m_sliceBias = -static_cast<float>(g_lightClusterCountZ) * std::log(nearPlane) / depthRatioLog;
+
+   // View space coordinate at depth d of an NDC coordinate is ndc * d / projection scale.
+   const auto invScaleX = 1.0f / projection[0][0];
+   const auto invScaleY = 1.0f / projection[1][1];
+
+   for (u32 z = 0; z < g_lightClusterCountZ; ++z) {
+      const auto sliceNear = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / g_lightClusterCountZ);
+      const auto sliceFar = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z + 1) / g_lightClusterCountZ);
+
+      for (u32 y = 0; y < g_lightClusterCountY; ++y) {
+         const auto ndcMinY = 2.0f * static_cast<float>(y) / g_lightClusterCountY - 1.0f;
+         const auto ndcMaxY = 2.0f * static_cast<float>(y + 1) / g_lightClusterCountY - 1.0f;
+
+         for (u32 x = 0; x < g_lightClusterCountX; ++x) {
+            const auto ndcMinX = 2.0f * static_cast<float>(x) / g_lightClusterCountX - 1.0f;
+            const auto ndcMaxX = 2.0f * static_cast<float>(x + 1) / g_lightClusterCountX - 1.0f;
+
+            const auto index = cluster_index(x, y, z);
+            m_minX[index] = std::min({ndcMinX * sliceNear, ndcMinX * sliceFar}) * invScaleX;
+            m_maxX[index] = std::max({ndcMaxX * sliceNear, ndcMaxX * sliceFar}) * invScaleX;
+            m_minY[index] = std::min({ndcMinY * sliceNear, ndcMinY * sliceFar}) * invScaleY;
+            m_maxY[index] = std::max({ndcMaxY * sliceNear, ndcMaxY * sliceFar}) * invScaleY;
+            m_minZ[index] = -sliceFar;
+            m_maxZ[index] = -sliceNear;
+         }
+      }
+   }
+}
+
+void LightClustering::assign_lights(const std::span<const glm::vec4> lightSpheres)
+{
+   m_clusterLightPairs.clear();
+
+   for (u32 lightIndex = 0; lightIndex < lightSpheres.size(); ++lightIndex) {
+      const auto& sphere = lightSpheres[lightIndex];
+      const auto depth = -sphere.z;
+      if (depth + sphere.w < m_nearPlane || depth - sphere.w > m_farPlane)
+         continue;
+
+      // Widen the slice range by one on each side, the box test below decides the exact overlap.
+      const auto firstSlice = this->depth_to_slice(depth - sphere.w);
+      const auto lastSlice = this->depth_to_slice(depth + sphere.w);
+
+      for (u32 slice = firstSlice > 0 ? firstSlice - 1 : 0; slice <= std::min(lastSlice + 1, g_lightClusterCountZ - 1); ++slice) {
+         const auto sliceOffset = slice * g_lightClusterTileCount;
+
+         // Branch free sphere against box test over the whole slice.
+         const SliceBounds bounds{
+            .minX = m_minX.data() + sliceOffset,
+            .minY = m_minY.data() + sliceOffset,
+            .minZ = m_minZ.data() + sliceOffset,
+            .maxX = m_maxX.data() + sliceOffset,
+            .maxY = m_maxY.data() + sliceOffset,
+            .maxZ = m_maxZ.data() + sliceOffset,
+         };
+         test_slice_tiles(bounds, sphere, m_sliceHits.data());
+
+         for (u32 tile = 0; tile < g_lightClusterTileCount; ++tile) {
+            if (m_sliceHits[tile]) {
+               m_clusterLightPairs.emplace_back(sliceOffset + tile, lightIndex);
+            }
+         }
+      }
+   }
+
+   // Counting sort of the pairs by cluster, light indices stay in ascending order within a cluster.
+   std::ranges::fill(m_clusters, LightCluster{0, 0});
+   for (const auto& [cluster, light] : m_clusterLightPairs) {
+      ++m_clusters[cluster].count;
+   }
+
+   u32 offset = 0;
+   for (auto& cluster : m_clusters) {
+      offset += cluster.count;
+      cluster.offset = offset;
+   }
+
+   m_lightIndices.resize(offset);
+   for (auto it = m_clusterLightPairs.rbegin(); it != m_clusterLightPairs.rend(); ++it) {
+      m_lightIndices[--m_clusters[it->first].offset] = it->second;
+   }
+}
+
+std::span<const LightCluster> LightClustering::clusters() const
+{
+   return m_clusters;
+}
+
+std::span<const u32> LightClustering::light_indices() const
+{
+   return m_lightIndices;
+}
+
+LightClusterBounds LightClustering::cluster_bounds(const u32 clusterIndex) const
+{
+   return LightClusterBounds{
+      .min{m_minX[clusterIndex], m_minY[clusterIndex], m_minZ[clusterIndex]},
+      .max{m_maxX[clusterIndex], m_maxY[clusterIndex], m_maxZ[clusterIndex]},
+   };
+}
+
+float LightClustering::slice_scale() const
+{
+   return m_sliceScale;
+}
+
+float LightClustering::slice_bias() const
+{
+   return m_sliceBias;
+}
+
+u32 LightClustering::cluster_index(const u32 x, const u32 y, const u32 z)
+{
+   return z * g_lightClusterTileCount + y * g_lightClusterCountX + x;
+}
+
+u32 LightClustering::depth_to_slice(const float depth) const
+{
+   const auto clampedDepth = std::clamp(depth, m_nearPlane, m_farPlane);
+   const auto slice = std::floor(std::log(clampedDepth) * m_sliceScale + m_sliceBias);
+   return std::clamp(static_cast<u32>(std::max(slice, 0.0f)), 0u, g_lightClusterCountZ - 1);
+}
+
+}// namespace triglav::renderer
@@ -8,23 +8,104 @@
 #include "triglav/render_core/Material.hpp"
 #include "triglav/render_core/Model.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <vector>
+
 namespace triglav::renderer {
 
+using namespace name_literals;
 using graphics_api::BufferUsage;
 
+namespace {
+
+// Drawn in place of the textures that are still loading, normal maps get a flat normal.
+constexpr auto g_placeholderTexture = "placeholder/albedo.tex"_rc;
+constexpr auto g_placeholderNormalTexture = "placeholder/normal.tex"_rc;
+
+}// namespace
+
 MaterialManager::MaterialManager(graphics_api::Device& device, resource::ResourceManager& resourceManager,
                                  graphics_api::RenderTarget& renderTarget) :
     m_device(device),
     m_resourceManager(resourceManager),
-    m_renderTarget(renderTarget)
+    m_renderTarget(renderTarget),
+    m_onReloadedAssetsSink(resourceManager.OnReloadedAssets.connect<&MaterialManager::on_reloaded_assets>(this)),
+    m_onAddedAssetsSink(resourceManager.OnAddedAssets.connect<&MaterialManager::on_added_assets>(this))
 {
+   this->create_placeholder_textures();
+
    m_resourceManager.iterate_resources<ResourceType::MaterialTemplate>(
       [this](MaterialTemplateName name, const render_core::MaterialTemplate& material) {
          this->process_material_template(name, material);
       });
 
+   // Processing a material looks up its handle, which can't be done while the materials are being visited.
+   std::vector<MaterialName> materials;
    m_resourceManager.iterate_resources<ResourceType::Material>(
-      [this](MaterialName name, const render_core::Material& material) { this->process_material(name, material); });
+      [&materials](MaterialName name, const render_core::Material& /*material*/) { materials.emplace_back(name); });
+   for (const auto name : materials) {
+      this->process_material(name, m_resourceManager.get(name));
+   }
+}
+
+void MaterialManager::on_reloaded_assets(const std::span<const ResourceName> names)
+{
+   for (const auto name : names) {
+      if (name.type() == ResourceType::MaterialTemplate) {
+         const MaterialTemplateName templateName{name};
+         this->process_material_template(templateName, m_resourceManager.get(templateName));
+      } else if (name.type() == ResourceType::Material) {
+         const MaterialName materialName{name};
+         this->process_material(materialName, m_resourceManager.get(materialName));
+      }
+   }
+}
+
+void MaterialManager::on_added_assets(const std::span<const ResourceName> names)
+{
+   for (const auto name : names) {
+      if (name.type() == ResourceType::MaterialTemplate) {
+         const MaterialTemplateName templateName{name};
+         if (not m_templates.contains(templateName)) {
+            this->process_material_template(templateName, m_resourceManager.get(templateName));
+         }
+      } else if (name.type() == ResourceType::Material) {
+         const MaterialName materialName{name};
+         const auto handle = m_resourceManager.handle(materialName);
+         if (handle.index() >= m_materials.size() || not m_materials[handle.index()].has_value() ||
+             m_materials[handle.index()]->material != handle) {
+            this->process_material(materialName, m_resourceManager.get(materialName));
+         }
+      } else if (name.type() == ResourceType::Texture) {
+         const auto node = m_placeholderMaterials.extract(TextureName{name});
+         if (node.empty())
+            continue;
+
+         for (const auto materialName : node.mapped()) {
+            if (m_resourceManager.is_name_registered(materialName)) {
+               this->process_material(materialName, m_resourceManager.get(materialName));
+            }
+         }
+      }
+   }
+}
+
+void MaterialManager::create_placeholder_textures()
+{
+   if (m_resourceManager.is_name_registered(g_placeholderTexture))
+      return;
+
+   const std::array<std::pair<TextureName, std::array<u8, 4>>, 2> placeholders{
+      std::pair{TextureName{g_placeholderTexture}, std::array<u8, 4>{160, 160, 160, 255}},
+      std::pair{TextureName{g_placeholderNormalTexture}, std::array<u8, 4>{128, 128, 255, 255}},
+   };
+   for (const auto& [name, pixel] : placeholders) {
+      auto texture = GAPI_CHECK(m_device.create_texture(GAPI_FORMAT(RGBA, UNorm8), {1, 1}));
+      GAPI_CHECK_STATUS(texture.write(m_device, pixel.data()));
+      m_resourceManager.emplace_resource(name, std::move(texture));
+   }
 }
 
 void MaterialManager::process_material(const MaterialName name, const render_core::Material& material)
@@ -33,11 +114,24 @@ void MaterialManager::process_material(const MaterialName name, const render_cor
    io::BufferWriter writer(buffer);
    io::Serializer serializer(writer);
 
-   std::vector<TextureName> textures;
+   std::vector<TextureHandle> textures;
 
-   for (const auto& value : material.values) {
+   const auto& materialTemplate = m_resourceManager.get(material.materialTemplate);
+   for (MemorySize valueIndex = 0; valueIndex < material.values.size(); ++valueIndex) {
+      const auto& value = material.values[valueIndex];
       if (std::holds_alternative<TextureName>(value)) {
-         textures.emplace_back(std::get<TextureName>(value));
+         const auto textureName = std::get<TextureName>(value);
+         if (m_resourceManager.is_name_registered(textureName)) {
+            textures.emplace_back(m_resourceManager.handle(textureName));
+            continue;
+         }
+
+         auto& waitingMaterials = m_placeholderMaterials[textureName];
+         if (std::ranges::find(waitingMaterials, name) == waitingMaterials.end()) {
+            waitingMaterials.emplace_back(name);
+         }
+         const auto isNormalMap = materialTemplate.properties[valueIndex].name == "normal"_name;
+         textures.emplace_back(m_resourceManager.handle(isNormalMap ? g_placeholderNormalTexture : g_placeholderTexture));
       } else if (std::holds_alternative<float>(value)) {
          serializer.write_float32(std::get<float>(value));
       } else if (std::holds_alternative<glm::vec3>(value)) {
@@ -47,23 +141,35 @@ void MaterialManager::process_material(const MaterialName name, const render_cor
       }
    }
 
+   const auto handle = m_resourceManager.handle(name);
+   if (m_materials.size() <= handle.index()) {
+      m_materials.resize(handle.index() + 1);
+   }
+
+   // The previous uniform buffer of a reloaded material may still be used by the frames in flight.
+   if (auto& previous = m_materials[handle.index()]; previous.has_value() && previous->uniformBuffer.has_value()) {
+      m_resourceManager.retire_queue().retire(std::move(*previous->uniformBuffer));
+   }
+
    if (writer.offset() == 0) {
-      m_materials.emplace(name, MaterialResources{
-                                   .materialTemplate{material.materialTemplate},
-                                   .uniformBuffer{std::nullopt},
-                                   .textures{std::move(textures)},
-                                });
+      m_materials[handle.index()].emplace(MaterialResources{
+         .material{handle},
+         .materialTemplate{material.materialTemplate},
+         .uniformBuffer{std::nullopt},
+         .textures{std::move(textures)},
+      });
       return;
    }
 
    auto uniformBuffer = GAPI_CHECK(m_device.create_buffer(BufferUsage::TransferDst | BufferUsage::UniformBuffer, writer.offset()));
    GAPI_CHECK_STATUS(uniformBuffer.write_indirect(buffer.data(), writer.offset()));
 
-   m_materials.emplace(name, MaterialResources{
-                                .materialTemplate{material.materialTemplate},
-                                .uniformBuffer{std::move(uniformBuffer)},
-                                .textures{std::move(textures)},
-                             });
+   m_materials[handle.index()].emplace(MaterialResources{
+      .material{handle},
+      .materialTemplate{material.materialTemplate},
+      .uniformBuffer{std::move(uniformBuffer)},
+      .textures{std::move(textures)},
+   });
 }
 
 void MaterialManager::process_material_template(const MaterialTemplateName name, const render_core::MaterialTemplate& materialTemplate)
@@ -106,12 +212,25 @@ void MaterialManager::process_material_template(const MaterialTemplateName name,
       builder.descriptor_binding(graphics_api::DescriptorType::UniformBuffer, graphics_api::PipelineStage::FragmentShader);
    }
 
-   m_templates.emplace(name, MaterialTemplateResources{.pipeline = GAPI_CHECK(builder.build())});
+   auto pipeline = GAPI_CHECK(builder.build());
+   auto depthEqualPipeline = GAPI_CHECK(builder.depth_test_mode(graphics_api::DepthTestMode::Equal).build());
+
+   // The pipelines of a reloaded template may still be used by the frames in flight.
+   if (auto previous = m_templates.extract(name); not previous.empty()) {
+      m_resourceManager.retire_queue().retire(std::move(previous));
+   }
+
+   m_templates.emplace(name, MaterialTemplateResources{
+                                .pipeline = std::move(pipeline),
+                                .depthEqualPipeline = std::move(depthEqualPipeline),
+                             });
 }
 
-const MaterialResources& MaterialManager::material_resources(const MaterialName name) const
+const MaterialResources& MaterialManager::material_resources(const MaterialHandle handle) const
 {
-   return m_materials.at(name);
+   assert(handle.index() < m_materials.size() && m_materials[handle.index()].has_value() &&
+          m_materials[handle.index()]->material == handle);
+   return *m_materials[handle.index()];
 }
 
 const MaterialTemplateResources& MaterialManager::material_template_resources(const MaterialTemplateName name) const
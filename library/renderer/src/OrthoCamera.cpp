@@ -29,7 +29,8 @@ const glm::mat4& OrthoCamera::projection_matrix() const
       const auto halfWidth = 0.5f * m_viewSpaceWidth;
       const auto halfHeight = 0.5f * m_viewSpaceWidth / m_aspect;
 
-      m_projectionMat = glm::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight, this->near_plane(), this->far_plane());
+      // Vulkan keeps depth in [0, 1] and depth clamp is disabled, a [-1, 1] projection would clip the near half of the range.
+      m_projectionMat = glm::orthoRH_ZO(-halfWidth, halfWidth, -halfHeight, halfHeight, this->near_plane(), this->far_plane());
       m_hasCachedProjectionMatrix = true;
    }
 
@@ -38,6 +39,7 @@ const glm::mat4& OrthoCamera::projection_matrix() const
 
 float OrthoCamera::to_linear_depth(const float depth) const
 {
+   // Orthographic depth is already linear and in the [0, 1] range the rasterizer keeps.
    return depth;
 }
 
@@ -0,0 +1,101 @@
+#include "ParticleSimulation.h"
+
+#include <cmath>
+#include <numeric>
+
+namespace triglav::renderer {
+
+namespace particles {
+
+#include "particles/simulation.glsl"
+
+}// namespace particles
+
+u32 schedule_particle_spawns(const std::span<ParticleEmitterState> emitters, const float deltaTime, const u32 frameSeed)
+{
+   u32 spawnIndex = 0;
+   for (u32 emitterIndex = 0; emitterIndex < emitters.size(); ++emitterIndex) {
+      auto& state = emitters[emitterIndex];
+
+      const auto requested = state.spawnRemainder + state.spawnRate * deltaTime;
+      const auto spawnCount = static_cast<u32>(std::floor(requested));
+      state.spawnRemainder = requested - static_cast<float>(spawnCount);
+
+      state.emitter.spawn = glm::uvec4{spawnIndex, spawnCount, particles::particle_seed(frameSeed, emitterIndex), 0};
+      spawnIndex += spawnCount;
+   }
+   return spawnIndex;
+}
+
+ParticleSimulation::ParticleSimulation(const u32 capacity) :
+    m_particles(capacity),
+    m_dead(capacity)
+{
+   m_alive.reserve(capacity);
+   m_nextAlive.reserve(capacity);
+   std::iota(m_dead.begin(), m_dead.end(), 0);
+}
+
+void ParticleSimulation::update(const std::span<const ParticleEmitterState> emitters, const float deltaTime)
+{
+   this->simulate(deltaTime);
+   this->emit(emitters);
+}
+
+u32 ParticleSimulation::capacity() const
+{
+   return static_cast<u32>(m_particles.size());
+}
+
+const particles::Particle& ParticleSimulation::particle(const u32 slot) const
+{
+   return m_particles[slot];
+}
+
+std::span<const u32> ParticleSimulation::alive_slots() const
+{
+   return m_alive;
+}
+
+std::span<const u32> ParticleSimulation::dead_slots() const
+{
+   return m_dead;
+}
+
+void ParticleSimulation::simulate(const float deltaTime)
+{
+   m_nextAlive.clear();
+
+   for (const auto slot : m_alive) {
+      const auto particle = particles::update_particle(m_particles[slot], deltaTime);
+      if (particles::is_particle_alive(particle)) {
+         m_particles[slot] = particle;
+         m_nextAlive.push_back(slot);
+      } else {
+         m_dead.push_back(slot);
+      }
+   }
+
+   std::swap(m_alive, m_nextAlive);
+}
+
+void ParticleSimulation::emit(const std::span<const ParticleEmitterState> emitters)
+{
+   // Same slot assignment as the emit shader, spawn index i takes the i-th slot from the end of the dead list.
+   const auto deadCount = static_cast<u32>(m_dead.size());
+   u32 spawnedCount = 0;
+
+   for (const auto& state : emitters) {
+      const auto& emitter = state.emitter;
+      for (u32 index = emitter.spawn.x; index < emitter.spawn.x + emitter.spawn.y && index < deadCount; ++index) {
+         const auto slot = m_dead[deadCount - 1 - index];
+         m_particles[slot] = particles::spawn_particle(emitter, particles::particle_seed(emitter.spawn.z, index - emitter.spawn.x));
+         m_alive.push_back(slot);
+         ++spawnedCount;
+      }
+   }
+
+   m_dead.resize(deadCount - spawnedCount);
+}
+
+}// namespace triglav::renderer
@@ -1,6 +1,6 @@
 #include "PostProcessingRenderer.h"
 
-#include "src/node/Downsample.h"
+#include "src/node/Bloom.h"
 #include "triglav/graphics_api/CommandList.h"
 #include "triglav/graphics_api/DescriptorWriter.h"
 #include "triglav/graphics_api/PipelineBuilder.h"
@@ -37,16 +37,17 @@ void PostProcessingRenderer::draw(render_core::FrameResources& resources, graphi
 
    auto& shading = resources.node("shading"_name).framebuffer("shading"_name);
    auto& ui = resources.node("user_interface"_name).framebuffer("ui"_name);
-   auto& bloomTexture = dynamic_cast<node::DownsampleResources&>(resources.node("downsample_bloom"_name)).texture();
+   auto& bloomTexture = dynamic_cast<node::BloomResources&>(resources.node("bloom"_name)).upsampled();
 
    cmdList.bind_texture(0, shading.texture("shading"_name));
-   cmdList.bind_texture(1, bloomTexture);
+   cmdList.bind_texture_mip(1, bloomTexture, 0);
    cmdList.bind_texture(2, ui.texture("user_interface"_name));
 
    PushConstants constants{
       .enableFXAA = resources.has_flag("fxaa"_name),
       .hideUI = resources.has_flag("hide_ui"_name),
       .bloomEnabled = resources.has_flag("bloom"_name),
+      .upscale = resources.has_flag("upscale"_name),
    };
    cmdList.push_constant(graphics_api::PipelineStage::FragmentShader, constants);
    cmdList.draw_primitives(4, 0);
@@ -2,7 +2,7 @@
 
 #include "StatisticManager.h"
 #include "node/AmbientOcclusion.h"
-#include "node/Downsample.h"
+#include "node/Bloom.h"
 #include "node/Geometry.h"
 #include "node/Particles.h"
 #include "node/PostProcessing.h"
@@ -19,11 +19,14 @@
 #include "triglav/render_core/GlyphAtlas.h"
 #include "triglav/render_core/RenderCore.hpp"
 #include "triglav/resource/ResourceManager.h"
+#include "triglav/resource/TextureStreamer.h"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <glm/glm.hpp>
+#include <random>
 
 using triglav::ResourceType;
 using triglav::desktop::Key;
@@ -39,6 +42,14 @@ namespace triglav::renderer {
 constexpr auto g_colorFormat = GAPI_FORMAT(BGRA, sRGB);
 constexpr auto g_depthFormat = GAPI_FORMAT(D, UNorm16);
 constexpr auto g_sampleCount = SampleCount::Single;
+constexpr auto g_demoLightArea = 60.0f;
+constexpr auto g_defaultTargetFrameRate = 60;
+// Bounds of the dynamic render scale in percent of the output resolution.
+constexpr auto g_defaultMinRenderScale = 50;
+constexpr auto g_defaultMaxRenderScale = 100;
+
+// Nodes rendered at the dynamic render resolution, the remaining nodes always use the output resolution.
+constexpr std::array g_scaledNodes{"geometry"_name, "ambient_occlusion"_name, "shading"_name, "bloom"_name};
 
 namespace {
 
@@ -57,6 +68,26 @@ graphics_api::Resolution create_viewport_resolution(const graphics_api::Device&
    return resolution;
 }
 
+// Scatters randomly colored point and spot lights above the ground.
+void spawn_demo_lights(Scene& scene, const u32 count)
+{
+   std::default_random_engine generator{};
+   std::uniform_real_distribution<float> area(-g_demoLightArea, g_demoLightArea);
+   std::uniform_real_distribution<float> height(-4.0f, -0.5f);
+   std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+   for (u32 i = 0; i < count; ++i) {
+      scene.add_light(Light{
+         .type = (i % 4 == 0) ? LightType::Spot : LightType::Point,
+         .position{area(generator), area(generator), height(generator)},
+         .direction{0.0f, 0.0f, 1.0f},
+         .color{unit(generator), unit(generator), unit(generator)},
+         .intensity = 4.0f + 8.0f * unit(generator),
+         .range = 2.0f + 6.0f * unit(generator),
+      });
+   }
+}
+
 std::vector<graphics_api::Framebuffer> create_framebuffers(const graphics_api::Swapchain& swapchain,
                                                            const graphics_api::RenderTarget& renderTarget)
 {
@@ -68,6 +99,19 @@ std::vector<graphics_api::Framebuffer> create_framebuffers(const graphics_api::S
    return result;
 }
 
+DynamicResolutionSettings get_dynamic_resolution_settings()
+{
+   const auto& commandLine = io::CommandLine::the();
+   const auto targetFrameRate = commandLine.arg_int("targetFrameRate"_name).value_or(g_defaultTargetFrameRate);
+   const auto minRenderScale = commandLine.arg_int("minRenderScale"_name).value_or(g_defaultMinRenderScale);
+   const auto maxRenderScale = commandLine.arg_int("maxRenderScale"_name).value_or(g_defaultMaxRenderScale);
+   return DynamicResolutionSettings{
+      .targetGpuTime = 1000.0f / static_cast<float>(std::max(targetFrameRate, 1)),
+      .minScale = static_cast<float>(minRenderScale) / 100.0f,
+      .maxScale = static_cast<float>(maxRenderScale) / 100.0f,
+   };
+}
+
 graphics_api::PresentMode get_present_mode()
 {
    auto presentModeStr = io::CommandLine::the().arg("presentMode"_name);
@@ -93,6 +137,8 @@ Renderer::Renderer(desktop::ISurface& desktopSurface, graphics_api::Surface& sur
     m_resourceManager(resourceManager),
     m_scene(m_resourceManager),
     m_resolution(create_viewport_resolution(m_device, m_surface, resolution.width, resolution.height)),
+    m_renderResolution(m_resolution),
+    m_dynamicResolution(get_dynamic_resolution_settings()),
     m_swapchain(
        checkResult(m_device.create_swapchain(m_surface, g_colorFormat, graphics_api::ColorSpace::sRGB, m_resolution, get_present_mode()))),
     m_renderTarget(
@@ -111,6 +157,13 @@ Renderer::Renderer(desktop::ISurface& desktopSurface, graphics_api::Surface& sur
 {
    m_context2D.update_resolution(m_resolution);
 
+   m_dynamicResolutionEnabled = io::CommandLine::the().is_enabled("dynamicResolution"_name);
+   m_bloomHighQuality = io::CommandLine::the().arg("bloomQuality"_name).value_or("high") != "low";
+
+   if (const auto shadowDistance = io::CommandLine::the().arg_int("shadowDistance"_name); shadowDistance.has_value()) {
+      m_scene.set_shadow_distance(static_cast<float>(*shadowDistance));
+   }
+
    m_renderGraph.add_external_node("frame_is_ready"_name);
    m_renderGraph.emplace_node<node::Geometry>("geometry"_name, m_device, m_resourceManager, m_scene);
    m_renderGraph.emplace_node<node::ShadowMap>("shadow_map"_name, m_device, m_resourceManager, m_scene);
@@ -118,8 +171,8 @@ Renderer::Renderer(desktop::ISurface& desktopSurface, graphics_api::Surface& sur
    m_renderGraph.emplace_node<node::Shading>("shading"_name, m_device, m_resourceManager, m_scene);
    m_renderGraph.emplace_node<node::UserInterface>("user_interface"_name, m_device, m_resourceManager, m_uiViewport, m_glyphCache);
    m_renderGraph.emplace_node<node::PostProcessing>("post_processing"_name, m_device, m_resourceManager, m_renderTarget, m_framebuffers);
-   m_renderGraph.emplace_node<node::Downsample>("downsample_bloom"_name, m_device, "shading"_name, "shading"_name, "bloom"_name);
-   m_renderGraph.emplace_node<node::Particles>("particles"_name, m_device, m_resourceManager, m_renderGraph);
+   m_renderGraph.emplace_node<node::Bloom>("bloom"_name, m_device, m_resourceManager, "shading"_name, "shading"_name, "bloom"_name);
+   m_renderGraph.emplace_node<node::Particles>("particles"_name, m_device, m_resourceManager, m_renderGraph, m_scene);
    m_renderGraph.emplace_node<node::SyncBuffers>("sync_buffers"_name, m_scene);
    m_renderGraph.emplace_node<node::ProcessGlyphs>("process_glyphs"_name, m_device, m_resourceManager, m_glyphCache, m_uiViewport);
 
@@ -131,10 +184,10 @@ Renderer::Renderer(desktop::ISurface& desktopSurface, graphics_api::Surface& sur
    m_renderGraph.add_dependency("shading"_name, "shadow_map"_name);
    m_renderGraph.add_dependency("shading"_name, "ambient_occlusion"_name);
    m_renderGraph.add_dependency("shading"_name, "particles"_name);
-   m_renderGraph.add_dependency("downsample_bloom"_name, "shading"_name);
+   m_renderGraph.add_dependency("bloom"_name, "shading"_name);
    m_renderGraph.add_dependency("post_processing"_name, "frame_is_ready"_name);
    m_renderGraph.add_dependency("post_processing"_name, "user_interface"_name);
-   m_renderGraph.add_dependency("post_processing"_name, "downsample_bloom"_name);
+   m_renderGraph.add_dependency("post_processing"_name, "bloom"_name);
 
    m_renderGraph.bake("post_processing"_name);
    m_renderGraph.update_resolution(m_resolution);
@@ -142,6 +195,10 @@ Renderer::Renderer(desktop::ISurface& desktopSurface, graphics_api::Surface& sur
    m_infoDialog.initialize();
    m_scene.load_level("demo.level"_rc);
 
+   if (const auto lightCount = io::CommandLine::the().arg_int("lightCount"_name); lightCount.has_value()) {
+      spawn_demo_lights(m_scene, static_cast<u32>(*lightCount));
+   }
+
    StatisticManager::the().initialize();
 }
 
@@ -168,6 +225,28 @@ void Renderer::update_debug_info()
    m_uiViewport.set_text_content("info_dialog/metrics/gbuffer_gpu_time/value"_name, gBufferGpuTimeStr);
    const auto shadingGpuTimeStr = std::format("{:.2f}ms", StatisticManager::the().value(Stat::ShadingGpuTime));
    m_uiViewport.set_text_content("info_dialog/metrics/shading_gpu_time/value"_name, shadingGpuTimeStr);
+   const auto shadowMapGpuTimeStr = std::format("{:.2f}ms", StatisticManager::the().value(Stat::ShadowMapGpuTime));
+   m_uiViewport.set_text_content("info_dialog/metrics/shadow_map_gpu_time/value"_name, shadowMapGpuTimeStr);
+   const auto aoGpuTimeStr = std::format("{:.2f}ms", StatisticManager::the().value(Stat::AmbientOcclusionGpuTime));
+   m_uiViewport.set_text_content("info_dialog/metrics/ao_gpu_time/value"_name, aoGpuTimeStr);
+   const auto bloomPassCount = std::max(m_renderGraph.node<node::Bloom>("bloom"_name).pass_count(), 1u);
+   const auto bloomGpuTime = StatisticManager::the().value(Stat::BloomGpuTime);
+   const auto bloomGpuTimeStr = std::format("{:.2f}ms ({:.3f}ms/pass)", bloomGpuTime, bloomGpuTime / static_cast<float>(bloomPassCount));
+   m_uiViewport.set_text_content("info_dialog/metrics/bloom_gpu_time/value"_name, bloomGpuTimeStr);
+   const auto gBufferBandwidth = m_renderGraph.node<node::Geometry>("geometry"_name).gbuffer_bandwidth(m_renderResolution);
+   const auto gBufferBandwidthStr = std::format("{:.1f}MB", static_cast<double>(gBufferBandwidth) / (1024.0 * 1024.0));
+   m_uiViewport.set_text_content("info_dialog/metrics/gbuffer_bandwidth/value"_name, gBufferBandwidthStr);
+   const auto renderScale = m_dynamicResolutionEnabled ? m_dynamicResolution.render_scale() : 1.0f;
+   const auto renderResolutionStr =
+      std::format("{}x{} ({:.0f}%)", m_renderResolution.width, m_renderResolution.height, 100.0f * renderScale);
+   m_uiViewport.set_text_content("info_dialog/metrics/render_resolution/value"_name, renderResolutionStr);
+   const auto* textureStreamer = m_resourceManager.texture_streamer();
+   const auto textureMemoryStr =
+      textureStreamer != nullptr
+         ? std::format("{:.1f}MB / {:.0f}MB", static_cast<double>(textureStreamer->resident_size()) / (1024.0 * 1024.0),
+                       static_cast<double>(textureStreamer->budget()) / (1024.0 * 1024.0))
+         : std::format("{:.1f}MB", static_cast<double>(m_resourceManager.texture_memory()) / (1024.0 * 1024.0));
+   m_uiViewport.set_text_content("info_dialog/metrics/texture_memory/value"_name, textureMemoryStr);
 
    const auto camPos = m_scene.camera().position();
    const auto positionStr = std::format("{:.2f}, {:.2f}, {:.2f}", camPos.x, camPos.y, camPos.z);
@@ -179,8 +258,15 @@ void Renderer::update_debug_info()
    m_uiViewport.set_text_content("info_dialog/features/ao/value"_name, m_ssaoEnabled ? "Screen-Space" : "Off");
    m_uiViewport.set_text_content("info_dialog/features/aa/value"_name, m_fxaaEnabled ? "FXAA" : "Off");
    m_uiViewport.set_text_content("info_dialog/features/bloom/value"_name, m_bloomEnabled ? "On" : "Off");
+   m_uiViewport.set_text_content("info_dialog/features/bloom_quality/value"_name, m_bloomHighQuality ? "High" : "Low");
    m_uiViewport.set_text_content("info_dialog/features/debug_lines/value"_name, m_showDebugLines ? "On" : "Off");
    m_uiViewport.set_text_content("info_dialog/features/smooth_camera/value"_name, m_smoothCamera ? "On" : "Off");
+   m_uiViewport.set_text_content("info_dialog/features/depth_prepass/value"_name, m_depthPrepassEnabled ? "On" : "Off");
+   m_uiViewport.set_text_content("info_dialog/features/ao_resolution/value"_name,
+                                 m_ssaoResolutionDivisor == 4   ? "Quarter"
+                                 : m_ssaoResolutionDivisor == 2 ? "Half"
+                                                                : "Full");
+   m_uiViewport.set_text_content("info_dialog/features/dynamic_resolution/value"_name, m_dynamicResolutionEnabled ? "On" : "Off");
 }
 
 void Renderer::on_render()
@@ -193,6 +279,11 @@ void Renderer::on_render()
       StatisticManager::the().push_accumulated(Stat::FramesPerSecond, 1.0f / deltaTime);
       StatisticManager::the().push_accumulated(Stat::GBufferGpuTime, m_renderGraph.node<node::Geometry>("geometry"_name).gpu_time());
       StatisticManager::the().push_accumulated(Stat::ShadingGpuTime, m_renderGraph.node<node::Shading>("shading"_name).gpu_time());
+      StatisticManager::the().push_accumulated(Stat::ShadowMapGpuTime, m_renderGraph.node<node::ShadowMap>("shadow_map"_name).gpu_time());
+      StatisticManager::the().push_accumulated(Stat::AmbientOcclusionGpuTime,
+                                               m_renderGraph.node<node::AmbientOcclusion>("ambient_occlusion"_name).gpu_time());
+      StatisticManager::the().push_accumulated(Stat::BloomGpuTime, m_renderGraph.node<node::Bloom>("bloom"_name).gpu_time());
+      this->update_dynamic_resolution();
    } else {
       isFirstFrame = false;
    }
@@ -200,6 +291,9 @@ void Renderer::on_render()
    m_renderGraph.change_active_frame();
    m_renderGraph.await();
 
+   // The frame resources are free now, so textures with streamed levels can be swapped and retired resources destroyed.
+   m_resourceManager.begin_frame();
+
    auto& frameReadySemaphore = m_renderGraph.semaphore("frame_is_ready"_name, "post_processing"_name);
    const auto framebufferIndex = m_swapchain.get_available_framebuffer(frameReadySemaphore);
    if (not framebufferIndex.has_value()) {
@@ -214,9 +308,14 @@ void Renderer::on_render()
 
    m_renderGraph.set_flag("debug_lines"_name, m_showDebugLines);
    m_renderGraph.set_flag("ssao"_name, m_ssaoEnabled);
+   m_renderGraph.set_flag("ssao_half_res"_name, m_ssaoResolutionDivisor == 2);
+   m_renderGraph.set_flag("ssao_quarter_res"_name, m_ssaoResolutionDivisor == 4);
    m_renderGraph.set_flag("fxaa"_name, m_fxaaEnabled);
    m_renderGraph.set_flag("bloom"_name, m_bloomEnabled);
+   m_renderGraph.set_flag("bloom_high_quality"_name, m_bloomHighQuality);
    m_renderGraph.set_flag("hide_ui"_name, m_hideUI);
+   m_renderGraph.set_flag("depth_prepass"_name, m_depthPrepassEnabled);
+   m_renderGraph.set_flag("upscale"_name, m_renderResolution != m_resolution);
    this->update_debug_info();
 
    this->update_uniform_data(deltaTime);
@@ -290,6 +389,20 @@ void Renderer::on_key_pressed(const Key key)
    if (key == Key::F8) {
       m_smoothCamera = not m_smoothCamera;
    }
+   if (key == Key::F9) {
+      m_depthPrepassEnabled = not m_depthPrepassEnabled;
+   }
+   if (key == Key::F10) {
+      m_ssaoResolutionDivisor = m_ssaoResolutionDivisor == 4 ? 1 : 2 * m_ssaoResolutionDivisor;
+   }
+   if (key == Key::F11) {
+      m_dynamicResolutionEnabled = not m_dynamicResolutionEnabled;
+      m_dynamicResolution.reset();
+      this->apply_render_resolution();
+   }
+   if (key == Key::F12) {
+      m_bloomHighQuality = not m_bloomHighQuality;
+   }
    if (key == Key::Space && m_motion.z == 0.0f) {
       m_motion.z += -32.0f;
    }
@@ -372,6 +485,36 @@ void Renderer::recreate_swapchain(const u32 width, const u32 height)
    m_framebuffers = create_framebuffers(m_swapchain, m_renderTarget);
 
    m_resolution = {width, height};
+   m_renderResolution = m_resolution;
+   this->apply_render_resolution();
+}
+
+void Renderer::update_dynamic_resolution()
+{
+   if (not m_dynamicResolutionEnabled)
+      return;
+
+   const auto gpuTime = m_renderGraph.node<node::Geometry>("geometry"_name).gpu_time() +
+                        m_renderGraph.node<node::ShadowMap>("shadow_map"_name).gpu_time() +
+                        m_renderGraph.node<node::AmbientOcclusion>("ambient_occlusion"_name).gpu_time() +
+                        m_renderGraph.node<node::Shading>("shading"_name).gpu_time();
+
+   if (m_dynamicResolution.update(gpuTime)) {
+      this->apply_render_resolution();
+   }
+}
+
+void Renderer::apply_render_resolution()
+{
+   const auto renderResolution = m_dynamicResolutionEnabled ? m_dynamicResolution.render_resolution(m_resolution) : m_resolution;
+   if (renderResolution == m_renderResolution)
+      return;
+
+   // The framebuffers of the scaled nodes are recreated, the frames in flight must finish using them first.
+   m_device.await_all();
+
+   m_renderGraph.update_resolution(g_scaledNodes, renderResolution);
+   m_renderResolution = renderResolution;
 }
 
 graphics_api::Device& Renderer::device() const
@@ -4,7 +4,9 @@
 
 #include "triglav/world/Level.h"
 
+#include <algorithm>
 #include <cmath>
+#include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 #ifndef M_PI
@@ -16,6 +18,9 @@ using triglav::ResourceType;
 namespace triglav::renderer {
 
 constexpr auto g_upVector = glm::vec3{0.0f, 0.0f, 1.0f};
+constexpr auto g_shadowCascadeResolution = 2048.0f;
+// Extends the cascade depth range towards the light so casters outside the cascade bounds still cast shadows.
+constexpr auto g_shadowCasterDistance = 100.0f;
 
 glm::mat4 SceneObject::model_matrix() const
 {
@@ -36,6 +41,8 @@ void Scene::update(graphics_api::Resolution& resolution)
    const auto [width, height] = resolution;
    m_camera.set_viewport_size(width, height);
 
+   this->update_shadow_cascades();
+
    this->OnViewportChange.publish(resolution);
 }
 
@@ -45,6 +52,16 @@ void Scene::add_object(SceneObject object)
    this->OnObjectAddedToScene.publish(emplacedObj);
 }
 
+void Scene::add_light(const Light& light)
+{
+   m_lights.emplace_back(light);
+}
+
+void Scene::add_particle_emitter(const SceneParticleEmitter& emitter)
+{
+   m_particleEmitters.emplace_back(emitter);
+}
+
 void Scene::load_level(const LevelName name)
 {
    auto& level = m_resourceManager.get<ResourceType::Level>(name);
@@ -58,6 +75,13 @@ void Scene::load_level(const LevelName name)
          .scale = mesh.transform.scale,
       });
    }
+
+   for (const auto& emitter : root.particle_emitters()) {
+      this->add_particle_emitter(SceneParticleEmitter{
+         .emitter = emitter.emitterName,
+         .position = emitter.position,
+      });
+   }
 }
 
 void Scene::set_camera(const glm::vec3 position, const glm::quat orientation)
@@ -81,6 +105,101 @@ const OrthoCamera& Scene::shadow_map_camera() const
    return m_shadowMapCamera;
 }
 
+const OrthoCamera& Scene::shadow_cascade_camera(const u32 index) const
+{
+   return m_shadowCascadeCameras[index];
+}
+
+float Scene::shadow_cascade_split(const u32 index) const
+{
+   return m_shadowCascadeSplits[index];
+}
+
+std::span<const Light> Scene::lights() const
+{
+   return m_lights;
+}
+
+std::span<const SceneParticleEmitter> Scene::particle_emitters() const
+{
+   return m_particleEmitters;
+}
+
+void Scene::set_shadow_distance(const float distance)
+{
+   m_shadowDistance = distance;
+}
+
+void Scene::set_shadow_cascade_split_lambda(const float lambda)
+{
+   m_shadowCascadeSplitLambda = std::clamp(lambda, 0.0f, 1.0f);
+}
+
+void Scene::update_shadow_cascades()
+{
+   const auto nearPlane = m_camera.near_plane();
+   const auto farPlane = std::min(m_shadowDistance, m_camera.far_plane());
+
+   // Corners of the whole view frustum, near plane first.
+   const auto invViewProj = glm::inverse(m_camera.view_projection_matrix());
+   std::array<glm::vec3, 8> frustumCorners{};
+   for (u32 i = 0; i < 8; ++i) {
+      const glm::vec4 ndcCorner{(i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f};
+      const auto corner = invViewProj * ndcCorner;
+      frustumCorners[i] = glm::vec3(corner) / corner.w;
+   }
+
+   const auto lightOrientation = m_shadowMapCamera.orientation();
+   const auto lightRotation = glm::lookAt(glm::vec3{0.0f}, lightOrientation * glm::vec3{0.0f, 1.0f, 0.0f},
+                                          lightOrientation * glm::vec3{0.0f, 0.0f, 1.0f});
+   const auto invLightRotation = glm::inverse(lightRotation);
+
+   float splitNear = nearPlane;
+   for (u32 cascade = 0; cascade < g_shadowCascadeCount; ++cascade) {
+      // Practical split scheme, blend between logarithmic and uniform distribution.
+      const auto ratio = static_cast<float>(cascade + 1) / static_cast<float>(g_shadowCascadeCount);
+      const auto logSplit = nearPlane * std::pow(farPlane / nearPlane, ratio);
+      const auto uniformSplit = nearPlane + (farPlane - nearPlane) * ratio;
+      const auto splitFar = glm::mix(uniformSplit, logSplit, m_shadowCascadeSplitLambda);
+
+      // View depth is linear along each frustum edge, so the slice corners can be interpolated.
+      const auto nearFactor = (splitNear - m_camera.near_plane()) / (m_camera.far_plane() - m_camera.near_plane());
+      const auto farFactor = (splitFar - m_camera.near_plane()) / (m_camera.far_plane() - m_camera.near_plane());
+
+      std::array<glm::vec3, 8> sliceCorners{};
+      glm::vec3 center{0.0f};
+      for (u32 i = 0; i < 4; ++i) {
+         sliceCorners[i] = glm::mix(frustumCorners[i], frustumCorners[i + 4], nearFactor);
+         sliceCorners[i + 4] = glm::mix(frustumCorners[i], frustumCorners[i + 4], farFactor);
+         center += sliceCorners[i] + sliceCorners[i + 4];
+      }
+      center /= 8.0f;
+
+      // Bounding sphere keeps the cascade size constant as the camera rotates.
+      float radius = 0.0f;
+      for (const auto& corner : sliceCorners) {
+         radius = std::max(radius, glm::length(corner - center));
+      }
+      radius = std::ceil(radius * 16.0f) / 16.0f;
+
+      // Snap the cascade center to the shadow map texel grid to avoid shimmering.
+      const auto texelSize = 2.0f * radius / g_shadowCascadeResolution;
+      auto lightSpaceCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+      lightSpaceCenter.x = std::floor(lightSpaceCenter.x / texelSize) * texelSize;
+      lightSpaceCenter.y = std::floor(lightSpaceCenter.y / texelSize) * texelSize;
+      center = glm::vec3(invLightRotation * glm::vec4(lightSpaceCenter, 1.0f));
+
+      auto& cascadeCamera = m_shadowCascadeCameras[cascade];
+      cascadeCamera.set_position(center);
+      cascadeCamera.set_orientation(lightOrientation);
+      cascadeCamera.set_near_far_planes(-radius - g_shadowCasterDistance, radius);
+      cascadeCamera.set_viewspace_width(2.0f * radius);
+
+      m_shadowCascadeSplits[cascade] = splitFar;
+      splitNear = splitFar;
+   }
+}
+
 float Scene::yaw() const
 {
    return m_yaw;
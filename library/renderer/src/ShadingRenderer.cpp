@@ -1,5 +1,7 @@
 #include "ShadingRenderer.h"
 
+#include "node/ShadowMap.h"
+
 #include <cstring>
 #include <random>
 
@@ -16,6 +18,8 @@ using triglav::resource::ResourceManager;
 
 namespace triglav::renderer {
 
+static_assert(g_shadowCascadeCount == 3, "shading pipeline layout expects three shadow cascades");
+
 ShadingRenderer::ShadingRenderer(graphics_api::Device& device, graphics_api::RenderTarget& renderTarget, ResourceManager& resourceManager) :
     m_device(device),
     m_pipeline(checkResult(graphics_api::GraphicsPipelineBuilder(m_device, renderTarget)
@@ -26,7 +30,12 @@ ShadingRenderer::ShadingRenderer(graphics_api::Device& device, graphics_api::Ren
                               .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
                               .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
                               .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
+                              .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
+                              .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
                               .descriptor_binding(graphics_api::DescriptorType::UniformBuffer, graphics_api::PipelineStage::FragmentShader)
+                              .descriptor_binding(graphics_api::DescriptorType::StorageBuffer, graphics_api::PipelineStage::FragmentShader)
+                              .descriptor_binding(graphics_api::DescriptorType::StorageBuffer, graphics_api::PipelineStage::FragmentShader)
+                              .descriptor_binding(graphics_api::DescriptorType::StorageBuffer, graphics_api::PipelineStage::FragmentShader)
                               .push_constant(graphics_api::PipelineStage::FragmentShader, sizeof(PushConstant))
                               .use_push_descriptors(true)
                               .enable_depth_test(false)
@@ -37,28 +46,34 @@ ShadingRenderer::ShadingRenderer(graphics_api::Device& device, graphics_api::Ren
 }
 
 void ShadingRenderer::draw(render_core::FrameResources& resources, graphics_api::CommandList& cmdList, const glm::vec3& lightPosition,
-                           const glm::mat4& shadowMapMat) const
+                           const UniformData& uniformData, const ClusteredLightBuffers& lightBuffers) const
 {
-   m_uniformBuffer->shadowMapMat = shadowMapMat;
+   *m_uniformBuffer = uniformData;
 
    cmdList.bind_pipeline(m_pipeline);
 
    auto& gbuffer = resources.node("geometry"_name).framebuffer("gbuffer"_name);
    auto& aoBuffer = resources.node("ambient_occlusion"_name).framebuffer("ao"_name);
-   auto& smBuffer = resources.node("shadow_map"_name).framebuffer("sm"_name);
+   auto& smNode = resources.node("shadow_map"_name);
 
    PushConstant pushConstant{
       .lightPosition = lightPosition,
       .enableSSAO = resources.has_flag("ssao"_name),
+      .blurSSAO = not(resources.has_flag("ssao_half_res"_name) || resources.has_flag("ssao_quarter_res"_name)),
    };
    cmdList.push_constant(graphics_api::PipelineStage::FragmentShader, pushConstant);
 
    cmdList.bind_texture(0, gbuffer.texture("albedo"_name));
-   cmdList.bind_texture(1, gbuffer.texture("position"_name));
-   cmdList.bind_texture(2, gbuffer.texture("normal"_name));
+   cmdList.bind_texture(1, gbuffer.texture("normal"_name));
+   cmdList.bind_texture(2, gbuffer.texture("depth"_name));
    cmdList.bind_texture(3, aoBuffer.texture("ao"_name));
-   cmdList.bind_texture(4, smBuffer.texture("sm"_name));
-   cmdList.bind_uniform_buffer(5, m_uniformBuffer);
+   for (u32 cascade = 0; cascade < g_shadowCascadeCount; ++cascade) {
+      cmdList.bind_texture(4 + cascade, smNode.framebuffer(node::shadow_cascade_framebuffer_name(cascade)).texture("sm"_name));
+   }
+   cmdList.bind_uniform_buffer(4 + g_shadowCascadeCount, m_uniformBuffer);
+   cmdList.bind_storage_buffer(5 + g_shadowCascadeCount, lightBuffers.lights);
+   cmdList.bind_storage_buffer(6 + g_shadowCascadeCount, lightBuffers.clusters);
+   cmdList.bind_storage_buffer(7 + g_shadowCascadeCount, lightBuffers.lightIndices);
 
    cmdList.draw_primitives(4, 0);
 }
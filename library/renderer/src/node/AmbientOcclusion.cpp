@@ -1,27 +1,119 @@
 #include "AmbientOcclusion.h"
 
+#include "triglav/graphics_api/PipelineBuilder.h"
+
 #include <triglav/render_core/FrameResources.h>
 
+#include <algorithm>
+#include <glm/vec2.hpp>
+
 namespace triglav::renderer::node {
 
 using namespace name_literals;
 using graphics_api::AttachmentAttribute;
+using graphics_api::DescriptorType;
+using graphics_api::PipelineStage;
 using graphics_api::SampleCount;
 
+namespace {
+
+struct BilateralPushConstants
+{
+   glm::vec2 depthParams;
+   glm::ivec2 direction;
+};
+
+graphics_api::Resolution reduced_resolution(const graphics_api::Resolution& resolution, const u32 level)
+{
+   const auto divisor = 2u << level;
+   return {std::max(resolution.width / divisor, 1u), std::max(resolution.height / divisor, 1u)};
+}
+
+}// namespace
+
+AmbientOcclusionResources::AmbientOcclusionResources(graphics_api::RenderTarget& aoRenderTarget,
+                                                     graphics_api::RenderTarget& depthNormalRenderTarget) :
+    m_aoRenderTarget(aoRenderTarget),
+    m_depthNormalRenderTarget(depthNormalRenderTarget)
+{
+}
+
+void AmbientOcclusionResources::update_resolution(const graphics_api::Resolution& resolution)
+{
+   NodeFrameResources::update_resolution(resolution);
+
+   for (u32 level = 0; level < g_aoPyramidLevelCount; ++level) {
+      const auto levelResolution = reduced_resolution(resolution, level);
+      m_depthNormalPyramid[level].emplace(GAPI_CHECK(m_depthNormalRenderTarget.create_framebuffer(levelResolution)));
+      m_reducedAO[2 * level].emplace(GAPI_CHECK(m_aoRenderTarget.create_framebuffer(levelResolution)));
+      m_reducedAO[2 * level + 1].emplace(GAPI_CHECK(m_aoRenderTarget.create_framebuffer(levelResolution)));
+   }
+}
+
+graphics_api::Framebuffer& AmbientOcclusionResources::depth_normal(const u32 level)
+{
+   assert(m_depthNormalPyramid[level].has_value());
+   return *m_depthNormalPyramid[level];
+}
+
+graphics_api::Framebuffer& AmbientOcclusionResources::reduced_ao(const u32 level, const u32 index)
+{
+   assert(m_reducedAO[2 * level + index].has_value());
+   return *m_reducedAO[2 * level + index];
+}
+
 AmbientOcclusion::AmbientOcclusion(graphics_api::Device& device, resource::ResourceManager& resourceManager, Scene& scene) :
     m_renderTarget(
        GAPI_CHECK(graphics_api::RenderTargetBuilder(device)
                      .attachment("ao"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
                                  GAPI_FORMAT(R, Float16), SampleCount::Single)
                      .build())),
+    m_depthNormalRenderTarget(GAPI_CHECK(
+       graphics_api::RenderTargetBuilder(device)
+          .attachment("depth"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
+                      GAPI_FORMAT(R, Float32), SampleCount::Single)
+          .attachment("normal"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
+                      GAPI_FORMAT(RG, UNorm16), SampleCount::Single)
+          .build())),
     m_renderer(device, m_renderTarget, resourceManager, resourceManager.get("noise.tex"_rc)),
-    m_scene(scene)
+    m_scene(scene),
+    m_downsamplePipeline(GAPI_CHECK(graphics_api::GraphicsPipelineBuilder(device, m_depthNormalRenderTarget)
+                                       .fragment_shader(resourceManager.get("ambient_occlusion_downsample.fshader"_rc))
+                                       .vertex_shader(resourceManager.get("ambient_occlusion.vshader"_rc))
+                                       .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                       .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                       .enable_depth_test(false)
+                                       .use_push_descriptors(true)
+                                       .vertex_topology(graphics_api::VertexTopology::TriangleStrip)
+                                       .build())),
+    m_blurPipeline(GAPI_CHECK(graphics_api::GraphicsPipelineBuilder(device, m_renderTarget)
+                                 .fragment_shader(resourceManager.get("ambient_occlusion_blur.fshader"_rc))
+                                 .vertex_shader(resourceManager.get("ambient_occlusion.vshader"_rc))
+                                 .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                 .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                 .push_constant(PipelineStage::FragmentShader, sizeof(BilateralPushConstants))
+                                 .enable_depth_test(false)
+                                 .use_push_descriptors(true)
+                                 .vertex_topology(graphics_api::VertexTopology::TriangleStrip)
+                                 .build())),
+    m_upsamplePipeline(GAPI_CHECK(graphics_api::GraphicsPipelineBuilder(device, m_renderTarget)
+                                     .fragment_shader(resourceManager.get("ambient_occlusion_upsample.fshader"_rc))
+                                     .vertex_shader(resourceManager.get("ambient_occlusion.vshader"_rc))
+                                     .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                     .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                     .descriptor_binding(DescriptorType::ImageSampler, PipelineStage::FragmentShader)
+                                     .push_constant(PipelineStage::FragmentShader, sizeof(BilateralPushConstants))
+                                     .enable_depth_test(false)
+                                     .use_push_descriptors(true)
+                                     .vertex_topology(graphics_api::VertexTopology::TriangleStrip)
+                                     .build())),
+    m_timestampArray(GAPI_CHECK(device.create_timestamp_array(2)))
 {
 }
 
 std::unique_ptr<render_core::NodeFrameResources> AmbientOcclusion::create_node_resources()
 {
-   auto result = std::make_unique<render_core::NodeFrameResources>();
+   auto result = std::make_unique<AmbientOcclusionResources>(m_renderTarget, m_depthNormalRenderTarget);
    result->add_render_target("ao"_name, m_renderTarget);
    return result;
 }
@@ -34,17 +126,105 @@ graphics_api::WorkTypeFlags AmbientOcclusion::work_types() const
 void AmbientOcclusion::record_commands(render_core::FrameResources& frameResources, render_core::NodeFrameResources& resources,
                                        graphics_api::CommandList& cmdList)
 {
-   if (not frameResources.has_flag("ssao"_name))
-      return;
+   cmdList.reset_timestamp_array(m_timestampArray, 0, 2);
+   cmdList.write_timestamp(PipelineStage::Entrypoint, m_timestampArray, 0);
+
+   if (frameResources.has_flag("ssao"_name)) {
+      if (frameResources.has_flag("ssao_quarter_res"_name)) {
+         this->draw_reduced(frameResources, dynamic_cast<AmbientOcclusionResources&>(resources), cmdList, 2);
+      } else if (frameResources.has_flag("ssao_half_res"_name)) {
+         this->draw_reduced(frameResources, dynamic_cast<AmbientOcclusionResources&>(resources), cmdList, 1);
+      } else {
+         auto& gbuffer = frameResources.node("geometry"_name).framebuffer("gbuffer"_name);
+
+         std::array<graphics_api::ClearValue, 1> clearValues{
+            graphics_api::ColorPalette::Black,
+         };
+
+         cmdList.begin_render_pass(resources.framebuffer("ao"_name), clearValues);
+         m_renderer.draw(cmdList, m_scene.camera().projection_matrix(), gbuffer.texture("depth"_name), gbuffer.texture("normal"_name));
+         cmdList.end_render_pass();
+      }
+   }
+
+   cmdList.write_timestamp(PipelineStage::End, m_timestampArray, 1);
+}
+
+float AmbientOcclusion::gpu_time() const
+{
+   return m_timestampArray.get_difference(0, 1);
+}
+
+void AmbientOcclusion::draw_reduced(render_core::FrameResources& frameResources, AmbientOcclusionResources& resources,
+                                    graphics_api::CommandList& cmdList, const u32 levelCount)
+{
+   auto& gbuffer = frameResources.node("geometry"_name).framebuffer("gbuffer"_name);
+   const auto level = levelCount - 1;
 
+   std::array<graphics_api::ClearValue, 2> depthNormalClearValues{
+      graphics_api::ColorPalette::Black,
+      graphics_api::ColorPalette::Black,
+   };
    std::array<graphics_api::ClearValue, 1> clearValues{
       graphics_api::ColorPalette::Black,
    };
 
-   cmdList.begin_render_pass(resources.framebuffer("ao"_name), clearValues);
+   // Build the depth and normal pyramid, each level is downsampled from the previous one.
+   const graphics_api::Texture* srcDepth = &gbuffer.texture("depth"_name);
+   const graphics_api::Texture* srcNormal = &gbuffer.texture("normal"_name);
+   for (u32 pyramidLevel = 0; pyramidLevel < levelCount; ++pyramidLevel) {
+      auto& dstFramebuffer = resources.depth_normal(pyramidLevel);
 
-   m_renderer.draw(frameResources, cmdList, m_scene.camera().projection_matrix());
+      cmdList.begin_render_pass(dstFramebuffer, depthNormalClearValues);
+      cmdList.bind_pipeline(m_downsamplePipeline);
+      cmdList.bind_texture(0, *srcDepth);
+      cmdList.bind_texture(1, *srcNormal);
+      cmdList.draw_primitives(4, 0);
+      cmdList.end_render_pass();
 
+      srcDepth = &dstFramebuffer.texture("depth"_name);
+      srcNormal = &dstFramebuffer.texture("normal"_name);
+   }
+
+   const auto& projection = m_scene.camera().projection_matrix();
+   auto& lowDepth = resources.depth_normal(level).texture("depth"_name);
+
+   cmdList.begin_render_pass(resources.reduced_ao(level, 0), clearValues);
+   m_renderer.draw(cmdList, projection, lowDepth, resources.depth_normal(level).texture("normal"_name));
+   cmdList.end_render_pass();
+
+   // Separable depth aware blur, horizontal pass into the second framebuffer and vertical pass back.
+   BilateralPushConstants pushConstants{
+      .depthParams{projection[3][2], projection[2][2]},
+      .direction{1, 0},
+   };
+
+   cmdList.begin_render_pass(resources.reduced_ao(level, 1), clearValues);
+   cmdList.bind_pipeline(m_blurPipeline);
+   cmdList.push_constant(PipelineStage::FragmentShader, pushConstants);
+   cmdList.bind_texture(0, resources.reduced_ao(level, 0).texture("ao"_name));
+   cmdList.bind_texture(1, lowDepth);
+   cmdList.draw_primitives(4, 0);
+   cmdList.end_render_pass();
+
+   pushConstants.direction = {0, 1};
+
+   cmdList.begin_render_pass(resources.reduced_ao(level, 0), clearValues);
+   cmdList.bind_pipeline(m_blurPipeline);
+   cmdList.push_constant(PipelineStage::FragmentShader, pushConstants);
+   cmdList.bind_texture(0, resources.reduced_ao(level, 1).texture("ao"_name));
+   cmdList.bind_texture(1, lowDepth);
+   cmdList.draw_primitives(4, 0);
+   cmdList.end_render_pass();
+
+   // Depth aware upsample to the full resolution target consumed by shading.
+   cmdList.begin_render_pass(resources.framebuffer("ao"_name), clearValues);
+   cmdList.bind_pipeline(m_upsamplePipeline);
+   cmdList.push_constant(PipelineStage::FragmentShader, pushConstants);
+   cmdList.bind_texture(0, resources.reduced_ao(level, 0).texture("ao"_name));
+   cmdList.bind_texture(1, lowDepth);
+   cmdList.bind_texture(2, gbuffer.texture("depth"_name));
+   cmdList.draw_primitives(4, 0);
    cmdList.end_render_pass();
 }
 
@@ -2,13 +2,39 @@
 
 #include "triglav/graphics_api/Framebuffer.h"
 #include "triglav/graphics_api/RenderTarget.h"
+#include "triglav/graphics_api/TimestampArray.h"
 #include "triglav/render_core/IRenderNode.hpp"
 
 #include "AmbientOcclusionRenderer.h"
 #include "Scene.h"
 
+#include <array>
+#include <optional>
+
 namespace triglav::renderer::node {
 
+// Number of levels of the depth and normal pyramid: half and quarter resolution.
+constexpr u32 g_aoPyramidLevelCount = 2;
+
+class AmbientOcclusionResources : public render_core::NodeFrameResources
+{
+ public:
+   AmbientOcclusionResources(graphics_api::RenderTarget& aoRenderTarget, graphics_api::RenderTarget& depthNormalRenderTarget);
+
+   void update_resolution(const graphics_api::Resolution& resolution) override;
+
+   // Level 0 is half resolution, level 1 is quarter resolution.
+   [[nodiscard]] graphics_api::Framebuffer& depth_normal(u32 level);
+   // Reduced resolution occlusion, two framebuffers per level for the separable blur.
+   [[nodiscard]] graphics_api::Framebuffer& reduced_ao(u32 level, u32 index);
+
+ private:
+   graphics_api::RenderTarget& m_aoRenderTarget;
+   graphics_api::RenderTarget& m_depthNormalRenderTarget;
+   std::array<std::optional<graphics_api::Framebuffer>, g_aoPyramidLevelCount> m_depthNormalPyramid;
+   std::array<std::optional<graphics_api::Framebuffer>, 2 * g_aoPyramidLevelCount> m_reducedAO;
+};
+
 class AmbientOcclusion : public render_core::IRenderNode
 {
  public:
@@ -18,10 +44,20 @@ class AmbientOcclusion : public render_core::IRenderNode
    void record_commands(render_core::FrameResources& frameResources, render_core::NodeFrameResources& resources,
                         graphics_api::CommandList& cmdList) override;
 
+   [[nodiscard]] float gpu_time() const;
+
  private:
+   void draw_reduced(render_core::FrameResources& frameResources, AmbientOcclusionResources& resources, graphics_api::CommandList& cmdList,
+                     u32 levelCount);
+
    graphics_api::RenderTarget m_renderTarget;
+   graphics_api::RenderTarget m_depthNormalRenderTarget;
    AmbientOcclusionRenderer m_renderer;
    Scene& m_scene;
+   graphics_api::Pipeline m_downsamplePipeline;
+   graphics_api::Pipeline m_blurPipeline;
+   graphics_api::Pipeline m_upsamplePipeline;
+   graphics_api::TimestampArray m_timestampArray;
 };
 
 }// namespace triglav::renderer::node
@@ -0,0 +1,258 @@
+#include "Bloom.h"
+
+#include "triglav/graphics_api/Device.h"
+#include "triglav/graphics_api/PipelineBuilder.h"
+
+#include <algorithm>
+#include <glm/vec2.hpp>
+
+namespace triglav::renderer::node {
+
+using namespace name_literals;
+
+using graphics_api::CommandList;
+using graphics_api::DescriptorType;
+using graphics_api::Device;
+using graphics_api::PipelineStage;
+using graphics_api::Resolution;
+using graphics_api::SampleCount;
+using graphics_api::Texture;
+using graphics_api::TextureBarrierInfo;
+using graphics_api::TextureState;
+using graphics_api::TextureUsage;
+using graphics_api::WorkType;
+using render_core::FrameResources;
+using render_core::NodeFrameResources;
+
+namespace {
+
+constexpr u32 g_workgroupSize = 8;
+// One timestamp before the first pass and one after each downsample and upsample pass.
+constexpr u32 g_timestampCount = 2 * g_bloomLevelCount;
+
+struct DownsamplePushConstants
+{
+   glm::ivec2 targetSize;
+   u32 highQuality;
+   u32 isFirstLevel;
+};
+
+struct UpsamplePushConstants
+{
+   glm::ivec2 targetSize;
+   u32 highQuality;
+   float scale;
+};
+
+void dispatch_level(CommandList& cmdList, const Resolution& resolution)
+{
+   const auto groupCountX = (resolution.width + g_workgroupSize - 1) / g_workgroupSize;
+   const auto groupCountY = (resolution.height + g_workgroupSize - 1) / g_workgroupSize;
+   cmdList.dispatch(groupCountX, groupCountY, 1);
+}
+
+}// namespace
+
+BloomResources::BloomResources(Device& device) :
+    m_device(device)
+{
+}
+
+void BloomResources::update_resolution(const Resolution& resolution)
+{
+   const Resolution baseResolution{std::max(resolution.width / 2, 1u), std::max(resolution.height / 2, 1u)};
+
+   constexpr auto usage = TextureUsage::Storage | TextureUsage::Sampled;
+
+   m_downsampled.emplace(
+      GAPI_CHECK(m_device.create_texture(GAPI_FORMAT(RGBA, Float16), baseResolution, usage, SampleCount::Single, g_bloomLevelCount)));
+   m_upsampled.emplace(
+      GAPI_CHECK(m_device.create_texture(GAPI_FORMAT(RGBA, Float16), baseResolution, usage, SampleCount::Single, g_bloomLevelCount - 1)));
+}
+
+Texture& BloomResources::downsampled()
+{
+   assert(m_downsampled.has_value());
+   return *m_downsampled;
+}
+
+Texture& BloomResources::upsampled()
+{
+   assert(m_upsampled.has_value());
+   return *m_upsampled;
+}
+
+Bloom::Bloom(Device& device, resource::ResourceManager& resourceManager, Name srcNode, Name srcFramebuffer, Name srcAttachment) :
+    m_device(device),
+    m_downsamplePipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
+                                       .compute_shader(resourceManager.get("bloom_downsample.cshader"_rc))
+                                       .descriptor_binding(DescriptorType::ImageSampler)
+                                       .descriptor_binding(DescriptorType::StorageImage)
+                                       .push_constant(PipelineStage::ComputeShader, sizeof(DownsamplePushConstants))
+                                       .use_push_descriptors(true)
+                                       .build())),
+    m_upsamplePipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
+                                     .compute_shader(resourceManager.get("bloom_upsample.cshader"_rc))
+                                     .descriptor_binding(DescriptorType::ImageSampler)
+                                     .descriptor_binding(DescriptorType::ImageSampler)
+                                     .descriptor_binding(DescriptorType::StorageImage)
+                                     .push_constant(PipelineStage::ComputeShader, sizeof(UpsamplePushConstants))
+                                     .use_push_descriptors(true)
+                                     .build())),
+    m_timestampArray(GAPI_CHECK(device.create_timestamp_array(g_timestampCount))),
+    m_srcNode(srcNode),
+    m_srcFramebuffer(srcFramebuffer),
+    m_srcAttachment(srcAttachment)
+{
+}
+
+std::unique_ptr<NodeFrameResources> Bloom::create_node_resources()
+{
+   return std::make_unique<BloomResources>(m_device);
+}
+
+graphics_api::WorkTypeFlags Bloom::work_types() const
+{
+   // The source attachment and the result are exclusive to the graphics queue, the passes are recorded there to avoid
+   // transferring their ownership twice per frame.
+   return WorkType::Graphics;
+}
+
+void Bloom::record_commands(FrameResources& frameResources, NodeFrameResources& resources, CommandList& cmdList)
+{
+   auto& bloomResources = dynamic_cast<BloomResources&>(resources);
+
+   cmdList.reset_timestamp_array(m_timestampArray, 0, g_timestampCount);
+   cmdList.write_timestamp(PipelineStage::Entrypoint, m_timestampArray, 0);
+   m_passCount = 0;
+
+   if (not frameResources.has_flag("bloom"_name)) {
+      // Post processing still binds the result, it only needs to be in the right layout.
+      const TextureBarrierInfo barrier{
+         .texture = &bloomResources.upsampled(),
+         .sourceState = TextureState::Undefined,
+         .targetState = TextureState::ShaderRead,
+         .baseMipLevel = 0,
+         .mipLevelCount = 1,
+      };
+      cmdList.texture_barrier(PipelineStage::Entrypoint, PipelineStage::FragmentShader, barrier);
+      return;
+   }
+
+   const auto highQuality = frameResources.has_flag("bloom_high_quality"_name);
+   const auto levelCount = highQuality ? g_bloomLevelCount : g_bloomLowQualityLevelCount;
+
+   auto& framebuffer = frameResources.node(m_srcNode).framebuffer(m_srcFramebuffer);
+   this->downsample(cmdList, framebuffer.texture(m_srcAttachment), bloomResources, levelCount, highQuality);
+   this->upsample(cmdList, bloomResources, levelCount, highQuality);
+}
+
+float Bloom::gpu_time() const
+{
+   if (m_passCount == 0)
+      return 0.0f;
+   return m_timestampArray.get_difference(0, m_passCount);
+}
+
+u32 Bloom::pass_count() const
+{
+   return m_passCount;
+}
+
+void Bloom::downsample(CommandList& cmdList, const Texture& source, BloomResources& resources, const u32 levelCount,
+                       const bool highQuality)
+{
+   auto& downsampled = resources.downsampled();
+
+   const TextureBarrierInfo storageBarrier{
+      .texture = &downsampled,
+      .sourceState = TextureState::Undefined,
+      .targetState = TextureState::General,
+      .baseMipLevel = 0,
+      .mipLevelCount = static_cast<int>(levelCount),
+   };
+   cmdList.texture_barrier(PipelineStage::Entrypoint, PipelineStage::ComputeShader, storageBarrier);
+
+   cmdList.bind_pipeline(m_downsamplePipeline);
+
+   for (u32 level = 0; level < levelCount; ++level) {
+      const auto mipLevel = static_cast<int>(level);
+      const auto targetResolution = downsampled.mip_resolution(mipLevel);
+
+      if (level == 0) {
+         cmdList.bind_texture(0, source);
+      } else {
+         cmdList.bind_texture_mip(0, downsampled, mipLevel - 1);
+      }
+      cmdList.bind_storage_images(1, downsampled, mipLevel, 1);
+
+      DownsamplePushConstants pushConstants{
+         .targetSize{static_cast<int>(targetResolution.width), static_cast<int>(targetResolution.height)},
+         .highQuality = highQuality,
+         .isFirstLevel = level == 0,
+      };
+      cmdList.push_constant(PipelineStage::ComputeShader, pushConstants);
+      dispatch_level(cmdList, targetResolution);
+
+      const TextureBarrierInfo readBarrier{
+         .texture = &downsampled,
+         .sourceState = TextureState::General,
+         .targetState = TextureState::ShaderRead,
+         .baseMipLevel = mipLevel,
+         .mipLevelCount = 1,
+      };
+      cmdList.texture_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader, readBarrier);
+
+      cmdList.write_timestamp(PipelineStage::ComputeShader, m_timestampArray, ++m_passCount);
+   }
+}
+
+void Bloom::upsample(CommandList& cmdList, BloomResources& resources, const u32 levelCount, const bool highQuality)
+{
+   auto& downsampled = resources.downsampled();
+   auto& upsampled = resources.upsampled();
+
+   const TextureBarrierInfo storageBarrier{
+      .texture = &upsampled,
+      .sourceState = TextureState::Undefined,
+      .targetState = TextureState::General,
+      .baseMipLevel = 0,
+      .mipLevelCount = static_cast<int>(levelCount - 1),
+   };
+   cmdList.texture_barrier(PipelineStage::Entrypoint, PipelineStage::ComputeShader, storageBarrier);
+
+   cmdList.bind_pipeline(m_upsamplePipeline);
+
+   // The smallest level is accumulated into the level above it, down to level 0.
+   for (int mipLevel = static_cast<int>(levelCount) - 2; mipLevel >= 0; --mipLevel) {
+      const auto targetResolution = upsampled.mip_resolution(mipLevel);
+      const auto isLowestLevel = mipLevel == static_cast<int>(levelCount) - 2;
+
+      cmdList.bind_texture_mip(0, isLowestLevel ? downsampled : upsampled, mipLevel + 1);
+      cmdList.bind_texture_mip(1, downsampled, mipLevel);
+      cmdList.bind_storage_images(2, upsampled, mipLevel, 1);
+
+      // Each level adds its own contribution, the final level averages them.
+      UpsamplePushConstants pushConstants{
+         .targetSize{static_cast<int>(targetResolution.width), static_cast<int>(targetResolution.height)},
+         .highQuality = highQuality,
+         .scale = mipLevel == 0 ? 1.0f / static_cast<float>(levelCount) : 1.0f,
+      };
+      cmdList.push_constant(PipelineStage::ComputeShader, pushConstants);
+      dispatch_level(cmdList, targetResolution);
+
+      const TextureBarrierInfo readBarrier{
+         .texture = &upsampled,
+         .sourceState = TextureState::General,
+         .targetState = TextureState::ShaderRead,
+         .baseMipLevel = mipLevel,
+         .mipLevelCount = 1,
+      };
+      cmdList.texture_barrier(PipelineStage::ComputeShader, mipLevel == 0 ? PipelineStage::FragmentShader : PipelineStage::ComputeShader,
+                              readBarrier);
+
+      cmdList.write_timestamp(PipelineStage::ComputeShader, m_timestampArray, ++m_passCount);
+   }
+}
+
+}// namespace triglav::renderer::node
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "triglav/graphics_api/Pipeline.h"
+#include "triglav/graphics_api/Texture.h"
+#include "triglav/graphics_api/TimestampArray.h"
+#include "triglav/render_core/FrameResources.h"
+#include "triglav/render_core/IRenderNode.hpp"
+#include "triglav/resource/ResourceManager.h"
+
+#include <optional>
+
+namespace triglav::renderer::node {
+
+// Number of levels of the bloom pyramid, level 0 is half of the render resolution.
+constexpr u32 g_bloomLevelCount = 6;
+// Levels used when the bloom_high_quality flag is off.
+constexpr u32 g_bloomLowQualityLevelCount = 4;
+
+class BloomResources : public render_core::NodeFrameResources
+{
+ public:
+   explicit BloomResources(graphics_api::Device& device);
+
+   void update_resolution(const graphics_api::Resolution& resolution) override;
+
+   // Downsampled levels of the bloom source.
+   [[nodiscard]] graphics_api::Texture& downsampled();
+   // Accumulated levels, level 0 holds the final bloom.
+   [[nodiscard]] graphics_api::Texture& upsampled();
+
+ private:
+   graphics_api::Device& m_device;
+   std::optional<graphics_api::Texture> m_downsampled;
+   std::optional<graphics_api::Texture> m_upsampled;
+};
+
+class Bloom : public render_core::IRenderNode
+{
+ public:
+   Bloom(graphics_api::Device& device, resource::ResourceManager& resourceManager, Name srcNode, Name srcFramebuffer, Name srcAttachment);
+
+   std::unique_ptr<render_core::NodeFrameResources> create_node_resources() override;
+   [[nodiscard]] graphics_api::WorkTypeFlags work_types() const override;
+   void record_commands(render_core::FrameResources& frameResources, render_core::NodeFrameResources& resources,
+                        graphics_api::CommandList& cmdList) override;
+
+   [[nodiscard]] float gpu_time() const;
+   [[nodiscard]] u32 pass_count() const;
+
+ private:
+   void downsample(graphics_api::CommandList& cmdList, const graphics_api::Texture& source, BloomResources& resources, u32 levelCount,
+                   bool highQuality);
+   void upsample(graphics_api::CommandList& cmdList, BloomResources& resources, u32 levelCount, bool highQuality);
+
+   graphics_api::Device& m_device;
+   graphics_api::Pipeline m_downsamplePipeline;
+   graphics_api::Pipeline m_upsamplePipeline;
+   graphics_api::TimestampArray m_timestampArray;
+   Name m_srcNode;
+   Name m_srcFramebuffer;
+   Name m_srcAttachment;
+   u32 m_passCount{};
+};
+
+}// namespace triglav::renderer::node
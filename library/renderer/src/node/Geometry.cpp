@@ -2,6 +2,7 @@
 
 #include "triglav/graphics_api/Framebuffer.h"
 #include "triglav/graphics_api/PipelineBuilder.h"
+#include "triglav/resource/TextureStreamer.h"
 
 #include <ranges>
 
@@ -14,12 +15,13 @@ class GeometryResources : public IGeometryResources
 {
  public:
    GeometryResources(graphics_api::Device& device, resource::ResourceManager& resourceManager, MaterialManager& materialManager,
-                     Scene& scene, DebugLinesRenderer& debugLinesRenderer) :
+                     Scene& scene, DebugLinesRenderer& debugLinesRenderer, graphics_api::Pipeline& depthPrepassPipeline) :
        m_device(device),
        m_resourceManager(resourceManager),
        m_materialManager(materialManager),
        m_scene(scene),
        m_debugLinesRenderer(debugLinesRenderer),
+       m_depthPrepassPipeline(depthPrepassPipeline),
        m_groundUniformBuffer(m_device),
        m_skyboxUniformBuffer(m_device),
        m_onAddedObjectSink(scene.OnObjectAddedToScene.connect<&GeometryResources::on_object_added_to_scene>(this)),
@@ -31,15 +33,23 @@ class GeometryResources : public IGeometryResources
 
    void on_object_added_to_scene(const SceneObject& object)
    {
-      const auto& model = m_resourceManager.get<ResourceType::Model>(object.model);
+      const auto modelHandle = m_resourceManager.handle<ResourceType::Model>(object.model);
+      const auto& model = m_resourceManager.get(modelHandle);
       graphics_api::UniformBuffer<render_core::UniformBufferObject> ubo(m_device);
 
+      std::vector<MaterialHandle> materials;
+      materials.reserve(model.range.size());
+      for (const auto& range : model.range) {
+         materials.emplace_back(m_resourceManager.handle<ResourceType::Material>(range.materialName));
+      }
+
       const auto modelMat = object.model_matrix();
       ubo->model = modelMat;
       ubo->normal = glm::transpose(glm::inverse(glm::mat3(modelMat)));
 
       m_models.emplace_back(render_core::InstancedModel{
-         object.model,
+         modelHandle,
+         std::move(materials),
          model.boundingBox,
          object.position,
          std::move(ubo),
@@ -65,22 +75,24 @@ class GeometryResources : public IGeometryResources
       }
    }
 
-   void draw_model(graphics_api::CommandList& cmdList, const render_core::InstancedModel& instancedModel)
+   void draw_model(graphics_api::CommandList& cmdList, const render_core::InstancedModel& instancedModel, const bool isDepthLaidOut)
    {
-      const auto& model = m_resourceManager.get<ResourceType::Model>(instancedModel.modelName);
+      const auto& model = m_resourceManager.get(instancedModel.model);
 
       cmdList.bind_vertex_array(model.mesh.vertices);
       cmdList.bind_index_array(model.mesh.indices);
 
-      for (const auto& range : model.range) {
+      for (MemorySize rangeIndex = 0; rangeIndex < model.range.size(); ++rangeIndex) {
+         const auto& range = model.range[rangeIndex];
+         const auto material = instancedModel.materials[rangeIndex];
          cmdList.bind_uniform_buffer(0, instancedModel.ubo);
 
-         if (not m_lastMaterial.has_value() || *m_lastMaterial != range.materialName) {
-            const auto& matResources = m_materialManager.material_resources(range.materialName);
+         if (not m_lastMaterial.has_value() || *m_lastMaterial != material) {
+            const auto& matResources = m_materialManager.material_resources(material);
 
             if (not m_lastMaterialTemplate.has_value() || *m_lastMaterialTemplate != matResources.materialTemplate) {
                const auto& matTemplateResources = m_materialManager.material_template_resources(matResources.materialTemplate);
-               cmdList.bind_pipeline(matTemplateResources.pipeline);
+               cmdList.bind_pipeline(isDepthLaidOut ? matTemplateResources.depthEqualPipeline : matTemplateResources.pipeline);
                m_lastMaterialTemplate = matResources.materialTemplate;
 
                render_core::FragmentPushConstants pushConstants{
@@ -91,8 +103,8 @@ class GeometryResources : public IGeometryResources
 
             u32 binding = 1;
 
-            for (const auto textureName : matResources.textures) {
-               const auto& texture = m_resourceManager.get(textureName);
+            for (const auto textureHandle : matResources.textures) {
+               const auto& texture = m_resourceManager.get(textureHandle);
                cmdList.bind_texture(binding, texture);
                ++binding;
             }
@@ -101,14 +113,44 @@ class GeometryResources : public IGeometryResources
                cmdList.bind_raw_uniform_buffer(binding, *matResources.uniformBuffer);
             }
 
-            m_lastMaterial = range.materialName;
+            m_lastMaterial = material;
          }
 
          cmdList.draw_indexed_primitives(static_cast<int>(range.size), static_cast<int>(range.offset), 0);
       }
    }
 
-   void draw_scene_models(graphics_api::CommandList& cmdList)
+   void draw_depth_prepass(graphics_api::CommandList& cmdList)
+   {
+      if (m_needsUpdate) {
+         m_needsUpdate = false;
+         this->update_uniforms();
+      }
+
+      cmdList.bind_pipeline(m_depthPrepassPipeline);
+
+      for (const auto& obj : m_models) {
+         if (not m_scene.camera().is_bounding_box_visible(obj.boundingBox, obj.ubo->model))
+            continue;
+
+         const auto& model = m_resourceManager.get(obj.model);
+
+         cmdList.bind_vertex_array(model.mesh.vertices);
+         cmdList.bind_index_array(model.mesh.indices);
+         cmdList.bind_uniform_buffer(0, obj.ubo);
+
+         // Material ranges are contiguous, so the whole model is drawn at once.
+         const auto firstOffset = model.range[0].offset;
+         size_t size{};
+         for (const auto& range : model.range) {
+            size += range.size;
+         }
+
+         cmdList.draw_indexed_primitives(static_cast<int>(size), static_cast<int>(firstOffset), 0);
+      }
+   }
+
+   void draw_scene_models(graphics_api::CommandList& cmdList, const bool isDepthLaidOut)
    {
       if (m_needsUpdate) {
          m_needsUpdate = false;
@@ -122,7 +164,34 @@ class GeometryResources : public IGeometryResources
          if (not m_scene.camera().is_bounding_box_visible(obj.boundingBox, obj.ubo->model))
             continue;
 
-         this->draw_model(cmdList, obj);
+         this->draw_model(cmdList, obj, isDepthLaidOut);
+      }
+   }
+
+   // Marks the resources of the visible models as used, the least recently drawn ones are unloaded first. Also reports the
+   // screen area covered by each visible model to the streamer, which selects the mip levels of its material textures.
+   void report_resource_use(const graphics_api::Resolution& resolution)
+   {
+      auto* textureStreamer = m_resourceManager.texture_streamer();
+      const auto viewportArea = static_cast<float>(resolution.width) * static_cast<float>(resolution.height);
+
+      for (const auto& obj : m_models) {
+         if (not m_scene.camera().is_bounding_box_visible(obj.boundingBox, obj.ubo->model))
+            continue;
+
+         m_resourceManager.mark_used(obj.model);
+
+         const auto screenArea =
+            textureStreamer != nullptr ? m_scene.camera().screen_coverage(obj.boundingBox, obj.ubo->model) * viewportArea : 0.0f;
+         for (const auto material : obj.materials) {
+            m_resourceManager.mark_used(material);
+            for (const auto textureHandle : m_materialManager.material_resources(material).textures) {
+               m_resourceManager.mark_used(textureHandle);
+               if (textureStreamer != nullptr) {
+                  textureStreamer->report_demand(m_resourceManager.name(textureHandle), screenArea);
+               }
+            }
+         }
       }
    }
 
@@ -150,12 +219,13 @@ class GeometryResources : public IGeometryResources
    MaterialManager& m_materialManager;
    Scene& m_scene;
    DebugLinesRenderer& m_debugLinesRenderer;
+   graphics_api::Pipeline& m_depthPrepassPipeline;
    std::vector<render_core::InstancedModel> m_models{};
    std::vector<DebugLines> m_debugLines{};
    bool m_needsUpdate{false};
    GroundRenderer::UniformBuffer m_groundUniformBuffer;
    SkyBox::UniformBuffer m_skyboxUniformBuffer;
-   std::optional<MaterialName> m_lastMaterial;
+   std::optional<MaterialHandle> m_lastMaterial;
    std::optional<MaterialTemplateName> m_lastMaterialTemplate;
 
    Scene::OnObjectAddedToSceneDel::Sink<GeometryResources> m_onAddedObjectSink;
@@ -169,20 +239,29 @@ Geometry::Geometry(graphics_api::Device& device, resource::ResourceManager& reso
     m_renderTarget(GAPI_CHECK(
        graphics_api::RenderTargetBuilder(device)
           .attachment("albedo"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
-                      GAPI_FORMAT(RGBA, Float16))
-          .attachment("position"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
-                      GAPI_FORMAT(RGBA, Float16))
+                      GAPI_FORMAT(RGBA, UNorm16))
           .attachment("normal"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
-                      GAPI_FORMAT(RGBA, Float16))
-          .attachment("depth"_name,
-                      AttachmentAttribute::Depth | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage |
-                         AttachmentAttribute::TransferSrc,
-                      GAPI_FORMAT(D, UNorm16))
+                      GAPI_FORMAT(RG, UNorm16))
+          .attachment("depth"_name, AttachmentAttribute::Depth | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
+                      GAPI_FORMAT(D, Float32))
           .build())),
     m_materialManager(device, m_resourceManager, m_renderTarget),
     m_skybox(device, resourceManager, m_renderTarget),
     m_groundRenderer(device, m_renderTarget, resourceManager),
     m_debugLinesRenderer(device, m_renderTarget, resourceManager),
+    m_depthPrepassPipeline(GAPI_CHECK(graphics_api::GraphicsPipelineBuilder(device, m_renderTarget)
+                                         .fragment_shader(resourceManager.get("depth_prepass.fshader"_rc))
+                                         .vertex_shader(resourceManager.get("depth_prepass.vshader"_rc))
+                                         .begin_vertex_layout<geometry::Vertex>()
+                                         .vertex_attribute(GAPI_FORMAT(RGB, Float32), offsetof(geometry::Vertex, location))
+                                         .end_vertex_layout()
+                                         .descriptor_binding(graphics_api::DescriptorType::UniformBuffer,
+                                                             graphics_api::PipelineStage::VertexShader)
+                                         .enable_depth_test(true)
+                                         .enable_blending(false)
+                                         .enable_color_write(false)
+                                         .use_push_descriptors(true)
+                                         .build())),
     m_timestampArray(GAPI_CHECK(device.create_timestamp_array(2)))
 {
 }
@@ -200,8 +279,10 @@ void Geometry::record_commands(render_core::FrameResources& frameResources, rend
    cmdList.reset_timestamp_array(m_timestampArray, 0, 2);
    cmdList.write_timestamp(graphics_api::PipelineStage::Entrypoint, m_timestampArray, 0);
 
-   std::array<graphics_api::ClearValue, 4> clearValues{
-      graphics_api::ColorPalette::Black,
+   // Synced by the sync_buffers node, which may run on a dedicated transfer queue.
+   geoResources.ground_ubo().acquire(cmdList, graphics_api::PipelineStage::VertexShader);
+
+   std::array<graphics_api::ClearValue, 3> clearValues{
       graphics_api::ColorPalette::Black,
       graphics_api::ColorPalette::Black,
       graphics_api::DepthStenctilValue{1.0f, 0},
@@ -210,12 +291,18 @@ void Geometry::record_commands(render_core::FrameResources& frameResources, rend
    auto& framebuffer = resources.framebuffer("gbuffer"_name);
    cmdList.begin_render_pass(framebuffer, clearValues);
 
+   const auto isDepthPrepassEnabled = frameResources.has_flag("depth_prepass"_name);
+   if (isDepthPrepassEnabled) {
+      geoResources.draw_depth_prepass(cmdList);
+   }
+
    m_skybox.on_render(cmdList, geoResources.skybox_ubo(), m_scene.yaw(), m_scene.pitch(),
                       static_cast<float>(framebuffer.resolution().width), static_cast<float>(framebuffer.resolution().height));
 
    m_groundRenderer.draw(cmdList, geoResources.ground_ubo());
 
-   geoResources.draw_scene_models(cmdList);
+   geoResources.report_resource_use(framebuffer.resolution());
+   geoResources.draw_scene_models(cmdList, isDepthPrepassEnabled);
 
    if (frameResources.has_flag("debug_lines"_name)) {
       geoResources.draw_debug_lines(cmdList);
@@ -228,7 +315,8 @@ void Geometry::record_commands(render_core::FrameResources& frameResources, rend
 
 std::unique_ptr<render_core::NodeFrameResources> Geometry::create_node_resources()
 {
-   auto result = std::make_unique<GeometryResources>(m_device, m_resourceManager, m_materialManager, m_scene, m_debugLinesRenderer);
+   auto result = std::make_unique<GeometryResources>(m_device, m_resourceManager, m_materialManager, m_scene, m_debugLinesRenderer,
+                                                     m_depthPrepassPipeline);
    result->add_render_target("gbuffer"_name, m_renderTarget);
    return result;
 }
@@ -243,4 +331,13 @@ const GroundRenderer& Geometry::ground_renderer() const
    return m_groundRenderer;
 }
 
+u64 Geometry::gbuffer_bandwidth(const graphics_api::Resolution& resolution) const
+{
+   u64 pixelSize{};
+   for (const auto& attachment : m_renderTarget.attachments()) {
+      pixelSize += attachment.format.pixel_size();
+   }
+   return 2 * pixelSize * resolution.width * resolution.height;
+}
+
 }// namespace triglav::renderer::node
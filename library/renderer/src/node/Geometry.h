@@ -28,6 +28,8 @@ class Geometry : public render_core::IRenderNode
 
    [[nodiscard]] float gpu_time() const;
    [[nodiscard]] const GroundRenderer& ground_renderer() const;
+   // Estimated bytes moved through the G-buffer per frame: written by this pass and read back by shading.
+   [[nodiscard]] u64 gbuffer_bandwidth(const graphics_api::Resolution& resolution) const;
 
  private:
    graphics_api::Device& m_device;
@@ -38,6 +40,7 @@ class Geometry : public render_core::IRenderNode
    SkyBox m_skybox;
    GroundRenderer m_groundRenderer;
    DebugLinesRenderer m_debugLinesRenderer;
+   graphics_api::Pipeline m_depthPrepassPipeline;
    graphics_api::TimestampArray m_timestampArray;
 };
 
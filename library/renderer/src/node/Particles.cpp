@@ -1,13 +1,12 @@
 #include "Particles.h"
 
-#include "triglav/geometry/Geometry.h"
 #include "triglav/graphics_api/Device.h"
 #include "triglav/graphics_api/PipelineBuilder.h"
+#include "triglav/render_core/ParticleEmitter.hpp"
 #include "triglav/render_core/RenderGraph.h"
 
-#include <glm/vec3.hpp>
-
-#include <random>
+#include <algorithm>
+#include <numeric>
 
 namespace triglav::renderer::node {
 
@@ -16,51 +15,69 @@ using graphics_api::BufferUsage;
 using graphics_api::DescriptorType;
 using graphics_api::PipelineStage;
 
-struct PushConstants
+namespace {
+
+constexpr u32 g_emitGroupSize = 64;
+
+struct SimulatePushConstants
 {
    float deltaTime;
-   u32 randomValue;
 };
 
-constexpr u32 g_particleCount = 256;
-
-struct Particle
+struct EmitPushConstants
 {
-   alignas(16) glm::vec3 position;
-   alignas(16) glm::vec3 velocity;
-   float animation;
-   float rotation;
-   float angularVelocity;
-   float scale;
+   u32 spawnCount;
+   u32 emitterCount;
 };
 
-static graphics_api::Buffer generate_particles(graphics_api::Device& device, const glm::vec3& center, const glm::vec3& range)
+struct FinalizePushConstants
 {
-   std::vector<Particle> particles;
-   particles.resize(g_particleCount);
-
-   std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-   std::default_random_engine generator{};
+   u32 spawnCount;
+};
 
-   for (auto& particle : particles) {
-      particle.position = center + range * glm::vec3(dist(generator), dist(generator), dist(generator));
-      particle.velocity = glm::vec3(dist(generator), dist(generator), 0.0f) * 0.01f;
-      particle.animation = 0.5f * (1.0f + dist(generator));
-      particle.rotation = 2.0f * geometry::g_pi * dist(generator);
-      particle.angularVelocity = dist(generator);
-      particle.scale = 0.5f + (1.0f + dist(generator));
-   }
+template<typename TValue>
+graphics_api::Buffer create_initialized_buffer(graphics_api::Device& device, const graphics_api::BufferUsageFlags usage,
+                                              const std::span<const TValue> values)
+{
+   auto buffer = GAPI_CHECK(device.create_buffer(usage | BufferUsage::TransferDst, values.size_bytes()));
+   GAPI_CHECK_STATUS(buffer.write_indirect(values.data(), values.size_bytes()));
+   return buffer;
+}
 
-   auto buffer =
-      GAPI_CHECK(device.create_buffer(BufferUsage::StorageBuffer | BufferUsage::TransferDst, sizeof(Particle) * particles.size()));
-   GAPI_CHECK_STATUS(buffer.write_indirect(particles.data(), sizeof(Particle) * particles.size()));
+// All the slots start in the dead list, so the first frame reads a valid empty state.
+graphics_api::Buffer create_dead_list(graphics_api::Device& device)
+{
+   std::vector<u32> slots(g_maxParticleCount);
+   std::iota(slots.begin(), slots.end(), 0);
+   return create_initialized_buffer<u32>(device, BufferUsage::StorageBuffer, slots);
+}
 
-   return buffer;
+ParticleEmitterState to_emitter_state(const render_core::ParticleEmitter& emitter, const glm::vec3& position)
+{
+   return ParticleEmitterState{
+      .emitter{
+         .position{position, 0.0f},
+         .extent{emitter.extent, emitter.lifetime},
+         .velocity{emitter.velocity, emitter.velocityRandomness},
+         .properties{emitter.lifetimeRandomness, emitter.angularVelocity, emitter.scale, emitter.gravity},
+         .spawn{},
+      },
+      .spawnRate = emitter.spawnRate,
+   };
 }
 
+}// namespace
+
 ParticlesResources::ParticlesResources(graphics_api::Device& device) :
-    m_device(device),
-    m_particlesBuffer(generate_particles(m_device, {-30, 0, -30}, {2, 2, 2}))
+    m_particlesBuffer(GAPI_CHECK(device.create_buffer(BufferUsage::StorageBuffer, sizeof(particles::Particle) * g_maxParticleCount))),
+    m_aliveBuffer(GAPI_CHECK(device.create_buffer(BufferUsage::StorageBuffer, sizeof(u32) * g_maxParticleCount))),
+    m_countersBuffer(create_initialized_buffer<particles::ParticleCounters>(device, BufferUsage::StorageBuffer,
+                                                                            std::array{particles::ParticleCounters{0, g_maxParticleCount}})),
+    m_drawCallBuffer(create_initialized_buffer<graphics_api::DrawIndirectCommand>(
+       device, BufferUsage::StorageBuffer | BufferUsage::Indirect, std::array{graphics_api::DrawIndirectCommand{4, 0, 0, 0}})),
+    m_simulateDispatchBuffer(create_initialized_buffer<graphics_api::DispatchIndirectCommand>(
+       device, BufferUsage::StorageBuffer | BufferUsage::Indirect, std::array{graphics_api::DispatchIndirectCommand{0, 1, 1}})),
+    m_emitters(device)
 {
 }
 
@@ -69,16 +86,74 @@ graphics_api::Buffer& ParticlesResources::particles_buffer()
    return m_particlesBuffer;
 }
 
-Particles::Particles(graphics_api::Device& device, resource::ResourceManager& resourceManager, render_core::RenderGraph& renderGraph) :
+graphics_api::Buffer& ParticlesResources::alive_buffer()
+{
+   return m_aliveBuffer;
+}
+
+graphics_api::Buffer& ParticlesResources::counters_buffer()
+{
+   return m_countersBuffer;
+}
+
+graphics_api::Buffer& ParticlesResources::draw_call_buffer()
+{
+   return m_drawCallBuffer;
+}
+
+graphics_api::Buffer& ParticlesResources::simulate_dispatch_buffer()
+{
+   return m_simulateDispatchBuffer;
+}
+
+ParticleEmitterBuffer& ParticlesResources::emitters()
+{
+   return m_emitters;
+}
+
+Particles::Particles(graphics_api::Device& device, resource::ResourceManager& resourceManager, render_core::RenderGraph& renderGraph,
+                     Scene& scene) :
     m_device(device),
+    m_resourceManager(resourceManager),
     m_renderGraph(renderGraph),
-    m_computePipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
-                                    .compute_shader(resourceManager.get("particles.cshader"_rc))
-                                    .descriptor_binding(DescriptorType::StorageBuffer)
-                                    .descriptor_binding(DescriptorType::StorageBuffer)
-                                    .push_constant(PipelineStage::ComputeShader, sizeof(PushConstants))
-                                    .use_push_descriptors(true)
-                                    .build()))
+    m_scene(scene),
+    m_deadBuffer(create_dead_list(device)),
+    m_resetPipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
+                                  .compute_shader(resourceManager.get("particles_reset.cshader"_rc))
+                                  .descriptor_binding(DescriptorType::StorageBuffer)
+                                  .descriptor_binding(DescriptorType::StorageBuffer)
+                                  .use_push_descriptors(true)
+                                  .build())),
+    m_simulatePipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
+                                     .compute_shader(resourceManager.get("particles_simulate.cshader"_rc))
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .push_constant(PipelineStage::ComputeShader, sizeof(SimulatePushConstants))
+                                     .use_push_descriptors(true)
+                                     .build())),
+    m_emitPipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
+                                 .compute_shader(resourceManager.get("particles_emit.cshader"_rc))
+                                 .descriptor_binding(DescriptorType::StorageBuffer)
+                                 .descriptor_binding(DescriptorType::StorageBuffer)
+                                 .descriptor_binding(DescriptorType::StorageBuffer)
+                                 .descriptor_binding(DescriptorType::StorageBuffer)
+                                 .descriptor_binding(DescriptorType::StorageBuffer)
+                                 .push_constant(PipelineStage::ComputeShader, sizeof(EmitPushConstants))
+                                 .use_push_descriptors(true)
+                                 .build())),
+    m_finalizePipeline(GAPI_CHECK(graphics_api::ComputePipelineBuilder(device)
+                                     .compute_shader(resourceManager.get("particles_finalize.cshader"_rc))
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .descriptor_binding(DescriptorType::StorageBuffer)
+                                     .push_constant(PipelineStage::ComputeShader, sizeof(FinalizePushConstants))
+                                     .use_push_descriptors(true)
+                                     .build()))
 {
 }
 
@@ -103,19 +178,74 @@ void Particles::record_commands(render_core::FrameResources& frameResources, ren
    auto& currentResources = dynamic_cast<ParticlesResources&>(resources);
    auto& previousResources = dynamic_cast<ParticlesResources&>(m_renderGraph.previous_frame_resources().node("particles"_name));
 
-   cmdList.bind_pipeline(m_computePipeline);
-   cmdList.bind_storage_buffer(0, previousResources.particles_buffer());
-   cmdList.bind_storage_buffer(1, currentResources.particles_buffer());
+   this->update_emitters();
 
-   std::uniform_int_distribution<u32> dist(0, std::numeric_limits<u32>::max());
+   const auto emitterCount = static_cast<u32>(m_emitters.size());
+   const auto spawnCount = std::min(schedule_particle_spawns(m_emitters, m_deltaTime, m_frameIndex++), g_maxParticleCount);
+   std::ranges::transform(m_emitters, currentResources.emitters()->begin(), [](const ParticleEmitterState& state) { return state.emitter; });
 
-   PushConstants pushConstants{
+   cmdList.bind_pipeline(m_resetPipeline);
+   cmdList.bind_storage_buffer(0, previousResources.counters_buffer());
+   cmdList.bind_storage_buffer(1, currentResources.counters_buffer());
+   cmdList.dispatch(1, 1, 1);
+
+   cmdList.memory_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader);
+
+   // Update the particles alive in the previous frame, the dispatch is sized by the previous frame's alive count.
+   SimulatePushConstants simulatePushConstants{
       .deltaTime = m_deltaTime,
-      .randomValue = dist(m_randomEngine),
    };
-   cmdList.push_constant(PipelineStage::ComputeShader, pushConstants);
+   cmdList.bind_pipeline(m_simulatePipeline);
+   cmdList.bind_storage_buffer(0, previousResources.particles_buffer());
+   cmdList.bind_storage_buffer(1, previousResources.alive_buffer());
+   cmdList.bind_storage_buffer(2, previousResources.counters_buffer());
+   cmdList.bind_storage_buffer(3, currentResources.particles_buffer());
+   cmdList.bind_storage_buffer(4, currentResources.alive_buffer());
+   cmdList.bind_storage_buffer(5, m_deadBuffer);
+   cmdList.bind_storage_buffer(6, currentResources.counters_buffer());
+   cmdList.push_constant(PipelineStage::ComputeShader, simulatePushConstants);
+   cmdList.dispatch_indirect(previousResources.simulate_dispatch_buffer());
+
+   cmdList.memory_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader);
+
+   if (spawnCount > 0) {
+      EmitPushConstants emitPushConstants{
+         .spawnCount = spawnCount,
+         .emitterCount = emitterCount,
+      };
+      cmdList.bind_pipeline(m_emitPipeline);
+      cmdList.bind_storage_buffer(0, currentResources.emitters().buffer());
+      cmdList.bind_storage_buffer(1, currentResources.particles_buffer());
+      cmdList.bind_storage_buffer(2, currentResources.alive_buffer());
+      cmdList.bind_storage_buffer(3, m_deadBuffer);
+      cmdList.bind_storage_buffer(4, currentResources.counters_buffer());
+      cmdList.push_constant(PipelineStage::ComputeShader, emitPushConstants);
+      cmdList.dispatch((spawnCount + g_emitGroupSize - 1) / g_emitGroupSize, 1, 1);
+
+      cmdList.memory_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader);
+   }
 
+   FinalizePushConstants finalizePushConstants{
+      .spawnCount = spawnCount,
+   };
+   cmdList.bind_pipeline(m_finalizePipeline);
+   cmdList.bind_storage_buffer(0, currentResources.counters_buffer());
+   cmdList.bind_storage_buffer(1, currentResources.draw_call_buffer());
+   cmdList.bind_storage_buffer(2, currentResources.simulate_dispatch_buffer());
+   cmdList.push_constant(PipelineStage::ComputeShader, finalizePushConstants);
    cmdList.dispatch(1, 1, 1);
 }
 
-}// namespace triglav::renderer::node
\ No newline at end of file
+void Particles::update_emitters()
+{
+   const auto sceneEmitters = m_scene.particle_emitters();
+   const auto emitterCount = std::min<size_t>(sceneEmitters.size(), g_maxParticleEmitters);
+
+   // Emitters are only ever added to the scene.
+   for (auto index = m_emitters.size(); index < emitterCount; ++index) {
+      const auto& sceneEmitter = sceneEmitters[index];
+      m_emitters.emplace_back(to_emitter_state(m_resourceManager.get(sceneEmitter.emitter), sceneEmitter.position));
+   }
+}
+
+}// namespace triglav::renderer::node
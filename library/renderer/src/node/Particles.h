@@ -1,31 +1,56 @@
 #pragma once
 
+#include "triglav/graphics_api/HostVisibleBuffer.hpp"
 #include "triglav/render_core/IRenderNode.hpp"
 #include "triglav/resource/ResourceManager.h"
 
-#include <glm/mat4x4.hpp>
-#include <random>
+#include "ParticleSimulation.h"
+#include "Scene.h"
+
+#include <array>
+#include <vector>
 
 namespace triglav::render_core {
 class RenderGraph;
 }
 namespace triglav::renderer::node {
 
+// Size of the particle pool shared by all emitters.
+constexpr u32 g_maxParticleCount = 256 * 1024;
+constexpr u32 g_maxParticleEmitters = 64;
+
+using ParticleEmitterBuffer =
+   graphics_api::HostVisibleBuffer<graphics_api::BufferUsage::StorageBuffer, std::array<particles::ParticleEmitter, g_maxParticleEmitters>>;
+
 class ParticlesResources : public render_core::NodeFrameResources
 {
  public:
    explicit ParticlesResources(graphics_api::Device& device);
+
    [[nodiscard]] graphics_api::Buffer& particles_buffer();
+   // Pool slots of the live particles, compacted every frame.
+   [[nodiscard]] graphics_api::Buffer& alive_buffer();
+   [[nodiscard]] graphics_api::Buffer& counters_buffer();
+   // Indirect draw call with the instance count set to the number of live particles.
+   [[nodiscard]] graphics_api::Buffer& draw_call_buffer();
+   // Indirect dispatch of the next frame's simulate shader, one invocation per live particle.
+   [[nodiscard]] graphics_api::Buffer& simulate_dispatch_buffer();
+   [[nodiscard]] ParticleEmitterBuffer& emitters();
 
  private:
-   graphics_api::Device& m_device;
    graphics_api::Buffer m_particlesBuffer;
+   graphics_api::Buffer m_aliveBuffer;
+   graphics_api::Buffer m_countersBuffer;
+   graphics_api::Buffer m_drawCallBuffer;
+   graphics_api::Buffer m_simulateDispatchBuffer;
+   ParticleEmitterBuffer m_emitters;
 };
 
 class Particles : public render_core::IRenderNode
 {
  public:
-   Particles(graphics_api::Device& device, resource::ResourceManager& resourceManager, render_core::RenderGraph& renderGraph);
+   Particles(graphics_api::Device& device, resource::ResourceManager& resourceManager, render_core::RenderGraph& renderGraph,
+             Scene& scene);
 
    [[nodiscard]] graphics_api::WorkTypeFlags work_types() const override;
    std::unique_ptr<render_core::NodeFrameResources> create_node_resources() override;
@@ -34,10 +59,20 @@ class Particles : public render_core::IRenderNode
    void set_delta_time(float value);
 
  private:
+   void update_emitters();
+
    graphics_api::Device& m_device;
+   resource::ResourceManager& m_resourceManager;
    render_core::RenderGraph& m_renderGraph;
-   graphics_api::Pipeline m_computePipeline;
-   std::default_random_engine m_randomEngine;
+   Scene& m_scene;
+   // Free pool slots, used as a stack shared by all the frames. Frames are serialized by the interframe dependency.
+   graphics_api::Buffer m_deadBuffer;
+   graphics_api::Pipeline m_resetPipeline;
+   graphics_api::Pipeline m_simulatePipeline;
+   graphics_api::Pipeline m_emitPipeline;
+   graphics_api::Pipeline m_finalizePipeline;
+   std::vector<ParticleEmitterState> m_emitters;
+   u32 m_frameIndex{};
    float m_deltaTime{0.0166};
 };
 
@@ -1,9 +1,13 @@
 #include "Shading.h"
 #include "Particles.h"
-#include "TextureHelper.h"
 
 #include "triglav/graphics_api/PipelineBuilder.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/glm.hpp>
+
 namespace triglav::renderer::node {
 
 using graphics_api::AttachmentAttribute;
@@ -14,12 +18,35 @@ using graphics_api::TextureState;
 
 using namespace name_literals;
 
-constexpr geometry::BoundingBox g_particlesBoundingBox{
-   {-31.0f, -1.0f, -50.0f},
-   {-29.0f, 1.0f, 0.0f},
-};
+ShadingResources::ShadingResources(graphics_api::Device& device) :
+    m_lights(device),
+    m_clusters(device),
+    m_lightIndices(device)
+{
+}
+
+ClusteredLightBuffer& ShadingResources::lights()
+{
+   return m_lights;
+}
+
+LightClusterBuffer& ShadingResources::clusters()
+{
+   return m_clusters;
+}
+
+LightIndexBuffer& ShadingResources::light_indices()
+{
+   return m_lightIndices;
+}
+
+ShadingRenderer::ClusteredLightBuffers ShadingResources::light_buffers() const
+{
+   return {m_lights.buffer(), m_clusters.buffer(), m_lightIndices.buffer()};
+}
 
 Shading::Shading(graphics_api::Device& device, resource::ResourceManager& resourceManager, Scene& scene) :
+    m_device(device),
     m_shadingRenderTarget(GAPI_CHECK(
        graphics_api::RenderTargetBuilder(device)
           .attachment("shading"_name, AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage,
@@ -28,10 +55,6 @@ Shading::Shading(graphics_api::Device& device, resource::ResourceManager& resour
                       AttachmentAttribute::Color | AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage |
                          AttachmentAttribute::TransferSrc,
                       GAPI_FORMAT(RGBA, Float16), SampleCount::Single)
-          .attachment("depth"_name,
-                      AttachmentAttribute::Depth | AttachmentAttribute::LoadImage | AttachmentAttribute::StoreImage |
-                         AttachmentAttribute::TransferDst,
-                      GAPI_FORMAT(D, UNorm16))
           .build())),
     m_shadingRenderer(device, m_shadingRenderTarget, resourceManager),
     m_scene(scene),
@@ -43,7 +66,9 @@ Shading::Shading(graphics_api::Device& device, resource::ResourceManager& resour
                      .descriptor_binding(graphics_api::DescriptorType::UniformBuffer, graphics_api::PipelineStage::VertexShader)
                      .descriptor_binding(graphics_api::DescriptorType::StorageBuffer, graphics_api::PipelineStage::VertexShader)
                      .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
-                     .depth_test_mode(graphics_api::DepthTestMode::ReadOnly)
+                     .descriptor_binding(graphics_api::DescriptorType::ImageSampler, graphics_api::PipelineStage::FragmentShader)
+                     .descriptor_binding(graphics_api::DescriptorType::StorageBuffer, graphics_api::PipelineStage::VertexShader)
+                     .depth_test_mode(graphics_api::DepthTestMode::Disabled)
                      .enable_blending(true)
                      .use_push_descriptors(true)
                      .vertex_topology(graphics_api::VertexTopology::TriangleStrip)
@@ -56,7 +81,7 @@ Shading::Shading(graphics_api::Device& device, resource::ResourceManager& resour
 
 std::unique_ptr<render_core::NodeFrameResources> Shading::create_node_resources()
 {
-   auto result = IRenderNode::create_node_resources();
+   auto result = std::make_unique<ShadingResources>(m_device);
    result->add_render_target("shading"_name, m_shadingRenderTarget);
    return result;
 }
@@ -69,36 +94,50 @@ graphics_api::WorkTypeFlags Shading::work_types() const
 void Shading::record_commands(render_core::FrameResources& frameResources, render_core::NodeFrameResources& resources,
                               graphics_api::CommandList& cmdList)
 {
+   auto& shadingResources = dynamic_cast<ShadingResources&>(resources);
+   this->update_clustered_lights(shadingResources);
+
    cmdList.reset_timestamp_array(m_timestampArray, 0, 2);
    cmdList.write_timestamp(graphics_api::PipelineStage::Entrypoint, m_timestampArray, 0);
 
    auto& gbuffer = frameResources.node("geometry"_name).framebuffer("gbuffer"_name);
    auto& framebuffer = resources.framebuffer("shading"_name);
 
-   copy_texture(cmdList, gbuffer.texture("depth"_name), framebuffer.texture("depth"_name));
-
    std::array<graphics_api::ClearValue, 2> clearValues{
       graphics_api::ColorPalette::Black,
       graphics_api::ColorPalette::Black,
    };
    cmdList.begin_render_pass(framebuffer, clearValues);
 
-   const auto shadowMat = m_scene.shadow_map_camera().view_projection_matrix() * glm::inverse(m_scene.camera().view_matrix());
+   const auto invViewMat = glm::inverse(m_scene.camera().view_matrix());
+   ShadingRenderer::UniformData uniformData{
+      .inverseProjection = glm::inverse(m_scene.camera().projection_matrix()),
+      .shadowMapMats{},
+      .cascadeSplits{},
+      .clusterDepthParams{m_lightClustering.slice_scale(), m_lightClustering.slice_bias(), 0.0f, 0.0f},
+   };
+   for (u32 cascade = 0; cascade < g_shadowCascadeCount; ++cascade) {
+      uniformData.shadowMapMats[cascade] = m_scene.shadow_cascade_camera(cascade).view_projection_matrix() * invViewMat;
+      uniformData.cascadeSplits[cascade] = m_scene.shadow_cascade_split(cascade);
+   }
    const auto lightPosition = m_scene.camera().view_matrix() * glm::vec4(m_scene.shadow_map_camera().position(), 1.0);
 
-   m_shadingRenderer.draw(frameResources, cmdList, glm::vec3(lightPosition), shadowMat);
+   m_shadingRenderer.draw(frameResources, cmdList, glm::vec3(lightPosition), uniformData, shadingResources.light_buffers());
 
-   if (m_scene.camera().is_bounding_box_visible(g_particlesBoundingBox, glm::mat4{1})) {
+   if (not m_scene.particle_emitters().empty()) {
       auto& particles = dynamic_cast<ParticlesResources&>(frameResources.node("particles"_name));
 
       m_particlesUBO->view = m_scene.camera().view_matrix();
       m_particlesUBO->proj = m_scene.camera().projection_matrix();
 
+      // The instance count is written by the particles node, one instance per live particle.
       cmdList.bind_pipeline(m_particlesPipeline);
       cmdList.bind_uniform_buffer(0, m_particlesUBO);
       cmdList.bind_storage_buffer(1, particles.particles_buffer());
       cmdList.bind_texture(2, m_particlesTexture);
-      cmdList.draw_primitives(4, 0, 256, 0);
+      cmdList.bind_texture(3, gbuffer.texture("depth"_name));
+      cmdList.bind_storage_buffer(4, particles.alive_buffer());
+      cmdList.draw_indirect(particles.draw_call_buffer());
    }
 
    cmdList.end_render_pass();
@@ -111,4 +150,54 @@ float Shading::gpu_time() const
    return m_timestampArray.get_difference(0, 1);
 }
 
+void Shading::update_clustered_lights(ShadingResources& resources)
+{
+   const auto& camera = m_scene.camera();
+   m_lightClustering.update_projection(camera.projection_matrix(), camera.near_plane(), camera.far_plane());
+
+   const auto sceneLights = m_scene.lights();
+   const auto lights = sceneLights.first(std::min<size_t>(sceneLights.size(), g_maxClusteredLights));
+   const auto& viewMat = camera.view_matrix();
+
+   auto& gpuLights = *resources.lights();
+   m_lightSpheres.resize(lights.size());
+   for (u32 i = 0; i < lights.size(); ++i) {
+      const auto& light = lights[i];
+      const auto viewPosition = glm::vec3(viewMat * glm::vec4(light.position, 1.0f));
+      m_lightSpheres[i] = glm::vec4(viewPosition, light.range);
+
+      // Spot attenuation is computed as saturate(cos(angle) * scale + offset), point lights always yield one.
+      float spotScale = 0.0f;
+      float spotOffset = 1.0f;
+      glm::vec3 viewDirection{0.0f};
+      if (light.type == LightType::Spot) {
+         const auto cosOuter = std::cos(light.outerConeAngle);
+         const auto cosInner = std::cos(light.innerConeAngle);
+         spotScale = 1.0f / std::max(cosInner - cosOuter, 0.001f);
+         spotOffset = -cosOuter * spotScale;
+         viewDirection = glm::normalize(glm::mat3(viewMat) * light.direction);
+      }
+
+      gpuLights[i] = ClusteredLight{
+         .positionRange{viewPosition, light.range},
+         .colorSpotOffset{light.color * light.intensity, spotOffset},
+         .directionSpotScale{viewDirection, spotScale},
+      };
+   }
+
+   m_lightClustering.assign_lights(m_lightSpheres);
+
+   // Light lists which don't fit into the index buffer get truncated.
+   const auto clusters = m_lightClustering.clusters();
+   auto& gpuClusters = *resources.clusters();
+   for (u32 i = 0; i < clusters.size(); ++i) {
+      const auto offset = std::min(clusters[i].offset, g_maxClusterLightIndices);
+      gpuClusters[i] = LightCluster{offset, std::min(clusters[i].count, g_maxClusterLightIndices - offset)};
+   }
+
+   const auto lightIndices = m_lightClustering.light_indices();
+   std::memcpy(resources.light_indices()->data(), lightIndices.data(),
+               std::min<size_t>(lightIndices.size(), g_maxClusterLightIndices) * sizeof(u32));
+}
+
 }// namespace triglav::renderer::node
@@ -2,9 +2,12 @@
 
 #include "triglav/render_core/IRenderNode.hpp"
 
+#include "LightClustering.h"
 #include "Scene.h"
 #include "ShadingRenderer.h"
 
+#include <vector>
+
 namespace triglav::renderer::node {
 
 struct ParticlesUBO
@@ -13,6 +16,22 @@ struct ParticlesUBO
    glm::mat4 proj;
 };
 
+class ShadingResources : public render_core::NodeFrameResources
+{
+ public:
+   explicit ShadingResources(graphics_api::Device& device);
+
+   [[nodiscard]] ClusteredLightBuffer& lights();
+   [[nodiscard]] LightClusterBuffer& clusters();
+   [[nodiscard]] LightIndexBuffer& light_indices();
+   [[nodiscard]] ShadingRenderer::ClusteredLightBuffers light_buffers() const;
+
+ private:
+   ClusteredLightBuffer m_lights;
+   LightClusterBuffer m_clusters;
+   LightIndexBuffer m_lightIndices;
+};
+
 class Shading : public render_core::IRenderNode
 {
  public:
@@ -26,6 +45,9 @@ class Shading : public render_core::IRenderNode
    [[nodiscard]] float gpu_time() const;
 
  private:
+   void update_clustered_lights(ShadingResources& resources);
+
+   graphics_api::Device& m_device;
    graphics_api::RenderTarget m_shadingRenderTarget;
    ShadingRenderer m_shadingRenderer;
    Scene& m_scene;
@@ -33,6 +55,8 @@ class Shading : public render_core::IRenderNode
    graphics_api::UniformBuffer<ParticlesUBO> m_particlesUBO;
    graphics_api::Texture& m_particlesTexture;
    graphics_api::TimestampArray m_timestampArray;
+   LightClustering m_lightClustering;
+   std::vector<glm::vec4> m_lightSpheres;
 };
 
 }// namespace triglav::renderer::node
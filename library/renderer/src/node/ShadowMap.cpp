@@ -9,43 +9,57 @@ namespace triglav::renderer::node {
 using namespace name_literals;
 using graphics_api::AttachmentAttribute;
 
-constexpr auto g_shadowMapResolution = graphics_api::Resolution{4096, 4096};
+constexpr auto g_shadowMapResolution = graphics_api::Resolution{2048, 2048};
 constexpr auto g_shadowMapFormat = GAPI_FORMAT(D, Float32);
+constexpr std::array g_shadowCascadeNames{"sm/cascade0"_name, "sm/cascade1"_name, "sm/cascade2"_name};
+
+static_assert(g_shadowCascadeNames.size() == g_shadowCascadeCount);
+
+Name shadow_cascade_framebuffer_name(const u32 cascade)
+{
+   return g_shadowCascadeNames[cascade];
+}
 
 class ShadowMapResources : public render_core::NodeFrameResources
 {
  public:
-   ShadowMapResources(graphics_api::Device& device, resource::ResourceManager& resourceManager, graphics_api::Pipeline& pipeline,
-                      Scene& scene) :
-       m_device(device),
+   ShadowMapResources(resource::ResourceManager& resourceManager, graphics_api::Pipeline& pipeline, Scene& scene) :
        m_resourceManager(resourceManager),
        m_pipeline(pipeline),
        m_scene(scene),
-       m_onAddedObjectSink(scene.OnObjectAddedToScene.connect<&ShadowMapResources::on_object_added_to_scene>(this)),
-       m_onViewportChangeSink(scene.OnViewportChange.connect<&ShadowMapResources::on_viewport_change>(this))
+       m_onAddedObjectSink(scene.OnObjectAddedToScene.connect<&ShadowMapResources::on_object_added_to_scene>(this))
    {
    }
 
    void on_object_added_to_scene(const SceneObject& object)
    {
-      const auto& model = m_resourceManager.get<ResourceType::Model>(object.model);
+      const auto modelHandle = m_resourceManager.handle<ResourceType::Model>(object.model);
+      const auto& model = m_resourceManager.get(modelHandle);
+      m_models.emplace_back(render_core::ModelShaderMapProperties{modelHandle, model.boundingBox, object.model_matrix()});
 
-      graphics_api::UniformBuffer<render_core::ShadowMapUBO> shadowMapUbo(m_device);
-      m_models.emplace_back(
-         render_core::ModelShaderMapProperties{object.model, model.boundingBox, object.model_matrix(), std::move(shadowMapUbo)});
+      this->invalidate_cascades();
    }
 
-   void on_viewport_change(const graphics_api::Resolution& /*resolution*/)
+   void update_resolution(const graphics_api::Resolution& resolution) override
    {
-      const auto camMatShadow = m_scene.shadow_map_camera().view_projection_matrix();
-      for (const auto& obj : m_models) {
-         obj.ubo->mvp = camMatShadow * obj.modelMat;
-      }
+      NodeFrameResources::update_resolution(resolution);
+
+      // Framebuffers got recreated, their contents are lost.
+      this->invalidate_cascades();
    }
 
-   void draw_model(graphics_api::CommandList& cmdList, const render_core::ModelShaderMapProperties& instancedModel)
+   // Scene objects never move, so a cascade only needs to be redrawn
+   // when the light or the cascade bounds change.
+   [[nodiscard]] bool is_cascade_cached(const u32 cascade) const
    {
-      const auto& model = m_resourceManager.get<ResourceType::Model>(instancedModel.modelName);
+      const auto& cachedMatrix = m_cachedCascadeMatrices[cascade];
+      return cachedMatrix.has_value() && *cachedMatrix == m_scene.shadow_cascade_camera(cascade).view_projection_matrix();
+   }
+
+   void draw_model(graphics_api::CommandList& cmdList, const render_core::ModelShaderMapProperties& instancedModel,
+                   const glm::mat4& cascadeMat)
+   {
+      const auto& model = m_resourceManager.get(instancedModel.model);
 
       cmdList.bind_vertex_array(model.mesh.vertices);
       cmdList.bind_index_array(model.mesh.indices);
@@ -56,30 +70,44 @@ class ShadowMapResources : public render_core::NodeFrameResources
          size += range.size;
       }
 
-      cmdList.bind_uniform_buffer(0, instancedModel.ubo);
+      render_core::ShadowMapPushConstants pushConstants{
+         .mvp = cascadeMat * instancedModel.modelMat,
+      };
+      cmdList.push_constant(graphics_api::PipelineStage::VertexShader, pushConstants);
+
       cmdList.draw_indexed_primitives(size, firstOffset, 0);
    }
 
-   void draw_scene_models(graphics_api::CommandList& cmdList)
+   void draw_cascade(graphics_api::CommandList& cmdList, const u32 cascade)
    {
+      const auto& cascadeCamera = m_scene.shadow_cascade_camera(cascade);
+
       cmdList.bind_pipeline(m_pipeline);
 
       for (const auto& obj : m_models) {
-         if (not m_scene.shadow_map_camera().is_bounding_box_visible(obj.boundingBox, obj.modelMat))
+         if (not cascadeCamera.is_bounding_box_visible(obj.boundingBox, obj.modelMat))
             continue;
 
-         this->draw_model(cmdList, obj);
+         this->draw_model(cmdList, obj, cascadeCamera.view_projection_matrix());
       }
+
+      m_cachedCascadeMatrices[cascade] = cascadeCamera.view_projection_matrix();
    }
 
  private:
-   graphics_api::Device& m_device;
+   void invalidate_cascades()
+   {
+      for (auto& matrix : m_cachedCascadeMatrices) {
+         matrix.reset();
+      }
+   }
+
    resource::ResourceManager& m_resourceManager;
    graphics_api::Pipeline& m_pipeline;
    Scene& m_scene;
    std::vector<render_core::ModelShaderMapProperties> m_models;
+   std::array<std::optional<glm::mat4>, g_shadowCascadeCount> m_cachedCascadeMatrices{};
    Scene::OnObjectAddedToSceneDel::Sink<ShadowMapResources> m_onAddedObjectSink;
-   Scene::OnViewportChangeDel::Sink<ShadowMapResources> m_onViewportChangeSink;
 };
 
 ShadowMap::ShadowMap(graphics_api::Device& device, resource::ResourceManager& resourceManager, Scene& scene) :
@@ -96,18 +124,21 @@ ShadowMap::ShadowMap(graphics_api::Device& device, resource::ResourceManager& re
                              .begin_vertex_layout<geometry::Vertex>()
                              .vertex_attribute(GAPI_FORMAT(RGB, Float32), offsetof(geometry::Vertex, location))
                              .end_vertex_layout()
-                             .descriptor_binding(graphics_api::DescriptorType::UniformBuffer, graphics_api::PipelineStage::VertexShader)
+                             .push_constant(graphics_api::PipelineStage::VertexShader, sizeof(render_core::ShadowMapPushConstants))
                              .enable_depth_test(true)
                              .use_push_descriptors(true)
                              .build())),
-    m_scene(scene)
+    m_scene(scene),
+    m_timestampArray(GAPI_CHECK(device.create_timestamp_array(2)))
 {
 }
 
 std::unique_ptr<render_core::NodeFrameResources> ShadowMap::create_node_resources()
 {
-   auto result = std::make_unique<ShadowMapResources>(m_device, m_resourceManager, m_pipeline, m_scene);
-   result->add_render_target_with_resolution("sm"_name, m_depthRenderTarget, g_shadowMapResolution);
+   auto result = std::make_unique<ShadowMapResources>(m_resourceManager, m_pipeline, m_scene);
+   for (const auto name : g_shadowCascadeNames) {
+      result->add_render_target_with_resolution(name, m_depthRenderTarget, g_shadowMapResolution);
+   }
    return result;
 }
 
@@ -119,16 +150,30 @@ graphics_api::WorkTypeFlags ShadowMap::work_types() const
 void ShadowMap::record_commands(render_core::FrameResources& frameResources, render_core::NodeFrameResources& resources,
                                 graphics_api::CommandList& cmdList)
 {
+   cmdList.reset_timestamp_array(m_timestampArray, 0, 2);
+   cmdList.write_timestamp(graphics_api::PipelineStage::Entrypoint, m_timestampArray, 0);
+
    std::array<graphics_api::ClearValue, 1> clearValues{
       graphics_api::ClearValue{graphics_api::DepthStenctilValue{1.0f, 0}},
    };
 
-   cmdList.begin_render_pass(resources.framebuffer("sm"_name), clearValues);
-
    auto& smResources = dynamic_cast<ShadowMapResources&>(resources);
-   smResources.draw_scene_models(cmdList);
 
-   cmdList.end_render_pass();
+   for (u32 cascade = 0; cascade < g_shadowCascadeCount; ++cascade) {
+      if (smResources.is_cascade_cached(cascade))
+         continue;
+
+      cmdList.begin_render_pass(resources.framebuffer(g_shadowCascadeNames[cascade]), clearValues);
+      smResources.draw_cascade(cmdList, cascade);
+      cmdList.end_render_pass();
+   }
+
+   cmdList.write_timestamp(graphics_api::PipelineStage::End, m_timestampArray, 1);
+}
+
+float ShadowMap::gpu_time() const
+{
+   return m_timestampArray.get_difference(0, 1);
 }
 
 }// namespace triglav::renderer::node
@@ -6,6 +6,8 @@
 
 namespace triglav::renderer::node {
 
+[[nodiscard]] Name shadow_cascade_framebuffer_name(u32 cascade);
+
 class ShadowMap : public render_core::IRenderNode
 {
  public:
@@ -16,12 +18,15 @@ class ShadowMap : public render_core::IRenderNode
    void record_commands(render_core::FrameResources& frameResources, render_core::NodeFrameResources& resources,
                         graphics_api::CommandList& cmdList) override;
 
+   [[nodiscard]] float gpu_time() const;
+
  private:
    graphics_api::Device& m_device;
    resource::ResourceManager& m_resourceManager;
    graphics_api::RenderTarget m_depthRenderTarget;
    graphics_api::Pipeline m_pipeline;
    Scene& m_scene;
+   graphics_api::TimestampArray m_timestampArray;
 };
 
-}// namespace triglav::renderer::node
\ No newline at end of file
+}// namespace triglav::renderer::node
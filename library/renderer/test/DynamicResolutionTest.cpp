@@ -0,0 +1,216 @@
+#include "triglav/renderer/DynamicResolution.h"
+
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+
+using triglav::u32;
+using triglav::graphics_api::Resolution;
+using triglav::renderer::DynamicResolutionController;
+using triglav::renderer::DynamicResolutionSettings;
+
+namespace {
+
+// Synthetic GPU whose frame time is a fixed cost plus a cost proportional to the rendered pixel count.
+struct SyntheticGpu
+{
+   float fixedCost;
+   float pixelCost;
+   float noise{};
+   std::mt19937 generator{42};
+
+   float frame_time(const float scale)
+   {
+      std::uniform_real_distribution<float> jitter(-noise, noise);
+      return fixedCost + pixelCost * scale * scale + jitter(generator);
+   }
+};
+
+struct TraceResult
+{
+   u32 changeCount{};
+   u32 minFramesBetweenChanges{~0u};
+   float minScale{1.0f};
+   float maxScale{0.0f};
+};
+
+TraceResult run_trace(DynamicResolutionController& controller, SyntheticGpu& gpu, const u32 frameCount)
+{
+   TraceResult result{};
+   u32 lastChange = 0;
+   bool hasChanged = false;
+   for (u32 frame = 0; frame < frameCount; ++frame) {
+      if (controller.update(gpu.frame_time(controller.render_scale()))) {
+         if (hasChanged) {
+            result.minFramesBetweenChanges = std::min(result.minFramesBetweenChanges, frame - lastChange);
+         }
+         hasChanged = true;
+         lastChange = frame;
+         ++result.changeCount;
+      }
+      result.minScale = std::min(result.minScale, controller.render_scale());
+      result.maxScale = std::max(result.maxScale, controller.render_scale());
+   }
+   return result;
+}
+
+}// namespace
+
+TEST(DynamicResolutionTest, StaysAtMaxScaleWithinBudget)
+{
+   DynamicResolutionController controller(DynamicResolutionSettings{});
+   SyntheticGpu gpu{.fixedCost = 2.0f, .pixelCost = 8.0f};
+
+   const auto result = run_trace(controller, gpu, 600);
+
+   EXPECT_EQ(result.changeCount, 0u);
+   EXPECT_FLOAT_EQ(controller.render_scale(), 1.0f);
+}
+
+TEST(DynamicResolutionTest, ConvergesUnderBudgetWhenOverloaded)
+{
+   DynamicResolutionSettings settings{};
+   DynamicResolutionController controller(settings);
+   SyntheticGpu gpu{.fixedCost = 2.0f, .pixelCost = 24.0f};
+
+   run_trace(controller, gpu, 1200);
+
+   EXPECT_LT(controller.render_scale(), 1.0f);
+   EXPECT_GE(controller.render_scale(), settings.minScale);
+
+   const auto frameTime = gpu.frame_time(controller.render_scale());
+   EXPECT_LE(frameTime, settings.targetGpuTime * (1.0f + settings.overBudgetTolerance));
+   // Shouldn't give up much more resolution than needed.
+   EXPECT_GE(frameTime, settings.targetGpuTime * 0.75f);
+}
+
+TEST(DynamicResolutionTest, RespectsScaleBounds)
+{
+   DynamicResolutionSettings settings{};
+   settings.minScale = 0.6f;
+   DynamicResolutionController controller(settings);
+   SyntheticGpu gpu{.fixedCost = 20.0f, .pixelCost = 40.0f};
+
+   const auto result = run_trace(controller, gpu, 2000);
+
+   EXPECT_FLOAT_EQ(controller.render_scale(), settings.minScale);
+   EXPECT_GE(result.minScale, settings.minScale);
+   EXPECT_LE(result.maxScale, settings.maxScale);
+}
+
+TEST(DynamicResolutionTest, RespectsConfiguredMaxScale)
+{
+   DynamicResolutionSettings settings{};
+   settings.minScale = 0.7f;
+   settings.maxScale = 0.8f;
+   DynamicResolutionController controller(settings);
+   EXPECT_FLOAT_EQ(controller.render_scale(), 0.8f);
+
+   SyntheticGpu light{.fixedCost = 2.0f, .pixelCost = 4.0f};
+   const auto lightResult = run_trace(controller, light, 1000);
+   EXPECT_LE(lightResult.maxScale, 0.8f);
+
+   SyntheticGpu heavy{.fixedCost = 20.0f, .pixelCost = 40.0f};
+   const auto heavyResult = run_trace(controller, heavy, 2000);
+   EXPECT_FLOAT_EQ(controller.render_scale(), 0.7f);
+   EXPECT_GE(heavyResult.minScale, 0.7f);
+}
+
+TEST(DynamicResolutionTest, ScaleBoundsAreClamped)
+{
+   DynamicResolutionSettings settings{};
+   settings.minScale = 0.0f;
+   settings.maxScale = 1.5f;
+   const DynamicResolutionController unbounded(settings);
+   EXPECT_FLOAT_EQ(unbounded.settings().minScale, settings.scaleStep);
+   EXPECT_FLOAT_EQ(unbounded.settings().maxScale, 1.0f);
+   EXPECT_FLOAT_EQ(unbounded.render_scale(), 1.0f);
+
+   // The maximum doesn't go below the minimum.
+   settings.minScale = 0.8f;
+   settings.maxScale = 0.6f;
+   const DynamicResolutionController inverted(settings);
+   EXPECT_FLOAT_EQ(inverted.settings().minScale, 0.8f);
+   EXPECT_FLOAT_EQ(inverted.settings().maxScale, 0.8f);
+   EXPECT_FLOAT_EQ(inverted.render_scale(), 0.8f);
+}
+
+TEST(DynamicResolutionTest, RecoversAfterLoadSpike)
+{
+   DynamicResolutionController controller(DynamicResolutionSettings{});
+   SyntheticGpu heavy{.fixedCost = 2.0f, .pixelCost = 30.0f};
+   SyntheticGpu light{.fixedCost = 2.0f, .pixelCost = 6.0f};
+
+   run_trace(controller, heavy, 600);
+   EXPECT_LT(controller.render_scale(), 0.9f);
+
+   run_trace(controller, light, 3000);
+   EXPECT_FLOAT_EQ(controller.render_scale(), 1.0f);
+}
+
+TEST(DynamicResolutionTest, NoiseDoesNotCauseOscillation)
+{
+   DynamicResolutionController controller(DynamicResolutionSettings{});
+   SyntheticGpu gpu{.fixedCost = 2.0f, .pixelCost = 20.0f, .noise = 1.5f};
+
+   run_trace(controller, gpu, 1000);
+   const auto result = run_trace(controller, gpu, 3000);
+
+   // Once settled the applied scale may move by a step occasionally but shouldn't flip every cooldown period.
+   EXPECT_LE(result.changeCount, 10u);
+   EXPECT_LE(result.maxScale - result.minScale, 0.1f + 1e-4f);
+}
+
+TEST(DynamicResolutionTest, ChangesAreSeparatedByCooldown)
+{
+   DynamicResolutionSettings settings{};
+   settings.cooldownFrames = 20;
+   DynamicResolutionController controller(settings);
+   SyntheticGpu gpu{.fixedCost = 2.0f, .pixelCost = 40.0f};
+
+   const auto result = run_trace(controller, gpu, 1000);
+
+   ASSERT_GE(result.changeCount, 2u);
+   EXPECT_GE(result.minFramesBetweenChanges, settings.cooldownFrames);
+}
+
+TEST(DynamicResolutionTest, AppliedScaleIsQuantized)
+{
+   DynamicResolutionSettings settings{};
+   DynamicResolutionController controller(settings);
+   SyntheticGpu gpu{.fixedCost = 2.0f, .pixelCost = 26.0f};
+
+   for (u32 frame = 0; frame < 1000; ++frame) {
+      controller.update(gpu.frame_time(controller.render_scale()));
+      const auto steps = controller.render_scale() / settings.scaleStep;
+      EXPECT_NEAR(steps, std::round(steps), 1e-3f);
+   }
+}
+
+TEST(DynamicResolutionTest, RenderResolutionFollowsScale)
+{
+   DynamicResolutionController controller(DynamicResolutionSettings{});
+   const Resolution output{1920, 1080};
+
+   const auto fullResolution = controller.render_resolution(output);
+   EXPECT_EQ(fullResolution.width, 1920u);
+   EXPECT_EQ(fullResolution.height, 1080u);
+
+   SyntheticGpu gpu{.fixedCost = 20.0f, .pixelCost = 40.0f};
+   run_trace(controller, gpu, 2000);
+
+   const auto reducedResolution = controller.render_resolution(output);
+   EXPECT_EQ(reducedResolution.width, 960u);
+   EXPECT_EQ(reducedResolution.height, 540u);
+}
+
+TEST(DynamicResolutionTest, ResetRestoresMaxScale)
+{
+   DynamicResolutionController controller(DynamicResolutionSettings{});
+   SyntheticGpu gpu{.fixedCost = 20.0f, .pixelCost = 40.0f};
+   run_trace(controller, gpu, 500);
+   ASSERT_LT(controller.render_scale(), 1.0f);
+
+   controller.reset();
+   EXPECT_FLOAT_EQ(controller.render_scale(), 1.0f);
+}
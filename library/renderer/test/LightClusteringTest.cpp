@@ -0,0 +1,191 @@
+#include "triglav/renderer/LightClustering.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+
+using triglav::u32;
+using triglav::renderer::g_lightClusterCount;
+using triglav::renderer::g_lightClusterCountX;
+using triglav::renderer::g_lightClusterCountY;
+using triglav::renderer::g_lightClusterCountZ;
+using triglav::renderer::LightClusterBounds;
+using triglav::renderer::LightClustering;
+
+namespace {
+
+constexpr float g_nearPlane = 0.1f;
+constexpr float g_farPlane = 200.0f;
+
+glm::mat4 projection()
+{
+   return glm::perspective(0.7854f, 16.0f / 9.0f, g_nearPlane, g_farPlane);
+}
+
+LightClustering create_clustering()
+{
+   LightClustering clustering;
+   clustering.update_projection(projection(), g_nearPlane, g_farPlane);
+   return clustering;
+}
+
+std::vector<glm::vec4> generate_lights(const u32 count)
+{
+   std::mt19937 generator(100);
+   std::uniform_real_distribution<float> horizontal(-60.0f, 60.0f);
+   std::uniform_real_distribution<float> depth(-220.0f, 10.0f);
+   std::uniform_real_distribution<float> radius(0.5f, 15.0f);
+
+   std::vector<glm::vec4> lights(count);
+   for (auto& light : lights) {
+      light = glm::vec4{horizontal(generator), horizontal(generator), depth(generator), radius(generator)};
+   }
+   return lights;
+}
+
+// Bounds of a cluster built without the clustering, from the rays through the corners of its tile unprojected
+// with the inverse projection matrix.
+LightClusterBounds reference_cluster_bounds(const u32 x, const u32 y, const u32 z)
+{
+   const auto invProjection = glm::inverse(projection());
+   const auto sliceDepth = [](const u32 slice) {
+      return g_nearPlane * std::pow(g_farPlane / g_nearPlane, static_cast<float>(slice) / static_cast<float>(g_lightClusterCountZ));
+   };
+
+   LightClusterBounds bounds{glm::vec3{std::numeric_limits<float>::max()}, glm::vec3{std::numeric_limits<float>::lowest()}};
+   for (u32 corner = 0; corner < 4; ++corner) {
+      const auto ndcX = 2.0f * static_cast<float>(x + (corner & 1)) / static_cast<float>(g_lightClusterCountX) - 1.0f;
+      const auto ndcY = 2.0f * static_cast<float>(y + (corner >> 1)) / static_cast<float>(g_lightClusterCountY) - 1.0f;
+      const auto farPoint = invProjection * glm::vec4{ndcX, ndcY, 1.0f, 1.0f};
+      const auto ray = glm::vec3{farPoint} / farPoint.w;
+
+      for (const auto depth : {sliceDepth(z), sliceDepth(z + 1)}) {
+         const auto point = ray * (depth / -ray.z);
+         bounds.min = glm::min(bounds.min, point);
+         bounds.max = glm::max(bounds.max, point);
+      }
+   }
+   return bounds;
+}
+
+std::vector<u32> cluster_lights(const LightClustering& clustering, const u32 clusterIndex)
+{
+   const auto cluster = clustering.clusters()[clusterIndex];
+   const auto indices = clustering.light_indices().subspan(cluster.offset, cluster.count);
+   return {indices.begin(), indices.end()};
+}
+
+// Tests every light against every reference cluster. Lights touching a cluster within the rounding error of the two
+// ways to compute the bounds may go either way.
+void expect_matches_brute_force(const LightClustering& clustering, const std::vector<glm::vec4>& lights)
+{
+   for (u32 z = 0; z < g_lightClusterCountZ; ++z) {
+      for (u32 y = 0; y < g_lightClusterCountY; ++y) {
+         for (u32 x = 0; x < g_lightClusterCountX; ++x) {
+            const auto clusterIndex = LightClustering::cluster_index(x, y, z);
+            const auto bounds = reference_cluster_bounds(x, y, z);
+            const auto assignedLights = cluster_lights(clustering, clusterIndex);
+            ASSERT_TRUE(std::ranges::is_sorted(assignedLights)) << "cluster " << clusterIndex;
+
+            for (u32 lightIndex = 0; lightIndex < lights.size(); ++lightIndex) {
+               const glm::vec3 center{lights[lightIndex]};
+               const auto offset = center - glm::clamp(center, bounds.min, bounds.max);
+               const auto distanceSq = glm::dot(offset, offset);
+               const auto radiusSq = lights[lightIndex].w * lights[lightIndex].w;
+               const auto tolerance = 1e-3f * (radiusSq + 1.0f);
+
+               const auto isAssigned = std::ranges::binary_search(assignedLights, lightIndex);
+               if (distanceSq < radiusSq - tolerance) {
+                  ASSERT_TRUE(isAssigned) << "light " << lightIndex << " missing in cluster " << clusterIndex;
+               } else if (distanceSq > radiusSq + tolerance) {
+                  ASSERT_FALSE(isAssigned) << "light " << lightIndex << " wrongly in cluster " << clusterIndex;
+               }
+            }
+         }
+      }
+   }
+}
+
+}// namespace
+
+TEST(LightClusteringTest, ClusterBoundsCoverViewFrustum)
+{
+   const auto clustering = create_clustering();
+
+   const auto nearCluster = clustering.cluster_bounds(LightClustering::cluster_index(0, 0, 0));
+   EXPECT_FLOAT_EQ(nearCluster.max.z, -g_nearPlane);
+
+   const auto farCluster = clustering.cluster_bounds(LightClustering::cluster_index(0, 0, g_lightClusterCountZ - 1));
+   EXPECT_FLOAT_EQ(farCluster.min.z, -g_farPlane);
+
+   for (u32 z = 1; z < g_lightClusterCountZ; ++z) {
+      const auto previous = clustering.cluster_bounds(LightClustering::cluster_index(0, 0, z - 1));
+      const auto current = clustering.cluster_bounds(LightClustering::cluster_index(0, 0, z));
+      EXPECT_FLOAT_EQ(previous.min.z, current.max.z);
+   }
+}
+
+TEST(LightClusteringTest, NoLights)
+{
+   auto clustering = create_clustering();
+   clustering.assign_lights({});
+
+   EXPECT_TRUE(clustering.light_indices().empty());
+   for (const auto& cluster : clustering.clusters()) {
+      EXPECT_EQ(cluster.count, 0u);
+   }
+}
+
+TEST(LightClusteringTest, LightBehindCameraIsCulled)
+{
+   auto clustering = create_clustering();
+   const std::array lights{glm::vec4{0.0f, 0.0f, 20.0f, 5.0f}};
+   clustering.assign_lights(lights);
+
+   EXPECT_TRUE(clustering.light_indices().empty());
+}
+
+TEST(LightClusteringTest, LightIsAssignedToContainingCluster)
+{
+   auto clustering = create_clustering();
+   const std::array lights{glm::vec4{0.0f, 0.0f, -10.0f, 0.5f}};
+   clustering.assign_lights(lights);
+
+   // The light is in the middle of the screen.
+   const auto centerX = g_lightClusterCountX / 2;
+   const auto centerY = g_lightClusterCountY / 2;
+   u32 containingClusterCount = 0;
+   for (u32 z = 0; z < g_lightClusterCountZ; ++z) {
+      const auto bounds = clustering.cluster_bounds(LightClustering::cluster_index(centerX, centerY, z));
+      if (bounds.min.z <= -10.0f && -10.0f <= bounds.max.z) {
+         EXPECT_EQ(cluster_lights(clustering, LightClustering::cluster_index(centerX, centerY, z)), std::vector<u32>{0});
+         ++containingClusterCount;
+      }
+   }
+   EXPECT_GE(containingClusterCount, 1);
+   EXPECT_LT(clustering.light_indices().size(), g_lightClusterCount);
+}
+
+TEST(LightClusteringTest, MatchesBruteForce)
+{
+   auto clustering = create_clustering();
+   const auto lights = generate_lights(1000);
+   clustering.assign_lights(lights);
+
+   expect_matches_brute_force(clustering, lights);
+}
+
+TEST(LightClusteringTest, ReassignReplacesPreviousLights)
+{
+   auto clustering = create_clustering();
+   clustering.assign_lights(generate_lights(500));
+
+   const auto lights = generate_lights(20);
+   clustering.assign_lights(lights);
+
+   expect_matches_brute_force(clustering, lights);
+}
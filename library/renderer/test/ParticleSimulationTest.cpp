@@ -0,0 +1,219 @@
+#include "triglav/renderer/ParticleSimulation.h"
+
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <numeric>
+
+using triglav::u32;
+using triglav::renderer::ParticleEmitterState;
+using triglav::renderer::ParticleSimulation;
+using triglav::renderer::schedule_particle_spawns;
+using triglav::renderer::particles::ParticleEmitter;
+
+namespace {
+
+constexpr float g_deltaTime = 1.0f / 60.0f;
+
+ParticleEmitterState create_emitter(const float spawnRate, const float lifetime)
+{
+   return ParticleEmitterState{
+      .emitter{
+         .position{10.0f, -5.0f, -20.0f, 0.0f},
+         .extent{2.0f, 1.0f, 0.5f, lifetime},
+         .velocity{0.0f, 1.0f, -2.0f, 0.5f},
+         .properties{0.25f, 1.0f, 0.5f, 0.0f},
+         .spawn{},
+      },
+      .spawnRate = spawnRate,
+   };
+}
+
+void run_frames(ParticleSimulation& simulation, std::span<ParticleEmitterState> emitters, const u32 frameCount)
+{
+   for (u32 frame = 0; frame < frameCount; ++frame) {
+      schedule_particle_spawns(emitters, g_deltaTime, frame);
+      simulation.update(emitters, g_deltaTime);
+   }
+}
+
+void expect_lists_cover_pool(const ParticleSimulation& simulation)
+{
+   std::vector<u32> slots;
+   slots.insert(slots.end(), simulation.alive_slots().begin(), simulation.alive_slots().end());
+   slots.insert(slots.end(), simulation.dead_slots().begin(), simulation.dead_slots().end());
+   std::ranges::sort(slots);
+
+   std::vector<u32> expected(simulation.capacity());
+   std::iota(expected.begin(), expected.end(), 0);
+   EXPECT_EQ(slots, expected);
+}
+
+}// namespace
+
+TEST(ParticleSimulationTest, SpawnRateRemainderCarriesOver)
+{
+   std::array emitters{create_emitter(10.0f, 1.0f)};
+
+   u32 total = 0;
+   for (u32 frame = 0; frame < 4; ++frame) {
+      const auto count = schedule_particle_spawns(emitters, 0.25f, frame);
+      EXPECT_TRUE(count == 2 || count == 3);
+      total += count;
+   }
+   EXPECT_EQ(total, 10u);
+}
+
+TEST(ParticleSimulationTest, SpawnRangesAreConsecutive)
+{
+   std::array emitters{create_emitter(600.0f, 1.0f), create_emitter(0.0f, 1.0f), create_emitter(1200.0f, 1.0f)};
+
+   const auto total = schedule_particle_spawns(emitters, g_deltaTime, 0);
+   EXPECT_EQ(total, 30u);
+   EXPECT_EQ(emitters[0].emitter.spawn.x, 0u);
+   EXPECT_EQ(emitters[0].emitter.spawn.y, 10u);
+   EXPECT_EQ(emitters[1].emitter.spawn.x, 10u);
+   EXPECT_EQ(emitters[1].emitter.spawn.y, 0u);
+   EXPECT_EQ(emitters[2].emitter.spawn.x, 10u);
+   EXPECT_EQ(emitters[2].emitter.spawn.y, 20u);
+   EXPECT_NE(emitters[0].emitter.spawn.z, emitters[2].emitter.spawn.z);
+}
+
+TEST(ParticleSimulationTest, SpawnedParticlesFollowEmitter)
+{
+   std::array emitters{create_emitter(6000.0f, 2.0f)};
+   ParticleSimulation simulation(1024);
+   run_frames(simulation, emitters, 1);
+
+   const auto& emitter = emitters[0].emitter;
+   ASSERT_EQ(simulation.alive_slots().size(), 100u);
+   for (const auto slot : simulation.alive_slots()) {
+      const auto& particle = simulation.particle(slot);
+      EXPECT_LE(std::abs(particle.position.x - emitter.position.x), emitter.extent.x);
+      EXPECT_LE(std::abs(particle.position.y - emitter.position.y), emitter.extent.y);
+      EXPECT_LE(std::abs(particle.position.z - emitter.position.z), emitter.extent.z);
+      EXPECT_LE(std::abs(particle.velocity.y - emitter.velocity.y), emitter.velocity.w);
+      EXPECT_GE(particle.velocity.w, 1.5f);
+      EXPECT_LE(particle.velocity.w, 2.5f);
+      EXPECT_EQ(particle.position.w, 0.0f);
+   }
+}
+
+TEST(ParticleSimulationTest, ParticlesMoveWithVelocity)
+{
+   auto state = create_emitter(60.0f, 10.0f);
+   state.emitter.velocity.w = 0.0f;
+   std::array emitters{state};
+
+   ParticleSimulation simulation(16);
+   run_frames(simulation, emitters, 1);
+   ASSERT_EQ(simulation.alive_slots().size(), 1u);
+
+   const auto slot = simulation.alive_slots()[0];
+   const auto start = simulation.particle(slot).position;
+
+   emitters[0].spawnRate = 0.0f;
+   run_frames(simulation, emitters, 60);
+
+   const auto& particle = simulation.particle(slot);
+   EXPECT_NEAR(particle.position.x, start.x, 1e-4f);
+   EXPECT_NEAR(particle.position.y, start.y + 1.0f, 1e-3f);
+   EXPECT_NEAR(particle.position.z, start.z - 2.0f, 1e-3f);
+   EXPECT_NEAR(particle.position.w, 1.0f, 1e-4f);
+}
+
+TEST(ParticleSimulationTest, ParticlesBounceOffGround)
+{
+   auto state = create_emitter(60.0f, 10.0f);
+   state.emitter.position = {0.0f, 0.0f, -1.0f, 0.0f};
+   state.emitter.extent = {0.0f, 0.0f, 0.0f, 10.0f};
+   state.emitter.velocity = {0.0f, 0.0f, 0.0f, 0.0f};
+   state.emitter.properties.w = 10.0f;
+   std::array emitters{state};
+
+   ParticleSimulation simulation(16);
+   run_frames(simulation, emitters, 1);
+   emitters[0].spawnRate = 0.0f;
+
+   for (u32 frame = 0; frame < 120; ++frame) {
+      run_frames(simulation, emitters, 1);
+      EXPECT_LE(simulation.particle(simulation.alive_slots()[0]).position.z, -0.5f);
+   }
+}
+
+TEST(ParticleSimulationTest, ParticlesDieAfterLifetime)
+{
+   std::array emitters{create_emitter(6000.0f, 0.5f)};
+   ParticleSimulation simulation(1024);
+   run_frames(simulation, emitters, 1);
+   EXPECT_EQ(simulation.alive_slots().size(), 100u);
+
+   emitters[0].spawnRate = 0.0f;
+   run_frames(simulation, emitters, 60);
+
+   EXPECT_TRUE(simulation.alive_slots().empty());
+   EXPECT_EQ(simulation.dead_slots().size(), 1024u);
+}
+
+TEST(ParticleSimulationTest, ExpiredSlotsAreReusedFirst)
+{
+   auto state = create_emitter(60.0f, 0.1f);
+   state.emitter.properties.x = 0.0f;
+   std::array emitters{state};
+
+   ParticleSimulation simulation(16);
+   run_frames(simulation, emitters, 1);
+   ASSERT_EQ(simulation.alive_slots().size(), 1u);
+   const auto slot = simulation.alive_slots()[0];
+
+   // The expired slot is pushed on top of the dead list and taken by the next spawn.
+   emitters[0].spawnRate = 0.0f;
+   run_frames(simulation, emitters, 10);
+   EXPECT_TRUE(simulation.alive_slots().empty());
+   EXPECT_EQ(simulation.dead_slots().back(), slot);
+
+   emitters[0].spawnRate = 60.0f;
+   run_frames(simulation, emitters, 1);
+   ASSERT_EQ(simulation.alive_slots().size(), 1u);
+   EXPECT_EQ(simulation.alive_slots()[0], slot);
+}
+
+TEST(ParticleSimulationTest, SpawnIsLimitedByCapacity)
+{
+   std::array emitters{create_emitter(60000.0f, 10.0f)};
+   ParticleSimulation simulation(256);
+   run_frames(simulation, emitters, 3);
+
+   EXPECT_EQ(simulation.alive_slots().size(), 256u);
+   EXPECT_TRUE(simulation.dead_slots().empty());
+   expect_lists_cover_pool(simulation);
+}
+
+TEST(ParticleSimulationTest, AliveAndDeadListsPartitionPool)
+{
+   std::array emitters{create_emitter(3000.0f, 0.3f), create_emitter(1000.0f, 1.0f)};
+   ParticleSimulation simulation(512);
+
+   for (u32 frame = 0; frame < 200; ++frame) {
+      run_frames(simulation, emitters, 1);
+      expect_lists_cover_pool(simulation);
+   }
+   EXPECT_FALSE(simulation.alive_slots().empty());
+}
+
+TEST(ParticleSimulationTest, SimulationIsDeterministic)
+{
+   std::array emittersA{create_emitter(3000.0f, 0.3f)};
+   std::array emittersB{create_emitter(3000.0f, 0.3f)};
+   ParticleSimulation simulationA(512);
+   ParticleSimulation simulationB(512);
+
+   run_frames(simulationA, emittersA, 50);
+   run_frames(simulationB, emittersB, 50);
+
+   ASSERT_TRUE(std::ranges::equal(simulationA.alive_slots(), simulationB.alive_slots()));
+   for (const auto slot : simulationA.alive_slots()) {
+      EXPECT_EQ(simulationA.particle(slot).position, simulationB.particle(slot).position);
+      EXPECT_EQ(simulationA.particle(slot).velocity, simulationB.particle(slot).velocity);
+   }
+}
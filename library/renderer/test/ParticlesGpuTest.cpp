@@ -0,0 +1,379 @@
+#include "triglav/graphics_api/CommandList.h"
+#include "triglav/graphics_api/Device.h"
+#include "triglav/graphics_api/Instance.h"
+#include "triglav/graphics_api/Pipeline.h"
+#include "triglav/graphics_api/PipelineBuilder.h"
+#include "triglav/graphics_api/Shader.h"
+#include "triglav/renderer/ParticleSimulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+using triglav::u32;
+using triglav::graphics_api::Buffer;
+using triglav::graphics_api::BufferUsage;
+using triglav::graphics_api::BufferUsageFlags;
+using triglav::graphics_api::ComputePipelineBuilder;
+using triglav::graphics_api::DescriptorType;
+using triglav::graphics_api::DevicePickStrategy;
+using triglav::graphics_api::DeviceUPtr;
+using triglav::graphics_api::DispatchIndirectCommand;
+using triglav::graphics_api::DrawIndirectCommand;
+using triglav::graphics_api::Instance;
+using triglav::graphics_api::Pipeline;
+using triglav::graphics_api::PipelineStage;
+using triglav::graphics_api::Shader;
+using triglav::graphics_api::SubmitType;
+using triglav::graphics_api::WorkType;
+using triglav::renderer::ParticleEmitterState;
+using triglav::renderer::ParticleSimulation;
+using triglav::renderer::schedule_particle_spawns;
+using triglav::renderer::particles::Particle;
+using triglav::renderer::particles::ParticleCounters;
+using triglav::renderer::particles::ParticleEmitter;
+
+namespace {
+
+constexpr u32 g_capacity = 1024;
+constexpr u32 g_maxEmitterCount = 4;
+constexpr u32 g_emitGroupSize = 64;
+// Exact in binary, so particle ages are the same on the device and on the CPU.
+constexpr float g_deltaTime = 1.0f / 64.0f;
+
+// Push constants of the particle shaders, same as in the particles render node.
+struct SimulatePushConstants
+{
+   float deltaTime;
+};
+
+struct EmitPushConstants
+{
+   u32 spawnCount;
+   u32 emitterCount;
+};
+
+struct FinalizePushConstants
+{
+   u32 spawnCount;
+};
+
+ParticleEmitterState create_emitter(const float spawnRate, const float lifetime)
+{
+   return ParticleEmitterState{
+      .emitter{
+         .position{10.0f, -5.0f, -20.0f, 0.0f},
+         .extent{2.0f, 1.0f, 0.5f, lifetime},
+         .velocity{0.0f, 1.0f, -2.0f, 0.5f},
+         .properties{0.25f, 1.0f, 0.5f, 4.0f},
+         .spawn{},
+      },
+      .spawnRate = spawnRate,
+   };
+}
+
+// The slots are assigned in a different order on the device, so the particles are compared sorted.
+std::vector<Particle> sorted_particles(std::vector<Particle> particles)
+{
+   std::ranges::sort(particles, [](const Particle& lhs, const Particle& rhs) {
+      if (lhs.position.w != rhs.position.w)
+         return lhs.position.w < rhs.position.w;
+      return lhs.position.x < rhs.position.x;
+   });
+   return particles;
+}
+
+void expect_near(const glm::vec4& actual, const glm::vec4& expected, const std::size_t index)
+{
+   for (int component = 0; component < 4; ++component) {
+      EXPECT_NEAR(actual[component], expected[component], 1e-3f) << "particle " << index << ", component " << component;
+   }
+}
+
+}// namespace
+
+// Needs a Vulkan device, lavapipe is enough. The tests are skipped when none is available.
+class ParticlesGpuTest : public testing::Test
+{
+ protected:
+   // Per frame buffers of the particles render node.
+   struct FrameBuffers
+   {
+      Buffer particles;
+      Buffer alive;
+      Buffer counters;
+      Buffer drawCall;
+      Buffer simulateDispatch;
+   };
+
+   void SetUp() override
+   {
+      auto instance = Instance::create_instance();
+      if (not instance.has_value())
+         GTEST_SKIP() << "Vulkan is not available";
+      m_instance.emplace(std::move(*instance));
+
+      auto device = m_instance->create_headless_device(DevicePickStrategy::PreferDedicated);
+      if (not device.has_value())
+         GTEST_SKIP() << "no Vulkan device is available";
+      m_device = std::move(*device);
+
+      const auto resetShader = this->load_shader(TRIGLAV_PARTICLES_RESET_SHADER_PATH);
+      const auto simulateShader = this->load_shader(TRIGLAV_PARTICLES_SIMULATE_SHADER_PATH);
+      const auto emitShader = this->load_shader(TRIGLAV_PARTICLES_EMIT_SHADER_PATH);
+      const auto finalizeShader = this->load_shader(TRIGLAV_PARTICLES_FINALIZE_SHADER_PATH);
+
+      m_resetPipeline.emplace(GAPI_CHECK(ComputePipelineBuilder(*m_device)
+                                            .compute_shader(resetShader)
+                                            .descriptor_binding(DescriptorType::StorageBuffer)
+                                            .descriptor_binding(DescriptorType::StorageBuffer)
+                                            .use_push_descriptors(true)
+                                            .build()));
+      m_simulatePipeline.emplace(GAPI_CHECK(ComputePipelineBuilder(*m_device)
+                                               .compute_shader(simulateShader)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .push_constant(PipelineStage::ComputeShader, sizeof(SimulatePushConstants))
+                                               .use_push_descriptors(true)
+                                               .build()));
+      m_emitPipeline.emplace(GAPI_CHECK(ComputePipelineBuilder(*m_device)
+                                           .compute_shader(emitShader)
+                                           .descriptor_binding(DescriptorType::StorageBuffer)
+                                           .descriptor_binding(DescriptorType::StorageBuffer)
+                                           .descriptor_binding(DescriptorType::StorageBuffer)
+                                           .descriptor_binding(DescriptorType::StorageBuffer)
+                                           .descriptor_binding(DescriptorType::StorageBuffer)
+                                           .push_constant(PipelineStage::ComputeShader, sizeof(EmitPushConstants))
+                                           .use_push_descriptors(true)
+                                           .build()));
+      m_finalizePipeline.emplace(GAPI_CHECK(ComputePipelineBuilder(*m_device)
+                                               .compute_shader(finalizeShader)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .descriptor_binding(DescriptorType::StorageBuffer)
+                                               .push_constant(PipelineStage::ComputeShader, sizeof(FinalizePushConstants))
+                                               .use_push_descriptors(true)
+                                               .build()));
+
+      // Same initial state as the render node, every slot is dead.
+      std::vector<u32> deadSlots(g_capacity);
+      std::iota(deadSlots.begin(), deadSlots.end(), 0);
+      m_dead.emplace(this->create_buffer<u32>(BufferUsage::StorageBuffer, deadSlots));
+      m_emitters.emplace(this->create_buffer<ParticleEmitter>(BufferUsage::StorageBuffer, std::vector<ParticleEmitter>(g_maxEmitterCount)));
+      for (int frame = 0; frame < 2; ++frame) {
+         m_frames.emplace_back(FrameBuffers{
+            .particles = this->create_buffer<Particle>(BufferUsage::StorageBuffer, std::vector<Particle>(g_capacity)),
+            .alive = this->create_buffer<u32>(BufferUsage::StorageBuffer, std::vector<u32>(g_capacity)),
+            .counters = this->create_buffer<ParticleCounters>(BufferUsage::StorageBuffer, std::array{ParticleCounters{0, g_capacity}}),
+            .drawCall = this->create_buffer<DrawIndirectCommand>(BufferUsage::StorageBuffer | BufferUsage::Indirect,
+                                                                 std::array{DrawIndirectCommand{4, 0, 0, 0}}),
+            .simulateDispatch = this->create_buffer<DispatchIndirectCommand>(BufferUsage::StorageBuffer | BufferUsage::Indirect,
+                                                                             std::array{DispatchIndirectCommand{0, 1, 1}}),
+         });
+      }
+   }
+
+   [[nodiscard]] Shader load_shader(const char* path) const
+   {
+      std::ifstream file(path, std::ios::binary);
+      EXPECT_TRUE(file.is_open()) << path;
+      const std::vector<char> code{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+      return GAPI_CHECK(m_device->create_shader(PipelineStage::ComputeShader, "main", code));
+   }
+
+   // Host visible, so the tests can fill and read the buffers directly.
+   template<typename TValue>
+   [[nodiscard]] Buffer create_buffer(const BufferUsageFlags usage, const std::span<const TValue> values) const
+   {
+      auto buffer = GAPI_CHECK(m_device->create_buffer(usage | BufferUsage::HostVisible, values.size_bytes()));
+      this->write_buffer(buffer, values);
+      return buffer;
+   }
+
+   template<typename TValue>
+   static void write_buffer(Buffer& buffer, const std::span<const TValue> values)
+   {
+      const auto mapping = GAPI_CHECK(buffer.map_memory());
+      std::memcpy(*mapping, values.data(), values.size_bytes());
+   }
+
+   template<typename TValue>
+   [[nodiscard]] static std::vector<TValue> read_buffer(Buffer& buffer, const std::size_t count)
+   {
+      const auto mapping = GAPI_CHECK(buffer.map_memory());
+      const auto* values = static_cast<const TValue*>(*mapping);
+      return {values, values + count};
+   }
+
+   [[nodiscard]] FrameBuffers& current_frame()
+   {
+      return m_frames[m_frameIndex % 2];
+   }
+
+   // Records the same commands as Particles::record_commands and waits for them to finish.
+   void run_frame(const std::span<const ParticleEmitterState> emitters, const u32 spawnCount)
+   {
+      std::vector<ParticleEmitter> emitterValues;
+      std::ranges::transform(emitters, std::back_inserter(emitterValues), [](const ParticleEmitterState& state) { return state.emitter; });
+      write_buffer<ParticleEmitter>(*m_emitters, emitterValues);
+
+      auto& previous = this->current_frame();
+      ++m_frameIndex;
+      auto& current = this->current_frame();
+
+      auto cmdList = GAPI_CHECK(m_device->create_command_list(WorkType::Compute));
+      GAPI_CHECK_STATUS(cmdList.begin(SubmitType::OneTime));
+
+      cmdList.bind_pipeline(*m_resetPipeline);
+      cmdList.bind_storage_buffer(0, previous.counters);
+      cmdList.bind_storage_buffer(1, current.counters);
+      cmdList.dispatch(1, 1, 1);
+
+      cmdList.memory_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader);
+
+      SimulatePushConstants simulatePushConstants{
+         .deltaTime = g_deltaTime,
+      };
+      cmdList.bind_pipeline(*m_simulatePipeline);
+      cmdList.bind_storage_buffer(0, previous.particles);
+      cmdList.bind_storage_buffer(1, previous.alive);
+      cmdList.bind_storage_buffer(2, previous.counters);
+      cmdList.bind_storage_buffer(3, current.particles);
+      cmdList.bind_storage_buffer(4, current.alive);
+      cmdList.bind_storage_buffer(5, *m_dead);
+      cmdList.bind_storage_buffer(6, current.counters);
+      cmdList.push_constant(PipelineStage::ComputeShader, simulatePushConstants);
+      cmdList.dispatch_indirect(previous.simulateDispatch);
+
+      cmdList.memory_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader);
+
+      if (spawnCount > 0) {
+         EmitPushConstants emitPushConstants{
+            .spawnCount = spawnCount,
+            .emitterCount = static_cast<u32>(emitters.size()),
+         };
+         cmdList.bind_pipeline(*m_emitPipeline);
+         cmdList.bind_storage_buffer(0, *m_emitters);
+         cmdList.bind_storage_buffer(1, current.particles);
+         cmdList.bind_storage_buffer(2, current.alive);
+         cmdList.bind_storage_buffer(3, *m_dead);
+         cmdList.bind_storage_buffer(4, current.counters);
+         cmdList.push_constant(PipelineStage::ComputeShader, emitPushConstants);
+         cmdList.dispatch((spawnCount + g_emitGroupSize - 1) / g_emitGroupSize, 1, 1);
+
+         cmdList.memory_barrier(PipelineStage::ComputeShader, PipelineStage::ComputeShader);
+      }
+
+      FinalizePushConstants finalizePushConstants{
+         .spawnCount = spawnCount,
+      };
+      cmdList.bind_pipeline(*m_finalizePipeline);
+      cmdList.bind_storage_buffer(0, current.counters);
+      cmdList.bind_storage_buffer(1, current.drawCall);
+      cmdList.bind_storage_buffer(2, current.simulateDispatch);
+      cmdList.push_constant(PipelineStage::ComputeShader, finalizePushConstants);
+      cmdList.dispatch(1, 1, 1);
+
+      GAPI_CHECK_STATUS(cmdList.finish());
+      GAPI_CHECK_STATUS(m_device->submit_command_list_one_time(cmdList));
+   }
+
+   // Runs the frames on the device and on the CPU reference with the same spawns.
+   void run_frames(ParticleSimulation& simulation, const std::span<ParticleEmitterState> emitters, const u32 frameCount)
+   {
+      for (u32 frame = 0; frame < frameCount; ++frame) {
+         const auto spawnCount = std::min(schedule_particle_spawns(emitters, g_deltaTime, m_frameIndex), g_capacity);
+         this->run_frame(emitters, spawnCount);
+         simulation.update(emitters, g_deltaTime);
+      }
+   }
+
+   void expect_matches_reference(const ParticleSimulation& simulation)
+   {
+      auto& frame = this->current_frame();
+      const auto counters = read_buffer<ParticleCounters>(frame.counters, 1)[0];
+      ASSERT_EQ(counters.aliveCount, simulation.alive_slots().size());
+      ASSERT_EQ(counters.deadCount, simulation.dead_slots().size());
+
+      const auto drawCall = read_buffer<DrawIndirectCommand>(frame.drawCall, 1)[0];
+      EXPECT_EQ(drawCall.instanceCount, counters.aliveCount);
+      const auto simulateDispatch = read_buffer<DispatchIndirectCommand>(frame.simulateDispatch, 1)[0];
+      EXPECT_EQ(simulateDispatch.groupCountX, (counters.aliveCount + 255) / 256);
+
+      // The alive and dead lists cover the pool.
+      auto slots = read_buffer<u32>(frame.alive, counters.aliveCount);
+      const auto aliveSlots = slots;
+      const auto deadSlots = read_buffer<u32>(*m_dead, counters.deadCount);
+      slots.insert(slots.end(), deadSlots.begin(), deadSlots.end());
+      std::ranges::sort(slots);
+      std::vector<u32> expectedSlots(g_capacity);
+      std::iota(expectedSlots.begin(), expectedSlots.end(), 0);
+      EXPECT_EQ(slots, expectedSlots);
+
+      const auto pool = read_buffer<Particle>(frame.particles, g_capacity);
+      std::vector<Particle> particles;
+      std::ranges::transform(aliveSlots, std::back_inserter(particles), [&pool](const u32 slot) { return pool[slot]; });
+      std::vector<Particle> expectedParticles;
+      std::ranges::transform(simulation.alive_slots(), std::back_inserter(expectedParticles),
+                             [&simulation](const u32 slot) { return simulation.particle(slot); });
+
+      particles = sorted_particles(std::move(particles));
+      expectedParticles = sorted_particles(std::move(expectedParticles));
+      for (std::size_t i = 0; i < particles.size(); ++i) {
+         expect_near(particles[i].position, expectedParticles[i].position, i);
+         expect_near(particles[i].velocity, expectedParticles[i].velocity, i);
+         expect_near(particles[i].properties, expectedParticles[i].properties, i);
+      }
+   }
+
+   std::optional<Instance> m_instance;
+   DeviceUPtr m_device;
+   std::optional<Pipeline> m_resetPipeline;
+   std::optional<Pipeline> m_simulatePipeline;
+   std::optional<Pipeline> m_emitPipeline;
+   std::optional<Pipeline> m_finalizePipeline;
+   std::optional<Buffer> m_dead;
+   std::optional<Buffer> m_emitters;
+   std::vector<FrameBuffers> m_frames;
+   u32 m_frameIndex{};
+};
+
+TEST_F(ParticlesGpuTest, MatchesReferenceSimulation)
+{
+   std::array emitters{create_emitter(3000.0f, 0.3f), create_emitter(1000.0f, 1.0f)};
+   ParticleSimulation simulation(g_capacity);
+
+   // The pool fills up after a few frames, from then on spawns are limited by the dead count.
+   for (u32 step = 0; step < 10; ++step) {
+      this->run_frames(simulation, emitters, 10);
+      this->expect_matches_reference(simulation);
+   }
+}
+
+TEST_F(ParticlesGpuTest, AllParticlesExpire)
+{
+   std::array emitters{create_emitter(600.0f, 0.25f)};
+   ParticleSimulation simulation(g_capacity);
+
+   this->run_frames(simulation, emitters, 10);
+   this->expect_matches_reference(simulation);
+   ASSERT_FALSE(simulation.alive_slots().empty());
+
+   // Without live particles the simulate dispatch is empty.
+   emitters[0].spawnRate = 0.0f;
+   this->run_frames(simulation, emitters, 40);
+   this->expect_matches_reference(simulation);
+   EXPECT_TRUE(simulation.alive_slots().empty());
+}
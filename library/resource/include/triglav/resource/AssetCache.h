@@ -0,0 +1,187 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+#include "triglav/io/Path.h"
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace triglav::resource {
+
+// Identifies a cooked artifact by its content, changing the source, the importer or its options gives a different key.
+struct CacheKey
+{
+   u64 high{};
+   u64 low{};
+
+   [[nodiscard]] std::string to_string() const;
+
+   auto operator<=>(const CacheKey& other) const = default;
+};
+
+struct AssetCacheStats
+{
+   u32 hitCount{};
+   u32 missCount{};
+};
+
+// Directory of cooked artifacts, such as parsed meshes and decoded images, that loaders check before
+// doing the import again. Each entry is a file named after its key. Entries are written to a unique
+// temporary file that is renamed into place, so any number of processes and threads may write the
+// same entry, readers see either no entry or a complete one.
+//
+// Reading an entry refreshes its modification time, garbage collection removes the least recently
+// used entries until the directory fits the size limit. A size limit of zero disables the cache.
+class AssetCache
+{
+ public:
+   AssetCache(io::Path directory, MemorySize maxSize);
+
+   [[nodiscard]] static CacheKey make_key(std::span<const u8> source, std::string_view importer, u32 importerVersion,
+                                          std::string_view options);
+
+   [[nodiscard]] std::optional<std::vector<u8>> read(const CacheKey& key);
+   // Returns false if the entry could not be written, the cache is only an optimization so loading continues regardless.
+   bool write(const CacheKey& key, std::span<const u8> data);
+   void collect_garbage();
+
+   [[nodiscard]] bool is_enabled() const;
+   [[nodiscard]] MemorySize max_size() const;
+   [[nodiscard]] AssetCacheStats stats() const;
+
+   // Cache in the directory given by -cacheDir, or asset_cache in the build directory. The size limit in MiB
+   // is given by -cacheSize.
+   [[nodiscard]] static AssetCache& the();
+
+ private:
+   [[nodiscard]] std::filesystem::path entry_path(const CacheKey& key) const;
+
+   std::filesystem::path m_directory;
+   MemorySize m_maxSize;
+   bool m_isEnabled{};
+   std::atomic<u32> m_hitCount{};
+   std::atomic<u32> m_missCount{};
+   std::mutex m_garbageCollectionMutex;
+};
+
+// Serializes cooked data into an entry, values are stored in their in-memory representation.
+class CacheWriter
+{
+ public:
+   template<typename T>
+   void write(const T& value)
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto offset = m_data.size();
+      m_data.resize(offset + sizeof(T));
+      std::memcpy(m_data.data() + offset, &value, sizeof(T));
+   }
+
+   template<typename T>
+   void write_array(const std::span<const T> values)
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      this->write<u64>(values.size());
+      const auto offset = m_data.size();
+      m_data.resize(offset + values.size_bytes());
+      std::memcpy(m_data.data() + offset, values.data(), values.size_bytes());
+   }
+
+   void write_string(const std::string_view value)
+   {
+      this->write_array(std::span{value.data(), value.size()});
+   }
+
+   [[nodiscard]] std::span<const u8> data() const
+   {
+      return m_data;
+   }
+
+ private:
+   std::vector<u8> m_data;
+};
+
+// Reads the values in the order they were written, any read past the end of the data fails the whole reader.
+class CacheReader
+{
+ public:
+   explicit CacheReader(const std::span<const u8> data) :
+       m_data(data)
+   {
+   }
+
+   template<typename T>
+   T read()
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      T result{};
+      if (not this->check_remaining(sizeof(T)))
+         return result;
+      std::memcpy(&result, m_data.data() + m_offset, sizeof(T));
+      m_offset += sizeof(T);
+      return result;
+   }
+
+   template<typename T>
+   std::vector<T> read_array()
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto count = this->read<u64>();
+      if (count > m_data.size() / sizeof(T) || not this->check_remaining(count * sizeof(T)))
+         return {};
+      std::vector<T> result(count);
+      std::memcpy(result.data(), m_data.data() + m_offset, count * sizeof(T));
+      m_offset += count * sizeof(T);
+      return result;
+   }
+
+   // Returns the bytes of an array without copying them, the span points into the data of the reader.
+   template<typename T>
+   std::span<const u8> read_array_bytes()
+   {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const auto count = this->read<u64>();
+      if (count > m_data.size() / sizeof(T) || not this->check_remaining(count * sizeof(T)))
+         return {};
+      const auto result = m_data.subspan(m_offset, count * sizeof(T));
+      m_offset += count * sizeof(T);
+      return result;
+   }
+
+   // Returns the string without copying it, the view points into the data of the reader.
+   std::string_view read_string_view()
+   {
+      const auto chars = this->read_array_bytes<char>();
+      return {reinterpret_cast<const char*>(chars.data()), chars.size()};
+   }
+
+   // True if all reads succeeded and consumed the whole data.
+   [[nodiscard]] bool is_complete() const
+   {
+      return m_isValid && m_offset == m_data.size();
+   }
+
+ private:
+   bool check_remaining(const MemorySize size)
+   {
+      if (not m_isValid || m_data.size() - m_offset < size) {
+         m_isValid = false;
+         return false;
+      }
+      return true;
+   }
+
+   std::span<const u8> m_data;
+   MemorySize m_offset{};
+   bool m_isValid{true};
+};
+
+}// namespace triglav::resource
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PackArchive.h"
+
+#include "triglav/Int.hpp"
+#include "triglav/io/File.h"
+#include "triglav/io/Path.h"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace triglav::resource {
+
+// Contents of an asset, a view of a mapped pack archive or a buffer with the contents read from disk.
+class AssetData
+{
+ public:
+   explicit AssetData(std::span<const u8> data);
+   explicit AssetData(std::vector<u8>&& buffer);
+
+   AssetData(const AssetData& other) = delete;
+   AssetData& operator=(const AssetData& other) = delete;
+   AssetData(AssetData&& other) noexcept = default;
+   AssetData& operator=(AssetData&& other) noexcept = default;
+
+   [[nodiscard]] std::span<const u8> bytes() const;
+   [[nodiscard]] std::string_view text() const;
+   [[nodiscard]] bool empty() const;
+
+ private:
+   std::vector<u8> m_buffer;
+   std::span<const u8> m_data;
+};
+
+// File of an asset, either a loose file or an entry of a mounted pack archive. Loaders read the
+// contents through it, so they don't depend on where the asset is stored.
+class AssetFile
+{
+ public:
+   explicit AssetFile(io::Path path);
+   explicit AssetFile(const PackEntry& entry);
+
+   // Path of a loose file or the path the archive entry was packed from, for diagnostics and extension checks.
+   [[nodiscard]] std::string_view name() const;
+   // Path of a loose file, archive entries have none.
+   [[nodiscard]] const std::optional<io::Path>& path() const;
+   [[nodiscard]] bool is_packed() const;
+
+   // Reads the whole contents, uncompressed archive entries are returned without a copy. Empty if reading fails.
+   [[nodiscard]] AssetData read() const;
+   // Opens the contents for reading parts of them, loose files are not read whole.
+   [[nodiscard]] io::Result<io::IFileUPtr> open() const;
+
+   // Loose files opened for reading since the start, the opens a pack archive saves.
+   [[nodiscard]] static u32 loose_file_open_count();
+
+ private:
+   std::optional<io::Path> m_path;
+   std::optional<PackEntry> m_entry;
+   std::string m_name;
+};
+
+}// namespace triglav::resource
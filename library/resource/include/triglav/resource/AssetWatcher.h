@@ -0,0 +1,54 @@
+#pragma once
+
+#include "triglav/Name.hpp"
+#include "triglav/io/FileWatcher.h"
+#include "triglav/io/Path.h"
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace triglav::resource {
+
+// Assets to reload after their files change, grouped in waves. An asset comes in a later wave than
+// any reloaded asset it depends on, so it's loaded once the new versions of its dependencies are in place.
+using ReloadWaves = std::vector<std::vector<ResourceName>>;
+
+// Watches the files of the loaded assets and tracks the assets that depend on them. A changed file
+// invalidates the assets loaded from it together with their dependents, for example a changed shader
+// invalidates the material templates that use it and the materials of these templates.
+class AssetWatcher
+{
+ public:
+   explicit AssetWatcher(io::IFileWatcherUPtr fileWatcher);
+
+   // Assets without a path, like the ones read from pack archives, are only reloaded as dependents.
+   void add_asset(ResourceName name, const std::optional<io::Path>& path, std::span<const ResourceName> dependencies);
+   void remove_asset(ResourceName name);
+
+   // Returns the assets invalidated by the files changed since the last call.
+   [[nodiscard]] ReloadWaves poll_changes();
+   [[nodiscard]] ReloadWaves invalidate(std::span<const io::Path> changedFiles) const;
+
+ private:
+   struct Asset
+   {
+      std::optional<std::string> path{};
+      std::vector<ResourceName> dependencies{};
+      std::vector<ResourceName> dependents{};
+   };
+
+   void remove_asset_internal(ResourceName name);
+
+   io::IFileWatcherUPtr m_fileWatcher;
+   std::map<ResourceName, Asset> m_assets;
+   std::map<std::string, std::vector<ResourceName>> m_assetsByPath;
+   std::set<std::string> m_watchedDirectories;
+   mutable std::mutex m_mutex;
+};
+
+}// namespace triglav::resource
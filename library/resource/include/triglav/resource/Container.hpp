@@ -1,12 +1,17 @@
 #pragma once
 
 #include "triglav/Name.hpp"
+#include "triglav/ResourceHandle.hpp"
+#include "triglav/SlotArray.hpp"
 
+#include <atomic>
+#include <cassert>
 #include <map>
 #include <mutex>
-#include <ranges>
 #include <shared_mutex>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace triglav::resource {
 
@@ -16,32 +21,99 @@ class IContainer
    virtual ~IContainer() = default;
 
    [[nodiscard]] virtual bool is_name_registered(ResourceName name) const = 0;
+   // Appends the resources marked as used in the frame.
+   virtual void collect_used_resources(u64 frameIndex, std::vector<ResourceName>& names) const = 0;
 };
 
+// Resources of a single type stored in dense slots. Render code resolves a name to a handle once,
+// handles are resolved without locking. The names are only looked up while loading and debugging.
 template<ResourceType CResourceType>
 class Container final : public IContainer
 {
  public:
    using ResName = TypedName<CResourceType>;
+   using Handle = ResourceHandle<CResourceType>;
    using ValueType = typename EnumToCppResourceType<CResourceType>::ResourceType;
 
    ValueType& get(const ResName name)
    {
       std::shared_lock lk{m_mutex};
-      return m_map.at(name);
+      return m_slots[m_names.at(name)].value;
+   }
+
+   // Throws if the resource was removed, the handle of a reloaded resource stays valid.
+   ValueType& get(const Handle handle)
+   {
+      if (not this->is_valid(handle))
+         throw std::out_of_range("stale resource handle");
+      return m_slots[handle.index()].value;
+   }
+
+   [[nodiscard]] Handle handle(const ResName name) const
+   {
+      std::shared_lock lk{m_mutex};
+      const auto index = m_names.at(name);
+      return Handle{index, m_slots.generation(index)};
+   }
+
+   [[nodiscard]] ResName name(const Handle handle) const
+   {
+      if (not this->is_valid(handle))
+         throw std::out_of_range("stale resource handle");
+      return m_slots[handle.index()].name;
+   }
+
+   // Stamps the slot with the frame without locking, render code marks each resource it draws.
+   void mark_used(const Handle handle, const u64 frameIndex)
+   {
+      if (this->is_valid(handle)) {
+         m_slots[handle.index()].lastUsedFrame.store(frameIndex, std::memory_order_relaxed);
+      }
+   }
+
+   [[nodiscard]] bool is_valid(const Handle handle) const
+   {
+      return m_slots.contains(SlotKey{handle.index(), handle.generation()});
    }
 
    template<typename... TArgs>
-   void register_emplace(const ResName name, TArgs... args)
+   void register_emplace(const ResName name, TArgs&&... args)
    {
       std::unique_lock lk{m_mutex};
-      m_map.emplace(name, std::forward<TArgs>(args)...);
+      if (m_names.contains(name))
+         return;
+      const auto key = m_slots.emplace(name, std::forward<TArgs>(args)...);
+      m_names.emplace(name, key.index);
    }
 
    void register_resource(const ResName name, ValueType&& resource)
    {
       std::unique_lock lk{m_mutex};
-      m_map.emplace(name, std::move(resource));
+      if (m_names.contains(name))
+         return;
+      const auto key = m_slots.emplace(name, std::move(resource));
+      m_names.emplace(name, key.index);
+   }
+
+   // Swaps the value of a registered resource and returns the previous one. References and handles to the resource stay
+   // valid and refer to the new value, the previous value needs to outlive any GPU work that still uses it.
+   [[nodiscard]] ValueType replace(const ResName name, ValueType&& resource)
+   {
+      std::unique_lock lk{m_mutex};
+      auto& value = m_slots[m_names.at(name)].value;
+      auto previous = std::move(value);
+      value = std::move(resource);
+      return previous;
+   }
+
+   // Removes the resource and returns its value, the slot is reused with a new generation so handles to it become invalid.
+   [[nodiscard]] ValueType erase(const ResName name)
+   {
+      std::unique_lock lk{m_mutex};
+      const auto node = m_names.extract(name);
+      auto value = std::move(m_slots[node.mapped()].value);
+      m_slots.erase(node.mapped());
+      return value;
    }
 
    [[nodiscard]] bool is_name_registered(const ResourceName name) const override
@@ -50,20 +122,48 @@ class Container final : public IContainer
          return false;
 
       std::shared_lock lk{m_mutex};
-      return m_map.contains(ResName{name});
+      return m_names.contains(ResName{name});
    }
 
+   void collect_used_resources(const u64 frameIndex, std::vector<ResourceName>& names) const override
+   {
+      std::shared_lock lk{m_mutex};
+      for (const auto& [name, index] : m_names) {
+         if (m_slots[index].lastUsedFrame.load(std::memory_order_relaxed) == frameIndex) {
+            names.emplace_back(name);
+         }
+      }
+   }
+
+   // Visits the registered resources under a shared lock, so they can't be replaced or removed meanwhile.
+   // The loaders wait with registering new resources, func must not call back into this container.
    template<typename TFunc>
-   void iterate_resources(TFunc func)
+   void iterate_resources(TFunc func) const
    {
-      for (const auto& [name, value] : m_map) {
-         func(name, value);
+      std::shared_lock lk{m_mutex};
+      for (const auto& [name, index] : m_names) {
+         func(name, m_slots[index].value);
       }
    }
 
  private:
-   std::map<ResName, ValueType> m_map{};
+   struct Entry
+   {
+      template<typename... TArgs>
+      explicit Entry(const ResName name, TArgs&&... args) :
+          name(name),
+          value(std::forward<TArgs>(args)...)
+      {
+      }
+
+      ResName name;
+      ValueType value;
+      std::atomic<u64> lastUsedFrame{};
+   };
+
+   SlotArray<Entry> m_slots;
+   std::map<ResName, u32> m_names{};
    mutable std::shared_mutex m_mutex;
 };
 
-}// namespace triglav::resource
\ No newline at end of file
+}// namespace triglav::resource
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace triglav::resource {
+
+// Decoded image with four 8-bit channels per pixel.
+struct DecodedImage
+{
+   u32 width{};
+   u32 height{};
+   std::vector<u8> pixels;
+};
+
+class IImageDecoder
+{
+ public:
+   virtual ~IImageDecoder() = default;
+
+   [[nodiscard]] virtual std::string_view name() const = 0;
+   // Checks the signature of the encoded data, decoding may still fail.
+   [[nodiscard]] virtual bool can_decode(std::span<const u8> data) const = 0;
+   [[nodiscard]] virtual std::optional<DecodedImage> decode(std::span<const u8> data) const = 0;
+};
+
+using IImageDecoderUPtr = std::unique_ptr<IImageDecoder>;
+
+// PNG decoder backed by libpng, which decodes with zlib and SIMD row filters.
+class PngImageDecoder final : public IImageDecoder
+{
+ public:
+   [[nodiscard]] std::string_view name() const override;
+   [[nodiscard]] bool can_decode(std::span<const u8> data) const override;
+   [[nodiscard]] std::optional<DecodedImage> decode(std::span<const u8> data) const override;
+};
+
+// JPEG decoder backed by libjpeg-turbo, which has SIMD IDCT, upsampling and color conversion.
+// Large images are split into horizontal strips decoded on the thread pool. Each strip still
+// reads the entropy coded data before it, the rest of the work is divided between the threads.
+class JpegImageDecoder final : public IImageDecoder
+{
+ public:
+   explicit JpegImageDecoder(u32 maxStripCount);
+
+   [[nodiscard]] std::string_view name() const override;
+   [[nodiscard]] bool can_decode(std::span<const u8> data) const override;
+   [[nodiscard]] std::optional<DecodedImage> decode(std::span<const u8> data) const override;
+
+ private:
+   u32 m_maxStripCount;
+};
+
+// Decodes any format supported by stb_image.
+class StbImageDecoder final : public IImageDecoder
+{
+ public:
+   [[nodiscard]] std::string_view name() const override;
+   [[nodiscard]] bool can_decode(std::span<const u8> data) const override;
+   [[nodiscard]] std::optional<DecodedImage> decode(std::span<const u8> data) const override;
+};
+
+// Picks the first backend that accepts the data, stb_image decodes whatever the backends don't support or fail on.
+class ImageDecoder
+{
+ public:
+   ImageDecoder();
+   explicit ImageDecoder(std::vector<IImageDecoderUPtr> backends);
+
+   [[nodiscard]] std::optional<DecodedImage> decode(std::span<const u8> data) const;
+   // Name of the backend that would decode the data first.
+   [[nodiscard]] std::string_view backend_name(std::span<const u8> data) const;
+
+   [[nodiscard]] static ImageDecoder& the();
+
+ private:
+   std::vector<IImageDecoderUPtr> m_backends;
+   StbImageDecoder m_fallback;
+};
+
+}// namespace triglav::resource
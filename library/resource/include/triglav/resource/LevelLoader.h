@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Loader.hpp"
 
 #include "triglav/Name.hpp"
@@ -7,6 +8,7 @@
 #include "triglav/world/Level.h"
 
 #include <string_view>
+#include <vector>
 
 namespace triglav::resource {
 
@@ -15,7 +17,8 @@ struct Loader<ResourceType::Level>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Static};
 
-   static world::Level load(const io::Path& path);
+   static world::Level load(const AssetFile& file);
+   static std::vector<ResourceName> collect_references(const world::Level& level);
 };
 
 }// namespace triglav::resource
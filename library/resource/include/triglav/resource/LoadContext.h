@@ -1,57 +1,137 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Resource.hpp"
 
 #include "triglav/Int.hpp"
+#include "triglav/Name.hpp"
 #include "triglav/io/Path.h"
 
+#include <array>
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
+#include <optional>
 #include <shared_mutex>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace triglav::resource {
 
+class AssetCache;
+
+// Classes of assets in the order they are loaded, the steps of an asset in a higher class are taken first.
+enum class LoadPriority : u8
+{
+   // Rendering can't start without them: shaders, material templates and the starting level with its models and materials.
+   Required,
+   // Visible in the first frame, the renderer draws placeholders until they are loaded.
+   Visible,
+   Background,
+};
+
+constexpr u32 g_loadPriorityCount = 3;
+
+// Shaders and material templates are needed by every pipeline, the other assets are prioritized by what references them.
+[[nodiscard]] LoadPriority default_load_priority(ResourceType type);
+
 struct ResourcePath
 {
    std::string name;
    std::string source;
    ResourceProperties properties;
-};
-
-struct ResourceStage
-{
-   std::vector<ResourcePath> resourceList;
+   LoadPriority priority{LoadPriority::Background};
 };
 
 enum class FinishLoadingAssetResult
 {
    None,
-   FinishedStage,
+   // The required assets are loaded while the others are still loading, reported once.
+   FinishedLoadingRequiredAssets,
    FinishedLoadingAssets,
 };
 
+enum class LoadStep
+{
+   // Resolves the file and the dependencies of the asset.
+   Prepare,
+   Load,
+};
+
+struct LoadTask
+{
+   ResourceName name;
+   LoadStep step;
+};
+
+// Tracks the dependencies between the assets of an asset list. An asset is ready to load as soon as
+// the assets it depends on are loaded, dependencies outside of the list are expected to be loaded already.
+// The steps of the assets are queued by their priority, the dependencies of an asset take its priority.
 class LoadContext
 {
  public:
-   explicit LoadContext(std::vector<ResourceStage>&& loadingStages);
+   using Clock = std::chrono::steady_clock;
 
-   const ResourceStage& next_stage();
-   FinishLoadingAssetResult finish_loading_asset();
+   explicit LoadContext(std::vector<ResourcePath>&& assets);
+
+   [[nodiscard]] std::vector<ResourceName> asset_names() const;
+   [[nodiscard]] const ResourcePath& resource(ResourceName name) const;
+   // Resolved file of the asset, set together with its dependencies.
+   [[nodiscard]] const AssetFile& file(ResourceName name) const;
+
+   // Returns true if the asset can be loaded right away, otherwise it's returned
+   // from finish_loading_asset once its last dependency is loaded.
+   bool set_dependencies(ResourceName name, const AssetFile& file, std::span<const ResourceName> dependencies);
+   FinishLoadingAssetResult finish_loading_asset(ResourceName name, std::vector<ResourceName>& readyAssets);
+
+   void enqueue(LoadTask task);
+   // Takes the queued task of the highest priority, one is taken for each enqueued task.
+   [[nodiscard]] std::optional<LoadTask> next_task();
+   // Assets outside of the list, like the ones reloaded meanwhile, are loaded in the background.
+   [[nodiscard]] LoadPriority priority(ResourceName name) const;
+   // Raises the priority of a listed asset and of the dependencies it waits for, queued tasks move to the new class.
+   void promote(ResourceName name, LoadPriority priority);
 
    [[nodiscard]] u32 total_assets() const;
    [[nodiscard]] u32 total_loaded_assets() const;
-   [[nodiscard]] u32 current_stage_id() const;
+   [[nodiscard]] Clock::duration elapsed_time() const;
+   // Time the dependencies of the asset were set, it waits for them from then until it's ready.
+   [[nodiscard]] Clock::time_point prepared_time(ResourceName name) const;
+   // Chain of assets that determined the loading time, each waiting for the previous one.
+   [[nodiscard]] std::string critical_path() const;
 
    static std::unique_ptr<LoadContext> from_asset_list(const io::Path& path);
+   // The compiled manifest of the asset list is stored in the cache, keyed by the contents of the list.
+   static std::unique_ptr<LoadContext> from_asset_list(const io::Path& path, AssetCache& cache);
 
  private:
-   u32 m_assetsLoadedInStage{};
-   u32 m_totalAssets{};
+   struct Asset
+   {
+      ResourcePath resourcePath;
+      std::optional<AssetFile> file{};
+      LoadPriority priority{};
+      std::optional<LoadStep> queuedStep{};
+      u32 pendingDependencyCount{};
+      // Dependencies in the list that weren't loaded when the asset was prepared.
+      std::vector<ResourceName> dependencies{};
+      std::vector<ResourceName> dependents{};
+      std::optional<ResourceName> lastDependency{};
+      Clock::time_point preparedTime{};
+      Clock::time_point readyTime{};
+      std::optional<Clock::time_point> finishTime{};
+   };
+
+   void promote_locked(ResourceName name, LoadPriority priority);
+
+   std::map<ResourceName, Asset> m_assets;
+   std::array<std::deque<ResourceName>, g_loadPriorityCount> m_queuedAssets;
    u32 m_totalLoadedAssets{};
-   u32 m_currentStageId{};
-   std::vector<ResourceStage> m_loadingStages{};
+   u32 m_pendingRequiredAssets{};
+   bool m_hasLoadedRequiredAssets{false};
+   Clock::time_point m_startTime;
    mutable std::shared_mutex m_mutex;
 };
 
-}// namespace triglav::resource
\ No newline at end of file
+}// namespace triglav::resource
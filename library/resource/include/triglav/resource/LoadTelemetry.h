@@ -0,0 +1,116 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+#include "triglav/Name.hpp"
+#include "triglav/threading/Threading.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace triglav::resource {
+
+enum class LoadPhase : u8
+{
+   FileRead,
+   Decode,
+   Process,
+   Upload,
+   // Time between resolving the dependencies of an asset and the last of them being loaded.
+   DependencyWait,
+   Count,
+};
+
+[[nodiscard]] std::string_view load_phase_name(LoadPhase phase);
+
+struct LoadEvent
+{
+   using Clock = std::chrono::steady_clock;
+
+   ResourceName asset;
+   LoadPhase phase;
+   threading::ThreadID thread;
+   Clock::time_point start;
+   Clock::time_point end;
+};
+
+// Records the phases of loading assets, each thread writes its own ring buffer without locking.
+//
+// When a buffer is full the oldest events are overwritten. The events are meant to be read once
+// loading is finished, reading while the threads still record may return events being overwritten.
+class LoadTelemetry
+{
+ public:
+   using Clock = LoadEvent::Clock;
+   using AssetNameFunc = std::function<std::string(ResourceName)>;
+
+   static constexpr u32 g_maxThreadCount = 64;
+
+   explicit LoadTelemetry(u32 eventsPerThread);
+
+   void record(ResourceName asset, LoadPhase phase, Clock::time_point start, Clock::time_point end);
+
+   // Events that started after the time point, ordered by their start.
+   [[nodiscard]] std::vector<LoadEvent> events(Clock::time_point since) const;
+
+   // Trace event format of chrome://tracing and Perfetto. Phases are shown per thread, dependency waits
+   // overlap arbitrarily and are exported as async events of their asset.
+   [[nodiscard]] std::string chrome_trace(Clock::time_point since, const AssetNameFunc& assetName) const;
+   // Time spent in each phase per resource type.
+   [[nodiscard]] std::string summary(Clock::time_point since) const;
+
+   [[nodiscard]] static LoadTelemetry& the();
+
+ private:
+   struct ThreadBuffer
+   {
+      std::vector<LoadEvent> events;
+      std::atomic<u64> writeCount{};
+   };
+
+   ThreadBuffer* thread_buffer(threading::ThreadID thread);
+
+   u32 m_eventsPerThread;
+   std::array<std::atomic<ThreadBuffer*>, g_maxThreadCount> m_threadBuffers{};
+   std::vector<std::unique_ptr<ThreadBuffer>> m_ownedBuffers;
+   std::mutex m_allocationMutex;
+};
+
+// Makes the asset the one phases of the current thread are recorded for.
+class LoadAssetScope
+{
+ public:
+   explicit LoadAssetScope(ResourceName asset);
+   ~LoadAssetScope();
+
+   LoadAssetScope(const LoadAssetScope& other) = delete;
+   LoadAssetScope& operator=(const LoadAssetScope& other) = delete;
+
+ private:
+   ResourceName m_previousAsset;
+};
+
+// Times a phase of the asset loaded by the current thread, nothing is recorded outside of a LoadAssetScope.
+class LoadPhaseScope
+{
+ public:
+   explicit LoadPhaseScope(LoadPhase phase);
+   ~LoadPhaseScope();
+
+   LoadPhaseScope(const LoadPhaseScope& other) = delete;
+   LoadPhaseScope& operator=(const LoadPhaseScope& other) = delete;
+
+   // Ends the current phase and starts timing the next one.
+   void next(LoadPhase phase);
+
+ private:
+   LoadPhase m_phase;
+   LoadTelemetry::Clock::time_point m_start;
+};
+
+}// namespace triglav::resource
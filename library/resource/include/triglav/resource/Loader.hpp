@@ -1,7 +1,15 @@
 #pragma once
 
+#include "AssetFile.h"
+#include "Resource.hpp"
+
+#include "triglav/Int.hpp"
+#include "triglav/Name.hpp"
 #include "triglav/ResourceType.hpp"
 
+#include <concepts>
+#include <vector>
+
 namespace triglav::resource {
 
 enum class ResourceLoadType
@@ -20,4 +28,23 @@ struct Loader
    constexpr static ResourceLoadType type{ResourceLoadType::None};
 };
 
-}// namespace triglav::resource
\ No newline at end of file
+// Loaders that read other resources while loading list them, the asset is scheduled once they are loaded.
+template<ResourceType CResourceType>
+concept HasDependencies = requires(const AssetFile& file, const ResourceProperties& props) {
+   { Loader<CResourceType>::collect_dependencies(file, props) } -> std::same_as<std::vector<ResourceName>>;
+};
+
+// Resources that name other assets without reading them while loading, like the models of a level, list them.
+// The assets referenced by a prioritized asset are loaded with its priority.
+template<ResourceType CResourceType>
+concept HasReferences = requires(const typename EnumToCppResourceType<CResourceType>::ResourceType& resource) {
+   { Loader<CResourceType>::collect_references(resource) } -> std::same_as<std::vector<ResourceName>>;
+};
+
+// Loaders report the memory their resources take, resources of other types count with their object size.
+template<ResourceType CResourceType>
+concept HasResourceSize = requires(const typename EnumToCppResourceType<CResourceType>::ResourceType& resource) {
+   { Loader<CResourceType>::resource_size(resource) } -> std::same_as<MemorySize>;
+};
+
+}// namespace triglav::resource
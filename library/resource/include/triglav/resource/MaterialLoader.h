@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Loader.hpp"
 #include "ResourceManager.h"
 
@@ -8,6 +9,7 @@
 #include "triglav/render_core/Material.hpp"
 
 #include <string_view>
+#include <vector>
 
 namespace triglav::resource {
 
@@ -16,7 +18,9 @@ struct Loader<ResourceType::MaterialTemplate>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Static};
 
-   static render_core::MaterialTemplate load(const io::Path& path);
+   static render_core::MaterialTemplate load(const AssetFile& file);
+   // The shaders, pipelines built from the template are rebuilt once they are reloaded.
+   static std::vector<ResourceName> collect_dependencies(const AssetFile& file, const ResourceProperties& props);
 };
 
 template<>
@@ -24,7 +28,11 @@ struct Loader<ResourceType::Material>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::StaticDependent};
 
-   static render_core::Material load(ResourceManager& manager, const io::Path& path);
+   static render_core::Material load(ResourceManager& manager, const AssetFile& file);
+   // The material template, textures are only referenced by name.
+   static std::vector<ResourceName> collect_dependencies(const AssetFile& file, const ResourceProperties& props);
+   // The textures of the material.
+   static std::vector<ResourceName> collect_references(const render_core::Material& material);
 };
 
 }// namespace triglav::resource
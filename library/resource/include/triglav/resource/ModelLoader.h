@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Loader.hpp"
 #include "Resource.hpp"
 
@@ -8,6 +9,7 @@
 #include "triglav/render_core/Model.hpp"
 
 #include <string_view>
+#include <vector>
 
 namespace triglav::resource {
 
@@ -16,7 +18,10 @@ struct Loader<ResourceType::Model>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Graphics};
 
-   static render_core::Model load_gpu(graphics_api::Device& device, const io::Path& path, const ResourceProperties& props);
+   static render_core::Model load_gpu(graphics_api::Device& device, const AssetFile& file, const ResourceProperties& props);
+   static MemorySize resource_size(const render_core::Model& model);
+   // The materials of the ranges.
+   static std::vector<ResourceName> collect_references(const render_core::Model& model);
 };
 
 }// namespace triglav::resource
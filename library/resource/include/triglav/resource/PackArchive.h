@@ -0,0 +1,82 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+#include "triglav/Name.hpp"
+#include "triglav/io/MappedFile.h"
+#include "triglav/io/Path.h"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace triglav::resource {
+
+enum class PackCompression : u32
+{
+   None,
+   Deflate,
+};
+
+// Payloads start at multiples of the alignment, so uncompressed entries can be used in place.
+constexpr MemorySize g_packPayloadAlignment = 64;
+
+struct PackEntry
+{
+   ResourceName name;
+   // Bytes as stored in the archive, compressed entries need to be unpacked.
+   std::span<const u8> data;
+   MemorySize size;
+   PackCompression compression;
+   // Path of the file the entry was packed from, relative to the content or build directory.
+   std::string_view source;
+};
+
+// Archive of the assets of an asset list, produced by the asset_pack tool.
+//
+// The archive starts with a header and an index of all entries sorted by resource name, followed by
+// the source paths and the payloads. The archive is mapped into memory, finding an entry is a binary
+// search of the index and uncompressed entries are views of the mapping, neither takes a syscall.
+class PackArchive
+{
+ public:
+   // Returns nothing if the file doesn't exist or isn't a valid archive.
+   [[nodiscard]] static std::optional<PackArchive> open(const io::Path& path);
+
+   [[nodiscard]] std::optional<PackEntry> find(ResourceName name) const;
+   [[nodiscard]] u32 entry_count() const;
+   [[nodiscard]] PackEntry entry(u32 index) const;
+
+   // Decompresses the entry, uncompressed entries are copied.
+   [[nodiscard]] static std::optional<std::vector<u8>> unpack(const PackEntry& entry);
+
+ private:
+   PackArchive(io::MappedFile&& file, u32 entryCount);
+
+   io::MappedFile m_file;
+   u32 m_entryCount;
+};
+
+// Builds an archive in memory.
+class PackWriter
+{
+ public:
+   // Compressed entries are stored uncompressed if compression doesn't make them smaller. Adding a name again replaces its entry.
+   void add(ResourceName name, std::string_view source, std::span<const u8> data, PackCompression compression);
+   [[nodiscard]] std::vector<u8> write() const;
+
+ private:
+   struct Entry
+   {
+      ResourceName name;
+      std::string source;
+      std::vector<u8> data;
+      MemorySize size;
+      PackCompression compression;
+   };
+
+   std::vector<Entry> m_entries;
+};
+
+}// namespace triglav::resource
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "AssetFile.h"
+#include "Loader.hpp"
+
+#include "triglav/io/Path.h"
+#include "triglav/render_core/ParticleEmitter.hpp"
+
+namespace triglav::resource {
+
+template<>
+struct Loader<ResourceType::ParticleEmitter>
+{
+   constexpr static ResourceLoadType type{ResourceLoadType::Static};
+
+   static render_core::ParticleEmitter load(const AssetFile& file);
+};
+
+}// namespace triglav::resource
@@ -12,6 +12,8 @@ class PathManager
  public:
    [[nodiscard]] io::Path content_path();
    [[nodiscard]] io::Path build_path();
+   // Directory of the asset cache, given by -cacheDir or asset_cache in the build directory.
+   [[nodiscard]] io::Path cache_path();
 
 
    [[nodiscard]] static PathManager& the();
@@ -19,6 +21,7 @@ class PathManager
  private:
    threading::SafeReadWriteAccess<std::optional<io::Path>> m_cachedContentPath;
    threading::SafeReadWriteAccess<std::optional<io::Path>> m_cachedBuildPath;
+   threading::SafeReadWriteAccess<std::optional<io::Path>> m_cachedCachePath;
 };
 
 }// namespace triglav::resource
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+#include "triglav/Name.hpp"
+
+#include <array>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace triglav::resource {
+
+// Reference counts and memory of the loaded resources, decides which ones to unload.
+//
+// Resources are owned by the asset lists that load them, by the resources that depend on or use them
+// and by explicit references. A resource nothing refers to stays loaded while its type fits the memory
+// budget, once the budget is exceeded the least recently used ones are evicted first. The budgets are
+// unlimited by default, a budget of zero keeps no unreferenced resources.
+class ResourceBudget
+{
+ public:
+   static constexpr MemorySize unlimited_budget = std::numeric_limits<MemorySize>::max();
+
+   ResourceBudget();
+
+   // Resources may be referenced before they are loaded.
+   void acquire(ResourceName name);
+   void release(ResourceName name);
+   // The resource references its dependencies until it is evicted.
+   void add_dependencies(ResourceName name, std::span<const ResourceName> dependencies);
+   // The resource references the assets it uses, like the textures of a material, until it is evicted.
+   // Replaces the references it held before, a reloaded resource may use different assets.
+   void set_references(ResourceName name, std::span<const ResourceName> references);
+
+   void add_resource(ResourceName name, MemorySize size);
+   // Updates the size of a loaded resource after it was reloaded.
+   void resize_resource(ResourceName name, MemorySize size);
+   // Marks the resource as the most recently used one.
+   void mark_used(ResourceName name);
+   // Marks the resources as used in one go, the last one becomes the most recently used.
+   void mark_used(std::span<const ResourceName> names);
+
+   void set_budget(ResourceType type, MemorySize budget);
+
+   // Removes and returns the resources to unload, a resource comes after the resources that depend on it.
+   [[nodiscard]] std::vector<ResourceName> collect_evictions();
+
+   [[nodiscard]] bool is_loaded(ResourceName name) const;
+   [[nodiscard]] u32 reference_count(ResourceName name) const;
+   [[nodiscard]] MemorySize used_size(ResourceType type) const;
+   [[nodiscard]] MemorySize budget(ResourceType type) const;
+
+ private:
+   struct Entry
+   {
+      u32 referenceCount{};
+      bool isLoaded{};
+      MemorySize size{};
+      u64 lastUsed{};
+      std::vector<ResourceName> dependencies{};
+      std::vector<ResourceName> references{};
+   };
+
+   void release_internal(ResourceName name);
+   [[nodiscard]] static int type_index(ResourceType type);
+
+   std::map<ResourceName, Entry> m_entries;
+   std::array<MemorySize, static_cast<int>(ResourceType::Unknown)> m_usedSize{};
+   std::array<MemorySize, static_cast<int>(ResourceType::Unknown)> m_budget{};
+   u64 m_useCounter{};
+   mutable std::mutex m_mutex;
+};
+
+}// namespace triglav::resource
@@ -1,27 +1,43 @@
 #pragma once
 
+#include "AssetCache.h"
+#include "AssetWatcher.h"
 #include "Container.hpp"
+#include "LoadTelemetry.h"
 #include "Loader.hpp"
 #include "NameRegistry.h"
+#include "PackArchive.h"
 #include "Resource.hpp"
+#include "ResourceBudget.h"
+#include "RetireQueue.hpp"
+#include "TextureResidency.h"
 
 #include "LoadContext.h"
 #include "triglav/Delegate.hpp"
 #include "triglav/Name.hpp"
+#include "triglav/ResourceHandle.hpp"
 #include "triglav/font/FontManager.h"
 #include "triglav/io/Path.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace triglav::graphics_api {
 class Device;
+class MipMapGenerator;
 }
 
 namespace triglav::resource {
 
+class TextureStreamer;
 
 class ResourceManager
 {
@@ -35,11 +51,52 @@ class ResourceManager
    using OnLoadedAssetsDel = Delegate<>;
    OnLoadedAssetsDel OnLoadedAssets;
 
+   // Published once the required assets of an asset list are loaded while the others are still loading.
+   using OnLoadedRequiredAssetsDel = Delegate<>;
+   OnLoadedRequiredAssetsDel OnLoadedRequiredAssets;
+
+   // Published by begin_frame with the assets loaded since the previous frame, render code swaps the placeholders
+   // of the assets it was waiting for.
+   using OnAddedAssetsDel = Delegate<std::span<const ResourceName>>;
+   OnAddedAssetsDel OnAddedAssets;
+
+   // Published by begin_frame after a wave of reloaded resources replaced the previous ones.
+   using OnReloadedAssetsDel = Delegate<std::span<const ResourceName>>;
+   OnReloadedAssetsDel OnReloadedAssets;
+
    explicit ResourceManager(graphics_api::Device& device, font::FontManger& fontManager);
+   ~ResourceManager();
 
+   // The asset list references its assets until it is unloaded. The pack archive of the list in the build
+   // directory is mounted first unless -looseAssets is given. Assets are loaded by their priority class, assets
+   // referenced by a loaded asset, like the models of a level, are promoted to its class.
    void load_asset_list(const io::Path& path);
+   // Releases the assets of the list, the ones nothing else references are unloaded unless their type budget keeps them.
+   void unload_asset_list(const io::Path& path);
 
-   void load_asset(ResourceName assetName, const io::Path& path, const ResourceProperties& props);
+   // References keep a resource loaded, unreferenced resources are evicted under memory pressure.
+   void acquire(ResourceName name);
+   void release(ResourceName name);
+   // Resources that were used recently are evicted last, render code marks the resources it draws with each frame.
+   // Only stamps the slot of the handle, begin_frame passes the resources used in the frame to the budget once.
+   template<ResourceType CResourceType>
+   void mark_used(const ResourceHandle<CResourceType> handle)
+   {
+      container<CResourceType>().mark_used(handle, m_frameIndex);
+   }
+   // Memory unreferenced resources of the type may keep occupying. Textures and models have a limit by default, other
+   // types are unlimited. Zero keeps no unreferenced resources.
+   void set_memory_budget(ResourceType type, MemorySize budget);
+   [[nodiscard]] MemorySize memory_usage(ResourceType type) const;
+
+   // Assets found in a mounted archive are read from it instead of loose files, archives mounted first take precedence.
+   // Returns false if the archive doesn't exist or is invalid.
+   bool mount_pack_archive(const io::Path& path);
+
+   // Resources taken out of use are kept alive in the queue until the GPU can no longer use them.
+   [[nodiscard]] RetireQueue& retire_queue();
+
+   void load_asset(ResourceName assetName, const AssetFile& file, const ResourceProperties& props);
    [[nodiscard]] bool is_name_registered(ResourceName assetName) const;
 
    template<ResourceType CResourceType>
@@ -49,19 +106,33 @@ class ResourceManager
    }
 
    template<ResourceType CResourceType>
-   void load_resource(TypedName<CResourceType> name, const io::Path& path, const ResourceProperties& props)
+   auto& get(const ResourceHandle<CResourceType> handle)
    {
-      if constexpr (Loader<CResourceType>::type == ResourceLoadType::Graphics) {
-         container<CResourceType>().register_resource(name, Loader<CResourceType>::load_gpu(m_device, path, props));
-      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::GraphicsDependent) {
-         container<CResourceType>().register_resource(name, Loader<CResourceType>::load_gpu(*this, m_device, path));
-      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::Font) {
-         container<CResourceType>().register_resource(name, Loader<CResourceType>::load_font(m_fontManager, path));
-      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::StaticDependent) {
-         container<CResourceType>().register_resource(name, Loader<CResourceType>::load(*this, path));
-      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::Static) {
-         container<CResourceType>().register_resource(name, Loader<CResourceType>::load(path));
+      return container<CResourceType>().get(handle);
+   }
+
+   // Handles stay valid for as long as the resource is loaded, render code resolves them once and keeps them.
+   template<ResourceType CResourceType>
+   [[nodiscard]] ResourceHandle<CResourceType> handle(const TypedName<CResourceType> name)
+   {
+      return container<CResourceType>().handle(name);
+   }
+
+   template<ResourceType CResourceType>
+   [[nodiscard]] TypedName<CResourceType> name(const ResourceHandle<CResourceType> handle)
+   {
+      return container<CResourceType>().name(handle);
+   }
+
+   template<ResourceType CResourceType>
+   void load_resource(TypedName<CResourceType> name, const AssetFile& file, const ResourceProperties& props)
+   {
+      if constexpr (CResourceType == ResourceType::Texture) {
+         if (this->load_streamed_texture(name, file, props))
+            return;
       }
+
+      container<CResourceType>().register_resource(name, this->load_value<CResourceType>(file, props));
    }
 
    template<ResourceType CResourceType, typename... TArgs>
@@ -80,20 +151,224 @@ class ResourceManager
 
    std::optional<std::string> lookup_name(ResourceName resourceName) const;
 
+   // Shared compute mip generator, created on first use from the mip_downsample.cshader resource.
+   [[nodiscard]] graphics_api::MipMapGenerator& mip_map_generator();
+
+   // Called by the texture loader with the size of a loaded texture and the size it would have as RGBA8.
+   void report_texture_memory(MemorySize textureSize, MemorySize rgbaSize);
+   [[nodiscard]] MemorySize texture_memory() const;
+
+   // Cooked textures loaded afterwards start with their mip tail, the other levels are streamed on demand.
+   void enable_texture_streaming(const TextureResidencySettings& settings);
+   // Null unless texture streaming is enabled.
+   [[nodiscard]] TextureStreamer* texture_streamer() const;
+   // Called once per frame before any commands are recorded. Updates texture streaming, swaps in reloaded resources,
+   // evicts unreferenced resources over the budget and destroys the retired ones.
+   void begin_frame();
+
+   // Assets loaded afterwards from loose files are reloaded when their files change, together with the assets that
+   // depend on them. Returns false if files can't be watched on this platform.
+   bool enable_hot_reload();
+
  private:
-   void load_next_stage();
+   // Looks the asset up in the mounted archives, then in the build and content directories.
+   std::optional<AssetFile> resolve_asset_file(ResourceName name, std::string_view source);
+   // Queues the task in the load context and issues a job that runs the task of the highest priority.
+   void schedule(LoadTask task);
+   void run_load_task();
+   // Resolves the file and dependencies of an asset from the asset list, loads it if nothing is left to wait for.
+   void prepare_asset(ResourceName assetName);
+   // Schedules the assets that were waiting for this one.
+   void finish_loading_asset(ResourceName resourceName);
+   // Logs the loading time of the asset list, starts with a cold asset cache are reported separately from warm ones.
+   // The file system calls taken by loose files are logged with it, the ones pack archives save.
+   void report_load_time() const;
+   // Logs the time spent in each loading phase per type, -loadTrace=<path> writes the phases as a Chrome trace.
+   void report_load_phases() const;
+   void evict_resources();
+   // Returns false if the texture isn't streamed and needs to be loaded as a whole.
+   bool load_streamed_texture(TextureName name, const AssetFile& file, const ResourceProperties& props);
+   // Swaps in the reloaded resources once their wave is loaded, then starts loading the next wave. A new reload
+   // starts once the previous one finished and no asset list is loading.
+   void update_hot_reload();
+   void reload_asset(ResourceName assetName);
+
+   template<ResourceType CResourceType>
+   typename Container<CResourceType>::ValueType load_value(const AssetFile& file, const ResourceProperties& props)
+   {
+      if constexpr (Loader<CResourceType>::type == ResourceLoadType::Graphics) {
+         return Loader<CResourceType>::load_gpu(m_device, file, props);
+      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::GraphicsDependent) {
+         return Loader<CResourceType>::load_gpu(*this, m_device, file, props);
+      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::Font) {
+         return Loader<CResourceType>::load_font(m_fontManager, file);
+      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::StaticDependent) {
+         return Loader<CResourceType>::load(*this, file);
+      } else if constexpr (Loader<CResourceType>::type == ResourceLoadType::Static) {
+         return Loader<CResourceType>::load(file);
+      }
+   }
+
+   // Resource loaded again after its file changed, it replaces the loaded one at the start of a frame.
+   struct IReloadedResource
+   {
+      virtual ~IReloadedResource() = default;
+      // Returns the name of the resource if it was replaced.
+      virtual std::optional<ResourceName> replace(ResourceManager& manager) = 0;
+   };
+
+   template<ResourceType CResourceType>
+   struct ReloadedResource final : IReloadedResource
+   {
+      ReloadedResource(const TypedName<CResourceType> name, typename Container<CResourceType>::ValueType&& value) :
+          name(name),
+          value(std::move(value))
+      {
+      }
+
+      std::optional<ResourceName> replace(ResourceManager& manager) override
+      {
+         if (not manager.replace_resource<CResourceType>(name, std::move(value)))
+            return std::nullopt;
+         return name;
+      }
+
+      TypedName<CResourceType> name;
+      typename Container<CResourceType>::ValueType value;
+   };
+
+   template<ResourceType CResourceType>
+   void reload_resource(const TypedName<CResourceType> name, const AssetFile& file, const ResourceProperties& props)
+   {
+      auto resource = std::make_unique<ReloadedResource<CResourceType>>(name, this->load_value<CResourceType>(file, props));
+      std::unique_lock lk{m_reloadMutex};
+      m_reloadedResources.emplace_back(std::move(resource));
+   }
+
+   template<ResourceType CResourceType>
+   bool replace_resource(const TypedName<CResourceType> name, typename Container<CResourceType>::ValueType&& value)
+   {
+      auto& container = this->container<CResourceType>();
+      // Evicted while it was reloaded.
+      if (not container.is_name_registered(name))
+         return false;
+
+      if constexpr (CResourceType == ResourceType::Texture) {
+         // Reloaded textures are loaded with all their levels, they are no longer streamed.
+         if (m_textureStreamer != nullptr) {
+            this->remove_streamed_texture(name);
+         }
+      }
+
+      m_retireQueue.retire(container.replace(name, std::move(value)));
+
+      if constexpr (HasResourceSize<CResourceType>) {
+         m_budget.resize_resource(name, Loader<CResourceType>::resource_size(container.get(name)));
+      }
+      if constexpr (HasReferences<CResourceType>) {
+         m_budget.set_references(name, Loader<CResourceType>::collect_references(container.get(name)));
+      }
+      return true;
+   }
+
+   template<ResourceType CResourceType>
+   void track_resource(const TypedName<CResourceType> name)
+   {
+      auto& container = this->container<CResourceType>();
+      if (not container.is_name_registered(name))
+         return;
+
+      if constexpr (HasResourceSize<CResourceType>) {
+         m_budget.add_resource(name, Loader<CResourceType>::resource_size(container.get(name)));
+      } else {
+         m_budget.add_resource(name, sizeof(typename Container<CResourceType>::ValueType));
+      }
+
+      // The assets the resource draws with stay loaded while it is, even once the asset lists that loaded them are released.
+      if constexpr (HasReferences<CResourceType>) {
+         m_budget.set_references(name, Loader<CResourceType>::collect_references(container.get(name)));
+      }
+   }
+
+   template<ResourceType CResourceType>
+   void promote_references(const TypedName<CResourceType> name)
+   {
+      if constexpr (HasReferences<CResourceType>) {
+         auto& container = this->container<CResourceType>();
+         if (m_loadContext == nullptr || not container.is_name_registered(name))
+            return;
+
+         const auto priority = m_loadContext->priority(name);
+         if (priority == LoadPriority::Background)
+            return;
+
+         for (const auto reference : Loader<CResourceType>::collect_references(container.get(name))) {
+            // Textures are drawn with placeholders until they are loaded, rendering doesn't wait for them.
+            const auto referencePriority =
+               reference.type() == ResourceType::Texture ? std::max(priority, LoadPriority::Visible) : priority;
+            m_loadContext->promote(reference, referencePriority);
+         }
+      }
+   }
+
+   template<ResourceType CResourceType>
+   void unload_resource(const TypedName<CResourceType> name)
+   {
+      if (m_assetWatcher != nullptr) {
+         m_assetWatcher->remove_asset(name);
+      }
+
+      if constexpr (CResourceType == ResourceType::Texture) {
+         if (m_textureStreamer != nullptr) {
+            this->remove_streamed_texture(name);
+         }
+      }
+
+      m_retireQueue.retire(this->container<CResourceType>().erase(name));
+   }
+
+   void remove_streamed_texture(TextureName name);
 
    template<ResourceType CResourceType>
    Container<CResourceType>& container()
    {
-      return *static_cast<Container<CResourceType>*>(m_containers.at(CResourceType).get());
+      return *static_cast<Container<CResourceType>*>(m_containers[static_cast<int>(CResourceType)].get());
    }
 
    std::unique_ptr<LoadContext> m_loadContext{};
-   std::map<ResourceType, std::unique_ptr<IContainer>> m_containers;
+   AssetCacheStats m_cacheStatsAtLoadStart{};
+   u32 m_looseFileOpensAtLoadStart{};
+   std::atomic<u32> m_pathProbeCount{};
+   LoadTelemetry::Clock::time_point m_loadStartTime{};
+   std::vector<PackArchive> m_packArchives;
+   std::vector<std::string> m_packArchivePaths;
+   std::array<std::unique_ptr<IContainer>, static_cast<int>(ResourceType::Unknown)> m_containers;
    NameRegistry m_nameRegistry;
    graphics_api::Device& m_device;
    font::FontManger& m_fontManager;
+   std::once_flag m_mipMapGeneratorFlag;
+   std::unique_ptr<graphics_api::MipMapGenerator> m_mipMapGenerator;
+   std::atomic<MemorySize> m_textureMemory{};
+   std::atomic<MemorySize> m_textureMemorySaved{};
+   ResourceBudget m_budget;
+   // Frame the resources marked as used are stamped with, advanced by begin_frame.
+   u64 m_frameIndex{1};
+   std::vector<ResourceName> m_usedResources;
+   std::map<std::string, std::vector<ResourceName>> m_assetLists;
+   RetireQueue m_retireQueue;
+   // Loaded since the last frame, published by begin_frame.
+   std::vector<ResourceName> m_addedAssets;
+   std::mutex m_addedAssetsMutex;
+   std::unique_ptr<TextureStreamer> m_textureStreamer;
+   std::unique_ptr<AssetWatcher> m_assetWatcher;
+   // Asset list entries of the watched assets, reloading resolves their files again.
+   std::map<ResourceName, ResourcePath> m_reloadPaths;
+   ReloadWaves m_reloadWaves;
+   std::vector<ResourceName> m_reloadingAssets;
+   LoadTelemetry::Clock::time_point m_reloadStartTime{};
+   std::atomic<u32> m_pendingReloadCount{};
+   std::vector<std::unique_ptr<IReloadedResource>> m_reloadedResources;
+   std::mutex m_reloadMutex;
 };
 
 }// namespace triglav::resource
\ No newline at end of file
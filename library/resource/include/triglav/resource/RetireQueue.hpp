@@ -0,0 +1,73 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace triglav::resource {
+
+// Keeps resources that were taken out of use alive until the frames that may still use them on the GPU are finished.
+class RetireQueue
+{
+ public:
+   explicit RetireQueue(const u64 frameCount) :
+       m_frameCount(frameCount)
+   {
+   }
+
+   template<typename TResource>
+   void retire(TResource resource)
+   {
+      std::unique_lock lk{m_mutex};
+      m_entries.emplace_back(std::make_unique<Retired<TResource>>(std::move(resource)), m_frame);
+   }
+
+   // Advances to the next frame and destroys the resources retired long enough ago.
+   void advance_frame()
+   {
+      std::unique_lock lk{m_mutex};
+      ++m_frame;
+      while (not m_entries.empty() && m_entries.front().frame + m_frameCount <= m_frame) {
+         m_entries.pop_front();
+      }
+   }
+
+   [[nodiscard]] MemorySize size() const
+   {
+      std::unique_lock lk{m_mutex};
+      return m_entries.size();
+   }
+
+ private:
+   struct IRetired
+   {
+      virtual ~IRetired() = default;
+   };
+
+   template<typename TResource>
+   struct Retired final : IRetired
+   {
+      explicit Retired(TResource&& resource) :
+          resource(std::move(resource))
+      {
+      }
+
+      TResource resource;
+   };
+
+   struct Entry
+   {
+      std::unique_ptr<IRetired> resource;
+      u64 frame;
+   };
+
+   u64 m_frameCount;
+   u64 m_frame{};
+   std::deque<Entry> m_entries;
+   mutable std::mutex m_mutex;
+};
+
+}// namespace triglav::resource
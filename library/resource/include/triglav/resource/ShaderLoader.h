@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Loader.hpp"
 #include "Resource.hpp"
 
@@ -17,7 +18,7 @@ struct Loader<ResourceType::FragmentShader>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Graphics};
 
-   static graphics_api::Shader load_gpu(graphics_api::Device& device, const io::Path& path, const ResourceProperties& props);
+   static graphics_api::Shader load_gpu(graphics_api::Device& device, const AssetFile& file, const ResourceProperties& props);
 };
 
 template<>
@@ -25,7 +26,7 @@ struct Loader<ResourceType::VertexShader>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Graphics};
 
-   static graphics_api::Shader load_gpu(graphics_api::Device& device, const io::Path& path, const ResourceProperties& props);
+   static graphics_api::Shader load_gpu(graphics_api::Device& device, const AssetFile& file, const ResourceProperties& props);
 };
 
 template<>
@@ -33,7 +34,7 @@ struct Loader<ResourceType::ComputeShader>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Graphics};
 
-   static graphics_api::Shader load_gpu(graphics_api::Device& device, const io::Path& path, const ResourceProperties& props);
+   static graphics_api::Shader load_gpu(graphics_api::Device& device, const AssetFile& file, const ResourceProperties& props);
 };
 
 }// namespace triglav::resource
@@ -1,23 +1,52 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Loader.hpp"
 #include "Resource.hpp"
 
 #include "triglav/Name.hpp"
 #include "triglav/graphics_api/Device.h"
 #include "triglav/graphics_api/Texture.h"
+#include "triglav/io/File.h"
 #include "triglav/io/Path.h"
+#include "triglav/ktx/Texture.h"
 
+#include <optional>
 #include <string_view>
+#include <vector>
 
 namespace triglav::resource {
 
+class ResourceManager;
+
 template<>
 struct Loader<ResourceType::Texture>
 {
-   constexpr static ResourceLoadType type{ResourceLoadType::Graphics};
+   constexpr static ResourceLoadType type{ResourceLoadType::GraphicsDependent};
+
+   static graphics_api::Texture load_gpu(ResourceManager& manager, graphics_api::Device& device, const AssetFile& file,
+                                         const ResourceProperties& props);
+   // Source images generate their mips with the compute downsample shader, cooked textures have no dependencies.
+   static std::vector<ResourceName> collect_dependencies(const AssetFile& file, const ResourceProperties& props);
 
-   static graphics_api::Texture load_gpu(graphics_api::Device& device, const io::Path& path, const ResourceProperties& props);
+   // Uploads all levels of a cooked texture, they are decoded on the CPU if the device doesn't support the format.
+   static graphics_api::Texture create_cooked_texture(graphics_api::Device& device, ktx::Texture& cookedTexture);
+   // Reads the header and the level index of a cooked texture without reading its levels.
+   static std::optional<ktx::Header> read_cooked_header(io::IFile& file);
+   // Reads the levels from the first mip into memory, used when they need to be decoded before the upload.
+   static std::optional<ktx::Texture> read_cooked_levels(io::IFile& file, const ktx::Header& header, u32 firstMip);
+   // Reads the levels from the first mip straight into the staging memory of the upload. Returns nullopt if reading fails
+   // or the device doesn't support the format, create_cooked_texture handles the latter by decoding the levels.
+   static std::optional<graphics_api::Texture> upload_cooked_levels(graphics_api::Device& device, io::IFile& file,
+                                                                    const ktx::Header& header, u32 firstMip);
+   // Size of the levels from the first mip in the format of the texture.
+   static MemorySize cooked_levels_size(const ktx::Header& header, u32 firstMip);
+   // Applies the sampler related properties of the asset.
+   static void apply_properties(graphics_api::Texture& texture, const ResourceProperties& props);
+   // Size of the texture as RGBA8, the layout textures were always loaded with before.
+   static MemorySize rgba_texture_size(const graphics_api::Resolution& resolution, int mipCount);
+   // Memory of all levels of the texture in its format.
+   static MemorySize resource_size(const graphics_api::Texture& texture);
 };
 
 }// namespace triglav::resource
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "triglav/Int.hpp"
+#include "triglav/Name.hpp"
+
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace triglav::resource {
+
+struct TextureResidencySettings
+{
+   // Memory all streamed textures may take together.
+   MemorySize budget{256ull * 1024 * 1024};
+   // Levels not larger than this in both dimensions are always resident.
+   u32 tailDimension{128};
+   // Texels per screen pixel at which the next mip level becomes sufficient, above one favours sharper textures.
+   float texelToPixelRatio{1.0f};
+};
+
+// Mip levels a texture should have resident. The first mip is the most detailed level, lower levels are dropped.
+struct TextureResidencyRequest
+{
+   TextureName name;
+   u32 firstMip;
+};
+
+// Decides which mip levels of the streamed textures are resident. It only tracks sizes and demand,
+// the resource manager performs the requests and reports back when they finish.
+//
+// Every frame the renderer reports the screen area each texture is visible on. The area selects the
+// desired first mip, textures that were not reported this frame only need their mip tail. Loads are
+// issued from the largest area down, if one doesn't fit the budget the least recently used textures
+// drop the levels they don't need. Loads that still don't fit are reduced to the levels that do.
+class TextureResidency
+{
+ public:
+   explicit TextureResidency(const TextureResidencySettings& settings);
+
+   // Registers a texture with the sizes of all its levels, returns the first mip to load initially.
+   u32 add_texture(TextureName name, u32 width, u32 height, std::vector<MemorySize> levelSizes);
+   void remove_texture(TextureName name);
+
+   // Screen area in pixels the texture covers this frame, multiple reports keep the largest one.
+   void report_demand(TextureName name, float screenArea);
+
+   // Advances to the next frame and returns the requests to perform. A texture has at most one request in progress.
+   [[nodiscard]] std::vector<TextureResidencyRequest> update();
+   void on_request_finished(TextureName name, u32 firstMip);
+
+   [[nodiscard]] bool is_registered(TextureName name) const;
+   [[nodiscard]] u32 resident_mip(TextureName name) const;
+   [[nodiscard]] u32 desired_mip(TextureName name) const;
+   [[nodiscard]] u32 tail_mip(TextureName name) const;
+   // Memory of the resident levels, requests in progress count with the levels they result in.
+   [[nodiscard]] MemorySize committed_size() const;
+   [[nodiscard]] MemorySize resident_size() const;
+   [[nodiscard]] u32 pending_request_count() const;
+   [[nodiscard]] const TextureResidencySettings& settings() const;
+
+ private:
+   struct Entry
+   {
+      u32 width;
+      u32 height;
+      // Size of the levels from each mip to the last one.
+      std::vector<MemorySize> sizeFromMip;
+      u32 tailMip;
+      u32 residentMip;
+      u32 desiredMip;
+      std::optional<u32> pendingMip;
+      float screenArea{};
+      float lastScreenArea{};
+      u64 lastUsedFrame{};
+   };
+
+   [[nodiscard]] u32 mip_for_area(const Entry& entry, float screenArea) const;
+   [[nodiscard]] static MemorySize committed_size(const Entry& entry);
+   // Drops unneeded levels of the least recently used textures until the given amount is available or nothing is left to drop.
+   void evict(MemorySize requiredSize, std::vector<TextureResidencyRequest>& requests);
+
+   TextureResidencySettings m_settings;
+   std::map<TextureName, Entry> m_entries;
+   MemorySize m_committedSize{};
+   u64 m_frame{};
+};
+
+}// namespace triglav::resource
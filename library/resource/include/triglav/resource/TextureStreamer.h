@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AssetFile.h"
+#include "Container.hpp"
+#include "Resource.hpp"
+#include "TextureResidency.h"
+
+#include "triglav/Name.hpp"
+#include "triglav/ktx/Texture.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace triglav::graphics_api {
+class Device;
+class Texture;
+}// namespace triglav::graphics_api
+
+namespace triglav::resource {
+
+class ResourceManager;
+
+// Streams the mip levels of cooked textures according to the TextureResidency decisions.
+//
+// Initially only the mip tail is loaded. When a texture needs other levels, its levels from the
+// requested mip are read from the KTX2 file on the thread pool and uploaded into a new texture.
+// The new texture replaces the registered one at the start of a frame, the previous one is retired
+// until the frames that may still sample it are finished. Pack archives store cooked textures
+// uncompressed, so levels of packed textures are read from the mapped archive.
+class TextureStreamer
+{
+ public:
+   TextureStreamer(ResourceManager& resourceManager, graphics_api::Device& device, const TextureResidencySettings& settings);
+   ~TextureStreamer();
+
+   [[nodiscard]] static bool is_streamable(const AssetFile& file, const ResourceProperties& props);
+
+   // Loads the mip tail of a cooked texture and registers it for streaming.
+   [[nodiscard]] graphics_api::Texture load_texture(TextureName name, const AssetFile& file, const ResourceProperties& props);
+
+   // Stops streaming an unloaded texture.
+   void remove_texture(TextureName name);
+
+   void report_demand(TextureName name, float screenArea);
+
+   // Called once per frame once the frame resources are available, before any commands are recorded.
+   void update(Container<ResourceType::Texture>& container);
+
+   [[nodiscard]] MemorySize resident_size() const;
+   [[nodiscard]] MemorySize budget() const;
+
+ private:
+   struct StreamedTexture
+   {
+      AssetFile file;
+      ResourceProperties props;
+      ktx::Header header;
+   };
+
+   struct FinishedRequest
+   {
+      TextureName name;
+      u32 firstMip;
+      std::optional<graphics_api::Texture> texture;
+   };
+
+   void load_levels(TextureName name, const StreamedTexture& streamedTexture, u32 firstMip);
+
+   ResourceManager& m_resourceManager;
+   graphics_api::Device& m_device;
+   TextureResidency m_residency;
+   std::map<TextureName, StreamedTexture> m_textures;
+   mutable std::mutex m_mutex;
+   std::vector<FinishedRequest> m_finishedRequests;
+   std::mutex m_finishedRequestsMutex;
+   std::atomic<u32> m_pendingJobCount{};
+};
+
+}// namespace triglav::resource
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetFile.h"
 #include "Loader.hpp"
 
 #include "triglav/Name.hpp"
@@ -16,7 +17,7 @@ struct Loader<ResourceType::Typeface>
 {
    constexpr static ResourceLoadType type{ResourceLoadType::Font};
 
-   static font::Typeface load_font(const font::FontManger& manager, const io::Path& path);
+   static font::Typeface load_font(const font::FontManger& manager, const AssetFile& file);
 };
 
 }// namespace triglav::resource
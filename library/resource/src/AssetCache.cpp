@@ -0,0 +1,347 @@
+#include "AssetCache.h"
+
+#include "LoadTelemetry.h"
+#include "PathManager.h"
+
+#include "triglav/io/CommandLine.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <random>
+
+namespace triglav::resource {
+
+using namespace name_literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr u32 g_entryMagic = 0x43414754;// TGAC
+// Bumped whenever the entry layout changes, entries of other versions are treated as missing.
+constexpr u32 g_entryFormatVersion = 1;
+constexpr std::string_view g_entryExtension{".bin"};
+constexpr std::string_view g_tempExtension{".tmp"};
+constexpr int g_defaultMaxSizeMiB = 1024;
+// Temporary files this old were left behind by a writer that didn't finish.
+constexpr auto g_abandonedTempFileAge = std::chrono::minutes(10);
+
+// Shared by all caches of the process, caches opened on the same directory never pick the same temporary file.
+std::atomic<u32> g_tempFileCounter{};
+
+struct EntryHeader
+{
+   u32 magic;
+   u32 formatVersion;
+   u64 payloadSize;
+   CacheKey payloadHash;
+};
+
+constexpr u64 g_prime1 = 0x9E3779B185EBCA87ull;
+constexpr u64 g_prime2 = 0xC2B2AE3D27D4EB4Full;
+
+u64 mix(const u64 value)
+{
+   // Finalizer of MurmurHash3, every input bit affects every output bit.
+   auto result = value;
+   result ^= result >> 33;
+   result *= 0xFF51AFD7ED558CCDull;
+   result ^= result >> 33;
+   result *= 0xC4CEB9FE1A85EC53ull;
+   result ^= result >> 33;
+   return result;
+}
+
+// Non-cryptographic 128-bit hash processing two 64-bit lanes at a time, hashing is a small fraction
+// of the import it replaces even for large sources.
+class Hasher
+{
+ public:
+   void update(const std::span<const u8> data)
+   {
+      const auto blockCount = data.size() / 16;
+      for (MemorySize block = 0; block < blockCount; ++block) {
+         u64 first;
+         u64 second;
+         std::memcpy(&first, data.data() + 16 * block, sizeof(u64));
+         std::memcpy(&second, data.data() + 16 * block + 8, sizeof(u64));
+         this->round(first, second);
+      }
+
+      std::array<u8, 16> tail{};
+      const auto tailSize = data.size() % 16;
+      std::copy_n(data.data() + 16 * blockCount, tailSize, tail.begin());
+      u64 first;
+      u64 second;
+      std::memcpy(&first, tail.data(), sizeof(u64));
+      std::memcpy(&second, tail.data() + 8, sizeof(u64));
+      // Separates the parts, so moving bytes between them changes the hash.
+      this->round(first ^ tailSize, second ^ data.size());
+   }
+
+   void update(const std::string_view value)
+   {
+      this->update({reinterpret_cast<const u8*>(value.data()), value.size()});
+   }
+
+   void update(const u64 value)
+   {
+      this->round(value, ~value);
+   }
+
+   [[nodiscard]] CacheKey finish() const
+   {
+      return {mix(m_high ^ std::rotl(m_low, 17)), mix(m_low + m_high * g_prime2)};
+   }
+
+ private:
+   void round(const u64 first, const u64 second)
+   {
+      m_high = std::rotl(m_high ^ (first * g_prime1), 31) * g_prime2;
+      m_low = std::rotl(m_low ^ (second * g_prime2), 27) * g_prime1;
+      m_high += m_low;
+   }
+
+   u64 m_high{0x243F6A8885A308D3ull};
+   u64 m_low{0x13198A2E03707344ull};
+};
+
+MemorySize max_size_from_command_line()
+{
+   const auto maxSizeMiB = std::max(io::CommandLine::the().arg_int("cacheSize"_name).value_or(g_defaultMaxSizeMiB), 0);
+   return static_cast<MemorySize>(maxSizeMiB) * 1024 * 1024;
+}
+
+CacheKey hash_payload(const std::span<const u8> data)
+{
+   Hasher hasher;
+   hasher.update(data);
+   return hasher.finish();
+}
+
+}// namespace
+
+std::string CacheKey::to_string() const
+{
+   return std::format("{:016x}{:016x}", this->high, this->low);
+}
+
+AssetCache::AssetCache(const io::Path directory, const MemorySize maxSize) :
+    m_directory(directory.string()),
+    m_maxSize(maxSize)
+{
+   if (m_maxSize == 0)
+      return;
+
+   std::error_code error;
+   fs::create_directories(m_directory, error);
+   m_isEnabled = not error && fs::is_directory(m_directory, error);
+   if (not m_isEnabled) {
+      spdlog::warn("asset cache: cannot use directory {}, cooked assets won't be cached", m_directory.string());
+   }
+}
+
+CacheKey AssetCache::make_key(const std::span<const u8> source, const std::string_view importer, const u32 importerVersion,
+                              const std::string_view options)
+{
+   Hasher hasher;
+   hasher.update(importer);
+   hasher.update(importerVersion);
+   hasher.update(options);
+   hasher.update(source);
+   return hasher.finish();
+}
+
+std::optional<std::vector<u8>> AssetCache::read(const CacheKey& key)
+{
+   if (not m_isEnabled)
+      return std::nullopt;
+
+   const LoadPhaseScope phaseScope{LoadPhase::FileRead};
+
+   const auto path = this->entry_path(key);
+   std::ifstream file(path, std::ios::binary);
+   if (not file.is_open()) {
+      ++m_missCount;
+      return std::nullopt;
+   }
+
+   file.seekg(0, std::ios::end);
+   const auto fileSize = static_cast<u64>(file.tellg());
+   file.seekg(0, std::ios::beg);
+
+   EntryHeader header{};
+   file.read(reinterpret_cast<char*>(&header), sizeof(EntryHeader));
+   if (not file || header.magic != g_entryMagic || header.formatVersion != g_entryFormatVersion) {
+      ++m_missCount;
+      return std::nullopt;
+   }
+
+   // A corrupted entry is removed, so it's written again by the next import.
+   const auto discard_entry = [&] {
+      spdlog::warn("asset cache: discarding corrupted entry {}", key.to_string());
+      file.close();
+      std::error_code error;
+      fs::remove(path, error);
+      ++m_missCount;
+   };
+
+   // Checked before allocating, the payload size of a truncated or corrupted entry can be anything.
+   if (header.payloadSize != fileSize - sizeof(EntryHeader)) {
+      discard_entry();
+      return std::nullopt;
+   }
+
+   std::vector<u8> result(header.payloadSize);
+   file.read(reinterpret_cast<char*>(result.data()), static_cast<std::streamsize>(result.size()));
+   if (not file || hash_payload(result) != header.payloadHash) {
+      discard_entry();
+      return std::nullopt;
+   }
+
+   // The modification time orders the entries for garbage collection.
+   std::error_code error;
+   fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+
+   ++m_hitCount;
+   return result;
+}
+
+bool AssetCache::write(const CacheKey& key, const std::span<const u8> data)
+{
+   if (not m_isEnabled)
+      return false;
+
+   // The name is unique across caches and processes, concurrent writers of the same entry never share a temporary file.
+   static const auto processTag = std::random_device{}();
+   const auto tempPath =
+      m_directory / std::format("{}.{:08x}.{}{}", key.to_string(), processTag, g_tempFileCounter.fetch_add(1), g_tempExtension);
+
+   {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      const EntryHeader header{
+         .magic = g_entryMagic,
+         .formatVersion = g_entryFormatVersion,
+         .payloadSize = data.size(),
+         .payloadHash = hash_payload(data),
+      };
+      file.write(reinterpret_cast<const char*>(&header), sizeof(EntryHeader));
+      file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+      file.close();
+      if (not file) {
+         std::error_code error;
+         fs::remove(tempPath, error);
+         return false;
+      }
+   }
+
+   // Renaming replaces an existing entry atomically, entries with the same key have the same content.
+   std::error_code error;
+   fs::rename(tempPath, this->entry_path(key), error);
+   if (error) {
+      fs::remove(tempPath, error);
+      return false;
+   }
+   return true;
+}
+
+void AssetCache::collect_garbage()
+{
+   if (not m_isEnabled)
+      return;
+
+   std::unique_lock lk{m_garbageCollectionMutex};
+
+   struct Entry
+   {
+      fs::path path;
+      MemorySize size;
+      fs::file_time_type lastUsed;
+   };
+
+   const auto now = fs::file_time_type::clock::now();
+
+   std::vector<Entry> entries;
+   MemorySize totalSize{};
+   std::error_code error;
+   for (const auto& dirEntry : fs::directory_iterator(m_directory, error)) {
+      std::error_code entryError;
+      if (not dirEntry.is_regular_file(entryError))
+         continue;
+
+      const auto lastUsed = dirEntry.last_write_time(entryError);
+      if (entryError)
+         continue;
+
+      const auto extension = dirEntry.path().extension().string();
+      if (extension == g_tempExtension) {
+         if (now - lastUsed > g_abandonedTempFileAge) {
+            fs::remove(dirEntry.path(), entryError);
+         }
+         continue;
+      }
+      if (extension != g_entryExtension)
+         continue;
+
+      const auto size = dirEntry.file_size(entryError);
+      if (entryError)
+         continue;
+
+      entries.emplace_back(dirEntry.path(), size, lastUsed);
+      totalSize += size;
+   }
+
+   if (totalSize <= m_maxSize)
+      return;
+
+   std::ranges::sort(entries, [](const Entry& lhs, const Entry& rhs) { return lhs.lastUsed < rhs.lastUsed; });
+
+   u32 removedCount{};
+   const auto initialSize = totalSize;
+   for (const auto& entry : entries) {
+      if (totalSize <= m_maxSize)
+         break;
+
+      std::error_code removeError;
+      if (fs::remove(entry.path, removeError)) {
+         totalSize -= entry.size;
+         ++removedCount;
+      }
+   }
+
+   spdlog::info("asset cache: removed {} entries, {:.1f} MiB -> {:.1f} MiB", removedCount,
+                static_cast<double>(initialSize) / (1024.0 * 1024.0), static_cast<double>(totalSize) / (1024.0 * 1024.0));
+}
+
+bool AssetCache::is_enabled() const
+{
+   return m_isEnabled;
+}
+
+MemorySize AssetCache::max_size() const
+{
+   return m_maxSize;
+}
+
+AssetCacheStats AssetCache::stats() const
+{
+   return {m_hitCount.load(), m_missCount.load()};
+}
+
+AssetCache& AssetCache::the()
+{
+   static AssetCache instance(PathManager::the().cache_path(), max_size_from_command_line());
+   return instance;
+}
+
+fs::path AssetCache::entry_path(const CacheKey& key) const
+{
+   return m_directory / (key.to_string() + std::string{g_entryExtension});
+}
+
+}// namespace triglav::resource
@@ -0,0 +1,118 @@
+#include "AssetFile.h"
+#include "LoadTelemetry.h"
+
+#include "triglav/io/MemoryFile.h"
+
+#include <atomic>
+#include <cassert>
+
+namespace triglav::resource {
+
+namespace {
+
+std::atomic<u32> g_looseFileOpenCount{};
+
+}// namespace
+
+AssetData::AssetData(const std::span<const u8> data) :
+    m_data(data)
+{
+}
+
+AssetData::AssetData(std::vector<u8>&& buffer) :
+    m_buffer(std::move(buffer)),
+    m_data(m_buffer)
+{
+}
+
+std::span<const u8> AssetData::bytes() const
+{
+   return m_data;
+}
+
+std::string_view AssetData::text() const
+{
+   return {reinterpret_cast<const char*>(m_data.data()), m_data.size()};
+}
+
+bool AssetData::empty() const
+{
+   return m_data.empty();
+}
+
+AssetFile::AssetFile(io::Path path) :
+    m_path(std::move(path)),
+    m_name(m_path->string())
+{
+}
+
+AssetFile::AssetFile(const PackEntry& entry) :
+    m_entry(entry),
+    m_name(entry.source)
+{
+}
+
+std::string_view AssetFile::name() const
+{
+   return m_name;
+}
+
+const std::optional<io::Path>& AssetFile::path() const
+{
+   return m_path;
+}
+
+bool AssetFile::is_packed() const
+{
+   return m_entry.has_value();
+}
+
+AssetData AssetFile::read() const
+{
+   // Unpacking a compressed archive entry takes the place of reading the file.
+   const LoadPhaseScope phaseScope{LoadPhase::FileRead};
+
+   if (m_entry.has_value()) {
+      if (m_entry->compression == PackCompression::None)
+         return AssetData{m_entry->data};
+      return AssetData{PackArchive::unpack(*m_entry).value_or(std::vector<u8>{})};
+   }
+
+   auto file = this->open();
+   if (not file.has_value())
+      return AssetData{std::vector<u8>{}};
+
+   const auto fileSize = (*file)->file_size();
+   if (not fileSize.has_value())
+      return AssetData{std::vector<u8>{}};
+
+   std::vector<u8> buffer(*fileSize);
+   if (const auto readSize = (*file)->read(buffer); not readSize.has_value() || *readSize != buffer.size())
+      return AssetData{std::vector<u8>{}};
+
+   return AssetData{std::move(buffer)};
+}
+
+io::Result<io::IFileUPtr> AssetFile::open() const
+{
+   if (m_entry.has_value()) {
+      if (m_entry->compression == PackCompression::None)
+         return std::make_unique<io::MemoryFile>(m_entry->data);
+
+      auto contents = PackArchive::unpack(*m_entry);
+      if (not contents.has_value())
+         return std::unexpected(io::Status::InvalidFile);
+      return std::make_unique<io::MemoryFile>(std::move(*contents));
+   }
+
+   assert(m_path.has_value());
+   ++g_looseFileOpenCount;
+   return io::open_file(*m_path, io::FileOpenMode::Read);
+}
+
+u32 AssetFile::loose_file_open_count()
+{
+   return g_looseFileOpenCount.load();
+}
+
+}// namespace triglav::resource
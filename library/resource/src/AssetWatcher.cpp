@@ -0,0 +1,149 @@
+#include "AssetWatcher.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace triglav::resource {
+
+AssetWatcher::AssetWatcher(io::IFileWatcherUPtr fileWatcher) :
+    m_fileWatcher(std::move(fileWatcher))
+{
+}
+
+void AssetWatcher::add_asset(const ResourceName name, const std::optional<io::Path>& path, const std::span<const ResourceName> dependencies)
+{
+   std::unique_lock lk{m_mutex};
+
+   // An asset loaded again after it was evicted keeps its dependents.
+   this->remove_asset_internal(name);
+
+   auto& asset = m_assets[name];
+   asset.dependencies.assign(dependencies.begin(), dependencies.end());
+   for (const auto dependency : dependencies) {
+      if (dependency != name) {
+         m_assets[dependency].dependents.emplace_back(name);
+      }
+   }
+
+   if (not path.has_value())
+      return;
+
+   asset.path = path->string();
+   m_assetsByPath[path->string()].emplace_back(name);
+
+   auto directory = path->parent();
+   if (m_watchedDirectories.contains(directory.string()))
+      return;
+
+   if (m_fileWatcher->watch_directory(directory) != io::Status::Success) {
+      spdlog::warn("Cannot watch directory {} for changed assets", directory.string());
+   }
+   m_watchedDirectories.emplace(directory.string());
+}
+
+void AssetWatcher::remove_asset(const ResourceName name)
+{
+   std::unique_lock lk{m_mutex};
+   this->remove_asset_internal(name);
+}
+
+ReloadWaves AssetWatcher::poll_changes()
+{
+   const auto changedFiles = m_fileWatcher->changed_files();
+   if (changedFiles.empty())
+      return {};
+   return this->invalidate(changedFiles);
+}
+
+ReloadWaves AssetWatcher::invalidate(const std::span<const io::Path> changedFiles) const
+{
+   std::unique_lock lk{m_mutex};
+
+   // Collects the assets of the changed files and everything that depends on them.
+   std::set<ResourceName> invalidated;
+   std::vector<ResourceName> pending;
+   for (const auto& file : changedFiles) {
+      if (const auto it = m_assetsByPath.find(file.string()); it != m_assetsByPath.end()) {
+         pending.insert(pending.end(), it->second.begin(), it->second.end());
+      }
+   }
+   while (not pending.empty()) {
+      const auto name = pending.back();
+      pending.pop_back();
+      if (invalidated.emplace(name).second) {
+         const auto& dependents = m_assets.at(name).dependents;
+         pending.insert(pending.end(), dependents.begin(), dependents.end());
+      }
+   }
+
+   // Each wave holds the assets whose invalidated dependencies were all reloaded in the previous waves.
+   std::map<ResourceName, u32> pendingDependencyCounts;
+   for (const auto name : invalidated) {
+      auto& count = pendingDependencyCounts[name];
+      for (const auto dependency : m_assets.at(name).dependencies) {
+         if (dependency != name && invalidated.contains(dependency)) {
+            ++count;
+         }
+      }
+   }
+
+   ReloadWaves result;
+   std::vector<ResourceName> wave;
+   for (const auto& [name, count] : pendingDependencyCounts) {
+      if (count == 0) {
+         wave.emplace_back(name);
+      }
+   }
+   while (not wave.empty()) {
+      std::vector<ResourceName> nextWave;
+      for (const auto name : wave) {
+         pendingDependencyCounts.erase(name);
+         for (const auto dependent : m_assets.at(name).dependents) {
+            if (const auto it = pendingDependencyCounts.find(dependent); it != pendingDependencyCounts.end() && --it->second == 0) {
+               nextWave.emplace_back(dependent);
+            }
+         }
+      }
+      result.emplace_back(std::move(wave));
+      std::ranges::sort(nextWave);
+      wave = std::move(nextWave);
+   }
+
+   // Assets on a dependency cycle never run out of pending dependencies, they are reloaded last.
+   if (not pendingDependencyCounts.empty()) {
+      auto& lastWave = result.emplace_back();
+      for (const auto& [name, count] : pendingDependencyCounts) {
+         lastWave.emplace_back(name);
+      }
+   }
+
+   return result;
+}
+
+void AssetWatcher::remove_asset_internal(const ResourceName name)
+{
+   const auto it = m_assets.find(name);
+   if (it == m_assets.end())
+      return;
+
+   auto& asset = it->second;
+   if (asset.path.has_value()) {
+      auto& pathAssets = m_assetsByPath[*asset.path];
+      std::erase(pathAssets, name);
+      if (pathAssets.empty()) {
+         m_assetsByPath.erase(*asset.path);
+      }
+      asset.path.reset();
+   }
+
+   for (const auto dependency : asset.dependencies) {
+      if (const auto dependencyIt = m_assets.find(dependency); dependencyIt != m_assets.end()) {
+         std::erase(dependencyIt->second.dependents, name);
+      }
+   }
+   asset.dependencies.clear();
+}
+
+}// namespace triglav::resource
@@ -0,0 +1,97 @@
+#include "ImageDecoder.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <thread>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace triglav::resource {
+
+namespace {
+
+// JPEG strips are decoded on the thread pool, beyond a few the skipped rows dominate the work.
+constexpr u32 g_maxJpegStripCount = 8;
+
+std::vector<IImageDecoderUPtr> default_backends()
+{
+   std::vector<IImageDecoderUPtr> result;
+   result.emplace_back(std::make_unique<PngImageDecoder>());
+   result.emplace_back(std::make_unique<JpegImageDecoder>(std::clamp(std::thread::hardware_concurrency(), 1u, g_maxJpegStripCount)));
+   return result;
+}
+
+}// namespace
+
+std::string_view StbImageDecoder::name() const
+{
+   return "stb_image";
+}
+
+bool StbImageDecoder::can_decode(const std::span<const u8> data) const
+{
+   int width, height, channelCount;
+   return stbi_info_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channelCount) != 0;
+}
+
+std::optional<DecodedImage> StbImageDecoder::decode(const std::span<const u8> data) const
+{
+   int width, height, channelCount;
+   stbi_uc* pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channelCount, STBI_rgb_alpha);
+   if (pixels == nullptr)
+      return std::nullopt;
+
+   DecodedImage result{
+      .width = static_cast<u32>(width),
+      .height = static_cast<u32>(height),
+   };
+   result.pixels.assign(pixels, pixels + 4 * static_cast<MemorySize>(width) * height);
+   stbi_image_free(pixels);
+
+   return result;
+}
+
+ImageDecoder::ImageDecoder() :
+    ImageDecoder(default_backends())
+{
+}
+
+ImageDecoder::ImageDecoder(std::vector<IImageDecoderUPtr> backends) :
+    m_backends(std::move(backends))
+{
+}
+
+std::optional<DecodedImage> ImageDecoder::decode(const std::span<const u8> data) const
+{
+   for (const auto& backend : m_backends) {
+      if (not backend->can_decode(data))
+         continue;
+
+      if (auto result = backend->decode(data); result.has_value())
+         return result;
+
+      spdlog::warn("{} failed to decode the image, falling back to {}", backend->name(), m_fallback.name());
+      break;
+   }
+
+   return m_fallback.decode(data);
+}
+
+std::string_view ImageDecoder::backend_name(const std::span<const u8> data) const
+{
+   for (const auto& backend : m_backends) {
+      if (backend->can_decode(data))
+         return backend->name();
+   }
+   return m_fallback.name();
+}
+
+ImageDecoder& ImageDecoder::the()
+{
+   static ImageDecoder instance;
+   return instance;
+}
+
+}// namespace triglav::resource
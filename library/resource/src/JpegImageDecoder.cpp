@@ -0,0 +1,189 @@
+#include "ImageDecoder.h"
+
+// jpeglib.h expects the standard library types to be declared.
+#include <cstdio>
+
+#include <jpeglib.h>
+
+#include "triglav/threading/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csetjmp>
+#include <memory>
+
+namespace triglav::resource {
+
+namespace {
+
+// Strips are aligned to the largest MCU height, so each one starts at an MCU row.
+constexpr u32 g_stripAlignment = 16;
+// Smaller strips don't make up for the entropy decoding each thread does before its strip.
+constexpr u32 g_minStripHeight = 256;
+constexpr u32 g_scanlineBatchSize = 16;
+
+// Strips are claimed by the decoding thread and by thread pool jobs, whichever gets to them first. The decoding thread
+// only waits for strips that are already being decoded, so decoding from a thread pool job can't deadlock the pool.
+struct StripProgress
+{
+   std::atomic<u32> nextStrip{0};
+   std::atomic<u32> finishedStripCount{0};
+};
+
+struct JpegErrorManager
+{
+   jpeg_error_mgr manager;
+   std::jmp_buf jump;
+};
+
+[[noreturn]] void on_jpeg_error(const j_common_ptr info)
+{
+   std::longjmp(reinterpret_cast<JpegErrorManager*>(info->err)->jump, 1);
+}
+
+void on_jpeg_message(j_common_ptr /*info*/) {}
+
+struct JpegInfo
+{
+   u32 width;
+   u32 height;
+   bool isProgressive;
+};
+
+void init_decompress(jpeg_decompress_struct& info, JpegErrorManager& error, const std::span<const u8> data)
+{
+   info.err = jpeg_std_error(&error.manager);
+   error.manager.error_exit = on_jpeg_error;
+   error.manager.output_message = on_jpeg_message;
+   jpeg_create_decompress(&info);
+   jpeg_mem_src(&info, const_cast<u8*>(data.data()), static_cast<unsigned long>(data.size()));
+}
+
+// libjpeg reports errors with longjmp, only trivially destructible objects live in these frames.
+bool read_jpeg_info(const std::span<const u8> data, JpegInfo& outInfo)
+{
+   jpeg_decompress_struct info{};
+   JpegErrorManager error{};
+   if (setjmp(error.jump)) {
+      jpeg_destroy_decompress(&info);
+      return false;
+   }
+
+   init_decompress(info, error, data);
+   jpeg_read_header(&info, TRUE);
+   outInfo = JpegInfo{info.image_width, info.image_height, jpeg_has_multiple_scans(&info) != 0};
+   jpeg_destroy_decompress(&info);
+
+   return true;
+}
+
+// Decodes the rows from firstRow to lastRow into the output, which starts at the first row.
+bool decode_jpeg_rows(const std::span<const u8> data, const u32 firstRow, const u32 lastRow, u8* const output)
+{
+   jpeg_decompress_struct info{};
+   JpegErrorManager error{};
+   if (setjmp(error.jump)) {
+      jpeg_destroy_decompress(&info);
+      return false;
+   }
+
+   init_decompress(info, error, data);
+   jpeg_read_header(&info, TRUE);
+   info.out_color_space = JCS_EXT_RGBA;
+   jpeg_start_decompress(&info);
+
+   // The rows above are only entropy decoded, their IDCT, upsampling and color conversion is skipped.
+   while (info.output_scanline < firstRow) {
+      jpeg_skip_scanlines(&info, firstRow - info.output_scanline);
+   }
+
+   const auto rowSize = 4 * static_cast<MemorySize>(info.output_width);
+   JSAMPROW rows[g_scanlineBatchSize];
+   while (info.output_scanline < lastRow) {
+      const auto batchSize = std::min(lastRow - info.output_scanline, g_scanlineBatchSize);
+      for (u32 row = 0; row < batchSize; ++row) {
+         rows[row] = output + (info.output_scanline - firstRow + row) * rowSize;
+      }
+      jpeg_read_scanlines(&info, rows, batchSize);
+   }
+
+   if (info.output_scanline == info.output_height) {
+      jpeg_finish_decompress(&info);
+   } else {
+      jpeg_abort_decompress(&info);
+   }
+   jpeg_destroy_decompress(&info);
+
+   return true;
+}
+
+}// namespace
+
+JpegImageDecoder::JpegImageDecoder(const u32 maxStripCount) :
+    m_maxStripCount(std::max(maxStripCount, 1u))
+{
+}
+
+std::string_view JpegImageDecoder::name() const
+{
+   return "libjpeg-turbo";
+}
+
+bool JpegImageDecoder::can_decode(const std::span<const u8> data) const
+{
+   return data.size() >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+std::optional<DecodedImage> JpegImageDecoder::decode(const std::span<const u8> data) const
+{
+   JpegInfo info{};
+   if (not read_jpeg_info(data, info))
+      return std::nullopt;
+
+   DecodedImage result{
+      .width = info.width,
+      .height = info.height,
+   };
+   result.pixels.resize(4 * static_cast<MemorySize>(info.width) * info.height);
+
+   // Progressive images are entropy decoded as a whole before any row is output, so they're decoded in one strip.
+   const auto stripCount = info.isProgressive ? 1u : std::clamp(info.height / g_minStripHeight, 1u, m_maxStripCount);
+   const auto stripHeight = (info.height / stripCount + g_stripAlignment - 1) / g_stripAlignment * g_stripAlignment;
+
+   std::vector<u8> stripResults(stripCount);
+   const auto decode_strip = [&](const u32 strip) {
+      const auto firstRow = std::min(strip * stripHeight, info.height);
+      const auto lastRow = strip + 1 == stripCount ? info.height : std::min(firstRow + stripHeight, info.height);
+      auto* output = result.pixels.data() + 4 * static_cast<MemorySize>(info.width) * firstRow;
+      stripResults[strip] = firstRow == lastRow || decode_jpeg_rows(data, firstRow, lastRow, output);
+   };
+
+   // Jobs started after all strips are claimed return without touching the image.
+   auto progress = std::make_shared<StripProgress>();
+   const auto claim_strips = [progress, stripCount, decode_strip] {
+      for (auto strip = progress->nextStrip++; strip < stripCount; strip = progress->nextStrip++) {
+         decode_strip(strip);
+         if (++progress->finishedStripCount == stripCount) {
+            progress->finishedStripCount.notify_all();
+         }
+      }
+   };
+
+   auto& threadPool = threading::ThreadPool::the();
+   const auto jobCount = std::min(stripCount, threadPool.thread_count() + 1) - 1;
+   for (u32 job = 0; job < jobCount; ++job) {
+      threadPool.issue_job(claim_strips);
+   }
+   claim_strips();
+
+   for (auto count = progress->finishedStripCount.load(); count != stripCount; count = progress->finishedStripCount.load()) {
+      progress->finishedStripCount.wait(count);
+   }
+
+   if (std::ranges::find(stripResults, 0) != stripResults.end())
+      return std::nullopt;
+
+   return result;
+}
+
+}// namespace triglav::resource
@@ -1,6 +1,7 @@
 #include "LevelLoader.h"
 
-#include "triglav/io/File.h"
+#include "AssetCache.h"
+#include "LoadTelemetry.h"
 
 #include <ryml.hpp>
 #include <string>
@@ -9,6 +10,9 @@ namespace triglav::resource {
 
 namespace {
 
+// Bumped whenever the compiled format changes.
+constexpr u32 g_levelImporterVersion = 1;
+
 glm::vec3 parse_vector3(const ryml::ConstNodeRef node)
 {
    auto x = node["x"].val();
@@ -57,36 +61,112 @@ world::StaticMesh parse_static_mesh(const ryml::ConstNodeRef node)
    };
 }
 
-}// namespace
+world::ParticleEmitterInstance parse_particle_emitter(const ryml::ConstNodeRef node)
+{
+   auto emitterName = node["emitter"].val();
+   return world::ParticleEmitterInstance{
+      .emitterName = make_rc_name(std::string_view{emitterName.data(), emitterName.size()}),
+      .position = parse_vector3(node["position"]),
+   };
+}
 
-world::Level Loader<ResourceType::Level>::load(const io::Path& path)
+world::Level parse_level(const AssetFile& file, const AssetData& data, CacheWriter& writer)
 {
-   auto file = io::read_whole_file(path);
-   assert(not file.empty());
+   const LoadPhaseScope phaseScope{LoadPhase::Decode};
 
    auto tree =
-      ryml::parse_in_place(c4::substr{const_cast<char*>(path.string().data()), path.string().size()}, c4::substr{file.data(), file.size()});
+      ryml::parse_in_arena(c4::csubstr{file.name().data(), file.name().size()}, c4::csubstr{data.text().data(), data.text().size()});
 
    world::Level result{};
 
    auto nodes = tree["nodes"];
+   writer.write<u64>(nodes.num_children());
    for (const auto node : nodes) {
       auto name = node["name"].val();
 
-      world::LevelNode levelNode;
+      std::vector<world::StaticMesh> staticMeshes;
+      std::vector<world::ParticleEmitterInstance> particleEmitters;
 
       auto items = node["items"];
       for (const auto item : items) {
          auto type = item["type"].val();
          if (type == "static_mesh") {
-            levelNode.add_static_mesh(parse_static_mesh(item));
+            staticMeshes.emplace_back(parse_static_mesh(item));
+         } else if (type == "particle_emitter") {
+            particleEmitters.emplace_back(parse_particle_emitter(item));
          }
       }
 
-      result.add_node(make_name_id(std::string_view{name.data(), name.size()}), std::move(levelNode));
+      const auto nodeName = make_name_id(std::string_view{name.data(), name.size()});
+      writer.write(nodeName);
+      writer.write_array(std::span<const world::StaticMesh>{staticMeshes});
+      writer.write_array(std::span<const world::ParticleEmitterInstance>{particleEmitters});
+
+      world::LevelNode levelNode;
+      for (auto& mesh : staticMeshes) {
+         levelNode.add_static_mesh(std::move(mesh));
+      }
+      for (auto& emitter : particleEmitters) {
+         levelNode.add_particle_emitter(std::move(emitter));
+      }
+      result.add_node(nodeName, std::move(levelNode));
    }
 
    return result;
 }
 
+std::optional<world::Level> deserialize_level(const std::span<const u8> data)
+{
+   const LoadPhaseScope phaseScope{LoadPhase::Decode};
+
+   CacheReader reader{data};
+   world::Level result{};
+
+   const auto nodeCount = reader.read<u64>();
+   for (u64 nodeIndex = 0; nodeIndex < nodeCount && nodeIndex < data.size(); ++nodeIndex) {
+      const auto nodeName = reader.read<Name>();
+
+      world::LevelNode levelNode;
+      for (auto& mesh : reader.read_array<world::StaticMesh>()) {
+         levelNode.add_static_mesh(std::move(mesh));
+      }
+      for (auto& emitter : reader.read_array<world::ParticleEmitterInstance>()) {
+         levelNode.add_particle_emitter(std::move(emitter));
+      }
+      result.add_node(nodeName, std::move(levelNode));
+   }
+
+   if (not reader.is_complete())
+      return std::nullopt;
+   return result;
+}
+
+}// namespace
+
+world::Level Loader<ResourceType::Level>::load(const AssetFile& file)
+{
+   const auto data = file.read();
+   assert(not data.empty());
+
+   // The YAML level is the authoring format, warm starts read the compiled level without parsing it.
+   const auto key = AssetCache::make_key(data.bytes(), "level", g_levelImporterVersion, "");
+
+   auto& cache = AssetCache::the();
+   if (const auto entry = cache.read(key); entry.has_value()) {
+      if (auto level = deserialize_level(*entry); level.has_value()) {
+         return std::move(*level);
+      }
+   }
+
+   CacheWriter writer;
+   auto result = parse_level(file, data, writer);
+   cache.write(key, writer.data());
+   return result;
+}
+
+std::vector<ResourceName> Loader<ResourceType::Level>::collect_references(const world::Level& level)
+{
+   return level.referenced_assets();
+}
+
 }// namespace triglav::resource
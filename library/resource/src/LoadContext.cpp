@@ -1,97 +1,372 @@
 #include "LoadContext.h"
 
+#include "AssetCache.h"
+
 #include "triglav/io/File.h"
 
 #include <ryml.hpp>
 
+#include <cassert>
+#include <format>
 #include <mutex>
+#include <ranges>
 
 namespace triglav::resource {
 
-LoadContext::LoadContext(std::vector<ResourceStage>&& loadingStages) :
-    m_loadingStages(std::move(loadingStages))
+namespace {
+
+// Bumped whenever the compiled manifest changes.
+constexpr u32 g_assetListImporterVersion = 2;
+
+double to_milliseconds(const LoadContext::Clock::duration duration)
+{
+   return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::vector<ResourcePath> parse_asset_list(const io::Path& path, std::vector<char>& file)
+{
+   std::vector<ResourcePath> result{};
+
+   auto tree =
+      ryml::parse_in_place(c4::substr{const_cast<char*>(path.string().data()), path.string().size()}, c4::substr{file.data(), file.size()});
+   auto resources = tree["resources"];
+
+   for (const auto node : resources) {
+      auto name = node["name"].val();
+      auto source = node["source"].val();
+
+      ResourceProperties properties;
+
+      if (node.has_child("properties")) {
+         auto propertiesNode = node["properties"];
+         for (const auto property : propertiesNode) {
+            auto key = property.key();
+            auto value = property.val();
+            properties.add(make_name_id({key.data(), key.size()}), std::string{value.data(), value.size()});
+         }
+      }
+
+      std::string nameStr{name.data(), name.size()};
+      auto priority = default_load_priority(make_rc_name(nameStr).type());
+      if (node.has_child("priority")) {
+         const auto priorityStr = node["priority"].val();
+         if (priorityStr == "required") {
+            priority = LoadPriority::Required;
+         } else if (priorityStr == "visible") {
+            priority = LoadPriority::Visible;
+         } else if (priorityStr == "background") {
+            priority = LoadPriority::Background;
+         }
+      }
+
+      result.emplace_back(std::move(nameStr), std::string{source.data(), source.size()}, std::move(properties), priority);
+   }
+
+   return result;
+}
+
+std::vector<u8> serialize_manifest(const std::span<const ResourcePath> assets)
+{
+   CacheWriter writer;
+   writer.write<u64>(assets.size());
+   for (const auto& [name, source, properties, priority] : assets) {
+      writer.write_string(name);
+      writer.write_string(source);
+      writer.write(priority);
+      writer.write<u64>(properties.properties.size());
+      for (const auto& [key, value] : properties.properties) {
+         writer.write(key);
+         writer.write_string(value);
+      }
+   }
+   return {writer.data().begin(), writer.data().end()};
+}
+
+std::optional<std::vector<ResourcePath>> deserialize_manifest(const std::span<const u8> data)
+{
+   CacheReader reader{data};
+   std::vector<ResourcePath> result;
+   const auto assetCount = reader.read<u64>();
+   for (u64 assetIndex = 0; assetIndex < assetCount && assetIndex < data.size(); ++assetIndex) {
+      // The strings are copied once from the entry into the resource path that owns them.
+      const auto name = reader.read_string_view();
+      const auto source = reader.read_string_view();
+      const auto priority = reader.read<LoadPriority>();
+      auto& asset = result.emplace_back(std::string{name}, std::string{source}, ResourceProperties{}, priority);
+      const auto propertyCount = reader.read<u64>();
+      for (u64 propertyIndex = 0; propertyIndex < propertyCount && propertyIndex < data.size(); ++propertyIndex) {
+         const auto key = reader.read<Name>();
+         asset.properties.add(key, reader.read_string_view());
+      }
+   }
+
+   if (not reader.is_complete())
+      return std::nullopt;
+   return result;
+}
+
+}// namespace
+
+LoadPriority default_load_priority(const ResourceType type)
+{
+   switch (type) {
+   case ResourceType::FragmentShader:
+   case ResourceType::VertexShader:
+   case ResourceType::ComputeShader:
+   case ResourceType::MaterialTemplate:
+      return LoadPriority::Required;
+   default:
+      return LoadPriority::Background;
+   }
+}
+
+LoadContext::LoadContext(std::vector<ResourcePath>&& assets) :
+    m_startTime(Clock::now())
+{
+   for (auto& resourcePath : assets) {
+      const auto name = make_rc_name(resourcePath.name);
+      const auto priority = resourcePath.priority;
+      if (priority == LoadPriority::Required) {
+         ++m_pendingRequiredAssets;
+      }
+      m_assets.emplace(name, Asset{.resourcePath = std::move(resourcePath), .priority = priority, .readyTime = m_startTime});
+   }
+}
+
+std::vector<ResourceName> LoadContext::asset_names() const
 {
-   for (const auto& stage : m_loadingStages) {
-      m_totalAssets += stage.resourceList.size();
+   std::shared_lock lk{m_mutex};
+   std::vector<ResourceName> result;
+   result.reserve(m_assets.size());
+   for (const auto name : m_assets | std::views::keys) {
+      result.emplace_back(name);
    }
+   return result;
+}
+
+const ResourcePath& LoadContext::resource(const ResourceName name) const
+{
+   std::shared_lock lk{m_mutex};
+   return m_assets.at(name).resourcePath;
+}
+
+const AssetFile& LoadContext::file(const ResourceName name) const
+{
+   std::shared_lock lk{m_mutex};
+   return *m_assets.at(name).file;
 }
 
-const ResourceStage& LoadContext::next_stage()
+bool LoadContext::set_dependencies(const ResourceName name, const AssetFile& file, const std::span<const ResourceName> dependencies)
 {
    std::unique_lock lk{m_mutex};
-   m_assetsLoadedInStage = 0;
-   return m_loadingStages[m_currentStageId];
+
+   auto& asset = m_assets.at(name);
+   asset.file.emplace(file);
+   asset.preparedTime = Clock::now();
+
+   // Edges always point from an asset to a different resource type its loader reads, so the graph has no cycles.
+   for (const auto dependency : dependencies) {
+      const auto it = m_assets.find(dependency);
+      if (it == m_assets.end() || it->first == name)
+         continue;
+
+      if (it->second.finishTime.has_value()) {
+         if (not asset.lastDependency.has_value() || *m_assets.at(*asset.lastDependency).finishTime < *it->second.finishTime) {
+            asset.lastDependency = dependency;
+         }
+         continue;
+      }
+
+      ++asset.pendingDependencyCount;
+      asset.dependencies.emplace_back(dependency);
+      it->second.dependents.emplace_back(name);
+      this->promote_locked(dependency, asset.priority);
+   }
+
+   if (asset.pendingDependencyCount != 0)
+      return false;
+
+   asset.readyTime = Clock::now();
+   return true;
 }
 
-FinishLoadingAssetResult LoadContext::finish_loading_asset()
+FinishLoadingAssetResult LoadContext::finish_loading_asset(const ResourceName name, std::vector<ResourceName>& readyAssets)
 {
    std::unique_lock lk{m_mutex};
 
-   ++m_assetsLoadedInStage;
+   const auto now = Clock::now();
+   auto& asset = m_assets.at(name);
+   asset.finishTime = now;
+   asset.dependencies.clear();
    ++m_totalLoadedAssets;
 
-   if (m_assetsLoadedInStage >= m_loadingStages[m_currentStageId].resourceList.size()) {
-      ++m_currentStageId;
-      if (m_currentStageId >= m_loadingStages.size()) {
-         return FinishLoadingAssetResult::FinishedLoadingAssets;
+   for (const auto dependentName : asset.dependents) {
+      auto& dependent = m_assets.at(dependentName);
+      --dependent.pendingDependencyCount;
+      if (dependent.pendingDependencyCount == 0) {
+         dependent.lastDependency = name;
+         dependent.readyTime = now;
+         readyAssets.emplace_back(dependentName);
       }
+   }
+   asset.dependents.clear();
 
-      return FinishLoadingAssetResult::FinishedStage;
+   if (m_totalLoadedAssets >= m_assets.size()) {
+      return FinishLoadingAssetResult::FinishedLoadingAssets;
+   }
+   if (asset.priority == LoadPriority::Required && not m_hasLoadedRequiredAssets) {
+      --m_pendingRequiredAssets;
+      if (m_pendingRequiredAssets == 0) {
+         m_hasLoadedRequiredAssets = true;
+         return FinishLoadingAssetResult::FinishedLoadingRequiredAssets;
+      }
    }
 
    return FinishLoadingAssetResult::None;
 }
 
+void LoadContext::enqueue(const LoadTask task)
+{
+   std::unique_lock lk{m_mutex};
+
+   auto& asset = m_assets.at(task.name);
+   assert(not asset.queuedStep.has_value());
+   asset.queuedStep = task.step;
+   m_queuedAssets[static_cast<u32>(asset.priority)].emplace_back(task.name);
+}
+
+std::optional<LoadTask> LoadContext::next_task()
+{
+   std::unique_lock lk{m_mutex};
+
+   for (auto& queue : m_queuedAssets) {
+      if (queue.empty())
+         continue;
+
+      const auto name = queue.front();
+      queue.pop_front();
+      auto& asset = m_assets.at(name);
+      const auto step = *asset.queuedStep;
+      asset.queuedStep.reset();
+      return LoadTask{name, step};
+   }
+
+   return std::nullopt;
+}
+
+LoadPriority LoadContext::priority(const ResourceName name) const
+{
+   std::shared_lock lk{m_mutex};
+   const auto it = m_assets.find(name);
+   if (it == m_assets.end())
+      return LoadPriority::Background;
+   return it->second.priority;
+}
+
+void LoadContext::promote(const ResourceName name, const LoadPriority priority)
+{
+   std::unique_lock lk{m_mutex};
+   this->promote_locked(name, priority);
+}
+
+void LoadContext::promote_locked(const ResourceName name, const LoadPriority priority)
+{
+   const auto it = m_assets.find(name);
+   if (it == m_assets.end())
+      return;
+
+   auto& asset = it->second;
+   if (asset.priority <= priority || asset.finishTime.has_value())
+      return;
+
+   if (asset.queuedStep.has_value()) {
+      std::erase(m_queuedAssets[static_cast<u32>(asset.priority)], name);
+      m_queuedAssets[static_cast<u32>(priority)].emplace_back(name);
+   }
+   // Assets promoted after the required ones are loaded are only loaded first, the event isn't reported again.
+   if (priority == LoadPriority::Required && not m_hasLoadedRequiredAssets) {
+      ++m_pendingRequiredAssets;
+   }
+   asset.priority = priority;
+
+   // Dependencies of an asset that isn't prepared yet are promoted once they are known.
+   for (const auto dependency : asset.dependencies) {
+      this->promote_locked(dependency, priority);
+   }
+}
+
 u32 LoadContext::total_assets() const
 {
    std::shared_lock lk{m_mutex};
-   return m_totalAssets;
+   return static_cast<u32>(m_assets.size());
 }
+
 u32 LoadContext::total_loaded_assets() const
 {
    std::shared_lock lk{m_mutex};
    return m_totalLoadedAssets;
 }
-u32 LoadContext::current_stage_id() const
+
+LoadContext::Clock::duration LoadContext::elapsed_time() const
 {
-   std::shared_lock lk{m_mutex};
-   return m_currentStageId;
+   return Clock::now() - m_startTime;
 }
 
-std::unique_ptr<LoadContext> LoadContext::from_asset_list(const io::Path& path)
+LoadContext::Clock::time_point LoadContext::prepared_time(const ResourceName name) const
 {
-   std::vector<ResourceStage> result{};
-   result.resize(loading_stage_count());
+   std::shared_lock lk{m_mutex};
+   return m_assets.at(name).preparedTime;
+}
 
-   auto file = io::read_whole_file(path);
-   auto tree =
-      ryml::parse_in_place(c4::substr{const_cast<char*>(path.string().data()), path.string().size()}, c4::substr{file.data(), file.size()});
-   auto resources = tree["resources"];
+std::string LoadContext::critical_path() const
+{
+   std::shared_lock lk{m_mutex};
 
-   for (const auto node : resources) {
-      auto name = node["name"].val();
-      auto source = node["source"].val();
+   const Asset* last{};
+   for (const auto& asset : m_assets | std::views::values) {
+      if (asset.finishTime.has_value() && (last == nullptr || *last->finishTime < *asset.finishTime)) {
+         last = &asset;
+      }
+   }
+   if (last == nullptr)
+      return "empty";
 
-      ResourceProperties properties;
+   std::vector<const Asset*> chain{last};
+   while (chain.back()->lastDependency.has_value()) {
+      chain.emplace_back(&m_assets.at(*chain.back()->lastDependency));
+   }
 
-      if (node.has_child("properties")) {
-         auto propertiesNode = node["properties"];
-         for (const auto property : propertiesNode) {
-            auto key = property.key();
-            auto value = property.val();
-            properties.add(make_name_id({key.data(), key.size()}), std::string{value.data(), value.size()});
-         }
+   auto result = std::format("{:.1f} ms:", to_milliseconds(*last->finishTime - m_startTime));
+   for (const auto* asset : chain | std::views::reverse) {
+      result += std::format(" {} ({:.1f} ms)", asset->resourcePath.name, to_milliseconds(*asset->finishTime - asset->readyTime));
+      if (asset != last) {
+         result += " ->";
       }
-
-      auto resourceName = make_rc_name(std::string{name.data(), name.size()});
-      result[resourceName.loading_stage()].resourceList.emplace_back(std::string{name.data(), name.size()},
-                                                                     std::string{source.data(), source.size()}, std::move(properties));
    }
+   return result;
+}
 
-   result.erase(std::ranges::remove_if(result, [](const ResourceStage& stage) { return stage.resourceList.empty(); }).begin(),
-                result.end());
+std::unique_ptr<LoadContext> LoadContext::from_asset_list(const io::Path& path)
+{
+   return from_asset_list(path, AssetCache::the());
+}
+
+std::unique_ptr<LoadContext> LoadContext::from_asset_list(const io::Path& path, AssetCache& cache)
+{
+   auto file = io::read_whole_file(path);
+   const auto key =
+      AssetCache::make_key({reinterpret_cast<const u8*>(file.data()), file.size()}, "asset_list", g_assetListImporterVersion, "");
+
+   // The YAML asset list is the authoring format, warm starts read the compiled manifest without parsing it.
+   if (const auto entry = cache.read(key); entry.has_value()) {
+      if (auto assets = deserialize_manifest(*entry); assets.has_value()) {
+         return std::make_unique<LoadContext>(std::move(*assets));
+      }
+   }
 
-   return std::make_unique<LoadContext>(std::move(result));
+   auto assets = parse_asset_list(path, file);
+   cache.write(key, serialize_manifest(assets));
+   return std::make_unique<LoadContext>(std::move(assets));
 }
 
-}// namespace triglav::resource
\ No newline at end of file
+}// namespace triglav::resource
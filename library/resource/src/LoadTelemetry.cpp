@@ -0,0 +1,224 @@
+#include "LoadTelemetry.h"
+
+#include <algorithm>
+#include <format>
+#include <map>
+#include <utility>
+
+namespace triglav::resource {
+
+namespace {
+
+constexpr u32 g_defaultEventsPerThread = 4096;
+
+thread_local ResourceName g_currentAsset{};
+
+std::string escape_json(const std::string_view value)
+{
+   std::string result;
+   result.reserve(value.size());
+   for (const auto ch : value) {
+      if (ch == '"' || ch == '\\') {
+         result.push_back('\\');
+      }
+      result.push_back(ch);
+   }
+   return result;
+}
+
+double to_microseconds(const LoadEvent::Clock::duration duration)
+{
+   return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}// namespace
+
+std::string_view load_phase_name(const LoadPhase phase)
+{
+   switch (phase) {
+   case LoadPhase::FileRead:
+      return "file read";
+   case LoadPhase::Decode:
+      return "decode";
+   case LoadPhase::Process:
+      return "process";
+   case LoadPhase::Upload:
+      return "upload";
+   case LoadPhase::DependencyWait:
+      return "dependency wait";
+   case LoadPhase::Count:
+      break;
+   }
+   return "unknown";
+}
+
+LoadTelemetry::LoadTelemetry(const u32 eventsPerThread) :
+    m_eventsPerThread(eventsPerThread)
+{
+}
+
+LoadTelemetry::ThreadBuffer* LoadTelemetry::thread_buffer(const threading::ThreadID thread)
+{
+   if (thread >= g_maxThreadCount)
+      return nullptr;
+
+   if (auto* buffer = m_threadBuffers[thread].load(std::memory_order_acquire); buffer != nullptr)
+      return buffer;
+
+   // Only the first event of a thread takes the lock.
+   std::unique_lock lk{m_allocationMutex};
+   auto& buffer = m_ownedBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+   buffer->events.resize(m_eventsPerThread);
+   m_threadBuffers[thread].store(buffer.get(), std::memory_order_release);
+   return buffer.get();
+}
+
+void LoadTelemetry::record(const ResourceName asset, const LoadPhase phase, const Clock::time_point start, const Clock::time_point end)
+{
+   if (m_eventsPerThread == 0)
+      return;
+
+   const auto thread = threading::this_thread_id();
+   auto* buffer = this->thread_buffer(thread);
+   if (buffer == nullptr)
+      return;
+
+   const auto writeCount = buffer->writeCount.load(std::memory_order_relaxed);
+   buffer->events[writeCount % m_eventsPerThread] = LoadEvent{asset, phase, thread, start, end};
+   buffer->writeCount.store(writeCount + 1, std::memory_order_release);
+}
+
+std::vector<LoadEvent> LoadTelemetry::events(const Clock::time_point since) const
+{
+   std::vector<LoadEvent> result;
+   for (const auto& threadBuffer : m_threadBuffers) {
+      const auto* buffer = threadBuffer.load(std::memory_order_acquire);
+      if (buffer == nullptr)
+         continue;
+
+      const auto writeCount = buffer->writeCount.load(std::memory_order_acquire);
+      const auto first = writeCount > m_eventsPerThread ? writeCount - m_eventsPerThread : 0;
+      for (auto index = first; index < writeCount; ++index) {
+         const auto& event = buffer->events[index % m_eventsPerThread];
+         if (event.start >= since) {
+            result.emplace_back(event);
+         }
+      }
+   }
+
+   std::ranges::stable_sort(result, {}, &LoadEvent::start);
+   return result;
+}
+
+std::string LoadTelemetry::chrome_trace(const Clock::time_point since, const AssetNameFunc& assetName) const
+{
+   const auto events = this->events(since);
+
+   std::string result{"{\"traceEvents\":["};
+   bool isFirst = true;
+   const auto append_event = [&](const std::string& event) {
+      if (not isFirst) {
+         result += ",\n";
+      }
+      result += event;
+      isFirst = false;
+   };
+
+   std::vector<threading::ThreadID> threads;
+   for (const auto& event : events) {
+      if (std::ranges::find(threads, event.thread) == threads.end()) {
+         threads.emplace_back(event.thread);
+      }
+   }
+   for (const auto thread : threads) {
+      const auto threadName = thread == threading::g_mainThread ? std::string{"main"} : std::format("worker {}", thread);
+      append_event(std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", thread, threadName));
+   }
+
+   for (const auto& event : events) {
+      const auto name = escape_json(assetName(event.asset));
+      const auto timestamp = to_microseconds(event.start - since);
+      const auto duration = to_microseconds(event.end - event.start);
+      const auto phaseName = load_phase_name(event.phase);
+
+      if (event.phase == LoadPhase::DependencyWait) {
+         const auto id = event.asset.name();
+         append_event(std::format(R"({{"name":"{}","cat":"{}","ph":"b","id":"{:x}","pid":1,"tid":{},"ts":{:.3f}}})", name, phaseName, id,
+                                  event.thread, timestamp));
+         append_event(std::format(R"({{"name":"{}","cat":"{}","ph":"e","id":"{:x}","pid":1,"tid":{},"ts":{:.3f}}})", name, phaseName, id,
+                                  event.thread, timestamp + duration));
+      } else {
+         append_event(std::format(R"({{"name":"{} {}","cat":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})", phaseName, name,
+                                  phaseName, event.thread, timestamp, duration));
+      }
+   }
+
+   result += "]}\n";
+   return result;
+}
+
+std::string LoadTelemetry::summary(const Clock::time_point since) const
+{
+   struct TypeSummary
+   {
+      std::array<Clock::duration, static_cast<u32>(LoadPhase::Count)> phaseTimes{};
+   };
+
+   std::map<ResourceType, TypeSummary> summaries;
+   for (const auto& event : this->events(since)) {
+      summaries[event.asset.type()].phaseTimes[static_cast<u32>(event.phase)] += event.end - event.start;
+   }
+
+   std::string result = std::format("{:<18}", "type");
+   for (u32 phase = 0; phase < static_cast<u32>(LoadPhase::Count); ++phase) {
+      result += std::format(" {:>15}", load_phase_name(static_cast<LoadPhase>(phase)));
+   }
+   for (const auto& [type, summary] : summaries) {
+      result += std::format("\n{:<18}", resource_type_name(type));
+      for (const auto phaseTime : summary.phaseTimes) {
+         result += std::format(" {:>12.1f} ms", std::chrono::duration<double, std::milli>(phaseTime).count());
+      }
+   }
+   return result;
+}
+
+LoadTelemetry& LoadTelemetry::the()
+{
+   static LoadTelemetry instance(g_defaultEventsPerThread);
+   return instance;
+}
+
+LoadAssetScope::LoadAssetScope(const ResourceName asset) :
+    m_previousAsset(std::exchange(g_currentAsset, asset))
+{
+}
+
+LoadAssetScope::~LoadAssetScope()
+{
+   g_currentAsset = m_previousAsset;
+}
+
+LoadPhaseScope::LoadPhaseScope(const LoadPhase phase) :
+    m_phase(phase),
+    m_start(LoadTelemetry::Clock::now())
+{
+}
+
+LoadPhaseScope::~LoadPhaseScope()
+{
+   if (g_currentAsset == g_emptyResource)
+      return;
+   LoadTelemetry::the().record(g_currentAsset, m_phase, m_start, LoadTelemetry::Clock::now());
+}
+
+void LoadPhaseScope::next(const LoadPhase phase)
+{
+   const auto now = LoadTelemetry::Clock::now();
+   if (g_currentAsset != g_emptyResource) {
+      LoadTelemetry::the().record(g_currentAsset, m_phase, m_start, now);
+   }
+   m_phase = phase;
+   m_start = now;
+}
+
+}// namespace triglav::resource
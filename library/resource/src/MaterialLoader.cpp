@@ -1,28 +1,63 @@
 #include "MaterialLoader.h"
 
-#include "triglav/io/File.h"
+#include "AssetCache.h"
+#include "LoadTelemetry.h"
+
 #include "triglav/render_core/Material.hpp"
 
+#include <charconv>
 #include <ranges>
 #include <ryml.hpp>
 #include <string>
 
 namespace triglav::resource {
 
-render_core::MaterialTemplate Loader<ResourceType::MaterialTemplate>::load(const io::Path& path)
+namespace {
+
+// Bumped whenever the compiled format changes.
+constexpr u32 g_materialImporterVersion = 1;
+
+struct CompiledMaterialTemplate
 {
-   auto file = io::read_whole_file(path);
-   assert(not file.empty());
+   FragmentShaderName fragmentShader;
+   VertexShaderName vertexShader;
+   std::vector<render_core::MaterialProperty> properties;
+};
+
+// Values are compiled without the template, a scalar is kept both as a resource name and as a number
+// and the property type of the template picks one of them on load.
+struct CompiledMaterialProperty
+{
+   Name name;
+   ResourceName resourceValue;
+   glm::vec4 value{0.0f};
+};
+
+struct CompiledMaterial
+{
+   MaterialTemplateName materialTemplate;
+   std::vector<CompiledMaterialProperty> properties;
+};
+
+float parse_float(const c4::csubstr value)
+{
+   float result{};
+   std::from_chars(value.data(), value.data() + value.size(), result);
+   return result;
+}
 
+CompiledMaterialTemplate parse_material_template(const AssetFile& file, const AssetData& data)
+{
+   const LoadPhaseScope phaseScope{LoadPhase::Decode};
 
    auto tree =
-      ryml::parse_in_place(c4::substr{const_cast<char*>(path.string().data()), path.string().size()}, c4::substr{file.data(), file.size()});
+      ryml::parse_in_arena(c4::csubstr{file.name().data(), file.name().size()}, c4::csubstr{data.text().data(), data.text().size()});
 
    auto fragmentShader = tree["fragment_shader"].val();
    auto vertexShader = tree["vertex_shader"].val();
 
-   render_core::MaterialTemplate result{.fragmentShader{make_rc_name({fragmentShader.data(), fragmentShader.size()})},
-                                        .vertexShader{make_rc_name({vertexShader.data(), vertexShader.size()})}};
+   CompiledMaterialTemplate result{.fragmentShader{make_rc_name({fragmentShader.data(), fragmentShader.size()})},
+                                   .vertexShader{make_rc_name({vertexShader.data(), vertexShader.size()})}};
 
    auto properties = tree["properties"];
 
@@ -47,74 +82,174 @@ render_core::MaterialTemplate Loader<ResourceType::MaterialTemplate>::load(const
    return result;
 }
 
-render_core::Material Loader<ResourceType::Material>::load(ResourceManager& manager, const io::Path& path)
+CompiledMaterial parse_material(const AssetFile& file, const AssetData& data)
 {
-   auto file = io::read_whole_file(path);
-   assert(not file.empty());
+   const LoadPhaseScope phaseScope{LoadPhase::Decode};
 
    auto tree =
-      ryml::parse_in_place(c4::substr{const_cast<char*>(path.string().data()), path.string().size()}, c4::substr{file.data(), file.size()});
+      ryml::parse_in_arena(c4::csubstr{file.name().data(), file.name().size()}, c4::csubstr{data.text().data(), data.text().size()});
 
    auto templateStr = tree["template"].val();
-   auto templateName = make_rc_name({templateStr.data(), templateStr.size()});
-
-   auto& materialTemplate = manager.get<ResourceType::MaterialTemplate>(templateName);
-
-   std::vector<render_core::MaterialPropertyValue> values;
-   values.resize(materialTemplate.properties.size(), 0.0f);
+   CompiledMaterial result{.materialTemplate{make_rc_name({templateStr.data(), templateStr.size()})}};
 
    auto properties = tree["properties"];
    for (const auto& property : properties) {
       auto nameStr = property.key();
 
-      auto name = make_name_id({nameStr.data(), nameStr.size()});
+      CompiledMaterialProperty compiledProperty{.name = make_name_id({nameStr.data(), nameStr.size()})};
+      if (property.has_val()) {
+         auto valueStr = property.val();
+         compiledProperty.resourceValue = make_rc_name({valueStr.data(), valueStr.size()});
+         compiledProperty.value.x = parse_float(valueStr);
+      } else {
+         compiledProperty.value = glm::vec4{
+            parse_float(property["x"].val()),
+            parse_float(property["y"].val()),
+            parse_float(property["z"].val()),
+            property.has_child("w") ? parse_float(property["w"].val()) : 0.0f,
+         };
+      }
+
+      result.properties.emplace_back(compiledProperty);
+   }
+
+   return result;
+}
+
+CompiledMaterialTemplate compile_material_template(const AssetFile& file)
+{
+   const auto data = file.read();
+   assert(not data.empty());
+
+   const auto key = AssetCache::make_key(data.bytes(), "material_template", g_materialImporterVersion, "");
+
+   auto& cache = AssetCache::the();
+   if (const auto entry = cache.read(key); entry.has_value()) {
+      const LoadPhaseScope phaseScope{LoadPhase::Decode};
+      CacheReader reader{*entry};
+      CompiledMaterialTemplate result{
+         .fragmentShader = FragmentShaderName{reader.read<Name>()},
+         .vertexShader = VertexShaderName{reader.read<Name>()},
+         .properties = reader.read_array<render_core::MaterialProperty>(),
+      };
+      if (reader.is_complete())
+         return result;
+   }
+
+   auto result = parse_material_template(file, data);
+
+   CacheWriter writer;
+   writer.write(result.fragmentShader.name());
+   writer.write(result.vertexShader.name());
+   writer.write_array(std::span<const render_core::MaterialProperty>{result.properties});
+   cache.write(key, writer.data());
+
+   return result;
+}
+
+// The material is compiled once for its dependencies and read back from the cache when it's loaded.
+CompiledMaterial compile_material(const AssetFile& file, const AssetData& data)
+{
+   const auto key = AssetCache::make_key(data.bytes(), "material", g_materialImporterVersion, "");
+
+   auto& cache = AssetCache::the();
+   if (const auto entry = cache.read(key); entry.has_value()) {
+      const LoadPhaseScope phaseScope{LoadPhase::Decode};
+      CacheReader reader{*entry};
+      CompiledMaterial result{
+         .materialTemplate = MaterialTemplateName{reader.read<Name>()},
+         .properties = reader.read_array<CompiledMaterialProperty>(),
+      };
+      if (reader.is_complete())
+         return result;
+   }
+
+   auto result = parse_material(file, data);
 
+   CacheWriter writer;
+   writer.write(result.materialTemplate.name());
+   writer.write_array(std::span<const CompiledMaterialProperty>{result.properties});
+   cache.write(key, writer.data());
+
+   return result;
+}
+
+}// namespace
+
+render_core::MaterialTemplate Loader<ResourceType::MaterialTemplate>::load(const AssetFile& file)
+{
+   auto compiledTemplate = compile_material_template(file);
+   return render_core::MaterialTemplate{
+      .fragmentShader = compiledTemplate.fragmentShader,
+      .vertexShader = compiledTemplate.vertexShader,
+      .properties = std::move(compiledTemplate.properties),
+   };
+}
+
+render_core::Material Loader<ResourceType::Material>::load(ResourceManager& manager, const AssetFile& file)
+{
+   const auto data = file.read();
+   assert(not data.empty());
+
+   const auto compiledMaterial = compile_material(file, data);
+   auto& materialTemplate = manager.get<ResourceType::MaterialTemplate>(compiledMaterial.materialTemplate);
+
+   std::vector<render_core::MaterialPropertyValue> values;
+   values.resize(materialTemplate.properties.size(), 0.0f);
+
+   for (const auto& property : compiledMaterial.properties) {
       auto it = std::ranges::find_if(materialTemplate.properties,
-                                     [target = name](const render_core::MaterialProperty& prop) { return prop.name == target; });
+                                     [target = property.name](const render_core::MaterialProperty& prop) { return prop.name == target; });
       if (it == materialTemplate.properties.end())
          continue;
 
       auto index = it - materialTemplate.properties.begin();
 
       switch (it->type) {
-      case render_core::MaterialPropertyType::Texture2D: {
-         auto valueStr = property.val();
-         values[index] = TextureName{make_rc_name({valueStr.data(), valueStr.size()})};
+      case render_core::MaterialPropertyType::Texture2D:
+         values[index] = TextureName{property.resourceValue};
          break;
-      }
-      case render_core::MaterialPropertyType::Float32: {
-         auto valueStr = property.val();
-         values[index] = std::stof({valueStr.data(), valueStr.size()});
+      case render_core::MaterialPropertyType::Float32:
+         values[index] = property.value.x;
          break;
-      }
-      case render_core::MaterialPropertyType::Vec3: {
-         const auto xStr = property["x"].val();
-         const auto yStr = property["y"].val();
-         const auto zStr = property["z"].val();
-         values[index] = glm::vec3{
-            std::stof({xStr.data(), xStr.size()}),
-            std::stof({yStr.data(), yStr.size()}),
-            std::stof({zStr.data(), zStr.size()}),
-         };
+      case render_core::MaterialPropertyType::Vec3:
+         values[index] = glm::vec3{property.value};
          break;
-      }
-      case render_core::MaterialPropertyType::Vec4: {
-         const auto xStr = property["x"].val();
-         const auto yStr = property["y"].val();
-         const auto zStr = property["z"].val();
-         const auto wStr = property["w"].val();
-         values[index] = glm::vec4{
-            std::stof({xStr.data(), xStr.size()}),
-            std::stof({yStr.data(), yStr.size()}),
-            std::stof({zStr.data(), zStr.size()}),
-            std::stof({wStr.data(), wStr.size()}),
-         };
+      case render_core::MaterialPropertyType::Vec4:
+         values[index] = property.value;
          break;
       }
-      }
    }
 
-   return render_core::Material{.materialTemplate = templateName, .values = std::move(values)};
+   return render_core::Material{.materialTemplate = compiledMaterial.materialTemplate, .values = std::move(values)};
+}
+
+std::vector<ResourceName> Loader<ResourceType::MaterialTemplate>::collect_dependencies(const AssetFile& file,
+                                                                                      [[maybe_unused]] const ResourceProperties& props)
+{
+   const auto compiledTemplate = compile_material_template(file);
+   return {compiledTemplate.fragmentShader, compiledTemplate.vertexShader};
+}
+
+std::vector<ResourceName> Loader<ResourceType::Material>::collect_dependencies(const AssetFile& file,
+                                                                              [[maybe_unused]] const ResourceProperties& props)
+{
+   const auto data = file.read();
+   if (data.empty())
+      return {};
+
+   return {compile_material(file, data).materialTemplate};
+}
+
+std::vector<ResourceName> Loader<ResourceType::Material>::collect_references(const render_core::Material& material)
+{
+   std::vector<ResourceName> result;
+   for (const auto& value : material.values) {
+      if (std::holds_alternative<TextureName>(value)) {
+         result.emplace_back(std::get<TextureName>(value));
+      }
+   }
+   return result;
 }
 
 }// namespace triglav::resource
@@ -1,27 +1,144 @@
 #include "ModelLoader.h"
 
+#include "AssetCache.h"
+#include "LoadTelemetry.h"
+
 #include "triglav/geometry/Mesh.h"
+#include "triglav/io/MemoryFile.h"
 
 #include <algorithm>
+#include <cassert>
 #include <format>
 
 namespace triglav::resource {
 
-render_core::Model Loader<ResourceType::Model>::load_gpu(graphics_api::Device& device, const io::Path& path,
+namespace {
+
+// Bumped whenever the import produces different data from the same source.
+constexpr u32 g_objImporterVersion = 1;
+
+struct CookedMesh
+{
+   geometry::VertexData vertexData;
+   geometry::BoundingBox boundingBox;
+};
+
+std::vector<u8> serialize_mesh(const CookedMesh& mesh)
+{
+   CacheWriter writer;
+   writer.write_array(std::span<const geometry::Vertex>{mesh.vertexData.vertices});
+   writer.write_array(std::span<const u32>{mesh.vertexData.indices});
+   writer.write<u64>(mesh.vertexData.ranges.size());
+   for (const auto& range : mesh.vertexData.ranges) {
+      writer.write<u64>(range.offset);
+      writer.write<u64>(range.size);
+      writer.write_string(range.materialName);
+   }
+   writer.write(mesh.boundingBox);
+   return {writer.data().begin(), writer.data().end()};
+}
+
+// Cooked mesh parsed in place, the vertex and index data point into the serialized entry and are uploaded from there.
+struct CookedMeshView
+{
+   std::span<const u8> vertexBytes;
+   std::span<const u8> indexBytes;
+   std::vector<geometry::MaterialRange> ranges;
+   geometry::BoundingBox boundingBox;
+};
+
+std::optional<CookedMeshView> parse_mesh(const std::span<const u8> data)
+{
+   CacheReader reader{data};
+   CookedMeshView result{};
+   result.vertexBytes = reader.read_array_bytes<geometry::Vertex>();
+   result.indexBytes = reader.read_array_bytes<u32>();
+   const auto rangeCount = reader.read<u64>();
+   for (u64 rangeIndex = 0; rangeIndex < rangeCount && rangeIndex < data.size(); ++rangeIndex) {
+      const auto offset = reader.read<u64>();
+      const auto size = reader.read<u64>();
+      result.ranges.emplace_back(offset, size, std::string{reader.read_string_view()});
+   }
+   result.boundingBox = reader.read<geometry::BoundingBox>();
+
+   if (not reader.is_complete())
+      return std::nullopt;
+   return result;
+}
+
+// Parsing the OBJ file and generating tangents is the expensive part of loading a model, the result is cached.
+// Returns the serialized mesh, which is valid for parse_mesh.
+std::vector<u8> cook_mesh(const AssetFile& file)
+{
+   const auto source = file.read();
+   const auto key = AssetCache::make_key(source.bytes(), "obj", g_objImporterVersion, "");
+
+   auto& cache = AssetCache::the();
+   if (auto entry = cache.read(key); entry.has_value()) {
+      const LoadPhaseScope phaseScope{LoadPhase::Decode};
+      if (parse_mesh(*entry).has_value()) {
+         return std::move(*entry);
+      }
+   }
+
+   geometry::Mesh objMesh;
+   {
+      const LoadPhaseScope phaseScope{LoadPhase::Decode};
+      io::MemoryFile stream{source.bytes()};
+      objMesh = geometry::Mesh::from_stream(stream);
+   }
+
+   CookedMesh result{};
+   {
+      const LoadPhaseScope phaseScope{LoadPhase::Process};
+      objMesh.triangulate();
+      objMesh.recalculate_tangents();
+      result = CookedMesh{objMesh.to_vertex_data(), objMesh.calculate_bouding_box()};
+   }
+
+   auto serializedMesh = serialize_mesh(result);
+   cache.write(key, serializedMesh);
+   return serializedMesh;
+}
+
+}// namespace
+
+render_core::Model Loader<ResourceType::Model>::load_gpu(graphics_api::Device& device, const AssetFile& file,
                                                          const ResourceProperties& props)
 {
-   const auto objMesh = geometry::Mesh::from_file(path);
-   objMesh.triangulate();
-   objMesh.recalculate_tangents();
-   auto deviceMesh = objMesh.upload_to_device(device);
+   const auto serializedMesh = cook_mesh(file);
+   const auto cookedMesh = parse_mesh(serializedMesh);
+   assert(cookedMesh.has_value());
+
+   // The vertices and indices are copied from the entry straight into the staging memory.
+   const LoadPhaseScope phaseScope{LoadPhase::Upload};
+   graphics_api::VertexArray<geometry::Vertex> vertices{device, cookedMesh->vertexBytes.size() / sizeof(geometry::Vertex)};
+   vertices.write_bytes(cookedMesh->vertexBytes);
+   graphics_api::IndexArray indices{device, cookedMesh->indexBytes.size() / sizeof(u32)};
+   indices.write_bytes(cookedMesh->indexBytes);
 
    std::vector<render_core::MaterialRange> ranges{};
-   ranges.resize(deviceMesh.ranges.size());
-   std::transform(deviceMesh.ranges.begin(), deviceMesh.ranges.end(), ranges.begin(), [](const geometry::MaterialRange& range) {
+   ranges.resize(cookedMesh->ranges.size());
+   std::transform(cookedMesh->ranges.begin(), cookedMesh->ranges.end(), ranges.begin(), [](const geometry::MaterialRange& range) {
       return render_core::MaterialRange{range.offset, range.size, make_rc_name(std::format("{}.mat", range.materialName))};
    });
 
-   return render_core::Model{std::move(deviceMesh.mesh), objMesh.calculate_bouding_box(), std::move(ranges)};
+   return render_core::Model{{std::move(vertices), std::move(indices)}, cookedMesh->boundingBox, std::move(ranges)};
+}
+
+MemorySize Loader<ResourceType::Model>::resource_size(const render_core::Model& model)
+{
+   return model.mesh.vertices.count() * sizeof(geometry::Vertex) + model.mesh.indices.count() * sizeof(u32);
+}
+
+std::vector<ResourceName> Loader<ResourceType::Model>::collect_references(const render_core::Model& model)
+{
+   std::vector<ResourceName> result;
+   result.reserve(model.range.size());
+   for (const auto& range : model.range) {
+      result.emplace_back(range.materialName);
+   }
+   return result;
 }
 
 }// namespace triglav::resource
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "PackArchive.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace triglav::resource {
+
+namespace {
+
+constexpr u32 g_packMagic = 0x4B504754;// TGPK
+constexpr u32 g_packVersion = 1;
+constexpr MemorySize g_headerSize = 16;
+constexpr MemorySize g_indexEntrySize = 48;
+
+// The index is sorted in the order of ResourceName, by the name hash and then by the type.
+// Header:       magic u32, version u32, entry count u32, reserved u32
+// Index entry:  name u64, type u32, compression u32, offset u64, stored size u64, size u64, source offset u32, source size u32
+
+template<typename T>
+T read_value(const std::span<const u8> data, const MemorySize offset)
+{
+   T result;
+   std::memcpy(&result, data.data() + offset, sizeof(T));
+   return result;
+}
+
+template<typename T>
+void write_value(std::vector<u8>& data, const MemorySize offset, const T value)
+{
+   std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+ResourceName entry_name(const std::span<const u8> data, const u32 index)
+{
+   const auto offset = g_headerSize + index * g_indexEntrySize;
+   return {static_cast<ResourceType>(read_value<u32>(data, offset + 8)), read_value<u64>(data, offset)};
+}
+
+}// namespace
+
+std::optional<PackArchive> PackArchive::open(const io::Path& path)
+{
+   auto file = io::map_file(path);
+   if (not file.has_value())
+      return std::nullopt;
+
+   const auto data = file->data();
+   if (data.size() < g_headerSize || read_value<u32>(data, 0) != g_packMagic || read_value<u32>(data, 4) != g_packVersion)
+      return std::nullopt;
+
+   const auto entryCount = read_value<u32>(data, 8);
+   if (data.size() < g_headerSize + entryCount * g_indexEntrySize)
+      return std::nullopt;
+
+   // Payloads and source paths are validated once, so lookups don't need to check the ranges.
+   for (u32 index = 0; index < entryCount; ++index) {
+      const auto offset = g_headerSize + index * g_indexEntrySize;
+      const auto payloadOffset = read_value<u64>(data, offset + 16);
+      const auto storedSize = read_value<u64>(data, offset + 24);
+      const auto sourceOffset = read_value<u32>(data, offset + 40);
+      const auto sourceSize = read_value<u32>(data, offset + 44);
+      if (payloadOffset > data.size() || storedSize > data.size() - payloadOffset || sourceOffset > data.size() ||
+          sourceSize > data.size() - sourceOffset)
+         return std::nullopt;
+      if (index > 0 && entry_name(data, index - 1) >= entry_name(data, index))
+         return std::nullopt;
+   }
+
+   return PackArchive{std::move(*file), entryCount};
+}
+
+PackArchive::PackArchive(io::MappedFile&& file, const u32 entryCount) :
+    m_file(std::move(file)),
+    m_entryCount(entryCount)
+{
+}
+
+std::optional<PackEntry> PackArchive::find(const ResourceName name) const
+{
+   const auto data = m_file.data();
+
+   u32 first = 0;
+   u32 count = m_entryCount;
+   while (count > 0) {
+      const auto step = count / 2;
+      if (entry_name(data, first + step) < name) {
+         first += step + 1;
+         count -= step + 1;
+      } else {
+         count = step;
+      }
+   }
+
+   if (first == m_entryCount || entry_name(data, first) != name)
+      return std::nullopt;
+   return this->entry(first);
+}
+
+u32 PackArchive::entry_count() const
+{
+   return m_entryCount;
+}
+
+PackEntry PackArchive::entry(const u32 index) const
+{
+   const auto data = m_file.data();
+   const auto offset = g_headerSize + index * g_indexEntrySize;
+   const auto sourceOffset = read_value<u32>(data, offset + 40);
+   const auto sourceSize = read_value<u32>(data, offset + 44);
+
+   return PackEntry{
+      .name = entry_name(data, index),
+      .data = data.subspan(read_value<u64>(data, offset + 16), read_value<u64>(data, offset + 24)),
+      .size = read_value<u64>(data, offset + 32),
+      .compression = static_cast<PackCompression>(read_value<u32>(data, offset + 12)),
+      .source = {reinterpret_cast<const char*>(data.data() + sourceOffset), sourceSize},
+   };
+}
+
+std::optional<std::vector<u8>> PackArchive::unpack(const PackEntry& entry)
+{
+   switch (entry.compression) {
+   case PackCompression::None:
+      return std::vector<u8>{entry.data.begin(), entry.data.end()};
+   case PackCompression::Deflate: {
+      std::vector<u8> result(entry.size);
+      auto size = static_cast<uLongf>(result.size());
+      if (uncompress(result.data(), &size, entry.data.data(), static_cast<uLong>(entry.data.size())) != Z_OK || size != entry.size)
+         return std::nullopt;
+      return result;
+   }
+   }
+   return std::nullopt;
+}
+
+void PackWriter::add(const ResourceName name, const std::string_view source, const std::span<const u8> data,
+                     const PackCompression compression)
+{
+   Entry entry{
+      .name = name,
+      .source = std::string{source},
+      .data{},
+      .size = data.size(),
+      .compression = PackCompression::None,
+   };
+
+   if (compression == PackCompression::Deflate) {
+      std::vector<u8> compressed(compressBound(static_cast<uLong>(data.size())));
+      auto compressedSize = static_cast<uLongf>(compressed.size());
+      if (compress2(compressed.data(), &compressedSize, data.data(), static_cast<uLong>(data.size()), Z_BEST_COMPRESSION) == Z_OK &&
+          compressedSize < data.size()) {
+         compressed.resize(compressedSize);
+         entry.data = std::move(compressed);
+         entry.compression = PackCompression::Deflate;
+      }
+   }
+   if (entry.compression == PackCompression::None) {
+      entry.data.assign(data.begin(), data.end());
+   }
+
+   // Adding a name again replaces its entry.
+   if (const auto it = std::ranges::find(m_entries, name, &Entry::name); it != m_entries.end()) {
+      *it = std::move(entry);
+   } else {
+      m_entries.emplace_back(std::move(entry));
+   }
+}
+
+std::vector<u8> PackWriter::write() const
+{
+   std::vector<const Entry*> entries;
+   entries.reserve(m_entries.size());
+   for (const auto& entry : m_entries) {
+      entries.emplace_back(&entry);
+   }
+   std::ranges::sort(entries, [](const Entry* lhs, const Entry* rhs) { return lhs->name < rhs->name; });
+
+   const auto entryCount = static_cast<u32>(entries.size());
+   std::vector<u8> result(g_headerSize + entryCount * g_indexEntrySize);
+   write_value<u32>(result, 0, g_packMagic);
+   write_value<u32>(result, 4, g_packVersion);
+   write_value<u32>(result, 8, entryCount);
+   write_value<u32>(result, 12, 0);
+
+   for (u32 index = 0; index < entryCount; ++index) {
+      const auto& source = entries[index]->source;
+      const auto offset = g_headerSize + index * g_indexEntrySize;
+      write_value<u32>(result, offset + 40, static_cast<u32>(result.size()));
+      write_value<u32>(result, offset + 44, static_cast<u32>(source.size()));
+      result.insert(result.end(), source.begin(), source.end());
+   }
+
+   for (u32 index = 0; index < entryCount; ++index) {
+      const auto& entry = *entries[index];
+      result.resize((result.size() + g_packPayloadAlignment - 1) / g_packPayloadAlignment * g_packPayloadAlignment);
+
+      const auto offset = g_headerSize + index * g_indexEntrySize;
+      write_value<u64>(result, offset, entry.name.name());
+      write_value<u32>(result, offset + 8, static_cast<u32>(entry.name.type()));
+      write_value<u32>(result, offset + 12, static_cast<u32>(entry.compression));
+      write_value<u64>(result, offset + 16, result.size());
+      write_value<u64>(result, offset + 24, entry.data.size());
+      write_value<u64>(result, offset + 32, entry.size);
+
+      result.insert(result.end(), entry.data.begin(), entry.data.end());
+   }
+
+   return result;
+}
+
+}// namespace triglav::resource
@@ -0,0 +1,59 @@
+#include "ParticleEmitterLoader.h"
+#include "LoadTelemetry.h"
+
+#include <ryml.hpp>
+#include <string>
+
+namespace triglav::resource {
+
+namespace {
+
+float parse_float(const ryml::ConstNodeRef node, const c4::csubstr key, const float defaultValue)
+{
+   if (not node.has_child(key))
+      return defaultValue;
+
+   auto value = node[key].val();
+   return std::stof(std::string{value.data(), value.size()});
+}
+
+glm::vec3 parse_vector3(const ryml::ConstNodeRef node, const c4::csubstr key)
+{
+   if (not node.has_child(key))
+      return glm::vec3{};
+
+   const auto vector = node[key];
+   return glm::vec3{
+      parse_float(vector, "x", 0.0f),
+      parse_float(vector, "y", 0.0f),
+      parse_float(vector, "z", 0.0f),
+   };
+}
+
+}// namespace
+
+render_core::ParticleEmitter Loader<ResourceType::ParticleEmitter>::load(const AssetFile& file)
+{
+   const auto data = file.read();
+   assert(not data.empty());
+
+   const LoadPhaseScope phaseScope{LoadPhase::Decode};
+   auto tree =
+      ryml::parse_in_arena(c4::csubstr{file.name().data(), file.name().size()}, c4::csubstr{data.text().data(), data.text().size()});
+   const auto root = tree.crootref();
+
+   render_core::ParticleEmitter defaults{};
+   return render_core::ParticleEmitter{
+      .spawnRate = parse_float(root, "spawn_rate", defaults.spawnRate),
+      .lifetime = parse_float(root, "lifetime", defaults.lifetime),
+      .lifetimeRandomness = parse_float(root, "lifetime_randomness", defaults.lifetimeRandomness),
+      .extent = parse_vector3(root, "extent"),
+      .velocity = parse_vector3(root, "velocity"),
+      .velocityRandomness = parse_float(root, "velocity_randomness", defaults.velocityRandomness),
+      .angularVelocity = parse_float(root, "angular_velocity", defaults.angularVelocity),
+      .scale = parse_float(root, "scale", defaults.scale),
+      .gravity = parse_float(root, "gravity", defaults.gravity),
+   };
+}
+
+}// namespace triglav::resource
@@ -60,4 +60,25 @@ io::Path PathManager::build_path()
    return **WA_buildPath;
 }
 
+io::Path PathManager::cache_path()
+{
+   {
+      auto RA_cachePath = m_cachedCachePath.read_access();
+      if (RA_cachePath->has_value()) {
+         return **RA_cachePath;
+      }
+   }
+
+   auto WA_cachePath = m_cachedCachePath.access();
+
+   auto commandLineArg = io::CommandLine::the().arg("cacheDir"_name);
+   if (commandLineArg.has_value()) {
+      WA_cachePath->emplace(io::Path{std::move(*commandLineArg)});
+      return **WA_cachePath;
+   }
+
+   WA_cachePath->emplace(this->build_path().sub("asset_cache"));
+   return **WA_cachePath;
+}
+
 }// namespace triglav::resource
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "ImageDecoder.h"
+
+#include <png.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace triglav::resource {
+
+namespace {
+
+constexpr std::array<u8, 8> g_pngSignature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+struct PngReadContext
+{
+   std::span<const u8> data;
+   MemorySize offset;
+};
+
+void read_png_data(const png_structp png, const png_bytep output, const png_size_t size)
+{
+   auto& context = *static_cast<PngReadContext*>(png_get_io_ptr(png));
+   if (size > context.data.size() - context.offset) {
+      png_error(png, "unexpected end of data");
+   }
+   std::memcpy(output, context.data.data() + context.offset, size);
+   context.offset += size;
+}
+
+void on_png_error(const png_structp png, png_const_charp /*message*/)
+{
+   png_longjmp(png, 1);
+}
+
+void on_png_warning(png_structp /*png*/, png_const_charp /*message*/) {}
+
+// libpng reports errors with longjmp, the objects written here are owned by the caller.
+bool read_png(const png_structp png, const png_infop info, DecodedImage& image, std::vector<png_bytep>& rows)
+{
+   if (setjmp(png_jmpbuf(png)))
+      return false;
+
+   png_read_info(png, info);
+
+   // The transformations match the RGBA output of stb_image.
+   const auto colorType = png_get_color_type(png, info);
+   const auto bitDepth = png_get_bit_depth(png, info);
+   if (colorType == PNG_COLOR_TYPE_PALETTE) {
+      png_set_palette_to_rgb(png);
+   }
+   if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
+      png_set_expand_gray_1_2_4_to_8(png);
+   }
+   if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+      png_set_tRNS_to_alpha(png);
+   }
+   if (bitDepth == 16) {
+      png_set_strip_16(png);
+   }
+   if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+      png_set_gray_to_rgb(png);
+   }
+   png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+   png_set_interlace_handling(png);
+   png_read_update_info(png, info);
+
+   image.width = png_get_image_width(png, info);
+   image.height = png_get_image_height(png, info);
+   image.pixels.resize(4 * static_cast<MemorySize>(image.width) * image.height);
+
+   rows.resize(image.height);
+   for (u32 row = 0; row < image.height; ++row) {
+      rows[row] = image.pixels.data() + 4 * static_cast<MemorySize>(image.width) * row;
+   }
+
+   png_read_image(png, rows.data());
+   png_read_end(png, nullptr);
+
+   return true;
+}
+
+}// namespace
+
+std::string_view PngImageDecoder::name() const
+{
+   return "libpng";
+}
+
+bool PngImageDecoder::can_decode(const std::span<const u8> data) const
+{
+   return data.size() >= g_pngSignature.size() && std::equal(g_pngSignature.begin(), g_pngSignature.end(), data.begin());
+}
+
+std::optional<DecodedImage> PngImageDecoder::decode(const std::span<const u8> data) const
+{
+   auto png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, on_png_error, on_png_warning);
+   if (png == nullptr)
+      return std::nullopt;
+
+   auto info = png_create_info_struct(png);
+   if (info == nullptr) {
+      png_destroy_read_struct(&png, nullptr, nullptr);
+      return std::nullopt;
+   }
+
+   // Like stb_image, checksums and ancillary chunk errors don't reject the image.
+   png_set_crc_action(png, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+   png_set_benign_errors(png, 1);
+
+   PngReadContext context{data, 0};
+   png_set_read_fn(png, &context, read_png_data);
+
+   DecodedImage result;
+   std::vector<png_bytep> rows;
+   const auto isSuccess = read_png(png, info, result, rows);
+   png_destroy_read_struct(&png, &info, nullptr);
+
+   if (not isSuccess)
+      return std::nullopt;
+
+   return result;
+}
+
+}// namespace triglav::resource
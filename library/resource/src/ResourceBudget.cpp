@@ -0,0 +1,203 @@
+#include "ResourceBudget.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace triglav::resource {
+
+ResourceBudget::ResourceBudget()
+{
+   m_budget.fill(unlimited_budget);
+}
+
+void ResourceBudget::acquire(const ResourceName name)
+{
+   std::unique_lock lk{m_mutex};
+   auto& entry = m_entries[name];
+   ++entry.referenceCount;
+   entry.lastUsed = ++m_useCounter;
+}
+
+void ResourceBudget::release(const ResourceName name)
+{
+   std::unique_lock lk{m_mutex};
+   this->release_internal(name);
+}
+
+void ResourceBudget::add_dependencies(const ResourceName name, const std::span<const ResourceName> dependencies)
+{
+   std::unique_lock lk{m_mutex};
+   for (const auto dependency : dependencies) {
+      if (dependency == name)
+         continue;
+
+      auto& dependencyEntry = m_entries[dependency];
+      ++dependencyEntry.referenceCount;
+      dependencyEntry.lastUsed = ++m_useCounter;
+      m_entries[name].dependencies.emplace_back(dependency);
+   }
+}
+
+void ResourceBudget::set_references(const ResourceName name, const std::span<const ResourceName> references)
+{
+   std::unique_lock lk{m_mutex};
+
+   // The new references are taken before the previous ones are released, so the assets kept by a reload aren't evicted.
+   std::vector<ResourceName> acquired;
+   acquired.reserve(references.size());
+   for (const auto reference : references) {
+      if (reference == name)
+         continue;
+
+      auto& referenceEntry = m_entries[reference];
+      ++referenceEntry.referenceCount;
+      referenceEntry.lastUsed = ++m_useCounter;
+      acquired.emplace_back(reference);
+   }
+
+   const auto previous = std::exchange(m_entries[name].references, std::move(acquired));
+   for (const auto reference : previous) {
+      this->release_internal(reference);
+   }
+}
+
+void ResourceBudget::add_resource(const ResourceName name, const MemorySize size)
+{
+   std::unique_lock lk{m_mutex};
+   auto& entry = m_entries[name];
+   if (entry.isLoaded)
+      return;
+
+   entry.isLoaded = true;
+   entry.size = size;
+   entry.lastUsed = ++m_useCounter;
+   m_usedSize[type_index(name.type())] += size;
+}
+
+void ResourceBudget::resize_resource(const ResourceName name, const MemorySize size)
+{
+   std::unique_lock lk{m_mutex};
+   const auto it = m_entries.find(name);
+   if (it == m_entries.end() || not it->second.isLoaded)
+      return;
+
+   auto& usedSize = m_usedSize[type_index(name.type())];
+   usedSize = usedSize - it->second.size + size;
+   it->second.size = size;
+}
+
+void ResourceBudget::mark_used(const ResourceName name)
+{
+   std::unique_lock lk{m_mutex};
+   if (const auto it = m_entries.find(name); it != m_entries.end()) {
+      it->second.lastUsed = ++m_useCounter;
+   }
+}
+
+void ResourceBudget::mark_used(const std::span<const ResourceName> names)
+{
+   std::unique_lock lk{m_mutex};
+   for (const auto name : names) {
+      if (const auto it = m_entries.find(name); it != m_entries.end()) {
+         it->second.lastUsed = ++m_useCounter;
+      }
+   }
+}
+
+void ResourceBudget::set_budget(const ResourceType type, const MemorySize budget)
+{
+   std::unique_lock lk{m_mutex};
+   m_budget[type_index(type)] = budget;
+}
+
+std::vector<ResourceName> ResourceBudget::collect_evictions()
+{
+   std::unique_lock lk{m_mutex};
+
+   std::vector<ResourceName> result;
+
+   // Evicting a resource releases its dependencies, which may then be evicted as well.
+   bool hasEvicted = true;
+   while (hasEvicted) {
+      hasEvicted = false;
+
+      std::vector<std::pair<u64, ResourceName>> candidates;
+      for (const auto& [name, entry] : m_entries) {
+         if (entry.isLoaded && entry.referenceCount == 0) {
+            candidates.emplace_back(entry.lastUsed, name);
+         }
+      }
+      std::ranges::sort(candidates);
+
+      for (const auto& [lastUsed, name] : candidates) {
+         const auto typeIndex = type_index(name.type());
+         if (m_budget[typeIndex] != 0 && m_usedSize[typeIndex] <= m_budget[typeIndex])
+            continue;
+
+         auto node = m_entries.extract(name);
+         m_usedSize[typeIndex] -= node.mapped().size;
+         for (const auto dependency : node.mapped().dependencies) {
+            this->release_internal(dependency);
+         }
+         for (const auto reference : node.mapped().references) {
+            this->release_internal(reference);
+         }
+
+         result.emplace_back(name);
+         hasEvicted = true;
+      }
+   }
+
+   return result;
+}
+
+bool ResourceBudget::is_loaded(const ResourceName name) const
+{
+   std::unique_lock lk{m_mutex};
+   const auto it = m_entries.find(name);
+   return it != m_entries.end() && it->second.isLoaded;
+}
+
+u32 ResourceBudget::reference_count(const ResourceName name) const
+{
+   std::unique_lock lk{m_mutex};
+   const auto it = m_entries.find(name);
+   return it != m_entries.end() ? it->second.referenceCount : 0;
+}
+
+MemorySize ResourceBudget::used_size(const ResourceType type) const
+{
+   std::unique_lock lk{m_mutex};
+   return m_usedSize[type_index(type)];
+}
+
+MemorySize ResourceBudget::budget(const ResourceType type) const
+{
+   std::unique_lock lk{m_mutex};
+   return m_budget[type_index(type)];
+}
+
+void ResourceBudget::release_internal(const ResourceName name)
+{
+   const auto it = m_entries.find(name);
+   assert(it != m_entries.end() && it->second.referenceCount > 0);
+   if (it == m_entries.end() || it->second.referenceCount == 0)
+      return;
+
+   --it->second.referenceCount;
+   it->second.lastUsed = ++m_useCounter;
+
+   // Released before it was loaded, nothing to keep track of.
+   if (it->second.referenceCount == 0 && not it->second.isLoaded && it->second.dependencies.empty() && it->second.references.empty()) {
+      m_entries.erase(it);
+   }
+}
+
+int ResourceBudget::type_index(const ResourceType type)
+{
+   assert(type != ResourceType::Unknown);
+   return static_cast<int>(type);
+}
+
+}// namespace triglav::resource
@@ -1,131 +1,318 @@
 #include "ResourceManager.h"
 
+#include "AssetCache.h"
 #include "LevelLoader.h"
+#include "LoadTelemetry.h"
 #include "MaterialLoader.h"
 #include "ModelLoader.h"
+#include "ParticleEmitterLoader.h"
 #include "PathManager.h"
 #include "ShaderLoader.h"
 #include "TextureLoader.h"
+#include "TextureStreamer.h"
 #include "TypefaceLoader.h"
 
 #include "triglav/TypeMacroList.hpp"
-#include "triglav/io/File.h"
+#include "triglav/graphics_api/MipMapGenerator.h"
+#include "triglav/io/CommandLine.h"
+#include "triglav/io/FileWatcher.h"
+#include "triglav/ktx/Texture.h"
 #include "triglav/threading/ThreadPool.h"
 
-#include <ryml.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <format>
+#include <fstream>
 #include <map>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace triglav::resource {
 
-namespace {
-
-std::vector<ResourceStage> parse_asset_list(const io::Path& path)
-{
-   std::vector<ResourceStage> result{};
-   result.resize(loading_stage_count());
+using namespace name_literals;
 
-   auto file = io::read_whole_file(path);
-   auto tree =
-      ryml::parse_in_place(c4::substr{const_cast<char*>(path.string().data()), path.string().size()}, c4::substr{file.data(), file.size()});
-   auto resources = tree["resources"];
+namespace {
 
-   for (const auto node : resources) {
-      auto name = node["name"].val();
-      auto source = node["source"].val();
+// Render graph frames that may be in flight, a retired resource is kept alive until all of them finished.
+constexpr u64 g_retiredFrameCount = 3;
 
-      ResourceProperties properties;
+// Memory the unreferenced textures and models may keep occupying unless set_memory_budget is called, the other types are
+// small and kept without a limit.
+constexpr MemorySize g_defaultTextureBudget = 512 * 1024 * 1024;
+constexpr MemorySize g_defaultModelBudget = 128 * 1024 * 1024;
 
-      if (node.has_child("properties")) {
-         auto propertiesNode = node["properties"];
-         for (const auto property : propertiesNode) {
-            auto key = property.key();
-            auto value = property.val();
-            properties.add(make_name_id({key.data(), key.size()}), std::string{value.data(), value.size()});
-         }
-      }
+// The asset_pack tool writes the archive of an asset list next to the build outputs, named after the list.
+io::Path pack_archive_path(const io::Path& assetListPath)
+{
+   std::string_view fileName{assetListPath.string()};
+   if (const auto separator = fileName.find_last_of("/\\"); separator != std::string_view::npos) {
+      fileName.remove_prefix(separator + 1);
+   }
+   return PathManager::the().build_path().sub(std::format("{}.pack", fileName.substr(0, fileName.rfind('.'))));
+}
 
-      auto resourceName = make_rc_name(std::string{name.data(), name.size()});
-      result[resourceName.loading_stage()].resourceList.emplace_back(std::string{name.data(), name.size()},
-                                                                     std::string{source.data(), source.size()}, std::move(properties));
+template<ResourceType CResourceType>
+std::vector<ResourceName> collect_dependencies(const AssetFile& file, const ResourceProperties& props)
+{
+   if constexpr (HasDependencies<CResourceType>) {
+      return Loader<CResourceType>::collect_dependencies(file, props);
+   } else {
+      return {};
    }
+}
 
-   return result;
+std::vector<ResourceName> collect_dependencies(const ResourceName assetName, const AssetFile& file, const ResourceProperties& props)
+{
+   switch (assetName.type()) {
+#define TG_RESOURCE_TYPE(name, extension, cppType)                  \
+   case ResourceType::name:                                         \
+      return collect_dependencies<ResourceType::name>(file, props);
+      TG_RESOURCE_TYPE_LIST
+#undef TG_RESOURCE_TYPE
+   case ResourceType::Unknown:
+      break;
+   }
+   return {};
 }
 
 }// namespace
 
 ResourceManager::ResourceManager(graphics_api::Device& device, font::FontManger& fontManager) :
     m_device(device),
-    m_fontManager(fontManager)
+    m_fontManager(fontManager),
+    m_retireQueue(g_retiredFrameCount)
 {
-#define TG_RESOURCE_TYPE(name, extension, cppType, stage) \
-   m_containers.emplace(ResourceType::name, std::make_unique<Container<ResourceType::name>>());
+#define TG_RESOURCE_TYPE(name, extension, cppType)                                                         \
+   m_containers[static_cast<int>(ResourceType::name)] = std::make_unique<Container<ResourceType::name>>();
    TG_RESOURCE_TYPE_LIST
 #undef TG_RESOURCE_TYPE
+
+   m_budget.set_budget(ResourceType::Texture, g_defaultTextureBudget);
+   m_budget.set_budget(ResourceType::Model, g_defaultModelBudget);
 }
 
+ResourceManager::~ResourceManager() = default;
+
 void ResourceManager::load_asset_list(const io::Path& path)
 {
    if (m_loadContext != nullptr) {
       spdlog::error("Loading assets already in progress");
       return;
    }
+   if (m_assetLists.contains(path.string())) {
+      spdlog::error("Asset list {} is already loaded", path.string());
+      return;
+   }
+   if (not io::CommandLine::the().is_enabled("looseAssets"_name)) {
+      this->mount_pack_archive(pack_archive_path(path));
+   }
+
    m_loadContext = LoadContext::from_asset_list(path);
+   m_cacheStatsAtLoadStart = AssetCache::the().stats();
+   m_looseFileOpensAtLoadStart = AssetFile::loose_file_open_count();
+   m_pathProbeCount = 0;
+   m_loadStartTime = LoadTelemetry::Clock::now();
 
    spdlog::info("Loading {} assets", m_loadContext->total_assets());
-   this->load_next_stage();
+
+   const auto assetNames = m_loadContext->asset_names();
+   for (const auto name : assetNames) {
+      m_nameRegistry.register_resource(name, m_loadContext->resource(name).name);
+      m_budget.acquire(name);
+   }
+   m_assetLists.emplace(path.string(), assetNames);
+
+   // Each asset is scheduled as soon as the assets its loader reads are loaded.
+   for (const auto name : assetNames) {
+      this->schedule(LoadTask{name, LoadStep::Prepare});
+   }
 }
 
-void ResourceManager::load_next_stage()
+void ResourceManager::unload_asset_list(const io::Path& path)
 {
-   if (m_loadContext == nullptr) {
-      spdlog::error("Cannot load stage: no asset loading in progress");
+   const auto node = m_assetLists.extract(path.string());
+   if (node.empty()) {
+      spdlog::error("Cannot unload asset list {}: not loaded", path.string());
       return;
    }
 
-   auto& stage = m_loadContext->next_stage();
+   for (const auto name : node.mapped()) {
+      m_budget.release(name);
+   }
+   this->evict_resources();
+}
+
+void ResourceManager::acquire(const ResourceName name)
+{
+   m_budget.acquire(name);
+}
+
+void ResourceManager::release(const ResourceName name)
+{
+   m_budget.release(name);
+}
+
+void ResourceManager::set_memory_budget(const ResourceType type, const MemorySize budget)
+{
+   m_budget.set_budget(type, budget);
+}
+
+MemorySize ResourceManager::memory_usage(const ResourceType type) const
+{
+   return m_budget.used_size(type);
+}
 
-   spdlog::info("Loading {} assets in stage {}", stage.resourceList.size(), m_loadContext->current_stage_id());
+bool ResourceManager::mount_pack_archive(const io::Path& path)
+{
+   // Loading assets reads the mounted archives without a lock.
+   if (m_loadContext != nullptr) {
+      spdlog::error("Cannot mount pack archive {} while loading assets", path.string());
+      return false;
+   }
+   if (std::ranges::find(m_packArchivePaths, path.string()) != m_packArchivePaths.end())
+      return true;
 
-   auto buildPath = PathManager::the().build_path();
-   auto contentPath = PathManager::the().content_path();
+   auto archive = PackArchive::open(path);
+   if (not archive.has_value())
+      return false;
 
-   for (const auto& [nameStr, source, props] : stage.resourceList) {
-      auto resourcePath = buildPath.sub(source);
-      if (not resourcePath.exists()) {
-         resourcePath = contentPath.sub(source);
+   spdlog::info("Mounted pack archive {} with {} assets", path.string(), archive->entry_count());
+   m_packArchives.emplace_back(std::move(*archive));
+   m_packArchivePaths.emplace_back(path.string());
+   return true;
+}
 
-         if (not resourcePath.exists()) {
-            spdlog::error("failed to load resource: {}, file not found", source);
-            continue;
+RetireQueue& ResourceManager::retire_queue()
+{
+   return m_retireQueue;
+}
+
+void ResourceManager::evict_resources()
+{
+   for (const auto resourceName : m_budget.collect_evictions()) {
+      spdlog::info("Unloading {}", m_nameRegistry.lookup_resource_name(resourceName).value_or("UNKNOWN"));
+
+      switch (resourceName.type()) {
+#define TG_RESOURCE_TYPE(name, extension, cppType)             \
+   case ResourceType::name:                                    \
+      this->unload_resource<ResourceType::name>(resourceName); \
+      break;
+         TG_RESOURCE_TYPE_LIST
+#undef TG_RESOURCE_TYPE
+      case ResourceType::Unknown:
+         break;
+      }
+   }
+}
+
+void ResourceManager::schedule(const LoadTask task)
+{
+   // The job runs whichever task has the highest priority once a worker is free, not necessarily this one.
+   m_loadContext->enqueue(task);
+   threading::ThreadPool::the().issue_job([this] { this->run_load_task(); });
+}
+
+void ResourceManager::run_load_task()
+{
+   const auto task = m_loadContext->next_task();
+   assert(task.has_value());
+
+   switch (task->step) {
+   case LoadStep::Prepare:
+      this->prepare_asset(task->name);
+      break;
+   case LoadStep::Load:
+      this->load_asset(task->name, m_loadContext->file(task->name), m_loadContext->resource(task->name).properties);
+      break;
+   }
+}
+
+void ResourceManager::prepare_asset(const ResourceName assetName)
+{
+   const auto& [nameStr, source, props] = m_loadContext->resource(assetName);
+   const LoadAssetScope assetScope{assetName};
+
+   // Loaded by another asset list, this list only holds a reference to it.
+   if (this->is_name_registered(assetName)) {
+      this->finish_loading_asset(assetName);
+      return;
+   }
+
+   const auto file = this->resolve_asset_file(assetName, source);
+   if (not file.has_value()) {
+      spdlog::error("failed to load resource: {}, file not found", source);
+      this->finish_loading_asset(assetName);
+      return;
+   }
+
+   const auto dependencies = collect_dependencies(assetName, *file, props);
+   m_budget.add_dependencies(assetName, dependencies);
+   if (m_assetWatcher != nullptr) {
+      m_assetWatcher->add_asset(assetName, file->path(), dependencies);
+      std::unique_lock lk{m_reloadMutex};
+      m_reloadPaths.insert_or_assign(assetName, m_loadContext->resource(assetName));
+   }
+   if (m_loadContext->set_dependencies(assetName, *file, dependencies)) {
+      this->load_asset(assetName, *file, props);
+   }
+}
+
+std::optional<AssetFile> ResourceManager::resolve_asset_file(const ResourceName name, const std::string_view source)
+{
+   // Fonts are read by FreeType from their files while glyphs are rendered, they are never packed.
+   if (name.type() != ResourceType::Typeface) {
+      for (const auto& archive : m_packArchives) {
+         if (const auto entry = archive.find(name); entry.has_value()) {
+            return AssetFile{*entry};
          }
       }
+   }
+
+   const auto buildPath = PathManager::the().build_path();
 
-      auto name = make_rc_name(nameStr);
-      m_nameRegistry.register_resource(name, nameStr);
-      threading::ThreadPool::the().issue_job([this, name, resourcePath, props] { this->load_asset(name, resourcePath, props); });
+   if (name.type() == ResourceType::Texture) {
+      // Textures cooked by the texture_cook tool take precedence over the source images.
+      ++m_pathProbeCount;
+      if (auto cookedPath = buildPath.sub(ktx::cooked_texture_path(source)); cookedPath.exists()) {
+         return AssetFile{std::move(cookedPath)};
+      }
+   }
+   ++m_pathProbeCount;
+   if (auto resourcePath = buildPath.sub(source); resourcePath.exists()) {
+      return AssetFile{std::move(resourcePath)};
+   }
+   ++m_pathProbeCount;
+   if (auto resourcePath = PathManager::the().content_path().sub(source); resourcePath.exists()) {
+      return AssetFile{std::move(resourcePath)};
    }
+   return std::nullopt;
 }
 
-void ResourceManager::load_asset(const ResourceName assetName, const io::Path& path, const ResourceProperties& props)
+void ResourceManager::load_asset(const ResourceName assetName, const AssetFile& file, const ResourceProperties& props)
 {
    spdlog::info("[THREAD: {}] Loading asset {}", threading::this_thread_id(),
                 m_nameRegistry.lookup_resource_name(assetName).value_or("UNKNOWN"));
 
    this->OnStartedLoadingAsset.publish(assetName);
 
-   switch (assetName.type()) {
-#define TG_RESOURCE_TYPE(name, extension, cppType, stage)              \
+   {
+      const LoadAssetScope assetScope{assetName};
+      switch (assetName.type()) {
+#define TG_RESOURCE_TYPE(name, extension, cppType)                     \
    case ResourceType::name:                                            \
-      this->load_resource<ResourceType::name>(assetName, path, props); \
+      this->load_resource<ResourceType::name>(assetName, file, props); \
+      this->track_resource<ResourceType::name>(assetName);             \
+      this->promote_references<ResourceType::name>(assetName);         \
       break;
-      TG_RESOURCE_TYPE_LIST
+         TG_RESOURCE_TYPE_LIST
 #undef TG_RESOURCE_TYPE
-   case ResourceType::Unknown:
-      break;
+      case ResourceType::Unknown:
+         break;
+      }
    }
 
    this->on_resource_is_loaded(assetName);
@@ -133,38 +320,103 @@ void ResourceManager::load_asset(const ResourceName assetName, const io::Path& p
 
 bool ResourceManager::is_name_registered(const ResourceName assetName) const
 {
-   if (not m_containers.contains(assetName.type()))
+   if (assetName.type() == ResourceType::Unknown)
       return false;
 
-   auto& container = m_containers.at(assetName.type());
-   return container->is_name_registered(assetName);
+   return m_containers[static_cast<int>(assetName.type())]->is_name_registered(assetName);
 }
 
 void ResourceManager::on_resource_is_loaded(ResourceName resourceName)
 {
    if (m_loadContext == nullptr) {
-      spdlog::error("Cannot load stage: no asset loading in progress");
+      spdlog::error("Cannot finish loading asset: no asset loading in progress");
       return;
    }
 
    spdlog::info("[THREAD: {}] [{}/{}] Successfully loaded {}", threading::this_thread_id(), m_loadContext->total_loaded_assets(),
                 m_loadContext->total_assets(), m_nameRegistry.lookup_resource_name(resourceName).value_or("UNKNOWN"));
    this->OnFinishedLoadingAsset.publish(resourceName, m_loadContext->total_loaded_assets(), m_loadContext->total_assets());
+   {
+      std::unique_lock lk{m_addedAssetsMutex};
+      m_addedAssets.emplace_back(resourceName);
+   }
 
-   const auto result = m_loadContext->finish_loading_asset();
+   this->finish_loading_asset(resourceName);
+}
 
-   switch (result) {
-   case FinishLoadingAssetResult::FinishedStage:
-      spdlog::info("Loading stage {} DONE", m_loadContext->current_stage_id());
-      this->load_next_stage();
-      break;
-   case FinishLoadingAssetResult::FinishedLoadingAssets:
+void ResourceManager::finish_loading_asset(const ResourceName resourceName)
+{
+   std::vector<ResourceName> readyAssets;
+   const auto result = m_loadContext->finish_loading_asset(resourceName, readyAssets);
+
+   const auto now = LoadTelemetry::Clock::now();
+   for (const auto name : readyAssets) {
+      LoadTelemetry::the().record(name, LoadPhase::DependencyWait, m_loadContext->prepared_time(name), now);
+      this->schedule(LoadTask{name, LoadStep::Load});
+   }
+
+   if (result == FinishLoadingAssetResult::FinishedLoadingRequiredAssets) {
+      const std::chrono::duration<double, std::milli> loadTime = m_loadContext->elapsed_time();
+      spdlog::info("Required assets loaded in {:.1f} ms, {} of {} assets loaded", loadTime.count(), m_loadContext->total_loaded_assets(),
+                   m_loadContext->total_assets());
+      this->OnLoadedRequiredAssets.publish();
+   }
+
+   if (result == FinishLoadingAssetResult::FinishedLoadingAssets) {
       spdlog::info("Loading assets DONE");
+      spdlog::info("Texture memory: {:.1f} MiB, {:.1f} MiB saved by channel aware and compressed formats",
+                   static_cast<double>(m_textureMemory) / (1024.0 * 1024.0), static_cast<double>(m_textureMemorySaved) / (1024.0 * 1024.0));
+      spdlog::info("Loading critical path: {}", m_loadContext->critical_path());
+      this->report_load_time();
+      this->report_load_phases();
       m_loadContext.reset();
+
+      threading::ThreadPool::the().issue_job([] { AssetCache::the().collect_garbage(); });
       this->OnLoadedAssets.publish();
-      break;
-   case FinishLoadingAssetResult::None:
-      break;
+   }
+}
+
+void ResourceManager::report_load_time() const
+{
+   const auto stats = AssetCache::the().stats();
+   const auto hitCount = stats.hitCount - m_cacheStatsAtLoadStart.hitCount;
+   const auto missCount = stats.missCount - m_cacheStatsAtLoadStart.missCount;
+
+   // Cold and warm starts are told apart by the assets the cache had, the times are only comparable within the same kind.
+   std::string_view startKind{"uncached"};
+   if (hitCount > 0 && missCount == 0) {
+      startKind = "warm";
+   } else if (hitCount == 0 && missCount > 0) {
+      startKind = "cold";
+   } else if (hitCount > 0) {
+      startKind = "partially warm";
+   }
+
+   const std::chrono::duration<double, std::milli> loadTime = m_loadContext->elapsed_time();
+   spdlog::info("Loading time ({} start): {:.1f} ms, {} of {} cooked assets read from the asset cache", startKind, loadTime.count(),
+                hitCount, hitCount + missCount);
+   spdlog::info("Loose asset files: {} opened, {} paths probed", AssetFile::loose_file_open_count() - m_looseFileOpensAtLoadStart,
+                m_pathProbeCount.load());
+}
+
+void ResourceManager::report_load_phases() const
+{
+   const auto& telemetry = LoadTelemetry::the();
+   spdlog::info("Loading phases by type:\n{}", telemetry.summary(m_loadStartTime));
+
+   const auto tracePath = io::CommandLine::the().arg("loadTrace"_name);
+   if (not tracePath.has_value())
+      return;
+
+   const auto trace = telemetry.chrome_trace(m_loadStartTime, [this](const ResourceName name) {
+      return m_nameRegistry.lookup_resource_name(name).value_or("UNKNOWN");
+   });
+   std::ofstream file(*tracePath, std::ios::trunc);
+   file << trace;
+   if (file.good()) {
+      spdlog::info("Loading trace written to {}", *tracePath);
+   } else {
+      spdlog::error("Failed to write loading trace to {}", *tracePath);
    }
 }
 
@@ -173,4 +425,181 @@ std::optional<std::string> ResourceManager::lookup_name(ResourceName resourceNam
    return m_nameRegistry.lookup_resource_name(resourceName);
 }
 
+graphics_api::MipMapGenerator& ResourceManager::mip_map_generator()
+{
+   std::call_once(m_mipMapGeneratorFlag, [this] {
+      m_mipMapGenerator = std::make_unique<graphics_api::MipMapGenerator>(m_device, this->get("mip_downsample.cshader"_rc));
+   });
+   return *m_mipMapGenerator;
+}
+
+void ResourceManager::report_texture_memory(const MemorySize textureSize, const MemorySize rgbaSize)
+{
+   m_textureMemory += textureSize;
+   m_textureMemorySaved += rgbaSize > textureSize ? rgbaSize - textureSize : 0;
+}
+
+MemorySize ResourceManager::texture_memory() const
+{
+   return m_textureMemory;
+}
+
+void ResourceManager::enable_texture_streaming(const TextureResidencySettings& settings)
+{
+   m_textureStreamer = std::make_unique<TextureStreamer>(*this, m_device, settings);
+}
+
+TextureStreamer* ResourceManager::texture_streamer() const
+{
+   return m_textureStreamer.get();
+}
+
+void ResourceManager::begin_frame()
+{
+   m_retireQueue.advance_frame();
+
+   if (m_textureStreamer != nullptr) {
+      m_textureStreamer->update(this->container<ResourceType::Texture>());
+   }
+
+   if (m_assetWatcher != nullptr) {
+      this->update_hot_reload();
+   }
+
+   std::vector<ResourceName> addedAssets;
+   {
+      std::unique_lock lk{m_addedAssetsMutex};
+      std::swap(addedAssets, m_addedAssets);
+   }
+   if (not addedAssets.empty()) {
+      this->OnAddedAssets.publish(std::span<const ResourceName>{addedAssets});
+   }
+
+   // The resources drawn in the previous frame become the most recently used ones, each is marked once.
+   m_usedResources.clear();
+   for (const auto& container : m_containers) {
+      container->collect_used_resources(m_frameIndex, m_usedResources);
+   }
+   m_budget.mark_used(m_usedResources);
+   ++m_frameIndex;
+
+   this->evict_resources();
+}
+
+bool ResourceManager::enable_hot_reload()
+{
+   auto fileWatcher = io::create_file_watcher();
+   if (not fileWatcher.has_value()) {
+      spdlog::error("Hot reload is not supported on this platform");
+      return false;
+   }
+
+   m_assetWatcher = std::make_unique<AssetWatcher>(std::move(*fileWatcher));
+   return true;
+}
+
+void ResourceManager::update_hot_reload()
+{
+   // Loading an asset list reads resources the reload could replace.
+   if (m_loadContext != nullptr || m_pendingReloadCount.load() != 0)
+      return;
+
+   std::vector<std::unique_ptr<IReloadedResource>> reloadedResources;
+   {
+      std::unique_lock lk{m_reloadMutex};
+      std::swap(reloadedResources, m_reloadedResources);
+   }
+   std::vector<ResourceName> replacedNames;
+   for (const auto& resource : reloadedResources) {
+      if (const auto name = resource->replace(*this); name.has_value()) {
+         replacedNames.emplace_back(*name);
+      }
+   }
+   if (not replacedNames.empty()) {
+      // The wave is published as a whole, so dependents rebuilt by the listeners see all of their new dependencies.
+      this->OnReloadedAssets.publish(std::span<const ResourceName>{replacedNames});
+   }
+
+   if (m_reloadWaves.empty()) {
+      if (not m_reloadingAssets.empty()) {
+         const std::chrono::duration<double, std::milli> reloadTime = LoadTelemetry::Clock::now() - m_reloadStartTime;
+         spdlog::info("Reloaded changed assets in {:.1f} ms", reloadTime.count());
+         m_reloadingAssets.clear();
+      }
+
+      m_reloadWaves = m_assetWatcher->poll_changes();
+      if (m_reloadWaves.empty())
+         return;
+
+      m_reloadStartTime = LoadTelemetry::Clock::now();
+      std::string invalidatedNames;
+      for (const auto& wave : m_reloadWaves) {
+         for (const auto name : wave) {
+            invalidatedNames += std::format(" {}", m_nameRegistry.lookup_resource_name(name).value_or("UNKNOWN"));
+         }
+      }
+      spdlog::info("Reloading changed assets in {} waves:{}", m_reloadWaves.size(), invalidatedNames);
+   }
+
+   m_reloadingAssets = std::move(m_reloadWaves.front());
+   m_reloadWaves.erase(m_reloadWaves.begin());
+
+   m_pendingReloadCount = static_cast<u32>(m_reloadingAssets.size());
+   for (const auto name : m_reloadingAssets) {
+      threading::ThreadPool::the().issue_job([this, name] { this->reload_asset(name); });
+   }
+}
+
+void ResourceManager::reload_asset(const ResourceName assetName)
+{
+   const LoadAssetScope assetScope{assetName};
+
+   std::optional<ResourcePath> resourcePath;
+   {
+      std::unique_lock lk{m_reloadMutex};
+      if (const auto it = m_reloadPaths.find(assetName); it != m_reloadPaths.end()) {
+         resourcePath.emplace(it->second);
+      }
+   }
+
+   std::optional<AssetFile> file;
+   if (resourcePath.has_value()) {
+      file = this->resolve_asset_file(assetName, resourcePath->source);
+   }
+
+   if (file.has_value()) {
+      // The asset may depend on other assets since it was edited.
+      m_assetWatcher->add_asset(assetName, file->path(), collect_dependencies(assetName, *file, resourcePath->properties));
+
+      switch (assetName.type()) {
+#define TG_RESOURCE_TYPE(name, extension, cppType)                                          \
+   case ResourceType::name:                                                                 \
+      this->reload_resource<ResourceType::name>(assetName, *file, resourcePath->properties); \
+      break;
+         TG_RESOURCE_TYPE_LIST
+#undef TG_RESOURCE_TYPE
+      case ResourceType::Unknown:
+         break;
+      }
+   } else {
+      spdlog::error("failed to reload resource: {}, file not found", m_nameRegistry.lookup_resource_name(assetName).value_or("UNKNOWN"));
+   }
+
+   --m_pendingReloadCount;
+}
+
+void ResourceManager::remove_streamed_texture(const TextureName name)
+{
+   m_textureStreamer->remove_texture(name);
+}
+
+bool ResourceManager::load_streamed_texture(const TextureName name, const AssetFile& file, const ResourceProperties& props)
+{
+   if (m_textureStreamer == nullptr || not TextureStreamer::is_streamable(file, props))
+      return false;
+
+   this->container<ResourceType::Texture>().register_resource(name, m_textureStreamer->load_texture(name, file, props));
+   return true;
+}
+
 }// namespace triglav::resource
\ No newline at end of file
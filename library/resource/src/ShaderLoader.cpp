@@ -1,26 +1,32 @@
 #include "ShaderLoader.h"
+#include "LoadTelemetry.h"
 
 #include "triglav/graphics_api/Device.h"
-#include "triglav/io/File.h"
 
 namespace triglav::resource {
 
-graphics_api::Shader Loader<ResourceType::FragmentShader>::load_gpu(graphics_api::Device& device, const io::Path& path,
+graphics_api::Shader Loader<ResourceType::FragmentShader>::load_gpu(graphics_api::Device& device, const AssetFile& file,
                                                                     const ResourceProperties& props)
 {
-   return GAPI_CHECK(device.create_shader(graphics_api::PipelineStage::FragmentShader, "main", io::read_whole_file(path)));
+   const auto data = file.read();
+   const LoadPhaseScope phaseScope{LoadPhase::Upload};
+   return GAPI_CHECK(device.create_shader(graphics_api::PipelineStage::FragmentShader, "main", std::span<const char>{data.text()}));
 }
 
-graphics_api::Shader Loader<ResourceType::VertexShader>::load_gpu(graphics_api::Device& device, const io::Path& path,
+graphics_api::Shader Loader<ResourceType::VertexShader>::load_gpu(graphics_api::Device& device, const AssetFile& file,
                                                                   const ResourceProperties& props)
 {
-   return GAPI_CHECK(device.create_shader(graphics_api::PipelineStage::VertexShader, "main", io::read_whole_file(path)));
+   const auto data = file.read();
+   const LoadPhaseScope phaseScope{LoadPhase::Upload};
+   return GAPI_CHECK(device.create_shader(graphics_api::PipelineStage::VertexShader, "main", std::span<const char>{data.text()}));
 }
 
-graphics_api::Shader Loader<ResourceType::ComputeShader>::load_gpu(graphics_api::Device& device, const io::Path& path,
+graphics_api::Shader Loader<ResourceType::ComputeShader>::load_gpu(graphics_api::Device& device, const AssetFile& file,
                                                                    const ResourceProperties& props)
 {
-   return GAPI_CHECK(device.create_shader(graphics_api::PipelineStage::ComputeShader, "main", io::read_whole_file(path)));
+   const auto data = file.read();
+   const LoadPhaseScope phaseScope{LoadPhase::Upload};
+   return GAPI_CHECK(device.create_shader(graphics_api::PipelineStage::ComputeShader, "main", std::span<const char>{data.text()}));
 }
 
 }// namespace triglav::resource
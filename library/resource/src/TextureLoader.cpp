@@ -1,10 +1,26 @@
 #include "TextureLoader.h"
 
+#include "AssetCache.h"
+#include "ImageDecoder.h"
+#include "LoadTelemetry.h"
+#include "ResourceManager.h"
+
 #include "triglav/graphics_api/Device.h"
+#include "triglav/graphics_api/MipMapGenerator.h"
 #include "triglav/graphics_api/Texture.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include "triglav/ktx/BlockCompression.h"
+#include "triglav/ktx/ChannelLayout.h"
+#include "triglav/ktx/Texture.h"
+
+#include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <format>
+#include <numeric>
+
+using triglav::graphics_api::ColorFormat;
+using triglav::graphics_api::MipFilter;
+using triglav::graphics_api::Resolution;
 using triglav::graphics_api::SampleCount;
 using triglav::graphics_api::TextureUsage;
 
@@ -12,27 +28,361 @@ namespace triglav::resource {
 
 using namespace name_literals;
 
-graphics_api::Texture Loader<ResourceType::Texture>::load_gpu(graphics_api::Device& device, const io::Path& path,
+namespace {
+
+// Bumped whenever the import produces different data from the same source.
+constexpr u32 g_imageImporterVersion = 1;
+
+MipFilter parse_mip_filter(const std::string_view value)
+{
+   if (value == "normal_map")
+      return MipFilter::NormalMap;
+   if (value == "min")
+      return MipFilter::Min;
+   if (value == "max")
+      return MipFilter::Max;
+   return MipFilter::Average;
+}
+
+ColorFormat to_color_format(const ktx::Format format)
+{
+   switch (format) {
+   case ktx::Format::R8_UNorm:
+      return GAPI_FORMAT(R, UNorm8);
+   case ktx::Format::RG8_UNorm:
+      return GAPI_FORMAT(RG, UNorm8);
+   case ktx::Format::RGBA8_UNorm:
+      return GAPI_FORMAT(RGBA, UNorm8);
+   case ktx::Format::RGBA8_sRGB:
+      return GAPI_FORMAT(RGBA, sRGB);
+   case ktx::Format::BC1_RGB_UNorm:
+      return GAPI_FORMAT(BC1, UNorm8);
+   case ktx::Format::BC1_RGB_sRGB:
+      return GAPI_FORMAT(BC1, sRGB);
+   case ktx::Format::BC4_UNorm:
+      return GAPI_FORMAT(BC4, UNorm8);
+   case ktx::Format::BC5_UNorm:
+      return GAPI_FORMAT(BC5, UNorm8);
+   case ktx::Format::BC7_UNorm:
+      return GAPI_FORMAT(BC7, UNorm8);
+   case ktx::Format::BC7_sRGB:
+      return GAPI_FORMAT(BC7, sRGB);
+   case ktx::Format::Undefined:
+      break;
+   }
+   assert(false);
+   return GAPI_FORMAT(RGBA, sRGB);
+}
+
+graphics_api::Texture load_cooked_texture(ResourceManager& manager, graphics_api::Device& device, const AssetFile& file)
+{
+   using TextureLoader = Loader<ResourceType::Texture>;
+
+   // The levels are read from the file, or copied from a mapped archive, straight into the staging memory.
+   if (auto stream = file.open(); stream.has_value()) {
+      LoadPhaseScope phaseScope{LoadPhase::FileRead};
+      if (const auto header = TextureLoader::read_cooked_header(**stream); header.has_value()) {
+         phaseScope.next(LoadPhase::Upload);
+         if (auto texture = TextureLoader::upload_cooked_levels(device, **stream, *header, 0); texture.has_value()) {
+            manager.report_texture_memory(TextureLoader::cooked_levels_size(*header, 0),
+                                          TextureLoader::rgba_texture_size(texture->resolution(), texture->mip_count()));
+            return std::move(*texture);
+         }
+      }
+   }
+
+   const auto data = file.read();
+
+   LoadPhaseScope phaseScope{LoadPhase::Decode};
+   auto cookedTexture = ktx::read_ktx2(data.bytes());
+   assert(cookedTexture.has_value());
+
+   phaseScope.next(LoadPhase::Upload);
+   auto texture = Loader<ResourceType::Texture>::create_cooked_texture(device, *cookedTexture);
+   manager.report_texture_memory(cookedTexture->total_size(),
+                                 Loader<ResourceType::Texture>::rgba_texture_size(texture.resolution(), texture.mip_count()));
+
+   return texture;
+}
+
+// Decoded source image converted to the format it's uploaded in.
+struct CookedImage
+{
+   ktx::Format format{};
+   u32 width{};
+   u32 height{};
+   std::vector<u8> texels;
+};
+
+std::optional<CookedImage> deserialize_image(const std::span<const u8> data, const ktx::Format format)
+{
+   CacheReader reader{data};
+   CookedImage result{.format = format};
+   result.width = reader.read<u32>();
+   result.height = reader.read<u32>();
+   result.texels = reader.read_array<u8>();
+
+   if (not reader.is_complete() || result.texels.size() != ktx::image_size(result.format, result.width, result.height))
+      return std::nullopt;
+   return result;
+}
+
+// Decoding dominates loading source images, the decoded texels are cached. Mips are still generated on the GPU.
+CookedImage cook_image(const AssetFile& file, const ResourceProperties& props, const MipFilter mipFilter)
+{
+   const auto data = file.read();
+   const auto source = data.bytes();
+
+   const auto layout = ktx::resolve_texture_layout(file.name(), props.get_string("channels"_name), props.get_string("color_space"_name),
+                                                   mipFilter == MipFilter::NormalMap);
+   const auto ktxFormat = ktx::uncompressed_format(layout);
+   const auto key = AssetCache::make_key(source, "image", g_imageImporterVersion, std::format("format={}", static_cast<u32>(ktxFormat)));
+
+   auto& cache = AssetCache::the();
+   if (const auto entry = cache.read(key); entry.has_value()) {
+      if (auto cookedImage = deserialize_image(*entry, ktxFormat); cookedImage.has_value()) {
+         return std::move(*cookedImage);
+      }
+   }
+
+   LoadPhaseScope phaseScope{LoadPhase::Decode};
+   const auto image = ImageDecoder::the().decode(source);
+   assert(image.has_value());
+
+   // Data textures keep only the channels they use, the source image is always decoded to RGBA.
+   phaseScope.next(LoadPhase::Process);
+   CookedImage result{
+      .format = ktxFormat,
+      .width = image->width,
+      .height = image->height,
+      .texels = ktx::encode_image(ktxFormat, image->pixels, image->width, image->height),
+   };
+
+   CacheWriter writer;
+   writer.write(result.width);
+   writer.write(result.height);
+   writer.write_array(std::span<const u8>{result.texels});
+   cache.write(key, writer.data());
+
+   return result;
+}
+
+graphics_api::Texture load_source_texture(ResourceManager& manager, graphics_api::Device& device, const AssetFile& file,
+                                          const ResourceProperties& props)
+{
+   const auto mipFilter = parse_mip_filter(props.get_string("mip_filter"_name));
+   const auto [ktxFormat, width, height, texels] = cook_image(file, props, mipFilter);
+   const Resolution resolution{width, height};
+
+   const LoadPhaseScope phaseScope{LoadPhase::Upload};
+   const auto format = to_color_format(ktxFormat);
+   // The levels are generated by the compute mip generator when the device can store the format from a shader,
+   // otherwise they are blitted. Storage of R8 and RG8 is optional.
+   auto usage = TextureUsage::Sampled | TextureUsage::TransferDst | TextureUsage::TransferSrc;
+   if (device.features().storageImageWithoutFormat && device.is_texture_format_supported(format, usage | TextureUsage::Storage)) {
+      usage |= TextureUsage::Storage;
+   }
+
+   auto texture = GAPI_CHECK(device.create_texture(format, resolution, usage, SampleCount::Single, graphics_api::g_maxMipMaps));
+   if (usage & TextureUsage::Storage) {
+      GAPI_CHECK_STATUS(texture.write(device, texels.data(), manager.mip_map_generator(), mipFilter));
+   } else {
+      GAPI_CHECK_STATUS(texture.write(device, texels.data()));
+   }
+
+   MemorySize textureSize{};
+   for (int mipLevel = 0; mipLevel < texture.mip_count(); ++mipLevel) {
+      const auto mipResolution = texture.mip_resolution(mipLevel);
+      textureSize += ktx::image_size(ktxFormat, mipResolution.width, mipResolution.height);
+   }
+   manager.report_texture_memory(textureSize, Loader<ResourceType::Texture>::rgba_texture_size(resolution, texture.mip_count()));
+
+   return texture;
+}
+
+}// namespace
+
+graphics_api::Texture Loader<ResourceType::Texture>::load_gpu(ResourceManager& manager, graphics_api::Device& device, const AssetFile& file,
                                                               const ResourceProperties& props)
 {
-   int texWidth, texHeight, texChannels;
-   stbi_uc* pixels = stbi_load(path.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-   assert(pixels != nullptr);
+   auto texture =
+      file.name().ends_with(".ktx2") ? load_cooked_texture(manager, device, file) : load_source_texture(manager, device, file, props);
+   apply_properties(texture, props);
+   return texture;
+}
+
+std::vector<ResourceName> Loader<ResourceType::Texture>::collect_dependencies(const AssetFile& file,
+                                                                             [[maybe_unused]] const ResourceProperties& props)
+{
+   if (file.name().ends_with(".ktx2"))
+      return {};
+   return {"mip_downsample.cshader"_rc};
+}
+
+graphics_api::Texture Loader<ResourceType::Texture>::create_cooked_texture(graphics_api::Device& device, ktx::Texture& cookedTexture)
+{
+   constexpr auto usage = TextureUsage::Sampled | TextureUsage::TransferDst;
+
+   auto format = to_color_format(cookedTexture.format);
+   if (not device.is_texture_format_supported(format, usage)) {
+      // Block compression is optional, such textures are decoded to the uncompressed format with the same channels and color space.
+      spdlog::warn("texture format {} is not supported by the device, decoding on the CPU", static_cast<u32>(cookedTexture.format));
+      const auto uncompressedFormat = ktx::uncompressed_format(ktx::texture_layout(cookedTexture.format));
+      for (u32 mipLevel = 0; mipLevel < cookedTexture.levels.size(); ++mipLevel) {
+         const auto width = cookedTexture.mip_width(mipLevel);
+         const auto height = cookedTexture.mip_height(mipLevel);
+         const auto decoded = ktx::decode_image(cookedTexture.format, cookedTexture.levels[mipLevel], width, height);
+         assert(decoded.has_value());
+         cookedTexture.levels[mipLevel] = ktx::encode_image(uncompressedFormat, *decoded, width, height);
+      }
+      cookedTexture.format = uncompressedFormat;
+      format = to_color_format(uncompressedFormat);
+   }
+
+   const auto mipCount = static_cast<int>(cookedTexture.levels.size());
+   auto texture =
+      GAPI_CHECK(device.create_texture(format, {cookedTexture.width, cookedTexture.height}, usage, SampleCount::Single, mipCount));
+
+   std::vector<std::span<const u8>> levels(cookedTexture.levels.begin(), cookedTexture.levels.end());
+   GAPI_CHECK_STATUS(texture.write_levels(device, levels));
+
+   return texture;
+}
+
+std::optional<ktx::Header> Loader<ResourceType::Texture>::read_cooked_header(io::IFile& file)
+{
+   const auto fileSize = file.file_size();
+   if (not fileSize.has_value())
+      return std::nullopt;
+
+   std::vector<u8> data(std::min(*fileSize, ktx::g_maxHeaderSize));
+   const auto readSize = file.read(data);
+   if (not readSize.has_value() || *readSize != data.size())
+      return std::nullopt;
+
+   auto header = ktx::read_ktx2_header(data, *fileSize);
+   if (not header.has_value())
+      return std::nullopt;
+
+   return std::move(*header);
+}
+
+std::optional<ktx::Texture> Loader<ResourceType::Texture>::read_cooked_levels(io::IFile& file, const ktx::Header& header,
+                                                                             const u32 firstMip)
+{
+   // Levels are stored from the smallest one, so the levels from the first mip to the last one are a single range.
+   const auto& lastLevel = header.levels.back();
+   const auto& firstLevel = header.levels[firstMip];
+
+   std::vector<u8> data(firstLevel.offset + firstLevel.size - lastLevel.offset);
+   if (file.seek(io::SeekPosition::Begin, static_cast<MemoryOffset>(lastLevel.offset)) != io::Status::Success)
+      return std::nullopt;
+   const auto readSize = file.read(data);
+   if (not readSize.has_value() || *readSize != data.size())
+      return std::nullopt;
+
+   ktx::Texture result{
+      .format = header.format,
+      .width = std::max(header.width >> firstMip, 1u),
+      .height = std::max(header.height >> firstMip, 1u),
+   };
+   result.levels.reserve(header.levels.size() - firstMip);
+   for (u32 mipLevel = firstMip; mipLevel < header.levels.size(); ++mipLevel) {
+      const auto& range = header.levels[mipLevel];
+      const auto level = std::span{data}.subspan(range.offset - lastLevel.offset, range.size);
+      result.levels.emplace_back(level.begin(), level.end());
+   }
+
+   return result;
+}
+
+std::optional<graphics_api::Texture> Loader<ResourceType::Texture>::upload_cooked_levels(graphics_api::Device& device, io::IFile& file,
+                                                                                        const ktx::Header& header, const u32 firstMip)
+{
+   constexpr auto usage = TextureUsage::Sampled | TextureUsage::TransferDst;
+
+   const auto format = to_color_format(header.format);
+   if (not device.is_texture_format_supported(format, usage))
+      return std::nullopt;
+
+   // Levels are stored from the smallest one, so the levels from the first mip to the last one are a single range
+   // and keep their offsets relative to the last level.
+   const auto& lastLevel = header.levels.back();
+   const auto& firstLevel = header.levels[firstMip];
+   const auto alignment = std::lcm(static_cast<MemorySize>(ktx::block_size(header.format)), MemorySize{4});
+
+   std::vector<MemorySize> levelOffsets;
+   levelOffsets.reserve(header.levels.size() - firstMip);
+   for (u32 mipLevel = firstMip; mipLevel < header.levels.size(); ++mipLevel) {
+      const auto offset = header.levels[mipLevel].offset - lastLevel.offset;
+      if (offset % alignment != 0)
+         return std::nullopt;
+      levelOffsets.emplace_back(offset);
+   }
 
-   auto texture = GAPI_CHECK(device.create_texture(
-      GAPI_FORMAT(RGBA, sRGB), {static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight)},
-      TextureUsage::Sampled | TextureUsage::TransferDst | TextureUsage::TransferSrc, SampleCount::Single, graphics_api::g_maxMipMaps));
-   GAPI_CHECK_STATUS(texture.write(device, pixels));
+   const auto readLevels = [&file, &lastLevel](const std::span<u8> memory) {
+      if (file.seek(io::SeekPosition::Begin, static_cast<MemoryOffset>(lastLevel.offset)) != io::Status::Success)
+         return false;
+      const auto readSize = file.read(memory);
+      return readSize.has_value() && *readSize == memory.size();
+   };
 
-   stbi_image_free(pixels);
+   const Resolution resolution{std::max(header.width >> firstMip, 1u), std::max(header.height >> firstMip, 1u)};
+   auto texture = GAPI_CHECK(device.create_texture(format, resolution, usage, SampleCount::Single, static_cast<int>(levelOffsets.size())));
 
+   const auto rangeSize = firstLevel.offset + firstLevel.size - lastLevel.offset;
+   if (texture.write_levels(device, levelOffsets, rangeSize, readLevels) != graphics_api::Status::Success)
+      return std::nullopt;
+
+   return texture;
+}
+
+MemorySize Loader<ResourceType::Texture>::cooked_levels_size(const ktx::Header& header, const u32 firstMip)
+{
+   MemorySize result{};
+   for (u32 mipLevel = firstMip; mipLevel < header.levels.size(); ++mipLevel) {
+      result += header.levels[mipLevel].size;
+   }
+   return result;
+}
+
+void Loader<ResourceType::Texture>::apply_properties(graphics_api::Texture& texture, const ResourceProperties& props)
+{
    texture.set_anisotropy_state(props.get_bool("anisotropy"_name, true));
    auto maxLod = props.get_float_opt("max_lod"_name);
    if (maxLod.has_value()) {
       texture.set_lod(0.0f, *maxLod);
    }
+}
 
-   return texture;
+MemorySize Loader<ResourceType::Texture>::rgba_texture_size(const Resolution& resolution, const int mipCount)
+{
+   MemorySize result{};
+   for (int mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+      result +=
+         ktx::image_size(ktx::Format::RGBA8_sRGB, std::max(resolution.width >> mipLevel, 1u), std::max(resolution.height >> mipLevel, 1u));
+   }
+   return result;
+}
+
+MemorySize Loader<ResourceType::Texture>::resource_size(const graphics_api::Texture& texture)
+{
+   const auto& format = texture.format();
+
+   MemorySize result{};
+   for (int mipLevel = 0; mipLevel < texture.mip_count(); ++mipLevel) {
+      const auto [width, height] = texture.mip_resolution(mipLevel);
+      if (format.is_block_compressed()) {
+         // BC1 and BC4 take 8 bytes per 4x4 block, the other formats 16.
+         const auto isHalfBlock =
+            format.order == graphics_api::ColorFormatOrder::BC1 || format.order == graphics_api::ColorFormatOrder::BC4;
+         const MemorySize blockSize = isHalfBlock ? 8 : 16;
+         result += static_cast<MemorySize>((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+      } else {
+         result += static_cast<MemorySize>(width) * height * format.pixel_size();
+      }
+   }
+   return result;
 }
 
 }// namespace triglav::resource
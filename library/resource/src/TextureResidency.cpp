@@ -0,0 +1,216 @@
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ranges>
+
+namespace triglav::resource {
+
+TextureResidency::TextureResidency(const TextureResidencySettings& settings) :
+    m_settings(settings)
+{
+}
+
+u32 TextureResidency::add_texture(const TextureName name, const u32 width, const u32 height, std::vector<MemorySize> levelSizes)
+{
+   assert(not levelSizes.empty());
+
+   const auto levelCount = static_cast<u32>(levelSizes.size());
+   std::vector<MemorySize> sizeFromMip(levelCount);
+   MemorySize sum{};
+   for (u32 mipLevel = levelCount; mipLevel-- > 0;) {
+      sum += levelSizes[mipLevel];
+      sizeFromMip[mipLevel] = sum;
+   }
+
+   u32 tailMip = 0;
+   while (tailMip + 1 < levelCount &&
+          std::max(std::max(width >> tailMip, 1u), std::max(height >> tailMip, 1u)) > m_settings.tailDimension) {
+      ++tailMip;
+   }
+
+   this->remove_texture(name);
+
+   m_entries.emplace(name, Entry{
+                              .width = width,
+                              .height = height,
+                              .sizeFromMip = std::move(sizeFromMip),
+                              .tailMip = tailMip,
+                              .residentMip = tailMip,
+                              .desiredMip = tailMip,
+                              .pendingMip = std::nullopt,
+                           });
+   m_committedSize += m_entries.at(name).sizeFromMip[tailMip];
+
+   return tailMip;
+}
+
+void TextureResidency::remove_texture(const TextureName name)
+{
+   const auto it = m_entries.find(name);
+   if (it == m_entries.end())
+      return;
+
+   m_committedSize -= committed_size(it->second);
+   m_entries.erase(it);
+}
+
+void TextureResidency::report_demand(const TextureName name, const float screenArea)
+{
+   const auto it = m_entries.find(name);
+   if (it == m_entries.end())
+      return;
+
+   it->second.screenArea = std::max(it->second.screenArea, screenArea);
+}
+
+std::vector<TextureResidencyRequest> TextureResidency::update()
+{
+   ++m_frame;
+
+   std::vector<std::pair<TextureName, Entry*>> loads;
+   for (auto& [name, entry] : m_entries) {
+      if (entry.screenArea > 0.0f) {
+         entry.lastUsedFrame = m_frame;
+         entry.lastScreenArea = entry.screenArea;
+         entry.desiredMip = this->mip_for_area(entry, entry.screenArea);
+      } else {
+         entry.desiredMip = entry.tailMip;
+      }
+      entry.screenArea = 0.0f;
+
+      if (not entry.pendingMip.has_value() && entry.desiredMip < entry.residentMip) {
+         loads.emplace_back(name, &entry);
+      }
+   }
+
+   // Textures covering more of the screen are streamed first.
+   std::ranges::stable_sort(loads,
+                            [](const auto& lhs, const auto& rhs) { return lhs.second->lastScreenArea > rhs.second->lastScreenArea; });
+
+   std::vector<TextureResidencyRequest> requests;
+   for (const auto& [name, entry] : loads) {
+      const auto currentSize = committed_size(*entry);
+      const auto requiredSize = entry->sizeFromMip[entry->desiredMip] - currentSize;
+      if (m_committedSize + requiredSize > m_settings.budget) {
+         this->evict(m_committedSize + requiredSize - m_settings.budget, requests);
+      }
+
+      auto firstMip = entry->desiredMip;
+      while (firstMip < entry->residentMip && m_committedSize + entry->sizeFromMip[firstMip] - currentSize > m_settings.budget) {
+         ++firstMip;
+      }
+      if (firstMip == entry->residentMip)
+         continue;
+
+      m_committedSize += entry->sizeFromMip[firstMip] - currentSize;
+      entry->pendingMip = firstMip;
+      requests.emplace_back(name, firstMip);
+   }
+
+   return requests;
+}
+
+void TextureResidency::on_request_finished(const TextureName name, const u32 firstMip)
+{
+   const auto it = m_entries.find(name);
+   if (it == m_entries.end())
+      return;
+
+   auto& entry = it->second;
+   // The result may differ from the request if loading failed, the committed size follows what is actually resident.
+   m_committedSize -= committed_size(entry);
+   entry.residentMip = std::min(firstMip, static_cast<u32>(entry.sizeFromMip.size()) - 1);
+   entry.pendingMip.reset();
+   m_committedSize += committed_size(entry);
+}
+
+bool TextureResidency::is_registered(const TextureName name) const
+{
+   return m_entries.contains(name);
+}
+
+u32 TextureResidency::resident_mip(const TextureName name) const
+{
+   return m_entries.at(name).residentMip;
+}
+
+u32 TextureResidency::desired_mip(const TextureName name) const
+{
+   return m_entries.at(name).desiredMip;
+}
+
+u32 TextureResidency::tail_mip(const TextureName name) const
+{
+   return m_entries.at(name).tailMip;
+}
+
+MemorySize TextureResidency::committed_size() const
+{
+   return m_committedSize;
+}
+
+MemorySize TextureResidency::resident_size() const
+{
+   MemorySize result{};
+   for (const auto& entry : m_entries | std::views::values) {
+      result += entry.sizeFromMip[entry.residentMip];
+   }
+   return result;
+}
+
+u32 TextureResidency::pending_request_count() const
+{
+   return static_cast<u32>(
+      std::ranges::count_if(m_entries | std::views::values, [](const Entry& entry) { return entry.pendingMip.has_value(); }));
+}
+
+const TextureResidencySettings& TextureResidency::settings() const
+{
+   return m_settings;
+}
+
+u32 TextureResidency::mip_for_area(const Entry& entry, const float screenArea) const
+{
+   // The most detailed level is needed while it has fewer texels than the covered pixels, each next level has four times less.
+   const auto texelCount = static_cast<float>(entry.width) * static_cast<float>(entry.height);
+   const auto ratio = texelCount / (screenArea * m_settings.texelToPixelRatio);
+   if (ratio <= 1.0f)
+      return 0;
+
+   const auto mipLevel = static_cast<u32>(std::floor(0.5f * std::log2(ratio)));
+   return std::min(mipLevel, entry.tailMip);
+}
+
+MemorySize TextureResidency::committed_size(const Entry& entry)
+{
+   return entry.sizeFromMip[entry.pendingMip.value_or(entry.residentMip)];
+}
+
+void TextureResidency::evict(const MemorySize requiredSize, std::vector<TextureResidencyRequest>& requests)
+{
+   std::vector<std::pair<TextureName, Entry*>> candidates;
+   for (auto& [name, entry] : m_entries) {
+      if (not entry.pendingMip.has_value() && entry.residentMip < entry.desiredMip) {
+         candidates.emplace_back(name, &entry);
+      }
+   }
+
+   std::ranges::stable_sort(candidates,
+                            [](const auto& lhs, const auto& rhs) { return lhs.second->lastUsedFrame < rhs.second->lastUsedFrame; });
+
+   MemorySize freedSize{};
+   for (const auto& [name, entry] : candidates) {
+      if (freedSize >= requiredSize)
+         break;
+
+      const auto entryFreedSize = entry->sizeFromMip[entry->residentMip] - entry->sizeFromMip[entry->desiredMip];
+      freedSize += entryFreedSize;
+      m_committedSize -= entryFreedSize;
+      entry->pendingMip = entry->desiredMip;
+      requests.emplace_back(name, entry->desiredMip);
+   }
+}
+
+}// namespace triglav::resource
@@ -0,0 +1,169 @@
+#include "TextureStreamer.h"
+
+#include "LoadTelemetry.h"
+#include "ResourceManager.h"
+#include "TextureLoader.h"
+
+#include "triglav/graphics_api/Texture.h"
+#include "triglav/io/File.h"
+#include "triglav/threading/ThreadPool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace triglav::resource {
+
+using namespace name_literals;
+
+namespace {
+
+// Uploads the levels straight from the file, falls back to reading them and decoding them on the CPU if the device
+// doesn't support the format.
+std::optional<graphics_api::Texture> upload_levels(graphics_api::Device& device, io::IFile& file, const ktx::Header& header,
+                                                   const u32 firstMip)
+{
+   using TextureLoader = Loader<ResourceType::Texture>;
+
+   if (auto texture = TextureLoader::upload_cooked_levels(device, file, header, firstMip); texture.has_value())
+      return texture;
+
+   auto cookedTexture = TextureLoader::read_cooked_levels(file, header, firstMip);
+   if (not cookedTexture.has_value())
+      return std::nullopt;
+
+   return TextureLoader::create_cooked_texture(device, *cookedTexture);
+}
+
+}// namespace
+
+TextureStreamer::TextureStreamer(ResourceManager& resourceManager, graphics_api::Device& device, const TextureResidencySettings& settings) :
+    m_resourceManager(resourceManager),
+    m_device(device),
+    m_residency(settings)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+   // Jobs in progress refer to the streamer.
+   for (auto count = m_pendingJobCount.load(); count != 0; count = m_pendingJobCount.load()) {
+      m_pendingJobCount.wait(count);
+   }
+}
+
+bool TextureStreamer::is_streamable(const AssetFile& file, const ResourceProperties& props)
+{
+   return file.name().ends_with(".ktx2") && props.get_bool("streaming"_name, true);
+}
+
+graphics_api::Texture TextureStreamer::load_texture(const TextureName name, const AssetFile& file, const ResourceProperties& props)
+{
+   LoadPhaseScope phaseScope{LoadPhase::FileRead};
+
+   auto stream = file.open();
+   assert(stream.has_value());
+
+   auto header = Loader<ResourceType::Texture>::read_cooked_header(**stream);
+   assert(header.has_value());
+
+   std::vector<MemorySize> levelSizes(header->levels.size());
+   std::ranges::transform(header->levels, levelSizes.begin(), [](const ktx::LevelRange& range) { return range.size; });
+
+   u32 tailMip;
+   {
+      std::unique_lock lk{m_mutex};
+      tailMip = m_residency.add_texture(name, header->width, header->height, levelSizes);
+      m_textures.emplace(name, StreamedTexture{file, props, *header});
+   }
+
+   phaseScope.next(LoadPhase::Upload);
+   auto texture = upload_levels(m_device, **stream, *header, tailMip);
+   assert(texture.has_value());
+   Loader<ResourceType::Texture>::apply_properties(*texture, props);
+
+   m_resourceManager.report_texture_memory(
+      Loader<ResourceType::Texture>::cooked_levels_size(*header, tailMip),
+      Loader<ResourceType::Texture>::rgba_texture_size({header->width, header->height}, static_cast<int>(header->levels.size())));
+
+   return std::move(*texture);
+}
+
+void TextureStreamer::remove_texture(const TextureName name)
+{
+   std::unique_lock lk{m_mutex};
+   m_residency.remove_texture(name);
+   m_textures.erase(name);
+}
+
+void TextureStreamer::report_demand(const TextureName name, const float screenArea)
+{
+   std::unique_lock lk{m_mutex};
+   m_residency.report_demand(name, screenArea);
+}
+
+void TextureStreamer::update(Container<ResourceType::Texture>& container)
+{
+   std::vector<FinishedRequest> finishedRequests;
+   {
+      std::unique_lock lk{m_finishedRequestsMutex};
+      std::swap(finishedRequests, m_finishedRequests);
+   }
+
+   std::unique_lock lk{m_mutex};
+
+   for (auto& request : finishedRequests) {
+      // The texture was unloaded while its levels were streamed.
+      if (not m_residency.is_registered(request.name))
+         continue;
+
+      if (request.texture.has_value()) {
+         m_resourceManager.retire_queue().retire(container.replace(request.name, std::move(*request.texture)));
+         m_residency.on_request_finished(request.name, request.firstMip);
+      } else {
+         m_residency.on_request_finished(request.name, m_residency.resident_mip(request.name));
+      }
+   }
+
+   for (const auto& request : m_residency.update()) {
+      ++m_pendingJobCount;
+      threading::ThreadPool::the().issue_job(
+         [this, request, texture = m_textures.at(request.name)] { this->load_levels(request.name, texture, request.firstMip); });
+   }
+}
+
+MemorySize TextureStreamer::resident_size() const
+{
+   std::unique_lock lk{m_mutex};
+   return m_residency.resident_size();
+}
+
+MemorySize TextureStreamer::budget() const
+{
+   return m_residency.settings().budget;
+}
+
+void TextureStreamer::load_levels(const TextureName name, const StreamedTexture& streamedTexture, const u32 firstMip)
+{
+   std::optional<graphics_api::Texture> texture;
+   if (auto stream = streamedTexture.file.open(); stream.has_value()) {
+      texture = upload_levels(m_device, **stream, streamedTexture.header, firstMip);
+   }
+
+   if (texture.has_value()) {
+      Loader<ResourceType::Texture>::apply_properties(*texture, streamedTexture.props);
+   } else {
+      spdlog::warn("failed to stream mip levels of {}", streamedTexture.file.name());
+   }
+
+   {
+      std::unique_lock lk{m_finishedRequestsMutex};
+      m_finishedRequests.emplace_back(name, firstMip, std::move(texture));
+   }
+
+   --m_pendingJobCount;
+   m_pendingJobCount.notify_all();
+}
+
+}// namespace triglav::resource
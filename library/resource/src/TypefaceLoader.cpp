@@ -1,10 +1,16 @@
 #include "TypefaceLoader.h"
+#include "LoadTelemetry.h"
+
+#include <cassert>
 
 namespace triglav::resource {
 
-font::Typeface Loader<ResourceType::Typeface>::load_font(const font::FontManger& manager, const io::Path& path)
+font::Typeface Loader<ResourceType::Typeface>::load_font(const font::FontManger& manager, const AssetFile& file)
 {
-   return manager.create_typeface(path, 0);
+   // FreeType reads the font from its file as glyphs are rendered, typefaces are never packed.
+   assert(file.path().has_value());
+   const LoadPhaseScope phaseScope{LoadPhase::Decode};
+   return manager.create_typeface(*file.path(), 0);
 }
 
 }// namespace triglav::resource
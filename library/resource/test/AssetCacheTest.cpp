@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/AssetCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using triglav::MemorySize;
+using triglav::u32;
+using triglav::u64;
+using triglav::u8;
+using triglav::resource::AssetCache;
+using triglav::resource::CacheKey;
+using triglav::resource::CacheReader;
+using triglav::resource::CacheWriter;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class AssetCacheTest : public ::testing::Test
+{
+ protected:
+   void SetUp() override
+   {
+      const auto* unitTest = ::testing::UnitTest::GetInstance();
+      m_directory = fs::temp_directory_path() /
+                    ("triglav_asset_cache_" + std::to_string(unitTest->random_seed()) + "_" + unitTest->current_test_info()->name());
+      fs::remove_all(m_directory);
+   }
+
+   void TearDown() override
+   {
+      fs::remove_all(m_directory);
+   }
+
+   [[nodiscard]] triglav::io::Path directory() const
+   {
+      return triglav::io::Path{m_directory.string()};
+   }
+
+   [[nodiscard]] u32 entry_count() const
+   {
+      u32 result{};
+      for (const auto& entry : fs::directory_iterator(m_directory)) {
+         if (entry.path().extension() == ".bin") {
+            ++result;
+         }
+      }
+      return result;
+   }
+
+   fs::path m_directory;
+};
+
+std::vector<u8> make_data(const MemorySize size, const u8 seed)
+{
+   std::vector<u8> result(size);
+   for (MemorySize index = 0; index < size; ++index) {
+      result[index] = static_cast<u8>(seed + index * 7);
+   }
+   return result;
+}
+
+CacheKey make_key(const u8 seed)
+{
+   const auto source = make_data(64, seed);
+   return AssetCache::make_key(source, "test", 1, "");
+}
+
+}// namespace
+
+TEST(AssetCacheKeyTest, KeyDependsOnSourceImporterAndOptions)
+{
+   const auto source = make_data(100, 1);
+   const auto key = AssetCache::make_key(source, "obj", 1, "");
+
+   EXPECT_EQ(AssetCache::make_key(source, "obj", 1, ""), key);
+   EXPECT_NE(AssetCache::make_key(make_data(100, 2), "obj", 1, ""), key);
+   EXPECT_NE(AssetCache::make_key(make_data(101, 1), "obj", 1, ""), key);
+   EXPECT_NE(AssetCache::make_key(source, "image", 1, ""), key);
+   EXPECT_NE(AssetCache::make_key(source, "obj", 2, ""), key);
+   EXPECT_NE(AssetCache::make_key(source, "obj", 1, "format=1"), key);
+   EXPECT_EQ(key.to_string().size(), 32);
+}
+
+TEST_F(AssetCacheTest, WrittenEntryIsRead)
+{
+   AssetCache cache(this->directory(), 1024 * 1024);
+   ASSERT_TRUE(cache.is_enabled());
+
+   const auto data = make_data(1000, 3);
+   EXPECT_FALSE(cache.read(make_key(1)).has_value());
+   EXPECT_TRUE(cache.write(make_key(1), data));
+
+   const auto entry = cache.read(make_key(1));
+   ASSERT_TRUE(entry.has_value());
+   EXPECT_EQ(*entry, data);
+   EXPECT_FALSE(cache.read(make_key(2)).has_value());
+
+   EXPECT_EQ(cache.stats().hitCount, 1);
+   EXPECT_EQ(cache.stats().missCount, 2);
+}
+
+TEST_F(AssetCacheTest, CorruptedEntryIsMissing)
+{
+   AssetCache cache(this->directory(), 1024 * 1024);
+   ASSERT_TRUE(cache.write(make_key(1), make_data(1000, 3)));
+
+   const auto path = m_directory / (make_key(1).to_string() + ".bin");
+   {
+      std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(500);
+      file.put('\x7F');
+   }
+   EXPECT_FALSE(cache.read(make_key(1)).has_value());
+   EXPECT_FALSE(fs::exists(path));
+
+   ASSERT_TRUE(cache.write(make_key(1), make_data(1000, 3)));
+   fs::resize_file(path, 200);
+   EXPECT_FALSE(cache.read(make_key(1)).has_value());
+   EXPECT_FALSE(fs::exists(path));
+}
+
+TEST_F(AssetCacheTest, PayloadSizeIsCheckedAgainstTheFile)
+{
+   AssetCache cache(this->directory(), 1024 * 1024);
+   ASSERT_TRUE(cache.write(make_key(1), make_data(1000, 3)));
+
+   // The payload size follows the magic and the format version.
+   const auto path = m_directory / (make_key(1).to_string() + ".bin");
+   {
+      std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(8);
+      const u64 payloadSize = u64{1} << 60;
+      file.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+   }
+
+   EXPECT_FALSE(cache.read(make_key(1)).has_value());
+   EXPECT_FALSE(fs::exists(path));
+   EXPECT_EQ(cache.stats().missCount, 1);
+}
+
+TEST_F(AssetCacheTest, GarbageCollectionRemovesLeastRecentlyUsed)
+{
+   AssetCache cache(this->directory(), 2500);
+   for (u8 seed = 0; seed < 4; ++seed) {
+      ASSERT_TRUE(cache.write(make_key(seed), make_data(1000, seed)));
+      fs::last_write_time(m_directory / (make_key(seed).to_string() + ".bin"),
+                          fs::file_time_type::clock::now() - std::chrono::hours(10 - seed));
+   }
+
+   // Reading the oldest entry makes it the most recently used one.
+   ASSERT_TRUE(cache.read(make_key(0)).has_value());
+
+   cache.collect_garbage();
+   EXPECT_EQ(this->entry_count(), 2);
+   EXPECT_TRUE(cache.read(make_key(0)).has_value());
+   EXPECT_FALSE(cache.read(make_key(1)).has_value());
+   EXPECT_FALSE(cache.read(make_key(2)).has_value());
+   EXPECT_TRUE(cache.read(make_key(3)).has_value());
+}
+
+TEST_F(AssetCacheTest, ConcurrentWritersOfTheSameEntry)
+{
+   AssetCache firstCache(this->directory(), 64 * 1024 * 1024);
+   AssetCache secondCache(this->directory(), 64 * 1024 * 1024);
+   const auto data = make_data(256 * 1024, 5);
+
+   std::vector<std::thread> threads;
+   for (u32 threadIndex = 0; threadIndex < 8; ++threadIndex) {
+      auto& cache = threadIndex % 2 == 0 ? firstCache : secondCache;
+      threads.emplace_back([&cache, &data] {
+         for (u32 iteration = 0; iteration < 10; ++iteration) {
+            EXPECT_TRUE(cache.write(make_key(1), data));
+            const auto entry = cache.read(make_key(1));
+            ASSERT_TRUE(entry.has_value());
+            EXPECT_EQ(*entry, data);
+         }
+      });
+   }
+   for (auto& thread : threads) {
+      thread.join();
+   }
+
+   // No temporary files are left behind.
+   EXPECT_EQ(std::distance(fs::directory_iterator(m_directory), fs::directory_iterator{}), 1);
+}
+
+TEST_F(AssetCacheTest, ZeroSizeDisablesTheCache)
+{
+   AssetCache cache(this->directory(), 0);
+   EXPECT_FALSE(cache.is_enabled());
+   EXPECT_FALSE(cache.write(make_key(1), make_data(10, 1)));
+   EXPECT_FALSE(cache.read(make_key(1)).has_value());
+   EXPECT_FALSE(fs::exists(m_directory));
+}
+
+TEST(CacheSerializationTest, ValuesAreReadInWriteOrder)
+{
+   CacheWriter writer;
+   writer.write<u32>(42);
+   writer.write_string("material.mat");
+   const std::vector<float> values{1.0f, 2.5f, -3.0f};
+   writer.write_array(std::span<const float>{values});
+
+   CacheReader reader{writer.data()};
+   EXPECT_EQ(reader.read<u32>(), 42);
+   EXPECT_EQ(reader.read_string_view(), "material.mat");
+   EXPECT_EQ(reader.read_array<float>(), values);
+   EXPECT_TRUE(reader.is_complete());
+
+   CacheReader truncatedReader{writer.data().first(writer.data().size() - 1)};
+   truncatedReader.read<u32>();
+   truncatedReader.read_string_view();
+   EXPECT_TRUE(truncatedReader.read_array<float>().empty());
+   EXPECT_FALSE(truncatedReader.is_complete());
+}
+
+TEST(CacheSerializationTest, ArrayBytesPointIntoTheData)
+{
+   CacheWriter writer;
+   writer.write<u8>(1);
+   const std::vector<u32> indices{0, 1, 2, 2, 3, 0};
+   writer.write_array(std::span<const u32>{indices});
+
+   CacheReader reader{writer.data()};
+   reader.read<u8>();
+   const auto bytes = reader.read_array_bytes<u32>();
+   EXPECT_TRUE(reader.is_complete());
+   ASSERT_EQ(bytes.size(), indices.size() * sizeof(u32));
+   EXPECT_EQ(bytes.data(), writer.data().data() + sizeof(u8) + sizeof(u64));
+   EXPECT_EQ(std::memcmp(bytes.data(), indices.data(), bytes.size()), 0);
+
+   CacheReader truncatedReader{writer.data().first(writer.data().size() - 1)};
+   truncatedReader.read<u8>();
+   EXPECT_TRUE(truncatedReader.read_array_bytes<u32>().empty());
+   EXPECT_FALSE(truncatedReader.is_complete());
+}
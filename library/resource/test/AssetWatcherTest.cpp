@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/AssetWatcher.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using triglav::ResourceName;
+using triglav::io::IFileWatcher;
+using triglav::io::Path;
+using triglav::io::Status;
+using triglav::resource::AssetWatcher;
+using triglav::resource::ReloadWaves;
+using namespace triglav::name_literals;
+
+namespace {
+
+// File system that exists only in the test, changes are reported as soon as the test makes them.
+class FakeFileSystem
+{
+ public:
+   void change_file(const std::string& path)
+   {
+      m_changedFiles.emplace_back(path);
+   }
+
+   [[nodiscard]] bool is_watched(const std::string& directory) const
+   {
+      return m_watchedDirectories.contains(directory);
+   }
+
+ private:
+   friend class FakeFileWatcher;
+
+   std::vector<Path> m_changedFiles;
+   std::set<std::string> m_watchedDirectories;
+};
+
+class FakeFileWatcher final : public IFileWatcher
+{
+ public:
+   explicit FakeFileWatcher(FakeFileSystem& fileSystem) :
+       m_fileSystem(fileSystem)
+   {
+   }
+
+   [[nodiscard]] Status watch_directory(const Path& path) override
+   {
+      m_fileSystem.m_watchedDirectories.emplace(path.string());
+      return Status::Success;
+   }
+
+   [[nodiscard]] std::vector<Path> changed_files() override
+   {
+      std::vector<Path> result;
+      for (const auto& file : m_fileSystem.m_changedFiles) {
+         if (m_fileSystem.m_watchedDirectories.contains(file.parent().string())) {
+            result.emplace_back(file);
+         }
+      }
+      m_fileSystem.m_changedFiles.clear();
+      return result;
+   }
+
+ private:
+   FakeFileSystem& m_fileSystem;
+};
+
+using WaveSets = std::vector<std::set<ResourceName>>;
+
+// Assets within a wave are loaded in parallel, their order doesn't matter.
+WaveSets to_sets(const ReloadWaves& waves)
+{
+   WaveSets result;
+   for (const auto& wave : waves) {
+      result.emplace_back(wave.begin(), wave.end());
+   }
+   return result;
+}
+
+class AssetWatcherTest : public ::testing::Test
+{
+ protected:
+   AssetWatcherTest() :
+       m_watcher(std::make_unique<FakeFileWatcher>(m_fileSystem))
+   {
+      // Two materials of a template that uses two shaders, a texture nothing depends on.
+      this->add_asset("basic.fshader"_rc, "/build/shader/basic.fshader");
+      this->add_asset("basic.vshader"_rc, "/build/shader/basic.vshader");
+      this->add_asset("basic.mt"_rc, "/content/material/basic.mt", {"basic.fshader"_rc, "basic.vshader"_rc});
+      this->add_asset("stone.mat"_rc, "/content/material/stone.mat", {"basic.mt"_rc});
+      this->add_asset("wood.mat"_rc, "/content/material/wood.mat", {"basic.mt"_rc});
+      this->add_asset("stone.tex"_rc, "/content/texture/stone.png");
+   }
+
+   void add_asset(const ResourceName name, const std::string& path, const std::vector<ResourceName>& dependencies = {})
+   {
+      m_watcher.add_asset(name, Path{path}, dependencies);
+   }
+
+   FakeFileSystem m_fileSystem;
+   AssetWatcher m_watcher;
+};
+
+}// namespace
+
+TEST_F(AssetWatcherTest, WatchesDirectoriesOfTheAssets)
+{
+   EXPECT_TRUE(m_fileSystem.is_watched("/build/shader"));
+   EXPECT_TRUE(m_fileSystem.is_watched("/content/material"));
+   EXPECT_TRUE(m_fileSystem.is_watched("/content/texture"));
+   EXPECT_FALSE(m_fileSystem.is_watched("/content"));
+}
+
+TEST_F(AssetWatcherTest, ChangedShaderReloadsTemplateThenMaterials)
+{
+   m_fileSystem.change_file("/build/shader/basic.fshader");
+
+   const WaveSets expected{
+      {"basic.fshader"_rc},
+      {"basic.mt"_rc},
+      {"stone.mat"_rc, "wood.mat"_rc},
+   };
+   EXPECT_EQ(to_sets(m_watcher.poll_changes()), expected);
+   EXPECT_TRUE(m_watcher.poll_changes().empty());
+}
+
+TEST_F(AssetWatcherTest, ChangedLeafReloadsOnlyItself)
+{
+   m_fileSystem.change_file("/content/material/wood.mat");
+   m_fileSystem.change_file("/content/texture/stone.png");
+
+   const WaveSets expected{
+      {"wood.mat"_rc, "stone.tex"_rc},
+   };
+   EXPECT_EQ(to_sets(m_watcher.poll_changes()), expected);
+}
+
+TEST_F(AssetWatcherTest, DependentWaitsForItsLatestDependency)
+{
+   // Both the template and one of its shaders changed, the template is reloaded after the shader.
+   m_fileSystem.change_file("/content/material/basic.mt");
+   m_fileSystem.change_file("/build/shader/basic.vshader");
+
+   const WaveSets expected{
+      {"basic.vshader"_rc},
+      {"basic.mt"_rc},
+      {"stone.mat"_rc, "wood.mat"_rc},
+   };
+   EXPECT_EQ(to_sets(m_watcher.poll_changes()), expected);
+}
+
+TEST_F(AssetWatcherTest, UnrelatedFilesInvalidateNothing)
+{
+   m_fileSystem.change_file("/content/material/basic.mt.swp");
+   m_fileSystem.change_file("/content/level/demo.level");
+
+   EXPECT_TRUE(m_watcher.poll_changes().empty());
+}
+
+TEST_F(AssetWatcherTest, RemovedAssetIsNotReloaded)
+{
+   m_watcher.remove_asset("wood.mat"_rc);
+   m_fileSystem.change_file("/content/material/basic.mt");
+
+   const WaveSets expected{
+      {"basic.mt"_rc},
+      {"stone.mat"_rc},
+   };
+   EXPECT_EQ(to_sets(m_watcher.poll_changes()), expected);
+
+   m_fileSystem.change_file("/content/material/wood.mat");
+   EXPECT_TRUE(m_watcher.poll_changes().empty());
+}
+
+TEST_F(AssetWatcherTest, ReaddedAssetKeepsItsDependents)
+{
+   // Evicted and loaded again, from a pack archive this time.
+   m_watcher.remove_asset("basic.mt"_rc);
+   m_watcher.add_asset("basic.mt"_rc, std::nullopt, std::vector<ResourceName>{"basic.fshader"_rc, "basic.vshader"_rc});
+
+   m_fileSystem.change_file("/content/material/basic.mt");
+   EXPECT_TRUE(m_watcher.poll_changes().empty());
+
+   m_fileSystem.change_file("/build/shader/basic.fshader");
+   const WaveSets expected{
+      {"basic.fshader"_rc},
+      {"basic.mt"_rc},
+      {"stone.mat"_rc, "wood.mat"_rc},
+   };
+   EXPECT_EQ(to_sets(m_watcher.poll_changes()), expected);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "triglav/render_core/Material.hpp"
+#include "triglav/resource/Container.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+using triglav::MaterialName;
+using triglav::MaterialTemplateName;
+using triglav::ResourceName;
+using triglav::ResourceType;
+using triglav::render_core::Material;
+using triglav::resource::Container;
+using namespace triglav::name_literals;
+
+TEST(ContainerTest, HandlesOfRemovedResourcesAreRejected)
+{
+   Container<ResourceType::Material> container;
+   container.register_emplace("first.mat"_rc, "first.mt"_rc);
+   const auto handle = container.handle("first.mat"_rc);
+   EXPECT_EQ(container.get(handle).materialTemplate, MaterialTemplateName{"first.mt"_rc});
+
+   (void)container.erase("first.mat"_rc);
+   EXPECT_FALSE(container.is_valid(handle));
+   EXPECT_THROW((void)container.get(handle), std::out_of_range);
+   EXPECT_THROW((void)container.name(handle), std::out_of_range);
+
+   // The slot is reused by the next resource, the previous handle still doesn't resolve to it.
+   container.register_emplace("second.mat"_rc, "second.mt"_rc);
+   const auto secondHandle = container.handle("second.mat"_rc);
+   EXPECT_EQ(secondHandle.index(), handle.index());
+   EXPECT_THROW((void)container.get(handle), std::out_of_range);
+   EXPECT_EQ(container.get(secondHandle).materialTemplate, MaterialTemplateName{"second.mt"_rc});
+}
+
+TEST(ContainerTest, EmplaceForwardsTheArguments)
+{
+   std::vector<triglav::render_core::MaterialPropertyValue> values{1.0f, 2.0f};
+   const auto* data = values.data();
+
+   Container<ResourceType::Material> container;
+   container.register_emplace("moved.mat"_rc, "moved.mt"_rc, std::move(values));
+   EXPECT_EQ(container.get("moved.mat"_rc).values.data(), data);
+}
+
+TEST(ContainerTest, IteratesRegisteredResources)
+{
+   Container<ResourceType::Material> container;
+   container.register_emplace("first.mat"_rc, "first.mt"_rc);
+   container.register_emplace("second.mat"_rc, "second.mt"_rc);
+   (void)container.erase("first.mat"_rc);
+
+   std::vector<MaterialName> names;
+   container.iterate_resources([&names](const MaterialName name, const Material& material) {
+      EXPECT_EQ(material.materialTemplate, MaterialTemplateName{"second.mt"_rc});
+      names.emplace_back(name);
+   });
+   EXPECT_EQ(names, std::vector<MaterialName>{"second.mat"_rc});
+}
+
+TEST(ContainerTest, CollectsResourcesUsedInTheFrame)
+{
+   Container<ResourceType::Material> container;
+   container.register_emplace("first.mat"_rc, "first.mt"_rc);
+   container.register_emplace("second.mat"_rc, "second.mt"_rc);
+   const auto first = container.handle("first.mat"_rc);
+   const auto second = container.handle("second.mat"_rc);
+
+   // Marking a resource more than once in a frame collects it once.
+   container.mark_used(first, 1);
+   container.mark_used(second, 1);
+   container.mark_used(first, 2);
+   container.mark_used(first, 2);
+
+   std::vector<ResourceName> names;
+   container.collect_used_resources(2, names);
+   EXPECT_EQ(names, std::vector<ResourceName>{"first.mat"_rc});
+
+   // Stale handles are ignored.
+   (void)container.erase("first.mat"_rc);
+   container.mark_used(first, 3);
+   names.clear();
+   container.collect_used_resources(3, names);
+   EXPECT_TRUE(names.empty());
+}
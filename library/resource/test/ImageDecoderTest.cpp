@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/ImageDecoder.h"
+#include "triglav/threading/ThreadPool.h"
+
+#include <cstdio>
+
+#include <jpeglib.h>
+#include <png.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+using triglav::u32;
+using triglav::u8;
+using triglav::resource::DecodedImage;
+using triglav::resource::ImageDecoder;
+using triglav::resource::JpegImageDecoder;
+using triglav::resource::PngImageDecoder;
+using triglav::resource::StbImageDecoder;
+using triglav::threading::ThreadPool;
+
+namespace {
+
+std::vector<u8> test_pattern(const u32 width, const u32 height, const u32 channelCount)
+{
+   std::vector<u8> result(static_cast<size_t>(width) * height * channelCount);
+   for (u32 y = 0; y < height; ++y) {
+      for (u32 x = 0; x < width; ++x) {
+         for (u32 channel = 0; channel < channelCount; ++channel) {
+            result[(y * width + x) * channelCount + channel] = static_cast<u8>((x * 7 + y * 3 + channel * 61 + (x * y) % 13) & 0xFF);
+         }
+      }
+   }
+   return result;
+}
+
+std::vector<u8> encode_png(const std::vector<u8>& pixels, const u32 width, const u32 height, const u32 format)
+{
+   png_image image{};
+   image.version = PNG_IMAGE_VERSION;
+   image.width = width;
+   image.height = height;
+   image.format = format;
+
+   png_alloc_size_t size{};
+   EXPECT_NE(png_image_write_to_memory(&image, nullptr, &size, 0, pixels.data(), 0, nullptr), 0);
+   std::vector<u8> result(size);
+   EXPECT_NE(png_image_write_to_memory(&image, result.data(), &size, 0, pixels.data(), 0, nullptr), 0);
+   result.resize(size);
+   return result;
+}
+
+std::vector<u8> encode_jpeg(const std::vector<u8>& pixels, const u32 width, const u32 height, const bool isProgressive)
+{
+   jpeg_compress_struct info{};
+   jpeg_error_mgr error{};
+   info.err = jpeg_std_error(&error);
+   jpeg_create_compress(&info);
+
+   unsigned char* buffer{};
+   unsigned long size{};
+   jpeg_mem_dest(&info, &buffer, &size);
+
+   info.image_width = width;
+   info.image_height = height;
+   info.input_components = 3;
+   info.in_color_space = JCS_RGB;
+   jpeg_set_defaults(&info);
+   jpeg_set_quality(&info, 90, TRUE);
+   if (isProgressive) {
+      jpeg_simple_progression(&info);
+   }
+
+   jpeg_start_compress(&info, TRUE);
+   while (info.next_scanline < height) {
+      auto* row = const_cast<u8*>(pixels.data()) + static_cast<size_t>(info.next_scanline) * width * 3;
+      jpeg_write_scanlines(&info, &row, 1);
+   }
+   jpeg_finish_compress(&info);
+   jpeg_destroy_compress(&info);
+
+   std::vector<u8> result(buffer, buffer + size);
+   free(buffer);
+   return result;
+}
+
+int max_difference(const DecodedImage& lhs, const DecodedImage& rhs)
+{
+   EXPECT_EQ(lhs.pixels.size(), rhs.pixels.size());
+   int result{};
+   for (size_t i = 0; i < std::min(lhs.pixels.size(), rhs.pixels.size()); ++i) {
+      result = std::max(result, std::abs(static_cast<int>(lhs.pixels[i]) - static_cast<int>(rhs.pixels[i])));
+   }
+   return result;
+}
+
+}// namespace
+
+TEST(ImageDecoderTest, PngMatchesStb)
+{
+   for (const u32 format : std::initializer_list<u32>{PNG_FORMAT_RGBA, PNG_FORMAT_RGB, PNG_FORMAT_GA, PNG_FORMAT_GRAY}) {
+      const auto data = encode_png(test_pattern(37, 23, PNG_IMAGE_PIXEL_CHANNELS(format)), 37, 23, format);
+
+      PngImageDecoder pngDecoder;
+      ASSERT_TRUE(pngDecoder.can_decode(data));
+      const auto image = pngDecoder.decode(data);
+      const auto reference = StbImageDecoder{}.decode(data);
+      ASSERT_TRUE(image.has_value());
+      ASSERT_TRUE(reference.has_value());
+
+      EXPECT_EQ(image->width, 37);
+      EXPECT_EQ(image->height, 23);
+      EXPECT_EQ(image->pixels, reference->pixels);
+   }
+}
+
+TEST(ImageDecoderTest, JpegStripsMatchSingleStrip)
+{
+   constexpr u32 width = 333;
+   constexpr u32 height = 1100;
+   const auto data = encode_jpeg(test_pattern(width, height, 3), width, height, false);
+
+   const auto singleStrip = JpegImageDecoder{1}.decode(data);
+   const auto multipleStrips = JpegImageDecoder{4}.decode(data);
+   ASSERT_TRUE(singleStrip.has_value());
+   ASSERT_TRUE(multipleStrips.has_value());
+
+   EXPECT_EQ(multipleStrips->width, width);
+   EXPECT_EQ(multipleStrips->height, height);
+   EXPECT_EQ(multipleStrips->pixels, singleStrip->pixels);
+
+   // The SIMD IDCT rounds differently than stb_image.
+   const auto reference = StbImageDecoder{}.decode(data);
+   ASSERT_TRUE(reference.has_value());
+   EXPECT_LE(max_difference(*multipleStrips, *reference), 8);
+}
+
+TEST(ImageDecoderTest, JpegStripsDecodeInsideThreadPoolJobs)
+{
+   constexpr u32 width = 333;
+   constexpr u32 height = 1100;
+   const auto data = encode_jpeg(test_pattern(width, height, 3), width, height, false);
+   const auto singleStrip = JpegImageDecoder{1}.decode(data);
+   ASSERT_TRUE(singleStrip.has_value());
+
+   // Every pool thread decodes an image, so the strips of each image are left to the threads decoding them.
+   constexpr u32 jobCount = 2;
+   auto& threadPool = ThreadPool::the();
+   threadPool.initialize(jobCount);
+
+   std::array<std::optional<DecodedImage>, jobCount> images;
+   std::atomic<u32> finishedJobCount{0};
+   for (u32 job = 0; job < jobCount; ++job) {
+      threadPool.issue_job([&, job] {
+         images[job] = JpegImageDecoder{4}.decode(data);
+         ++finishedJobCount;
+         finishedJobCount.notify_all();
+      });
+   }
+   for (auto count = finishedJobCount.load(); count != jobCount; count = finishedJobCount.load()) {
+      finishedJobCount.wait(count);
+   }
+   threadPool.quit();
+
+   for (const auto& image : images) {
+      ASSERT_TRUE(image.has_value());
+      EXPECT_EQ(image->pixels, singleStrip->pixels);
+   }
+}
+
+TEST(ImageDecoderTest, ProgressiveJpeg)
+{
+   constexpr u32 width = 200;
+   constexpr u32 height = 600;
+   const auto data = encode_jpeg(test_pattern(width, height, 3), width, height, true);
+
+   const auto image = JpegImageDecoder{4}.decode(data);
+   const auto reference = StbImageDecoder{}.decode(data);
+   ASSERT_TRUE(image.has_value());
+   ASSERT_TRUE(reference.has_value());
+   EXPECT_LE(max_difference(*image, *reference), 8);
+}
+
+TEST(ImageDecoderTest, UnsupportedFormatsFallBackToStb)
+{
+   // Uncompressed 2x1 true color TGA.
+   const std::vector<u8> data{0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 1, 0, 24, 0, 255, 0, 0, 0, 255, 0};
+
+   const ImageDecoder decoder;
+   EXPECT_EQ(decoder.backend_name(data), "stb_image");
+
+   const auto image = decoder.decode(data);
+   ASSERT_TRUE(image.has_value());
+   EXPECT_EQ(image->width, 2);
+   EXPECT_EQ(image->height, 1);
+   EXPECT_EQ(image->pixels, (std::vector<u8>{0, 0, 255, 255, 0, 255, 0, 255}));
+}
+
+TEST(ImageDecoderTest, CorruptedDataFails)
+{
+   auto data = encode_png(test_pattern(16, 16, 4), 16, 16, PNG_FORMAT_RGBA);
+   data.resize(data.size() / 2);
+
+   const ImageDecoder decoder;
+   EXPECT_EQ(decoder.backend_name(data), "libpng");
+   EXPECT_FALSE(PngImageDecoder{}.decode(data).has_value());
+
+   const std::vector<u8> jpegData{0xFF, 0xD8, 0xFF, 0xE0, 0x00};
+   EXPECT_FALSE(JpegImageDecoder{2}.decode(jpegData).has_value());
+   EXPECT_FALSE(decoder.decode(jpegData).has_value());
+}
@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/AssetCache.h"
+#include "triglav/resource/LoadContext.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using triglav::ResourceName;
+using triglav::io::Path;
+using triglav::resource::AssetCache;
+using triglav::resource::AssetFile;
+using triglav::resource::FinishLoadingAssetResult;
+using triglav::resource::LoadContext;
+using triglav::resource::LoadPriority;
+using triglav::resource::LoadStep;
+using triglav::resource::LoadTask;
+using triglav::resource::ResourcePath;
+using namespace triglav::name_literals;
+
+namespace {
+
+std::unique_ptr<LoadContext> make_context(const std::vector<std::string>& names)
+{
+   std::vector<ResourcePath> assets;
+   for (const auto& name : names) {
+      assets.emplace_back(name, name, triglav::resource::ResourceProperties{});
+   }
+   return std::make_unique<LoadContext>(std::move(assets));
+}
+
+std::unique_ptr<LoadContext> make_prioritized_context(const std::vector<std::pair<std::string, LoadPriority>>& names)
+{
+   std::vector<ResourcePath> assets;
+   for (const auto& [name, priority] : names) {
+      assets.emplace_back(name, name, triglav::resource::ResourceProperties{}, priority);
+   }
+   return std::make_unique<LoadContext>(std::move(assets));
+}
+
+bool set_dependencies(LoadContext& context, const ResourceName name, const std::vector<ResourceName>& dependencies)
+{
+   return context.set_dependencies(name, AssetFile{Path{"/tmp"}}, dependencies);
+}
+
+std::vector<ResourceName> take_tasks(LoadContext& context)
+{
+   std::vector<ResourceName> result;
+   while (const auto task = context.next_task()) {
+      result.emplace_back(task->name);
+   }
+   return result;
+}
+
+}// namespace
+
+TEST(LoadContextTest, AssetsWithoutDependenciesAreReady)
+{
+   const auto context = make_context({"a.tex", "b.model"});
+   EXPECT_EQ(context->total_assets(), 2);
+
+   EXPECT_TRUE(set_dependencies(*context, "a.tex"_rc, {}));
+   EXPECT_TRUE(set_dependencies(*context, "b.model"_rc, {}));
+
+   std::vector<ResourceName> readyAssets;
+   EXPECT_EQ(context->finish_loading_asset("a.tex"_rc, readyAssets), FinishLoadingAssetResult::None);
+   EXPECT_EQ(context->finish_loading_asset("b.model"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingAssets);
+   EXPECT_TRUE(readyAssets.empty());
+   EXPECT_EQ(context->total_loaded_assets(), 2);
+}
+
+TEST(LoadContextTest, AssetWaitsOnlyForItsOwnDependencies)
+{
+   const auto context = make_context({"a.mt", "b.mt", "a.mat", "b.mat", "slow.tex"});
+   EXPECT_TRUE(set_dependencies(*context, "slow.tex"_rc, {}));
+   EXPECT_TRUE(set_dependencies(*context, "a.mt"_rc, {}));
+   EXPECT_TRUE(set_dependencies(*context, "b.mt"_rc, {}));
+   EXPECT_FALSE(set_dependencies(*context, "a.mat"_rc, {"a.mt"_rc}));
+   EXPECT_FALSE(set_dependencies(*context, "b.mat"_rc, {"a.mt"_rc, "b.mt"_rc}));
+
+   // The texture is still loading, it doesn't hold back the materials.
+   std::vector<ResourceName> readyAssets;
+   context->finish_loading_asset("a.mt"_rc, readyAssets);
+   ASSERT_EQ(readyAssets.size(), 1);
+   EXPECT_EQ(readyAssets[0], "a.mat"_rc);
+
+   readyAssets.clear();
+   context->finish_loading_asset("b.mt"_rc, readyAssets);
+   ASSERT_EQ(readyAssets.size(), 1);
+   EXPECT_EQ(readyAssets[0], "b.mat"_rc);
+
+   readyAssets.clear();
+   context->finish_loading_asset("a.mat"_rc, readyAssets);
+   context->finish_loading_asset("b.mat"_rc, readyAssets);
+   EXPECT_EQ(context->finish_loading_asset("slow.tex"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingAssets);
+   EXPECT_TRUE(readyAssets.empty());
+}
+
+TEST(LoadContextTest, LoadedAndUnlistedDependenciesAreSatisfied)
+{
+   const auto context = make_context({"a.mt", "a.mat", "b.mat"});
+   EXPECT_TRUE(set_dependencies(*context, "a.mt"_rc, {}));
+
+   std::vector<ResourceName> readyAssets;
+   context->finish_loading_asset("a.mt"_rc, readyAssets);
+
+   EXPECT_TRUE(set_dependencies(*context, "a.mat"_rc, {"a.mt"_rc}));
+   EXPECT_TRUE(set_dependencies(*context, "b.mat"_rc, {"other.mt"_rc}));
+   EXPECT_TRUE(readyAssets.empty());
+}
+
+TEST(LoadContextTest, CriticalPathFollowsTheLastDependency)
+{
+   const auto context = make_context({"quick.cshader", "slow.cshader", "a.tex", "b.tex"});
+   EXPECT_TRUE(set_dependencies(*context, "quick.cshader"_rc, {}));
+   EXPECT_TRUE(set_dependencies(*context, "slow.cshader"_rc, {}));
+   EXPECT_FALSE(set_dependencies(*context, "a.tex"_rc, {"quick.cshader"_rc, "slow.cshader"_rc}));
+   EXPECT_FALSE(set_dependencies(*context, "b.tex"_rc, {"quick.cshader"_rc}));
+
+   std::vector<ResourceName> readyAssets;
+   context->finish_loading_asset("quick.cshader"_rc, readyAssets);
+   context->finish_loading_asset("b.tex"_rc, readyAssets);
+   context->finish_loading_asset("slow.cshader"_rc, readyAssets);
+   EXPECT_EQ(context->finish_loading_asset("a.tex"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingAssets);
+
+   const auto criticalPath = context->critical_path();
+   const auto slowShader = criticalPath.find("slow.cshader");
+   const auto texture = criticalPath.find("a.tex");
+   ASSERT_NE(slowShader, std::string::npos);
+   ASSERT_NE(texture, std::string::npos);
+   EXPECT_LT(slowShader, texture);
+   EXPECT_EQ(criticalPath.find("quick.cshader"), std::string::npos);
+   EXPECT_EQ(criticalPath.find("b.tex"), std::string::npos);
+}
+
+TEST(LoadContextTest, TasksAreTakenByPriority)
+{
+   const auto context = make_prioritized_context({
+      {"a.tex", LoadPriority::Background},
+      {"b.tex", LoadPriority::Visible},
+      {"c.model", LoadPriority::Required},
+      {"d.model", LoadPriority::Background},
+   });
+   for (const ResourceName name : std::vector<ResourceName>{"a.tex"_rc, "b.tex"_rc, "c.model"_rc, "d.model"_rc}) {
+      context->enqueue(LoadTask{name, LoadStep::Prepare});
+   }
+
+   const auto task = context->next_task();
+   ASSERT_TRUE(task.has_value());
+   EXPECT_EQ(task->name, "c.model"_rc);
+   EXPECT_EQ(task->step, LoadStep::Prepare);
+
+   const std::vector<ResourceName> expectedOrder{"b.tex"_rc, "a.tex"_rc, "d.model"_rc};
+   EXPECT_EQ(take_tasks(*context), expectedOrder);
+}
+
+TEST(LoadContextTest, DependenciesTakeThePriorityOfTheAsset)
+{
+   const auto context = make_prioritized_context({
+      {"a.mt", LoadPriority::Background},
+      {"a.mat", LoadPriority::Required},
+      {"b.tex", LoadPriority::Background},
+   });
+   context->enqueue(LoadTask{"b.tex"_rc, LoadStep::Prepare});
+   context->enqueue(LoadTask{"a.mt"_rc, LoadStep::Prepare});
+
+   EXPECT_FALSE(set_dependencies(*context, "a.mat"_rc, {"a.mt"_rc}));
+   EXPECT_EQ(context->priority("a.mt"_rc), LoadPriority::Required);
+
+   const std::vector<ResourceName> expectedOrder{"a.mt"_rc, "b.tex"_rc};
+   EXPECT_EQ(take_tasks(*context), expectedOrder);
+}
+
+TEST(LoadContextTest, PromotedAssetPromotesItsPendingDependencies)
+{
+   const auto context = make_prioritized_context({
+      {"a.mt", LoadPriority::Background},
+      {"a.mat", LoadPriority::Background},
+      {"b.tex", LoadPriority::Background},
+   });
+   EXPECT_TRUE(set_dependencies(*context, "a.mt"_rc, {}));
+   EXPECT_TRUE(set_dependencies(*context, "b.tex"_rc, {}));
+   EXPECT_FALSE(set_dependencies(*context, "a.mat"_rc, {"a.mt"_rc}));
+   context->enqueue(LoadTask{"b.tex"_rc, LoadStep::Load});
+   context->enqueue(LoadTask{"a.mt"_rc, LoadStep::Load});
+
+   context->promote("a.mat"_rc, LoadPriority::Visible);
+   EXPECT_EQ(context->priority("a.mat"_rc), LoadPriority::Visible);
+   EXPECT_EQ(context->priority("a.mt"_rc), LoadPriority::Visible);
+
+   // Promotions never lower the priority.
+   context->promote("a.mt"_rc, LoadPriority::Background);
+   EXPECT_EQ(context->priority("a.mt"_rc), LoadPriority::Visible);
+
+   const std::vector<ResourceName> expectedOrder{"a.mt"_rc, "b.tex"_rc};
+   EXPECT_EQ(take_tasks(*context), expectedOrder);
+}
+
+TEST(LoadContextTest, RequiredAssetsFinishBeforeTheRest)
+{
+   const auto context = make_prioritized_context({
+      {"a.level", LoadPriority::Required},
+      {"b.model", LoadPriority::Background},
+      {"c.tex", LoadPriority::Background},
+   });
+   for (const ResourceName name : std::vector<ResourceName>{"a.level"_rc, "b.model"_rc, "c.tex"_rc}) {
+      EXPECT_TRUE(set_dependencies(*context, name, {}));
+   }
+
+   // The level references the model, which becomes required before the level finishes.
+   std::vector<ResourceName> readyAssets;
+   context->promote("b.model"_rc, LoadPriority::Required);
+   EXPECT_EQ(context->finish_loading_asset("a.level"_rc, readyAssets), FinishLoadingAssetResult::None);
+   EXPECT_EQ(context->finish_loading_asset("b.model"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingRequiredAssets);
+   EXPECT_EQ(context->finish_loading_asset("c.tex"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingAssets);
+}
+
+TEST(LoadContextTest, RequiredAssetsAreReportedOnce)
+{
+   const auto context = make_prioritized_context({
+      {"a.level", LoadPriority::Required},
+      {"b.model", LoadPriority::Background},
+      {"c.tex", LoadPriority::Background},
+   });
+   for (const ResourceName name : std::vector<ResourceName>{"a.level"_rc, "b.model"_rc, "c.tex"_rc}) {
+      EXPECT_TRUE(set_dependencies(*context, name, {}));
+   }
+
+   std::vector<ResourceName> readyAssets;
+   EXPECT_EQ(context->finish_loading_asset("a.level"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingRequiredAssets);
+
+   // A model referenced after the level is loaded is still loaded first.
+   context->promote("b.model"_rc, LoadPriority::Required);
+   EXPECT_EQ(context->priority("b.model"_rc), LoadPriority::Required);
+   EXPECT_EQ(context->finish_loading_asset("b.model"_rc, readyAssets), FinishLoadingAssetResult::None);
+   EXPECT_EQ(context->finish_loading_asset("c.tex"_rc, readyAssets), FinishLoadingAssetResult::FinishedLoadingAssets);
+}
+
+TEST(LoadContextTest, CompiledManifestMatchesTheAssetList)
+{
+   namespace fs = std::filesystem;
+   const auto directory =
+      fs::temp_directory_path() / ("triglav_manifest_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()));
+   fs::create_directories(directory);
+
+   const auto listPath = directory / "index.yaml";
+   {
+      std::ofstream file(listPath);
+      file << "resources:\n"
+              "  - name: a.tex\n"
+              "    source: texture/a.png\n"
+              "    priority: visible\n"
+              "    properties:\n"
+              "      channels: rg\n"
+              "  - name: b.mat\n"
+              "    source: material/b.yaml\n"
+              "  - name: c.fshader\n"
+              "    source: shader/c.spv\n";
+   }
+
+   AssetCache cache(Path{(directory / "cache").string()}, 1024 * 1024);
+   const auto parsedContext = LoadContext::from_asset_list(Path{listPath.string()}, cache);
+   const auto compiledContext = LoadContext::from_asset_list(Path{listPath.string()}, cache);
+   EXPECT_EQ(cache.stats().missCount, 1);
+   EXPECT_EQ(cache.stats().hitCount, 1);
+
+   for (const auto& context : {parsedContext.get(), compiledContext.get()}) {
+      ASSERT_EQ(context->total_assets(), 3);
+      EXPECT_EQ(context->resource("a.tex"_rc).source, "texture/a.png");
+      EXPECT_EQ(context->resource("a.tex"_rc).properties.get_string("channels"_name), "rg");
+      EXPECT_EQ(context->priority("a.tex"_rc), LoadPriority::Visible);
+      EXPECT_EQ(context->resource("b.mat"_rc).source, "material/b.yaml");
+      EXPECT_TRUE(context->resource("b.mat"_rc).properties.properties.empty());
+      EXPECT_EQ(context->priority("b.mat"_rc), LoadPriority::Background);
+      EXPECT_EQ(context->priority("c.fshader"_rc), LoadPriority::Required);
+   }
+
+   fs::remove_all(directory);
+}
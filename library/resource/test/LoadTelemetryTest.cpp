@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/LoadTelemetry.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+using triglav::ResourceName;
+using triglav::resource::LoadAssetScope;
+using triglav::resource::LoadPhase;
+using triglav::resource::LoadPhaseScope;
+using triglav::resource::LoadTelemetry;
+using namespace triglav::name_literals;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = LoadTelemetry::Clock;
+
+std::string asset_name(const ResourceName name)
+{
+   if (name == "a.mat"_rc)
+      return "a.mat";
+   if (name == "b.tex"_rc)
+      return "b.tex";
+   return "unknown";
+}
+
+}// namespace
+
+TEST(LoadTelemetryTest, FullBuffersKeepTheNewestEvents)
+{
+   LoadTelemetry telemetry(4);
+
+   const auto since = Clock::now();
+   for (int index = 0; index < 6; ++index) {
+      const auto start = since + index * 1ms;
+      telemetry.record("a.mat"_rc, static_cast<LoadPhase>(index % 4), start, start + 1ms);
+   }
+
+   const auto events = telemetry.events(since);
+   ASSERT_EQ(events.size(), 4);
+   EXPECT_EQ(events.front().start, since + 2ms);
+   EXPECT_EQ(events.front().phase, LoadPhase::Process);
+   EXPECT_EQ(events.back().start, since + 5ms);
+
+   EXPECT_EQ(telemetry.events(since + 4ms).size(), 2);
+}
+
+TEST(LoadTelemetryTest, ThreadsRecordToTheirOwnBuffers)
+{
+   LoadTelemetry telemetry(2);
+
+   const auto since = Clock::now();
+   const auto record = [&](const triglav::threading::ThreadID thread) {
+      triglav::threading::set_thread_id(thread);
+      for (int index = 0; index < 2; ++index) {
+         telemetry.record("b.tex"_rc, LoadPhase::Decode, since + thread * 1ms, since + thread * 1ms + 1ms);
+      }
+   };
+
+   std::thread first(record, 1);
+   std::thread second(record, 2);
+   first.join();
+   second.join();
+
+   // Neither thread overwrote the events of the other.
+   const auto events = telemetry.events(since);
+   ASSERT_EQ(events.size(), 4);
+   EXPECT_EQ(events[0].thread, 1);
+   EXPECT_EQ(events[1].thread, 1);
+   EXPECT_EQ(events[2].thread, 2);
+   EXPECT_EQ(events[3].thread, 2);
+}
+
+TEST(LoadTelemetryTest, ChromeTraceContainsPhasesAndDependencyWaits)
+{
+   LoadTelemetry telemetry(16);
+
+   const auto since = Clock::now();
+   telemetry.record("a.mat"_rc, LoadPhase::FileRead, since, since + 2ms);
+   telemetry.record("a.mat"_rc, LoadPhase::DependencyWait, since + 2ms, since + 5ms);
+
+   const auto trace = telemetry.chrome_trace(since, asset_name);
+   EXPECT_TRUE(trace.starts_with("{\"traceEvents\":["));
+   EXPECT_NE(trace.find(R"("name":"thread_name","ph":"M")"), std::string::npos);
+   EXPECT_NE(trace.find(R"("name":"file read a.mat","cat":"file read","ph":"X")"), std::string::npos);
+   EXPECT_NE(trace.find(R"("ts":0.000,"dur":2000.000)"), std::string::npos);
+   EXPECT_NE(trace.find(R"("name":"a.mat","cat":"dependency wait","ph":"b")"), std::string::npos);
+   EXPECT_NE(trace.find(R"("ph":"e")"), std::string::npos);
+   EXPECT_NE(trace.find(R"("ts":5000.000)"), std::string::npos);
+}
+
+TEST(LoadTelemetryTest, SummaryAddsUpPhasesPerType)
+{
+   LoadTelemetry telemetry(16);
+
+   const auto since = Clock::now();
+   telemetry.record("a.mat"_rc, LoadPhase::Decode, since, since + 2ms);
+   telemetry.record("a.mat"_rc, LoadPhase::Decode, since, since + 3ms);
+   telemetry.record("b.tex"_rc, LoadPhase::Upload, since, since + 4ms);
+
+   const auto summary = telemetry.summary(since);
+   EXPECT_NE(summary.find("Material"), std::string::npos);
+   EXPECT_NE(summary.find("Texture"), std::string::npos);
+   EXPECT_NE(summary.find("5.0 ms"), std::string::npos);
+   EXPECT_NE(summary.find("4.0 ms"), std::string::npos);
+}
+
+TEST(LoadTelemetryTest, PhasesAreRecordedForTheCurrentAsset)
+{
+   const auto since = Clock::now();
+
+   // Nothing is recorded without an asset being loaded.
+   {
+      const LoadPhaseScope phaseScope{LoadPhase::Decode};
+   }
+
+   {
+      const LoadAssetScope assetScope{"b.tex"_rc};
+      LoadPhaseScope phaseScope{LoadPhase::Decode};
+      phaseScope.next(LoadPhase::Upload);
+   }
+
+   const auto events = LoadTelemetry::the().events(since);
+   ASSERT_EQ(events.size(), 2);
+   EXPECT_EQ(events[0].asset, "b.tex"_rc);
+   EXPECT_EQ(events[0].phase, LoadPhase::Decode);
+   EXPECT_EQ(events[1].phase, LoadPhase::Upload);
+   EXPECT_EQ(events[0].end, events[1].start);
+}
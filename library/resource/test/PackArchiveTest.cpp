@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/AssetFile.h"
+#include "triglav/resource/PackArchive.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using triglav::MemorySize;
+using triglav::u8;
+using triglav::resource::AssetFile;
+using triglav::resource::g_packPayloadAlignment;
+using triglav::resource::PackArchive;
+using triglav::resource::PackCompression;
+using triglav::resource::PackWriter;
+using namespace triglav::name_literals;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class PackArchiveTest : public ::testing::Test
+{
+ protected:
+   void SetUp() override
+   {
+      const auto* unitTest = ::testing::UnitTest::GetInstance();
+      m_path = fs::temp_directory_path() / ("triglav_pack_archive_" + std::to_string(unitTest->random_seed()) + "_" +
+                                            unitTest->current_test_info()->name() + ".pack");
+   }
+
+   void TearDown() override
+   {
+      fs::remove(m_path);
+   }
+
+   [[nodiscard]] std::optional<PackArchive> write_archive(const PackWriter& writer) const
+   {
+      const auto data = writer.write();
+      {
+         std::ofstream file(m_path, std::ios::binary);
+         file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+      }
+      return PackArchive::open(triglav::io::Path{m_path.string()});
+   }
+
+   fs::path m_path;
+};
+
+std::vector<u8> make_data(const MemorySize size, const u8 seed)
+{
+   std::vector<u8> result(size);
+   for (MemorySize index = 0; index < size; ++index) {
+      result[index] = static_cast<u8>(seed + index * 7);
+   }
+   return result;
+}
+
+std::vector<u8> to_vector(const std::span<const u8> data)
+{
+   return {data.begin(), data.end()};
+}
+
+}// namespace
+
+TEST_F(PackArchiveTest, EntriesAreFoundByName)
+{
+   PackWriter writer;
+   writer.add("b.mat"_rc, "material/b.mat", make_data(100, 1), PackCompression::None);
+   writer.add("a.tex"_rc, "texture/a.ktx2", make_data(3000, 2), PackCompression::None);
+   writer.add("c.fshader"_rc, "shader/c.fspv", make_data(1, 3), PackCompression::None);
+
+   const auto archive = this->write_archive(writer);
+   ASSERT_TRUE(archive.has_value());
+   EXPECT_EQ(archive->entry_count(), 3);
+
+   const auto entry = archive->find("a.tex"_rc);
+   ASSERT_TRUE(entry.has_value());
+   EXPECT_EQ(entry->name, "a.tex"_rc);
+   EXPECT_EQ(entry->source, "texture/a.ktx2");
+   EXPECT_EQ(entry->compression, PackCompression::None);
+   EXPECT_EQ(to_vector(entry->data), make_data(3000, 2));
+   EXPECT_EQ(reinterpret_cast<std::uintptr_t>(entry->data.data()) % g_packPayloadAlignment, 0);
+
+   ASSERT_TRUE(archive->find("b.mat"_rc).has_value());
+   ASSERT_TRUE(archive->find("c.fshader"_rc).has_value());
+   EXPECT_FALSE(archive->find("d.mat"_rc).has_value());
+}
+
+TEST_F(PackArchiveTest, CompressedEntriesAreUnpacked)
+{
+   const std::vector<u8> compressible(10000, 'a');
+
+   PackWriter writer;
+   writer.add("a.mat"_rc, "material/a.mat", compressible, PackCompression::Deflate);
+   writer.add("b.mat"_rc, "material/b.mat", make_data(16, 4), PackCompression::Deflate);
+
+   const auto archive = this->write_archive(writer);
+   ASSERT_TRUE(archive.has_value());
+
+   const auto entry = archive->find("a.mat"_rc);
+   ASSERT_TRUE(entry.has_value());
+   EXPECT_EQ(entry->compression, PackCompression::Deflate);
+   EXPECT_LT(entry->data.size(), compressible.size());
+   EXPECT_EQ(PackArchive::unpack(*entry), compressible);
+
+   // Data that doesn't get smaller is stored as it is.
+   const auto smallEntry = archive->find("b.mat"_rc);
+   ASSERT_TRUE(smallEntry.has_value());
+   EXPECT_EQ(smallEntry->compression, PackCompression::None);
+
+   const AssetFile file{*entry};
+   EXPECT_TRUE(file.is_packed());
+   EXPECT_FALSE(file.path().has_value());
+   EXPECT_EQ(file.name(), "material/a.mat");
+   EXPECT_EQ(to_vector(file.read().bytes()), compressible);
+}
+
+TEST_F(PackArchiveTest, AddingANameAgainReplacesTheEntry)
+{
+   PackWriter writer;
+   writer.add("a.mat"_rc, "material/a.mat", make_data(10, 1), PackCompression::None);
+   writer.add("a.mat"_rc, "material/a2.mat", make_data(20, 2), PackCompression::None);
+
+   const auto archive = this->write_archive(writer);
+   ASSERT_TRUE(archive.has_value());
+   EXPECT_EQ(archive->entry_count(), 1);
+   EXPECT_EQ(archive->find("a.mat"_rc)->source, "material/a2.mat");
+}
+
+TEST_F(PackArchiveTest, InvalidArchivesAreRejected)
+{
+   EXPECT_FALSE(PackArchive::open(triglav::io::Path{m_path.string()}).has_value());
+
+   PackWriter writer;
+   writer.add("a.mat"_rc, "material/a.mat", make_data(100, 1), PackCompression::None);
+   auto data = writer.write();
+
+   // The index points past the end of a truncated archive.
+   data.resize(data.size() - 10);
+   {
+      std::ofstream file(m_path, std::ios::binary);
+      file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+   }
+   EXPECT_FALSE(PackArchive::open(triglav::io::Path{m_path.string()}).has_value());
+}
+
+TEST_F(PackArchiveTest, LooseFilesAreCountedWhenOpened)
+{
+   {
+      std::ofstream file(m_path, std::ios::binary);
+      file << "shader";
+   }
+
+   const auto openCount = AssetFile::loose_file_open_count();
+   const AssetFile file{triglav::io::Path{m_path.string()}};
+   EXPECT_FALSE(file.is_packed());
+   EXPECT_EQ(file.read().text(), "shader");
+   EXPECT_EQ(AssetFile::loose_file_open_count(), openCount + 1);
+}
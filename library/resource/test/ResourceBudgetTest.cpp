@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/ResourceBudget.h"
+#include "triglav/resource/RetireQueue.hpp"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+using triglav::MemorySize;
+using triglav::ResourceName;
+using triglav::ResourceType;
+using triglav::resource::ResourceBudget;
+using triglav::resource::RetireQueue;
+using namespace triglav::name_literals;
+
+namespace {
+
+// Stands in for the resource manager, loads resources of fixed sizes and keeps track of what is loaded.
+class MockLoader
+{
+ public:
+   explicit MockLoader(ResourceBudget& budget) :
+       m_budget(budget)
+   {
+   }
+
+   void load(const ResourceName name, const MemorySize size, const std::vector<ResourceName>& dependencies = {})
+   {
+      m_budget.add_dependencies(name, dependencies);
+      m_budget.add_resource(name, size);
+      m_loaded.emplace(name, size);
+   }
+
+   // Loads the resources referenced by the asset list.
+   void load_list(const std::vector<std::pair<ResourceName, MemorySize>>& assets)
+   {
+      for (const auto& [name, size] : assets) {
+         m_budget.acquire(name);
+         this->load(name, size);
+      }
+   }
+
+   std::vector<ResourceName> evict()
+   {
+      auto evicted = m_budget.collect_evictions();
+      for (const auto name : evicted) {
+         m_loaded.erase(name);
+      }
+      return evicted;
+   }
+
+   [[nodiscard]] bool is_loaded(const ResourceName name) const
+   {
+      return m_loaded.contains(name);
+   }
+
+ private:
+   ResourceBudget& m_budget;
+   std::map<ResourceName, MemorySize> m_loaded;
+};
+
+struct Tracked
+{
+   explicit Tracked(int& counter) :
+       counter(&counter)
+   {
+   }
+
+   Tracked(Tracked&& other) noexcept :
+       counter(std::exchange(other.counter, nullptr))
+   {
+   }
+
+   ~Tracked()
+   {
+      if (counter != nullptr) {
+         ++*counter;
+      }
+   }
+
+   int* counter;
+};
+
+}// namespace
+
+TEST(ResourceBudgetTest, ReferencedResourcesStayLoaded)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 0);
+   MockLoader loader(budget);
+
+   loader.load_list({{"a.tex"_rc, 100}, {"b.tex"_rc, 200}});
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 300);
+   EXPECT_TRUE(loader.evict().empty());
+
+   budget.release("a.tex"_rc);
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 1);
+   EXPECT_EQ(evicted[0], "a.tex"_rc);
+   EXPECT_FALSE(loader.is_loaded("a.tex"_rc));
+   EXPECT_TRUE(loader.is_loaded("b.tex"_rc));
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 200);
+}
+
+TEST(ResourceBudgetTest, BudgetsAreUnlimitedByDefault)
+{
+   ResourceBudget budget;
+   EXPECT_EQ(budget.budget(ResourceType::Texture), ResourceBudget::unlimited_budget);
+   MockLoader loader(budget);
+
+   loader.load_list({{"a.tex"_rc, 100}, {"b.tex"_rc, 200}});
+   budget.release("a.tex"_rc);
+   budget.release("b.tex"_rc);
+   EXPECT_TRUE(loader.evict().empty());
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 300);
+}
+
+TEST(ResourceBudgetTest, LeastRecentlyUsedIsEvictedFirst)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 250);
+   MockLoader loader(budget);
+
+   loader.load_list({{"a.tex"_rc, 100}, {"b.tex"_rc, 100}, {"c.tex"_rc, 100}});
+   budget.release("b.tex"_rc);
+   budget.release("a.tex"_rc);
+   budget.release("c.tex"_rc);
+
+   // C was released last, but the others are used again afterwards.
+   budget.mark_used("b.tex"_rc);
+   budget.mark_used("a.tex"_rc);
+
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 1);
+   EXPECT_EQ(evicted[0], "c.tex"_rc);
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 200);
+
+   budget.set_budget(ResourceType::Texture, 50);
+   const auto nextEvicted = loader.evict();
+   ASSERT_EQ(nextEvicted.size(), 2);
+   EXPECT_EQ(nextEvicted[0], "b.tex"_rc);
+   EXPECT_EQ(nextEvicted[1], "a.tex"_rc);
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 0);
+}
+
+TEST(ResourceBudgetTest, ResourcesMarkedTogetherKeepTheirOrder)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 150);
+   MockLoader loader(budget);
+
+   loader.load_list({{"a.tex"_rc, 100}, {"b.tex"_rc, 100}, {"c.tex"_rc, 100}});
+   budget.release("a.tex"_rc);
+   budget.release("b.tex"_rc);
+   budget.release("c.tex"_rc);
+
+   // A frame draws the first two, the one not drawn is evicted first.
+   const std::vector<ResourceName> used{"b.tex"_rc, "a.tex"_rc};
+   budget.mark_used(used);
+
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 2);
+   EXPECT_EQ(evicted[0], "c.tex"_rc);
+   EXPECT_EQ(evicted[1], "b.tex"_rc);
+   EXPECT_TRUE(loader.is_loaded("a.tex"_rc));
+}
+
+TEST(ResourceBudgetTest, BudgetsArePerType)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 1000);
+   budget.set_budget(ResourceType::Model, 100);
+   MockLoader loader(budget);
+
+   loader.load_list({{"a.tex"_rc, 500}, {"a.model"_rc, 80}, {"b.model"_rc, 80}});
+   budget.release("a.tex"_rc);
+   budget.release("a.model"_rc);
+   budget.release("b.model"_rc);
+
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 1);
+   EXPECT_EQ(evicted[0], "a.model"_rc);
+   EXPECT_TRUE(loader.is_loaded("a.tex"_rc));
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 500);
+   EXPECT_EQ(budget.used_size(ResourceType::Model), 80);
+}
+
+TEST(ResourceBudgetTest, DependenciesAreEvictedAfterDependents)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Material, 0);
+   budget.set_budget(ResourceType::MaterialTemplate, 0);
+   MockLoader loader(budget);
+
+   budget.acquire("a.mat"_rc);
+   loader.load("pbr.mt"_rc, 10);
+   loader.load("a.mat"_rc, 10, {"pbr.mt"_rc});
+   EXPECT_EQ(budget.reference_count("pbr.mt"_rc), 1);
+   EXPECT_TRUE(loader.evict().empty());
+
+   budget.release("a.mat"_rc);
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 2);
+   EXPECT_EQ(evicted[0], "a.mat"_rc);
+   EXPECT_EQ(evicted[1], "pbr.mt"_rc);
+}
+
+TEST(ResourceBudgetTest, ReferencedTextureOutlivesItsList)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 0);
+   budget.set_budget(ResourceType::Material, 0);
+   MockLoader loader(budget);
+
+   // The texture was loaded by another list than the material drawing with it.
+   loader.load_list({{"a.tex"_rc, 100}});
+   budget.acquire("a.mat"_rc);
+   loader.load("a.mat"_rc, 10);
+   const std::vector<ResourceName> references{"a.tex"_rc};
+   budget.set_references("a.mat"_rc, references);
+
+   budget.release("a.tex"_rc);
+   EXPECT_TRUE(loader.evict().empty());
+   EXPECT_TRUE(loader.is_loaded("a.tex"_rc));
+
+   budget.release("a.mat"_rc);
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 2);
+   EXPECT_EQ(evicted[0], "a.mat"_rc);
+   EXPECT_EQ(evicted[1], "a.tex"_rc);
+}
+
+TEST(ResourceBudgetTest, ReloadedResourceReplacesItsReferences)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 0);
+   MockLoader loader(budget);
+
+   loader.load("a.tex"_rc, 100);
+   loader.load("b.tex"_rc, 100);
+   budget.acquire("a.mat"_rc);
+   loader.load("a.mat"_rc, 10);
+
+   const std::vector<ResourceName> first{"a.tex"_rc, "b.tex"_rc};
+   budget.set_references("a.mat"_rc, first);
+   EXPECT_TRUE(loader.evict().empty());
+
+   // The reloaded material only uses the second texture.
+   const std::vector<ResourceName> second{"b.tex"_rc};
+   budget.set_references("a.mat"_rc, second);
+   EXPECT_EQ(budget.reference_count("b.tex"_rc), 1);
+
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 1);
+   EXPECT_EQ(evicted[0], "a.tex"_rc);
+}
+
+TEST(ResourceBudgetTest, ReleasedBeforeLoadedIsEvicted)
+{
+   ResourceBudget budget;
+   budget.set_budget(ResourceType::Texture, 0);
+   MockLoader loader(budget);
+
+   budget.acquire("a.tex"_rc);
+   budget.release("a.tex"_rc);
+   EXPECT_FALSE(budget.is_loaded("a.tex"_rc));
+
+   loader.load("a.tex"_rc, 100);
+   const auto evicted = loader.evict();
+   ASSERT_EQ(evicted.size(), 1);
+   EXPECT_FALSE(budget.is_loaded("a.tex"_rc));
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 0);
+}
+
+TEST(ResourceBudgetTest, ReloadedResourceChangesUsedSize)
+{
+   ResourceBudget budget;
+   MockLoader loader(budget);
+
+   loader.load_list({{"a.tex"_rc, 100}, {"b.tex"_rc, 200}});
+   budget.resize_resource("a.tex"_rc, 400);
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 600);
+
+   // Resources that aren't loaded have no size to update.
+   budget.resize_resource("c.tex"_rc, 50);
+   EXPECT_EQ(budget.used_size(ResourceType::Texture), 600);
+}
+
+TEST(RetireQueueTest, RetiredResourcesOutliveFramesInFlight)
+{
+   int destroyedCount{};
+   RetireQueue queue(3);
+
+   queue.retire(Tracked{destroyedCount});
+   queue.advance_frame();
+   queue.retire(Tracked{destroyedCount});
+   queue.advance_frame();
+   EXPECT_EQ(destroyedCount, 0);
+
+   queue.advance_frame();
+   EXPECT_EQ(destroyedCount, 1);
+   EXPECT_EQ(queue.size(), 1);
+
+   queue.advance_frame();
+   EXPECT_EQ(destroyedCount, 2);
+   EXPECT_EQ(queue.size(), 0);
+}
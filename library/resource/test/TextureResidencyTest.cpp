@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include "triglav/resource/TextureResidency.h"
+
+using triglav::MemorySize;
+using triglav::TextureName;
+using triglav::u32;
+using triglav::resource::TextureResidency;
+using triglav::resource::TextureResidencyRequest;
+using triglav::resource::TextureResidencySettings;
+using namespace triglav::name_literals;
+
+namespace {
+
+std::vector<MemorySize> level_sizes(const u32 width, const u32 height)
+{
+   std::vector<MemorySize> result;
+   for (u32 mipLevel = 0; (width >> mipLevel) > 0 || (height >> mipLevel) > 0; ++mipLevel) {
+      result.emplace_back(4 * static_cast<MemorySize>(std::max(width >> mipLevel, 1u)) * std::max(height >> mipLevel, 1u));
+   }
+   return result;
+}
+
+MemorySize size_from_mip(const u32 width, const u32 height, const u32 firstMip)
+{
+   const auto sizes = level_sizes(width, height);
+   MemorySize result{};
+   for (u32 mipLevel = firstMip; mipLevel < sizes.size(); ++mipLevel) {
+      result += sizes[mipLevel];
+   }
+   return result;
+}
+
+void finish_requests(TextureResidency& residency, const std::vector<TextureResidencyRequest>& requests)
+{
+   for (const auto& request : requests) {
+      residency.on_request_finished(request.name, request.firstMip);
+   }
+}
+
+constexpr auto g_texA = "a.tex"_rc;
+constexpr auto g_texB = "b.tex"_rc;
+constexpr auto g_texC = "c.tex"_rc;
+
+}// namespace
+
+TEST(TextureResidencyTest, OnlyTheTailIsInitiallyResident)
+{
+   TextureResidency residency(TextureResidencySettings{.tailDimension = 128});
+
+   EXPECT_EQ(residency.add_texture(g_texA, 1024, 1024, level_sizes(1024, 1024)), 3);
+   EXPECT_EQ(residency.add_texture(g_texB, 64, 64, level_sizes(64, 64)), 0);
+   EXPECT_EQ(residency.resident_size(), size_from_mip(1024, 1024, 3) + size_from_mip(64, 64, 0));
+   EXPECT_EQ(residency.committed_size(), residency.resident_size());
+
+   // Nothing is visible, so nothing is requested.
+   EXPECT_TRUE(residency.update().empty());
+}
+
+TEST(TextureResidencyTest, ScreenAreaSelectsTheMip)
+{
+   TextureResidency residency(TextureResidencySettings{.tailDimension = 128});
+   residency.add_texture(g_texA, 1024, 1024, level_sizes(1024, 1024));
+
+   residency.report_demand(g_texA, 256.0f * 256.0f);
+   residency.report_demand(g_texA, 64.0f * 64.0f);
+   const auto requests = residency.update();
+
+   ASSERT_EQ(requests.size(), 1);
+   EXPECT_EQ(requests[0].name, g_texA);
+   EXPECT_EQ(requests[0].firstMip, 2);
+   EXPECT_EQ(residency.committed_size(), size_from_mip(1024, 1024, 2));
+
+   // The request is in progress, it isn't issued again.
+   residency.report_demand(g_texA, 256.0f * 256.0f);
+   EXPECT_TRUE(residency.update().empty());
+
+   finish_requests(residency, requests);
+   EXPECT_EQ(residency.resident_mip(g_texA), 2);
+   EXPECT_EQ(residency.resident_size(), size_from_mip(1024, 1024, 2));
+
+   residency.report_demand(g_texA, 2048.0f * 2048.0f);
+   const auto fullRequests = residency.update();
+   ASSERT_EQ(fullRequests.size(), 1);
+   EXPECT_EQ(fullRequests[0].firstMip, 0);
+}
+
+TEST(TextureResidencyTest, LargerAreaIsStreamedFirst)
+{
+   TextureResidency residency(TextureResidencySettings{.tailDimension = 128});
+   residency.add_texture(g_texA, 512, 512, level_sizes(512, 512));
+   residency.add_texture(g_texB, 512, 512, level_sizes(512, 512));
+   residency.add_texture(g_texC, 512, 512, level_sizes(512, 512));
+
+   residency.report_demand(g_texA, 200.0f * 200.0f);
+   residency.report_demand(g_texB, 800.0f * 800.0f);
+   residency.report_demand(g_texC, 300.0f * 300.0f);
+   const auto requests = residency.update();
+
+   ASSERT_EQ(requests.size(), 3);
+   EXPECT_EQ(requests[0].name, g_texB);
+   EXPECT_EQ(requests[1].name, g_texC);
+   EXPECT_EQ(requests[2].name, g_texA);
+}
+
+TEST(TextureResidencyTest, BudgetEvictsLeastRecentlyUsed)
+{
+   const auto fullSize = size_from_mip(512, 512, 0);
+   const auto tailSize = size_from_mip(512, 512, 2);
+   TextureResidency residency(TextureResidencySettings{.budget = 2 * fullSize + tailSize, .tailDimension = 128});
+   residency.add_texture(g_texA, 512, 512, level_sizes(512, 512));
+   residency.add_texture(g_texB, 512, 512, level_sizes(512, 512));
+   residency.add_texture(g_texC, 512, 512, level_sizes(512, 512));
+
+   residency.report_demand(g_texA, 1024.0f * 1024.0f);
+   finish_requests(residency, residency.update());
+   residency.report_demand(g_texB, 1024.0f * 1024.0f);
+   finish_requests(residency, residency.update());
+   EXPECT_EQ(residency.resident_mip(g_texA), 0);
+   EXPECT_EQ(residency.resident_mip(g_texB), 0);
+
+   // A was used longer ago than B, so it gives up its levels for C.
+   residency.report_demand(g_texC, 1024.0f * 1024.0f);
+   const auto requests = residency.update();
+   ASSERT_EQ(requests.size(), 2);
+   EXPECT_EQ(requests[0].name, g_texA);
+   EXPECT_EQ(requests[0].firstMip, 2);
+   EXPECT_EQ(requests[1].name, g_texC);
+   EXPECT_EQ(requests[1].firstMip, 0);
+
+   finish_requests(residency, requests);
+   EXPECT_EQ(residency.resident_mip(g_texB), 0);
+   EXPECT_LE(residency.resident_size(), residency.settings().budget);
+}
+
+TEST(TextureResidencyTest, VisibleTexturesAreNotEvicted)
+{
+   const auto fullSize = size_from_mip(512, 512, 0);
+   const auto tailSize = size_from_mip(512, 512, 2);
+   const auto mip1Size = size_from_mip(512, 512, 1);
+   TextureResidency residency(TextureResidencySettings{.budget = fullSize + mip1Size, .tailDimension = 128});
+   residency.add_texture(g_texA, 512, 512, level_sizes(512, 512));
+   residency.add_texture(g_texB, 512, 512, level_sizes(512, 512));
+
+   residency.report_demand(g_texA, 1024.0f * 1024.0f);
+   finish_requests(residency, residency.update());
+   ASSERT_EQ(residency.resident_mip(g_texA), 0);
+
+   // Both are visible, B gets the most detailed levels that fit next to A.
+   residency.report_demand(g_texA, 1024.0f * 1024.0f);
+   residency.report_demand(g_texB, 1024.0f * 1024.0f);
+   const auto requests = residency.update();
+   ASSERT_EQ(requests.size(), 1);
+   EXPECT_EQ(requests[0].name, g_texB);
+   EXPECT_EQ(requests[0].firstMip, 1);
+   EXPECT_EQ(residency.committed_size(), fullSize + mip1Size);
+   EXPECT_GT(residency.committed_size(), fullSize + tailSize);
+}
+
+TEST(TextureResidencyTest, FailedRequestKeepsTheResidentLevels)
+{
+   TextureResidency residency(TextureResidencySettings{.tailDimension = 128});
+   residency.add_texture(g_texA, 1024, 1024, level_sizes(1024, 1024));
+
+   residency.report_demand(g_texA, 1024.0f * 1024.0f);
+   const auto requests = residency.update();
+   ASSERT_EQ(requests.size(), 1);
+
+   residency.on_request_finished(g_texA, 3);
+   EXPECT_EQ(residency.resident_mip(g_texA), 3);
+   EXPECT_EQ(residency.committed_size(), size_from_mip(1024, 1024, 3));
+   EXPECT_EQ(residency.pending_request_count(), 0);
+
+   residency.remove_texture(g_texA);
+   EXPECT_EQ(residency.committed_size(), 0);
+}
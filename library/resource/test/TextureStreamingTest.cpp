@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "triglav/graphics_api/Device.h"
+#include "triglav/resource/AssetFile.h"
+#include "triglav/resource/TextureLoader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using triglav::u32;
+using triglav::u8;
+using triglav::graphics_api::Device;
+using triglav::resource::AssetFile;
+using TextureLoader = triglav::resource::Loader<triglav::resource::ResourceType::Texture>;
+
+namespace ktx = triglav::ktx;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Cooked 64x64 texture on disk, each level holds a different pattern so reading the wrong range is noticed.
+class TextureStreamingTest : public ::testing::Test
+{
+ protected:
+   void SetUp() override
+   {
+      const auto* unitTest = ::testing::UnitTest::GetInstance();
+      m_path = fs::temp_directory_path() / ("triglav_texture_streaming_" + std::to_string(unitTest->random_seed()) + "_" +
+                                            unitTest->current_test_info()->name() + ".ktx2");
+
+      m_texture.format = ktx::Format::RGBA8_UNorm;
+      m_texture.width = 64;
+      m_texture.height = 64;
+      for (u32 mipLevel = 0; (64u >> mipLevel) > 0; ++mipLevel) {
+         const auto size = 4 * static_cast<std::size_t>(64u >> mipLevel) * (64u >> mipLevel);
+         auto& level = m_texture.levels.emplace_back(size);
+         for (std::size_t index = 0; index < size; ++index) {
+            level[index] = static_cast<u8>(31 * mipLevel + index * 7);
+         }
+      }
+
+      const auto data = ktx::write_ktx2(m_texture);
+      std::ofstream file(m_path, std::ios::binary);
+      file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+   }
+
+   void TearDown() override
+   {
+      fs::remove(m_path);
+   }
+
+   [[nodiscard]] AssetFile asset_file() const
+   {
+      return AssetFile{triglav::io::Path{m_path.string()}};
+   }
+
+   fs::path m_path;
+   ktx::Texture m_texture;
+};
+
+}// namespace
+
+TEST_F(TextureStreamingTest, ReadsLevelsFromTheFile)
+{
+   auto stream = this->asset_file().open();
+   ASSERT_TRUE(stream.has_value());
+
+   const auto header = TextureLoader::read_cooked_header(**stream);
+   ASSERT_TRUE(header.has_value());
+   ASSERT_EQ(header->levels.size(), m_texture.levels.size());
+
+   // The header was read from the start of the file, the levels are read from an offset past it.
+   for (const u32 firstMip : {2u, 0u, 5u}) {
+      const auto levels = TextureLoader::read_cooked_levels(**stream, *header, firstMip);
+      ASSERT_TRUE(levels.has_value());
+      EXPECT_EQ(levels->width, 64u >> firstMip);
+      EXPECT_EQ(levels->height, 64u >> firstMip);
+
+      ASSERT_EQ(levels->levels.size(), m_texture.levels.size() - firstMip);
+      for (u32 index = 0; index < levels->levels.size(); ++index) {
+         EXPECT_EQ(levels->levels[index], m_texture.levels[firstMip + index]) << "first mip " << firstMip << ", level " << index;
+      }
+   }
+}
+
+TEST_F(TextureStreamingTest, UploadsLevelsFromTheFile)
+{
+   const auto device = Device::create_null();
+
+   auto stream = this->asset_file().open();
+   ASSERT_TRUE(stream.has_value());
+   const auto header = TextureLoader::read_cooked_header(**stream);
+   ASSERT_TRUE(header.has_value());
+
+   const auto texture = TextureLoader::upload_cooked_levels(*device, **stream, *header, 3);
+   ASSERT_TRUE(texture.has_value());
+   EXPECT_EQ(texture->resolution().width, 8u);
+   EXPECT_EQ(texture->resolution().height, 8u);
+   EXPECT_EQ(texture->mip_count(), 4);
+
+   // The null device records the uploaded size, the upload fails if the range can't be read whole.
+   EXPECT_EQ(device->null_stats()->uploadCount.load(), 1u);
+   EXPECT_EQ(device->null_stats()->uploadSize.load(), TextureLoader::cooked_levels_size(*header, 3));
+}
@@ -3,6 +3,7 @@
 #include "LevelNode.h"
 
 #include <map>
+#include <vector>
 
 namespace triglav::world {
 
@@ -14,6 +15,10 @@ class Level
    LevelNode& at(Name id);
    LevelNode& root();
 
+   // Models and particle emitters placed by the nodes of the level, each listed once. The resource manager
+   // follows them to the materials and textures of the models.
+   [[nodiscard]] std::vector<ResourceName> referenced_assets() const;
+
  private:
    std::map<Name, LevelNode> m_nodes;
 };
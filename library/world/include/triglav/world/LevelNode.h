@@ -21,15 +21,24 @@ struct StaticMesh
    Transformation transform{};
 };
 
+struct ParticleEmitterInstance
+{
+   ParticleEmitterName emitterName{0};
+   glm::vec3 position{};
+};
+
 class LevelNode
 {
  public:
    void add_static_mesh(StaticMesh&& mesh);
+   void add_particle_emitter(ParticleEmitterInstance&& emitter);
 
-   const std::vector<StaticMesh>& static_meshes();
+   const std::vector<StaticMesh>& static_meshes() const;
+   const std::vector<ParticleEmitterInstance>& particle_emitters() const;
 
  private:
    std::vector<StaticMesh> m_staticMeshes;
+   std::vector<ParticleEmitterInstance> m_particleEmitters;
    std::vector<Name> m_children;
 };
 
@@ -1,5 +1,8 @@
 #include "Level.h"
 
+#include <algorithm>
+#include <ranges>
+
 namespace triglav::world {
 
 void Level::add_node(const Name id, LevelNode&& node)
@@ -12,6 +15,24 @@ LevelNode& Level::at(const Name id)
    return m_nodes.at(id);
 }
 
+std::vector<ResourceName> Level::referenced_assets() const
+{
+   std::vector<ResourceName> result;
+   for (const auto& node : m_nodes | std::views::values) {
+      for (const auto& mesh : node.static_meshes()) {
+         result.emplace_back(mesh.meshName);
+      }
+      for (const auto& emitter : node.particle_emitters()) {
+         result.emplace_back(emitter.emitterName);
+      }
+   }
+
+   std::ranges::sort(result);
+   const auto [first, last] = std::ranges::unique(result);
+   result.erase(first, last);
+   return result;
+}
+
 LevelNode& Level::root()
 {
    using namespace name_literals;
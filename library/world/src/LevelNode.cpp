@@ -7,9 +7,19 @@ void LevelNode::add_static_mesh(StaticMesh&& mesh)
    m_staticMeshes.emplace_back(mesh);
 }
 
-const std::vector<StaticMesh>& LevelNode::static_meshes()
+void LevelNode::add_particle_emitter(ParticleEmitterInstance&& emitter)
+{
+   m_particleEmitters.emplace_back(emitter);
+}
+
+const std::vector<StaticMesh>& LevelNode::static_meshes() const
 {
    return m_staticMeshes;
 }
 
+const std::vector<ParticleEmitterInstance>& LevelNode::particle_emitters() const
+{
+   return m_particleEmitters;
+}
+
 }// namespace triglav::world
\ No newline at end of file
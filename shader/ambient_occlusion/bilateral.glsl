@@ -0,0 +1,24 @@
+#ifndef BILATERAL_H
+#define BILATERAL_H
+
+layout(push_constant) uniform Constants
+{
+    // x - projection[3][2], y - projection[2][2], used to linearize depth.
+    vec2 depthParams;
+    ivec2 direction;
+} pc;
+
+const float g_relativeDepthTolerance = 0.05;
+
+float linear_depth(float depth)
+{
+    return pc.depthParams.x / (depth + pc.depthParams.y);
+}
+
+// Drops the weight of samples which lie on a different surface than the center.
+float depth_weight(float centerDepth, float sampleDepth)
+{
+    return exp(-abs(sampleDepth - centerDepth) / (g_relativeDepthTolerance * centerDepth));
+}
+
+#endif // BILATERAL_H
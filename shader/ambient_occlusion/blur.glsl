@@ -0,0 +1,33 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outAmbient;
+
+layout(binding = 0) uniform sampler2D texAmbientOcclusion;
+layout(binding = 1) uniform sampler2D texDepth;
+
+#include "bilateral.glsl"
+
+const float g_weights[5] = {0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216};
+
+void main() {
+    const ivec2 pixel = ivec2(gl_FragCoord.xy);
+    const ivec2 maxPixel = textureSize(texAmbientOcclusion, 0) - 1;
+    const float centerDepth = linear_depth(texelFetch(texDepth, pixel, 0).r);
+
+    float result = g_weights[0] * texelFetch(texAmbientOcclusion, pixel, 0).r;
+    float totalWeight = g_weights[0];
+    for (int i = 1; i < 5; ++i) {
+        for (int side = -1; side <= 1; side += 2) {
+            const ivec2 samplePixel = clamp(pixel + side * i * pc.direction, ivec2(0), maxPixel);
+            const float sampleDepth = linear_depth(texelFetch(texDepth, samplePixel, 0).r);
+            const float weight = g_weights[i] * depth_weight(centerDepth, sampleDepth);
+
+            result += weight * texelFetch(texAmbientOcclusion, samplePixel, 0).r;
+            totalWeight += weight;
+        }
+    }
+
+    outAmbient = vec4(result / totalWeight);
+}
@@ -0,0 +1,31 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out float outDepth;
+layout(location = 1) out vec2 outNormal;
+
+layout(binding = 0) uniform sampler2D texDepth;
+layout(binding = 1) uniform sampler2D texNormal;
+
+void main() {
+    const ivec2 srcPixel = 2 * ivec2(gl_FragCoord.xy);
+    const ivec2 maxPixel = textureSize(texDepth, 0) - 1;
+
+    // Keep the closest of the four source texels so edges don't blend foreground and background.
+    ivec2 closestPixel = srcPixel;
+    float closestDepth = 1.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            const ivec2 pixel = min(srcPixel + ivec2(x, y), maxPixel);
+            const float depth = texelFetch(texDepth, pixel, 0).r;
+            if (depth <= closestDepth) {
+                closestDepth = depth;
+                closestPixel = pixel;
+            }
+        }
+    }
+
+    outDepth = closestDepth;
+    outNormal = texelFetch(texNormal, closestPixel, 0).rg;
+}
@@ -4,26 +4,37 @@ layout(location = 0) in vec2 fragTexCoord;
 
 layout(location = 0) out vec4 outAmbient;
 
-layout(binding = 0) uniform sampler2D texPosition;
+layout(binding = 0) uniform sampler2D texDepth;
 layout(binding = 1) uniform sampler2D texNormal;
 layout(binding = 2) uniform sampler2D texNoise;
 
 layout(binding = 3) uniform AmbientOcclusionUBO {
     mat4 cameraProjection;
+    mat4 inverseCameraProjection;
     vec3 samplesSSAO[64];
 } ubo;
 
+#include "../common/gbuffer.glsl"
+
 const float radius = 1.2;
 
+vec3 sample_position(vec2 texCoord)
+{
+    // Kernel samples may project off screen, clamp them to the edge like the other passes reading the depth.
+    const ivec2 size = textureSize(texDepth, 0);
+    const ivec2 pixel = clamp(ivec2(texCoord * vec2(size)), ivec2(0), size - 1);
+    return position_from_depth(ubo.inverseCameraProjection, texCoord, texelFetch(texDepth, pixel, 0).r);
+}
+
 void main() {
-    vec3 normal = texture(texNormal, fragTexCoord).xyz;
-    if (normal == vec3(0.0, 0.0, 0.0)) {
+    vec2 encodedNormal = texelFetch(texNormal, ivec2(gl_FragCoord.xy), 0).rg;
+    if (is_unlit(encodedNormal)) {
         outAmbient = vec4(1);
         return;
     }
-    normal = normalize(normal);
+    vec3 normal = decode_normal(encodedNormal);
 
-    vec3 position = texture(texPosition, fragTexCoord).xyz;
+    vec3 position = sample_position(fragTexCoord);
 
     vec4 randomPixel = texture(texNoise, fragTexCoord * vec2(1.0, 0.6));
     vec3 randomVector = normalize(randomPixel.xyz * 2 - 1);
@@ -41,7 +52,7 @@ void main() {
         offset.xyz /= offset.w;
         offset.xyz = offset.xyz * 0.5 + 0.5;
 
-        vec3 occluderPos = texture(texPosition, offset.xy).xyz;
+        vec3 occluderPos = sample_position(offset.xy);
         float rangeCheck = smoothstep(0.0, 1.0, radius / length(position - occluderPos));
 
         occlusion += (occluderPos.z >= s.z + 0.1 ? rangeCheck : 0.0);
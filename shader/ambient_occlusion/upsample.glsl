@@ -0,0 +1,38 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outAmbient;
+
+layout(binding = 0) uniform sampler2D texAmbientOcclusion;
+layout(binding = 1) uniform sampler2D texLowDepth;
+layout(binding = 2) uniform sampler2D texDepth;
+
+#include "bilateral.glsl"
+
+void main() {
+    const float depth = linear_depth(texelFetch(texDepth, ivec2(gl_FragCoord.xy), 0).r);
+
+    const vec2 lowSize = vec2(textureSize(texAmbientOcclusion, 0));
+    const vec2 lowPosition = fragTexCoord * lowSize - 0.5;
+    const ivec2 basePixel = ivec2(floor(lowPosition));
+    const vec2 fraction = lowPosition - vec2(basePixel);
+    const ivec2 maxPixel = ivec2(lowSize) - 1;
+
+    // Bilinear weights of the four nearest low resolution texels, scaled by depth similarity.
+    float result = 0.0;
+    float totalWeight = 0.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            const ivec2 samplePixel = clamp(basePixel + ivec2(x, y), ivec2(0), maxPixel);
+            const float bilinear = (x == 0 ? 1.0 - fraction.x : fraction.x) * (y == 0 ? 1.0 - fraction.y : fraction.y);
+            const float sampleDepth = linear_depth(texelFetch(texLowDepth, samplePixel, 0).r);
+            const float weight = max(bilinear * depth_weight(depth, sampleDepth), 0.0001);
+
+            result += weight * texelFetch(texAmbientOcclusion, samplePixel, 0).r;
+            totalWeight += weight;
+        }
+    }
+
+    outAmbient = vec4(result / totalWeight);
+}
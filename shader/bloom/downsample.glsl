@@ -0,0 +1,101 @@
+#version 450
+
+// Reduces one level of the bloom pyramid. The high quality filter is the 13 tap filter from
+// "Next Generation Post Processing in Call of Duty: Advanced Warfare", the low quality filter
+// is the 5 tap dual filter.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D texSource;
+layout(binding = 1, rgba16f) uniform writeonly image2D outLevel;
+
+layout(push_constant) uniform Constants
+{
+    ivec2 targetSize;
+    uint highQuality;
+    uint isFirstLevel;
+} pc;
+
+vec2 g_texelSize;
+vec2 g_minCoord;
+vec2 g_maxCoord;
+
+// The bloom attachment stores the intensity in the alpha channel.
+vec3 sample_source(vec2 coord)
+{
+    vec4 value = textureLod(texSource, clamp(coord, g_minCoord, g_maxCoord), 0.0);
+    return pc.isFirstLevel != 0u ? value.rgb * value.a : value.rgb;
+}
+
+// Weights the first level by the inverse luminance to keep single bright pixels from flickering.
+float karis_weight(vec3 color)
+{
+    return 1.0 / (1.0 + dot(color, vec3(0.2126, 0.7152, 0.0722)));
+}
+
+// Weighted sum of the 2x2 groups of the 13 tap filter.
+vec3 karis_average(vec3 groups[5])
+{
+    const float coefs[5] = float[](0.5, 0.125, 0.125, 0.125, 0.125);
+
+    vec3 sum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        float weight = coefs[i] * karis_weight(groups[i]);
+        sum += groups[i] * weight;
+        weightSum += weight;
+    }
+    return sum / weightSum;
+}
+
+vec3 downsample_13_tap(vec2 coord)
+{
+    vec3 a = sample_source(coord + g_texelSize * vec2(-2.0, 2.0));
+    vec3 b = sample_source(coord + g_texelSize * vec2(0.0, 2.0));
+    vec3 c = sample_source(coord + g_texelSize * vec2(2.0, 2.0));
+    vec3 d = sample_source(coord + g_texelSize * vec2(-2.0, 0.0));
+    vec3 e = sample_source(coord);
+    vec3 f = sample_source(coord + g_texelSize * vec2(2.0, 0.0));
+    vec3 g = sample_source(coord + g_texelSize * vec2(-2.0, -2.0));
+    vec3 h = sample_source(coord + g_texelSize * vec2(0.0, -2.0));
+    vec3 i = sample_source(coord + g_texelSize * vec2(2.0, -2.0));
+    vec3 j = sample_source(coord + g_texelSize * vec2(-1.0, 1.0));
+    vec3 k = sample_source(coord + g_texelSize * vec2(1.0, 1.0));
+    vec3 l = sample_source(coord + g_texelSize * vec2(-1.0, -1.0));
+    vec3 m = sample_source(coord + g_texelSize * vec2(1.0, -1.0));
+
+    if (pc.isFirstLevel != 0u) {
+        vec3 groups[5] = vec3[](0.25 * (j + k + l + m), 0.25 * (a + b + d + e), 0.25 * (b + c + e + f), 0.25 * (d + e + g + h),
+                                0.25 * (e + f + h + i));
+        return karis_average(groups);
+    }
+
+    return e * 0.125 + (a + c + g + i) * 0.03125 + (b + d + f + h) * 0.0625 + (j + k + l + m) * 0.125;
+}
+
+vec3 downsample_dual(vec2 coord)
+{
+    vec3 center = sample_source(coord);
+    vec3 a = sample_source(coord + g_texelSize * vec2(-1.0, 1.0));
+    vec3 b = sample_source(coord + g_texelSize * vec2(1.0, 1.0));
+    vec3 c = sample_source(coord + g_texelSize * vec2(-1.0, -1.0));
+    vec3 d = sample_source(coord + g_texelSize * vec2(1.0, -1.0));
+
+    return (center * 4.0 + a + b + c + d) * 0.125;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, pc.targetSize)))
+        return;
+
+    g_texelSize = 1.0 / vec2(textureSize(texSource, 0));
+    g_minCoord = 0.5 * g_texelSize;
+    g_maxCoord = 1.0 - 0.5 * g_texelSize;
+
+    vec2 coord = (vec2(pixel) + 0.5) / vec2(pc.targetSize);
+    vec3 color = pc.highQuality != 0u ? downsample_13_tap(coord) : downsample_dual(coord);
+
+    imageStore(outLevel, pixel, vec4(color, 1.0));
+}
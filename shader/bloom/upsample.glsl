@@ -0,0 +1,62 @@
+#version 450
+
+// Accumulates the lower level of the bloom pyramid into the current one. The high quality filter
+// is a 9 tap tent, the low quality filter is the 8 tap dual filter.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D texLower;
+layout(binding = 1) uniform sampler2D texCurrent;
+layout(binding = 2, rgba16f) uniform writeonly image2D outLevel;
+
+layout(push_constant) uniform Constants
+{
+    ivec2 targetSize;
+    uint highQuality;
+    float scale;
+} pc;
+
+vec2 g_minCoord;
+vec2 g_maxCoord;
+
+vec3 sample_lower(vec2 coord)
+{
+    return textureLod(texLower, clamp(coord, g_minCoord, g_maxCoord), 0.0).rgb;
+}
+
+vec3 upsample_tent(vec2 coord, vec2 texelSize)
+{
+    vec3 result = sample_lower(coord) * 4.0;
+    result += (sample_lower(coord + texelSize * vec2(0.0, 1.0)) + sample_lower(coord + texelSize * vec2(0.0, -1.0)) +
+               sample_lower(coord + texelSize * vec2(1.0, 0.0)) + sample_lower(coord + texelSize * vec2(-1.0, 0.0))) * 2.0;
+    result += sample_lower(coord + texelSize * vec2(-1.0, 1.0)) + sample_lower(coord + texelSize * vec2(1.0, 1.0)) +
+              sample_lower(coord + texelSize * vec2(-1.0, -1.0)) + sample_lower(coord + texelSize * vec2(1.0, -1.0));
+    return result / 16.0;
+}
+
+vec3 upsample_dual(vec2 coord, vec2 texelSize)
+{
+    vec3 result = sample_lower(coord + texelSize * vec2(-1.0, 0.0)) + sample_lower(coord + texelSize * vec2(1.0, 0.0)) +
+                  sample_lower(coord + texelSize * vec2(0.0, 1.0)) + sample_lower(coord + texelSize * vec2(0.0, -1.0));
+    result += (sample_lower(coord + texelSize * vec2(-0.5, 0.5)) + sample_lower(coord + texelSize * vec2(0.5, 0.5)) +
+               sample_lower(coord + texelSize * vec2(-0.5, -0.5)) + sample_lower(coord + texelSize * vec2(0.5, -0.5))) * 2.0;
+    return result / 12.0;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, pc.targetSize)))
+        return;
+
+    vec2 lowerTexelSize = 1.0 / vec2(textureSize(texLower, 0));
+    g_minCoord = 0.5 * lowerTexelSize;
+    g_maxCoord = 1.0 - 0.5 * lowerTexelSize;
+
+    vec2 coord = (vec2(pixel) + 0.5) / vec2(pc.targetSize);
+    vec2 texelSize = 1.0 / vec2(pc.targetSize);
+    vec3 lower = pc.highQuality != 0u ? upsample_tent(coord, lowerTexelSize) : upsample_dual(coord, texelSize);
+    vec3 current = texelFetch(texCurrent, pixel, 0).rgb;
+
+    imageStore(outLevel, pixel, vec4((lower + current) * pc.scale, 1.0));
+}
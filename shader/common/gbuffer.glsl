@@ -0,0 +1,64 @@
+#ifndef GBUFFER_H
+#define GBUFFER_H
+
+// Encoded normal of surfaces which should not be lit (sky, debug lines).
+// It decodes to a normal pointing away from the camera, which is never visible.
+const vec2 g_unlitNormal = vec2(0.0, 0.0);
+
+vec2 octahedral_wrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Packs a unit normal into a RG16 UNORM target using octahedral encoding.
+vec2 encode_normal(vec3 normal)
+{
+    normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+    normal.xy = normal.z >= 0.0 ? normal.xy : octahedral_wrap(normal.xy);
+    return normal.xy * 0.5 + 0.5;
+}
+
+vec3 decode_normal(vec2 encoded)
+{
+    encoded = encoded * 2.0 - 1.0;
+    vec3 normal = vec3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = clamp(-normal.z, 0.0, 1.0);
+    normal.x += normal.x >= 0.0 ? -t : t;
+    normal.y += normal.y >= 0.0 ? -t : t;
+    return normalize(normal);
+}
+
+// Tangent space normal of a normal map texel. Cooked normal maps only store the x and y components.
+vec3 decode_normal_map(vec2 texel)
+{
+    vec2 xy = 2.0 * texel - 1.0;
+    return vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+}
+
+bool is_unlit(vec2 encodedNormal)
+{
+    return encodedNormal == g_unlitNormal;
+}
+
+// Packs roughness and metallic with 8 bits each into a single UNORM16 channel.
+float pack_material(float roughness, float metallic)
+{
+    uint roughnessBits = uint(round(clamp(roughness, 0.0, 1.0) * 255.0));
+    uint metallicBits = uint(round(clamp(metallic, 0.0, 1.0) * 255.0));
+    return float((roughnessBits << 8) | metallicBits) / 65535.0;
+}
+
+vec2 unpack_material(float packed)
+{
+    uint bits = uint(round(packed * 65535.0));
+    return vec2(float(bits >> 8), float(bits & 0xFFu)) / 255.0;
+}
+
+// Reconstructs the view space position from the depth buffer value.
+vec3 position_from_depth(mat4 inverseProjection, vec2 texCoord, float depth)
+{
+    vec4 position = inverseProjection * vec4(texCoord * 2.0 - 1.0, depth, 1.0);
+    return position.xyz / position.w;
+}
+
+#endif // GBUFFER_H
@@ -1,11 +1,11 @@
 #version 450
 
 layout(location = 0) out vec4 outColor;
-layout(location = 1) out vec4 outPosition;
-layout(location = 2) out vec4 outNormal;
+layout(location = 1) out vec2 outNormal;
+
+#include "../common/gbuffer.glsl"
 
 void main() {
     outColor = vec4(1, 0, 0, 1);
-    outPosition = vec4(0, 0, 0, 1);
-    outNormal = vec4(0, 0, 0, 1);
+    outNormal = g_unlitNormal;
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 450
+
+layout(location = 0) in vec3 inPosition;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+invariant gl_Position;
+
+void main() {
+    vec4 viewSpace = ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * viewSpace;
+}
\ No newline at end of file
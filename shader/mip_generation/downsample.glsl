@@ -0,0 +1,146 @@
+#version 450
+
+#extension GL_EXT_shader_image_load_formatted : require
+
+#include "filter.glsl"
+
+// Each workgroup reduces a 64x64 tile of the input down to six levels. When more levels are requested,
+// the last workgroup to finish continues from the sixth level, so a single dispatch covers up to 12 levels.
+// The continuation only reduces the first 64x64 tile of the sixth level, which covers inputs up to 4096 pixels.
+// MipMapGenerator splits larger inputs into two dispatches.
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(binding = 0) uniform sampler2D texSource;
+
+layout(std430, binding = 1) coherent buffer Counter {
+    uint finishedWorkgroups;
+};
+
+// Output levels, level 0 is half the size of the source.
+layout(binding = 2) uniform coherent image2D mipLevels[12];
+
+layout(push_constant) uniform Constants
+{
+    ivec2 sourceSize;
+    uint mipCount;
+    uint workgroupCount;
+    uint filterType;
+    uint isSrgb;
+} pc;
+
+const uint g_levelsPerPass = 6u;
+
+shared vec4 s_tile[16][16];
+shared uint s_isLastWorkgroup;
+
+ivec2 mip_size(uint level)
+{
+    return max(pc.sourceSize >> int(level + 1u), ivec2(1));
+}
+
+// Reads the input of the given output level, edge texels are repeated outside of the image.
+vec4 load_input(uint level, ivec2 coord)
+{
+    if (level == 0u) {
+        return mip_decode(texelFetch(texSource, min(coord, pc.sourceSize - 1), 0), pc.filterType, pc.isSrgb != 0u);
+    }
+    return mip_decode(imageLoad(mipLevels[level - 1u], min(coord, mip_size(level - 1u) - 1)), pc.filterType, pc.isSrgb != 0u);
+}
+
+void store_output(uint level, ivec2 coord, vec4 value)
+{
+    if (level < pc.mipCount && all(lessThan(coord, mip_size(level)))) {
+        imageStore(mipLevels[level], coord, mip_encode(value, pc.filterType, pc.isSrgb != 0u));
+    }
+}
+
+vec4 reduce_input(uint level, ivec2 coord)
+{
+    const ivec2 inputCoord = 2 * coord;
+    return mip_reduce(load_input(level, inputCoord), load_input(level, inputCoord + ivec2(1, 0)),
+                      load_input(level, inputCoord + ivec2(0, 1)), load_input(level, inputCoord + ivec2(1, 1)), pc.filterType);
+}
+
+// Texels past the edge of the level are replaced with the edge texel, same as the clamped loads.
+vec4 load_tile(ivec2 coord, ivec2 lastValid)
+{
+    const ivec2 clamped = min(coord, lastValid);
+    return s_tile[clamped.y][clamped.x];
+}
+
+void reduce_tile(ivec2 workgroup, ivec2 thread, uint baseLevel)
+{
+    // Each thread writes a 2x2 quad of the first level and reduces it for the second one.
+    const ivec2 quadCoord = workgroup * 32 + thread * 2;
+    vec4 quad[4];
+    for (int i = 0; i < 4; ++i) {
+        const ivec2 coord = quadCoord + ivec2(i & 1, i >> 1);
+        quad[i] = reduce_input(baseLevel, coord);
+        store_output(baseLevel, coord, quad[i]);
+    }
+
+    const ivec2 lastQuadTexel = mip_size(baseLevel) - 1;
+    if (quadCoord.x + 1 > lastQuadTexel.x) {
+        quad[1] = quad[0];
+        quad[3] = quad[2];
+    }
+    if (quadCoord.y + 1 > lastQuadTexel.y) {
+        quad[2] = quad[0];
+        quad[3] = quad[1];
+    }
+
+    vec4 value = mip_reduce(quad[0], quad[1], quad[2], quad[3], pc.filterType);
+    store_output(baseLevel + 1u, workgroup * 16 + thread, value);
+    s_tile[thread.y][thread.x] = value;
+
+    for (uint level = 2u; level < g_levelsPerPass; ++level) {
+        barrier();
+
+        const int tileSize = 32 >> level;
+        const ivec2 previousSize = mip_size(baseLevel + level - 1u);
+        const ivec2 lastValid = max(min(ivec2(2 * tileSize - 1), previousSize - 1 - workgroup * 2 * tileSize), ivec2(0));
+        const bool isActive = all(lessThan(thread, ivec2(tileSize)));
+        if (isActive) {
+            const ivec2 coord = 2 * thread;
+            value = mip_reduce(load_tile(coord, lastValid), load_tile(coord + ivec2(1, 0), lastValid),
+                               load_tile(coord + ivec2(0, 1), lastValid), load_tile(coord + ivec2(1, 1), lastValid), pc.filterType);
+            store_output(baseLevel + level, workgroup * tileSize + thread, value);
+        }
+
+        barrier();
+
+        if (isActive) {
+            s_tile[thread.y][thread.x] = value;
+        }
+    }
+}
+
+void main()
+{
+    const ivec2 thread = ivec2(gl_LocalInvocationID.xy);
+    reduce_tile(ivec2(gl_WorkGroupID.xy), thread, 0u);
+
+    if (pc.mipCount <= g_levelsPerPass)
+        return;
+
+    // Make the writes of this workgroup visible before it's counted as finished.
+    memoryBarrier();
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0u) {
+        s_isLastWorkgroup = atomicAdd(finishedWorkgroups, 1u) == pc.workgroupCount - 1u ? 1u : 0u;
+    }
+    barrier();
+
+    if (s_isLastWorkgroup == 0u)
+        return;
+
+    // The counter is reused by later dispatches.
+    if (gl_LocalInvocationIndex == 0u) {
+        finishedWorkgroups = 0u;
+    }
+    memoryBarrier();
+
+    reduce_tile(ivec2(0), thread, g_levelsPerPass);
+}
@@ -0,0 +1,69 @@
+#ifndef MIP_GENERATION_FILTER_H
+#define MIP_GENERATION_FILTER_H
+
+// Also compiled by the CPU reference in graphics_api, keep to the subset of GLSL that is valid C++.
+
+const uint g_mipFilterAverage = 0u;
+const uint g_mipFilterNormalMap = 1u;
+const uint g_mipFilterMin = 2u;
+const uint g_mipFilterMax = 3u;
+
+float mip_srgb_to_linear(float value)
+{
+    if (value <= 0.04045f) {
+        return value / 12.92f;
+    }
+    return pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float mip_linear_to_srgb(float value)
+{
+    if (value <= 0.0031308f) {
+        return value * 12.92f;
+    }
+    return 1.055f * pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// Converts a stored texel to the space the reduction operates in.
+vec4 mip_decode(vec4 texel, uint filterType, bool isSrgb)
+{
+    if (filterType == g_mipFilterNormalMap) {
+        // Z is reconstructed so two channel normal maps, which sample a zero blue channel, filter the same way.
+        const float x = 2.0f * texel.x - 1.0f;
+        const float y = 2.0f * texel.y - 1.0f;
+        return vec4(x, y, sqrt(max(1.0f - x * x - y * y, 0.0f)), texel.w);
+    }
+    if (isSrgb) {
+        return vec4(mip_srgb_to_linear(texel.x), mip_srgb_to_linear(texel.y), mip_srgb_to_linear(texel.z), texel.w);
+    }
+    return texel;
+}
+
+vec4 mip_reduce(vec4 a, vec4 b, vec4 c, vec4 d, uint filterType)
+{
+    if (filterType == g_mipFilterMin) {
+        return min(min(a, b), min(c, d));
+    }
+    if (filterType == g_mipFilterMax) {
+        return max(max(a, b), max(c, d));
+    }
+    return 0.25f * (a + b + c + d);
+}
+
+// Converts a reduced value back to the stored representation.
+// Normals are averaged unnormalized through the whole chain and only renormalized when stored.
+vec4 mip_encode(vec4 value, uint filterType, bool isSrgb)
+{
+    if (filterType == g_mipFilterNormalMap) {
+        vec3 normal = vec3(value.x, value.y, value.z);
+        const float lengthSq = dot(normal, normal);
+        normal = lengthSq > 0.0f ? normal / sqrt(lengthSq) : vec3(0.0f, 0.0f, 1.0f);
+        return vec4(0.5f * normal.x + 0.5f, 0.5f * normal.y + 0.5f, 0.5f * normal.z + 0.5f, value.w);
+    }
+    if (isSrgb) {
+        return vec4(mip_linear_to_srgb(value.x), mip_linear_to_srgb(value.y), mip_linear_to_srgb(value.z), value.w);
+    }
+    return value;
+}
+
+#endif // MIP_GENERATION_FILTER_H
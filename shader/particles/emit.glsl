@@ -0,0 +1,52 @@
+#version 450
+
+#include "simulation.glsl"
+
+layout(std430, binding = 0) readonly buffer Emitters {
+    ParticleEmitter emitters[];
+};
+
+layout(std430, binding = 1) writeonly buffer Particles {
+    Particle particles[];
+};
+
+layout(std430, binding = 2) writeonly buffer Alive {
+    uint alive[];
+};
+
+layout(std430, binding = 3) readonly buffer Dead {
+    uint dead[];
+};
+
+layout(std430, binding = 4) buffer Counters {
+    ParticleCounters counters;
+};
+
+layout(push_constant) uniform Constants
+{
+    uint spawnCount;
+    uint emitterCount;
+} pc;
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+// One invocation per requested particle, slots are taken from the end of the dead list.
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    uint deadCount = counters.deadCount;
+    if (index >= pc.spawnCount || index >= deadCount) {
+        return;
+    }
+
+    uint emitterIndex = 0;
+    while (emitterIndex + 1 < pc.emitterCount && index >= emitters[emitterIndex].spawn.x + emitters[emitterIndex].spawn.y) {
+        ++emitterIndex;
+    }
+
+    ParticleEmitter emitter = emitters[emitterIndex];
+    uint slot = dead[deadCount - 1 - index];
+
+    particles[slot] = spawn_particle(emitter, particle_seed(emitter.spawn.z, index - emitter.spawn.x));
+    alive[atomicAdd(counters.aliveCount, 1)] = slot;
+}
@@ -0,0 +1,45 @@
+#version 450
+
+#include "particle.glsl"
+
+layout(std430, binding = 0) buffer Counters {
+    ParticleCounters counters;
+};
+
+layout(std430, binding = 1) writeonly buffer DrawCall {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+} drawCall;
+
+layout(std430, binding = 2) writeonly buffer SimulateDispatch {
+    uint groupCountX;
+    uint groupCountY;
+    uint groupCountZ;
+} simulateDispatch;
+
+layout(push_constant) uniform Constants
+{
+    uint spawnCount;
+} pc;
+
+layout (local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+
+// Local size of the simulate shader.
+const uint g_simulateGroupSize = 256u;
+
+void main()
+{
+    counters.deadCount -= min(pc.spawnCount, counters.deadCount);
+
+    drawCall.vertexCount = 4;
+    drawCall.instanceCount = counters.aliveCount;
+    drawCall.firstVertex = 0;
+    drawCall.firstInstance = 0;
+
+    // The next frame simulates the particles alive now.
+    simulateDispatch.groupCountX = (counters.aliveCount + g_simulateGroupSize - 1) / g_simulateGroupSize;
+    simulateDispatch.groupCountY = 1;
+    simulateDispatch.groupCountZ = 1;
+}
@@ -7,8 +7,13 @@ layout(location = 0) out vec4 outColor;
 layout(location = 1) out vec4 outBloom;
 
 layout(binding = 2) uniform sampler2D texSampler;
+layout(binding = 3) uniform sampler2D texDepth;
 
 void main() {
+    if (gl_FragCoord.z > texelFetch(texDepth, ivec2(gl_FragCoord.xy), 0).r) {
+        discard;
+    }
+
     outColor = texture(texSampler, fragTexCoord).rgba;
     outColor.rgb *= vec3(1.0, 0.1, 0.1) * fragAnimation + vec3(1.0, 1.0, 0.1) * (1.0 - fragAnimation);
     outBloom = outColor;
@@ -1,13 +1,26 @@
 #ifndef PARTICLE_H
 #define PARTICLE_H
 
+// Included by the CPU reference simulation as well,
+// keep to the subset of GLSL that also compiles as C++.
+
 struct Particle {
-    vec3 position;
-    vec3 velocity;
-    float animation;
-    float rotation;
-    float angularVelocity;
-    float scale;
+    vec4 position;   // w: age in seconds
+    vec4 velocity;   // w: lifetime in seconds
+    vec4 properties; // x: rotation, y: angular velocity, z: scale, w: gravity
+};
+
+struct ParticleEmitter {
+    vec4 position;   // w: unused
+    vec4 extent;     // half extent of the spawn box, w: lifetime
+    vec4 velocity;   // w: velocity randomness
+    vec4 properties; // x: lifetime randomness, y: angular velocity, z: scale, w: gravity
+    uvec4 spawn;     // x: first spawn index, y: spawn count, z: seed
+};
+
+struct ParticleCounters {
+    uint aliveCount;
+    uint deadCount;
 };
 
 #endif // PARTICLE_H
@@ -0,0 +1,20 @@
+#version 450
+
+#include "particle.glsl"
+
+layout(std430, binding = 0) readonly buffer PrevCounters {
+    ParticleCounters prevCounters;
+};
+
+layout(std430, binding = 1) writeonly buffer Counters {
+    ParticleCounters counters;
+};
+
+layout (local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+
+// The dead list is shared by all the frames, its count carries over from the previous frame.
+void main()
+{
+    counters.aliveCount = 0;
+    counters.deadCount = prevCounters.deadCount;
+}
@@ -0,0 +1,58 @@
+#version 450
+
+#include "simulation.glsl"
+
+layout(std430, binding = 0) readonly buffer PrevParticles {
+    Particle prevParticles[];
+};
+
+layout(std430, binding = 1) readonly buffer PrevAlive {
+    uint prevAlive[];
+};
+
+layout(std430, binding = 2) readonly buffer PrevCounters {
+    ParticleCounters prevCounters;
+};
+
+layout(std430, binding = 3) writeonly buffer Particles {
+    Particle particles[];
+};
+
+layout(std430, binding = 4) writeonly buffer Alive {
+    uint alive[];
+};
+
+layout(std430, binding = 5) writeonly buffer Dead {
+    uint dead[];
+};
+
+layout(std430, binding = 6) buffer Counters {
+    ParticleCounters counters;
+};
+
+layout(push_constant) uniform Constants
+{
+    float deltaTime;
+} pc;
+
+layout (local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+// One invocation per previously alive particle, the group count is written by the previous frame's finalize.
+// Expired slots are pushed on top of the dead list.
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= prevCounters.aliveCount) {
+        return;
+    }
+
+    uint slot = prevAlive[index];
+    Particle particle = update_particle(prevParticles[slot], pc.deltaTime);
+
+    if (is_particle_alive(particle)) {
+        particles[slot] = particle;
+        alive[atomicAdd(counters.aliveCount, 1)] = slot;
+    } else {
+        dead[atomicAdd(counters.deadCount, 1)] = slot;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef PARTICLE_SIMULATION_H
+#define PARTICLE_SIMULATION_H
+
+#include "particle.glsl"
+
+// Also compiled by the CPU reference simulation, see particle.glsl.
+
+const float g_particleGroundLevel = -0.5f;
+const float g_particleBounceDamping = 0.5f;
+const float g_particleFullAngle = 6.2831853f;
+
+uint particle_hash(uint value)
+{
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+// Uniform value in [0, 1), only 24 bits are used so the result is exact in single precision.
+float particle_random(uint seed, uint index)
+{
+    return float(particle_hash(seed ^ particle_hash(index)) >> 8u) / 16777216.0f;
+}
+
+float particle_random_signed(uint seed, uint index)
+{
+    return 2.0f * particle_random(seed, index) - 1.0f;
+}
+
+uint particle_seed(uint seed, uint index)
+{
+    return particle_hash(seed + index * 2654435769u);
+}
+
+Particle spawn_particle(ParticleEmitter emitter, uint seed)
+{
+    float randomness = emitter.velocity.w;
+    float lifetime = emitter.extent.w * (1.0f + emitter.properties.x * particle_random_signed(seed, 6u));
+
+    Particle particle;
+    particle.position = vec4(emitter.position.x + emitter.extent.x * particle_random_signed(seed, 0u),
+                             emitter.position.y + emitter.extent.y * particle_random_signed(seed, 1u),
+                             emitter.position.z + emitter.extent.z * particle_random_signed(seed, 2u),
+                             0.0f);
+    particle.velocity = vec4(emitter.velocity.x + randomness * particle_random_signed(seed, 3u),
+                             emitter.velocity.y + randomness * particle_random_signed(seed, 4u),
+                             emitter.velocity.z + randomness * particle_random_signed(seed, 5u),
+                             lifetime);
+    particle.properties = vec4(g_particleFullAngle * particle_random(seed, 7u),
+                               emitter.properties.y * particle_random_signed(seed, 8u),
+                               emitter.properties.z * (0.5f + particle_random(seed, 9u)),
+                               emitter.properties.w);
+    return particle;
+}
+
+Particle update_particle(Particle particle, float deltaTime)
+{
+    // Up is -Z, gravity pulls towards the ground at positive Z.
+    particle.velocity.z += particle.properties.w * deltaTime;
+
+    particle.position.x += particle.velocity.x * deltaTime;
+    particle.position.y += particle.velocity.y * deltaTime;
+    particle.position.z += particle.velocity.z * deltaTime;
+    particle.position.w += deltaTime;
+    particle.properties.x += particle.properties.y * deltaTime;
+
+    if (particle.position.z > g_particleGroundLevel) {
+        particle.position.z = g_particleGroundLevel;
+        particle.velocity.z = -g_particleBounceDamping * particle.velocity.z;
+    }
+
+    return particle;
+}
+
+bool is_particle_alive(Particle particle)
+{
+    return particle.position.w < particle.velocity.w;
+}
+
+#endif // PARTICLE_SIMULATION_H
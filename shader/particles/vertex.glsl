@@ -10,8 +10,12 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
-layout(std140, binding = 1) readonly buffer Particles {
-    Particle particlesIn[];
+layout(std430, binding = 1) readonly buffer Particles {
+    Particle particles[];
+};
+
+layout(std430, binding = 4) readonly buffer Alive {
+    uint alive[];
 };
 
 vec2 g_positions[4] = {
@@ -23,20 +27,24 @@ vec2 g_positions[4] = {
 
 void main() {
     const vec2 point = g_positions[gl_VertexIndex];
-    const Particle particle = particlesIn[gl_InstanceIndex];
+    const Particle particle = particles[alive[gl_InstanceIndex]];
+
+    float rotation = particle.properties.x;
+    float scale = particle.properties.z;
+    float animation = clamp(particle.position.w / particle.velocity.w, 0.0, 0.999);
 
-    float sinA = sin(particle.rotation);
-    float cosA = cos(particle.rotation);
+    float sinA = sin(rotation);
+    float cosA = cos(rotation);
 
     mat3 mat = mat3(cosA, sinA, 0, -sinA, cosA, 0, 0, 0, 1);
 
-    vec4 particleViewPos = ubo.view * vec4(particle.position, 1.0);
-    particleViewPos.xy += (mat * (particle.scale * vec3(point, 1.0))).xy;
+    vec4 particleViewPos = ubo.view * vec4(particle.position.xyz, 1.0);
+    particleViewPos.xy += (mat * (scale * vec3(point, 1.0))).xy;
 
-    int frameID = int(16.0  * particle.animation);
+    int frameID = int(16.0 * animation);
     ivec2 framePos = ivec2(frameID % 4, frameID / 4);
 
-    fragAnimation = particle.animation;
+    fragAnimation = animation;
     fragTexCoord =  vec2(0.25) * vec2(framePos) + 0.25 * (vec2(0.5) + 0.5*point);
     gl_Position = ubo.proj * particleViewPos;
 }
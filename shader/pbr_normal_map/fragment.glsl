@@ -7,8 +7,7 @@ layout(location = 3) in vec3 fragTangent;
 layout(location = 4) in vec3 fragBitangent;
 
 layout(location = 0) out vec4 outColor;
-layout(location = 1) out vec4 outPosition;
-layout(location = 2) out vec4 outNormal;
+layout(location = 1) out vec2 outNormal;
 
 layout(binding = 1) uniform sampler2D texSampler;
 layout(binding = 2) uniform sampler2D normalSampler;
@@ -18,11 +17,12 @@ layout(binding = 3) uniform MaterialProperties {
     float metallic;
 } mp;
 
+#include "../common/gbuffer.glsl"
+
 void main() {
-    outColor = vec4(texture(texSampler, fragTexCoord).rgb, mp.roughness);
-    outPosition = vec4(fragPosition, mp.metallic);
+    outColor = vec4(texture(texSampler, fragTexCoord).rgb, pack_material(mp.roughness, mp.metallic));
 
     const mat3 tangentSpaceMat = mat3(fragTangent, fragBitangent, fragNormal);
-    vec3 normalSample = 2 * texture(normalSampler, fragTexCoord).rgb - 1.0;
-    outNormal = vec4(normalize(tangentSpaceMat * normalSample), 1.0);
+    vec3 normalSample = decode_normal_map(texture(normalSampler, fragTexCoord).rg);
+    outNormal = encode_normal(normalize(tangentSpaceMat * normalSample));
 }
@@ -19,6 +19,8 @@ layout(location = 2) out vec3 fragNormal;
 layout(location = 3) out vec3 fragTangent;
 layout(location = 4) out vec3 fragBitangent;
 
+invariant gl_Position;
+
 void main() {
     vec4 viewSpace = ubo.view * ubo.model * vec4(inPosition, 1.0);
 
@@ -11,8 +11,7 @@ layout(location = 7) in vec3 fragWorldTangent;
 layout(location = 8) in vec3 fragWorldBitangent;
 
 layout(location = 0) out vec4 outColor;
-layout(location = 1) out vec4 outPosition;
-layout(location = 2) out vec4 outNormal;
+layout(location = 1) out vec2 outNormal;
 
 layout(binding = 1) uniform sampler2D texSampler;
 layout(binding = 2) uniform sampler2D normalSampler;
@@ -30,6 +29,8 @@ layout(push_constant) uniform Constants
     vec3 viewPos;
 } pc;
 
+#include "../common/gbuffer.glsl"
+
 vec2 offset_parallax(vec2 texCoords, vec3 viewDir)
 {
     // number of depth layers
@@ -78,10 +79,9 @@ void main() {
     vec3 viewDir = normalize(tangentSpaceWorldMat * normalize(fragWorldPosition - pc.viewPos));
     vec2 parallaxUV = offset_parallax(fragTexCoord, viewDir * vec3(-1, 1, -1));
 
-    outColor = vec4(texture(texSampler, parallaxUV).rgb, mp.roughness);
-    outPosition = vec4(fragPosition, mp.metallic);
+    outColor = vec4(texture(texSampler, parallaxUV).rgb, pack_material(mp.roughness, mp.metallic));
 
     const mat3 tangentSpaceMat = mat3(fragTangent, fragBitangent, fragNormal);
-    vec3 normalSample = 2 * texture(normalSampler, parallaxUV).rgb - 1.0;
-    outNormal = vec4(normalize(tangentSpaceMat * normalSample), 1.0);
+    vec3 normalSample = decode_normal_map(texture(normalSampler, parallaxUV).rg);
+    outNormal = encode_normal(normalize(tangentSpaceMat * normalSample));
 }
@@ -24,6 +24,8 @@ layout(location = 6) out vec3 fragWorldNormal;
 layout(location = 7) out vec3 fragWorldTangent;
 layout(location = 8) out vec3 fragWorldBitangent;
 
+invariant gl_Position;
+
 void main() {
     vec4 viewSpace = ubo.view * ubo.model * vec4(inPosition, 1.0);
     const mat3 normMat = mat3(ubo.normal);
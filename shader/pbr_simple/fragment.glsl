@@ -7,8 +7,7 @@ layout(location = 3) in vec3 fragTangent;
 layout(location = 4) in vec3 fragBitangent;
 
 layout(location = 0) out vec4 outColor;
-layout(location = 1) out vec4 outPosition;
-layout(location = 2) out vec4 outNormal;
+layout(location = 1) out vec2 outNormal;
 
 layout(binding = 1) uniform sampler2D texSampler;
 
@@ -17,8 +16,9 @@ layout(binding = 2) uniform MaterialProperties {
     float metallic;
 } mp;
 
+#include "../common/gbuffer.glsl"
+
 void main() {
-    outColor = vec4(texture(texSampler, fragTexCoord).rgb, mp.roughness);
-    outPosition = vec4(fragPosition, mp.metallic);
-    outNormal = vec4(normalize(fragNormal), 1.0);
+    outColor = vec4(texture(texSampler, fragTexCoord).rgb, pack_material(mp.roughness, mp.metallic));
+    outNormal = encode_normal(normalize(fragNormal));
 }
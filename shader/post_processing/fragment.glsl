@@ -7,8 +7,6 @@ layout(binding = 0) uniform sampler2D texColor;
 layout(binding = 1) uniform sampler2D texBloom;
 layout(binding = 2) uniform sampler2D texOverlay;
 
-#include "../common/blur.glsl"
-
 const vec3 luma = vec3(0.299, 0.587, 0.114);
 
 float getLuma(vec2 offset) {
@@ -25,6 +23,7 @@ layout(push_constant) uniform Constants
     bool enableFXAA;
     bool hideUI;
     bool enableBloom;
+    bool upscale;
 } pc;
 
 float linearize_depth(float depth)
@@ -84,17 +83,55 @@ vec3 calculate_fxaa()
     return rgbB;
 }
 
+// Catmull-Rom bicubic filter evaluated with 9 bilinear taps, keeps the edges sharp
+// when the scene is rendered at a lower resolution than the output.
+vec3 sample_catmull_rom(vec2 uv)
+{
+    vec2 texSize = vec2(textureSize(texColor, 0));
+    vec2 samplePos = uv * texSize;
+    vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+    vec2 f = samplePos - texPos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 offset12 = w2 / w12;
+
+    vec2 texPos0 = (texPos1 - 1.0) / texSize;
+    vec2 texPos3 = (texPos1 + 2.0) / texSize;
+    vec2 texPos12 = (texPos1 + offset12) / texSize;
+
+    vec3 result = vec3(0.0);
+    result += textureLod(texColor, vec2(texPos0.x, texPos0.y), 0.0).rgb * w0.x * w0.y;
+    result += textureLod(texColor, vec2(texPos12.x, texPos0.y), 0.0).rgb * w12.x * w0.y;
+    result += textureLod(texColor, vec2(texPos3.x, texPos0.y), 0.0).rgb * w3.x * w0.y;
+
+    result += textureLod(texColor, vec2(texPos0.x, texPos12.y), 0.0).rgb * w0.x * w12.y;
+    result += textureLod(texColor, vec2(texPos12.x, texPos12.y), 0.0).rgb * w12.x * w12.y;
+    result += textureLod(texColor, vec2(texPos3.x, texPos12.y), 0.0).rgb * w3.x * w12.y;
+
+    result += textureLod(texColor, vec2(texPos0.x, texPos3.y), 0.0).rgb * w0.x * w3.y;
+    result += textureLod(texColor, vec2(texPos12.x, texPos3.y), 0.0).rgb * w12.x * w3.y;
+    result += textureLod(texColor, vec2(texPos3.x, texPos3.y), 0.0).rgb * w3.x * w3.y;
+
+    return max(result, vec3(0.0));
+}
+
 void main() {
     vec3 backColor;
     if (pc.enableFXAA) {
         backColor = calculate_fxaa();
+    } else if (pc.upscale) {
+        backColor = sample_catmull_rom(fragTexCoord);
     } else {
         backColor = texture(texColor, fragTexCoord).rgb;
     }
 
     if (pc.enableBloom) {
-        vec3 bloomColor = blur_image(texBloom, fragTexCoord);
-        backColor += bloomColor;
+        backColor += textureLod(texBloom, fragTexCoord, 0.0).rgb;
     }
 
     if (pc.hideUI) {
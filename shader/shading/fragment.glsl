@@ -3,15 +3,42 @@
 layout(location = 0) in vec2 fragTexCoord;
 
 layout(binding = 0) uniform sampler2D texColor;
-layout(binding = 1) uniform sampler2D texPosition;
-layout(binding = 2) uniform sampler2D texNormal;
+layout(binding = 1) uniform sampler2D texNormal;
+layout(binding = 2) uniform sampler2D texDepth;
 layout(binding = 3) uniform sampler2D texAmbientOcclusion;
-layout(binding = 4) uniform sampler2D texShadowMap;
+layout(binding = 4) uniform sampler2D texShadowMapCascade0;
+layout(binding = 5) uniform sampler2D texShadowMapCascade1;
+layout(binding = 6) uniform sampler2D texShadowMapCascade2;
 
-layout(binding = 5) uniform PostProcessingUBO {
-    mat4 shadowMapMat;
+const int g_shadowCascadeCount = 3;
+
+layout(binding = 7) uniform PostProcessingUBO {
+    mat4 inverseProjection;
+    mat4 shadowMapMats[g_shadowCascadeCount];
+    vec4 cascadeSplits;
+    vec4 clusterDepthParams;
 } ubo;
 
+const uvec3 g_lightClusterCount = uvec3(16, 9, 24);
+
+struct Light {
+    vec4 positionRange;
+    vec4 colorSpotOffset;
+    vec4 directionSpotScale;
+};
+
+layout(std430, binding = 8) readonly buffer LightBuffer {
+    Light lights[];
+};
+
+layout(std430, binding = 9) readonly buffer LightClusterBuffer {
+    uvec2 lightClusters[];
+};
+
+layout(std430, binding = 10) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
+
 layout(location = 0) out vec4 outColor;
 layout(location = 1) out vec4 outBloom;
 
@@ -19,11 +46,13 @@ layout(push_constant) uniform Constants
 {
     vec3 lightPosition;
     bool enableSSAO;
+    bool blurSSAO;
 } pc;
 
 #include "../common/blur.glsl"
 #include "../common/brdf.glsl"
 #include "../common/constants.glsl"
+#include "../common/gbuffer.glsl"
 #include "../common/shadow_map.glsl"
 
 const float ambient = 0.5;
@@ -35,42 +64,48 @@ const mat4 biasMat = mat4(
     0.5, 0.5, 0.0, 1.0
 );
 
-void main() {
-    vec3 normal = texture(texNormal, fragTexCoord).rgb;
-    if (normal == vec3(0.0, 0.0, 0.0)) {
-        outColor = vec4(texture(texColor, fragTexCoord).rgb, 1.0);
-        outBloom = vec4(0.0);
-        return;
+float shadow_cascade_test(vec3 position)
+{
+    const float viewDepth = -position.z;
+
+    int cascade = 0;
+    while (cascade < g_shadowCascadeCount && viewDepth > ubo.cascadeSplits[cascade]) {
+        ++cascade;
+    }
+    if (cascade == g_shadowCascadeCount) {
+        return 1.0;
     }
-    normal = normalize(normal);
 
-    vec4 texPositionSample = texture(texPosition, fragTexCoord);
-    vec3 position = texPositionSample.xyz;
-    vec4 shadowUV = biasMat * ubo.shadowMapMat * vec4(position, 1.0);
+    vec4 shadowUV = biasMat * ubo.shadowMapMats[cascade] * vec4(position, 1.0);
     shadowUV /= shadowUV.w;
 
-    float shadow = shadow_map_test_pcr(texShadowMap, shadowUV);
-    float ambientValue = ambient;
-    if (pc.enableSSAO) {
-        ambientValue *= blur_image_single(texAmbientOcclusion, fragTexCoord);
+    if (cascade == 0) {
+        return shadow_map_test_pcr(texShadowMapCascade0, shadowUV);
+    } else if (cascade == 1) {
+        return shadow_map_test_pcr(texShadowMapCascade1, shadowUV);
     }
+    return shadow_map_test_pcr(texShadowMapCascade2, shadowUV);
+}
 
-    vec4 texColorSample = texture(texColor, fragTexCoord);
-    vec3 albedo = texColorSample.rgb;
-
-    const float roughness = texColorSample.w;
-    const float metallic = texPositionSample.w;
-
-    vec3 viewDir = normalize(-position);
-    vec3 baseReflectivity = mix(vec3(0.04), albedo, metallic);
-
-    vec3 Lo = vec3(0);
+uint light_cluster_index(vec2 texCoord, float viewDepth)
+{
+    const uvec2 tile = min(uvec2(texCoord * vec2(g_lightClusterCount.xy)), g_lightClusterCount.xy - 1);
+    const float slice = log(viewDepth) * ubo.clusterDepthParams.x + ubo.clusterDepthParams.y;
+    const uint sliceIndex = min(uint(max(slice, 0.0)), g_lightClusterCount.z - 1);
+    return (sliceIndex * g_lightClusterCount.y + tile.y) * g_lightClusterCount.x + tile.x;
+}
+
+// Windowed inverse square falloff, reaches zero at the light range.
+float light_falloff(float distanceSq, float range)
+{
+    const float ratio = distanceSq / (range * range);
+    const float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+    return window * window / max(distanceSq, 0.01);
+}
 
-    // PER LIGHT
-    vec3 lightDir = normalize(pc.lightPosition - position);
+vec3 brdf(vec3 normal, vec3 viewDir, vec3 lightDir, vec3 albedo, float roughness, float metallic, vec3 baseReflectivity)
+{
     vec3 halfpoint = normalize(viewDir + lightDir);
-    float attenuation = 4.0;
-    vec3 radience = vec3(1, 1, 1) * attenuation;
 
     float NdotV = max(dot(normal, viewDir), 0.00000001);
     float NdotL = max(dot(normal, lightDir), 0.00000001);
@@ -87,12 +122,61 @@ void main() {
     vec3 kD = vec3(1.0) - fresnel;
     kD *= 1.0 - metallic;
 
-    Lo += (kD * albedo / pi + specular) * radience * NdotL;
+    return (kD * albedo / pi + specular) * NdotL;
+}
+
+void main() {
+    const ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    vec2 encodedNormal = texelFetch(texNormal, pixel, 0).rg;
+    if (is_unlit(encodedNormal)) {
+        outColor = vec4(texelFetch(texColor, pixel, 0).rgb, 1.0);
+        outBloom = vec4(0.0);
+        return;
+    }
+    vec3 normal = decode_normal(encodedNormal);
+
+    const float depth = texelFetch(texDepth, pixel, 0).r;
+    vec3 position = position_from_depth(ubo.inverseProjection, fragTexCoord, depth);
+    float shadow = shadow_cascade_test(position);
+    float ambientValue = ambient;
+    if (pc.enableSSAO) {
+        ambientValue *= pc.blurSSAO ? blur_image_single(texAmbientOcclusion, fragTexCoord) : texelFetch(texAmbientOcclusion, pixel, 0).r;
+    }
+
+    vec4 texColorSample = texelFetch(texColor, pixel, 0);
+    vec3 albedo = texColorSample.rgb;
+
+    const vec2 material = unpack_material(texColorSample.w);
+    const float roughness = material.x;
+    const float metallic = material.y;
+
+    vec3 viewDir = normalize(-position);
+    vec3 baseReflectivity = mix(vec3(0.04), albedo, metallic);
 
-    // END PER LIGHT
+    // Directional light, the only one casting shadows.
+    vec3 sunDir = normalize(pc.lightPosition - position);
+    vec3 Lo = 4.0 * shadow * brdf(normal, viewDir, sunDir, albedo, roughness, metallic, baseReflectivity);
+
+    const uvec2 cluster = lightClusters[light_cluster_index(fragTexCoord, -position.z)];
+    for (uint i = 0; i < cluster.y; ++i) {
+        const Light light = lights[lightIndices[cluster.x + i]];
+
+        vec3 toLight = light.positionRange.xyz - position;
+        const float distanceSq = dot(toLight, toLight);
+        if (distanceSq >= light.positionRange.w * light.positionRange.w) {
+            continue;
+        }
+        vec3 lightDir = toLight * inversesqrt(distanceSq);
+
+        float spot = clamp(dot(-lightDir, light.directionSpotScale.xyz) * light.directionSpotScale.w + light.colorSpotOffset.w, 0.0, 1.0);
+        vec3 radiance = light.colorSpotOffset.rgb * light_falloff(distanceSq, light.positionRange.w) * spot * spot;
+
+        Lo += radiance * brdf(normal, viewDir, lightDir, albedo, roughness, metallic, baseReflectivity);
+    }
 
     vec3 ambient = albedo * ambientValue;
-    vec3 color = 0.5 * ambient + 1.2 * shadow * Lo;
+    vec3 color = 0.5 * ambient + 1.2 * Lo;
 
     float luminance = dot(color, vec3(0.2125, 0.7153, 0.07121));
     color = mix(vec3(luminance), color, 1.25);
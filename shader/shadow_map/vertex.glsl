@@ -2,10 +2,10 @@
 
 layout(location = 0) in vec3 inPosition;
 
-layout(binding = 0) uniform UniformBufferObject {
+layout(push_constant) uniform Constants {
     mat4 MVP;
-} ubo;
+} pc;
 
 void main() {
-    gl_Position = ubo.MVP * vec4(inPosition, 1.0);
-}
+    gl_Position = pc.MVP * vec4(inPosition, 1.0);
+}
\ No newline at end of file
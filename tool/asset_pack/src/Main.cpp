@@ -0,0 +1,153 @@
+// Packs the assets of an asset list into a single archive, the resource manager mounts it in place of the loose files.
+// Sources are resolved like the resource manager resolves them: cooked textures first, then the build and content directories.
+//
+// asset_pack -index=<asset list> -contentDir=<content directory> -buildDir=<build directory> -output=<archive> [-stamp=<file>]
+
+#include "triglav/io/CommandLine.h"
+#include "triglav/ktx/Texture.h"
+#include "triglav/resource/PackArchive.h"
+
+#include <fmt/core.h>
+#include <ryml.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace triglav;
+using namespace triglav::name_literals;
+
+namespace fs = std::filesystem;
+
+using resource::PackCompression;
+
+struct PackedAsset
+{
+   std::string name;
+   std::string source;
+};
+
+std::vector<PackedAsset> read_assets(const fs::path& indexPath)
+{
+   std::ifstream file(indexPath, std::ios::binary);
+   std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+   const auto pathStr = indexPath.string();
+   auto tree = ryml::parse_in_place(c4::csubstr{pathStr.data(), pathStr.size()}, c4::substr{contents.data(), contents.size()});
+
+   std::vector<PackedAsset> result;
+   for (const auto node : tree["resources"]) {
+      const auto name = node["name"].val();
+      const auto source = node["source"].val();
+      result.emplace_back(std::string{name.data(), name.size()}, std::string{source.data(), source.size()});
+   }
+   return result;
+}
+
+// Returns the resolved file and its path relative to the directory it was found in.
+std::optional<std::pair<fs::path, std::string>> resolve_source(const ResourceName name, const std::string& source, const fs::path& buildDir,
+                                                               const fs::path& contentDir)
+{
+   if (name.type() == ResourceType::Texture) {
+      const auto cookedSource = ktx::cooked_texture_path(source);
+      if (const auto cookedPath = buildDir / cookedSource; fs::exists(cookedPath)) {
+         return std::pair{cookedPath, cookedSource};
+      }
+   }
+   if (const auto buildPath = buildDir / source; fs::exists(buildPath)) {
+      return std::pair{buildPath, source};
+   }
+   if (const auto contentPath = contentDir / source; fs::exists(contentPath)) {
+      return std::pair{contentPath, source};
+   }
+   return std::nullopt;
+}
+
+std::vector<u8> read_file(const fs::path& path)
+{
+   std::ifstream file(path, std::ios::binary);
+   return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+double to_kib(const MemorySize size)
+{
+   return static_cast<double>(size) / 1024.0;
+}
+
+}// namespace
+
+int main(const int argc, const char** argv)
+{
+   auto& commandLine = io::CommandLine::the();
+   commandLine.parse(argc, argv);
+
+   const auto indexArg = commandLine.arg("index"_name);
+   const auto contentDirArg = commandLine.arg("contentDir"_name);
+   const auto buildDirArg = commandLine.arg("buildDir"_name);
+   const auto outputArg = commandLine.arg("output"_name);
+   if (not indexArg.has_value() || not contentDirArg.has_value() || not buildDirArg.has_value() || not outputArg.has_value()) {
+      fmt::print(stderr, "usage: asset_pack -index=<asset list> -contentDir=<dir> -buildDir=<dir> -output=<archive> [-stamp=<file>]\n");
+      return 1;
+   }
+
+   const fs::path contentDir{*contentDirArg};
+   const fs::path buildDir{*buildDirArg};
+
+   resource::PackWriter writer;
+   MemorySize totalSize{};
+   u32 assetCount{};
+
+   for (const auto& [nameStr, source] : read_assets(fs::path{*indexArg})) {
+      const auto name = make_rc_name(nameStr);
+
+      // FreeType reads fonts from their files while rendering glyphs, they stay loose.
+      if (name.type() == ResourceType::Typeface)
+         continue;
+
+      // Missing sources are reported by the resource manager when the asset is loaded.
+      const auto resolved = resolve_source(name, source, buildDir, contentDir);
+      if (not resolved.has_value()) {
+         fmt::print(stderr, "{}: source not found, skipping\n", source);
+         continue;
+      }
+
+      const auto& [path, relativePath] = *resolved;
+      const auto data = read_file(path);
+
+      // Cooked textures are stored uncompressed, their levels are streamed directly from the mapped archive.
+      const auto compression = relativePath.ends_with(".ktx2") ? PackCompression::None : PackCompression::Deflate;
+      writer.add(name, relativePath, data, compression);
+
+      totalSize += data.size();
+      ++assetCount;
+   }
+
+   const auto archive = writer.write();
+
+   const fs::path outputPath{*outputArg};
+   const auto tempPath = fs::path{outputPath}.concat(".tmp");
+   {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(archive.data()), static_cast<std::streamsize>(archive.size()));
+      if (not file.good()) {
+         fmt::print(stderr, "failed to write {}\n", tempPath.string());
+         return 1;
+      }
+   }
+   // A running game keeps the previous archive mapped, replacing it doesn't change the mapped contents.
+   fs::rename(tempPath, outputPath);
+
+   fmt::print("{}: {} assets, {:.1f} KiB -> {:.1f} KiB\n", outputPath.filename().string(), assetCount, to_kib(totalSize),
+              to_kib(archive.size()));
+
+   if (const auto stampArg = commandLine.arg("stamp"_name); stampArg.has_value()) {
+      std::ofstream stamp(*stampArg, std::ios::trunc);
+   }
+
+   return 0;
+}
@@ -0,0 +1,188 @@
+// Compares the decode throughput and peak memory of stb_image with the image decoder backends
+// on every PNG and JPEG image in a directory.
+//
+// image_decode_bench -contentDir=<directory> [-iterations=<count>]
+
+#include "triglav/io/CommandLine.h"
+#include "triglav/resource/ImageDecoder.h"
+
+#include <fmt/core.h>
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cstdio>
+#endif
+
+namespace {
+
+using namespace triglav;
+using namespace triglav::name_literals;
+
+namespace fs = std::filesystem;
+
+using DecodeFunc = std::function<bool(std::span<const u8>)>;
+
+struct DecodeStats
+{
+   double seconds{};
+   std::optional<MemorySize> peakMemory;
+};
+
+std::vector<u8> read_file(const fs::path& path)
+{
+   std::ifstream file(path, std::ios::binary);
+   return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+bool decode_stb(const std::span<const u8> data)
+{
+   int width, height, channelCount;
+   stbi_uc* pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channelCount, STBI_rgb_alpha);
+   stbi_image_free(pixels);
+   return pixels != nullptr;
+}
+
+#ifdef __linux__
+// Reads a memory value in bytes from /proc/self/status.
+MemorySize process_memory(const std::string_view key)
+{
+   std::ifstream status("/proc/self/status");
+   std::string line;
+   while (std::getline(status, line)) {
+      if (line.starts_with(key)) {
+         return std::stoull(line.substr(key.size() + 1)) * 1024;
+      }
+   }
+   return 0;
+}
+#endif
+
+// Peak resident memory of decoding the image once. It's measured in a fresh process running this executable,
+// so the heap of previous decodes doesn't hide allocations.
+std::optional<MemorySize> decode_peak_memory([[maybe_unused]] const fs::path& path, [[maybe_unused]] const std::string_view decoderName)
+{
+#ifdef __linux__
+   const auto command =
+      fmt::format("'{}' -decodeOnce='{}' -decoder={}", fs::read_symlink("/proc/self/exe").string(), path.string(), decoderName);
+   auto* pipe = popen(command.c_str(), "r");
+   if (pipe == nullptr)
+      return std::nullopt;
+
+   unsigned long long peakMemory{};
+   const auto matchCount = std::fscanf(pipe, "%llu", &peakMemory);
+   if (pclose(pipe) != 0 || matchCount != 1)
+      return std::nullopt;
+
+   return static_cast<MemorySize>(peakMemory);
+#else
+   return std::nullopt;
+#endif
+}
+
+DecodeStats measure(const DecodeFunc& decode, const std::string_view decoderName, const fs::path& path, const std::span<const u8> data,
+                    const u32 iterations)
+{
+   DecodeStats result{.seconds = std::numeric_limits<double>::infinity()};
+   for (u32 iteration = 0; iteration < iterations; ++iteration) {
+      const auto startTime = std::chrono::steady_clock::now();
+      if (not decode(data))
+         return DecodeStats{};
+      const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+      result.seconds = std::min(result.seconds, duration.count());
+   }
+   result.peakMemory = decode_peak_memory(path, decoderName);
+   return result;
+}
+
+std::string format_memory(const std::optional<MemorySize> size)
+{
+   if (not size.has_value())
+      return "n/a";
+   return fmt::format("{:.1f}MiB", static_cast<double>(*size) / (1024.0 * 1024.0));
+}
+
+}// namespace
+
+int main(const int argc, const char** argv)
+{
+   auto& commandLine = io::CommandLine::the();
+   commandLine.parse(argc, argv);
+
+   const auto& decoder = resource::ImageDecoder::the();
+   const DecodeFunc decodeDefault = [&decoder](const std::span<const u8> data) { return decoder.decode(data).has_value(); };
+
+#ifdef __linux__
+   // Child process of the peak memory measurement, prints the peak increase of the resident memory.
+   if (const auto decodeOnceArg = commandLine.arg("decodeOnce"_name); decodeOnceArg.has_value()) {
+      const auto data = read_file(*decodeOnceArg);
+      const auto residentMemory = process_memory("VmRSS:");
+      // Resets the peak resident memory of the process.
+      std::ofstream("/proc/self/clear_refs") << "5";
+
+      const auto isSuccess = commandLine.arg("decoder"_name) == "stb" ? decode_stb(data) : decodeDefault(data);
+      fmt::print("{}\n", process_memory("VmHWM:") - residentMemory);
+      return isSuccess ? 0 : 1;
+   }
+#endif
+
+   const auto contentDirArg = commandLine.arg("contentDir"_name);
+   if (not contentDirArg.has_value()) {
+      fmt::print(stderr, "usage: image_decode_bench -contentDir=<dir> [-iterations=<count>]\n");
+      return 1;
+   }
+   const auto iterations = static_cast<u32>(std::max(commandLine.arg_int("iterations"_name).value_or(3), 1));
+
+   std::vector<fs::path> paths;
+   for (const auto& entry : fs::recursive_directory_iterator(*contentDirArg)) {
+      const auto extension = entry.path().extension();
+      if (extension == ".png" || extension == ".jpg" || extension == ".jpeg") {
+         paths.emplace_back(entry.path());
+      }
+   }
+   std::ranges::sort(paths);
+
+   fmt::print("{:<28} {:>10} {:>14} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8} {:>10}\n", "image", "size", "backend", "stb", "stb MP/s",
+              "stb peak", "time", "MP/s", "speedup", "peak");
+
+   double totalMegapixels{};
+   double totalStbSeconds{};
+   double totalSeconds{};
+   for (const auto& path : paths) {
+      const auto data = read_file(path);
+      const auto image = decoder.decode(data);
+      if (not image.has_value()) {
+         fmt::print(stderr, "{}: failed to decode the image\n", path.string());
+         continue;
+      }
+
+      const auto megapixels = static_cast<double>(image->width) * image->height / 1'000'000.0;
+      const auto stbStats = measure(decode_stb, "stb", path, data, iterations);
+      const auto stats = measure(decodeDefault, "default", path, data, iterations);
+
+      totalMegapixels += megapixels;
+      totalStbSeconds += stbStats.seconds;
+      totalSeconds += stats.seconds;
+
+      fmt::print("{:<28} {:>10} {:>14} {:>8.1f}ms {:>10.1f} {:>10} {:>8.1f}ms {:>10.1f} {:>7.2f}x {:>10}\n",
+                 fs::relative(path, *contentDirArg).string(), fmt::format("{}x{}", image->width, image->height),
+                 decoder.backend_name(data), 1000.0 * stbStats.seconds, megapixels / stbStats.seconds, format_memory(stbStats.peakMemory),
+                 1000.0 * stats.seconds, megapixels / stats.seconds, stbStats.seconds / stats.seconds, format_memory(stats.peakMemory));
+   }
+
+   fmt::print("\ntotal {:.1f} megapixels: stb_image {:.1f}ms ({:.1f} MP/s), backends {:.1f}ms ({:.1f} MP/s), {:.2f}x\n", totalMegapixels,
+              1000.0 * totalStbSeconds, totalMegapixels / totalStbSeconds, 1000.0 * totalSeconds, totalMegapixels / totalSeconds,
+              totalStbSeconds / totalSeconds);
+
+   return 0;
+}
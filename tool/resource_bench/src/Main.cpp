@@ -0,0 +1,304 @@
+// Loads the asset lists of the demo end to end against a null graphics device, so loader throughput can be
+// measured on machines without a GPU. GPU objects are created without Vulkan handles and the data uploaded
+// to them is discarded, their sizes are reported instead. The data is still written to the staging memory, so
+// the uploaded bytes and the peak resident memory show what the loaders copy on the way to the GPU.
+//
+// resource_bench [-threadCount=<count>] [-contentDir=<dir>] [-buildDir=<dir>] [-looseAssets] [-loadTrace=<path>]
+
+#include "triglav/font/FontManager.h"
+#include "triglav/graphics_api/Device.h"
+#include "triglav/graphics_api/RenderTarget.h"
+#include "triglav/io/CommandLine.h"
+#include "triglav/renderer/MaterialManager.h"
+#include "triglav/resource/LoadTelemetry.h"
+#include "triglav/resource/PathManager.h"
+#include "triglav/resource/ResourceManager.h"
+#include "triglav/threading/ThreadPool.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+using namespace triglav;
+using namespace triglav::name_literals;
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto g_minThreads = 1;
+constexpr auto g_maxThreads = 64;
+
+std::atomic<u64> g_allocationCount{};
+std::atomic<u64> g_allocatedSize{};
+
+struct AllocationStats
+{
+   u64 count;
+   u64 size;
+
+   static AllocationStats current()
+   {
+      return {g_allocationCount.load(std::memory_order_relaxed), g_allocatedSize.load(std::memory_order_relaxed)};
+   }
+};
+
+using TypeMemory = std::array<MemorySize, static_cast<u32>(ResourceType::Unknown)>;
+
+double to_mib(const MemorySize size)
+{
+   return static_cast<double>(size) / (1024.0 * 1024.0);
+}
+
+std::string format_memory(const std::optional<MemorySize> size)
+{
+   if (not size.has_value())
+      return "n/a";
+   return fmt::format("{:.2f} MiB", to_mib(*size));
+}
+
+#ifdef __linux__
+// Reads a memory value in bytes from /proc/self/status.
+MemorySize process_memory(const std::string_view key)
+{
+   std::ifstream status("/proc/self/status");
+   std::string line;
+   while (std::getline(status, line)) {
+      if (line.starts_with(key)) {
+         return std::stoull(line.substr(key.size() + 1)) * 1024;
+      }
+   }
+   return 0;
+}
+#endif
+
+// Peak resident memory of the process since the last reset.
+std::optional<MemorySize> peak_resident_memory()
+{
+#ifdef __linux__
+   return process_memory("VmHWM:");
+#else
+   return std::nullopt;
+#endif
+}
+
+void reset_peak_resident_memory()
+{
+#ifdef __linux__
+   std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+TypeMemory memory_usage(const resource::ResourceManager& resourceManager)
+{
+   TypeMemory result{};
+   for (u32 type = 0; type < result.size(); ++type) {
+      result[type] = resourceManager.memory_usage(static_cast<ResourceType>(type));
+   }
+   return result;
+}
+
+// Waits for the asset lists to load and counts the loaded assets of each type.
+class LoadListener
+{
+ public:
+   using OnLoadedAssetsSink = resource::ResourceManager::OnLoadedAssetsDel::Sink<LoadListener>;
+   using OnFinishedLoadingAssetSink = resource::ResourceManager::OnFinishedLoadingAssetDel::Sink<LoadListener>;
+   using OnLoadedRequiredAssetsSink = resource::ResourceManager::OnLoadedRequiredAssetsDel::Sink<LoadListener>;
+
+   explicit LoadListener(resource::ResourceManager& resourceManager) :
+       m_onLoadedAssetsSink(resourceManager.OnLoadedAssets.connect<&LoadListener::on_loaded_assets>(this)),
+       m_onFinishedLoadingAssetSink(resourceManager.OnFinishedLoadingAsset.connect<&LoadListener::on_finished_loading_asset>(this)),
+       m_onLoadedRequiredAssetsSink(resourceManager.OnLoadedRequiredAssets.connect<&LoadListener::on_loaded_required_assets>(this))
+   {
+   }
+
+   void on_loaded_assets()
+   {
+      {
+         std::unique_lock lk{m_mutex};
+         m_isLoaded = true;
+      }
+      m_loadedCV.notify_one();
+   }
+
+   void on_finished_loading_asset(const ResourceName name, [[maybe_unused]] const u32 loadedCount, [[maybe_unused]] const u32 totalCount)
+   {
+      std::unique_lock lk{m_mutex};
+      ++m_assetCounts[name.type()];
+   }
+
+   void on_loaded_required_assets()
+   {
+      std::unique_lock lk{m_mutex};
+      m_requiredAssetsTime = Clock::now();
+   }
+
+   // Returns the assets of each type loaded since the last call.
+   std::map<ResourceType, u32> wait_for_assets()
+   {
+      std::unique_lock lk{m_mutex};
+      m_loadedCV.wait(lk, [this] { return m_isLoaded; });
+      m_isLoaded = false;
+      return std::exchange(m_assetCounts, {});
+   }
+
+   // Returns when the required assets of the last list were loaded, lists finishing them together with the rest have none.
+   std::optional<Clock::time_point> required_assets_time()
+   {
+      std::unique_lock lk{m_mutex};
+      return std::exchange(m_requiredAssetsTime, std::nullopt);
+   }
+
+ private:
+   std::mutex m_mutex;
+   std::condition_variable m_loadedCV;
+   bool m_isLoaded{false};
+   std::map<ResourceType, u32> m_assetCounts;
+   std::optional<Clock::time_point> m_requiredAssetsTime;
+   OnLoadedAssetsSink m_onLoadedAssetsSink;
+   OnFinishedLoadingAssetSink m_onFinishedLoadingAssetSink;
+   OnLoadedRequiredAssetsSink m_onLoadedRequiredAssetsSink;
+};
+
+// Throughput is relative to the time the worker threads spent loading assets of the type, not to the wall time.
+void report_types(const resource::ResourceManager& resourceManager, const std::map<ResourceType, u32>& assetCounts,
+                  const TypeMemory& memoryBefore, const Clock::time_point since)
+{
+   std::map<ResourceType, Clock::duration> busyTimes;
+   for (const auto& event : resource::LoadTelemetry::the().events(since)) {
+      if (event.phase != resource::LoadPhase::DependencyWait) {
+         busyTimes[event.asset.type()] += event.end - event.start;
+      }
+   }
+
+   fmt::print("  {:<18} {:>7} {:>10} {:>10} {:>10} {:>10}\n", "type", "assets", "MiB", "busy ms", "assets/s", "MiB/s");
+   const auto memoryAfter = memory_usage(resourceManager);
+   for (const auto& [type, count] : assetCounts) {
+      const auto typeIndex = static_cast<u32>(type);
+      const auto memory = memoryAfter[typeIndex] - std::min(memoryBefore[typeIndex], memoryAfter[typeIndex]);
+      const auto busySeconds = std::chrono::duration<double>(busyTimes[type]).count();
+      const auto perSecond = [busySeconds](const double value) { return busySeconds > 0.0 ? value / busySeconds : 0.0; };
+      fmt::print("  {:<18} {:>7} {:>10.2f} {:>10.1f} {:>10.1f} {:>10.1f}\n", resource_type_name(type), count, to_mib(memory),
+                 busySeconds * 1000.0, perSecond(count), perSecond(to_mib(memory)));
+   }
+}
+
+// Render target of the geometry pass, the pipelines of the materials are built against it.
+graphics_api::RenderTarget create_geometry_render_target(graphics_api::Device& device)
+{
+   using graphics_api::AttachmentAttribute;
+   const auto attributes = AttachmentAttribute::ClearImage | AttachmentAttribute::StoreImage;
+
+   return GAPI_CHECK(graphics_api::RenderTargetBuilder(device)
+                        .attachment("albedo"_name, attributes | AttachmentAttribute::Color, GAPI_FORMAT(RGBA, UNorm16))
+                        .attachment("normal"_name, attributes | AttachmentAttribute::Color, GAPI_FORMAT(RG, UNorm16))
+                        .attachment("depth"_name, attributes | AttachmentAttribute::Depth, GAPI_FORMAT(D, Float32))
+                        .build());
+}
+
+void report_device(const graphics_api::NullDeviceStats& stats)
+{
+   fmt::print("null device:\n");
+   fmt::print("  {} buffers, {:.2f} MiB\n", stats.bufferCount.load(), to_mib(stats.bufferMemory.load()));
+   fmt::print("  {} textures, {:.2f} MiB\n", stats.textureCount.load(), to_mib(stats.textureMemory.load()));
+   fmt::print("  {} shaders, {:.2f} MiB of code\n", stats.shaderCount.load(), to_mib(stats.shaderCodeSize.load()));
+   fmt::print("  {} pipelines\n", stats.pipelineCount.load());
+   fmt::print("  {} uploads, {:.2f} MiB staged\n", stats.uploadCount.load(), to_mib(stats.uploadSize.load()));
+}
+
+}// namespace
+
+// Counts every allocation of the process, the loaders run on the thread pool.
+void* operator new(const std::size_t size)
+{
+   g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+   g_allocatedSize.fetch_add(size, std::memory_order_relaxed);
+   if (auto* pointer = std::malloc(size == 0 ? 1 : size); pointer != nullptr)
+      return pointer;
+   throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+   std::free(pointer);
+}
+
+void operator delete(void* pointer, [[maybe_unused]] const std::size_t size) noexcept
+{
+   std::free(pointer);
+}
+
+int main(const int argc, const char** argv)
+{
+   auto& commandLine = io::CommandLine::the();
+   commandLine.parse(argc, argv);
+
+   threading::set_thread_id(threading::g_mainThread);
+   const auto threadCount = commandLine.arg_int("threadCount"_name).value_or(8);
+   threading::ThreadPool::the().initialize(std::clamp(threadCount, g_minThreads, g_maxThreads));
+
+   {
+      const auto device = graphics_api::Device::create_null();
+      font::FontManger fontManager;
+      resource::ResourceManager resourceManager(*device, fontManager);
+      LoadListener listener(resourceManager);
+
+      const auto startAllocations = AllocationStats::current();
+      const auto startTime = Clock::now();
+
+      for (const auto* listName : {"index_base.yaml", "index.yaml"}) {
+         const auto listAllocations = AllocationStats::current();
+         const auto listMemory = memory_usage(resourceManager);
+         const auto listUploadSize = device->null_stats()->uploadSize.load();
+         const auto listStartTime = Clock::now();
+         reset_peak_resident_memory();
+
+         resourceManager.load_asset_list(resource::PathManager::the().content_path().sub(listName));
+         const auto assetCounts = listener.wait_for_assets();
+
+         const std::chrono::duration<double, std::milli> duration = Clock::now() - listStartTime;
+         const auto allocations = AllocationStats::current();
+         fmt::print("{}: {:.1f} ms, {} allocations, {:.2f} MiB allocated, {:.2f} MiB staged, peak resident {}\n", listName,
+                    duration.count(), allocations.count - listAllocations.count, to_mib(allocations.size - listAllocations.size),
+                    to_mib(device->null_stats()->uploadSize.load() - listUploadSize), format_memory(peak_resident_memory()));
+         if (const auto requiredTime = listener.required_assets_time(); requiredTime.has_value()) {
+            const std::chrono::duration<double, std::milli> requiredDuration = *requiredTime - listStartTime;
+            fmt::print("{}: required assets {:.1f} ms\n", listName, requiredDuration.count());
+         }
+         report_types(resourceManager, assetCounts, listMemory, listStartTime);
+      }
+
+      // Compiles the pipelines of the material templates and the uniform buffers of the materials, as the renderer does.
+      const auto materialStartTime = Clock::now();
+      auto renderTarget = create_geometry_render_target(*device);
+      renderer::MaterialManager materialManager(*device, resourceManager, renderTarget);
+      const std::chrono::duration<double, std::milli> materialDuration = Clock::now() - materialStartTime;
+      fmt::print("material manager: {:.1f} ms\n", materialDuration.count());
+
+      const std::chrono::duration<double, std::milli> totalDuration = Clock::now() - startTime;
+      const auto allocations = AllocationStats::current();
+      fmt::print("total: {:.1f} ms, {} allocations, {:.2f} MiB allocated\n", totalDuration.count(),
+                 allocations.count - startAllocations.count, to_mib(allocations.size - startAllocations.size));
+
+      report_device(*device->null_stats());
+
+      // Pending jobs may still reference the resource manager.
+      threading::ThreadPool::the().quit();
+   }
+
+   return EXIT_SUCCESS;
+}
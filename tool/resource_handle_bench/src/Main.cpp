@@ -0,0 +1,133 @@
+// Compares the cost of resolving a resource by name through a map guarded by a shared mutex, the way
+// the resource container worked before, with resolving it by name and by handle through the container.
+// Each thread performs the lookups of a frame drawing the given number of objects.
+//
+// resource_handle_bench [-resourceCount=<count>] [-lookupCount=<count>] [-threadCount=<count>] [-iterations=<count>]
+
+#include "triglav/io/CommandLine.h"
+#include "triglav/render_core/Material.hpp"
+#include "triglav/resource/Container.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace triglav;
+using namespace triglav::name_literals;
+
+// The container before dense handles, every lookup takes the shared lock and searches the map.
+class MapContainer
+{
+ public:
+   void register_resource(const MaterialName name, render_core::Material&& material)
+   {
+      std::unique_lock lk{m_mutex};
+      m_map.emplace(name, std::move(material));
+   }
+
+   render_core::Material& get(const MaterialName name)
+   {
+      std::shared_lock lk{m_mutex};
+      return m_map.at(name);
+   }
+
+ private:
+   std::map<MaterialName, render_core::Material> m_map;
+   mutable std::shared_mutex m_mutex;
+};
+
+// Runs the lookup function on every thread, returns the best time of a lookup in nanoseconds.
+template<typename TLookup>
+double measure(const TLookup& lookup, const u32 lookupCount, const u32 threadCount, const u32 iterations)
+{
+   double bestSeconds = std::numeric_limits<double>::infinity();
+   for (u32 iteration = 0; iteration < iterations; ++iteration) {
+      std::vector<std::thread> threads;
+      std::vector<MemorySize> sums(threadCount);
+
+      const auto startTime = std::chrono::steady_clock::now();
+      for (u32 threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+         threads.emplace_back([&lookup, &sums, threadIndex, lookupCount] {
+            MemorySize sum{};
+            for (u32 lookupIndex = 0; lookupIndex < lookupCount; ++lookupIndex) {
+               sum += lookup(lookupIndex).values.size();
+            }
+            sums[threadIndex] = sum;
+         });
+      }
+      for (auto& thread : threads) {
+         thread.join();
+      }
+      const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+
+      // Keeps the lookups from being optimized away.
+      if (std::ranges::find(sums, 0) != sums.end()) {
+         fmt::print(stderr, "unexpected empty material\n");
+      }
+      bestSeconds = std::min(bestSeconds, duration.count());
+   }
+
+   return 1'000'000'000.0 * bestSeconds / lookupCount;
+}
+
+}// namespace
+
+int main(const int argc, const char** argv)
+{
+   auto& commandLine = io::CommandLine::the();
+   commandLine.parse(argc, argv);
+
+   const auto resourceCount = static_cast<u32>(std::max(commandLine.arg_int("resourceCount"_name).value_or(512), 1));
+   const auto lookupCount = static_cast<u32>(std::max(commandLine.arg_int("lookupCount"_name).value_or(1'000'000), 1));
+   const auto threadCount = static_cast<u32>(std::max(commandLine.arg_int("threadCount"_name).value_or(1), 1));
+   const auto iterations = static_cast<u32>(std::max(commandLine.arg_int("iterations"_name).value_or(5), 1));
+
+   MapContainer mapContainer;
+   resource::Container<ResourceType::Material> container;
+
+   std::vector<MaterialName> names;
+   for (u32 index = 0; index < resourceCount; ++index) {
+      const auto name = MaterialName{make_rc_name(fmt::format("material_{}.mat", index))};
+      names.emplace_back(name);
+
+      render_core::Material material{.materialTemplate{"pbr.mt"_rc}, .values{1.0f}};
+      mapContainer.register_resource(name, render_core::Material{material});
+      container.register_resource(name, std::move(material));
+   }
+
+   // Objects are drawn in an order unrelated to the order the resources were loaded in.
+   std::mt19937 generator{42};
+   std::uniform_int_distribution<u32> distribution(0, resourceCount - 1);
+   std::vector<MaterialName> drawNames;
+   std::vector<MaterialHandle> drawHandles;
+   for (u32 index = 0; index < lookupCount; ++index) {
+      const auto name = names[distribution(generator)];
+      drawNames.emplace_back(name);
+      drawHandles.emplace_back(container.handle(name));
+   }
+
+   const auto mapTime = measure([&](const u32 index) -> auto& { return mapContainer.get(drawNames[index]); }, lookupCount, threadCount,
+                                iterations);
+   const auto nameTime =
+      measure([&](const u32 index) -> auto& { return container.get(drawNames[index]); }, lookupCount, threadCount, iterations);
+   const auto handleTime =
+      measure([&](const u32 index) -> auto& { return container.get(drawHandles[index]); }, lookupCount, threadCount, iterations);
+
+   fmt::print("{} resources, {} lookups on {} threads\n", resourceCount, lookupCount, threadCount);
+   fmt::print("{:<34} {:>10} {:>8}\n", "lookup", "ns", "speedup");
+   fmt::print("{:<34} {:>10.2f} {:>7.2f}x\n", "map with shared mutex (previous)", mapTime, 1.0);
+   fmt::print("{:<34} {:>10.2f} {:>7.2f}x\n", "container by name", nameTime, mapTime / nameTime);
+   fmt::print("{:<34} {:>10.2f} {:>7.2f}x\n", "container by handle", handleTime, mapTime / handleTime);
+
+   return 0;
+}
@@ -0,0 +1,342 @@
+// Converts the textures of an asset list to KTX2 files with block compression and precomputed mips.
+// Runs entirely on the CPU, the resource manager picks up the cooked files from the output directory.
+//
+// texture_cook -index=<asset list> -contentDir=<content directory> -outputDir=<build directory> [-stamp=<file>] [-force]
+
+#include "triglav/graphics_api/MipFilter.h"
+#include "triglav/io/CommandLine.h"
+#include "triglav/ktx/BlockCompression.h"
+#include "triglav/ktx/ChannelLayout.h"
+#include "triglav/ktx/Texture.h"
+
+#include <fmt/core.h>
+#include <ryml.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace triglav;
+using namespace triglav::name_literals;
+
+namespace fs = std::filesystem;
+
+using graphics_api::MipFilter;
+using ktx::Format;
+
+// Opaque color textures are stored as BC1 when its error stays below this value and as BC7 otherwise.
+constexpr double g_bc1MaxRmse = 3.0;
+
+struct TextureAsset
+{
+   std::string source;
+   MipFilter mipFilter{MipFilter::Average};
+   // One of auto, none, bc1, bc4, bc5 or bc7.
+   std::string compression{"auto"};
+   std::string channels;
+   std::string colorSpace;
+};
+
+struct CookStats
+{
+   MemorySize sourceSize{};
+   MemorySize cookedSize{};
+};
+
+MipFilter parse_mip_filter(const std::string_view value)
+{
+   if (value == "normal_map")
+      return MipFilter::NormalMap;
+   if (value == "min")
+      return MipFilter::Min;
+   if (value == "max")
+      return MipFilter::Max;
+   return MipFilter::Average;
+}
+
+std::string_view format_name(const Format format)
+{
+   switch (format) {
+   case Format::BC1_RGB_sRGB:
+   case Format::BC1_RGB_UNorm:
+      return "BC1";
+   case Format::BC4_UNorm:
+      return "BC4";
+   case Format::BC5_UNorm:
+      return "BC5";
+   case Format::BC7_sRGB:
+   case Format::BC7_UNorm:
+      return "BC7";
+   default:
+      break;
+   }
+   return "uncompressed";
+}
+
+std::vector<TextureAsset> read_texture_assets(const fs::path& indexPath)
+{
+   std::ifstream file(indexPath, std::ios::binary);
+   std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+   const auto pathStr = indexPath.string();
+   auto tree = ryml::parse_in_place(c4::csubstr{pathStr.data(), pathStr.size()}, c4::substr{contents.data(), contents.size()});
+
+   std::vector<TextureAsset> result;
+   for (const auto node : tree["resources"]) {
+      const auto name = node["name"].val();
+      const std::string_view nameView{name.data(), name.size()};
+      if (not nameView.ends_with(".tex"))
+         continue;
+
+      const auto source = node["source"].val();
+      auto& asset = result.emplace_back(TextureAsset{.source{source.data(), source.size()}});
+
+      if (not node.has_child("properties"))
+         continue;
+
+      for (const auto property : node["properties"]) {
+         const auto key = property.key();
+         const auto value = property.val();
+         const std::string_view keyView{key.data(), key.size()};
+         if (keyView == "mip_filter") {
+            asset.mipFilter = parse_mip_filter({value.data(), value.size()});
+         } else if (keyView == "compression") {
+            asset.compression.assign(value.data(), value.size());
+         } else if (keyView == "channels") {
+            asset.channels.assign(value.data(), value.size());
+         } else if (keyView == "color_space") {
+            asset.colorSpace.assign(value.data(), value.size());
+         }
+      }
+   }
+
+   return result;
+}
+
+double rmse(const std::span<const u8> expected, const std::span<const u8> actual)
+{
+   double sum{};
+   for (MemorySize i = 0; i < expected.size(); ++i) {
+      if (i % 4 == 3)
+         continue;
+      const auto diff = static_cast<double>(expected[i]) - static_cast<double>(actual[i]);
+      sum += diff * diff;
+   }
+   return std::sqrt(sum / static_cast<double>(expected.size() / 4 * 3));
+}
+
+std::optional<Format> select_format(const TextureAsset& asset, const std::span<const u8> texels, const u32 width, const u32 height)
+{
+   const auto layout =
+      ktx::resolve_texture_layout(asset.source, asset.channels, asset.colorSpace, asset.mipFilter == MipFilter::NormalMap);
+   const auto isSrgb = layout.colorSpace == ktx::ColorSpace::sRGB;
+   const auto bc1Format = isSrgb ? Format::BC1_RGB_sRGB : Format::BC1_RGB_UNorm;
+   const auto bc7Format = isSrgb ? Format::BC7_sRGB : Format::BC7_UNorm;
+
+   if (asset.compression == "none")
+      return std::nullopt;
+   if (asset.compression == "bc1")
+      return bc1Format;
+   if (asset.compression == "bc4")
+      return Format::BC4_UNorm;
+   if (asset.compression == "bc5")
+      return Format::BC5_UNorm;
+   if (asset.compression == "bc7")
+      return bc7Format;
+
+   if (layout.channels == ktx::ChannelLayout::R)
+      return Format::BC4_UNorm;
+   if (layout.channels == ktx::ChannelLayout::RG)
+      return Format::BC5_UNorm;
+
+   for (MemorySize i = 3; i < texels.size(); i += 4) {
+      if (texels[i] != 255)
+         return bc7Format;
+   }
+
+   const auto encoded = ktx::encode_image(bc1Format, texels, width, height);
+   const auto decoded = ktx::decode_image(bc1Format, encoded, width, height);
+   return rmse(texels, *decoded) <= g_bc1MaxRmse ? bc1Format : bc7Format;
+}
+
+std::vector<u8> to_bytes(const std::span<const glm::vec4> texels)
+{
+   std::vector<u8> result(4 * texels.size());
+   for (MemorySize i = 0; i < texels.size(); ++i) {
+      for (int c = 0; c < 4; ++c) {
+         result[4 * i + c] = static_cast<u8>(std::lround(std::clamp(texels[i][c], 0.0f, 1.0f) * 255.0f));
+      }
+   }
+   return result;
+}
+
+ktx::Texture cook_texture(const TextureAsset& asset, const Format format, const std::span<const u8> texels, const u32 width,
+                          const u32 height)
+{
+   ktx::Texture result{
+      .format = format,
+      .width = width,
+      .height = height,
+   };
+
+   std::vector<glm::vec4> sourceTexels(static_cast<MemorySize>(width) * height);
+   for (MemorySize i = 0; i < sourceTexels.size(); ++i) {
+      sourceTexels[i] = glm::vec4(texels[4 * i], texels[4 * i + 1], texels[4 * i + 2], texels[4 * i + 3]) / 255.0f;
+   }
+
+   // Same filter as the mip generator, so cooked textures match the ones generated on load.
+   const auto mipCount = static_cast<int>(std::floor(std::log2(std::max(width, height)))) + 1;
+   const auto mipChain = graphics_api::generate_mip_chain_reference(sourceTexels, {width, height}, mipCount - 1, asset.mipFilter,
+                                                                    ktx::is_srgb(format));
+
+   result.levels.emplace_back(ktx::encode_image(format, texels, width, height));
+   for (int mipLevel = 1; mipLevel < mipCount; ++mipLevel) {
+      const auto levelTexels = to_bytes(mipChain[mipLevel - 1]);
+      result.levels.emplace_back(ktx::encode_image(format, levelTexels, result.mip_width(mipLevel), result.mip_height(mipLevel)));
+   }
+
+   return result;
+}
+
+// Size of the texture the loader creates from the source image, RGBA8 with a full mip chain.
+MemorySize source_texture_size(const u32 width, const u32 height)
+{
+   MemorySize result{};
+   for (u32 mipLevel = 0; (width >> mipLevel) > 0 || (height >> mipLevel) > 0; ++mipLevel) {
+      result += ktx::image_size(Format::RGBA8_sRGB, std::max(width >> mipLevel, 1u), std::max(height >> mipLevel, 1u));
+   }
+   return result;
+}
+
+std::optional<ktx::Texture> read_cooked_texture(const fs::path& path)
+{
+   std::ifstream file(path, std::ios::binary);
+   const std::vector<u8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+   auto result = ktx::read_ktx2(data);
+   if (not result.has_value())
+      return std::nullopt;
+   return std::move(*result);
+}
+
+bool write_cooked_texture(const fs::path& path, const ktx::Texture& texture)
+{
+   const auto data = ktx::write_ktx2(texture);
+
+   fs::create_directories(path.parent_path());
+   std::ofstream file(path, std::ios::binary | std::ios::trunc);
+   file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+   return file.good();
+}
+
+double to_kib(const MemorySize size)
+{
+   return static_cast<double>(size) / 1024.0;
+}
+
+}// namespace
+
+int main(const int argc, const char** argv)
+{
+   auto& commandLine = io::CommandLine::the();
+   commandLine.parse(argc, argv);
+
+   const auto indexArg = commandLine.arg("index"_name);
+   const auto contentDirArg = commandLine.arg("contentDir"_name);
+   const auto outputDirArg = commandLine.arg("outputDir"_name);
+   if (not indexArg.has_value() || not contentDirArg.has_value() || not outputDirArg.has_value()) {
+      fmt::print(stderr, "usage: texture_cook -index=<asset list> -contentDir=<dir> -outputDir=<dir> [-stamp=<file>] [-force]\n");
+      return 1;
+   }
+
+   const fs::path indexPath{*indexArg};
+   const fs::path contentDir{*contentDirArg};
+   const fs::path outputDir{*outputDirArg};
+   const auto isForced = commandLine.is_enabled("force"_name);
+   const auto indexWriteTime = fs::last_write_time(indexPath);
+
+   CookStats totalStats{};
+   bool hasFailed = false;
+
+   for (const auto& asset : read_texture_assets(indexPath)) {
+      const auto sourcePath = contentDir / asset.source;
+      const auto cookedPath = outputDir / ktx::cooked_texture_path(asset.source);
+
+      // Missing sources are reported by the resource manager when the asset is loaded.
+      if (not fs::exists(sourcePath)) {
+         fmt::print(stderr, "{}: source not found, skipping\n", asset.source);
+         continue;
+      }
+
+      if (asset.compression == "none") {
+         // Stale cooked files would otherwise take precedence over the source.
+         fs::remove(cookedPath);
+         continue;
+      }
+
+      const auto isUpToDate = fs::exists(cookedPath) && fs::last_write_time(cookedPath) >= fs::last_write_time(sourcePath) &&
+                              fs::last_write_time(cookedPath) >= indexWriteTime;
+      if (isUpToDate && not isForced) {
+         if (const auto cooked = read_cooked_texture(cookedPath); cooked.has_value()) {
+            totalStats.sourceSize += source_texture_size(cooked->width, cooked->height);
+            totalStats.cookedSize += cooked->total_size();
+            continue;
+         }
+      }
+
+      const auto startTime = std::chrono::steady_clock::now();
+
+      int width, height, channelCount;
+      stbi_uc* pixels = stbi_load(sourcePath.string().c_str(), &width, &height, &channelCount, STBI_rgb_alpha);
+      if (pixels == nullptr) {
+         fmt::print(stderr, "{}: failed to decode the image\n", asset.source);
+         hasFailed = true;
+         continue;
+      }
+
+      const std::span<const u8> texels{pixels, 4 * static_cast<MemorySize>(width) * height};
+      const auto texWidth = static_cast<u32>(width);
+      const auto texHeight = static_cast<u32>(height);
+
+      const auto format = select_format(asset, texels, texWidth, texHeight);
+      assert(format.has_value());
+      const auto cooked = cook_texture(asset, *format, texels, texWidth, texHeight);
+      stbi_image_free(pixels);
+
+      if (not write_cooked_texture(cookedPath, cooked)) {
+         fmt::print(stderr, "{}: failed to write {}\n", asset.source, cookedPath.string());
+         hasFailed = true;
+         continue;
+      }
+
+      const CookStats stats{source_texture_size(texWidth, texHeight), cooked.total_size()};
+      totalStats.sourceSize += stats.sourceSize;
+      totalStats.cookedSize += stats.cookedSize;
+
+      const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+      fmt::print("{:<40} {:>4}x{:<4} {:<4} {:>9.1f} KiB -> {:>8.1f} KiB ({:.0f} ms)\n", asset.source, texWidth, texHeight,
+                 format_name(*format), to_kib(stats.sourceSize), to_kib(stats.cookedSize), duration.count());
+   }
+
+   fmt::print("texture memory: {:.1f} MiB as RGBA8, {:.1f} MiB cooked\n", to_kib(totalStats.sourceSize) / 1024.0,
+              to_kib(totalStats.cookedSize) / 1024.0);
+
+   if (hasFailed)
+      return 1;
+
+   if (const auto stampArg = commandLine.arg("stamp"_name); stampArg.has_value()) {
+      std::ofstream stamp(*stampArg, std::ios::trunc);
+   }
+
+   return 0;
+}